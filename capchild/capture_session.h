@@ -49,6 +49,7 @@ typedef struct _capture_session {
     gid_t     group;                      /**< group of the cfile */
 #endif
     gboolean  session_started;
+    gboolean  temp_files;                 /**< capture files are temporary ones chosen by the child */
     guint32   count;                      /**< Total number of frames captured */
     capture_options *capture_opts;        /**< options for this capture */
     capture_file *cf;                     /**< handle to cfile */
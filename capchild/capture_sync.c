@@ -129,6 +129,7 @@ capture_session_init(capture_session *cap_session, capture_file *cf)
 #endif
     cap_session->count                           = 0;
     cap_session->session_started                 = FALSE;
+    cap_session->temp_files                      = FALSE;
 }
 
 /* Append an arg (realloc) to an argc/argv array */
@@ -419,6 +420,13 @@ sync_pipe_start(capture_options *capture_opts, capture_session *cap_session, inf
         argv = sync_pipe_add_arg(argv, &argc, "-w");
         argv = sync_pipe_add_arg(argv, &argc, capture_opts->save_file);
     }
+
+    if (capture_opts->update_interval != DEFAULT_UPDATE_INTERVAL) {
+        char update_interval[ARGV_NUMBER_LEN];
+        argv = sync_pipe_add_arg(argv, &argc, "--update-interval");
+        g_snprintf(update_interval, ARGV_NUMBER_LEN, "%u", capture_opts->update_interval);
+        argv = sync_pipe_add_arg(argv, &argc, update_interval);
+    }
     for (i = 0; i < argc; i++) {
         g_log(LOG_DOMAIN_CAPTURE, G_LOG_LEVEL_DEBUG, "argv[%d]: %s", i, argv[i]);
     }
@@ -0,0 +1,869 @@
+/* capindex.c
+ * Index the conversations in a capture file, and copy out the records of
+ * one conversation without reading the whole file again.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <glib.h>
+
+#ifdef HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+
+#include <wiretap/wtap.h>
+
+#ifndef HAVE_GETOPT_LONG
+#include "wsutil/wsgetopt.h"
+#endif
+
+#include <ui/cmdarg_err.h>
+#include <wsutil/filesystem.h>
+#include <wsutil/file_util.h>
+#include <wsutil/privileges.h>
+#include <wsutil/inet_addr.h>
+#include <wsutil/pint.h>
+#include <cli_main.h>
+#include <version_info.h>
+#include <wiretap/wtap_opttypes.h>
+
+#include <wsutil/report_message.h>
+
+#include "ui/capture_index.h"
+#include "ui/failure_message.h"
+
+#define INVALID_OPTION 1
+#define OPEN_ERROR 2
+#define OUTPUT_FILE_ERROR 1
+
+/*
+ * The index format is described in ui/capture_index.h.  A time checkpoint
+ * is written every CHECKPOINT_INTERVAL records.
+ */
+#define CHECKPOINT_INTERVAL 4096
+
+/* Show command-line usage */
+static void
+print_usage(FILE *output)
+{
+    fprintf(output, "\n");
+    fprintf(output, "Usage: capindex [options] <infile>\n");
+    fprintf(output, "\n");
+    fprintf(output, "Without -l, -e, -A or -B, index the conversations in <infile>.\n");
+    fprintf(output, "\n");
+    fprintf(output, "Options:\n");
+    fprintf(output, "  -i <index>     use this index file instead of <infile>.idx.\n");
+    fprintf(output, "  -l             list the conversations in the index.\n");
+    fprintf(output, "  -e <id>        write the records of conversation <id> to the\n");
+    fprintf(output, "                 file given with -w.\n");
+    fprintf(output, "  -A <start time> write the records with a time stamp at or after\n");
+    fprintf(output, "                 <start time> to the file given with -w.\n");
+    fprintf(output, "  -B <stop time>  write the records with a time stamp before\n");
+    fprintf(output, "                 <stop time> to the file given with -w.\n");
+    fprintf(output, "                 The times are given as YYYY-MM-DD hh:mm:ss, in local time.\n");
+    fprintf(output, "  -w <outfile>   output file for -e, -A and -B; use - for the standard output.\n");
+    fprintf(output, "  -h             display this help and exit.\n");
+    fprintf(output, "  -v             print version information and exit.\n");
+}
+
+/* A conversation, with the endpoints in a canonical order */
+typedef struct flow_key_t {
+    guint8       ip_version;
+    guint8       ip_proto;
+    guint16      port_a;
+    guint16      port_b;
+    guint8       addr_a[16];
+    guint8       addr_b[16];
+} flow_key_t;
+
+typedef struct flow_t {
+    flow_key_t   key;
+    GArray      *offsets;   /* gint64 */
+} flow_t;
+
+static guint
+flow_key_hash(gconstpointer v)
+{
+    const flow_key_t *key = (const flow_key_t *)v;
+    const guint8 *p = (const guint8 *)key;
+    guint h = 5381;
+    size_t i;
+
+    for (i = 0; i < sizeof *key; i++)
+        h = (h << 5) + h + p[i];
+    return h;
+}
+
+static gboolean
+flow_key_equal(gconstpointer v1, gconstpointer v2)
+{
+    return memcmp(v1, v2, sizeof(flow_key_t)) == 0;
+}
+
+static void
+flow_free(gpointer data)
+{
+    flow_t *flow = (flow_t *)data;
+
+    g_array_free(flow->offsets, TRUE);
+    g_free(flow);
+}
+
+/*
+ * Fill in the conversation key of an IPv4 or IPv6 packet.  Returns FALSE
+ * if the packet isn't one.  Fragments other than the first one have no
+ * transport header, so they're put in a conversation without ports.
+ */
+static gboolean
+flow_key_from_ip(const guint8 *pd, guint len, flow_key_t *key)
+{
+    guint8 addr_len;
+    guint  l4_offset;
+    guint8 src[16], dst[16];
+    guint16 sport = 0, dport = 0;
+    gboolean has_ports = TRUE;
+
+    if (len < 1)
+        return FALSE;
+
+    memset(key, 0, sizeof *key);
+    key->ip_version = pd[0] >> 4;
+    switch (key->ip_version) {
+
+    case 4:
+        if (len < 20 || (pd[0] & 0x0f) < 5)
+            return FALSE;
+        addr_len = 4;
+        key->ip_proto = pd[9];
+        memcpy(src, pd + 12, 4);
+        memcpy(dst, pd + 16, 4);
+        l4_offset = (pd[0] & 0x0f) * 4;
+        if (pntoh16(pd + 6) & 0x1fff)
+            has_ports = FALSE;
+        break;
+
+    case 6:
+        if (len < 40)
+            return FALSE;
+        addr_len = 16;
+        key->ip_proto = pd[6];
+        memcpy(src, pd + 8, 16);
+        memcpy(dst, pd + 24, 16);
+        l4_offset = 40;
+        /* Skip the extension headers that may come before the transport header */
+        for (;;) {
+            if (key->ip_proto == 0 || key->ip_proto == 43 || key->ip_proto == 60) {
+                if (l4_offset + 2 > len)
+                    return FALSE;
+                key->ip_proto = pd[l4_offset];
+                l4_offset += (pd[l4_offset + 1] + 1) * 8;
+            } else if (key->ip_proto == 44) {
+                if (l4_offset + 8 > len)
+                    return FALSE;
+                key->ip_proto = pd[l4_offset];
+                if (pntoh16(pd + l4_offset + 2) & 0xfff8)
+                    has_ports = FALSE;
+                l4_offset += 8;
+            } else {
+                break;
+            }
+        }
+        break;
+
+    default:
+        return FALSE;
+    }
+
+    switch (key->ip_proto) {
+
+    case 6:     /* TCP */
+    case 17:    /* UDP */
+    case 132:   /* SCTP */
+        if (has_ports && l4_offset + 4 <= len) {
+            sport = pntoh16(pd + l4_offset);
+            dport = pntoh16(pd + l4_offset + 2);
+        }
+        break;
+
+    default:
+        break;
+    }
+
+    /* Both directions are the same conversation */
+    if (memcmp(src, dst, addr_len) < 0 ||
+        (memcmp(src, dst, addr_len) == 0 && sport <= dport)) {
+        memcpy(key->addr_a, src, addr_len);
+        memcpy(key->addr_b, dst, addr_len);
+        key->port_a = sport;
+        key->port_b = dport;
+    } else {
+        memcpy(key->addr_a, dst, addr_len);
+        memcpy(key->addr_b, src, addr_len);
+        key->port_a = dport;
+        key->port_b = sport;
+    }
+    return TRUE;
+}
+
+/* Find the IP header of a packet, for the encapsulations we know */
+static gboolean
+flow_key_from_packet(const wtap_rec *rec, const guint8 *pd, flow_key_t *key)
+{
+    guint len = rec->rec_header.packet_header.caplen;
+    guint offset;
+    guint16 ethertype;
+
+    switch (rec->rec_header.packet_header.pkt_encap) {
+
+    case WTAP_ENCAP_ETHERNET:
+        if (len < 14)
+            return FALSE;
+        ethertype = pntoh16(pd + 12);
+        offset = 14;
+        /* 802.1Q and 802.1ad tags */
+        while ((ethertype == 0x8100 || ethertype == 0x88a8) && offset + 4 <= len) {
+            ethertype = pntoh16(pd + offset + 2);
+            offset += 4;
+        }
+        break;
+
+    case WTAP_ENCAP_SLL:
+        if (len < 16)
+            return FALSE;
+        ethertype = pntoh16(pd + 14);
+        offset = 16;
+        break;
+
+    case WTAP_ENCAP_RAW_IP:
+    case WTAP_ENCAP_RAW_IP4:
+    case WTAP_ENCAP_RAW_IP6:
+        return flow_key_from_ip(pd, len, key);
+
+    default:
+        return FALSE;
+    }
+
+    if (ethertype != 0x0800 && ethertype != 0x86dd)
+        return FALSE;
+    return flow_key_from_ip(pd + offset, len - offset, key);
+}
+
+static void
+flow_endpoint_string(guint8 ip_version, const guint8 *addr, guint16 port,
+                     char *buf, size_t buf_size)
+{
+    char addr_str[WS_INET6_ADDRSTRLEN];
+
+    if (ip_version == 4) {
+        ws_inet_ntop4(addr, addr_str, sizeof addr_str);
+        g_snprintf(buf, (gulong)buf_size, "%s:%u", addr_str, port);
+    } else {
+        ws_inet_ntop6(addr, addr_str, sizeof addr_str);
+        g_snprintf(buf, (gulong)buf_size, "[%s]:%u", addr_str, port);
+    }
+}
+
+static const char *
+flow_proto_string(guint8 ip_proto)
+{
+    switch (ip_proto) {
+    case 1:     return "icmp";
+    case 6:     return "tcp";
+    case 17:    return "udp";
+    case 58:    return "icmpv6";
+    case 132:   return "sctp";
+    default:    return NULL;
+    }
+}
+
+static guint
+file_num_interfaces(wtap *wth)
+{
+    wtapng_iface_descriptions_t *idb_info = wtap_file_get_idb_info(wth);
+    guint num_interfaces = idb_info->interface_data->len;
+
+    g_free(idb_info);
+    return num_interfaces;
+}
+
+static const char *
+nstime_to_index_string(const nstime_t *t, char *buf, size_t buf_size)
+{
+    if (nstime_is_unset(t))
+        return "-";
+    g_snprintf(buf, (gulong)buf_size, "%" G_GINT64_MODIFIER "d.%09d", (gint64)t->secs, t->nsecs);
+    return buf;
+}
+
+/* Read infile and write the index of its conversations */
+static int
+build_index(const char *infile, const char *indexfile)
+{
+    wtap      *wth;
+    wtap_rec   rec;
+    Buffer     buf;
+    int        err;
+    gchar     *err_info;
+    gint64     data_offset;
+    capture_index_id_t capture_id;
+    char      *err_msg;
+    GHashTable *flows_by_key;
+    GPtrArray *flows;
+    GArray    *checkpoints;
+    gboolean   can_checkpoint;
+    guint      num_shbs;
+    guint      num_interfaces;
+    nstime_t   latest;
+    guint      records = 0;
+    guint      i, j;
+    FILE      *fh;
+    int        ret = EXIT_SUCCESS;
+
+    wth = wtap_open_offline(infile, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+    if (wth == NULL) {
+        cfile_open_failure_message("capindex", infile, err, err_info);
+        return OPEN_ERROR;
+    }
+
+    /* Conversations in the order their first record appears */
+    flows_by_key = g_hash_table_new(flow_key_hash, flow_key_equal);
+    flows = g_ptr_array_new_with_free_func(flow_free);
+
+    /*
+     * Reading can only start at a checkpoint if no section or interface
+     * is described between the start of the file and it, so we stop
+     * adding them after the first one that is.
+     */
+    checkpoints = g_array_new(FALSE, FALSE, sizeof(capture_index_checkpoint_t));
+    can_checkpoint = TRUE;
+    num_shbs = wtap_file_get_num_shbs(wth);
+    num_interfaces = file_num_interfaces(wth);
+    nstime_set_unset(&latest);
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+        flow_key_t key;
+        flow_t *flow;
+
+        if (can_checkpoint && records % CHECKPOINT_INTERVAL == 0) {
+            if (wtap_file_get_num_shbs(wth) == num_shbs &&
+                file_num_interfaces(wth) == num_interfaces) {
+                capture_index_checkpoint_t checkpoint;
+
+                checkpoint.offset = data_offset;
+                checkpoint.latest_before = latest;
+                nstime_set_unset(&checkpoint.earliest_from);
+                g_array_append_val(checkpoints, checkpoint);
+            } else {
+                can_checkpoint = FALSE;
+            }
+        }
+        records++;
+
+        if ((rec.presence_flags & WTAP_HAS_TS) && checkpoints->len > 0) {
+            /* For now, the earliest time of the records after the last checkpoint */
+            capture_index_checkpoint_t *checkpoint = &g_array_index(checkpoints, capture_index_checkpoint_t, checkpoints->len - 1);
+
+            if (nstime_is_unset(&latest) || nstime_cmp(&rec.ts, &latest) > 0)
+                latest = rec.ts;
+            if (nstime_is_unset(&checkpoint->earliest_from) ||
+                nstime_cmp(&rec.ts, &checkpoint->earliest_from) < 0)
+                checkpoint->earliest_from = rec.ts;
+        }
+
+        if (rec.rec_type != REC_TYPE_PACKET ||
+            !flow_key_from_packet(&rec, ws_buffer_start_ptr(&buf), &key))
+            continue;
+
+        flow = (flow_t *)g_hash_table_lookup(flows_by_key, &key);
+        if (flow == NULL) {
+            flow = g_new(flow_t, 1);
+            flow->key = key;
+            flow->offsets = g_array_new(FALSE, FALSE, sizeof(gint64));
+            g_hash_table_insert(flows_by_key, &flow->key, flow);
+            g_ptr_array_add(flows, flow);
+        }
+        g_array_append_val(flow->offsets, data_offset);
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    if (err != 0) {
+        cfile_read_failure_message("capindex", infile, err, err_info);
+        ret = OPEN_ERROR;
+        goto done;
+    }
+
+    if (!capture_index_get_id(infile, &capture_id, &err_msg)) {
+        fprintf(stderr, "capindex: %s\n", err_msg);
+        g_free(err_msg);
+        ret = OPEN_ERROR;
+        goto done;
+    }
+
+    fh = ws_fopen(indexfile, "w");
+    if (fh == NULL) {
+        fprintf(stderr, "capindex: Can't create \"%s\": %s.\n",
+                indexfile, g_strerror(errno));
+        ret = OUTPUT_FILE_ERROR;
+        goto done;
+    }
+
+    fprintf(fh, "%s\n", CAPTURE_INDEX_VERSION_LINE);
+    fprintf(fh, "size %" G_GINT64_MODIFIER "d\n", capture_id.size);
+    fprintf(fh, "mtime %" G_GINT64_MODIFIER "d\n", capture_id.mtime);
+    fprintf(fh, "header %s\n", capture_id.header_hash);
+    /* Turn the earliest times after each checkpoint into ones up to the end */
+    for (i = checkpoints->len; i-- > 1; ) {
+        capture_index_checkpoint_t *checkpoint = &g_array_index(checkpoints, capture_index_checkpoint_t, i);
+        capture_index_checkpoint_t *previous = &g_array_index(checkpoints, capture_index_checkpoint_t, i - 1);
+
+        if (!nstime_is_unset(&checkpoint->earliest_from) &&
+            (nstime_is_unset(&previous->earliest_from) ||
+             nstime_cmp(&checkpoint->earliest_from, &previous->earliest_from) < 0))
+            previous->earliest_from = checkpoint->earliest_from;
+    }
+    for (i = 0; i < checkpoints->len; i++) {
+        capture_index_checkpoint_t *checkpoint = &g_array_index(checkpoints, capture_index_checkpoint_t, i);
+        char latest_str[32], earliest_str[32];
+
+        fprintf(fh, "time %" G_GINT64_MODIFIER "d %s %s\n", checkpoint->offset,
+                nstime_to_index_string(&checkpoint->latest_before, latest_str, sizeof latest_str),
+                nstime_to_index_string(&checkpoint->earliest_from, earliest_str, sizeof earliest_str));
+    }
+    for (i = 0; i < flows->len; i++) {
+        flow_t *flow = (flow_t *)g_ptr_array_index(flows, i);
+        const char *proto = flow_proto_string(flow->key.ip_proto);
+        char endpoint_a[WS_INET6_ADDRSTRLEN + 9];
+        char endpoint_b[WS_INET6_ADDRSTRLEN + 9];
+
+        flow_endpoint_string(flow->key.ip_version, flow->key.addr_a, flow->key.port_a,
+                             endpoint_a, sizeof endpoint_a);
+        flow_endpoint_string(flow->key.ip_version, flow->key.addr_b, flow->key.port_b,
+                             endpoint_b, sizeof endpoint_b);
+        if (proto != NULL)
+            fprintf(fh, "flow %u %s", i + 1, proto);
+        else
+            fprintf(fh, "flow %u ip.proto=%u", i + 1, flow->key.ip_proto);
+        fprintf(fh, " %s %s %u", endpoint_a, endpoint_b, flow->offsets->len);
+        for (j = 0; j < flow->offsets->len; j++)
+            fprintf(fh, " %" G_GINT64_MODIFIER "d", g_array_index(flow->offsets, gint64, j));
+        fprintf(fh, "\n");
+    }
+
+    if (ferror(fh) | (fclose(fh) != 0)) {
+        fprintf(stderr, "capindex: Error writing to \"%s\": %s.\n",
+                indexfile, g_strerror(errno));
+        ret = OUTPUT_FILE_ERROR;
+        goto done;
+    }
+
+    printf("%u records, %u conversations\n", records, flows->len);
+
+done:
+    g_hash_table_destroy(flows_by_key);
+    g_ptr_array_free(flows, TRUE);
+    g_array_free(checkpoints, TRUE);
+    wtap_close(wth);
+    return ret;
+}
+
+/*
+ * Read the next "flow" line up to its offsets.  Returns FALSE at the end
+ * of the index.
+ */
+static gboolean
+read_flow_header(FILE *fh, guint *id, char *proto, char *endpoint_a,
+                 char *endpoint_b, guint *count)
+{
+    return fscanf(fh, " flow %u %31s %63s %63s %u",
+                  id, proto, endpoint_a, endpoint_b, count) == 5;
+}
+
+static int
+list_flows(FILE *fh)
+{
+    guint id, count, i;
+    char  proto[32], endpoint_a[64], endpoint_b[64];
+    gint64 offset;
+
+    printf("%8s  %-12s %-48s %-48s %10s\n", "Id", "Protocol", "Endpoint A", "Endpoint B", "Records");
+    while (read_flow_header(fh, &id, proto, endpoint_a, endpoint_b, &count)) {
+        printf("%8u  %-12s %-48s %-48s %10u\n", id, proto, endpoint_a, endpoint_b, count);
+        for (i = 0; i < count; i++) {
+            if (fscanf(fh, "%" G_GINT64_MODIFIER "d", &offset) != 1) {
+                fprintf(stderr, "capindex: The index is truncated.\n");
+                return OPEN_ERROR;
+            }
+        }
+    }
+    return EXIT_SUCCESS;
+}
+
+/* Open outfile for records like those of wth */
+static wtap_dumper *
+open_output(wtap *wth, const char *outfile, wtap_dump_params *params)
+{
+    wtap_dumper *pdh;
+    int err;
+
+    wtap_dump_params_init(params, wth);
+    if (strcmp(outfile, "-") == 0) {
+        pdh = wtap_dump_open_stdout(wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, params, &err);
+    } else {
+        pdh = wtap_dump_open(outfile, wtap_file_type_subtype(wth), WTAP_UNCOMPRESSED, params, &err);
+    }
+    g_free(params->idb_inf);
+    params->idb_inf = NULL;
+
+    if (pdh == NULL) {
+        cfile_dump_open_failure_message("capindex", outfile, err,
+                                        wtap_file_type_subtype(wth));
+        wtap_dump_params_cleanup(params);
+    }
+    return pdh;
+}
+
+/* Copy the records of one conversation from wth to outfile */
+static int
+extract_flow(FILE *fh, guint want_id, wtap *wth, const char *infile,
+             const char *outfile)
+{
+    guint id, count, i;
+    char  proto[32], endpoint_a[64], endpoint_b[64];
+    gint64 offset;
+    wtap_dump_params params;
+    wtap_dumper *pdh;
+    wtap_rec rec;
+    Buffer buf;
+    int    err;
+    gchar *err_info;
+    int    ret = EXIT_SUCCESS;
+
+    for (;;) {
+        if (!read_flow_header(fh, &id, proto, endpoint_a, endpoint_b, &count)) {
+            fprintf(stderr, "capindex: There is no conversation %u in the index.\n", want_id);
+            return INVALID_OPTION;
+        }
+        if (id == want_id)
+            break;
+        for (i = 0; i < count; i++) {
+            if (fscanf(fh, "%" G_GINT64_MODIFIER "d", &offset) != 1) {
+                fprintf(stderr, "capindex: The index is truncated.\n");
+                return OPEN_ERROR;
+            }
+        }
+    }
+
+    pdh = open_output(wth, outfile, &params);
+    if (pdh == NULL)
+        return OUTPUT_FILE_ERROR;
+
+    /* The offsets are in file order, so this reads forward through the file */
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    for (i = 0; i < count; i++) {
+        if (fscanf(fh, "%" G_GINT64_MODIFIER "d", &offset) != 1) {
+            fprintf(stderr, "capindex: The index is truncated.\n");
+            ret = OPEN_ERROR;
+            break;
+        }
+        if (!wtap_seek_read(wth, offset, &rec, &buf, &err, &err_info)) {
+            fprintf(stderr, "capindex: An error occurred while re-reading \"%s\".\n", infile);
+            cfile_read_failure_message("capindex", infile, err, err_info);
+            ret = OPEN_ERROR;
+            break;
+        }
+        if (!wtap_dump(pdh, &rec, ws_buffer_start_ptr(&buf), &err, &err_info)) {
+            cfile_write_failure_message("capindex", infile, outfile, err,
+                                        err_info, i + 1,
+                                        wtap_file_type_subtype(wth));
+            ret = OUTPUT_FILE_ERROR;
+            break;
+        }
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+
+    if (!wtap_dump_close(pdh, &err)) {
+        cfile_close_failure_message(outfile, err);
+        ret = OUTPUT_FILE_ERROR;
+    }
+    wtap_dump_params_cleanup(&params);
+    return ret;
+}
+
+/*
+ * Copy the records with a time stamp in [start, stop) from wth to outfile.
+ * Either end may be unset.  Only the part of the capture between the
+ * checkpoints around the range is read.
+ */
+static int
+extract_time_range(GArray *checkpoints, const nstime_t *start,
+                   const nstime_t *stop, wtap *wth, const char *infile,
+                   const char *outfile)
+{
+    wtap_dump_params params;
+    wtap_dumper *pdh;
+    wtap_rec rec;
+    Buffer buf;
+    int    err;
+    gchar *err_info;
+    gint64 data_offset;
+    capture_index_range_t range;
+    guint  records_read = 0, records_written = 0;
+    int    ret = EXIT_SUCCESS;
+
+    pdh = open_output(wth, outfile, &params);
+    if (pdh == NULL)
+        return OUTPUT_FILE_ERROR;
+
+    capture_index_range_init(&range, checkpoints, start, stop);
+    capture_index_range_seek(&range, wth);
+
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    for (;;) {
+        if (!wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+            if (err != 0) {
+                cfile_read_failure_message("capindex", infile, err, err_info);
+                ret = OPEN_ERROR;
+            }
+            break;
+        }
+        records_read++;
+
+        if (capture_index_range_at_end(&range, data_offset))
+            break;
+        if (!capture_index_range_contains(&range, &rec))
+            continue;
+
+        if (!wtap_dump(pdh, &rec, ws_buffer_start_ptr(&buf), &err, &err_info)) {
+            cfile_write_failure_message("capindex", infile, outfile, err,
+                                        err_info, records_read,
+                                        wtap_file_type_subtype(wth));
+            ret = OUTPUT_FILE_ERROR;
+            break;
+        }
+        records_written++;
+    }
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+
+    if (!wtap_dump_close(pdh, &err)) {
+        cfile_close_failure_message(outfile, err);
+        ret = OUTPUT_FILE_ERROR;
+    }
+    wtap_dump_params_cleanup(&params);
+
+    if (ret == EXIT_SUCCESS)
+        fprintf(stderr, "%u records read, %u written\n", records_read, records_written);
+    return ret;
+}
+
+/*
+ * General errors and warnings are reported with an console message
+ * in capindex.
+ */
+static void
+failure_warning_message(const char *msg_format, va_list ap)
+{
+    fprintf(stderr, "capindex: ");
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+/*
+ * Report additional information for an error in command-line arguments.
+ */
+static void
+failure_message_cont(const char *msg_format, va_list ap)
+{
+    vfprintf(stderr, msg_format, ap);
+    fprintf(stderr, "\n");
+}
+
+/********************************************************************/
+/* Main function.                                                   */
+/********************************************************************/
+int
+main(int argc, char *argv[])
+{
+    char *init_progfile_dir_error;
+    int   ret = EXIT_SUCCESS;
+    int   opt;
+    static const struct option long_options[] = {
+        {"help", no_argument, NULL, 'h'},
+        {"version", no_argument, NULL, 'v'},
+        {0, 0, 0, 0 }
+    };
+    const char *infile;
+    char *indexfile = NULL;
+    const char *outfile = NULL;
+    gboolean list = FALSE;
+    guint extract_id = 0;
+    gboolean time_range;
+    nstime_t start_time, stop_time;
+    char *p;
+    wtap *wth = NULL;
+    FILE *fh = NULL;
+    GArray *checkpoints = NULL;
+    capture_index_id_t capture_id;
+    int   err;
+    gchar *err_info;
+    char *err_msg;
+
+    cmdarg_err_init(failure_warning_message, failure_message_cont);
+
+    /* Initialize the version information. */
+    ws_init_version_info("Capindex (Wireshark)", NULL, NULL, NULL);
+
+    /*
+     * Get credential information for later use.
+     */
+    init_process_policies();
+
+    /*
+     * Attempt to get the pathname of the directory containing the
+     * executable file.
+     */
+    init_progfile_dir_error = init_progfile_dir(argv[0]);
+    if (init_progfile_dir_error != NULL) {
+        fprintf(stderr,
+                "capindex: Can't get pathname of directory containing the capindex program: %s.\n",
+                init_progfile_dir_error);
+        g_free(init_progfile_dir_error);
+    }
+
+    init_report_message(failure_warning_message, failure_warning_message,
+                        NULL, NULL, NULL);
+
+    wtap_init(TRUE);
+
+    nstime_set_unset(&start_time);
+    nstime_set_unset(&stop_time);
+
+    /* Process the options first */
+    while ((opt = getopt_long(argc, argv, "A:B:e:hi:lvw:", long_options, NULL)) != -1) {
+        switch (opt) {
+            case 'A':
+            case 'B':
+                if (!capture_index_parse_time(optarg, opt == 'A' ? &start_time : &stop_time)) {
+                    cmdarg_err("\"%s\" isn't a valid time format", optarg);
+                    ret = INVALID_OPTION;
+                    goto clean_exit;
+                }
+                break;
+            case 'e':
+                extract_id = (guint)strtoul(optarg, &p, 10);
+                if (p == optarg || *p != '\0' || extract_id == 0) {
+                    cmdarg_err("\"%s\" isn't a valid conversation id", optarg);
+                    ret = INVALID_OPTION;
+                    goto clean_exit;
+                }
+                break;
+            case 'i':
+                g_free(indexfile);
+                indexfile = g_strdup(optarg);
+                break;
+            case 'l':
+                list = TRUE;
+                break;
+            case 'w':
+                outfile = optarg;
+                break;
+            case 'h':
+                show_help_header("Index the conversations in a capture file and extract them.");
+                print_usage(stdout);
+                goto clean_exit;
+            case 'v':
+                show_version();
+                goto clean_exit;
+            case '?':
+                print_usage(stderr);
+                ret = INVALID_OPTION;
+                goto clean_exit;
+        }
+    }
+
+    time_range = !nstime_is_unset(&start_time) || !nstime_is_unset(&stop_time);
+    if (argc - optind != 1 || (extract_id != 0 || time_range) != (outfile != NULL) ||
+        (list + (extract_id != 0) + time_range) > 1) {
+        print_usage(stderr);
+        ret = INVALID_OPTION;
+        goto clean_exit;
+    }
+    infile = argv[optind];
+    if (indexfile == NULL)
+        indexfile = capture_index_default_name(infile);
+
+    if (!list && extract_id == 0 && !time_range) {
+        ret = build_index(infile, indexfile);
+        goto clean_exit;
+    }
+
+    wth = wtap_open_offline(infile, WTAP_TYPE_AUTO, &err, &err_info, TRUE);
+    if (wth == NULL) {
+        cfile_open_failure_message("capindex", infile, err, err_info);
+        ret = OPEN_ERROR;
+        goto clean_exit;
+    }
+    if (!capture_index_get_id(infile, &capture_id, &err_msg)) {
+        fprintf(stderr, "capindex: %s\n", err_msg);
+        g_free(err_msg);
+        ret = OPEN_ERROR;
+        goto clean_exit;
+    }
+
+    checkpoints = g_array_new(FALSE, FALSE, sizeof(capture_index_checkpoint_t));
+    fh = capture_index_open(indexfile, &capture_id, checkpoints, &err_msg);
+    if (fh == NULL) {
+        fprintf(stderr, "capindex: %s\n", err_msg);
+        g_free(err_msg);
+        ret = OPEN_ERROR;
+        goto clean_exit;
+    }
+
+    if (list)
+        ret = list_flows(fh);
+    else if (time_range)
+        ret = extract_time_range(checkpoints, &start_time, &stop_time, wth, infile, outfile);
+    else
+        ret = extract_flow(fh, extract_id, wth, infile, outfile);
+
+clean_exit:
+    if (fh != NULL)
+        fclose(fh);
+    if (checkpoints != NULL)
+        g_array_free(checkpoints, TRUE);
+    if (wth != NULL)
+        wtap_close(wth);
+    g_free(indexfile);
+    wtap_cleanup();
+    free_progdirs();
+    return ret;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -158,6 +158,11 @@ static gchar file_sha256[HASH_STR_SIZE];
 static gchar file_rmd160[HASH_STR_SIZE];
 static gchar file_sha1[HASH_STR_SIZE];
 
+/* The hashes of a file are calculated while the file is being read */
+static gcry_md_hd_t hash_hd;
+static char *hash_buf;
+static GThread *hash_thread;
+
 static guint num_ipv4_addresses;
 static guint num_ipv6_addresses;
 static guint num_decryption_secrets;
@@ -1091,6 +1096,70 @@ count_decryption_secret(guint32 secrets_type _U_, const void *secrets _U_, guint
   num_decryption_secrets++;
 }
 
+static void
+hash_to_str(const unsigned char *hash, size_t length, char *str) {
+  int i;
+
+  for (i = 0; i < (int) length; i++) {
+    g_snprintf(str+(i*2), 3, "%02x", hash[i]);
+  }
+}
+
+static gpointer
+calculate_hashes_worker(gpointer data)
+{
+  const char *filename = (const char *)data;
+  FILE  *fh;
+  size_t hash_bytes;
+
+  fh = ws_fopen(filename, "rb");
+  if (fh && hash_hd) {
+    while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
+      gcry_md_write(hash_hd, hash_buf, hash_bytes);
+    }
+    gcry_md_final(hash_hd);
+    hash_to_str(gcry_md_read(hash_hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
+    hash_to_str(gcry_md_read(hash_hd, GCRY_MD_RMD160), HASH_SIZE_RMD160, file_rmd160);
+    hash_to_str(gcry_md_read(hash_hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
+  }
+  if (fh) fclose(fh);
+  if (hash_hd) gcry_md_reset(hash_hd);
+
+  return NULL;
+}
+
+/* Wait for the hashes of the current file, if they're being calculated */
+static void
+finish_hashes(void)
+{
+  if (hash_thread) {
+    g_thread_join(hash_thread);
+    hash_thread = NULL;
+  }
+}
+
+/*
+ * Do we have to read the records of the file?  If none of the infos that
+ * are tallied from the records were asked for, the file header is enough.
+ */
+static gboolean
+need_records(wtap *wth)
+{
+  if (cap_packet_count || cap_data_size || cap_snaplen || cap_order)
+    return TRUE;
+  if (cap_duration || cap_start_time || cap_end_time)
+    return TRUE;
+  if (cap_data_rate_byte || cap_data_rate_bit || cap_packet_size || cap_packet_rate)
+    return TRUE;
+  if (cap_file_encap && wtap_file_encap(wth) == WTAP_ENCAP_PER_PACKET)
+    return TRUE;
+  /* Interfaces, name resolution and decryption secrets may be anywhere
+     in the file, and are only shown in long reports. */
+  if (long_report && (cap_file_idb || cap_file_nrb || cap_file_dsb))
+    return TRUE;
+  return FALSE;
+}
+
 static int
 process_cap_file(const char *filename, gboolean need_separator)
 {
@@ -1119,12 +1188,14 @@ process_cap_file(const char *filename, gboolean need_separator)
   order_t               order = IN_ORDER;
   guint                 i;
   wtapng_iface_descriptions_t *idb_info;
+  gboolean              read_records;
 
   wth = wtap_open_offline(filename, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
   if (!wth) {
     cfile_open_failure_message("capinfos", filename, err, err_info);
     return 2;
   }
+  read_records = need_records(wth);
 
   if (need_separator && long_report) {
     printf("\n");
@@ -1165,9 +1236,11 @@ process_cap_file(const char *filename, gboolean need_separator)
   num_decryption_secrets = 0;
 
   /* Tally up data that we need to parse through the file to find */
+  err = 0;
   wtap_rec_init(&rec);
   ws_buffer_init(&buf, 1514);
-  while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset))  {
+  while (read_records &&
+         wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset))  {
     if (rec.presence_flags & WTAP_HAS_TS) {
       prev_time = cur_time;
       cur_time = rec.ts;
@@ -1360,6 +1433,7 @@ process_cap_file(const char *filename, gboolean need_separator)
     cf_info.packet_size = (double)bytes / packet;                  /* Avg packet size      */
   }
 
+  finish_hashes();
   if (long_report) {
     print_stats(filename, &cf_info);
   } else {
@@ -1461,15 +1535,6 @@ failure_message_cont(const char *msg_format, va_list ap)
   fprintf(stderr, "\n");
 }
 
-static void
-hash_to_str(const unsigned char *hash, size_t length, char *str) {
-  int i;
-
-  for (i = 0; i < (int) length; i++) {
-    g_snprintf(str+(i*2), 3, "%02x", hash[i]);
-  }
-}
-
 int
 main(int argc, char *argv[])
 {
@@ -1484,10 +1549,6 @@ main(int argc, char *argv[])
   };
 
   int status = 0;
-  FILE  *fh;
-  char  *hash_buf = NULL;
-  gcry_md_hd_t hd = NULL;
-  size_t hash_bytes;
 
   /* Set the C-language locale to the native environment. */
   setlocale(LC_ALL, "");
@@ -1722,10 +1783,10 @@ main(int argc, char *argv[])
 
   if (cap_file_hashes) {
     gcry_check_version(NULL);
-    gcry_md_open(&hd, GCRY_MD_SHA256, 0);
-    if (hd) {
-      gcry_md_enable(hd, GCRY_MD_RMD160);
-      gcry_md_enable(hd, GCRY_MD_SHA1);
+    gcry_md_open(&hash_hd, GCRY_MD_SHA256, 0);
+    if (hash_hd) {
+      gcry_md_enable(hash_hd, GCRY_MD_RMD160);
+      gcry_md_enable(hash_hd, GCRY_MD_SHA1);
     }
     hash_buf = (char *)g_malloc(HASH_BUF_SIZE);
   }
@@ -1739,21 +1800,11 @@ main(int argc, char *argv[])
     g_strlcpy(file_sha1, "<unknown>", HASH_STR_SIZE);
 
     if (cap_file_hashes) {
-      fh = ws_fopen(argv[opt], "rb");
-      if (fh && hd) {
-        while((hash_bytes = fread(hash_buf, 1, HASH_BUF_SIZE, fh)) > 0) {
-          gcry_md_write(hd, hash_buf, hash_bytes);
-        }
-        gcry_md_final(hd);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA256), HASH_SIZE_SHA256, file_sha256);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_RMD160), HASH_SIZE_RMD160, file_rmd160);
-        hash_to_str(gcry_md_read(hd, GCRY_MD_SHA1), HASH_SIZE_SHA1, file_sha1);
-      }
-      if (fh) fclose(fh);
-      if (hd) gcry_md_reset(hd);
+      hash_thread = g_thread_new("capinfos hashes", calculate_hashes_worker, argv[opt]);
     }
 
     status = process_cap_file(argv[opt], need_separator);
+    finish_hashes();
     if (status) {
       /* Something failed.  It's been reported; remember that processing
          one file failed and, if -C was specified, stop. */
@@ -1772,7 +1823,7 @@ main(int argc, char *argv[])
 
 exit:
   g_free(hash_buf);
-  gcry_md_close(hd);
+  gcry_md_close(hash_hd);
   wtap_cleanup();
   free_progdirs();
   return overall_error_status;
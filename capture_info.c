@@ -20,6 +20,7 @@
 #include "capture_info.h"
 
 #include <epan/capture_dissectors.h>
+#include <epan/prefs.h>
 
 static void
 capture_info_packet(info_data_t* cap_info, gint wtap_linktype, const guchar *pd, guint32 caplen, union wtap_pseudo_header *pseudo_header)
@@ -34,6 +35,57 @@ capture_info_packet(info_data_t* cap_info, gint wtap_linktype, const guchar *pd,
         cap_info->counts.other++;
 }
 
+/*
+ * Dissect one packet of a sample in which each packet stands for "weight"
+ * packets: count it in a scratch table, then add it to the real counters
+ * "weight" times.
+ */
+static void
+capture_info_sampled_packet(info_data_t* cap_info, packet_counts *sample_counts, guint weight,
+                            gint wtap_linktype, const guchar *pd, guint32 caplen, union wtap_pseudo_header *pseudo_header)
+{
+    capture_packet_info_t cpinfo;
+    GHashTableIter iter;
+    gpointer key, value;
+
+    cpinfo.counts = sample_counts->counts_hash;
+
+    if (!try_capture_dissector("wtap_encap", wtap_linktype, pd, 0, caplen, &cpinfo, pseudo_header))
+        cap_info->counts.other += (gint)weight;
+
+    cpinfo.counts = cap_info->counts.counts_hash;
+    g_hash_table_iter_init(&iter, sample_counts->counts_hash);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        int proto = GPOINTER_TO_INT(key);
+        capture_dissector_add_count(&cpinfo, proto, capture_dissector_get_count(sample_counts, proto) * weight);
+    }
+    g_hash_table_remove_all(sample_counts->counts_hash);
+}
+
+/*
+ * Above prefs.capture_info_sample_rate packets per second, only every
+ * Nth packet is run through the capture dissectors, with N chosen so
+ * that about that many packets per second are dissected. The total is
+ * always exact. Returns 1 when every packet should be dissected.
+ */
+static guint
+capture_info_sample_interval(info_data_t* cap_info, int to_read)
+{
+    gint64 now = g_get_monotonic_time();
+    gint64 elapsed = now - cap_info->last_batch_time;
+    guint64 rate;
+
+    cap_info->last_batch_time = now;
+    if (prefs.capture_info_sample_rate == 0 || elapsed <= 0 || elapsed > G_USEC_PER_SEC)
+        return 1;
+
+    rate = (guint64)to_read * G_USEC_PER_SEC / (guint64)elapsed;
+    if (rate <= prefs.capture_info_sample_rate)
+        return 1;
+
+    return (guint)((rate + prefs.capture_info_sample_rate - 1) / prefs.capture_info_sample_rate);
+}
+
 /* new packets arrived */
 void capture_info_new_packets(int to_read, wtap *wth, info_data_t* cap_info)
 {
@@ -44,11 +96,21 @@ void capture_info_new_packets(int to_read, wtap *wth, info_data_t* cap_info)
     Buffer buf;
     union wtap_pseudo_header *pseudo_header;
     int wtap_linktype;
+    guint interval;
+    packet_counts sample_counts;
 
     cap_info->ui.new_packets = to_read;
 
     /*g_warning("new packets: %u", to_read);*/
 
+    interval = capture_info_sample_interval(cap_info, to_read);
+    if (interval > 1) {
+        sample_counts.counts_hash = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+        cap_info->ui.sampled = TRUE;
+    } else {
+        sample_counts.counts_hash = NULL;
+    }
+
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
     while (to_read > 0) {
@@ -58,10 +120,23 @@ void capture_info_new_packets(int to_read, wtap *wth, info_data_t* cap_info)
                 pseudo_header = &rec.rec_header.packet_header.pseudo_header;
                 wtap_linktype = rec.rec_header.packet_header.pkt_encap;
 
-                capture_info_packet(cap_info, wtap_linktype,
-                                    ws_buffer_start_ptr(&buf),
-                                    rec.rec_header.packet_header.caplen,
-                                    pseudo_header);
+                if (sample_counts.counts_hash == NULL) {
+                    capture_info_packet(cap_info, wtap_linktype,
+                                        ws_buffer_start_ptr(&buf),
+                                        rec.rec_header.packet_header.caplen,
+                                        pseudo_header);
+                } else {
+                    cap_info->counts.total++;
+                    if (cap_info->sample_skip == 0) {
+                        capture_info_sampled_packet(cap_info, &sample_counts, interval,
+                                                    wtap_linktype,
+                                                    ws_buffer_start_ptr(&buf),
+                                                    rec.rec_header.packet_header.caplen,
+                                                    pseudo_header);
+                        cap_info->sample_skip = interval;
+                    }
+                    cap_info->sample_skip--;
+                }
 
                 /*g_warning("new packet");*/
                 to_read--;
@@ -70,6 +145,8 @@ void capture_info_new_packets(int to_read, wtap *wth, info_data_t* cap_info)
     }
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
+    if (sample_counts.counts_hash != NULL)
+        g_hash_table_destroy(sample_counts.counts_hash);
 
     capture_info_ui_update(&cap_info->ui);
 }
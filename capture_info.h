@@ -34,11 +34,14 @@ typedef struct _capture_info {
     /* capture info */
     packet_counts   *counts;        /**< protocol specific counters */
     gint            new_packets;    /**< packets since last update */
+    gboolean        sampled;        /**< protocol counts are estimated from a sample */
 } capture_info;
 
 typedef struct _info_data {
     packet_counts     counts;     /* Packet counting */
     capture_info      ui;         /* user interface data */
+    gint64            last_batch_time; /* when the previous batch arrived, monotonic usecs */
+    guint             sample_skip;     /* packets left until the next dissected one */
 } info_data_t;
 
 /* new packets arrived - read from wtap, count */
@@ -93,6 +93,7 @@ capture_opts_init(capture_options *capture_opts)
 #endif
     capture_opts->real_time_mode                  = TRUE;
     capture_opts->show_info                       = TRUE;
+    capture_opts->update_interval                 = DEFAULT_UPDATE_INTERVAL;
     capture_opts->restart                         = FALSE;
     capture_opts->orig_save_file                  = NULL;
 
@@ -241,6 +242,7 @@ capture_opts_log(const char *log_domain, GLogLevelFlags log_level, capture_optio
     g_log(log_domain, log_level, "Fileformat          : %s", (capture_opts->use_pcapng) ? "PCAPNG" : "PCAP");
     g_log(log_domain, log_level, "RealTimeMode        : %u", capture_opts->real_time_mode);
     g_log(log_domain, log_level, "ShowInfo            : %u", capture_opts->show_info);
+    g_log(log_domain, log_level, "UpdateInterval      : %u (ms)", capture_opts->update_interval);
 
     g_log(log_domain, log_level, "MultiFilesOn        : %u", capture_opts->multi_files_on);
     g_log(log_domain, log_level, "FileDuration    (%u) : %.3f", capture_opts->has_file_duration, capture_opts->file_duration);
@@ -827,6 +829,9 @@ capture_opts_add_opt(capture_options *capture_opts, int opt, const char *optarg_
     case 'H':        /* Hide capture info dialog box */
         capture_opts->show_info = FALSE;
         break;
+    case LONGOPT_UPDATE_INTERVAL:  /* capture update interval */
+        capture_opts->update_interval = get_positive_int(optarg_str_p, "update interval");
+        break;
     case LONGOPT_SET_TSTAMP_TYPE:        /* Set capture time stamp type */
         if (capture_opts->ifaces->len > 0) {
             interface_options *interface_opts;
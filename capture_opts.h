@@ -21,6 +21,7 @@
 #include <sys/types.h>     /* for gid_t */
 
 #include <caputils/capture_ifinfo.h>
+#include <epan/prefs.h>     /* for DEFAULT_UPDATE_INTERVAL */
 
 #ifdef _WIN32
 #include <windows.h>
@@ -53,6 +54,7 @@ extern "C" {
 #define LONGOPT_NUM_CAP_COMMENT   128
 #define LONGOPT_LIST_TSTAMP_TYPES 129
 #define LONGOPT_SET_TSTAMP_TYPE   130
+#define LONGOPT_UPDATE_INTERVAL   131
 
 /*
  * Options for capturing common to all capturing programs.
@@ -93,7 +95,8 @@ extern "C" {
     {"snapshot-length",       required_argument, NULL, 's'}, \
     {"linktype",              required_argument, NULL, 'y'}, \
     {"list-time-stamp-types", no_argument,       NULL, LONGOPT_LIST_TSTAMP_TYPES}, \
-    {"time-stamp-type",       required_argument, NULL, LONGOPT_SET_TSTAMP_TYPE},
+    {"time-stamp-type",       required_argument, NULL, LONGOPT_SET_TSTAMP_TYPE}, \
+    {"update-interval",       required_argument, NULL, LONGOPT_UPDATE_INTERVAL},
 
 
 #define OPTSTRING_CAPTURE_COMMON \
@@ -283,6 +286,8 @@ typedef struct capture_options_tag {
     /* GUI related */
     gboolean           real_time_mode;        /**< Update list of packets in real time */
     gboolean           show_info;             /**< show the info dialog. */
+    guint              update_interval;       /**< ms between reports of new packets
+                                                   from the capture child */
     gboolean           restart;               /**< restart after closing is done */
     gchar             *orig_save_file;        /**< the original capture file name (saved for a restart) */
 
@@ -23,6 +23,8 @@ cap_file_init(capture_file *cf)
 {
   /* Initialize the capture file struct */
   memset(cf, 0, sizeof(capture_file));
+  nstime_set_unset(&cf->read_start);
+  nstime_set_unset(&cf->read_stop);
 }
 
 /*
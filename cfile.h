@@ -87,12 +87,17 @@ typedef struct _capture_file {
   guint32                     drops;                /* Dropped packets */
   nstime_t                    elapsed_time;         /* Elapsed time */
   int                         snap;                 /* Maximum captured packet length; 0 if unknown */
+  nstime_t                    read_start;           /* If set, read only records from this time on */
+  nstime_t                    read_stop;            /* If set, read only records before this time */
   dfilter_t                  *rfcode;               /* Compiled read filter program */
   dfilter_t                  *dfcode;               /* Compiled display filter program */
   gchar                      *dfilter;              /* Display filter string */
   gboolean                    redissecting;         /* TRUE if currently redissecting (cf_redissect_packets) */
+  gboolean                    filter_incomplete;    /* TRUE if the last rescan stopped before filtering every frame */
   gboolean                    read_lock;            /* TRUE if currently processing a file (cf_read) */
   rescan_type                 redissection_queued;  /* Queued redissection type. */
+  guint32                     dissection_gen;       /* Bumped when frames may dissect differently than before */
+  struct proto_presence      *proto_presence;       /* Protocols seen in each frame, if known */
   /* search */
   gchar                      *sfilter;              /* Filter, hex value, or string being searched */
   gboolean                    hex;                  /* TRUE if "Hex value" search was last selected */
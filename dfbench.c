@@ -0,0 +1,470 @@
+/* dfbench.c
+ * Measures how long display filters take to compile and to apply.
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include <config.h>
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <locale.h>
+#include <string.h>
+#include <errno.h>
+
+#ifdef HAVE_GETOPT_H
+#include <getopt.h>
+#endif
+
+#include <glib.h>
+
+#include <epan/epan.h>
+#include <epan/epan_dissect.h>
+#include <epan/timestamp.h>
+#include <epan/prefs.h>
+#include <epan/addr_resolv.h>
+#include <epan/frame_data.h>
+#include <epan/tvbuff.h>
+#include <epan/dfilter/dfilter.h>
+
+#ifdef HAVE_PLUGINS
+#include <wsutil/plugins.h>
+#endif
+#include <wsutil/filesystem.h>
+#include <wsutil/privileges.h>
+#include <wsutil/report_message.h>
+#include <wsutil/time_util.h>
+
+#ifndef HAVE_GETOPT_LONG
+#include "wsutil/wsgetopt.h"
+#endif
+
+#include <wiretap/wtap.h>
+
+#include "ui/failure_message.h"
+#include "ui/util.h"
+
+/* A filter and what we measured for it */
+typedef struct {
+	char		*text;
+	dfilter_t	*df;
+	guint64		compile_nsecs;	/* mean of all the compilations */
+} bench_filter_t;
+
+static void failure_warning_message(const char *msg_format, va_list ap);
+static void open_failure_message(const char *filename, int err,
+	gboolean for_writing);
+static void read_failure_message(const char *filename, int err);
+static void write_failure_message(const char *filename, int err);
+
+/* The session and frames are kept until we exit, as the trees refer to them */
+static epan_t *session;
+static GPtrArray *frames;
+
+static const nstime_t *
+dfbench_get_frame_ts(struct packet_provider_data *prov _U_, guint32 frame_num)
+{
+	if (frame_num == 0 || frame_num > frames->len)
+		return NULL;
+
+	return &((frame_data *)g_ptr_array_index(frames, frame_num - 1))->abs_ts;
+}
+
+static epan_t *
+dfbench_epan_new(void)
+{
+	static const struct packet_provider_funcs funcs = {
+		dfbench_get_frame_ts,
+		NULL,
+		NULL,
+		NULL
+	};
+
+	return epan_new(NULL, &funcs);
+}
+
+static void
+print_usage(FILE *output)
+{
+	fprintf(output, "Usage: dfbench [-n <passes>] [-c <count>] -r <infile> [-f <filter file>] [<filter> ...]\n");
+	fprintf(output, "\n");
+	fprintf(output, "  -r <infile>       read packets from <infile>\n");
+	fprintf(output, "  -c <count>        dissect at most <count> packets (default: 1000)\n");
+	fprintf(output, "  -n <passes>       compile and apply each filter <passes> times (default: 20)\n");
+	fprintf(output, "  -f <filter file>  read filters from <filter file>, one per line\n");
+}
+
+/* Add the filters in a file, one per line; blank lines and lines
+ * starting with '#' are skipped. */
+static gboolean
+read_filter_file(const char *path, GPtrArray *filters)
+{
+	gchar	*contents;
+	gchar	**lines;
+	GError	*error = NULL;
+	guint	i;
+
+	if (!g_file_get_contents(path, &contents, NULL, &error)) {
+		fprintf(stderr, "dfbench: %s\n", error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	lines = g_strsplit(contents, "\n", -1);
+	for (i = 0; lines[i] != NULL; i++) {
+		g_strstrip(lines[i]);
+		if (lines[i][0] == '\0' || lines[i][0] == '#')
+			continue;
+		g_ptr_array_add(filters, g_strdup(lines[i]));
+	}
+	g_strfreev(lines);
+	g_free(contents);
+	return TRUE;
+}
+
+/* Compile a filter "passes" times, keeping the last result */
+static gboolean
+compile_filter(bench_filter_t *bf, int passes)
+{
+	gchar	*err_msg;
+	guint64	start;
+	int	i;
+
+	start = get_monotonic_nsecs();
+	for (i = 0; i < passes; i++) {
+		dfilter_free(bf->df);
+		if (!dfilter_compile(bf->text, &bf->df, &err_msg)) {
+			fprintf(stderr, "dfbench: \"%s\": %s\n", bf->text, err_msg);
+			g_free(err_msg);
+			return FALSE;
+		}
+	}
+	bf->compile_nsecs = (get_monotonic_nsecs() - start) / passes;
+
+	if (bf->df == NULL) {
+		fprintf(stderr, "dfbench: \"%s\": filter is empty\n", bf->text);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Dissect up to max_packets packets, keeping their trees. Every tree is
+ * primed with the fields of every filter, as TShark does for -Y. */
+static GPtrArray *
+dissect_capture(const char *path, guint max_packets, GArray *bench_filters)
+{
+	wtap		*wth;
+	wtap_rec	rec;
+	Buffer		buf;
+	GPtrArray	*edts;
+	int		err = 0;
+	gchar		*err_info = NULL;
+	gint64		data_offset;
+	guint32		cum_bytes = 0;
+	nstime_t	elapsed_time;
+	const frame_data *ref = NULL;
+	frame_data	*prev_dis = NULL;
+	guint		i;
+
+	wth = wtap_open_offline(path, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+	if (wth == NULL) {
+		cfile_open_failure_message("dfbench", path, err, err_info);
+		return NULL;
+	}
+
+	session = dfbench_epan_new();
+	edts = g_ptr_array_new();
+	nstime_set_zero(&elapsed_time);
+	wtap_rec_init(&rec);
+	ws_buffer_init(&buf, 1514);
+
+	while (edts->len < max_packets &&
+	       wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+		epan_dissect_t	*edt;
+		frame_data	*fdata;
+		tvbuff_t	*tvb;
+		guint8		*data;
+
+		fdata = g_new(frame_data, 1);
+		frame_data_init(fdata, frames->len + 1, &rec, data_offset, cum_bytes);
+		g_ptr_array_add(frames, fdata);
+
+		/* The tree refers to the packet data, so give each packet
+		 * its own copy. */
+		data = (guint8 *)g_memdup(ws_buffer_start_ptr(&buf), rec.rec_header.packet_header.caplen);
+		tvb = tvb_new_real_data(data, rec.rec_header.packet_header.caplen,
+					rec.rec_header.packet_header.len);
+		tvb_set_free_cb(tvb, g_free);
+
+		edt = epan_dissect_new(session, TRUE, FALSE);
+		for (i = 0; i < bench_filters->len; i++) {
+			epan_dissect_prime_with_dfilter(edt,
+				g_array_index(bench_filters, bench_filter_t, i).df);
+		}
+
+		frame_data_set_before_dissect(fdata, &elapsed_time, &ref, prev_dis);
+		epan_dissect_run(edt, wtap_file_type_subtype(wth), &rec, tvb, fdata, NULL);
+		frame_data_set_after_dissect(fdata, &cum_bytes);
+		prev_dis = fdata;
+
+		g_ptr_array_add(edts, edt);
+	}
+
+	if (err != 0 && edts->len < max_packets) {
+		cfile_read_failure_message("dfbench", path, err, err_info);
+	}
+
+	wtap_rec_cleanup(&rec);
+	ws_buffer_free(&buf);
+	wtap_close(wth);
+	return edts;
+}
+
+static guint
+apply_filter(dfilter_t *df, GPtrArray *edts)
+{
+	guint	matches = 0;
+	guint	i;
+
+	for (i = 0; i < edts->len; i++) {
+		if (dfilter_apply_edt(df, (epan_dissect_t *)g_ptr_array_index(edts, i)))
+			matches++;
+	}
+	return matches;
+}
+
+static void
+bench_filter(const bench_filter_t *bf, GPtrArray *edts, int passes)
+{
+	dfilter_profile_t profile;
+	guint64	start, apply_nsecs;
+	guint64	total_insns = 0, total_nsecs = 0;
+	guint	matches;
+	int	i, cls;
+
+	/* The first pass warms up the caches and counts the matches */
+	matches = apply_filter(bf->df, edts);
+
+	start = get_monotonic_nsecs();
+	for (i = 0; i < passes; i++) {
+		apply_filter(bf->df, edts);
+	}
+	apply_nsecs = get_monotonic_nsecs() - start;
+
+	/* The breakdown comes from a separate, slower, pass */
+	dfilter_set_profiling(bf->df, TRUE);
+	apply_filter(bf->df, edts);
+	dfilter_get_profile(bf->df, &profile);
+	dfilter_set_profiling(bf->df, FALSE);
+
+	for (cls = 0; cls < DFILTER_PROFILE_NUM_CLASSES; cls++) {
+		total_insns += profile.insns[cls];
+		total_nsecs += profile.nsecs[cls];
+	}
+
+	printf("%10.1f %8u %10.1f %8.1f",
+	       bf->compile_nsecs / 1000.0,
+	       matches,
+	       (double)apply_nsecs / ((double)passes * edts->len),
+	       (double)total_insns / edts->len);
+	for (cls = 0; cls < DFILTER_PROFILE_NUM_CLASSES; cls++) {
+		printf(" %6.1f%%", total_nsecs ? 100.0 * profile.nsecs[cls] / total_nsecs : 0.0);
+	}
+	printf("  %s\n", bf->text);
+}
+
+int
+main(int argc, char **argv)
+{
+	char		*init_progfile_dir_error;
+	const char	*infile = NULL;
+	guint		max_packets = 1000;
+	int		passes = 20;
+	GPtrArray	*filter_texts;
+	GArray		*bench_filters;
+	GPtrArray	*edts;
+	int		opt;
+	guint		i;
+	int		ret = 0;
+
+	/*
+	 * Get credential information for later use.
+	 */
+	init_process_policies();
+
+	/*
+	 * Attempt to get the pathname of the directory containing the
+	 * executable file.
+	 */
+	init_progfile_dir_error = init_progfile_dir(argv[0]);
+	if (init_progfile_dir_error != NULL) {
+		fprintf(stderr, "dfbench: Can't get pathname of directory containing the dfbench program: %s.\n",
+			init_progfile_dir_error);
+		g_free(init_progfile_dir_error);
+	}
+
+	init_report_message(failure_warning_message, failure_warning_message,
+			    open_failure_message, read_failure_message,
+			    write_failure_message);
+
+	filter_texts = g_ptr_array_new_with_free_func(g_free);
+	while ((opt = getopt(argc, argv, "c:f:hn:r:")) != -1) {
+		switch (opt) {
+		case 'c':
+			max_packets = (guint)strtoul(optarg, NULL, 10);
+			break;
+		case 'f':
+			if (!read_filter_file(optarg, filter_texts))
+				exit(1);
+			break;
+		case 'h':
+			print_usage(stdout);
+			exit(0);
+		case 'n':
+			passes = atoi(optarg);
+			break;
+		case 'r':
+			infile = optarg;
+			break;
+		default:
+			print_usage(stderr);
+			exit(1);
+		}
+	}
+	for (; optind < argc; optind++) {
+		g_ptr_array_add(filter_texts, g_strdup(argv[optind]));
+	}
+
+	if (infile == NULL || filter_texts->len == 0 || max_packets == 0 || passes <= 0) {
+		print_usage(stderr);
+		exit(1);
+	}
+
+	timestamp_set_type(TS_RELATIVE);
+	timestamp_set_seconds_type(TS_SECONDS_DEFAULT);
+
+	wtap_init(TRUE);
+
+	if (!epan_init(NULL, NULL, FALSE))
+		return 2;
+
+	/* set the c-language locale to the native environment. */
+	setlocale(LC_ALL, "");
+
+	/* Load libwireshark settings from the current profile. */
+	epan_load_settings();
+	prefs_apply_all();
+
+	/* Name lookups would swamp the time spent dissecting */
+	disable_name_resolution();
+
+	/* The filters have to be compiled first, to prime the trees */
+	bench_filters = g_array_new(FALSE, TRUE, sizeof(bench_filter_t));
+	for (i = 0; i < filter_texts->len; i++) {
+		bench_filter_t bf = { (char *)g_ptr_array_index(filter_texts, i), NULL, 0 };
+
+		g_array_append_val(bench_filters, bf);
+		if (!compile_filter(&g_array_index(bench_filters, bench_filter_t, i), passes)) {
+			ret = 2;
+			goto cleanup;
+		}
+	}
+
+	frames = g_ptr_array_new_with_free_func(g_free);
+	edts = dissect_capture(infile, max_packets, bench_filters);
+	if (edts == NULL) {
+		ret = 2;
+		goto cleanup;
+	}
+	if (edts->len == 0) {
+		fprintf(stderr, "dfbench: \"%s\" has no packets\n", infile);
+		ret = 2;
+	} else {
+		printf("%u packets, %d passes\n", edts->len, passes);
+		printf("Instruction time: Tree = READ_TREE and CHECK_EXISTS, Compare = relations,\n"
+		       "Func = CALL_FUNCTION, Other = jumps, NOT and RETURN\n\n");
+		printf("%10s %8s %10s %8s %7s %7s %7s %7s  %s\n",
+		       "Compile us", "Matches", "ns/packet", "Insns", "Tree", "Compare", "Func", "Other", "Filter");
+		for (i = 0; i < bench_filters->len; i++) {
+			bench_filter(&g_array_index(bench_filters, bench_filter_t, i), edts, passes);
+		}
+	}
+
+	for (i = 0; i < edts->len; i++) {
+		epan_dissect_free((epan_dissect_t *)g_ptr_array_index(edts, i));
+	}
+	g_ptr_array_free(edts, TRUE);
+
+cleanup:
+	for (i = 0; i < bench_filters->len; i++) {
+		dfilter_free(g_array_index(bench_filters, bench_filter_t, i).df);
+	}
+	g_array_free(bench_filters, TRUE);
+	g_ptr_array_free(filter_texts, TRUE);
+	if (frames)
+		g_ptr_array_free(frames, TRUE);
+	epan_free(session);
+	epan_cleanup();
+	wtap_cleanup();
+	return ret;
+}
+
+/*
+ * General errors and warnings are reported with an console message
+ * in "dfbench".
+ */
+static void
+failure_warning_message(const char *msg_format, va_list ap)
+{
+	fprintf(stderr, "dfbench: ");
+	vfprintf(stderr, msg_format, ap);
+	fprintf(stderr, "\n");
+}
+
+/*
+ * Open/create errors are reported with an console message in "dfbench".
+ */
+static void
+open_failure_message(const char *filename, int err, gboolean for_writing)
+{
+	fprintf(stderr, "dfbench: ");
+	fprintf(stderr, file_open_error_message(err, for_writing), filename);
+	fprintf(stderr, "\n");
+}
+
+/*
+ * Read errors are reported with an console message in "dfbench".
+ */
+static void
+read_failure_message(const char *filename, int err)
+{
+	fprintf(stderr, "dfbench: An error occurred while reading from the file \"%s\": %s.\n",
+		filename, g_strerror(err));
+}
+
+/*
+ * Write errors are reported with an console message in "dfbench".
+ */
+static void
+write_failure_message(const char *filename, int err)
+{
+	fprintf(stderr, "dfbench: An error occurred while writing to the file \"%s\": %s.\n",
+		filename, g_strerror(err));
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
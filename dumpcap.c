@@ -114,6 +114,8 @@ FILE *debug_log;   /* for logging debug messages to  */
 static GAsyncQueue *pcap_queue;
 static gint64 pcap_queue_bytes;
 static gint64 pcap_queue_packets;
+static gint64 pcap_queue_max_bytes;     /* high-water marks, logged when the capture stops */
+static gint64 pcap_queue_max_packets;
 static gint64 pcap_queue_byte_limit = 0;
 static gint64 pcap_queue_packet_limit = 0;
 
@@ -190,6 +192,28 @@ static void cap_pipe_close(int pipe_fd, gboolean from_socket);
 #define MUST_DO_SELECT
 #endif
 
+#ifdef MUST_DO_SELECT
+#ifdef HAVE_PCAP_BREAKLOOP
+/*
+ * Once select() says packets are available, hand at most this many of them
+ * to pcap_dispatch() at a time.  capture_loop_stop() interrupts the batch
+ * with pcap_breakloop(), and the callbacks check the autostop and ring
+ * buffer conditions for every packet; the limit keeps the time between
+ * returns to the capture loop (timers, statistics) short while the packets
+ * keep coming, and saves a select() per packet.
+ */
+#define DISPATCH_BATCH_COUNT 64
+#else
+/*
+ * We don't have pcap_breakloop(), so we only process one packet per
+ * pcap_dispatch() call, to allow a signal to stop the processing
+ * immediately, rather than processing all packets in a batch before
+ * quitting.
+ */
+#define DISPATCH_BATCH_COUNT 1
+#endif
+#endif
+
 /** init the capture filter */
 typedef enum {
     INITFILTER_NO_ERROR,
@@ -257,6 +281,9 @@ typedef struct _capture_src {
     char *                       cap_pipe_databuf;       /**< Pointer to the data buffer we've allocated */
     size_t                       cap_pipe_databuf_size;  /**< Current size of the data buffer */
     guint                        cap_pipe_max_pkt_size;  /**< Maximum packet size allowed */
+    char *                       cap_pipe_readbuf;       /**< Read-ahead buffer used by cap_pipe_read_data_bytes */
+    size_t                       cap_pipe_readbuf_pos;   /**< Offset of the first unused byte in cap_pipe_readbuf */
+    size_t                       cap_pipe_readbuf_len;   /**< Number of bytes read into cap_pipe_readbuf */
 #if defined(_WIN32)
     char *                       cap_pipe_buf;           /**< Pointer to the buffer we read into */
     DWORD                        cap_pipe_bytes_to_read; /**< Used by cap_pipe_dispatch */
@@ -464,6 +491,7 @@ print_usage(FILE *output)
     fprintf(output, "                           (only for pcapng)\n");
     fprintf(output, "\n");
     fprintf(output, "Miscellaneous:\n");
+    fprintf(output, "  --update-interval        interval between updates with new packets (def: %dms)\n", DEFAULT_UPDATE_INTERVAL);
     fprintf(output, "  -N <packet_limit>        maximum number of packets buffered within dumpcap\n");
     fprintf(output, "  -C <byte_limit>          maximum number of bytes used for buffering packets\n");
     fprintf(output, "                           within dumpcap\n");
@@ -1456,7 +1484,18 @@ cap_pipe_close(int pipe_fd, gboolean from_socket)
 #endif
 }
 
+/*
+ * Size of the read-ahead buffer of cap_pipe_read_data_bytes().  Reading as
+ * much as the pipe has, rather than exactly the rest of the current block
+ * header or block, saves a select() and a read() for most pcapng blocks
+ * coming from a busy pipe.
+ */
+#define CAP_PIPE_READBUF_SIZE (64 * 1024)
+
 /** Read bytes from a capture source, which is assumed to be a pipe.
+ *
+ * Data already in the read-ahead buffer is used first; requests at least
+ * as large as the buffer are read directly into cap_pipe_databuf.
  *
  * Returns -1, or the number of bytes read similar to read(2).
  * Sets pcap_src->cap_pipe_err on error or EOF.
@@ -1472,6 +1511,9 @@ cap_pipe_read_data_bytes(capture_src *pcap_src, char *errmsg, size_t errmsgl)
     ssize_t sz, bytes_read = 0;
 #endif /* _WIN32 */
     ssize_t b;
+    size_t  n;
+    char   *dest;
+    gboolean direct;
 
 #ifdef LOG_CAPTURE_VERBOSE
     g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_DEBUG, "cap_pipe_read_data_bytes read %lu of %lu",
@@ -1479,6 +1521,16 @@ cap_pipe_read_data_bytes(capture_src *pcap_src, char *errmsg, size_t errmsgl)
 #endif
     sz = pcap_src->cap_pipe_bytes_to_read - pcap_src->cap_pipe_bytes_read;
     while (bytes_read < sz) {
+        dest = pcap_src->cap_pipe_databuf + pcap_src->cap_pipe_bytes_read + bytes_read;
+        if (pcap_src->cap_pipe_readbuf_pos < pcap_src->cap_pipe_readbuf_len) {
+            n = MIN(pcap_src->cap_pipe_readbuf_len - pcap_src->cap_pipe_readbuf_pos,
+                    (size_t)(sz - bytes_read));
+            memcpy(dest, pcap_src->cap_pipe_readbuf + pcap_src->cap_pipe_readbuf_pos, n);
+            pcap_src->cap_pipe_readbuf_pos += n;
+            bytes_read += n;
+            continue;
+        }
+
         if (fd == -1) {
             g_snprintf(errmsg, (gulong)errmsgl, "Invalid file descriptor.");
             pcap_src->cap_pipe_err = PIPNEXIST;
@@ -1492,8 +1544,16 @@ cap_pipe_read_data_bytes(capture_src *pcap_src, char *errmsg, size_t errmsgl)
             pcap_src->cap_pipe_err = PIPERR;
             return -1;
         } else if (sel_ret > 0) {
-            b = cap_pipe_read(fd, pcap_src->cap_pipe_databuf+pcap_src->cap_pipe_bytes_read+bytes_read,
-                              sz-bytes_read, pcap_src->from_cap_socket);
+            direct = (size_t)(sz - bytes_read) >= CAP_PIPE_READBUF_SIZE;
+            if (direct) {
+                b = cap_pipe_read(fd, dest, sz-bytes_read, pcap_src->from_cap_socket);
+            } else {
+                if (pcap_src->cap_pipe_readbuf == NULL) {
+                    pcap_src->cap_pipe_readbuf = (char *)g_malloc(CAP_PIPE_READBUF_SIZE);
+                }
+                b = cap_pipe_read(fd, pcap_src->cap_pipe_readbuf, CAP_PIPE_READBUF_SIZE,
+                                  pcap_src->from_cap_socket);
+            }
             if (b <= 0) {
                 if (b == 0) {
                     g_snprintf(errmsg, (gulong)errmsgl,
@@ -1515,7 +1575,12 @@ cap_pipe_read_data_bytes(capture_src *pcap_src, char *errmsg, size_t errmsgl)
                 }
                 return -1;
             }
-            bytes_read += b;
+            if (direct) {
+                bytes_read += b;
+            } else {
+                pcap_src->cap_pipe_readbuf_pos = 0;
+                pcap_src->cap_pipe_readbuf_len = b;
+            }
         }
     }
     pcap_src->cap_pipe_bytes_read += bytes_read;
@@ -2922,6 +2987,10 @@ static void capture_loop_close_input(loop_data *ld)
                 g_free(pcap_src->cap_pipe_databuf);
                 pcap_src->cap_pipe_databuf = NULL;
             }
+            g_free(pcap_src->cap_pipe_readbuf);
+            pcap_src->cap_pipe_readbuf = NULL;
+            pcap_src->cap_pipe_readbuf_pos = 0;
+            pcap_src->cap_pipe_readbuf_len = 0;
             if (pcap_src->from_pcapng) {
                 g_array_free(pcap_src->cap_pipe_info.pcapng.src_iface_to_global, TRUE);
                 pcap_src->cap_pipe_info.pcapng.src_iface_to_global = NULL;
@@ -2951,7 +3020,15 @@ capture_loop_init_filter(pcap_t *pcap_h, gboolean from_cap_pipe,
 
     /* capture filters only work on real interfaces */
     if (cfilter && !from_cap_pipe) {
-        /* A capture filter was specified; set it up. */
+        /*
+         * A capture filter was specified; set it up.
+         *
+         * Where the OS supports it (BPF, Linux socket filters), libpcap
+         * runs the filter in the kernel, so rejected packets are never
+         * copied to us.  Display filters are not translated into capture
+         * filters here: dumpcap doesn't link with libwireshark, whose
+         * field registry the display filter compiler needs.
+         */
         if (!compile_capture_filter(name, pcap_h, &fcode, cfilter)) {
             /* Treat this specially - our caller might try to compile this
                as a display filter and, if that succeeds, warn the user that
@@ -3247,13 +3324,18 @@ capture_loop_dispatch(loop_data *ld,
 #ifdef _WIN32
         if (pcap_src->from_cap_socket) {
 #endif
-            sel_ret = cap_pipe_select(pcap_src->cap_pipe_fd);
-            if (sel_ret <= 0) {
-                if (sel_ret < 0 && errno != EINTR) {
-                    g_snprintf(errmsg, errmsg_len,
-                            "Unexpected error from select: %s", g_strerror(errno));
-                    report_capture_error(errmsg, please_report_bug());
-                    ld->go = FALSE;
+            if (pcap_src->cap_pipe_readbuf_pos < pcap_src->cap_pipe_readbuf_len) {
+                /* cap_pipe_read_data_bytes() already has data for us */
+                sel_ret = 1;
+            } else {
+                sel_ret = cap_pipe_select(pcap_src->cap_pipe_fd);
+                if (sel_ret <= 0) {
+                    if (sel_ret < 0 && errno != EINTR) {
+                        g_snprintf(errmsg, errmsg_len,
+                                "Unexpected error from select: %s", g_strerror(errno));
+                        report_capture_error(errmsg, please_report_bug());
+                        ld->go = FALSE;
+                    }
                 }
             }
 #ifdef _WIN32
@@ -3302,17 +3384,12 @@ capture_loop_dispatch(loop_data *ld,
             if (sel_ret > 0) {
                 /*
                  * "select()" says we can read from it without blocking; go for
-                 * it.
-                 *
-                 * We don't have pcap_breakloop(), so we only process one packet
-                 * per pcap_dispatch() call, to allow a signal to stop the
-                 * processing immediately, rather than processing all packets
-                 * in a batch before quitting.
+                 * it, see DISPATCH_BATCH_COUNT for how many packets we take.
                  */
                 if (use_threads) {
-                    inpkts = pcap_dispatch(pcap_src->pcap_h, 1, capture_loop_queue_packet_cb, (u_char *)pcap_src);
+                    inpkts = pcap_dispatch(pcap_src->pcap_h, DISPATCH_BATCH_COUNT, capture_loop_queue_packet_cb, (u_char *)pcap_src);
                 } else {
-                    inpkts = pcap_dispatch(pcap_src->pcap_h, 1, capture_loop_write_packet_cb, (u_char *)pcap_src);
+                    inpkts = pcap_dispatch(pcap_src->pcap_h, DISPATCH_BATCH_COUNT, capture_loop_write_packet_cb, (u_char *)pcap_src);
                 }
                 if (inpkts < 0) {
                     if (inpkts == -1) {
@@ -3570,26 +3647,55 @@ capture_loop_open_output(capture_options *capture_opts, int *save_file_fd,
         } else {
             suffix = ".pcap";
         }
-        *save_file_fd = create_tempfile(&tmpname, prefix, suffix);
+        if (capture_opts->multi_files_on) {
+            /*
+             * Ringbuffer without a file name; put the files in a
+             * private directory under the temporary directory, so that
+             * a long-running capture only keeps the last few files
+             * around. The ringbuffer file names are predictable, so
+             * they must not be created in a world-writable directory.
+             */
+            gchar *dirtemplate = g_strconcat(prefix, "_XXXXXX", NULL);
+            gchar *ringdir = g_build_filename(g_get_tmp_dir(), dirtemplate, NULL);
+            gchar *ringname = g_strconcat(prefix, suffix, NULL);
+
+            g_free(dirtemplate);
+            if (g_mkdtemp(ringdir) == NULL) {
+                capfile_name = ringdir;
+                *save_file_fd = -1;
+            } else {
+                capfile_name = g_build_filename(ringdir, ringname, NULL);
+                g_free(ringdir);
+                *save_file_fd = ringbuf_init(capfile_name,
+                                             (capture_opts->has_ring_num_files) ? capture_opts->ring_num_files : 0,
+                                             capture_opts->group_read_access);
+                if (*save_file_fd != -1) {
+                    g_free(capfile_name);
+                    capfile_name = NULL;
+                }
+            }
+            g_free(ringname);
+        } else {
+            *save_file_fd = create_tempfile(&tmpname, prefix, suffix);
+            capfile_name = g_strdup(tmpname);
+        }
         g_free(prefix);
-        capfile_name = g_strdup(tmpname);
         is_tempfile = TRUE;
     }
 
     /* did we fail to open the output file? */
     if (*save_file_fd == -1) {
+        if (capture_opts->multi_files_on) {
+            /* Ensures that the ringbuffer is not used. This ensures that
+             * !ringbuf_is_initialized() is equivalent to
+             * capture_opts->save_file not being part of ringbuffer. */
+            ringbuf_error_cleanup();
+        }
         if (is_tempfile) {
             g_snprintf(errmsg, errmsg_len,
                        "The temporary file to which the capture would be saved (\"%s\") "
                        "could not be opened: %s.", capfile_name, g_strerror(errno));
         } else {
-            if (capture_opts->multi_files_on) {
-                /* Ensures that the ringbuffer is not used. This ensures that
-                 * !ringbuf_is_initialized() is equivalent to
-                 * capture_opts->save_file not being part of ringbuffer. */
-                ringbuf_error_cleanup();
-            }
-
             g_snprintf(errmsg, errmsg_len,
                        "The file to which the capture would be saved (\"%s\") "
                        "could not be opened: %s.", capfile_name,
@@ -3600,7 +3706,7 @@ capture_loop_open_output(capture_options *capture_opts, int *save_file_fd,
     }
 
     g_free(capture_opts->save_file);
-    if (!is_tempfile && capture_opts->multi_files_on) {
+    if (capture_opts->multi_files_on) {
         /* In ringbuffer mode, save_file points to a filename from ringbuffer.c.
          * capfile_name was already freed before. */
         capture_opts->save_file = (char *)ringbuf_current_filename();
@@ -3625,6 +3731,7 @@ static gboolean
 do_file_switch_or_stop(capture_options *capture_opts)
 {
     gboolean          successful;
+    gint64            switch_start;
 
     if (capture_opts->multi_files_on) {
         if (capture_opts->has_autostop_files &&
@@ -3635,6 +3742,7 @@ do_file_switch_or_stop(capture_options *capture_opts)
         }
 
         /* Switch to the next ringbuffer file */
+        switch_start = g_get_monotonic_time();
         if (ringbuf_switch_file(&global_ld.pdh, &capture_opts->save_file,
                                 &global_ld.save_file_fd, &global_ld.err)) {
 
@@ -3665,6 +3773,9 @@ do_file_switch_or_stop(capture_options *capture_opts)
                 global_ld.next_interval_time = get_next_time_interval(global_ld.interval_s);
             }
             fflush(global_ld.pdh);
+            g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
+                  "Switched to file %s in %.3fms", capture_opts->save_file,
+                  (g_get_monotonic_time() - switch_start) / 1000.0);
             if (!quiet)
                 report_packet_count(global_ld.inpkts_to_sync_pipe);
             global_ld.inpkts_to_sync_pipe = 0;
@@ -3703,46 +3814,67 @@ pcap_read_handler(void* arg)
     return (NULL);
 }
 
-/* Try to pop an item off the packet queue and if it exists, write it */
-static gboolean
-capture_loop_dequeue_packet(void) {
+/*
+ * The most packets the writer takes off the packet queue while holding the
+ * queue lock once; the capture threads only have to wait for the pops, not
+ * for the writes.
+ */
+#define DEQUEUE_BATCH_COUNT 64
+
+/* Write one element taken off the packet queue and free it */
+static void
+capture_loop_write_queue_element(pcap_queue_element *queue_element)
+{
+    if (queue_element->pcap_src->from_pcapng) {
+        g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
+              "Dequeued a block of type 0x%08x of length %d captured on interface %d.",
+              queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
+              queue_element->pcap_src->interface_id);
+
+        capture_loop_write_pcapng_cb(queue_element->pcap_src,
+                                    &queue_element->u.bh,
+                                    queue_element->pd);
+    } else {
+        g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
+            "Dequeued a packet of length %d captured on interface %d.",
+            queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
+
+        capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
+                                    &queue_element->u.phdr,
+                                    queue_element->pd);
+    }
+    g_free(queue_element->pd);
+    g_free(queue_element);
+}
+
+/* Try to pop items off the packet queue and write the ones we got.
+   Returns the number of items written. */
+static int
+capture_loop_dequeue_packets(void) {
+    pcap_queue_element *queue_elements[DEQUEUE_BATCH_COUNT];
     pcap_queue_element *queue_element;
+    int                 count = 0;
+    int                 i;
 
     g_async_queue_lock(pcap_queue);
     queue_element = (pcap_queue_element *)g_async_queue_timeout_pop_unlocked(pcap_queue, WRITER_THREAD_TIMEOUT);
-    if (queue_element) {
+    while (queue_element) {
         if (queue_element->pcap_src->from_pcapng) {
             pcap_queue_bytes -= queue_element->u.bh.block_total_length;
         } else {
             pcap_queue_bytes -= queue_element->u.phdr.caplen;
         }
         pcap_queue_packets -= 1;
+        queue_elements[count++] = queue_element;
+        if (count == DEQUEUE_BATCH_COUNT)
+            break;
+        queue_element = (pcap_queue_element *)g_async_queue_try_pop_unlocked(pcap_queue);
     }
     g_async_queue_unlock(pcap_queue);
-    if (queue_element) {
-        if (queue_element->pcap_src->from_pcapng) {
-            g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
-                  "Dequeued a block of type 0x%08x of length %d captured on interface %d.",
-                  queue_element->u.bh.block_type, queue_element->u.bh.block_total_length,
-                  queue_element->pcap_src->interface_id);
-
-            capture_loop_write_pcapng_cb(queue_element->pcap_src,
-                                        &queue_element->u.bh,
-                                        queue_element->pd);
-        } else {
-            g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
-                "Dequeued a packet of length %d captured on interface %d.",
-                queue_element->u.phdr.caplen, queue_element->pcap_src->interface_id);
-
-            capture_loop_write_packet_cb((u_char *) queue_element->pcap_src,
-                                        &queue_element->u.phdr,
-                                        queue_element->pd);
-        }
-        g_free(queue_element->pd);
-        g_free(queue_element);
-        return TRUE;
+    for (i = 0; i < count; i++) {
+        capture_loop_write_queue_element(queue_elements[i]);
     }
-    return FALSE;
+    return count;
 }
 
 /* Do the low-level work of a capture.
@@ -3894,6 +4026,8 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
         pcap_queue = g_async_queue_new();
         pcap_queue_bytes = 0;
         pcap_queue_packets = 0;
+        pcap_queue_max_bytes = 0;
+        pcap_queue_max_packets = 0;
         for (i = 0; i < global_ld.pcaps->len; i++) {
             pcap_src = g_array_index(global_ld.pcaps, capture_src *, i);
             /* XXX - Add an interface name here? */
@@ -3903,13 +4037,7 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
     while (global_ld.go) {
         /* dispatch incoming packets */
         if (use_threads) {
-            gboolean dequeued = capture_loop_dequeue_packet();
-
-            if (dequeued) {
-                inpkts = 1;
-            } else {
-                inpkts = 0;
-            }
+            inpkts = capture_loop_dequeue_packets();
         } else {
             pcap_src = g_array_index(global_ld.pcaps, capture_src *, 0);
             inpkts = capture_loop_dispatch(&global_ld, errmsg,
@@ -3953,19 +4081,17 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
             }
         } /* inpkts */
 
-        /* Only update once every 500ms so as not to overload slow displays.
-         * This also prevents too much context-switching between the dumpcap
-         * and wireshark processes.
+        /* Only update once every update_interval ms (--update-interval)
+         * so as not to overload slow displays. This also prevents too much
+         * context-switching between the dumpcap and wireshark processes.
          */
-#define DUMPCAP_UPD_TIME 500
-
 #ifdef _WIN32
         cur_time = GetTickCount();  /* Note: wraps to 0 if sys runs for 49.7 days */
-        if ((cur_time - upd_time) > DUMPCAP_UPD_TIME) /* wrap just causes an extra update */
+        if ((cur_time - upd_time) > capture_opts->update_interval) /* wrap just causes an extra update */
 #else
         gettimeofday(&cur_time, NULL);
         if (((guint64)cur_time.tv_sec * 1000000 + cur_time.tv_usec) >
-            ((guint64)upd_time.tv_sec * 1000000 + upd_time.tv_usec + DUMPCAP_UPD_TIME*1000))
+            ((guint64)upd_time.tv_sec * 1000000 + upd_time.tv_usec + (guint64)capture_opts->update_interval*1000))
 #endif
         {
 
@@ -4024,15 +4150,23 @@ capture_loop_start(capture_options *capture_opts, gboolean *stats_known, struct
                   pcap_src->interface_id);
         }
         while (1) {
-            gboolean dequeued = capture_loop_dequeue_packet();
-            if (!dequeued) {
+            int dequeued = capture_loop_dequeue_packets();
+            if (dequeued == 0) {
                 break;
             }
-            global_ld.inpkts_to_sync_pipe += 1;
+            global_ld.inpkts_to_sync_pipe += dequeued;
             if (capture_opts->output_to_pipe) {
                 fflush(global_ld.pdh);
             }
         }
+        /*
+         * A high-water mark close to the queue limits (-N / -C) means the
+         * packets were lost between the capture threads and the file,
+         * rather than in the kernel.
+         */
+        g_log(LOG_DOMAIN_CAPTURE_CHILD, G_LOG_LEVEL_INFO,
+              "Packet queue high-water mark was %" G_GINT64_MODIFIER "d bytes (%" G_GINT64_MODIFIER "d packets)",
+              pcap_queue_max_bytes, pcap_queue_max_packets);
     }
 
 
@@ -4450,6 +4584,10 @@ capture_loop_queue_packet_cb(u_char *pcap_src_p, const struct pcap_pkthdr *phdr,
         g_async_queue_push_unlocked(pcap_queue, queue_element);
         pcap_queue_bytes += phdr->caplen;
         pcap_queue_packets += 1;
+        if (pcap_queue_bytes > pcap_queue_max_bytes)
+            pcap_queue_max_bytes = pcap_queue_bytes;
+        if (pcap_queue_packets > pcap_queue_max_packets)
+            pcap_queue_max_packets = pcap_queue_packets;
     } else {
         limit_reached = TRUE;
     }
@@ -4510,6 +4648,10 @@ capture_loop_queue_pcapng_cb(capture_src *pcap_src, const pcapng_block_header_t
         g_async_queue_push_unlocked(pcap_queue, queue_element);
         pcap_queue_bytes += bh->block_total_length;
         pcap_queue_packets += 1;
+        if (pcap_queue_bytes > pcap_queue_max_bytes)
+            pcap_queue_max_bytes = pcap_queue_bytes;
+        if (pcap_queue_packets > pcap_queue_max_packets)
+            pcap_queue_max_packets = pcap_queue_packets;
     } else {
         limit_reached = TRUE;
     }
@@ -4960,6 +5102,7 @@ main(int argc, char *argv[])
         case 'g':        /* enable group read access on file(s) */
         case 'i':        /* Use interface x */
         case LONGOPT_SET_TSTAMP_TYPE: /* Set capture timestamp type */
+        case LONGOPT_UPDATE_INTERVAL: /* Set the update interval */
         case 'n':        /* Use pcapng format */
         case 'p':        /* Don't capture in promiscuous mode */
         case 'P':        /* Use pcap format */
@@ -5140,10 +5283,11 @@ main(int argc, char *argv[])
         /* Was the ring buffer option specified and, if so, does it make sense? */
         if (global_capture_opts.multi_files_on) {
             /* Ring buffer works only under certain conditions:
-               a) ring buffer does not work with temporary files;
+               a) ring buffer does not work with temporary files, unless
+                  Wireshark runs us and removes the old files itself;
                b) it makes no sense to enable the ring buffer if the maximum
                file size is set to "infinite". */
-            if (global_capture_opts.save_file == NULL) {
+            if (global_capture_opts.save_file == NULL && !capture_child) {
                 cmdarg_err("Ring buffer requested, but capture isn't being saved to a permanent file.");
                 global_capture_opts.multi_files_on = FALSE;
             }
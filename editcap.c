@@ -114,6 +114,16 @@ static fd_hash_t fd_hash[MAX_DUP_DEPTH];
 static int       dup_window    = DEFAULT_DUP_DEPTH;
 static int       cur_dup_entry = 0;
 
+/*
+ * With -d/-D the fd_hash[] entries of the window are also chained into
+ * hash buckets by digest and length, so that looking for a duplicate
+ * doesn't compare against every entry of a large window.
+ */
+#define DUP_NOT_IN_BUCKET  -2    /* dup_next[] value for an unused entry */
+static int      *dup_bucket;     /* bucket -> most recent fd_hash[] entry, or -1 */
+static int      *dup_next;       /* fd_hash[] entry -> next in its bucket, or -1 */
+static guint32   dup_bucket_mask;
+
 static guint32   ignored_bytes  = 0;  /* Used with -I */
 
 #define ONE_BILLION 1000000000
@@ -583,9 +593,53 @@ remove_vlan_info(const wtap_packet_header *phdr, guint8* fd, guint32* len) {
     }
 }
 
+static void
+dup_buckets_init(void)
+{
+    guint32 n_buckets = 1;
+    int i;
+
+    while (n_buckets < (guint32)dup_window)
+        n_buckets <<= 1;
+    dup_bucket_mask = n_buckets - 1;
+
+    dup_bucket = g_new(int, n_buckets);
+    for (i = 0; i < (int)n_buckets; i++)
+        dup_bucket[i] = -1;
+    dup_next = g_new(int, dup_window > 0 ? dup_window : 1);
+    for (i = 0; i < (dup_window > 0 ? dup_window : 1); i++)
+        dup_next[i] = DUP_NOT_IN_BUCKET;
+}
+
+static guint32
+dup_bucket_of(const fd_hash_t *entry)
+{
+    guint32 h;
+
+    memcpy(&h, entry->digest, sizeof h);
+    return (h ^ entry->len) & dup_bucket_mask;
+}
+
+static void
+dup_bucket_remove(int entry)
+{
+    int *link;
+
+    if (dup_next[entry] == DUP_NOT_IN_BUCKET)
+        return;
+
+    for (link = &dup_bucket[dup_bucket_of(&fd_hash[entry])];
+         *link != entry; link = &dup_next[*link])
+        ;
+    *link = dup_next[entry];
+    dup_next[entry] = DUP_NOT_IN_BUCKET;
+}
+
 static gboolean
 is_duplicate(guint8* fd, guint32 len) {
     int i;
+    guint32 bucket;
+    gboolean dup = FALSE;
     const struct ieee80211_radiotap_header* tap_header;
 
     /*Hint to ignore some bytes at the start of the frame for the digest calculation(-I option) */
@@ -612,23 +666,28 @@ is_duplicate(guint8* fd, guint32 len) {
     if (cur_dup_entry >= dup_window)
         cur_dup_entry = 0;
 
+    /* The entry we're about to overwrite leaves the window */
+    dup_bucket_remove(cur_dup_entry);
+
     /* Calculate our digest */
     gcry_md_hash_buffer(GCRY_MD_MD5, fd_hash[cur_dup_entry].digest, new_fd, new_len);
 
     fd_hash[cur_dup_entry].len = len;
 
-    /* Look for duplicates */
-    for (i = 0; i < dup_window; i++) {
-        if (i == cur_dup_entry)
-            continue;
-
+    /* Look for duplicates among the entries with the same hash */
+    bucket = dup_bucket_of(&fd_hash[cur_dup_entry]);
+    for (i = dup_bucket[bucket]; i != -1; i = dup_next[i]) {
         if (fd_hash[i].len == fd_hash[cur_dup_entry].len
             && memcmp(fd_hash[i].digest, fd_hash[cur_dup_entry].digest, 16) == 0) {
-            return TRUE;
+            dup = TRUE;
+            break;
         }
     }
 
-    return FALSE;
+    dup_next[cur_dup_entry] = dup_bucket[bucket];
+    dup_bucket[bucket] = cur_dup_entry;
+
+    return dup;
 }
 
 static gboolean
@@ -1566,6 +1625,8 @@ main(int argc, char *argv[])
             nstime_set_unset(&fd_hash[i].frame_time);
         }
     }
+    if (dup_detect)
+        dup_buckets_init();
 
     /* Read all of the packets in turn */
     wtap_rec_init(&read_rec);
@@ -2086,6 +2147,8 @@ clean_exit:
         g_ptr_array_free(dsb_filenames, TRUE);
     }
     g_free(params.idb_inf);
+    g_free(dup_bucket);
+    g_free(dup_next);
     wtap_dump_params_cleanup(&params);
     if (wth != NULL)
         wtap_close(wth);
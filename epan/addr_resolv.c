@@ -19,6 +19,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <errno.h>
+#include <time.h>
 
 #include <wsutil/strtoi.h>
 
@@ -115,6 +116,16 @@
 
 #define HASH_IPV4_ADDRESS(addr) (g_htonl(addr) & (HASHHOSTSIZE - 1))
 
+/*
+ * Subnet addresses have their low (32 - mask_length) bits cleared, so
+ * HASH_IPV4_ADDRESS would put every /21-or-shorter subnet into bucket 0
+ * and every /24 into one of 8 buckets.  Hash the network number instead,
+ * spread over the table with a multiplicative (Fibonacci) hash.
+ */
+#define HASHHOSTBITS     11  /* log2(HASHHOSTSIZE) */
+#define HASH_IPV4_SUBNET(addr, mask_length) \
+    (((g_ntohl(addr) >> (32 - (mask_length))) * 2654435761U) >> (32 - HASHHOSTBITS))
+
 
 typedef struct sub_net_hashipv4 {
     guint             addr;
@@ -231,18 +242,22 @@ struct cb_serv_data {
 // Maps guint -> hashmanuf_t*
 static wmem_map_t *manuf_hashtable = NULL;
 static wmem_map_t *wka_hashtable = NULL;
+/* The manuf and wka files are big; they're read on first use, not at startup. */
+static gboolean manuf_loaded = FALSE;
 static wmem_map_t *eth_hashtable = NULL;
 // Maps guint -> serv_port_t*
 static wmem_map_t *serv_port_hashtable = NULL;
 static GHashTable *enterprises_hashtable = NULL;
+static gboolean enterprises_loaded = FALSE; /* read on first lookup, like manuf */
 
 static subnet_length_entry_t subnet_length_entries[SUBNETLENGTHSIZE]; /* Ordered array of entries */
-static gboolean have_subnet_entry = FALSE;
+static guint32 subnet_lengths_present = 0; /* bit (length - 1) set if any subnet of that length is known */
 
 static gboolean new_resolved_objects = FALSE;
 
 static GPtrArray* extra_hosts_files = NULL;
 
+static void load_manuf(void);
 static hashether_t *add_eth_name(const guint8 *addr, const gchar *name);
 static void add_serv_port_cb(const guint32 port, gpointer ptr);
 
@@ -365,6 +380,30 @@ static  gboolean  async_dns_initialized = FALSE;
 static  guint       async_dns_in_flight = 0;
 static  wmem_list_t *async_dns_queue_head = NULL;
 
+/*
+ * Names we got from the external resolver can be kept in the profile's
+ * "dns_cache" file from one run to the next, for up to dns_cache_max_age
+ * hours; the resolver doesn't tell us the records' TTLs.  The cache is
+ * keyed by the address as a string.
+ */
+#define ENAME_DNS_CACHE "dns_cache"
+
+typedef struct _dns_cache_entry {
+    union {
+        guint32      ip4;
+        ws_in6_addr  ip6;
+    } addr;
+    int              family;
+    gint64           resolved;  /* when we got the name, seconds since the Epoch */
+    gchar           *name;
+} dns_cache_entry_t;
+
+static guint       dns_cache_max_age = 0;  /* 0 means don't keep names */
+static GHashTable *dns_cache = NULL;
+static gchar      *dns_cache_path = NULL;  /* file the cache was read from */
+
+static void dns_cache_add(int family, const void *addr, const char *name, gint64 resolved);
+
 static void
 c_ares_ghba_sync_cb(void *arg, int status, int timeouts _U_, struct hostent *he) {
     sync_dns_data_t *sdd = (sync_dns_data_t *)arg;
@@ -384,7 +423,7 @@ c_ares_ghba_sync_cb(void *arg, int status, int timeouts _U_, struct hostent *he)
                     break;
             }
         }
-
+        dns_cache_add(sdd->family, &sdd->addr, he->h_name, (gint64)time(NULL));
     }
 
     /*
@@ -534,6 +573,143 @@ fgetline(char *buf, int size, FILE *fp)
 
 } /* fgetline */
 
+#ifdef HAVE_C_ARES
+static void
+dns_cache_entry_free(gpointer data)
+{
+    dns_cache_entry_t *entry = (dns_cache_entry_t *)data;
+
+    g_free(entry->name);
+    g_free(entry);
+}
+
+static void
+dns_cache_add(int family, const void *addr, const char *name, gint64 resolved)
+{
+    dns_cache_entry_t *entry;
+    gchar addr_str[WS_INET6_ADDRSTRLEN];
+
+    if (dns_cache == NULL || name == NULL || name[0] == '\0')
+        return;
+
+    entry = g_new(dns_cache_entry_t, 1);
+    entry->family = family;
+    if (family == AF_INET) {
+        memcpy(&entry->addr.ip4, addr, sizeof entry->addr.ip4);
+        ip_to_str_buf((const guint8 *)&entry->addr.ip4, addr_str, sizeof addr_str);
+    } else if (family == AF_INET6) {
+        memcpy(&entry->addr.ip6, addr, sizeof entry->addr.ip6);
+        ip6_to_str_buf(&entry->addr.ip6, addr_str, sizeof addr_str);
+    } else {
+        g_free(entry);
+        return;
+    }
+    entry->resolved = resolved;
+    entry->name = g_strdup(name);
+    g_hash_table_replace(dns_cache, g_strdup(addr_str), entry);
+}
+
+/*
+ * Read the names from the dns_cache file that aren't too old.  This is
+ * done once, when the host tables are first set up with preferences
+ * read; until then dns_cache_max_age is 0.
+ */
+static void
+dns_cache_load(void)
+{
+    FILE *fp;
+    char line[MAX_LINELEN];
+    char *resolved_str, *addr_str, *name;
+    gint64 resolved;
+    gint64 now = (gint64)time(NULL);
+    union {
+        guint32 ip4;
+        ws_in6_addr ip6;
+    } addr;
+
+    if (dns_cache != NULL || dns_cache_max_age == 0)
+        return;
+
+    dns_cache = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, dns_cache_entry_free);
+    dns_cache_path = get_persconffile_path(ENAME_DNS_CACHE, TRUE);
+
+    if ((fp = ws_fopen(dns_cache_path, "r")) == NULL)
+        return;
+
+    while (fgetline(line, sizeof(line), fp) >= 0) {
+        if (line[0] == '#')
+            continue;
+        if ((resolved_str = strtok(line, "\t")) == NULL ||
+            (addr_str = strtok(NULL, "\t")) == NULL ||
+            (name = strtok(NULL, "\t")) == NULL)
+            continue;
+        if (!ws_strtoi64(resolved_str, NULL, &resolved) ||
+            now - resolved > (gint64)dns_cache_max_age * 3600)
+            continue;
+
+        if (ws_inet_pton6(addr_str, &addr.ip6)) {
+            dns_cache_add(AF_INET6, &addr.ip6, name, resolved);
+        } else if (ws_inet_pton4(addr_str, &addr.ip4)) {
+            dns_cache_add(AF_INET, &addr.ip4, name, resolved);
+        }
+    }
+    fclose(fp);
+}
+
+/* Put the cached names into the host tables. */
+static void
+dns_cache_apply(void)
+{
+    GHashTableIter iter;
+    gpointer value;
+
+    if (dns_cache == NULL)
+        return;
+
+    g_hash_table_iter_init(&iter, dns_cache);
+    while (g_hash_table_iter_next(&iter, NULL, &value)) {
+        dns_cache_entry_t *entry = (dns_cache_entry_t *)value;
+
+        if (entry->family == AF_INET)
+            add_ipv4_name(entry->addr.ip4, entry->name);
+        else
+            add_ipv6_name(&entry->addr.ip6, entry->name);
+    }
+}
+
+/* Write the names that aren't too old back to the file, and drop the cache. */
+static void
+dns_cache_cleanup(void)
+{
+    FILE *fp;
+    GHashTableIter iter;
+    gpointer key, value;
+    gint64 now = (gint64)time(NULL);
+
+    if (dns_cache == NULL)
+        return;
+
+    if (dns_cache_max_age != 0 && (fp = ws_fopen(dns_cache_path, "w")) != NULL) {
+        fputs("# Names from the external resolver, kept by Wireshark.\n"
+              "# <time resolved>\t<address>\t<name>\n", fp);
+        g_hash_table_iter_init(&iter, dns_cache);
+        while (g_hash_table_iter_next(&iter, &key, &value)) {
+            dns_cache_entry_t *entry = (dns_cache_entry_t *)value;
+
+            if (now - entry->resolved <= (gint64)dns_cache_max_age * 3600)
+                fprintf(fp, "%" G_GINT64_FORMAT "\t%s\t%s\n",
+                        entry->resolved, (const char *)key, entry->name);
+        }
+        fclose(fp);
+    }
+
+    g_hash_table_destroy(dns_cache);
+    dns_cache = NULL;
+    g_free(dns_cache_path);
+    dns_cache_path = NULL;
+}
+#endif /* HAVE_C_ARES */
+
 
 /*
  *  Local function definitions
@@ -818,6 +994,12 @@ initialize_enterprises(void)
 {
     g_assert(enterprises_hashtable == NULL);
     enterprises_hashtable = g_hash_table_new_full(NULL, NULL, NULL, g_free);
+}
+
+static void
+load_enterprises(void)
+{
+    enterprises_loaded = TRUE;
 
     if (g_enterprises_path == NULL) {
         g_enterprises_path = get_datafile_path(ENAME_ENTERPRISES);
@@ -833,6 +1015,8 @@ initialize_enterprises(void)
 const gchar *
 try_enterprises_lookup(guint32 value)
 {
+    if (!enterprises_loaded)
+        load_enterprises();
     return (const gchar *)g_hash_table_lookup(enterprises_hashtable, GUINT_TO_POINTER(value));
 }
 
@@ -865,7 +1049,7 @@ enterprises_cleanup(void)
     g_assert(enterprises_hashtable);
     g_hash_table_destroy(enterprises_hashtable);
     enterprises_hashtable = NULL;
-    g_assert(g_enterprises_path);
+    enterprises_loaded = FALSE;
     g_free(g_enterprises_path);
     g_enterprises_path = NULL;
     g_free(g_penterprises_path);
@@ -954,6 +1138,7 @@ c_ares_ghba_cb(void *arg, int status, int timeouts _U_, struct hostent *he) {
                     break;
             }
         }
+        dns_cache_add(caqm->family, &caqm->addr, he->h_name, (gint64)time(NULL));
     }
     wmem_free(wmem_epan_scope(), caqm);
 }
@@ -1518,6 +1703,8 @@ manuf_name_lookup(const guint8 *addr)
     guint8       oct;
     hashmanuf_t  *manuf_value;
 
+    load_manuf();
+
     /* manuf needs only the 3 most significant octets of the ethernet address */
     manuf_key = addr[0];
     manuf_key = manuf_key<<8;
@@ -1563,6 +1750,7 @@ wka_name_lookup(const guint8 *addr, const unsigned int mask)
     if (wka_hashtable == NULL) {
         return NULL;
     }
+    load_manuf();
     /* Get the part of the address covered by the mask. */
     for (i = 0, num = mask; num >= 8; i++, num -= 8)
         masked_addr[i] = addr[i];   /* copy octets entirely covered by the mask */
@@ -1610,9 +1798,6 @@ eth_addr_cmp(gconstpointer a, gconstpointer b)
 static void
 initialize_ethers(void)
 {
-    ether_t *eth;
-    guint    mask = 0;
-
     /* hash table initialization */
     wka_hashtable   = wmem_map_new(wmem_epan_scope(), eth_addr_hash, eth_addr_cmp);
     manuf_hashtable = wmem_map_new(wmem_epan_scope(), g_direct_hash, g_direct_equal);
@@ -1628,6 +1813,23 @@ initialize_ethers(void)
      */
     if (g_pethers_path == NULL)
         g_pethers_path = get_persconffile_path(ENAME_ETHERS, FALSE);
+} /* initialize_ethers */
+
+/*
+ * Read the manuf and wka files into the manufacturer, well-known-address
+ * and Ethernet hash tables.  Everything that looks in those tables
+ * calls this first.
+ */
+static void
+load_manuf(void)
+{
+    ether_t *eth;
+    guint    mask = 0;
+
+    if (manuf_loaded)
+        return;
+    /* Set first; add_eth_name() below calls us too. */
+    manuf_loaded = TRUE;
 
     /* Compute the pathname of the manuf file */
     if (g_manuf_path == NULL)
@@ -1651,7 +1853,7 @@ initialize_ethers(void)
     }
     end_ethent();
 
-} /* initialize_ethers */
+} /* load_manuf */
 
 static void
 ethers_cleanup(void)
@@ -1664,6 +1866,7 @@ ethers_cleanup(void)
     g_manuf_path = NULL;
     g_free(g_wka_path);
     g_wka_path = NULL;
+    manuf_loaded = FALSE;
 }
 
 /* Resolve ethernet address */
@@ -1800,6 +2003,8 @@ add_eth_name(const guint8 *addr, const gchar *name)
 {
     hashether_t *tp;
 
+    load_manuf();
+
     tp = (hashether_t *)wmem_map_lookup(eth_hashtable, addr);
 
     if (tp == NULL) {
@@ -1820,6 +2025,8 @@ eth_name_lookup(const guint8 *addr, const gboolean resolve)
 {
     hashether_t  *tp;
 
+    load_manuf();
+
     tp = (hashether_t *)wmem_map_lookup(eth_hashtable, addr);
 
     if (tp == NULL) {
@@ -2379,20 +2586,20 @@ static subnet_entry_t
 subnet_lookup(const guint32 addr)
 {
     subnet_entry_t subnet_entry;
-    guint32 i;
+    guint32 lengths = subnet_lengths_present;
 
-    /* Search mask lengths linearly, longest first */
+    /* Search the mask lengths that have entries, longest first */
 
-    i = SUBNETLENGTHSIZE;
-    while(have_subnet_entry && i > 0) {
+    while(lengths != 0) {
+        guint32 i;
         guint32 masked_addr;
         subnet_length_entry_t* length_entry;
 
         /* Note that we run from 31 (length 32)  to 0 (length 1)  */
-        --i;
+        i = (guint32)g_bit_nth_msf(lengths, -1);
+        lengths &= ~(1U << i);
         g_assert(i < SUBNETLENGTHSIZE);
 
-
         length_entry = &subnet_length_entries[i];
 
         if (NULL != length_entry->subnet_addresses) {
@@ -2400,7 +2607,7 @@ subnet_lookup(const guint32 addr)
             guint32 hash_idx;
 
             masked_addr = addr & length_entry->mask;
-            hash_idx = HASH_IPV4_ADDRESS(masked_addr);
+            hash_idx = HASH_IPV4_SUBNET(masked_addr, i + 1);
 
             tp = length_entry->subnet_addresses[hash_idx];
             while(tp != NULL && tp->addr != masked_addr) {
@@ -2440,7 +2647,7 @@ subnet_entry_set(guint32 subnet_addr, const guint8 mask_length, const gchar* nam
 
     subnet_addr &= entry->mask;
 
-    hash_idx = HASH_IPV4_ADDRESS(subnet_addr);
+    hash_idx = HASH_IPV4_SUBNET(subnet_addr, mask_length);
 
     if (NULL == entry->subnet_addresses) {
         entry->subnet_addresses = (sub_net_hashipv4_t**)wmem_alloc0(wmem_epan_scope(), sizeof(sub_net_hashipv4_t*) * HASHHOSTSIZE);
@@ -2467,7 +2674,7 @@ subnet_entry_set(guint32 subnet_addr, const guint8 mask_length, const gchar* nam
     tp->next = NULL;
     tp->addr = subnet_addr;
     g_strlcpy(tp->name, name, MAXNAMELEN); /* This is longer than subnet names can actually be */
-    have_subnet_entry = TRUE;
+    subnet_lengths_present |= 1U << (mask_length - 1);
 }
 
 static void
@@ -2702,6 +2909,14 @@ addr_resolve_pref_init(module_t *nameres)
             " your DNS server behave badly.",
             10,
             &name_resolve_concurrency);
+
+    prefs_register_uint_preference(nameres, "dns_cache_max_age",
+            "Keep resolved names for (hours)",
+            "Keep the names got from the external resolver in the"
+            " profile's \"dns_cache\" file, and use them in later"
+            " sessions for this many hours. 0 doesn't keep them.",
+            10,
+            &dns_cache_max_age);
 #else
     prefs_register_static_text_preference(nameres, "use_external_name_resolver",
             "Use an external network name resolver: N/A",
@@ -2761,7 +2976,7 @@ host_name_lookup_process(void) {
 
     head = wmem_list_head(async_dns_queue_head);
 
-    while (head != NULL && async_dns_in_flight <= name_resolve_concurrency) {
+    while (head != NULL && async_dns_in_flight < name_resolve_concurrency) {
         caqm = (async_dns_queue_msg_t *)wmem_list_frame_data(head);
         wmem_list_remove_frame(async_dns_queue_head, head);
         if (caqm->family == AF_INET) {
@@ -2971,6 +3186,12 @@ host_name_lookup_init(void)
     if (manually_resolved_ipv6_list == NULL)
         manually_resolved_ipv6_list = wmem_list_new(wmem_epan_scope());
 
+#ifdef HAVE_C_ARES
+    /* Names from hosts files, loaded next, take precedence. */
+    dns_cache_load();
+    dns_cache_apply();
+#endif
+
     /*
      * Load the global hosts file, if we have one.
      */
@@ -3042,7 +3263,7 @@ host_name_lookup_cleanup(void)
         }
     }
 
-    have_subnet_entry = FALSE;
+    subnet_lengths_present = 0;
     new_resolved_objects = FALSE;
 }
 
@@ -3272,6 +3493,8 @@ get_manuf_name_if_known(const guint8 *addr)
     guint manuf_key;
     guint8 oct;
 
+    load_manuf();
+
     /* manuf needs only the 3 most significant octets of the ethernet address */
     manuf_key = addr[0];
     manuf_key = manuf_key<<8;
@@ -3295,6 +3518,8 @@ uint_get_manuf_name_if_known(const guint manuf_key)
 {
     hashmanuf_t *manuf_value;
 
+    load_manuf();
+
     manuf_value = (hashmanuf_t *)wmem_map_lookup(manuf_hashtable, GUINT_TO_POINTER(manuf_key));
     if ((manuf_value == NULL) || (manuf_value->status == HASHETHER_STATUS_UNRESOLVED)) {
         return NULL;
@@ -3483,18 +3708,21 @@ get_host_ipaddr6(const char *host, ws_in6_addr *addrp)
 wmem_map_t *
 get_manuf_hashtable(void)
 {
+    load_manuf();
     return manuf_hashtable;
 }
 
 wmem_map_t *
 get_wka_hashtable(void)
 {
+    load_manuf();
     return wka_hashtable;
 }
 
 wmem_map_t *
 get_eth_hashtable(void)
 {
+    load_manuf();
     return eth_hashtable;
 }
 
@@ -3549,6 +3777,9 @@ addr_resolv_cleanup(void)
     ipx_name_lookup_cleanup();
     enterprises_cleanup();
     host_name_lookup_cleanup();
+#ifdef HAVE_C_ARES
+    dns_cache_cleanup();
+#endif
 }
 
 gboolean
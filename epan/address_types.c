@@ -43,6 +43,13 @@ static address_type_t dissector_type_addresses[MAX_DISSECTOR_ADDR_TYPE];
 /* Keep track of address_type_t's via their id number */
 static address_type_t* type_list[MAX_ADDR_TYPE_VALUE + 1];
 
+/*
+ * Formatted addresses, address * -> gchar *, for address_to_str_cached().
+ * Only the unresolved form is kept, as resolved names can change while
+ * a file is open; the map is emptied when the file is closed.
+ */
+static wmem_map_t *address_str_cache = NULL;
+
 /*
  * If a user _does_ pass in a too-small buffer, this is probably
  * going to be too long to fit.  However, even a partial string
@@ -741,6 +748,48 @@ void address_to_str_buf(const address* addr, gchar *buf, int buf_len)
 }
 
 
+static guint
+address_str_cache_hash(gconstpointer key)
+{
+    const address *addr = (const address *)key;
+
+    return add_address_to_hash((guint)addr->type, addr);
+}
+
+static gboolean
+address_str_cache_equal(gconstpointer a, gconstpointer b)
+{
+    return addresses_equal((const address *)a, (const address *)b);
+}
+
+const gchar *
+address_to_str_cached(const address *addr)
+{
+    address *key;
+    gchar *str;
+
+    /*
+     * Address types registered by dissectors might format addresses
+     * according to their preferences, so don't keep those around.
+     */
+    if (addr->type >= AT_END_OF_LIST)
+        return address_to_str(wmem_packet_scope(), addr);
+
+    if (G_UNLIKELY(address_str_cache == NULL)) {
+        address_str_cache = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
+                address_str_cache_hash, address_str_cache_equal);
+    }
+
+    str = (gchar *)wmem_map_lookup(address_str_cache, addr);
+    if (str == NULL) {
+        key = wmem_new(wmem_file_scope(), address);
+        copy_address_wmem(wmem_file_scope(), key, addr);
+        str = address_to_str(wmem_file_scope(), addr);
+        wmem_map_insert(address_str_cache, key, str);
+    }
+    return str;
+}
+
 guint address_to_bytes(const address *addr, guint8 *buf, guint buf_len)
 {
     address_type_t *at;
@@ -820,6 +869,23 @@ address_to_display(wmem_allocator_t *allocator, const address *addr)
     return str;
 }
 
+void
+address_to_display_buf(const address *addr, gchar *buf, int buf_len)
+{
+    const gchar *result;
+
+    if (!buf || !buf_len)
+        return;
+
+    result = address_to_name(addr);
+    if (result != NULL)
+        g_strlcpy(buf, result, buf_len);
+    else if (addr->type == AT_NONE)
+        g_strlcpy(buf, "NONE", buf_len);
+    else
+        address_to_str_buf(addr, buf, buf_len);
+}
+
 static void address_with_resolution_to_str_buf(const address* addr, gchar *buf, int buf_len)
 {
     address_type_t *at;
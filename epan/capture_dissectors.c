@@ -169,7 +169,7 @@ guint32 capture_dissector_get_count(packet_counts* counts, const int proto)
     return hash_count->count;
 }
 
-void capture_dissector_increment_count(capture_packet_info_t *cpinfo, const int proto)
+void capture_dissector_add_count(capture_packet_info_t *cpinfo, const int proto, guint32 count)
 {
     /* See if we already have a counter for the protocol */
     capture_dissector_count_t* hash_count = (capture_dissector_count_t*)g_hash_table_lookup(cpinfo->counts, GINT_TO_POINTER(proto));
@@ -179,7 +179,12 @@ void capture_dissector_increment_count(capture_packet_info_t *cpinfo, const int
         g_hash_table_insert(cpinfo->counts, GINT_TO_POINTER(proto), (gpointer)hash_count);
     }
 
-    hash_count->count++;
+    hash_count->count += count;
+}
+
+void capture_dissector_increment_count(capture_packet_info_t *cpinfo, const int proto)
+{
+    capture_dissector_add_count(cpinfo, proto, 1);
 }
 
 /*
@@ -108,6 +108,13 @@ WS_DLL_PUBLIC guint32 capture_dissector_get_count(packet_counts* counts, const i
  */
 WS_DLL_PUBLIC void capture_dissector_increment_count(capture_packet_info_t *cpinfo, const int proto);
 
+/* Increment packet capture count by a given amount for a particular protocol.
+ * @param[in] cpinfo Capture statistics
+ * @param[in] proto Protocol to increment packet count
+ * @param[in] count Amount to add
+ */
+WS_DLL_PUBLIC void capture_dissector_add_count(capture_packet_info_t *cpinfo, const int proto, guint32 count);
+
 extern void capture_dissector_init(void);
 extern void capture_dissector_cleanup(void);
 
@@ -0,0 +1,156 @@
+/* cksum_bench.c
+ * Compares the Internet checksum and CRC-32C routines with plain
+ * byte-at-a-time reference versions, for correctness and speed.
+ *
+ * cksum_bench [buffer size [iterations]]
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "in_cksum.h"
+#include <wsutil/crc32.h>
+
+/* RFC 1071, one 16-bit word at a time */
+static guint16
+ref_in_cksum(const guint8 *p, int len)
+{
+	guint32 sum = 0;
+	union {
+		guint8	c[2];
+		guint16	s;
+	} w;
+
+	while (len > 1) {
+		w.c[0] = p[0];
+		w.c[1] = p[1];
+		sum += w.s;
+		p += 2;
+		len -= 2;
+	}
+	if (len == 1) {
+		w.c[0] = p[0];
+		w.c[1] = 0;
+		sum += w.s;
+	}
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+	return ~sum & 0xffff;
+}
+
+/* The crc32c_table, one byte at a time */
+static guint32
+ref_crc32c(const guint8 *p, int len, guint32 crc)
+{
+	while (len-- > 0)
+		crc = (crc >> 8) ^ crc32c_table_lookup((crc ^ *p++) & 0xff);
+	return crc;
+}
+
+static double
+mbytes_per_sec(gint64 usecs, int len, int iterations)
+{
+	if (usecs <= 0)
+		usecs = 1;
+	return (double)len * iterations / usecs;
+}
+
+int
+main(int argc, char **argv)
+{
+	int len = 1500;
+	int iterations = 100000;
+	guint8 *buf;
+	vec_t vec[1];
+	volatile guint32 sink = 0;
+	gint64 start, in_cksum_usecs, ref_in_cksum_usecs, crc32c_usecs, ref_crc32c_usecs;
+	int i, offset;
+	gboolean failed = FALSE;
+
+	if (argc > 1)
+		len = atoi(argv[1]);
+	if (argc > 2)
+		iterations = atoi(argv[2]);
+	if (len <= 0 || iterations <= 0) {
+		fprintf(stderr, "usage: cksum_bench [buffer size [iterations]]\n");
+		return 1;
+	}
+
+	/* One spare byte, so that odd offsets can be checked */
+	buf = (guint8 *)g_malloc(len + 1);
+	for (i = 0; i < len + 1; i++)
+		buf[i] = (guint8)g_random_int();
+
+	/* Check every length up to len at both alignments */
+	for (offset = 0; offset < 2; offset++) {
+		for (i = 0; i <= len; i++) {
+			SET_CKSUM_VEC_PTR(vec[0], buf + offset, i);
+			if (in_cksum(vec, 1) != ref_in_cksum(buf + offset, i)) {
+				fprintf(stderr, "in_cksum mismatch: offset %d length %d\n", offset, i);
+				failed = TRUE;
+			}
+			if (crc32c_calculate_no_swap(buf + offset, i, CRC32C_PRELOAD) !=
+			    ref_crc32c(buf + offset, i, CRC32C_PRELOAD)) {
+				fprintf(stderr, "crc32c mismatch: offset %d length %d\n", offset, i);
+				failed = TRUE;
+			}
+		}
+	}
+
+	SET_CKSUM_VEC_PTR(vec[0], buf, len);
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < iterations; i++)
+		sink += in_cksum(vec, 1);
+	in_cksum_usecs = g_get_monotonic_time() - start;
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < iterations; i++)
+		sink += ref_in_cksum(buf, len);
+	ref_in_cksum_usecs = g_get_monotonic_time() - start;
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < iterations; i++)
+		sink += crc32c_calculate_no_swap(buf, len, CRC32C_PRELOAD);
+	crc32c_usecs = g_get_monotonic_time() - start;
+
+	start = g_get_monotonic_time();
+	for (i = 0; i < iterations; i++)
+		sink += ref_crc32c(buf, len, CRC32C_PRELOAD);
+	ref_crc32c_usecs = g_get_monotonic_time() - start;
+
+	printf("%d bytes, %d iterations\n", len, iterations);
+	printf("%-24s %12s %12s\n", "", "MB/s", "reference");
+	printf("%-24s %12.1f %12.1f\n", "in_cksum",
+	       mbytes_per_sec(in_cksum_usecs, len, iterations),
+	       mbytes_per_sec(ref_in_cksum_usecs, len, iterations));
+	printf("%-24s %12.1f %12.1f\n", "crc32c_calculate",
+	       mbytes_per_sec(crc32c_usecs, len, iterations),
+	       mbytes_per_sec(ref_crc32c_usecs, len, iterations));
+
+	g_free(buf);
+	return failed ? 1 : 0;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -43,6 +43,11 @@ static GSList *color_filter_list = NULL;
 static GSList *color_filter_deleted_list = NULL;
 static GSList *color_filter_valid_list   = NULL;
 
+/* Filters replaced by the last color_filters_apply() that are still the
+ * first match for the packets that matched them, mapped to the filters
+ * that replaced them. */
+static GHashTable *color_filter_unchanged = NULL;
+
 /* Color Filters can en-/disabled. */
 static gboolean filters_enabled = TRUE;
 
@@ -120,6 +125,15 @@ color_filters_find_by_name_cb(gconstpointer arg1, gconstpointer arg2)
 }
 
 
+static void
+color_filters_forget_unchanged(void)
+{
+    if (color_filter_unchanged) {
+        g_hash_table_destroy(color_filter_unchanged);
+        color_filter_unchanged = NULL;
+    }
+}
+
 /* Set the filter off a temporary colorfilters and enable it */
 gboolean
 color_filters_set_tmp(guint8 filt_nr, const gchar *filter, gboolean disabled, gchar **err_msg)
@@ -131,6 +145,9 @@ color_filters_set_tmp(guint8 filt_nr, const gchar *filter, gboolean disabled, gc
     dfilter_t      *compiled_filter;
     guint8         i;
     gchar          *local_err_msg = NULL;
+
+    color_filters_forget_unchanged();
+
     /* Go through the temporary filters and look for the same filter string.
      * If found, clear it so that a filter can be "moved" up and down the list
      */
@@ -322,6 +339,7 @@ gboolean
 color_filters_init(gchar** err_msg, color_filter_add_cb_func add_cb)
 {
     /* delete all currently existing filters */
+    color_filters_forget_unchanged();
     color_filter_list_delete(&color_filter_list);
 
     /* now try to construct the filters list */
@@ -333,6 +351,7 @@ color_filters_reload(gchar** err_msg, color_filter_add_cb_func add_cb)
 {
     /* "move" old entries to the deleted list
      * we must keep them until the dissection no longer needs them */
+    color_filters_forget_unchanged();
     color_filter_deleted_list = g_slist_concat(color_filter_deleted_list, color_filter_list);
     color_filter_list = NULL;
 
@@ -344,6 +363,7 @@ void
 color_filters_cleanup(void)
 {
     /* delete the previously deleted filters */
+    color_filters_forget_unchanged();
     color_filter_list_delete(&color_filter_deleted_list);
 }
 
@@ -417,11 +437,49 @@ color_filter_validate_cb(gpointer filter_arg, gpointer err)
     }
 }
 
+/* Rules are tried in order, so a packet that matched an old rule still
+ * matches its replacement first as long as neither that rule nor any
+ * rule before it matches differently. Remember those rules. */
+static void
+color_filters_find_unchanged(GSList *old_cfl, GSList *new_cfl)
+{
+    color_filter_t *old_colorf, *new_colorf;
+
+    color_filters_forget_unchanged();
+    color_filter_unchanged = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+    for (; old_cfl && new_cfl; old_cfl = g_slist_next(old_cfl), new_cfl = g_slist_next(new_cfl)) {
+        old_colorf = (color_filter_t *)old_cfl->data;
+        new_colorf = (color_filter_t *)new_cfl->data;
+
+        if (old_colorf->disabled != new_colorf->disabled)
+            break;
+        if (!old_colorf->disabled) {
+            if (strcmp(old_colorf->filter_text, new_colorf->filter_text) != 0)
+                break;
+            /* It couldn't have matched before but might now, or vice versa */
+            if ((old_colorf->c_colorfilter == NULL) != (new_colorf->c_colorfilter == NULL))
+                break;
+        }
+        g_hash_table_insert(color_filter_unchanged, old_colorf, new_colorf);
+    }
+}
+
+const color_filter_t *
+color_filters_unchanged_match(const color_filter_t *colorf)
+{
+    if (!color_filter_unchanged || !colorf)
+        return NULL;
+
+    return (const color_filter_t *)g_hash_table_lookup(color_filter_unchanged, colorf);
+}
+
 /* apply changes from the edit list */
 gboolean
 color_filters_apply(GSList *tmp_cfl, GSList *edit_cfl, gchar** err_msg)
 {
     gboolean ret = TRUE;
+    GSList *old_cfl = color_filter_list;
 
     *err_msg = NULL;
 
@@ -451,6 +509,10 @@ color_filters_apply(GSList *tmp_cfl, GSList *edit_cfl, gchar** err_msg)
         ret = FALSE;
     }
 
+    /* old_cfl still starts at the old entries, which are now the tail of
+     * the deleted list. */
+    color_filters_find_unchanged(old_cfl, color_filter_list);
+
     return ret;
 }
 
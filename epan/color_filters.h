@@ -109,6 +109,16 @@ WS_DLL_PUBLIC void color_filters_prime_edt(struct epan_dissect *edt);
 WS_DLL_PUBLIC const color_filter_t *
 color_filters_colorize_packet(struct epan_dissect *edt);
 
+/** Find out whether packets that matched a color filter before the last
+ * color_filters_apply() are colored the same way by the new filters.
+ *
+ * @param colorf the filter a packet matched before
+ * @return the new filter the packet matches first, or NULL if the packet
+ * has to be colorized again
+ */
+WS_DLL_PUBLIC const color_filter_t *
+color_filters_unchanged_match(const color_filter_t *colorf);
+
 /** Clone the currently active filter list.
  *
  * @param user_data will be returned by each call to to color_filter_add_cb()
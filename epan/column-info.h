@@ -45,6 +45,7 @@ typedef struct {
   gchar              *col_buf;              /**< Buffer into which to copy data for column */
   int                 col_fence;            /**< Stuff in column buffer before this index is immutable */
   gboolean            writable;             /**< writable or not */
+  gboolean            visible;              /**< shown by the UI; see col_set_only_visible() */
 } col_item_t;
 
 /** Column info */
@@ -54,6 +55,8 @@ struct epan_column_info {
   col_item_t         *columns;              /**< All column data */
   gint               *col_first;            /**< First column number with a given format */
   gint               *col_last;             /**< Last column number with a given format */
+  gboolean           *col_fmt_visible;      /**< At least one visible column has a given format */
+  gboolean            only_visible;         /**< Don't construct hidden columns */
   col_expr_t          col_expr;             /**< Column expressions and values */
   gboolean            writable;             /**< writable or not @todo Are we still writing to the columns? */
   GRegex             *prime_regex;          /**< Used to prime custom columns */
@@ -56,8 +56,11 @@ col_setup(column_info *cinfo, const gint num_cols)
   cinfo->columns               = g_new(col_item_t, num_cols);
   cinfo->col_first             = g_new(int, NUM_COL_FMTS);
   cinfo->col_last              = g_new(int, NUM_COL_FMTS);
+  cinfo->col_fmt_visible       = g_new(gboolean, NUM_COL_FMTS);
+  cinfo->only_visible          = FALSE;
   for (i = 0; i < num_cols; i++) {
     cinfo->columns[i].col_custom_fields_ids = NULL;
+    cinfo->columns[i].visible = TRUE;
   }
   cinfo->col_expr.col_expr     = g_new(const gchar*, num_cols + 1);
   cinfo->col_expr.col_expr_val = g_new(gchar*, num_cols + 1);
@@ -65,6 +68,7 @@ col_setup(column_info *cinfo, const gint num_cols)
   for (i = 0; i < NUM_COL_FMTS; i++) {
     cinfo->col_first[i] = -1;
     cinfo->col_last[i] = -1;
+    cinfo->col_fmt_visible[i] = TRUE;
   }
   cinfo->prime_regex = g_regex_new(COL_CUSTOM_PRIME_REGEX,
     (GRegexCompileFlags) (G_REGEX_ANCHORED | G_REGEX_RAW),
@@ -106,6 +110,7 @@ col_cleanup(column_info *cinfo)
   g_free(cinfo->columns);
   g_free(cinfo->col_first);
   g_free(cinfo->col_last);
+  g_free(cinfo->col_fmt_visible);
   /*
    * XXX - MSVC doesn't correctly handle the "const" qualifier; it thinks
    * "const XXX **" means "pointer to const pointer to XXX", i.e. that
@@ -119,6 +124,34 @@ col_cleanup(column_info *cinfo)
     g_regex_unref(cinfo->prime_regex);
 }
 
+void
+col_set_visible(column_info *cinfo, const gint col, const gboolean visible)
+{
+  int i, j;
+
+  if (!cinfo || col < 0 || col >= cinfo->num_cols)
+    return;
+
+  cinfo->columns[col].visible = visible;
+
+  for (j = 0; j < NUM_COL_FMTS; j++) {
+    cinfo->col_fmt_visible[j] = FALSE;
+    for (i = cinfo->col_first[j]; i >= 0 && i <= cinfo->col_last[j]; i++) {
+      if (cinfo->columns[i].fmt_matx[j] && cinfo->columns[i].visible) {
+        cinfo->col_fmt_visible[j] = TRUE;
+        break;
+      }
+    }
+  }
+}
+
+void
+col_set_only_visible(column_info *cinfo, const gboolean only_visible)
+{
+  if (cinfo)
+    cinfo->only_visible = only_visible;
+}
+
 /* Initialize the data structures for constructing column data. */
 void
 col_init(column_info *cinfo, const struct epan_session *epan)
@@ -192,7 +225,9 @@ col_set_writable(column_info *cinfo, const gint col, const gboolean writable)
     /* We are constructing columns, and they're writable */ \
     (col_get_writable(cinfo, el) && \
       /* There is at least one column in that format */ \
-    ((cinfo)->col_first[el] >= 0))
+    ((cinfo)->col_first[el] >= 0) && \
+      /* and it's shown, if we only construct shown columns */ \
+    (!(cinfo)->only_visible || (cinfo)->col_fmt_visible[el]))
 
 /* Sets the fence for a column to be at the end of the column. */
 void
@@ -345,6 +380,8 @@ void col_custom_set_edt(epan_dissect_t *edt, column_info *cinfo)
   for (i = cinfo->col_first[COL_CUSTOM];
        i <= cinfo->col_last[COL_CUSTOM]; i++) {
     col_item = &cinfo->columns[i];
+    if (cinfo->only_visible && !col_item->visible)
+      continue;
     if (col_item->fmt_matx[COL_CUSTOM] &&
         col_item->col_custom_fields &&
         col_item->col_custom_fields_ids) {
@@ -370,6 +407,8 @@ col_custom_prime_edt(epan_dissect_t *edt, column_info *cinfo)
   for (i = cinfo->col_first[COL_CUSTOM];
        i <= cinfo->col_last[COL_CUSTOM]; i++) {
     col_item = &cinfo->columns[i];
+    if (cinfo->only_visible && !col_item->visible)
+      continue;
 
     if (col_item->fmt_matx[COL_CUSTOM] &&
         col_item->col_custom_dfilter) {
@@ -873,120 +912,162 @@ col_has_time_fmt(column_info *cinfo, const gint col)
           (col_item->fmt_matx[COL_DELTA_TIME_DIS]));
 }
 
+/* Layouts of the absolute time columns, up to and including the seconds */
+typedef enum {
+  ABS_TIME_HMS,   /* hh:mm:ss */
+  ABS_TIME_YMD,   /* YYYY-MM-DD hh:mm:ss */
+  ABS_TIME_YDOY,  /* YYYY/DOY hh:mm:ss */
+  ABS_TIME_NUM_LAYOUTS
+} abs_time_layout_e;
+
+/*
+ * Consecutive packets nearly always fall in the same second, so remember
+ * the last whole-second string of each layout (local and UTC) and only
+ * call localtime()/gmtime() and ws_snprintf() when the second changes.
+ */
+typedef struct {
+  gboolean valid;
+  time_t   secs;
+  gsize    len;
+  gchar    str[COL_MAX_LEN];
+} abs_time_cache_t;
+
+static abs_time_cache_t abs_time_cache[ABS_TIME_NUM_LAYOUTS][2];
+
+static int
+abs_time_tsprecision(const frame_data *fd)
+{
+  switch (timestamp_get_precision()) {
+  case TS_PREC_FIXED_SEC:
+    return WTAP_TSPREC_SEC;
+  case TS_PREC_FIXED_DSEC:
+    return WTAP_TSPREC_DSEC;
+  case TS_PREC_FIXED_CSEC:
+    return WTAP_TSPREC_CSEC;
+  case TS_PREC_FIXED_MSEC:
+    return WTAP_TSPREC_MSEC;
+  case TS_PREC_FIXED_USEC:
+    return WTAP_TSPREC_USEC;
+  case TS_PREC_FIXED_NSEC:
+    return WTAP_TSPREC_NSEC;
+  case TS_PREC_AUTO:
+    return fd->tsprec;
+  default:
+    g_assert_not_reached();
+    return WTAP_TSPREC_SEC;
+  }
+}
+
 static void
-set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
+set_abs_time_layout(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local,
+                    abs_time_layout_e layout)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
+  abs_time_cache_t *cache = &abs_time_cache[layout][local ? 1 : 0];
+  int digits, divisor;
+  gint frac;
+  gchar *p;
+
+  if (!fd->has_ts) {
+    buf[0] = '\0';
+    return;
+  }
+
+  if (!cache->valid || cache->secs != fd->abs_ts.secs) {
+    struct tm *tmp;
+    time_t then = fd->abs_ts.secs;
 
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
     if (local)
       tmp = localtime(&then);
     else
       tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
+    if (tmp == NULL) {
+      cache->valid = FALSE;
+      buf[0] = '\0';
+      return;
     }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
+    switch (layout) {
+    case ABS_TIME_HMS:
+      ws_snprintf(cache->str, COL_MAX_LEN, "%02d:%02d:%02d",
         tmp->tm_hour,
         tmp->tm_min,
         tmp->tm_sec);
       break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d-%02d-%02d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%03d",
+    case ABS_TIME_YMD:
+      ws_snprintf(cache->str, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d",
         tmp->tm_year + 1900,
         tmp->tm_mon + 1,
         tmp->tm_mday,
         tmp->tm_hour,
         tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
+        tmp->tm_sec);
       break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d-%02d-%02d %02d:%02d:%02d%s%09d",
+    case ABS_TIME_YDOY:
+      ws_snprintf(cache->str, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d",
         tmp->tm_year + 1900,
-        tmp->tm_mon + 1,
-        tmp->tm_mday,
+        tmp->tm_yday + 1,
         tmp->tm_hour,
         tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
+        tmp->tm_sec);
       break;
     default:
       g_assert_not_reached();
     }
-  } else {
-    buf[0] = '\0';
+    cache->len = strlen(cache->str);
+    cache->secs = fd->abs_ts.secs;
+    cache->valid = TRUE;
+  }
+
+  switch (abs_time_tsprecision(fd)) {
+  case WTAP_TSPREC_SEC:
+    memcpy(buf, cache->str, cache->len + 1);
+    return;
+  case WTAP_TSPREC_DSEC:
+    digits = 1;
+    divisor = 100000000;
+    break;
+  case WTAP_TSPREC_CSEC:
+    digits = 2;
+    divisor = 10000000;
+    break;
+  case WTAP_TSPREC_MSEC:
+    digits = 3;
+    divisor = 1000000;
+    break;
+  case WTAP_TSPREC_USEC:
+    digits = 6;
+    divisor = 1000;
+    break;
+  case WTAP_TSPREC_NSEC:
+    digits = 9;
+    divisor = 1;
+    break;
+  default:
+    g_assert_not_reached();
+    return;
+  }
+
+  frac = fd->abs_ts.nsecs / divisor;
+  if (frac < 0 || fd->abs_ts.nsecs >= 1000000000) {
+    /* Not a normalized timestamp; keep the old printf output for it */
+    ws_snprintf(buf, COL_MAX_LEN, "%s%s%0*d", cache->str, decimal_point, digits, frac);
+    return;
+  }
+
+  memcpy(buf, cache->str, cache->len);
+  p = g_stpcpy(buf + cache->len, decimal_point);
+  p[digits] = '\0';
+  while (digits-- > 0) {
+    p[digits] = '0' + frac % 10;
+    frac /= 10;
   }
 }
 
+static void
+set_abs_ymd_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
+{
+  set_abs_time_layout(fd, buf, decimal_point, local, ABS_TIME_YMD);
+}
+
 static void
 col_set_abs_ymd_time(const frame_data *fd, column_info *cinfo, const int col)
 {
@@ -1010,109 +1091,7 @@ col_set_utc_ymd_time(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_ydoy_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
-
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%01d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%04d/%03d %02d:%02d:%02d%s%02d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%03d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%06d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%04d/%03d %02d:%02d:%02d%s%09d",
-        tmp->tm_year + 1900,
-        tmp->tm_yday + 1,
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
-  } else {
-    buf[0] = '\0';
-  }
+  set_abs_time_layout(fd, buf, decimal_point, local, ABS_TIME_YDOY);
 }
 
 static void
@@ -1468,98 +1447,7 @@ col_set_delta_time_dis(const frame_data *fd, column_info *cinfo, const int col)
 static void
 set_abs_time(const frame_data *fd, gchar *buf, char *decimal_point, gboolean local)
 {
-  struct tm *tmp;
-  time_t then;
-  int tsprecision;
-
-  if (fd->has_ts) {
-    then = fd->abs_ts.secs;
-    if (local)
-      tmp = localtime(&then);
-    else
-      tmp = gmtime(&then);
-  } else
-    tmp = NULL;
-  if (tmp != NULL) {
-    switch (timestamp_get_precision()) {
-    case TS_PREC_FIXED_SEC:
-      tsprecision = WTAP_TSPREC_SEC;
-      break;
-    case TS_PREC_FIXED_DSEC:
-      tsprecision = WTAP_TSPREC_DSEC;
-      break;
-    case TS_PREC_FIXED_CSEC:
-      tsprecision = WTAP_TSPREC_CSEC;
-      break;
-    case TS_PREC_FIXED_MSEC:
-      tsprecision = WTAP_TSPREC_MSEC;
-      break;
-    case TS_PREC_FIXED_USEC:
-      tsprecision = WTAP_TSPREC_USEC;
-      break;
-    case TS_PREC_FIXED_NSEC:
-      tsprecision = WTAP_TSPREC_NSEC;
-      break;
-    case TS_PREC_AUTO:
-      tsprecision = fd->tsprec;
-      break;
-    default:
-      g_assert_not_reached();
-    }
-    switch (tsprecision) {
-    case WTAP_TSPREC_SEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec);
-      break;
-    case WTAP_TSPREC_DSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%01d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 100000000);
-      break;
-    case WTAP_TSPREC_CSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%02d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 10000000);
-      break;
-    case WTAP_TSPREC_MSEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%03d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000000);
-      break;
-    case WTAP_TSPREC_USEC:
-      ws_snprintf(buf, COL_MAX_LEN,"%02d:%02d:%02d%s%06d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs / 1000);
-      break;
-    case WTAP_TSPREC_NSEC:
-      ws_snprintf(buf, COL_MAX_LEN, "%02d:%02d:%02d%s%09d",
-        tmp->tm_hour,
-        tmp->tm_min,
-        tmp->tm_sec,
-        decimal_point,
-        fd->abs_ts.nsecs);
-      break;
-    default:
-      g_assert_not_reached();
-    }
-
-  } else {
-    *buf = '\0';
-  }
+  set_abs_time_layout(fd, buf, decimal_point, local, ABS_TIME_HMS);
 }
 
 static void
@@ -1941,10 +1829,8 @@ col_set_addr(packet_info *pinfo, const int col, const address *addr, const gbool
 
   if (res && (name = address_to_name(addr)) != NULL)
     col_item->col_data = name;
-  else {
-    col_item->col_data = col_item->col_buf;
-    address_to_str_buf(addr, col_item->col_buf, COL_MAX_LEN);
-  }
+  else
+    col_item->col_data = address_to_str_cached(addr);
 
   if (!fill_col_exprs)
     return;
@@ -2158,6 +2044,8 @@ col_fill_in(packet_info *pinfo, const gboolean fill_col_exprs, const gboolean fi
 
   for (i = 0; i < pinfo->cinfo->num_cols; i++) {
     col_item = &pinfo->cinfo->columns[i];
+    if (pinfo->cinfo->only_visible && !col_item->visible)
+      continue;
     if (col_based_on_frame_data(pinfo->cinfo, i)) {
       if (fill_fd_colums)
         col_fill_in_frame_data(pinfo->fd, pinfo->cinfo, i, fill_col_exprs);
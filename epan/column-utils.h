@@ -106,6 +106,21 @@ WS_DLL_PUBLIC void col_setup(column_info *cinfo, const gint num_cols);
  */
 WS_DLL_PUBLIC void col_cleanup(column_info *cinfo);
 
+/** Mark a column as shown or hidden by the UI.
+ *
+ * Internal, don't use this in dissectors!
+ */
+WS_DLL_PUBLIC void col_set_visible(column_info *cinfo, const gint col, const gboolean visible);
+
+/** Only construct the columns marked visible with col_set_visible().
+ * While this is set, col_... calls for formats that only hidden
+ * columns have do nothing, and col_fill_in() skips hidden columns,
+ * so their text is left empty.
+ *
+ * Internal, don't use this in dissectors!
+ */
+WS_DLL_PUBLIC void col_set_only_visible(column_info *cinfo, const gboolean only_visible);
+
 /** Initialize the data structures for constructing column data.
  *
  * Internal, don't use this in dissectors!
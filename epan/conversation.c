@@ -850,6 +850,14 @@ conversation_lookup_hashtable(wmem_map_t *hashtable, const guint32 frame_num, co
 	conversation_t* chain_head=NULL;
 	struct conversation_key key;
 
+	/*
+	 * Most captures only ever put conversations into one or two of
+	 * the tables; don't build and hash a key for a table that has
+	 * nothing in it.
+	 */
+	if (wmem_map_size(hashtable) == 0)
+		return NULL;
+
 	/*
 	 * We don't make a copy of the address data, we just copy the
 	 * pointer to it, as "key" disappears when we return.
@@ -584,27 +584,37 @@ add_conversation_table_data_with_conv_id(
     guint32 port1, port2;
     conv_item_t *conv_item = NULL;
     unsigned int conversation_idx = 0;
+    gboolean is_tx;
+    int addr_cmp = 0;
 
+    /* Order the endpoints. We know the direction of the packet from
+     * here on, so we don't have to compare the addresses again when
+     * updating the counters. */
     if (src_port > dst_port) {
         addr1 = src;
         addr2 = dst;
         port1 = src_port;
         port2 = dst_port;
+        is_tx = TRUE;
     } else if (src_port < dst_port) {
         addr2 = src;
         addr1 = dst;
         port2 = src_port;
         port1 = dst_port;
-    } else if (cmp_address(src, dst) < 0) {
+        is_tx = FALSE;
+    } else if ((addr_cmp = cmp_address(src, dst)) < 0) {
         addr1 = src;
         addr2 = dst;
         port1 = src_port;
         port2 = dst_port;
+        is_tx = TRUE;
     } else {
         addr2 = src;
         addr1 = dst;
         port2 = src_port;
         port1 = dst_port;
+        /* Identical endpoints count as tx. */
+        is_tx = (addr_cmp == 0);
     }
 
     /* if we don't have any entries at all yet */
@@ -673,7 +683,7 @@ add_conversation_table_data_with_conv_id(
     }
 
     /* update the conversation struct */
-    if ( (!cmp_address(src, addr1)) && (!cmp_address(dst, addr2)) && (src_port==port1) && (dst_port==port2) ) {
+    if (is_tx) {
         conv_item->tx_frames += num_frames;
         conv_item->tx_bytes += num_bytes;
     } else {
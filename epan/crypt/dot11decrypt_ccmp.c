@@ -64,29 +64,25 @@
 /****************************************************************************/
 /* Internal function prototypes declarations					*/
 
-static void ccmp_init_blocks(
-	gcry_cipher_hd_t rijndael_handle,
+static void ccmp_construct_blocks(
 	PDOT11DECRYPT_MAC_FRAME wh,
 	UINT64 pn,
 	size_t dlen,
 	UINT8 b0[AES_BLOCK_LEN],
-	UINT8 aad[2 * AES_BLOCK_LEN],
-	UINT8 a[AES_BLOCK_LEN],
-	UINT8 b[AES_BLOCK_LEN])
+	UINT8 aad[2 * AES_BLOCK_LEN])
 	;
 
 /****************************************************************************/
 /* Function definitions							*/
 
-static void ccmp_init_blocks(
-	gcry_cipher_hd_t rijndael_handle,
+/* Build the CCM initial block (flags, nonce and data length) and the
+ * length-prefixed AAD of a frame. */
+static void ccmp_construct_blocks(
 	PDOT11DECRYPT_MAC_FRAME wh,
 	UINT64 pn,
 	size_t dlen,
 	UINT8 b0[AES_BLOCK_LEN],
-	UINT8 aad[2 * AES_BLOCK_LEN],
-	UINT8 a[AES_BLOCK_LEN],
-	UINT8 b[AES_BLOCK_LEN])
+	UINT8 aad[2 * AES_BLOCK_LEN])
 {
 	UINT8 mgmt = (DOT11DECRYPT_TYPE(wh->fc[0]) == DOT11DECRYPT_TYPE_MANAGEMENT);
 #define IS_4ADDRESS(wh) \
@@ -172,6 +168,80 @@ static void ccmp_init_blocks(
 			b0[1] |= 0x10; /* set MGMT flag */
 		memset(&aad[26], 0, 4);
 	}
+#undef  IS_QOS_DATA
+#undef  IS_4ADDRESS
+}
+
+#if GCRYPT_VERSION_NUMBER >= 0x010600 /* 1.6.0 */
+/* Let Libgcrypt run CCM itself: it processes whole buffers and uses
+ * the AES instructions of the CPU where there are some. */
+INT Dot11DecryptCcmpDecrypt(
+	UINT8 *m,
+	gint mac_header_len,
+	INT len,
+	UCHAR TK1[16])
+{
+	PDOT11DECRYPT_MAC_FRAME wh;
+	UINT8 aad[2 * AES_BLOCK_LEN];
+	UINT8 b0[AES_BLOCK_LEN];
+	guint64 lengths[3];
+	size_t data_len;
+	INT z = mac_header_len;
+	gcry_cipher_hd_t rijndael_handle;
+	gcry_error_t err;
+	UINT64 PN;
+	UINT8 *ivp=m+z;
+
+	PN = READ_6(ivp[0], ivp[1], ivp[4], ivp[5], ivp[6], ivp[7]);
+
+	wh = (PDOT11DECRYPT_MAC_FRAME )m;
+	data_len = len - (z + DOT11DECRYPT_CCMP_HEADER+DOT11DECRYPT_CCMP_TRAILER);
+	if (data_len < 1) {
+		return 0;
+	}
+	ccmp_construct_blocks(wh, PN, data_len, b0, aad);
+
+	if (gcry_cipher_open(&rijndael_handle, GCRY_CIPHER_AES, GCRY_CIPHER_MODE_CCM, 0)) {
+		return 1;
+	}
+	/* The nonce is in b0 between the flags and the data length, and
+	 * aad[1] is the length of the AAD that follows it. */
+	lengths[0] = data_len;
+	lengths[1] = aad[1];
+	lengths[2] = DOT11DECRYPT_CCMP_TRAILER;
+	if (gcry_cipher_setkey(rijndael_handle, TK1, 16) ||
+	    gcry_cipher_setiv(rijndael_handle, b0 + 1, 13) ||
+	    gcry_cipher_ctl(rijndael_handle, GCRYCTL_SET_CCM_LENGTHS, lengths, sizeof(lengths)) ||
+	    gcry_cipher_authenticate(rijndael_handle, aad + 2, aad[1]) ||
+	    gcry_cipher_decrypt(rijndael_handle, m + z + DOT11DECRYPT_CCMP_HEADER, data_len, NULL, 0)) {
+		gcry_cipher_close(rijndael_handle);
+		return 1;
+	}
+
+	/* MIC Key ?= MIC */
+	err = gcry_cipher_checktag(rijndael_handle, m + len - DOT11DECRYPT_CCMP_TRAILER, DOT11DECRYPT_CCMP_TRAILER);
+	gcry_cipher_close(rijndael_handle);
+	if (err == 0) {
+		return 0;
+	}
+
+	/* TODO replay check	(IEEE 802.11i-2004, pg. 62)			*/
+	/* TODO PN must be incremental (IEEE 802.11i-2004, pg. 62)		*/
+
+	return 1;
+}
+#else
+static void ccmp_init_blocks(
+	gcry_cipher_hd_t rijndael_handle,
+	PDOT11DECRYPT_MAC_FRAME wh,
+	UINT64 pn,
+	size_t dlen,
+	UINT8 b0[AES_BLOCK_LEN],
+	UINT8 aad[2 * AES_BLOCK_LEN],
+	UINT8 a[AES_BLOCK_LEN],
+	UINT8 b[AES_BLOCK_LEN])
+{
+	ccmp_construct_blocks(wh, pn, dlen, b0, aad);
 
 	/* Start with the first block and AAD */
 	gcry_cipher_encrypt(rijndael_handle, a, AES_BLOCK_LEN, b0, AES_BLOCK_LEN);
@@ -184,8 +254,6 @@ static void ccmp_init_blocks(
 	gcry_cipher_encrypt(rijndael_handle, b, AES_BLOCK_LEN, b0, AES_BLOCK_LEN);
 
 	/** //XOR( m + len - 8, b, 8 ); **/
-#undef  IS_QOS_DATA
-#undef  IS_4ADDRESS
 }
 
 INT Dot11DecryptCcmpDecrypt(
@@ -254,3 +322,4 @@ INT Dot11DecryptCcmpDecrypt(
 
 	return 1;
 }
+#endif
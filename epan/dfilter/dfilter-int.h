@@ -26,7 +26,13 @@ struct epan_dfilter {
 	gboolean	*owns_memory;
 	int		*interesting_fields;
 	int		num_interesting_fields;
+	int		*protocol_reqs;
+	int		num_protocol_reqs;
+	gboolean	*protocol_stack;
 	GPtrArray	*deprecated;
+	dfilter_profile_t *profile;	/* non-NULL while profiling */
+	gchar		*canonical;	/* checked syntax tree, for dfilter_narrows() */
+	gchar		*canonical_and_lhs; /* left operand, if the filter is an "and" */
 };
 
 typedef struct {
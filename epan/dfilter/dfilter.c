@@ -16,6 +16,9 @@
 #include "gencode.h"
 #include "semcheck.h"
 #include "dfvm.h"
+#include "sttype-test.h"
+#include "sttype-range.h"
+#include "sttype-function.h"
 #include <epan/epan_dissect.h>
 #include "dfilter.h"
 #include "dfilter-macro.h"
@@ -132,6 +135,8 @@ dfilter_free(dfilter_t *df)
 	}
 
 	g_free(df->interesting_fields);
+	g_free(df->protocol_reqs);
+	g_free(df->protocol_stack);
 
 	/* Clear registers with constant values (as set by dfvm_init_const).
 	 * Other registers were cleared on RETURN by free_register_overhead. */
@@ -150,9 +155,125 @@ dfilter_free(dfilter_t *df)
 	g_free(df->registers);
 	g_free(df->attempted_load);
 	g_free(df->owns_memory);
+	g_free(df->profile);
+	g_free(df->canonical);
+	g_free(df->canonical_and_lhs);
 	g_free(df);
 }
 
+static gboolean canonicalize_node(GString *s, stnode_t *node);
+
+static void
+canonicalize_drange_node(gpointer data, gpointer user_data)
+{
+	drange_node	*rn = (drange_node *)data;
+	GString		*s = (GString *)user_data;
+
+	g_string_append_printf(s, "[%d", drange_node_get_start_offset(rn));
+	switch (drange_node_get_ending(rn)) {
+	case DRANGE_NODE_END_T_LENGTH:
+		g_string_append_printf(s, ":%d]", drange_node_get_length(rn));
+		break;
+	case DRANGE_NODE_END_T_OFFSET:
+		g_string_append_printf(s, "-%d]", drange_node_get_end_offset(rn));
+		break;
+	default:
+		g_string_append(s, ":]");
+		break;
+	}
+}
+
+static gboolean
+canonicalize_list(GString *s, GSList *nodes)
+{
+	for (; nodes; nodes = g_slist_next(nodes)) {
+		g_string_append_c(s, ' ');
+		if (nodes->data == NULL) {
+			/* Set elements come in pairs; NULL unless it's a range */
+			g_string_append_c(s, '-');
+		} else if (!canonicalize_node(s, (stnode_t *)nodes->data)) {
+			return FALSE;
+		}
+	}
+	return TRUE;
+}
+
+/*
+ * Appends a form of a checked syntax tree to s that doesn't depend on
+ * spacing, redundant parentheses or the spelling of operators, so that
+ * filters can be compared. Returns FALSE for nodes that we can't write,
+ * which then never compare equal. Must be called before dfw_gencode(),
+ * which takes the values out of the tree.
+ */
+static gboolean
+canonicalize_node(GString *s, stnode_t *node)
+{
+	test_op_t	op;
+	stnode_t	*arg1, *arg2;
+	fvalue_t	*fv;
+	char		*repr;
+
+	switch (stnode_type_id(node)) {
+	case STTYPE_TEST:
+		sttype_test_get(node, &op, &arg1, &arg2);
+		g_string_append_printf(s, "(%d", op);
+		if (arg1) {
+			g_string_append_c(s, ' ');
+			if (!canonicalize_node(s, arg1))
+				return FALSE;
+		}
+		if (arg2) {
+			g_string_append_c(s, ' ');
+			if (!canonicalize_node(s, arg2))
+				return FALSE;
+		}
+		g_string_append_c(s, ')');
+		return TRUE;
+	case STTYPE_FIELD:
+		g_string_append(s, ((header_field_info *)stnode_data(node))->abbrev);
+		return TRUE;
+	case STTYPE_FVALUE:
+		fv = (fvalue_t *)stnode_data(node);
+		repr = fvalue_to_string_repr(NULL, fv, FTREPR_DFILTER, BASE_NONE);
+		if (!repr)
+			return FALSE;
+		g_string_append_printf(s, "<%s %s>", fvalue_type_name(fv), repr);
+		wmem_free(NULL, repr);
+		return TRUE;
+	case STTYPE_RANGE:
+		if (!canonicalize_node(s, sttype_range_entity(node)))
+			return FALSE;
+		drange_foreach_drange_node(sttype_range_drange(node), canonicalize_drange_node, s);
+		return TRUE;
+	case STTYPE_FUNCTION:
+		g_string_append_printf(s, "%s(", sttype_function_funcdef(node)->name);
+		if (!canonicalize_list(s, sttype_function_params(node)))
+			return FALSE;
+		g_string_append_c(s, ')');
+		return TRUE;
+	case STTYPE_SET:
+		g_string_append_c(s, '{');
+		if (!canonicalize_list(s, (GSList *)stnode_data(node)))
+			return FALSE;
+		g_string_append_c(s, '}');
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+static gchar *
+canonicalize(stnode_t *node)
+{
+	GString	*s = g_string_new(NULL);
+
+	if (!canonicalize_node(s, node)) {
+		g_string_free(s, TRUE);
+		return NULL;
+	}
+	return g_string_free(s, FALSE);
+}
+
 
 static dfwork_t*
 dfwork_new(void)
@@ -334,17 +455,32 @@ dfilter_compile(const gchar *text, dfilter_t **dfp, gchar **err_msg)
 			goto FAILURE;
 		}
 
+		/* Remember the checked syntax tree for dfilter_narrows()
+		 * before dfw_gencode() takes it apart. */
+		dfilter = dfilter_new();
+		if (stnode_type_id(dfw->st_root) == STTYPE_TEST) {
+			test_op_t	op;
+			stnode_t	*arg1, *arg2;
+
+			dfilter->canonical = canonicalize(dfw->st_root);
+			sttype_test_get(dfw->st_root, &op, &arg1, &arg2);
+			if (op == TEST_OP_AND)
+				dfilter->canonical_and_lhs = canonicalize(arg1);
+		}
+
 		/* Create bytecode */
 		dfw_gencode(dfw);
 
 		/* Tuck away the bytecode in the dfilter_t */
-		dfilter = dfilter_new();
 		dfilter->insns = dfw->insns;
 		dfilter->consts = dfw->consts;
 		dfw->insns = NULL;
 		dfw->consts = NULL;
 		dfilter->interesting_fields = dfw_interesting_fields(dfw,
 			&dfilter->num_interesting_fields);
+		dfilter->protocol_reqs = dfw_protocol_requirements(dfw,
+			&dfilter->num_protocol_reqs);
+		dfilter->protocol_stack = g_new(gboolean, dfilter->num_protocol_reqs);
 
 		/* Initialize run-time space */
 		dfilter->num_registers = dfw->first_constant;
@@ -410,6 +546,23 @@ dfilter_apply_edt(dfilter_t *df, epan_dissect_t* edt)
 	return dfvm_apply(df, edt->tree);
 }
 
+void
+dfilter_set_profiling(dfilter_t *df, gboolean profiling)
+{
+	g_free(df->profile);
+	df->profile = profiling ? g_new0(dfilter_profile_t, 1) : NULL;
+}
+
+gboolean
+dfilter_get_profile(const dfilter_t *df, dfilter_profile_t *profile)
+{
+	if (!df->profile)
+		return FALSE;
+
+	*profile = *df->profile;
+	return TRUE;
+}
+
 
 void
 dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree)
@@ -427,6 +580,81 @@ dfilter_has_interesting_fields(const dfilter_t *df)
 	return (df->num_interesting_fields > 0);
 }
 
+gboolean
+dfilter_requires_protocols(const dfilter_t *df)
+{
+	return (df->num_protocol_reqs > 0);
+}
+
+gboolean
+dfilter_could_match_protocols(const dfilter_t *df, dfilter_has_protocol_func has_protocol, void *data)
+{
+	gboolean	*stack = df->protocol_stack;
+	int		depth = 0;
+	int		i, req;
+
+	for (i = 0; i < df->num_protocol_reqs; i++) {
+		req = df->protocol_reqs[i];
+		if (req == DFW_PROTO_AND) {
+			depth--;
+			stack[depth - 1] = stack[depth - 1] && stack[depth];
+		} else if (req == DFW_PROTO_OR) {
+			depth--;
+			stack[depth - 1] = stack[depth - 1] || stack[depth];
+		} else {
+			stack[depth++] = has_protocol(req, data);
+		}
+	}
+
+	return (depth == 0 || stack[0]);
+}
+
+/* Fields whose values can change without the frame being dissected
+ * again, e.g. when packets are marked or a time reference is set. */
+static const char *mutable_fields[] = {
+	"frame.marked",
+	"frame.ignored",
+	"frame.ref_time",
+	"frame.comment",
+	"frame.time",
+	"frame.time_epoch",
+	"frame.time_relative",
+	"frame.time_delta",
+	"frame.time_delta_displayed",
+	"frame.offset_shift",
+	NULL
+};
+
+static gboolean
+dfilter_uses_mutable_fields(const dfilter_t *df)
+{
+	int	i, j, hf_id;
+
+	for (i = 0; mutable_fields[i]; i++) {
+		hf_id = proto_registrar_get_id_byname(mutable_fields[i]);
+		if (hf_id < 0)
+			continue;
+		for (j = 0; j < df->num_interesting_fields; j++) {
+			if (df->interesting_fields[j] == hf_id)
+				return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+gboolean
+dfilter_narrows(const dfilter_t *df_old, const dfilter_t *df_new)
+{
+	if (!df_old || !df_new || !df_old->canonical || !df_new->canonical_and_lhs)
+		return FALSE;
+
+	if (strcmp(df_old->canonical, df_new->canonical_and_lhs) != 0)
+		return FALSE;
+
+	/* A frame that failed df_old might pass it now. */
+	return !dfilter_uses_mutable_fields(df_old) && !dfilter_uses_mutable_fields(df_new);
+}
+
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df) {
 	if (df->deprecated && df->deprecated->len > 0) {
@@ -72,6 +72,30 @@ dfilter_prime_proto_tree(const dfilter_t *df, proto_tree *tree);
 gboolean
 dfilter_has_interesting_fields(const dfilter_t *df);
 
+/* Check if dfilter can only match packets that have certain protocols */
+WS_DLL_PUBLIC
+gboolean
+dfilter_requires_protocols(const dfilter_t *df);
+
+typedef gboolean (*dfilter_has_protocol_func)(int proto_id, void *data);
+
+/* Returns FALSE if dfilter can't match a packet whose protocol tree has
+ * only the protocols for which has_protocol returns TRUE. This lets a
+ * caller that remembers which protocols were in each frame skip frames
+ * without dissecting them. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_could_match_protocols(const dfilter_t *df, dfilter_has_protocol_func has_protocol, void *data);
+
+/* Returns TRUE if df_new can only match packets that df_old matched,
+ * because df_new is "df_old && ..." (with any spacing or parentheses),
+ * e.g. as built by "Apply as Filter" > "...and Selected". Filters that
+ * test fields whose values can change without redissection, such as
+ * frame.marked or frame.time_relative, never narrow. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_narrows(const dfilter_t *df_old, const dfilter_t *df_new);
+
 WS_DLL_PUBLIC
 GPtrArray *
 dfilter_deprecated_tokens(dfilter_t *df);
@@ -81,6 +105,36 @@ WS_DLL_PUBLIC
 void
 dfilter_dump(dfilter_t *df);
 
+/* Classes of instructions whose cost is measured separately when a
+ * dfilter is being profiled. */
+typedef enum {
+	DFILTER_PROFILE_TREE,		/* READ_TREE, CHECK_EXISTS */
+	DFILTER_PROFILE_COMPARE,	/* relations, ranges and field tests */
+	DFILTER_PROFILE_FUNCTION,	/* CALL_FUNCTION */
+	DFILTER_PROFILE_OTHER,		/* jumps, NOT, RETURN */
+	DFILTER_PROFILE_NUM_CLASSES
+} dfilter_profile_class_t;
+
+typedef struct {
+	guint64 applies;				/* times the filter was applied */
+	guint64 insns[DFILTER_PROFILE_NUM_CLASSES];	/* instructions executed */
+	guint64 nsecs[DFILTER_PROFILE_NUM_CLASSES];	/* time spent in them */
+} dfilter_profile_t;
+
+/* Start or stop timing each instruction run by dfilter_apply*().
+ * Starting clears the counters. Reading the clock for every
+ * instruction is not free, so the totals will be higher than the
+ * time the filter takes when it is not being profiled. */
+WS_DLL_PUBLIC
+void
+dfilter_set_profiling(dfilter_t *df, gboolean profiling);
+
+/* Copy the counters gathered since profiling was started. Returns
+ * FALSE, leaving *profile untouched, if profiling isn't enabled. */
+WS_DLL_PUBLIC
+gboolean
+dfilter_get_profile(const dfilter_t *df, dfilter_profile_t *profile);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -8,9 +8,12 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "dfvm.h"
 
 #include <ftypes/ftypes-int.h>
+#include <wsutil/time_util.h>
 
 dfvm_insn_t*
 dfvm_insn_new(dfvm_opcode_t op)
@@ -36,6 +39,9 @@ dfvm_value_free(dfvm_value_t *v)
 		case DRANGE:
 			drange_free(v->value.drange);
 			break;
+		case FVALUE_SET:
+			g_hash_table_destroy(v->value.fvalue_set);
+			break;
 		default:
 			/* nothing */
 			;
@@ -73,6 +79,25 @@ dfvm_value_new(dfvm_value_type_t type)
 }
 
 
+static const char *
+relation_name(dfvm_opcode_t op)
+{
+	switch (op) {
+		case ANY_EQ:		return "==";
+		case ANY_NE:		return "!=";
+		case ANY_GT:		return ">";
+		case ANY_GE:		return ">=";
+		case ANY_LT:		return "<";
+		case ANY_LE:		return "<=";
+		case ANY_BITWISE_AND:	return "&";
+		case ANY_CONTAINS:	return "contains";
+		case ANY_MATCHES:	return "matches";
+		default:
+			g_assert_not_reached();
+			return "?";
+	}
+}
+
 void
 dfvm_dump(FILE *f, dfilter_t *df)
 {
@@ -119,6 +144,9 @@ dfvm_dump(FILE *f, dfilter_t *df)
 			case ANY_CONTAINS:
 			case ANY_MATCHES:
 			case ANY_IN_RANGE:
+			case ANY_FIELD_TEST:
+			case ANY_FIELD_TEST_UINT:
+			case ANY_IN_SET:
 			case NOT:
 			case RETURN:
 			case IF_TRUE_GOTO:
@@ -259,6 +287,28 @@ dfvm_dump(FILE *f, dfilter_t *df)
 					arg3->value.numeric);
 				break;
 
+			case ANY_FIELD_TEST:
+			case ANY_FIELD_TEST_UINT:
+				value_str = fvalue_to_string_repr(NULL, arg2->value.fvalue,
+					FTREPR_DFILTER, BASE_NONE);
+				fprintf(f, "%05d %s\t%s %s %s <%s>\n",
+					id, insn->op == ANY_FIELD_TEST ? "ANY_FIELD_TEST" : "ANY_FIELD_TEST_UINT",
+					arg1->value.hfinfo->abbrev,
+					relation_name((dfvm_opcode_t)arg3->value.numeric),
+					value_str, fvalue_type_name(arg2->value.fvalue));
+				wmem_free(NULL, value_str);
+				if (arg4) {
+					fprintf(f, "\t\tif it contains \"%s\"\n",
+						arg4->value.fvalue->value.string);
+				}
+				break;
+
+			case ANY_IN_SET:
+				fprintf(f, "%05d ANY_IN_SET\treg#%u in set of %u values\n",
+					id, arg1->value.numeric,
+					g_hash_table_size(arg2->value.fvalue_set));
+				break;
+
 			case NOT:
 				fprintf(f, "%05d NOT\n", id);
 				break;
@@ -369,6 +419,167 @@ any_test(dfilter_t *df, FvalueCmpFunc cmp, int reg1, int reg2)
 	return FALSE;
 }
 
+static FvalueCmpFunc
+relation_cmp_func(dfvm_opcode_t op)
+{
+	switch (op) {
+		case ANY_EQ:		return fvalue_eq;
+		case ANY_NE:		return fvalue_ne;
+		case ANY_GT:		return fvalue_gt;
+		case ANY_GE:		return fvalue_ge;
+		case ANY_LT:		return fvalue_lt;
+		case ANY_LE:		return fvalue_le;
+		case ANY_BITWISE_AND:	return fvalue_bitwise_and;
+		case ANY_CONTAINS:	return fvalue_contains;
+		case ANY_MATCHES:	return fvalue_matches;
+		default:
+			g_assert_not_reached();
+			return NULL;
+	}
+}
+
+/* Returns TRUE if data contains literal, which is upper case, ignoring
+ * ASCII case. */
+static gboolean
+has_literal_nocase(const guint8 *data, size_t data_len, const char *literal,
+		size_t literal_len)
+{
+	const guint8	*cur, *last;
+	guint8		first = (guint8)literal[0];
+	guint8		first_lower = g_ascii_tolower(first);
+	size_t		i;
+
+	if (literal_len > data_len) {
+		return FALSE;
+	}
+
+	last = data + data_len - literal_len;
+	for (cur = data; cur <= last; cur++) {
+		if (*cur != first && *cur != first_lower) {
+			continue;
+		}
+		for (i = 1; i < literal_len; i++) {
+			if (g_ascii_toupper(cur[i]) != (guint8)literal[i]) {
+				break;
+			}
+		}
+		if (i == literal_len) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
+/* Returns FALSE if a string or byte string value can't match a pattern
+ * because it doesn't contain the literal that the pattern requires. */
+static gboolean
+might_match_literal(const fvalue_t *value, const fvalue_t *literal)
+{
+	const char	*str = literal->value.string;
+	GByteArray	*bytes;
+
+	switch (value->ftype->ftype) {
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+			return has_literal_nocase((const guint8 *)value->value.string,
+					strlen(value->value.string), str, strlen(str));
+		case FT_BYTES:
+			bytes = value->value.bytes;
+			return has_literal_nocase(bytes->data, bytes->len, str, strlen(str));
+		default:
+			return TRUE;
+	}
+}
+
+/* Does the same as READ_TREE followed by a relation with a constant,
+ * comparing the field values in the tree directly instead of loading
+ * them into a register first. If literal isn't NULL, values that don't
+ * contain it can't match and aren't compared. */
+static gboolean
+any_field_test(proto_tree *tree, header_field_info *hfinfo, FvalueCmpFunc cmp,
+		const fvalue_t *fv, const fvalue_t *literal)
+{
+	GPtrArray	*finfos;
+	field_info	*finfo;
+	guint		i;
+
+	for (; hfinfo; hfinfo = hfinfo->same_name_next) {
+		finfos = proto_get_finfo_ptr_array(tree, hfinfo->id);
+		if (finfos == NULL) {
+			continue;
+		}
+		for (i = 0; i < finfos->len; i++) {
+			finfo = (field_info *)g_ptr_array_index(finfos, i);
+			if (literal && !might_match_literal(&finfo->value, literal)) {
+				continue;
+			}
+			if (cmp(&finfo->value, fv)) {
+				return TRUE;
+			}
+		}
+	}
+	return FALSE;
+}
+
+/* Like any_field_test, for fields whose values are all guint32s
+ * (FT_UINT8 to FT_UINT32 and FT_CHAR). */
+static gboolean
+any_field_test_uint(proto_tree *tree, header_field_info *hfinfo, dfvm_opcode_t op,
+		guint32 value)
+{
+	GPtrArray	*finfos;
+	field_info	*finfo;
+	guint32		field_value;
+	guint		i;
+
+	for (; hfinfo; hfinfo = hfinfo->same_name_next) {
+		finfos = proto_get_finfo_ptr_array(tree, hfinfo->id);
+		if (finfos == NULL) {
+			continue;
+		}
+		for (i = 0; i < finfos->len; i++) {
+			finfo = (field_info *)g_ptr_array_index(finfos, i);
+			field_value = finfo->value.value.uinteger;
+			switch (op) {
+				case ANY_EQ:
+					if (field_value == value)
+						return TRUE;
+					break;
+				case ANY_NE:
+					if (field_value != value)
+						return TRUE;
+					break;
+				case ANY_GT:
+					if (field_value > value)
+						return TRUE;
+					break;
+				case ANY_GE:
+					if (field_value >= value)
+						return TRUE;
+					break;
+				case ANY_LT:
+					if (field_value < value)
+						return TRUE;
+					break;
+				case ANY_LE:
+					if (field_value <= value)
+						return TRUE;
+					break;
+				case ANY_BITWISE_AND:
+					if (field_value & value)
+						return TRUE;
+					break;
+				default:
+					g_assert_not_reached();
+					break;
+			}
+		}
+	}
+	return FALSE;
+}
+
 static gboolean
 any_in_range(dfilter_t *df, int reg1, int reg2, int reg3)
 {
@@ -400,6 +611,34 @@ any_in_range(dfilter_t *df, int reg1, int reg2, int reg3)
 	return FALSE;
 }
 
+/* Returns TRUE if any of the values in the register is in the set. */
+static gboolean
+any_in_set(dfilter_t *df, int reg, GHashTable *set, dfvm_set_key_t key)
+{
+	GList		*list;
+	fvalue_t	*value;
+	gconstpointer	lookup = NULL;
+
+	for (list = df->registers[reg]; list; list = g_list_next(list)) {
+		value = (fvalue_t *)list->data;
+		switch (key) {
+			case DFVM_SET_KEY_INTEGER:
+				lookup = GUINT_TO_POINTER(value->value.uinteger);
+				break;
+			case DFVM_SET_KEY_IPV4:
+				lookup = GUINT_TO_POINTER(value->value.ipv4.addr);
+				break;
+			case DFVM_SET_KEY_STRING:
+				lookup = value->value.string;
+				break;
+		}
+		if (g_hash_table_contains(set, lookup)) {
+			return TRUE;
+		}
+	}
+	return FALSE;
+}
+
 
 static void
 free_owned_register(gpointer data, gpointer user_data _U_)
@@ -457,6 +696,44 @@ mk_range(dfilter_t *df, int from_reg, int to_reg, drange_t *d_range)
 }
 
 
+static dfilter_profile_class_t
+profile_class(dfvm_opcode_t op)
+{
+	switch (op) {
+		case READ_TREE:
+		case CHECK_EXISTS:
+			return DFILTER_PROFILE_TREE;
+
+		case CALL_FUNCTION:
+			return DFILTER_PROFILE_FUNCTION;
+
+		case IF_TRUE_GOTO:
+		case IF_FALSE_GOTO:
+		case NOT:
+		case RETURN:
+		case PUT_FVALUE:
+			return DFILTER_PROFILE_OTHER;
+
+		default:
+			return DFILTER_PROFILE_COMPARE;
+	}
+}
+
+/* Charge the time since *start to the class of insn and restart the clock.
+ * The first call of an application has no instruction to charge. */
+static void
+profile_insn(dfilter_profile_t *profile, dfvm_insn_t *insn, guint64 *start)
+{
+	guint64 now = get_monotonic_nsecs();
+
+	if (insn) {
+		dfilter_profile_class_t cls = profile_class(insn->op);
+
+		profile->insns[cls]++;
+		profile->nsecs[cls] += now - *start;
+	}
+	*start = now;
+}
 
 gboolean
 dfvm_apply(dfilter_t *df, proto_tree *tree)
@@ -471,15 +748,24 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 	header_field_info	*hfinfo;
 	GList		*param1;
 	GList		*param2;
+	dfvm_insn_t	*prev_insn = NULL;
+	guint64		profile_start = 0;
 
 	g_assert(tree);
 
 	length = df->insns->len;
 
+	if (G_UNLIKELY(df->profile))
+		df->profile->applies++;
+
 	for (id = 0; id < length; id++) {
 
 	  AGAIN:
 		insn = (dfvm_insn_t	*)g_ptr_array_index(df->insns, id);
+		if (G_UNLIKELY(df->profile)) {
+			profile_insn(df->profile, prev_insn, &profile_start);
+			prev_insn = insn;
+		}
 		arg1 = insn->arg1;
 		arg2 = insn->arg2;
 
@@ -579,12 +865,33 @@ dfvm_apply(dfilter_t *df, proto_tree *tree)
 						arg3->value.numeric);
 				break;
 
+			case ANY_FIELD_TEST:
+				accum = any_field_test(tree, arg1->value.hfinfo,
+						relation_cmp_func((dfvm_opcode_t)insn->arg3->value.numeric),
+						arg2->value.fvalue,
+						insn->arg4 ? insn->arg4->value.fvalue : NULL);
+				break;
+
+			case ANY_FIELD_TEST_UINT:
+				accum = any_field_test_uint(tree, arg1->value.hfinfo,
+						(dfvm_opcode_t)insn->arg3->value.numeric,
+						arg2->value.fvalue->value.uinteger);
+				break;
+
+			case ANY_IN_SET:
+				accum = any_in_set(df, arg1->value.numeric,
+						arg2->value.fvalue_set,
+						(dfvm_set_key_t)insn->arg3->value.numeric);
+				break;
+
 			case NOT:
 				accum = !accum;
 				break;
 
 			case RETURN:
 				free_register_overhead(df);
+				if (G_UNLIKELY(df->profile))
+					profile_insn(df->profile, insn, &profile_start);
 				return accum;
 
 			case IF_TRUE_GOTO:
@@ -654,6 +961,9 @@ dfvm_init_const(dfilter_t *df)
 			case ANY_CONTAINS:
 			case ANY_MATCHES:
 			case ANY_IN_RANGE:
+			case ANY_FIELD_TEST:
+			case ANY_FIELD_TEST_UINT:
+			case ANY_IN_SET:
 			case NOT:
 			case RETURN:
 			case IF_TRUE_GOTO:
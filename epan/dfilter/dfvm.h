@@ -23,7 +23,8 @@ typedef enum {
 	REGISTER,
 	INTEGER,
 	DRANGE,
-	FUNCTION_DEF
+	FUNCTION_DEF,
+	FVALUE_SET
 } dfvm_value_type_t;
 
 typedef struct {
@@ -35,6 +36,7 @@ typedef struct {
 		drange_t		*drange;
 		header_field_info	*hfinfo;
         df_func_def_t   *funcdef;
+		GHashTable		*fvalue_set;
 	} value;
 
 } dfvm_value_t;
@@ -60,10 +62,20 @@ typedef enum {
 	ANY_MATCHES,
 	MK_RANGE,
 	CALL_FUNCTION,
-	ANY_IN_RANGE
+	ANY_IN_RANGE,
+	ANY_FIELD_TEST,
+	ANY_FIELD_TEST_UINT,
+	ANY_IN_SET
 
 } dfvm_opcode_t;
 
+/* How ANY_IN_SET looks up a value in its FVALUE_SET. */
+typedef enum {
+	DFVM_SET_KEY_INTEGER,	/* 32-bit integers, by value.uinteger */
+	DFVM_SET_KEY_IPV4,	/* IPv4 host addresses, by value.ipv4.addr */
+	DFVM_SET_KEY_STRING	/* strings, by value.string */
+} dfvm_set_key_t;
+
 typedef struct {
 	int		id;
 	dfvm_opcode_t	op;
@@ -8,6 +8,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include "dfilter-int.h"
 #include "gencode.h"
 #include "dfvm.h"
@@ -252,12 +254,225 @@ gen_relation_regs(dfwork_t *dfw, dfvm_opcode_t op, int reg1, int reg2)
 	dfw_append_insn(dfw, insn);
 }
 
+static gboolean
+ftype_is_uinteger(ftenum_t ftype)
+{
+	switch (ftype) {
+		case FT_CHAR:
+		case FT_UINT8:
+		case FT_UINT16:
+		case FT_UINT24:
+		case FT_UINT32:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+/* Returns the longest run of literal characters that every match of a
+ * "matches" pattern must contain, upper-cased as the patterns are
+ * compiled caseless (see ftype-pcre.c), or NULL if there isn't one of
+ * at least two characters. This is conservative: anything that isn't
+ * understood, such as alternation, inline options or escapes with
+ * arguments, gives up. */
+static void
+regex_literal_end_run(GString *run, GString *best)
+{
+	if (run->len > best->len)
+		g_string_assign(best, run->str);
+	g_string_truncate(run, 0);
+}
+
+static char *
+regex_required_literal(const char *pattern)
+{
+	GString		*run = g_string_new(NULL);
+	GString		*best = g_string_new(NULL);
+	const char	*p;
+	int		depth = 0;
+	gboolean	ok = TRUE;
+
+	for (p = pattern; *p && ok; p++) {
+		switch (*p) {
+			case '|':
+				/* Alternatives might not contain the run. */
+				ok = FALSE;
+				break;
+
+			case '(':
+				if (p[1] == '?') {
+					/* Inline options might turn off caseless
+					 * matching or turn on extended syntax. */
+					ok = FALSE;
+					break;
+				}
+				regex_literal_end_run(run, best);
+				depth++;
+				break;
+
+			case ')':
+				depth--;
+				break;
+
+			case '[':
+				/* Skip a character class. A ']' right after
+				 * the '[' or "[^" is part of the class. */
+				regex_literal_end_run(run, best);
+				p++;
+				if (*p == '^')
+					p++;
+				if (*p == ']')
+					p++;
+				while (*p && *p != ']') {
+					if (*p == '\\' && p[1])
+						p++;
+					p++;
+				}
+				if (!*p)
+					ok = FALSE;
+				break;
+
+			case '?':
+			case '*':
+			case '{':
+				/* The previous character is optional. */
+				if (run->len > 0)
+					g_string_truncate(run, run->len - 1);
+				regex_literal_end_run(run, best);
+				if (*p == '{') {
+					while (*p && *p != '}')
+						p++;
+					if (!*p)
+						ok = FALSE;
+				}
+				break;
+
+			case '+':
+			case '.':
+			case '^':
+			case '$':
+				regex_literal_end_run(run, best);
+				break;
+
+			case '\\':
+				p++;
+				if (g_ascii_isalnum(*p)) {
+					/* Only allow escapes without an argument,
+					 * which match something other than a
+					 * literal. */
+					if (!strchr("dDsSwWbBAzZGhHvVR", *p))
+						ok = FALSE;
+					regex_literal_end_run(run, best);
+				} else if (!*p) {
+					ok = FALSE;
+				} else if (depth == 0) {
+					g_string_append_c(run, g_ascii_toupper(*p));
+				}
+				break;
+
+			default:
+				if (depth == 0)
+					g_string_append_c(run, g_ascii_toupper(*p));
+				break;
+		}
+	}
+	regex_literal_end_run(run, best);
+
+	g_string_free(run, TRUE);
+	if (!ok || best->len < 2) {
+		g_string_free(best, TRUE);
+		return NULL;
+	}
+	return g_string_free(best, FALSE);
+}
+
+static gboolean
+ftype_has_text(ftenum_t ftype)
+{
+	switch (ftype) {
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+		case FT_BYTES:
+			return TRUE;
+		default:
+			return FALSE;
+	}
+}
+
+/* Compare a field with a constant in one instruction, which doesn't have
+ * to load the field values into a register. Fields and constants that are
+ * all plain guint32s are compared without calling the ftype functions.
+ * For "matches" on strings and bytes, a literal that the pattern requires
+ * is passed along, so that values without it skip the regex. */
+static void
+gen_field_test(dfwork_t *dfw, dfvm_opcode_t op, header_field_info *hfinfo, fvalue_t *fv)
+{
+	dfvm_insn_t		*insn;
+	dfvm_value_t		*val;
+	header_field_info	*hfinfo_same;
+	gboolean		uinteger = (op != ANY_CONTAINS && op != ANY_MATCHES &&
+				    ftype_is_uinteger(fvalue_type_ftenum(fv)));
+	gboolean		text = (op == ANY_MATCHES);
+	char			*literal = NULL;
+	fvalue_t		*fv_literal;
+
+	/* Rewind to find the first field of this name. */
+	while (hfinfo->same_name_prev_id != -1) {
+		hfinfo = proto_registrar_get_nth(hfinfo->same_name_prev_id);
+	}
+
+	for (hfinfo_same = hfinfo; hfinfo_same; hfinfo_same = hfinfo_same->same_name_next) {
+		if (!ftype_is_uinteger(hfinfo_same->type)) {
+			uinteger = FALSE;
+		}
+		if (!ftype_has_text(hfinfo_same->type)) {
+			text = FALSE;
+		}
+		/* Record the FIELD_ID in hash of interesting fields. */
+		g_hash_table_insert(dfw->interesting_fields,
+		    GINT_TO_POINTER(hfinfo_same->id),
+		    GUINT_TO_POINTER(TRUE));
+	}
+
+	insn = dfvm_insn_new(uinteger ? ANY_FIELD_TEST_UINT : ANY_FIELD_TEST);
+	val = dfvm_value_new(HFINFO);
+	val->value.hfinfo = hfinfo;
+	insn->arg1 = val;
+	val = dfvm_value_new(FVALUE);
+	val->value.fvalue = fv;
+	insn->arg2 = val;
+	val = dfvm_value_new(INTEGER);
+	val->value.numeric = op;
+	insn->arg3 = val;
+	if (text) {
+		literal = regex_required_literal(g_regex_get_pattern((GRegex *)fvalue_get(fv)));
+	}
+	if (literal) {
+		fv_literal = fvalue_new(FT_STRING);
+		fvalue_set_string(fv_literal, literal);
+		g_free(literal);
+		val = dfvm_value_new(FVALUE);
+		val->value.fvalue = fv_literal;
+		insn->arg4 = val;
+	}
+	dfw_append_insn(dfw, insn);
+}
+
 static void
 gen_relation(dfwork_t *dfw, dfvm_opcode_t op, stnode_t *st_arg1, stnode_t *st_arg2)
 {
 	dfvm_value_t	*jmp1 = NULL, *jmp2 = NULL;
 	int		reg1 = -1, reg2 = -1;
 
+	if (stnode_type_id(st_arg1) == STTYPE_FIELD &&
+	    stnode_type_id(st_arg2) == STTYPE_FVALUE) {
+		gen_field_test(dfw, op, (header_field_info*)stnode_data(st_arg1),
+		    (fvalue_t *)stnode_steal_data(st_arg2));
+		return;
+	}
+
 	/* Create code for the LHS and RHS of the relation */
 	reg1 = gen_entity(dfw, st_arg1, &jmp1);
 	reg2 = gen_entity(dfw, st_arg2, &jmp2);
@@ -287,8 +502,136 @@ fixup_jumps(gpointer data, gpointer user_data)
 	}
 }
 
+/* Sets with fewer constants than this are tested with == one by one. */
+#define IN_SET_MIN_MEMBERS	4
+
+/* Returns how values of an ftype are looked up by ANY_IN_SET, or -1 if
+ * they can't be. Values with the same key must be equal by fvalue_eq. */
+static int
+set_key_for_ftype(ftenum_t ftype)
+{
+	switch (ftype) {
+		case FT_CHAR:
+		case FT_UINT8:
+		case FT_UINT16:
+		case FT_UINT24:
+		case FT_UINT32:
+		case FT_INT8:
+		case FT_INT16:
+		case FT_INT24:
+		case FT_INT32:
+			return DFVM_SET_KEY_INTEGER;
+		case FT_IPv4:
+			return DFVM_SET_KEY_IPV4;
+		case FT_STRING:
+		case FT_STRINGZ:
+		case FT_UINT_STRING:
+		case FT_STRINGZPAD:
+			return DFVM_SET_KEY_STRING;
+		default:
+			return -1;
+	}
+}
+
+/* Returns the set key for all the fields with this name, or -1 if they
+ * don't share one. */
+static int
+set_key_for_field(header_field_info *hfinfo)
+{
+	int	key;
+
+	/* Rewind to find the first field of this name. */
+	while (hfinfo->same_name_prev_id != -1) {
+		hfinfo = proto_registrar_get_nth(hfinfo->same_name_prev_id);
+	}
+
+	key = set_key_for_ftype(hfinfo->type);
+	for (hfinfo = hfinfo->same_name_next; hfinfo; hfinfo = hfinfo->same_name_next) {
+		if (set_key_for_ftype(hfinfo->type) != key) {
+			return -1;
+		}
+	}
+	return key;
+}
+
+/* Returns TRUE if a set element (node2 is the upper bound of a range, or
+ * NULL) is a constant that can be looked up with the given key. */
+static gboolean
+set_element_is_hashable(stnode_t *node1, stnode_t *node2, int key)
+{
+	fvalue_t	*fv;
+
+	if (node2 || stnode_type_id(node1) != STTYPE_FVALUE) {
+		return FALSE;
+	}
+	fv = (fvalue_t *)stnode_data(node1);
+	if (set_key_for_ftype(fvalue_type_ftenum(fv)) != key) {
+		return FALSE;
+	}
+	/* With a netmask, == matches a whole subnet. */
+	if (key == DFVM_SET_KEY_IPV4 && fv->value.ipv4.nmask != 0xffffffff) {
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/* Puts the constants of an "in" set that can be looked up with the given
+ * key into a hash table, or returns NULL if there are too few of them.
+ * *n_other is set to the number of elements left for == and range tests. */
+static GHashTable *
+gen_in_set_table(GSList *nodelist, int key, guint *n_other)
+{
+	GHashTable	*set;
+	GSList		*item;
+	stnode_t	*node1, *node2;
+	fvalue_t	*fv;
+	guint		n_hashable = 0;
+
+	*n_other = 0;
+	for (item = nodelist; item; item = g_slist_next(g_slist_next(item))) {
+		node1 = (stnode_t*)item->data;
+		node2 = (stnode_t*)g_slist_next(item)->data;
+		if (set_element_is_hashable(node1, node2, key)) {
+			n_hashable++;
+		} else {
+			(*n_other)++;
+		}
+	}
+	if (n_hashable < IN_SET_MIN_MEMBERS) {
+		return NULL;
+	}
+
+	if (key == DFVM_SET_KEY_STRING) {
+		set = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	} else {
+		set = g_hash_table_new(g_direct_hash, g_direct_equal);
+	}
+	for (item = nodelist; item; item = g_slist_next(g_slist_next(item))) {
+		node1 = (stnode_t*)item->data;
+		node2 = (stnode_t*)g_slist_next(item)->data;
+		if (!set_element_is_hashable(node1, node2, key)) {
+			continue;
+		}
+		fv = (fvalue_t *)stnode_data(node1);
+		switch (key) {
+			case DFVM_SET_KEY_INTEGER:
+				g_hash_table_add(set, GUINT_TO_POINTER(fv->value.uinteger));
+				break;
+			case DFVM_SET_KEY_IPV4:
+				g_hash_table_add(set, GUINT_TO_POINTER(fv->value.ipv4.addr));
+				break;
+			case DFVM_SET_KEY_STRING:
+				g_hash_table_add(set, g_strdup(fv->value.string));
+				break;
+		}
+	}
+	return set;
+}
+
 /* Generate the code for the in operator.  It behaves much like an OR-ed
- * series of == tests, but without the redundant existence checks. */
+ * series of == tests, but without the redundant existence checks. When
+ * a field is tested against enough integer, IPv4 or string constants,
+ * those are looked up in a hash table by a single ANY_IN_SET instead. */
 static void
 gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 {
@@ -299,18 +642,55 @@ gen_relation_in(dfwork_t *dfw, stnode_t *st_arg1, stnode_t *st_arg2)
 	stnode_t	*node1, *node2;
 	GSList		*nodelist_head, *nodelist;
 	GSList		*jumplist = NULL;
+	GHashTable	*set = NULL;
+	int		key = -1;
+	guint		n_other = 0;
 
 	/* Create code for the LHS of the relation */
 	reg1 = gen_entity(dfw, st_arg1, &jmp1);
 
 	/* Create code for the set on the RHS of the relation */
 	nodelist_head = nodelist = (GSList*)stnode_steal_data(st_arg2);
+
+	if (stnode_type_id(st_arg1) == STTYPE_FIELD) {
+		key = set_key_for_field((header_field_info*)stnode_data(st_arg1));
+	}
+	if (key != -1) {
+		set = gen_in_set_table(nodelist_head, key, &n_other);
+	}
+	if (set) {
+		insn = dfvm_insn_new(ANY_IN_SET);
+		val1 = dfvm_value_new(REGISTER);
+		val1->value.numeric = reg1;
+		val2 = dfvm_value_new(FVALUE_SET);
+		val2->value.fvalue_set = set;
+		val3 = dfvm_value_new(INTEGER);
+		val3->value.numeric = key;
+		insn->arg1 = val1;
+		insn->arg2 = val2;
+		insn->arg3 = val3;
+		dfw_append_insn(dfw, insn);
+
+		if (n_other) {
+			insn = dfvm_insn_new(IF_TRUE_GOTO);
+			val1 = dfvm_value_new(INSN_NUMBER);
+			insn->arg1 = val1;
+			dfw_append_insn(dfw, insn);
+			jumplist = g_slist_prepend(jumplist, val1);
+		}
+	}
+
 	while (nodelist) {
 		node1 = (stnode_t*)nodelist->data;
 		nodelist = g_slist_next(nodelist);
 		node2 = (stnode_t*)nodelist->data;
 		nodelist = g_slist_next(nodelist);
 
+		if (set && set_element_is_hashable(node1, node2, key)) {
+			/* Already in the set. */
+			continue;
+		}
+
 		if (node2) {
 			/* Range element: add lower/upper bound test. */
 			reg2 = gen_entity(dfw, node1, &jmp2);
@@ -661,6 +1041,137 @@ dfw_interesting_fields(dfwork_t *dfw, int *caller_num_fields)
 	return hki.fields;
 }
 
+/* Protocol requirements of a filter, in postfix form. A non-negative
+ * entry is "this protocol is in the tree", DFW_PROTO_AND and DFW_PROTO_OR
+ * combine the two values before it. An empty program places no
+ * requirement on the tree.
+ *
+ * Only what gencode makes false for a missing field is recorded: a field
+ * that is tested for existence or read by a relation. Anything under a
+ * "not" or a function says nothing about which protocols must be present. */
+static void
+proto_reqs_append(GArray *dst, GArray *src)
+{
+	g_array_append_vals(dst, src->data, src->len);
+	g_array_free(src, TRUE);
+}
+
+static GArray *
+proto_reqs_combine(GArray *reqs1, GArray *reqs2, int op)
+{
+	if (reqs1->len == 0 || reqs2->len == 0) {
+		if (op == DFW_PROTO_OR) {
+			/* Either side can match without any protocol. */
+			g_array_set_size(reqs1, 0);
+			g_array_free(reqs2, TRUE);
+			return reqs1;
+		}
+		if (reqs1->len == 0) {
+			g_array_free(reqs1, TRUE);
+			return reqs2;
+		}
+		g_array_free(reqs2, TRUE);
+		return reqs1;
+	}
+	proto_reqs_append(reqs1, reqs2);
+	g_array_append_val(reqs1, op);
+	return reqs1;
+}
+
+static GArray *
+proto_reqs_field(header_field_info *hfinfo)
+{
+	GArray	*reqs = g_array_new(FALSE, FALSE, sizeof(int));
+	int	op = DFW_PROTO_OR;
+
+	/* Rewind to find the first field of this name. */
+	while (hfinfo->same_name_prev_id != -1) {
+		hfinfo = proto_registrar_get_nth(hfinfo->same_name_prev_id);
+	}
+
+	for (; hfinfo; hfinfo = hfinfo->same_name_next) {
+		if (hfinfo->type != FT_PROTOCOL) {
+			/* A field can be added by a dissector other than the
+			 * one for its protocol, so it doesn't tell us which
+			 * protocols are present. */
+			g_array_set_size(reqs, 0);
+			break;
+		}
+		g_array_append_val(reqs, hfinfo->id);
+		if (reqs->len > 1) {
+			g_array_append_val(reqs, op);
+		}
+	}
+	return reqs;
+}
+
+static GArray *
+proto_reqs_entity(stnode_t *st_arg)
+{
+	switch (stnode_type_id(st_arg)) {
+		case STTYPE_FIELD:
+			return proto_reqs_field((header_field_info*)stnode_data(st_arg));
+		case STTYPE_RANGE:
+			return proto_reqs_entity(sttype_range_entity(st_arg));
+		default:
+			return g_array_new(FALSE, FALSE, sizeof(int));
+	}
+}
+
+static GArray *
+proto_reqs_test(stnode_t *st_node)
+{
+	test_op_t	st_op;
+	stnode_t	*st_arg1, *st_arg2;
+
+	sttype_test_get(st_node, &st_op, &st_arg1, &st_arg2);
+
+	switch (st_op) {
+		case TEST_OP_EXISTS:
+			return proto_reqs_field((header_field_info*)stnode_data(st_arg1));
+
+		case TEST_OP_AND:
+			return proto_reqs_combine(proto_reqs_test(st_arg1),
+				proto_reqs_test(st_arg2), DFW_PROTO_AND);
+
+		case TEST_OP_OR:
+			return proto_reqs_combine(proto_reqs_test(st_arg1),
+				proto_reqs_test(st_arg2), DFW_PROTO_OR);
+
+		case TEST_OP_IN:
+			/* The right hand side is a set of values. */
+			return proto_reqs_entity(st_arg1);
+
+		case TEST_OP_EQ:
+		case TEST_OP_NE:
+		case TEST_OP_GT:
+		case TEST_OP_GE:
+		case TEST_OP_LT:
+		case TEST_OP_LE:
+		case TEST_OP_BITWISE_AND:
+		case TEST_OP_CONTAINS:
+		case TEST_OP_MATCHES:
+			return proto_reqs_combine(proto_reqs_entity(st_arg1),
+				proto_reqs_entity(st_arg2), DFW_PROTO_AND);
+
+		default:
+			return g_array_new(FALSE, FALSE, sizeof(int));
+	}
+}
+
+int*
+dfw_protocol_requirements(dfwork_t *dfw, int *caller_num_reqs)
+{
+	GArray	*reqs = proto_reqs_test(dfw->st_root);
+
+	*caller_num_reqs = reqs->len;
+	if (reqs->len == 0) {
+		g_array_free(reqs, TRUE);
+		return NULL;
+	}
+	return (int *)g_array_free(reqs, FALSE);
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -16,4 +16,10 @@ dfw_gencode(dfwork_t *dfw);
 int*
 dfw_interesting_fields(dfwork_t *dfw, int *caller_num_fields);
 
+#define DFW_PROTO_AND	-1
+#define DFW_PROTO_OR	-2
+
+int*
+dfw_protocol_requirements(dfwork_t *dfw, int *caller_num_reqs);
+
 #endif
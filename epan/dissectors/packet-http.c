@@ -241,6 +241,28 @@ static gboolean http_dechunk_body = TRUE;
  */
 #if defined(HAVE_ZLIB) || defined(HAVE_BROTLI)
 static gboolean http_decompress_body = TRUE;
+
+/*
+ * Decompressed entity bodies, so that clicking on a packet, filtering or
+ * retapping doesn't decompress them again.  The bodies are keyed by frame,
+ * layer and the offset of the body in the message tvb, and the cache
+ * stops growing once it holds HTTP_BODY_CACHE_MAX_BYTES.
+ */
+#define HTTP_BODY_CACHE_MAX_BYTES (64 * 1024 * 1024)
+
+typedef struct {
+	guint32 frame;
+	guint8  layer;
+	gint    offset;
+} http_body_key_t;
+
+typedef struct {
+	guint8 *data;		/* NULL if decompression failed */
+	guint   length;
+} http_body_t;
+
+static wmem_map_t *http_body_cache = NULL;
+static gsize http_body_cache_bytes = 0;
 #endif
 
 /* Simple Service Discovery Protocol
@@ -557,6 +579,9 @@ static const gchar *st_str_resp_300 = "3xx: Redirection";
 static const gchar *st_str_resp_400 = "4xx: Client Error";
 static const gchar *st_str_resp_500 = "5xx: Server Error";
 static const gchar *st_str_other = "Other HTTP Packets";
+static const gchar *st_str_decompressed = "Decompressed Entity Bodies";
+static const gchar *st_str_decompressed_now = "Decompressed";
+static const gchar *st_str_decompressed_cached = "From cache";
 
 static int st_node_packets = -1;
 static int st_node_requests = -1;
@@ -568,6 +593,7 @@ static int st_node_resp_300 = -1;
 static int st_node_resp_400 = -1;
 static int st_node_resp_500 = -1;
 static int st_node_other = -1;
+static int st_node_decompressed = -1;
 
 
 /* HTTP/Packet Counter stats init function */
@@ -584,6 +610,7 @@ http_stats_tree_init(stats_tree* st)
 	st_node_resp_400    = stats_tree_create_node(st, st_str_resp_400,    st_node_responses, STAT_DT_INT, TRUE);
 	st_node_resp_500    = stats_tree_create_node(st, st_str_resp_500,    st_node_responses, STAT_DT_INT, TRUE);
 	st_node_other = stats_tree_create_node(st, st_str_other, st_node_packets, STAT_DT_INT, FALSE);
+	st_node_decompressed = stats_tree_create_node(st, st_str_decompressed, 0, STAT_DT_INT, TRUE);
 }
 
 /* HTTP/Packet Counter stats packet function */
@@ -632,6 +659,13 @@ http_stats_tree_packet(stats_tree* st, packet_info* pinfo _U_, epan_dissect_t* e
 		tick_stat_node(st, st_str_other, st_node_packets, FALSE);
 	}
 
+	if (v->body_decompression != HTTP_BODY_NOT_DECOMPRESSED) {
+		tick_stat_node(st, st_str_decompressed, 0, FALSE);
+		tick_stat_node(st, v->body_decompression == HTTP_BODY_FROM_CACHE ?
+		    st_str_decompressed_cached : st_str_decompressed_now,
+		    st_node_decompressed, FALSE);
+	}
+
 	return TAP_PACKET_REDRAW;
 }
 
@@ -1027,6 +1061,88 @@ static void push_res(http_conv_t *conv_data, packet_info *pinfo)
  */
 static http_info_value_t	*stat_info;
 
+#if defined(HAVE_ZLIB) || defined(HAVE_BROTLI)
+static guint
+http_body_key_hash(gconstpointer k)
+{
+	const http_body_key_t *key = (const http_body_key_t *)k;
+
+	return (key->frame * 31 + key->layer) * 31 + (guint)key->offset;
+}
+
+static gboolean
+http_body_key_equal(gconstpointer k1, gconstpointer k2)
+{
+	const http_body_key_t *key1 = (const http_body_key_t *)k1;
+	const http_body_key_t *key2 = (const http_body_key_t *)k2;
+
+	return key1->frame == key2->frame && key1->layer == key2->layer &&
+	    key1->offset == key2->offset;
+}
+
+static void
+http_body_cache_init(void)
+{
+	http_body_cache_bytes = 0;
+}
+
+/*
+ * Decompress the entity body in body_tvb, which starts at body_offset in the
+ * message tvb, or return it from the cache if it was decompressed before.
+ */
+static tvbuff_t *
+http_uncompress_body(tvbuff_t *tvb, tvbuff_t *body_tvb, int body_offset,
+		     packet_info *pinfo, gboolean brotli,
+		     http_body_decompression_t *decompression)
+{
+	http_body_key_t key;
+	http_body_t *body;
+	tvbuff_t *uncomp_tvb = NULL;
+
+	key.frame = pinfo->num;
+	key.layer = pinfo->curr_layer_num;
+	key.offset = body_offset;
+	body = (http_body_t *)wmem_map_lookup(http_body_cache, &key);
+	if (body != NULL) {
+		*decompression = HTTP_BODY_FROM_CACHE;
+		if (body->data == NULL)
+			return NULL;
+		return tvb_new_child_real_data(tvb, body->data, body->length, body->length);
+	}
+
+	*decompression = HTTP_BODY_DECOMPRESSED;
+#ifdef HAVE_ZLIB
+	if (!brotli)
+		uncomp_tvb = tvb_child_uncompress(tvb, body_tvb, 0,
+		    tvb_captured_length(body_tvb));
+#endif
+#ifdef HAVE_BROTLI
+	if (brotli)
+		uncomp_tvb = tvb_child_uncompress_brotli(tvb, body_tvb, 0,
+		    tvb_captured_length(body_tvb));
+#endif
+
+	if (uncomp_tvb != NULL &&
+	    http_body_cache_bytes + tvb_captured_length(uncomp_tvb) > HTTP_BODY_CACHE_MAX_BYTES) {
+		/* Full; decompress this one again next time */
+		return uncomp_tvb;
+	}
+
+	body = wmem_new(wmem_file_scope(), http_body_t);
+	body->data = NULL;
+	body->length = 0;
+	if (uncomp_tvb != NULL) {
+		body->length = tvb_captured_length(uncomp_tvb);
+		body->data = (guint8 *)tvb_memdup(wmem_file_scope(), uncomp_tvb, 0, body->length);
+		http_body_cache_bytes += body->length;
+	}
+	wmem_map_insert(http_body_cache,
+	    wmem_memdup(wmem_file_scope(), &key, sizeof(key)), body);
+
+	return uncomp_tvb;
+}
+#endif
+
 static int
 dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 		     proto_tree *tree, http_conv_t *conv_data,
@@ -1050,6 +1166,7 @@ dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 	headers_t	headers;
 	int		datalen;
 	int		reported_datalen = -1;
+	int		body_offset;
 	dissector_handle_t handle;
 	gboolean	dissected = FALSE;
 	gboolean	first_loop = TRUE;
@@ -1226,6 +1343,7 @@ dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 	stat_info->full_uri = NULL;
 	stat_info->location_target = NULL;
 	stat_info->location_base_uri = NULL;
+	stat_info->body_decompression = HTTP_BODY_NOT_DECOMPRESSED;
 
 	orig_offset = offset;
 
@@ -1642,6 +1760,7 @@ dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 		 * which, if no content length was specified,
 		 * is -1, i.e. "to the end of the frame.
 		 */
+		body_offset = offset;
 		next_tvb = tvb_new_subset_length_caplen(tvb, offset, datalen,
 		    reported_datalen);
 
@@ -1730,8 +1849,9 @@ dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 			     g_ascii_strcasecmp(headers.content_encoding, "x-gzip") == 0 ||
 			     g_ascii_strcasecmp(headers.content_encoding, "x-deflate") == 0))
 			{
-				uncomp_tvb = tvb_child_uncompress(tvb, next_tvb, 0,
-				    tvb_captured_length(next_tvb));
+				uncomp_tvb = http_uncompress_body(tvb, next_tvb,
+				    body_offset, pinfo, FALSE,
+				    &stat_info->body_decompression);
 			}
 #endif
 
@@ -1739,8 +1859,9 @@ dissect_http_message(tvbuff_t *tvb, int offset, packet_info *pinfo,
 			if (http_decompress_body &&
 			    g_ascii_strcasecmp(headers.content_encoding, "br") == 0)
 			{
-				uncomp_tvb = tvb_child_uncompress_brotli(tvb, next_tvb, 0,
-				    tvb_captured_length(next_tvb));
+				uncomp_tvb = http_uncompress_body(tvb, next_tvb,
+				    body_offset, pinfo, TRUE,
+				    &stat_info->body_decompression);
 			}
 #endif
 
@@ -4163,6 +4284,12 @@ proto_register_http(void)
 	register_follow_stream(proto_http, "http_follow", tcp_follow_conv_filter, tcp_follow_index_filter, tcp_follow_address_filter,
 							tcp_port_to_display, follow_tvb_tap_listener);
 	http_eo_tap = register_export_object(proto_http, http_eo_packet, NULL);
+
+#if defined(HAVE_ZLIB) || defined(HAVE_BROTLI)
+	http_body_cache = wmem_map_new_autoreset(wmem_epan_scope(), wmem_file_scope(),
+	    http_body_key_hash, http_body_key_equal);
+	register_init_routine(http_body_cache_init);
+#endif
 }
 
 /*
@@ -23,6 +23,13 @@ WS_DLL_PUBLIC
 void http_tcp_port_add(guint32 port);
 
 /* Used for HTTP statistics */
+/** How the content-encoded entity body of a message was decoded. */
+typedef enum {
+	HTTP_BODY_NOT_DECOMPRESSED,	/**< not encoded, or not decoded */
+	HTTP_BODY_DECOMPRESSED,		/**< decompressed in this pass */
+	HTTP_BODY_FROM_CACHE		/**< decompressed in an earlier pass */
+} http_body_decompression_t;
+
 typedef struct _http_info_value_t {
 	guint32 framenum;
 	gchar	*request_method;
@@ -33,6 +40,7 @@ typedef struct _http_info_value_t {
 	const gchar   *full_uri;
 	const gchar   *location_base_uri;
 	const gchar   *location_target;
+	http_body_decompression_t body_decompression;
 } http_info_value_t;
 
 /** information about a request and response on a HTTP conversation. */
@@ -23,6 +23,7 @@
 #include <epan/expert.h>
 #include <epan/ip_opts.h>
 #include <epan/prefs.h>
+#include <epan/prefs-int.h>
 #include <epan/conversation_table.h>
 #include <epan/dissector_filters.h>
 #include <epan/reassemble.h>
@@ -2956,6 +2957,8 @@ proto_register_ip(void)
     "Show IPv4 summary in protocol tree",
     "Whether the IPv4 summary line should be shown in the protocol tree",
     &ip_summary_in_tree);
+  /* Only changes the text of the IPv4 item, so don't redissect */
+  prefs_set_effect_flags_by_name(ip_module, "summary_in_tree", PREF_EFFECT_GUI);
   prefs_register_bool_preference(ip_module, "check_checksum",
   "Validate the IPv4 checksum if possible",
   "Whether to validate the IPv4 checksum", &ip_check_checksum);
@@ -215,6 +215,13 @@ static extra_esp_sa_records_t extra_esp_sa_records;
 static uat_t * esp_uat = NULL;
 static guint num_sa_uat = 0;
 
+/* Index of the UAT records by SPI, rebuilt whenever the table changes.
+   Records with a literal SPI are listed under it in esp_sa_spi_index,
+   the ones with wildcards in esp_sa_spi_wildcards; both hold record
+   numbers in table order, so the first matching record still wins. */
+static GHashTable *esp_sa_spi_index = NULL;
+static GArray *esp_sa_spi_wildcards = NULL;
+
 /*
    Name : static gint compute_ascii_key(gchar **ascii_key, gchar *key)
    Description : Allocate memory for the key and transform the key if it is hexadecimal
@@ -365,6 +372,53 @@ static void* uat_esp_sa_record_copy_cb(void* n, const void* o, size_t siz _U_) {
   return new_rec;
 }
 
+static void uat_esp_sa_index_free(gpointer data) {
+  g_array_free((GArray *)data, TRUE);
+}
+
+static void uat_esp_sa_reset_cb(void) {
+  if (esp_sa_spi_index) {
+    g_hash_table_destroy(esp_sa_spi_index);
+    esp_sa_spi_index = NULL;
+  }
+  if (esp_sa_spi_wildcards) {
+    g_array_free(esp_sa_spi_wildcards, TRUE);
+    esp_sa_spi_wildcards = NULL;
+  }
+}
+
+static void uat_esp_sa_post_update_cb(void) {
+  guint i;
+
+  uat_esp_sa_reset_cb();
+  esp_sa_spi_index = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, uat_esp_sa_index_free);
+  esp_sa_spi_wildcards = g_array_new(FALSE, FALSE, sizeof(guint));
+
+  for (i = 0; i < num_sa_uat; i++) {
+    const gchar *filter = uat_esp_sa_records[i].spi;
+    gulong spi;
+    GArray *records;
+
+    if (!filter || strchr(filter, IPSEC_SA_WILDCARDS_ANY) != NULL) {
+      g_array_append_val(esp_sa_spi_wildcards, i);
+      continue;
+    }
+
+    /* Same conversion as filter_spi_match() */
+    spi = strtoul(filter, NULL, 0);
+    if (spi > G_MAXUINT32) {
+      /* Can't match any SPI */
+      continue;
+    }
+    records = (GArray *)g_hash_table_lookup(esp_sa_spi_index, GUINT_TO_POINTER((guint)spi));
+    if (!records) {
+      records = g_array_new(FALSE, FALSE, sizeof(guint));
+      g_hash_table_insert(esp_sa_spi_index, GUINT_TO_POINTER((guint)spi), records);
+    }
+    g_array_append_val(records, i);
+  }
+}
+
 static void uat_esp_sa_record_free_cb(void*r) {
   uat_esp_sa_record_t* rec = (uat_esp_sa_record_t*)r;
 
@@ -1031,13 +1085,18 @@ get_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi,
   )
 {
   gboolean found = FALSE;
-  guint i, j;
+  guint e = 0, w = 0, j = 0;
+  GArray *exact = NULL;
 
   *cipher_hd = NULL;
   *cipher_hd_created = NULL;
 
-  /* Check each known SA in turn */
-  for (i = 0, j=0; (found == FALSE) && ((i < num_sa_uat) || (j < extra_esp_sa_records.num_records)); )
+  if (esp_sa_spi_index) {
+    exact = (GArray *)g_hash_table_lookup(esp_sa_spi_index, GUINT_TO_POINTER(spi));
+  }
+
+  /* Check each candidate SA in turn */
+  while (found == FALSE)
   {
     /* Get the next record to try */
     uat_esp_sa_record_t *record;
@@ -1046,8 +1105,25 @@ get_esp_sa(gint protocol_typ, gchar *src,  gchar *dst,  guint spi,
       record = &extra_esp_sa_records.records[j++];
     }
     else {
-      /* Then UAT ones */
-      record = &uat_esp_sa_records[i++];
+      /* Then UAT ones with this SPI or a wildcard SPI, in table order */
+      guint exact_i = (exact && e < exact->len) ? g_array_index(exact, guint, e) : G_MAXUINT;
+      guint wild_i = (esp_sa_spi_wildcards && w < esp_sa_spi_wildcards->len) ?
+                     g_array_index(esp_sa_spi_wildcards, guint, w) : G_MAXUINT;
+      guint i;
+
+      if (exact_i == G_MAXUINT && wild_i == G_MAXUINT)
+        break;
+
+      if (exact_i < wild_i) {
+        i = exact_i;
+        e++;
+      } else {
+        i = wild_i;
+        w++;
+      }
+      if (i >= num_sa_uat)
+        continue;
+      record = &uat_esp_sa_records[i];
     }
 
     if((protocol_typ == record->protocol)
@@ -2443,8 +2519,8 @@ proto_register_ipsec(void)
             uat_esp_sa_record_copy_cb,      /* copy callback */
             uat_esp_sa_record_update_cb,    /* update callback */
             uat_esp_sa_record_free_cb,      /* free callback */
-            NULL,                           /* post update callback */
-            NULL,                           /* reset callback */
+            uat_esp_sa_post_update_cb,      /* post update callback */
+            uat_esp_sa_reset_cb,            /* reset callback */
             esp_uat_flds);                  /* UAT field definitions */
 
   prefs_register_uat_preference(esp_module,
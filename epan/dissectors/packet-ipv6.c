@@ -22,6 +22,7 @@
 #include <epan/addr_resolv.h>
 #include <epan/maxmind_db.h>
 #include <epan/prefs.h>
+#include <epan/prefs-int.h>
 #include <epan/conversation_table.h>
 #include <epan/dissector_filters.h>
 #include <epan/reassemble.h>
@@ -3587,6 +3588,8 @@ proto_register_ipv6(void)
                                    "Show IPv6 summary in protocol tree",
                                    "Whether the IPv6 summary line should be shown in the protocol tree",
                                    &ipv6_summary_in_tree);
+    /* Only changes the text of the IPv6 item, so don't redissect */
+    prefs_set_effect_flags_by_name(ipv6_module, "summary_in_tree", PREF_EFFECT_GUI);
     prefs_register_bool_preference(ipv6_module, "use_geoip" ,
                                    "Enable IPv6 geolocation",
                                    "Whether to look up IPv6 addresses in each MaxMind database we have loaded",
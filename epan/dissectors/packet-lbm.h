@@ -223,6 +223,7 @@ typedef struct
 typedef struct
 {
     gchar * transport;
+    guint64 channel;
     guint8 type;
     gboolean retransmission;
     guint32 sqn;
@@ -234,6 +235,7 @@ typedef struct
 typedef struct
 {
     gchar * transport;
+    guint64 channel;
     guint8 type;
     gboolean retransmission;
     guint32 sqn;
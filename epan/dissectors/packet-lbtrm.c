@@ -1198,6 +1198,7 @@ static int dissect_lbtrm(tvbuff_t * tvb, packet_info * pinfo, proto_tree * tree,
     if (transport != NULL)
     {
         tapinfo->transport = lbtrm_transport_source_string_transport(transport);
+        tapinfo->channel = transport->channel;
     }
     tapinfo->type = packet_type;
 
@@ -1432,6 +1432,7 @@ static int dissect_lbtru(tvbuff_t * tvb, packet_info * pinfo, proto_tree * tree,
             client = lbtru_client_transport_find(transport, &receiver_address, receiver_port, pinfo->num);
         }
         tapinfo->transport = lbtru_transport_source_string_transport(transport);
+        tapinfo->channel = transport->channel;
         channel = transport->channel;
         fld_item = proto_tree_add_uint64(channel_tree, hf_lbtru_channel_id, tvb, 0, 0, channel);
         proto_item_set_generated(fld_item);
@@ -289,8 +289,6 @@ dissect_per_length_determinant(tvbuff_t *tvb, guint32 offset, asn1_ctx_t *actx _
 	guint32 len;
 	proto_item *pi;
 	int num_bits;
-	int i, bit, str_length, str_index;
-	gboolean tmp;
 
 	if(!length){
 		length=&len;
@@ -308,53 +306,30 @@ dissect_per_length_determinant(tvbuff_t *tvb, guint32 offset, asn1_ctx_t *actx _
 		char *str;
 		guint32 val;
 
-		val = 0;
-
-		/* prepare the string (max number of bits + quartet separators + prepended space) */
-		str_length = 256+64+1;
-		str=(char *)wmem_alloc(wmem_packet_scope(), str_length+1);
-		str_index = 0;
-
-		str_length = g_snprintf(str, str_length+1, " ");
-		for(bit=0;bit<((int)(offset&0x07));bit++){
-			if(bit&&(!(bit%4))){
-				if (str_index < str_length) str[str_index++] = ' ';
+		/* The first two bits tell how long the length is:
+		 * 0x = 8 bits, 10 = 16 bits, 11 = fragmented (or unconstrained) */
+		val = tvb_get_bits8(tvb, offset, 2);
+		if (val == 3) {
+			if (!is_fragmented) {
+				*length = 0;
+				dissect_per_not_decoded_yet(tree, actx->pinfo, tvb, "10.9 Unconstrained");
+				return offset + 2;
 			}
-			if (str_index < str_length) str[str_index++] = '.';
+			num_bits = 8;
+			*is_fragmented = TRUE;
+		} else {
+			num_bits = (val & 2) ? 16 : 8;
 		}
-		/* read the bits for the int */
-		num_bits = 8;
-		for(i=0;i<num_bits;i++){
-			if(bit&&(!(bit%4))){
-				if (str_index < str_length) str[str_index++] = ' ';
-			}
-			if(bit&&(!(bit%8))){
-				if (str_index < str_length) str[str_index++] = ' ';
-			}
-			bit++;
-			offset=dissect_per_boolean(tvb, offset, actx, tree, -1, &tmp);
-			val<<=1;
-			if(tmp){
-				val|=1;
-				if (str_index < str_length) str[str_index++] = '1';
-				if (i==0) { /* bit 8 is 1, so not a single byte length */
-					num_bits = 16;
-				}
-				else if (i==1 && val==3) { /* bits 8 and 7 both 1, so unconstrained */
-					if (!is_fragmented) {
-						*length = 0;
-						dissect_per_not_decoded_yet(tree, actx->pinfo, tvb, "10.9 Unconstrained");
-						return offset;
-					} else {
-						num_bits = 8;
-						*is_fragmented = TRUE;
-					}
-				}
-			} else {
-				if (str_index < str_length) str[str_index++] = '0';
-			}
+		val = (guint32)tvb_get_bits(tvb, offset, num_bits, ENC_BIG_ENDIAN);
+
+		/* Only build the bit string when it is going to be shown */
+		if (display_internal_per_fields && hf_index != -1) {
+			str = decode_bits_in_field(offset & 0x07, num_bits, val);
+		} else {
+			str = NULL;
 		}
-		str[str_index] = '\0'; /* Terminate string */
+		offset += num_bits;
+
 		if(is_fragmented && *is_fragmented==TRUE){
 			*length = val&0x3f;
 			if (*length>4 || *length==0) {
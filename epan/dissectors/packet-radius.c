@@ -2850,6 +2850,15 @@ proto_register_radius(void)
 	prefs_register_obsolete_preference(radius_module, "request_ttl");
 
 	radius_tap = register_tap("radius");
+
+	/*
+	 * Delay loading the dictionaries and registering the fields they
+	 * define until a "radius." field is looked up, e.g. by a filter,
+	 * or the first RADIUS packet is dissected (see the hf_radius_code
+	 * checks in the dissectors).  Startup stays cheap for captures
+	 * without RADIUS traffic, so the parsed dictionaries aren't cached
+	 * on disk.
+	 */
 	proto_register_prefix("radius", register_radius_fields);
 
 	dict = (radius_dictionary_t *)g_malloc(sizeof(radius_dictionary_t));
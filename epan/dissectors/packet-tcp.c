@@ -20,6 +20,7 @@
 #include <epan/ip_opts.h>
 #include <epan/follow.h>
 #include <epan/prefs.h>
+#include <epan/prefs-int.h>
 #include <epan/show_exception.h>
 #include <epan/conversation_table.h>
 #include <epan/dissector_filters.h>
@@ -589,6 +590,26 @@ static guint32 mptcp_stream_count;
  */
 static wmem_tree_t *mptcp_tokens = NULL;
 
+/*
+ * Sequence analysis results, one slot per frame number, allocated in
+ * chunks as frames that need them are seen. This is much smaller than
+ * keeping them in a tree keyed by frame number. The acked_table of a
+ * conversation only holds the results of frames that carry more than
+ * one analysed TCP header (e.g. tunnelled TCP).
+ */
+#define TCP_ACKED_CHUNK_SHIFT   12
+#define TCP_ACKED_CHUNK_SIZE    (1 << TCP_ACKED_CHUNK_SHIFT)
+
+typedef struct {
+    struct tcp_analysis *tcpd;  /* NULL if the slot is free */
+    guint32 seq;
+    guint32 ack;
+    struct tcp_acked ta;
+} tcp_acked_slot_t;
+
+static tcp_acked_slot_t **tcp_acked_chunks = NULL;
+static guint tcp_acked_num_chunks = 0;
+
 static const int *tcp_option_mptcp_capable_flags[] = {
   &hf_tcp_option_mptcp_checksum_flag,
   &hf_tcp_option_mptcp_B_flag,
@@ -1798,6 +1819,36 @@ pdu_store_window_scale_option(guint8 ws, struct tcp_analysis *tcpd)
         tcpd->fwd->win_scale=ws;
 }
 
+/* Returns the slot of a frame in tcp_acked_chunks, or NULL if there is
+ * none and createflag is not set.
+ */
+static tcp_acked_slot_t *
+tcp_acked_slot(guint32 frame, gboolean createflag)
+{
+    guint chunk = frame >> TCP_ACKED_CHUNK_SHIFT;
+
+    if (chunk >= tcp_acked_num_chunks) {
+        guint num_chunks;
+
+        if (!createflag) {
+            return NULL;
+        }
+        num_chunks = MAX(chunk + 1, tcp_acked_num_chunks * 2);
+        tcp_acked_chunks = (tcp_acked_slot_t **)wmem_realloc(wmem_file_scope(), tcp_acked_chunks,
+                num_chunks * sizeof(tcp_acked_slot_t *));
+        memset(tcp_acked_chunks + tcp_acked_num_chunks, 0,
+                (num_chunks - tcp_acked_num_chunks) * sizeof(tcp_acked_slot_t *));
+        tcp_acked_num_chunks = num_chunks;
+    }
+    if (!tcp_acked_chunks[chunk]) {
+        if (!createflag) {
+            return NULL;
+        }
+        tcp_acked_chunks[chunk] = wmem_alloc0_array(wmem_file_scope(), tcp_acked_slot_t, TCP_ACKED_CHUNK_SIZE);
+    }
+    return &tcp_acked_chunks[chunk][frame & (TCP_ACKED_CHUNK_SIZE - 1)];
+}
+
 /* when this function returns, it will (if createflag) populate the ta pointer.
  */
 static void
@@ -1805,6 +1856,7 @@ tcp_analyze_get_acked_struct(guint32 frame, guint32 seq, guint32 ack, gboolean c
 {
 
     wmem_tree_key_t key[4];
+    tcp_acked_slot_t *slot;
 
     key[0].length = 1;
     key[0].key = &frame;
@@ -1822,6 +1874,22 @@ tcp_analyze_get_acked_struct(guint32 frame, guint32 seq, guint32 ack, gboolean c
         return;
     }
 
+    /* The first TCP header of a frame takes its slot */
+    slot = tcp_acked_slot(frame, createflag);
+    if (slot) {
+        if (slot->tcpd == tcpd && slot->seq == seq && slot->ack == ack) {
+            tcpd->ta = &slot->ta;
+            return;
+        }
+        if (!slot->tcpd && createflag) {
+            slot->tcpd = tcpd;
+            slot->seq = seq;
+            slot->ack = ack;
+            tcpd->ta = &slot->ta;
+            return;
+        }
+    }
+
     tcpd->ta = (struct tcp_acked *)wmem_tree_lookup32_array(tcpd->acked_table, key);
     if((!tcpd->ta) && createflag) {
         tcpd->ta = wmem_new0(wmem_file_scope(), struct tcp_acked);
@@ -6772,6 +6840,10 @@ tcp_init(void)
 {
     tcp_stream_count = 0;
 
+    /* The chunks were in the previous file scope */
+    tcp_acked_chunks = NULL;
+    tcp_acked_num_chunks = 0;
+
     /* MPTCP init */
     mptcp_stream_count = 0;
     mptcp_tokens = wmem_tree_new(wmem_file_scope());
@@ -7725,6 +7797,8 @@ proto_register_tcp(void)
         "Show TCP summary in protocol tree",
         "Whether the TCP summary line should be shown in the protocol tree",
         &tcp_summary_in_tree);
+    /* Only changes the text of the TCP item, so don't redissect */
+    prefs_set_effect_flags_by_name(tcp_module, "summary_in_tree", PREF_EFFECT_GUI);
     prefs_register_bool_preference(tcp_module, "check_checksum",
         "Validate the TCP checksum if possible",
         "Whether to validate the TCP checksum or not.  "
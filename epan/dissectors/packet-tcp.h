@@ -150,18 +150,19 @@ typedef struct _tcp_unacked_t {
 	nstime_t ts;
 } tcp_unacked_t;
 
+/* One of these is kept for most TCP frames, so the members are ordered
+ * to avoid padding. */
 struct tcp_acked {
-	guint32 frame_acked;
 	nstime_t ts;
-
-	guint32  rto_frame;
 	nstime_t rto_ts;	/* Time since previous packet for
 				   retransmissions. */
-	guint16 flags; /* see TCP_A_* in packet-tcp.c */
+	guint32 frame_acked;
+	guint32  rto_frame;
 	guint32 dupack_num;	/* dup ack number */
 	guint32 dupack_frame;	/* dup ack to frame # */
 	guint32 bytes_in_flight; /* number of bytes in flight */
 	guint32 push_bytes_sent; /* bytes since the last PSH flag */
+	guint16 flags; /* see TCP_A_* in packet-tcp.c */
 };
 
 /* One instance of this structure is created for each pdu that spans across
@@ -407,8 +408,10 @@ struct tcp_analysis {
 	 * similar
 	 */
 	struct tcp_acked *ta;
-	/* This structure contains a tree containing all the various ta's
-	 * keyed by frame number.
+	/* The ta's of most frames are kept in a table indexed by frame
+	 * number, shared by all conversations. This tree, keyed by frame
+	 * number, sequence number and acknowledgement number, holds those of
+	 * frames that carry more than one analysed TCP header.
 	 */
 	wmem_tree_t	*acked_table;
 
@@ -2968,6 +2968,9 @@ ssl_decoder_destroy_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U
     if (dec->evp)
         ssl_cipher_cleanup(&dec->evp);
 
+    if (dec->mac_hd)
+        ssl_hmac_cleanup(&dec->mac_hd);
+
 #ifdef HAVE_ZLIB
     if (dec->decomp != NULL && dec->decomp->compression == 1 /* DEFLATE */)
         inflateEnd(&dec->decomp->istream);
@@ -3672,21 +3675,42 @@ ssl_decrypt_pre_master_secret(SslDecryptSession *ssl_session,
 
 /* Decryption integrity check {{{ */
 
+/* Returns the HMAC of the decoder, keyed and ready for a new record.
+ * The handle is kept for the lifetime of the decoder so that the key
+ * is not set up again for every record; resetting an HMAC handle
+ * keeps its key. */
+static SSL_HMAC *
+ssl_decoder_hmac(SslDecoder *decoder)
+{
+    gint md;
+
+    if (decoder->mac_hd) {
+        gcry_md_reset(decoder->mac_hd);
+        return &decoder->mac_hd;
+    }
+
+    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
+    ssl_debug_printf("ssl_decoder_hmac mac type:%s md %d\n",
+        ssl_cipher_suite_dig(decoder->cipher_suite)->name, md);
+
+    if (ssl_hmac_init(&decoder->mac_hd,decoder->mac_key.data,decoder->mac_key.data_len,md) != 0) {
+        decoder->mac_hd = NULL;
+        return NULL;
+    }
+    return &decoder->mac_hd;
+}
+
 static gint
 tls_check_mac(SslDecoder*decoder, gint ct, gint ver, guint8* data,
         guint32 datalen, guint8* mac)
 {
-    SSL_HMAC hm;
-    gint     md;
+    SSL_HMAC *hm;
     guint32  len;
     guint8   buf[DIGEST_MAX_SIZE];
     gint16   temp;
 
-    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
-    ssl_debug_printf("tls_check_mac mac type:%s md %d\n",
-        ssl_cipher_suite_dig(decoder->cipher_suite)->name, md);
-
-    if (ssl_hmac_init(&hm,decoder->mac_key.data,decoder->mac_key.data_len,md) != 0)
+    hm = ssl_decoder_hmac(decoder);
+    if (!hm)
         return -1;
 
     /* hash sequence number */
@@ -3694,28 +3718,27 @@ tls_check_mac(SslDecoder*decoder, gint ct, gint ver, guint8* data,
 
     decoder->seq++;
 
-    ssl_hmac_update(&hm,buf,8);
+    ssl_hmac_update(hm,buf,8);
 
     /* hash content type */
     buf[0]=ct;
-    ssl_hmac_update(&hm,buf,1);
+    ssl_hmac_update(hm,buf,1);
 
     /* hash version,data length and data*/
     /* *((gint16*)buf) = g_htons(ver); */
     temp = g_htons(ver);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
+    ssl_hmac_update(hm,buf,2);
 
     /* *((gint16*)buf) = g_htons(datalen); */
     temp = g_htons(datalen);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
-    ssl_hmac_update(&hm,data,datalen);
+    ssl_hmac_update(hm,buf,2);
+    ssl_hmac_update(hm,data,datalen);
 
     /* get digest and digest len*/
     len = sizeof(buf);
-    ssl_hmac_final(&hm,buf,&len);
-    ssl_hmac_cleanup(&hm);
+    ssl_hmac_final(hm,buf,&len);
     ssl_print_data("Mac", buf, len);
     if(memcmp(mac,buf,len))
         return -1;
@@ -3791,17 +3814,13 @@ static gint
 dtls_check_mac(SslDecoder*decoder, gint ct,int ver, guint8* data,
         guint32 datalen, guint8* mac)
 {
-    SSL_HMAC hm;
-    gint     md;
+    SSL_HMAC *hm;
     guint32  len;
     guint8   buf[DIGEST_MAX_SIZE];
     gint16   temp;
 
-    md=ssl_get_digest_by_name(ssl_cipher_suite_dig(decoder->cipher_suite)->name);
-    ssl_debug_printf("dtls_check_mac mac type:%s md %d\n",
-        ssl_cipher_suite_dig(decoder->cipher_suite)->name, md);
-
-    if (ssl_hmac_init(&hm,decoder->mac_key.data,decoder->mac_key.data_len,md) != 0)
+    hm = ssl_decoder_hmac(decoder);
+    if (!hm)
         return -1;
     ssl_debug_printf("dtls_check_mac seq: %" G_GUINT64_FORMAT " epoch: %d\n",decoder->seq,decoder->epoch);
     /* hash sequence number */
@@ -3809,25 +3828,24 @@ dtls_check_mac(SslDecoder*decoder, gint ct,int ver, guint8* data,
     buf[0]=decoder->epoch>>8;
     buf[1]=(guint8)decoder->epoch;
 
-    ssl_hmac_update(&hm,buf,8);
+    ssl_hmac_update(hm,buf,8);
 
     /* hash content type */
     buf[0]=ct;
-    ssl_hmac_update(&hm,buf,1);
+    ssl_hmac_update(hm,buf,1);
 
     /* hash version,data length and data */
     temp = g_htons(ver);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
+    ssl_hmac_update(hm,buf,2);
 
     temp = g_htons(datalen);
     memcpy(buf, &temp, 2);
-    ssl_hmac_update(&hm,buf,2);
-    ssl_hmac_update(&hm,data,datalen);
+    ssl_hmac_update(hm,buf,2);
+    ssl_hmac_update(hm,data,datalen);
     /* get digest and digest len */
     len = sizeof(buf);
-    ssl_hmac_final(&hm,buf,&len);
-    ssl_hmac_cleanup(&hm);
+    ssl_hmac_final(hm,buf,&len);
     ssl_print_data("Mac", buf, len);
     if(memcmp(mac,buf,len))
         return -1;
@@ -5344,28 +5362,56 @@ ssl_load_keyfile(const gchar *tls_keylog_filename, FILE **keylog_file,
     }
 
     if (*keylog_file == NULL) {
-        *keylog_file = ws_fopen(tls_keylog_filename, "r");
+        /* Binary, so that fseek() can step back over a line; CRs are dropped when parsing. */
+        *keylog_file = ws_fopen(tls_keylog_filename, "rb");
         if (!*keylog_file) {
             ssl_debug_printf("%s failed to open SSL keylog\n", G_STRFUNC);
             return;
         }
     }
 
+    /*
+     * Read from where the previous call stopped, a block at a time, and
+     * parse all complete lines in a block at once. A line that is still
+     * being written when we reach the end of the file is parsed as it
+     * is, in case the file simply doesn't end with a newline, and read
+     * again on the next call, so that it is replaced once it is complete.
+     */
+    char buf[8192];
+    size_t used = 0;
     for (;;) {
-        char buf[512], *line;
-        line = fgets(buf, sizeof(buf), *keylog_file);
-        if (!line) {
-            if (feof(*keylog_file)) {
-                /* Ensure that newly appended keys can be read in the future. */
-                clearerr(*keylog_file);
-            } else if (ferror(*keylog_file)) {
+        size_t nread = fread(buf + used, 1, sizeof(buf) - used, *keylog_file);
+        size_t parsed;
+
+        if (nread == 0) {
+            if (ferror(*keylog_file)) {
                 ssl_debug_printf("%s Error while reading key log file, closing it!\n", G_STRFUNC);
                 fclose(*keylog_file);
                 *keylog_file = NULL;
+                break;
             }
+            if (used > 0) {
+                tls_keylog_process_lines(mk_map, (guint8 *)buf, (guint)used);
+                if (fseek(*keylog_file, -(long)used, SEEK_CUR) != 0) {
+                    ssl_debug_printf("%s cannot go back to the incomplete last line\n", G_STRFUNC);
+                }
+            }
+            /* Ensure that newly appended keys can be read in the future. */
+            clearerr(*keylog_file);
             break;
         }
-        tls_keylog_process_lines(mk_map, (guint8 *)line, (int)strlen(line));
+        used += nread;
+
+        /* Everything up to the last newline; lines longer than the buffer are cut. */
+        for (parsed = used; parsed > 0 && buf[parsed - 1] != '\n'; parsed--)
+            ;
+        if (parsed == 0 && used == sizeof(buf))
+            parsed = used;
+        if (parsed > 0) {
+            tls_keylog_process_lines(mk_map, (guint8 *)buf, (guint)parsed);
+            memmove(buf, buf + parsed, used - parsed);
+            used -= parsed;
+        }
     }
 }
 /** SSL keylog file handling. }}} */
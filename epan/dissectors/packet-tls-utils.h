@@ -301,6 +301,7 @@ typedef struct _SslDecoder {
     StringInfo mac_key; /* for block and stream ciphers */
     StringInfo write_iv; /* for AEAD ciphers (at least GCM, CCM) */
     SSL_CIPHER_CTX evp;
+    gcry_md_hd_t mac_hd;    /**< HMAC keyed with mac_key, opened on first use. */
     SslDecompress *decomp;
     guint64 seq;    /**< Implicit (TLS) or explicit (DTLS) record sequence number. */
     guint16 epoch;
@@ -22,6 +22,7 @@
 #include <epan/ipproto.h>
 #include <epan/in_cksum.h>
 #include <epan/prefs.h>
+#include <epan/prefs-int.h>
 #include <epan/follow.h>
 #include <epan/expert.h>
 #include <epan/exceptions.h>
@@ -590,6 +591,22 @@ handle_export_pdu_conversation(packet_info *pinfo, tvbuff_t *tvb, int uh_dport,
   }
 }
 
+/*
+ * Returns the conversation data of the current packet if it has any, so that
+ * the heuristic that accepted an earlier packet of the conversation, which
+ * most likely accepts this one too, can be tried first.
+ */
+static struct udp_analysis *
+get_udp_heur_conversation_data(packet_info *pinfo)
+{
+  conversation_t *conv = find_conversation_pinfo(pinfo, 0);
+
+  if (!conv)
+    return NULL;
+
+  return (struct udp_analysis *)conversation_get_proto_data(conv, hfi_udp->id);
+}
+
 void
 decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
                  proto_tree *tree, int uh_sport, int uh_dport, int uh_ulen)
@@ -602,6 +619,7 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
   guint8 curr_layer_num = pinfo->curr_layer_num;
   heur_dtbl_entry_t *hdtbl_entry;
   exp_pdu_data_t *exp_pdu_data;
+  struct udp_analysis *udpd;
 
   /* populate per packet data variable */
   udp_p_info = (udp_p_info_t*)p_get_proto_data(wmem_file_scope(), pinfo, hfi_udp->id, pinfo->curr_layer_num);
@@ -645,7 +663,11 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
 
   if (try_heuristic_first) {
     /* Do lookup with the heuristic subdissector table */
-    if (dissector_try_heuristic(heur_subdissector_list, next_tvb, pinfo, tree, &hdtbl_entry, NULL)) {
+    udpd = get_udp_heur_conversation_data(pinfo);
+    if (dissector_try_heuristic_hinted(heur_subdissector_list, next_tvb, pinfo, tree,
+                                       udpd ? udpd->heur_dtbl_entry : NULL, &hdtbl_entry, NULL)) {
+      if (udpd)
+        udpd->heur_dtbl_entry = hdtbl_entry;
       if (!udp_p_info) {
         udp_p_info = wmem_new0(wmem_file_scope(), udp_p_info_t);
         p_add_proto_data(wmem_file_scope(), pinfo, hfi_udp->id, curr_layer_num, udp_p_info);
@@ -694,7 +716,11 @@ decode_udp_ports(tvbuff_t *tvb, int offset, packet_info *pinfo,
 
   if (!try_heuristic_first) {
     /* Do lookup with the heuristic subdissector table */
-    if (dissector_try_heuristic(heur_subdissector_list, next_tvb, pinfo, tree, &hdtbl_entry, NULL)) {
+    udpd = get_udp_heur_conversation_data(pinfo);
+    if (dissector_try_heuristic_hinted(heur_subdissector_list, next_tvb, pinfo, tree,
+                                       udpd ? udpd->heur_dtbl_entry : NULL, &hdtbl_entry, NULL)) {
+      if (udpd)
+        udpd->heur_dtbl_entry = hdtbl_entry;
       if (!udp_p_info) {
         udp_p_info = wmem_new0(wmem_file_scope(), udp_p_info_t);
         p_add_proto_data(wmem_file_scope(), pinfo, hfi_udp->id, curr_layer_num, udp_p_info);
@@ -1331,6 +1357,8 @@ proto_register_udp(void)
                                  "Show UDP summary in protocol tree",
                                  "Whether the UDP summary line should be shown in the protocol tree",
                                  &udp_summary_in_tree);
+  /* Only changes the text of the UDP item, so don't redissect */
+  prefs_set_effect_flags_by_name(udp_module, "summary_in_tree", PREF_EFFECT_GUI);
   prefs_register_bool_preference(udp_module, "try_heuristic_first",
                                  "Try heuristic sub-dissectors first",
                                  "Try to decode a packet using an heuristic sub-dissector"
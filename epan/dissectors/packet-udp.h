@@ -81,6 +81,11 @@ struct udp_analysis {
 	 * to previous frame in this conversation
 	 */
 	nstime_t	ts_prev;
+
+	/* The heuristic sub-dissector that accepted the last packet of
+	 * this conversation, tried first for the next unclaimed one.
+	 */
+	heur_dtbl_entry_t	*heur_dtbl_entry;
 };
 
 /** Associate process information with a given flow
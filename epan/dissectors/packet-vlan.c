@@ -21,6 +21,7 @@
 #include "packet-llc.h"
 #include <epan/etypes.h>
 #include <epan/prefs.h>
+#include <epan/prefs-int.h>
 #include <epan/to_str.h>
 #include <epan/addr_resolv.h>
 #include <epan/proto_data.h>
@@ -422,6 +423,8 @@ proto_register_vlan(void)
         "Show vlan summary in protocol tree",
         "Whether the vlan summary line should be shown in the protocol tree",
         &vlan_summary_in_tree);
+  /* Only changes the text of the VLAN item, so don't redissect */
+  prefs_set_effect_flags_by_name(vlan_module, "summary_in_tree", PREF_EFFECT_GUI);
   prefs_register_uint_preference(vlan_module, "qinq_ethertype",
         "802.1QinQ Ethertype (in hex)",
         "The (hexadecimal) Ethertype used to indicate 802.1QinQ VLAN in VLAN tunneling.",
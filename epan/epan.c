@@ -31,6 +31,7 @@
 #include "epan_dissect.h"
 
 #include <wsutil/nstime.h>
+#include <wsutil/startup_timings.h>
 
 #include "conversation.h"
 #include "except.h"
@@ -41,6 +42,7 @@
 #include "addr_resolv.h"
 #include "oids.h"
 #include "wmem/wmem.h"
+#include "app_mem_usage.h"
 #include "expert.h"
 #include "print.h"
 #include "capture_dissectors.h"
@@ -180,10 +182,50 @@ void epan_register_plugin(const epan_plugin *plug)
 }
 #endif
 
+/*
+ * Memory requested from the wmem scopes, for memory_usage_get().
+ * The packet scope is emptied after every packet, so its peak is
+ * more telling than its current size.
+ */
+static gsize
+wmem_packet_scope_peak(void)
+{
+	wmem_allocator_stats_t stats;
+
+	wmem_get_stats(wmem_packet_scope(), &stats);
+	return (gsize)stats.peak_bytes;
+}
+
+static gsize
+wmem_file_scope_bytes(void)
+{
+	wmem_allocator_stats_t stats;
+
+	wmem_get_stats(wmem_file_scope(), &stats);
+	return (gsize)stats.bytes;
+}
+
+static gsize
+wmem_epan_scope_bytes(void)
+{
+	wmem_allocator_stats_t stats;
+
+	wmem_get_stats(wmem_epan_scope(), &stats);
+	return (gsize)stats.bytes;
+}
+
+static const ws_mem_usage_t wmem_packet_scope_usage = { "Packet scope (peak)", wmem_packet_scope_peak, NULL };
+static const ws_mem_usage_t wmem_file_scope_usage = { "File scope", wmem_file_scope_bytes, NULL };
+static const ws_mem_usage_t wmem_epan_scope_usage = { "Epan scope", wmem_epan_scope_bytes, NULL };
+
 gboolean
 epan_init(register_cb cb, gpointer client_data, gboolean load_plugins)
 {
 	volatile gboolean status = TRUE;
+	gint64 start = g_get_monotonic_time();
+#ifdef HAVE_LUA
+	gint64 lua_start;
+#endif
 
 	/*
 	 * proto_init -> register_all_protocols -> g_async_queue_new which
@@ -194,6 +236,9 @@ epan_init(register_cb cb, gpointer client_data, gboolean load_plugins)
 	 */
 	/* initialize memory allocation subsystem */
 	wmem_init();
+	memory_usage_component_register(&wmem_packet_scope_usage);
+	memory_usage_component_register(&wmem_file_scope_usage);
+	memory_usage_component_register(&wmem_epan_scope_usage);
 
 	/* initialize the GUID to name mapping table */
 	guids_init();
@@ -249,7 +294,9 @@ epan_init(register_cb cb, gpointer client_data, gboolean load_plugins)
 		expert_packet_init();
 		export_pdu_init();
 #ifdef HAVE_LUA
+		lua_start = g_get_monotonic_time();
 		wslua_init(cb, client_data);
+		startup_timing_record("lua_plugins", NULL, g_get_monotonic_time() - lua_start);
 #endif
 	}
 	CATCH(DissectorError) {
@@ -271,6 +318,7 @@ epan_init(register_cb cb, gpointer client_data, gboolean load_plugins)
 		status = FALSE;
 	}
 	ENDTRY;
+	startup_timing_record("epan_init", NULL, g_get_monotonic_time() - start);
 	return status;
 }
 
@@ -281,18 +329,26 @@ e_prefs *
 epan_load_settings(void)
 {
 	e_prefs *prefs_p;
+	gint64 start = g_get_monotonic_time();
+	gint64 step = start;
 
 	/* load the decode as entries of the current profile */
 	load_decode_as_entries();
+	startup_timing_record("settings", "decode_as_entries", g_get_monotonic_time() - step);
 
+	step = g_get_monotonic_time();
 	prefs_p = read_prefs();
+	startup_timing_record("settings", "preferences", g_get_monotonic_time() - step);
 
 	/*
 	 * Read the files that enable and disable protocols and heuristic
 	 * dissectors.
 	 */
+	step = g_get_monotonic_time();
 	read_enabled_and_disabled_lists();
+	startup_timing_record("settings", "enabled_protocols", g_get_monotonic_time() - step);
 
+	startup_timing_record("settings", NULL, g_get_monotonic_time() - start);
 	return prefs_p;
 }
 
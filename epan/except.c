@@ -205,7 +205,7 @@ WS_NORETURN static void do_throw(except_t *except)
                 if (match(&except->except_id, pi)) {
                     catcher->except_obj = *except;
                     set_top(top);
-                    longjmp(catcher->except_jmp, 1);
+                    except_longjmp(catcher->except_jmp, 1);
                 }
             }
         }
@@ -42,6 +42,21 @@
 #define XCEPT_CODE_ANY  0
 #define XCEPT_BAD_ALLOC 1
 
+/*
+ * Every TRY saves a jump buffer. On BSD and macOS setjmp also saves the
+ * signal mask, which costs a system call each time; nothing here needs the
+ * mask restored, so use sigsetjmp without saving it where it's available.
+ */
+#ifdef _WIN32
+#define except_jmp_buf              jmp_buf
+#define except_setjmp(env)          setjmp(env)
+#define except_longjmp(env, val)    longjmp(env, val)
+#else
+#define except_jmp_buf              sigjmp_buf
+#define except_setjmp(env)          sigsetjmp(env, 0)
+#define except_longjmp(env, val)    siglongjmp(env, val)
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -68,7 +83,7 @@ struct except_catch {
     const except_id_t *except_id;
     size_t except_size;
     except_t except_obj;
-    jmp_buf except_jmp;
+    except_jmp_buf except_jmp;
 };
 
 enum except_stacktype {
@@ -174,7 +189,7 @@ WS_DLL_PUBLIC void except_free(void *);
         struct except_stacknode except_sn;                      \
         struct except_catch except_ch;                          \
         except_setup_try(&except_sn, &except_ch, ID, NUM);      \
-        if (setjmp(except_ch.except_jmp))                       \
+        if (except_setjmp(except_ch.except_jmp))                \
             *(PPE) = &except_ch.except_obj;                     \
         else                                                    \
             *(PPE) = 0
@@ -9,6 +9,7 @@
 #include <config.h>
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <glib.h>
 #include "exceptions.h"
 
@@ -206,10 +207,47 @@ run_tests(void)
         printf("success\n");
 }
 
-int main(void)
+/* Time TRY blocks that don't throw, nested as in a dissector stack */
+static void
+run_benchmark(unsigned int iterations)
+{
+    volatile unsigned int depth_reached = 0;
+    gint64 start, elapsed;
+    unsigned int i;
+
+    if (iterations == 0)
+        return;
+
+    start = g_get_monotonic_time();
+    for (i = 0; i < iterations; i++) {
+        TRY {
+            TRY {
+                TRY {
+                    depth_reached++;
+                }
+                ENDTRY;
+            }
+            ENDTRY;
+        }
+        ENDTRY;
+    }
+
+    elapsed = g_get_monotonic_time() - start;
+
+    printf("%u nested TRY blocks in %.3f ms (%.1f ns each)\n",
+           3 * iterations, elapsed / 1000.0,
+           elapsed * 1000.0 / (3.0 * iterations));
+    if (depth_reached != iterations)
+        failed = TRUE;
+}
+
+int main(int argc, char **argv)
 {
     except_init();
     run_tests();
+    /* "exntest <iterations>" also measures the cost of a TRY frame */
+    if (argc > 1)
+        run_benchmark((unsigned int)strtoul(argv[1], NULL, 10));
     except_deinit();
     exit(failed?1:0);
 }
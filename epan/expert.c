@@ -492,6 +492,22 @@ expert_create_tree(proto_item *pi, int group, int severity, const char *msg)
 	return proto_item_add_subtree(ti, ett_subexpert);
 }
 
+/*
+ * Whether the expert tree that would be added under pi shows the message,
+ * or has a field with it that a filter or column refers to.
+ */
+static gboolean
+expert_message_needed(proto_item *pi, int hf_index)
+{
+	/* No item, no expert tree */
+	if (pi == NULL)
+		return FALSE;
+
+	return proto_field_is_referenced(pi, proto_expert) ||
+		proto_field_is_referenced(pi, hf_expert_msg) ||
+		(hf_index != -1 && proto_field_is_referenced(pi, hf_index));
+}
+
 static void
 expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int severity, int hf_index, gboolean use_vaformat,
 			const char *format, va_list ap)
@@ -525,7 +541,15 @@ expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int sever
 		col_add_str(pinfo->cinfo, COL_EXPERT, val_to_str(severity, expert_severity_vals, "Unknown (%u)"));
 	}
 
-	if (use_vaformat) {
+	/*
+	 * Only format the message if something is going to look at it;
+	 * the severity and group are still added, for filters.
+	 */
+	tap = have_tap_listener(expert_tap);
+
+	if (!tap && !expert_message_needed(pi, hf_index)) {
+		formatted[0] = '\0';
+	} else if (use_vaformat) {
 		ws_vsnprintf(formatted, ITEM_LABEL_LENGTH, format, ap);
 	} else {
 		g_strlcpy(formatted, format, ITEM_LABEL_LENGTH);
@@ -553,8 +577,6 @@ expert_set_info_vformat(packet_info *pinfo, proto_item *pi, int group, int sever
 					      "%s", val_to_str_const(group, expert_group_vals, "Unknown"));
 	proto_item_set_generated(ti);
 
-	tap = have_tap_listener(expert_tap);
-
 	if (!tap)
 		return;
 
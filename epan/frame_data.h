@@ -51,10 +51,11 @@ typedef enum {
 
    There is one of these structures for every frame in the capture.
    That means a lot of memory if we have a lot of frames.
-   They are packed into power-of-2 chunks, so their size is effectively
-   rounded up to a power of 2.
-   Try to keep it close to, and less than or equal to, a power of 2.
-   "Smaller than a power of 2" is OK for ILP32 platforms.
+   frame_data_sequence stores them back to back in leaf arrays of 1024
+   entries, so every byte saved here is saved once per frame; on LP64
+   this is currently 88 bytes, of which 8 are padding inside the two
+   nstime_ts and 4 the hole after the bitfields.  Any new field should
+   go into that hole, or into per-frame proto data if it's rarely set.
 
    XXX - shuffle the fields to try to keep the most commonly-accessed
    fields within the first 16 or 32 bytes, so they all fit in a cache
@@ -13,6 +13,8 @@
 
 #include "config.h"
 
+#include <string.h>
+
 #include <glib.h>
 
 #include <epan/tvbuff.h>
@@ -76,17 +78,34 @@ in_cksum(const vec_t *vec, int veclen)
 			byte_swapped = 1;
 		}
 		/*
-		 * Unroll the loop to make overhead from
-		 * branches &c small.
+		 * Sum 32-bit words into a 64-bit accumulator, which
+		 * can't overflow for any vec_t length.  As 2^16 is 1
+		 * in one's complement arithmetic, folding the result
+		 * gives the same sum as adding the 16-bit words, and
+		 * compilers can vectorize this loop.
 		 */
-		while ((mlen -= 32) >= 0) {
-			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
-			sum += w[4]; sum += w[5]; sum += w[6]; sum += w[7];
-			sum += w[8]; sum += w[9]; sum += w[10]; sum += w[11];
-			sum += w[12]; sum += w[13]; sum += w[14]; sum += w[15];
-			w += 16;
+		if (mlen >= 32) {
+			const guint8 *p = (const guint8 *)w;
+			guint64 wide = 0;
+			guint32 word;
+			int i;
+
+			while ((mlen -= 32) >= 0) {
+				for (i = 0; i < 32; i += 4) {
+					memcpy(&word, p + i, sizeof(word));
+					wide += word;
+				}
+				p += 32;
+			}
+			mlen += 32;
+			w = (const guint16 *)(const void *)p;
+
+			wide = (wide & 0xffffffff) + (wide >> 32);
+			wide = (wide & 0xffffffff) + (wide >> 32);
+			wide = (wide & 0xffff) + (wide >> 16);
+			wide = (wide & 0xffff) + (wide >> 16);
+			sum += (int)wide;
 		}
-		mlen += 32;
 		while ((mlen -= 8) >= 0) {
 			sum += w[0]; sum += w[1]; sum += w[2]; sum += w[3];
 			w += 4;
@@ -23,6 +23,11 @@ static mmdb_lookup_t mmdb_not_found;
 #include <stdio.h>
 #include <errno.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#endif
+
 #include <epan/wmem/wmem.h>
 
 #include <epan/addr_resolv.h>
@@ -159,6 +164,8 @@ static gboolean mmdbr_pipe_valid(void) {
     return pipe_valid;
 }
 
+#define MMDB_WRITE_BATCH_LEN 4096
+
 // Writing to mmdbr_pipe.stdin_fd can block. Do so in a separate thread.
 static gpointer
 write_mmdbr_stdin_worker(gpointer sifd_data) {
@@ -185,22 +192,42 @@ write_mmdbr_stdin_worker(gpointer sifd_data) {
             continue;
         }
 
-        MMDB_DEBUG("write %s ql %d", request, g_async_queue_length(mmdbr_request_q));
-        ssize_t req_status = ws_write(stdin_fd, request, (unsigned int)strlen(request));
+        // Send everything that has been queued meanwhile in one write.
+        // A table full of new addresses queues them all at once.
+        GString *batch = g_string_new(request);
+        g_free(request);
+        while (batch->len < MMDB_WRITE_BATCH_LEN && (request = (char *) g_async_queue_try_pop(mmdbr_request_q)) != NULL) {
+            if (strcmp(request, mmdbr_stop_sentinel) != 0) {
+                g_string_append(batch, request);
+            }
+            g_free(request);
+        }
+
+        MMDB_DEBUG("write %zu bytes ql %d", batch->len, g_async_queue_length(mmdbr_request_q));
+        ssize_t req_status = ws_write(stdin_fd, batch->str, (unsigned int)batch->len);
+        g_string_free(batch, TRUE);
         if (req_status < 0) {
             MMDB_DEBUG("write error %s. exiting thread.", g_strerror(errno));
             return NULL;
         }
-        g_free(request);
     }
     return NULL;
 }
 
-static ssize_t mmdbr_pipe_read_one(char *ch_p) {
+// Reads whatever is available without blocking, up to len bytes.
+static ssize_t mmdbr_pipe_read(char *buf, size_t len) {
     ssize_t status = -1;
     g_rw_lock_reader_lock(&mmdbr_pipe_mtx);
     if (ws_pipe_valid(&mmdbr_pipe) && ws_pipe_data_available(mmdbr_pipe.stdout_fd)) {
-        status = ws_read(mmdbr_pipe.stdout_fd, ch_p, 1);
+#ifdef _WIN32
+        // Don't ask for more than the pipe holds, so that the read can't block.
+        DWORD bytes_avail = 0;
+        HANDLE hPipe = (HANDLE) _get_osfhandle(mmdbr_pipe.stdout_fd);
+        if (PeekNamedPipe(hPipe, NULL, 0, NULL, &bytes_avail, NULL) && bytes_avail < len) {
+            len = bytes_avail;
+        }
+#endif
+        status = ws_read(mmdbr_pipe.stdout_fd, buf, (unsigned int)len);
     }
     g_rw_lock_reader_unlock(&mmdbr_pipe_mtx);
     return status;
@@ -212,19 +239,24 @@ static ssize_t mmdbr_pipe_read_one(char *ch_p) {
 // thread calls fclose while fgets is blocking, it will block as well. The
 // same happens for plain close+read.
 //
-// Read our input one character at a time and only after we've ensured
-// that data is available. If this is too inefficient we could try one
-// of the following:
+// Read our input only after we've ensured that data is available, and
+// only as much as is available. Reading one character at a time took a
+// select and a read system call per byte, which made resolving a large
+// endpoint table slow. Alternatives would be:
 // - Use overlapped I/O, which implies adding ws_pipe_set_nonblock and
 //   ws_pipe_read_nonblock routines.
 // - Stash our worker thread handles on Windows and call CancelSynchronousIo
 //   before shutting down our threads.
 #define MAX_MMDB_LINE_LEN 2000
 #define MMDB_WAIT_TIME (150 * 1000) // microseconds
+#define MMDB_READ_BUF_LEN 4096
 static gpointer
 read_mmdbr_stdout_worker(gpointer data _U_) {
     mmdb_response_t *response = g_new0(mmdb_response_t, 1);
     GString *line_buf = g_string_new("");
+    char read_buf[MMDB_READ_BUF_LEN];
+    ssize_t read_len = 0;
+    ssize_t read_pos = 0;
     GString *country_iso = g_string_new("");
     GString *country = g_string_new("");
     GString *city = g_string_new("");
@@ -233,13 +265,21 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
 
     MMDB_DEBUG("starting read worker");
 
-    while (1) { // Start of line
+    while (1) { // Start of line, or rest of a line we only got part of
         char ch;
-        ssize_t status;
-
-        g_string_truncate(line_buf, 0);
-
-        while((status = mmdbr_pipe_read_one(&ch)) == 1) {
+        ssize_t status = 1;
+
+        while (1) {
+            if (read_pos == read_len) {
+                read_pos = 0;
+                read_len = mmdbr_pipe_read(read_buf, sizeof(read_buf));
+                if (read_len < 1) {
+                    status = read_len;
+                    read_len = 0;
+                    break;
+                }
+            }
+            ch = read_buf[read_pos++];
             if (ch == '\n') {
                 break;
             }
@@ -267,7 +307,10 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
         char *line = g_strstrip(line_buf->str);
         size_t line_len = strlen(line);
         MMDB_DEBUG("read %zd bytes, status %zd: %s", line_len, status, line);
-        if (line_len < 1) continue;
+        if (line_len < 1) {
+            g_string_truncate(line_buf, 0);
+            continue;
+        }
 
         char *val_start = strchr(line, ':');
         if (val_start) {
@@ -350,6 +393,7 @@ read_mmdbr_stdout_worker(gpointer data _U_) {
             cur_addr[0] = '\0';
             init_lookup(&response->mmdb_val);
         }
+        g_string_truncate(line_buf, 0);
     }
 
     g_string_free(line_buf, TRUE);
@@ -31,7 +31,10 @@
 #include <smi.h>
 
 static gboolean smi_init_done = FALSE;
+static gboolean smi_path_set = FALSE;
 static gboolean oids_init_done = FALSE;
+static gboolean mibs_load_pending = FALSE;
+static int proto_mibs = -1;
 static gboolean load_smi_modules = FALSE;
 static gboolean suppress_smi_errors = FALSE;
 #endif
@@ -515,26 +518,17 @@ static void restart_needed_warning(void) {
 		report_failure("Wireshark needs to be restarted for these changes to take effect");
 }
 
-static void register_mibs(void) {
+static void load_mibs(void) {
 	SmiModule *smiModule;
 	SmiNode *smiNode;
 	guint i;
-	int proto_mibs = -1;
 	wmem_array_t* hfa;
 	GArray* etta;
 	gchar* path_str;
 
-	if (!load_smi_modules) {
-		D(1,("OID resolution not enabled"));
-		return;
-	}
-
-	/* TODO: Remove this workaround when unregistration of "MIBs" proto is solved.
-	 * Wireshark does not support that yet. :-( */
-	if (oids_init_done) {
-		D(1,("Exiting register_mibs() to avoid double registration of MIBs proto."));
+	if (!mibs_load_pending)
 		return;
-	}
+	mibs_load_pending = FALSE;
 
 	hfa = wmem_array_new(wmem_epan_scope(), sizeof(hf_register_info));
 	etta = g_array_new(FALSE,TRUE,sizeof(gint*));
@@ -549,6 +543,7 @@ static void register_mibs(void) {
 	D(1,("SMI Path: '%s'",path_str));
 
 	smiSetPath(path_str);
+	smi_path_set = TRUE;
 
 	for(i=0;i<num_smi_modules;i++) {
 		if (!smi_modules[i].name) continue;
@@ -726,14 +721,46 @@ static void register_mibs(void) {
 		}
 	}
 
-	proto_mibs = proto_register_protocol("MIBs", "MIBS", "mibs");
-
 	proto_register_field_array(proto_mibs, (hf_register_info*)wmem_array_get_raw(hfa), wmem_array_get_count(hfa));
 
 	proto_register_subtree_array((gint**)(void*)etta->data, etta->len);
 
 	g_array_free(etta,TRUE);
+}
+
+static void load_mibs_for_prefix(const char *prefix _U_) {
+	load_mibs();
+}
+
+/*
+ * Loading the modules takes seconds, so it's done when an OID is first
+ * looked up, or when a field of one of the configured modules is, e.g.
+ * by a display filter.  The field names start with the name of the
+ * module that defines them.
+ */
+static void register_mibs(void) {
+	guint i;
+
+	if (!load_smi_modules) {
+		D(1,("OID resolution not enabled"));
+		return;
+	}
+
+	/* TODO: Remove this workaround when unregistration of "MIBs" proto is solved.
+	 * Wireshark does not support that yet. :-( */
+	if (oids_init_done) {
+		D(1,("Exiting register_mibs() to avoid double registration of MIBs proto."));
+		return;
+	}
+
+	proto_mibs = proto_register_protocol("MIBs", "MIBS", "mibs");
 
+	for (i = 0; i < num_smi_modules; i++) {
+		if (smi_modules[i].name && *smi_modules[i].name)
+			proto_register_prefix(wmem_strdup(wmem_epan_scope(), smi_modules[i].name), load_mibs_for_prefix);
+	}
+
+	mibs_load_pending = TRUE;
 	oids_init_done = TRUE;
 }
 #endif
@@ -1031,6 +1058,10 @@ oid_info_t* oid_get(guint len, guint32* subids, guint* matched, guint* left) {
 	oid_info_t* curr_oid = &oid_root;
 	guint i;
 
+#ifdef HAVE_LIBSMI
+	load_mibs();
+#endif
+
 	if(!(subids && *subids <= 2)) {
 		*matched = 0;
 		*left = len;
@@ -1285,7 +1316,8 @@ oid_get_default_mib_path(void) {
 	}
 	smi_free(path);
 
-	if (oids_init_done == FALSE)
+	/* smiGetPath() already has them once load_mibs() has set the path */
+	if (smi_path_set == FALSE)
 	{
 #endif
 		for (i = 0; i < num_smi_paths; i++) {
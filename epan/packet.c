@@ -89,6 +89,25 @@ struct dissector_table {
 	protocol_t	*protocol;
 	GHashFunc	hash_func;
 	gboolean	supports_decode_as;
+	/*
+	 * FT_UINT8 and FT_UINT16 tables only: an index of hash_table,
+	 * rebuilt on the first lookup after the table changes.  For
+	 * FT_UINT8 it maps every pattern straight to its entry; for
+	 * FT_UINT16 it is a bitmap of the patterns present, so that
+	 * misses don't need a hash lookup.  It isn't used if the table
+	 * has a pattern that doesn't fit in the type.
+	 */
+	gboolean	index_valid;
+	gboolean	index_usable;
+	dtbl_entry_t	**uint8_index;
+	guint8		*uint16_present;
+	/*
+	 * FT_UINT8 and FT_UINT16 tables only: a bitmap of the patterns
+	 * looked up while dissecting, for dissector_uint_pattern_consulted().
+	 */
+	guint8		*consulted;
+	/* Only counted while dissector_profiling is set */
+	dissector_table_profile_t profile;
 };
 
 /*
@@ -106,6 +125,18 @@ static GHashTable *dissector_table_aliases = NULL;
  */
 static GHashTable *registered_dissectors = NULL;
 
+/*
+ * Per-handle profiles, only collected while dissector_profiling is set.
+ * dissector_profile_child_usecs is the time spent so far in the dissectors
+ * called by the one currently running, which is what we subtract from its
+ * inclusive time to get its exclusive time.
+ */
+static gboolean dissector_profiling = FALSE;
+/* Set while dissect_record() or dissect_file() runs */
+static gboolean dissecting = FALSE;
+static GHashTable *dissector_profiles = NULL;	/* dissector_handle_t -> dissector_profile_t */
+static gint64 dissector_profile_child_usecs = 0;
+
 /*
  * A dissector dependency list.
  */
@@ -190,6 +221,9 @@ destroy_dissector_table(void *data)
 
 	g_hash_table_destroy(table->hash_table);
 	g_slist_free(table->dissector_handles);
+	g_free(table->uint8_index);
+	g_free(table->uint16_present);
+	g_free(table->consulted);
 	g_slice_free(struct dissector_table, data);
 }
 
@@ -259,6 +293,10 @@ packet_cleanup(void)
 	g_hash_table_destroy(depend_dissector_lists);
 	g_hash_table_destroy(heur_dissector_lists);
 	g_hash_table_destroy(heuristic_short_names);
+	if (dissector_profiles) {
+		g_hash_table_destroy(dissector_profiles);
+		dissector_profiles = NULL;
+	}
 	g_slist_foreach(shutdown_routines, &call_routine, NULL);
 	g_slist_free(shutdown_routines);
 	if (postdissectors) {
@@ -577,6 +615,7 @@ dissect_record(epan_dissect_t *edt, int file_type_subtype,
 		 * sub-dissector can throw, dissect_frame() itself may throw
 		 * a ReportedBoundsError in bizarre cases. Thus, we catch the exception
 		 * in this function. */
+		dissecting = TRUE;
 		call_dissector_with_data(frame_handle, edt->tvb, &edt->pi, edt->tree, &frame_dissector_data);
 	}
 	CATCH(BoundsError) {
@@ -588,6 +627,7 @@ dissect_record(epan_dissect_t *edt, int file_type_subtype,
 					       record_type);
 	}
 	ENDTRY;
+	dissecting = FALSE;
 
 	fd->visited = 1;
 }
@@ -645,6 +685,7 @@ dissect_file(epan_dissect_t *edt, wtap_rec *rec,
 		 * sub-dissector can throw, dissect_frame() itself may throw
 		 * a ReportedBoundsError in bizarre cases. Thus, we catch the exception
 		 * in this function. */
+		dissecting = TRUE;
 		call_dissector_with_data(file_handle, edt->tvb, &edt->pi, edt->tree, &file_dissector_data);
 
 	}
@@ -656,6 +697,7 @@ dissect_file(epan_dissect_t *edt, wtap_rec *rec,
 					       "[Malformed Record: Packet Length]");
 	}
 	ENDTRY;
+	dissecting = FALSE;
 
 	fd->visited = 1;
 }
@@ -678,6 +720,122 @@ struct dissector_handle {
 	protocol_t	*protocol;
 };
 
+static int
+call_dissector_func(dissector_handle_t handle, tvbuff_t *tvb,
+		    packet_info *pinfo, proto_tree *tree, void *data)
+{
+	if (handle->dissector_type == DISSECTOR_TYPE_SIMPLE) {
+		return ((dissector_t)handle->dissector_func)(tvb, pinfo, tree, data);
+	}
+	else if (handle->dissector_type == DISSECTOR_TYPE_CALLBACK) {
+		return ((dissector_cb_t)handle->dissector_func)(tvb, pinfo, tree, data, handle->dissector_data);
+	}
+
+	g_assert_not_reached();
+	return 0;
+}
+
+void
+set_dissector_profiling(gboolean enable)
+{
+	dissector_profiling = enable;
+	if (enable && !dissector_profiles) {
+		dissector_profiles = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
+	}
+}
+
+void
+dissector_profile_reset(void)
+{
+	if (dissector_profiles) {
+		g_hash_table_remove_all(dissector_profiles);
+	}
+	dissector_profile_child_usecs = 0;
+	if (dissector_tables) {
+		GHashTableIter iter;
+		gpointer value;
+
+		g_hash_table_iter_init(&iter, dissector_tables);
+		while (g_hash_table_iter_next(&iter, NULL, &value)) {
+			dissector_table_t sub_dissectors = (dissector_table_t)value;
+
+			memset(&sub_dissectors->profile, 0, sizeof sub_dissectors->profile);
+		}
+	}
+}
+
+void
+dissector_profile_foreach(dissector_profile_func func, gpointer user_data)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if (!dissector_profiles)
+		return;
+
+	g_hash_table_iter_init(&iter, dissector_profiles);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		dissector_handle_t handle = (dissector_handle_t)key;
+		const char *name = handle->name;
+
+		if (!name) {
+			name = handle->protocol ? proto_get_protocol_short_name(handle->protocol) : "(unknown)";
+		}
+		func(name, (const dissector_profile_t *)value, user_data);
+	}
+}
+
+void
+dissector_table_profile_foreach(dissector_table_profile_func func, gpointer user_data)
+{
+	GHashTableIter iter;
+	gpointer key, value;
+
+	g_hash_table_iter_init(&iter, dissector_tables);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		dissector_table_t sub_dissectors = (dissector_table_t)value;
+
+		if (sub_dissectors->profile.lookups != 0)
+			func((const char *)key, &sub_dissectors->profile, user_data);
+	}
+}
+
+static int
+call_dissector_func_profiled(dissector_handle_t handle, tvbuff_t *tvb,
+			     packet_info *pinfo, proto_tree *tree, void *data)
+{
+	dissector_profile_t *profile;
+	gint64 start, outer_child_usecs;
+	volatile int len = 0;
+
+	profile = (dissector_profile_t *)g_hash_table_lookup(dissector_profiles, handle);
+	if (!profile) {
+		profile = g_new0(dissector_profile_t, 1);
+		g_hash_table_insert(dissector_profiles, handle, profile);
+	}
+	profile->calls++;
+	profile->bytes += tvb_reported_length(tvb);
+
+	outer_child_usecs = dissector_profile_child_usecs;
+	dissector_profile_child_usecs = 0;
+	start = g_get_monotonic_time();
+
+	/* Dissectors throw exceptions, so account for the time either way */
+	TRY {
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
+	}
+	FINALLY {
+		gint64 elapsed = g_get_monotonic_time() - start;
+
+		profile->inclusive_usecs += elapsed;
+		profile->exclusive_usecs += elapsed - dissector_profile_child_usecs;
+		dissector_profile_child_usecs = outer_child_usecs + elapsed;
+	}
+	ENDTRY;
+
+	return len;
+}
+
 /* This function will return
  * old style dissector :
  *   length of the payload or 1 of the payload is empty
@@ -702,14 +860,10 @@ call_dissector_through_handle(dissector_handle_t handle, tvbuff_t *tvb,
 			proto_get_protocol_short_name(handle->protocol);
 	}
 
-	if (handle->dissector_type == DISSECTOR_TYPE_SIMPLE) {
-		len = ((dissector_t)handle->dissector_func)(tvb, pinfo, tree, data);
-	}
-	else if (handle->dissector_type == DISSECTOR_TYPE_CALLBACK) {
-		len = ((dissector_cb_t)handle->dissector_func)(tvb, pinfo, tree, data, handle->dissector_data);
-	}
-	else {
-		g_assert_not_reached();
+	if (G_UNLIKELY(dissector_profiling)) {
+		len = call_dissector_func_profiled(handle, tvb, pinfo, tree, data);
+	} else {
+		len = call_dissector_func(handle, tvb, pinfo, tree, data);
 	}
 	pinfo->current_proto = saved_proto;
 
@@ -955,10 +1109,109 @@ find_dissector_table(const char *name)
 	return dissector_table;
 }
 
+/* Called whenever entries are added to or removed from a uint table. */
+static inline void
+uint_dtbl_changed(dissector_table_t sub_dissectors)
+{
+	sub_dissectors->index_valid = FALSE;
+}
+
+static void
+build_uint_dtbl_index(dissector_table_t sub_dissectors)
+{
+	guint32 max_pattern = sub_dissectors->type == FT_UINT8 ? G_MAXUINT8 : G_MAXUINT16;
+	GHashTableIter iter;
+	gpointer key, value;
+
+	if (sub_dissectors->type == FT_UINT8) {
+		if (!sub_dissectors->uint8_index)
+			sub_dissectors->uint8_index = g_new(dtbl_entry_t *, G_MAXUINT8 + 1);
+		memset(sub_dissectors->uint8_index, 0, (G_MAXUINT8 + 1) * sizeof (dtbl_entry_t *));
+	} else {
+		if (!sub_dissectors->uint16_present)
+			sub_dissectors->uint16_present = (guint8 *)g_malloc((G_MAXUINT16 + 1) / 8);
+		memset(sub_dissectors->uint16_present, 0, (G_MAXUINT16 + 1) / 8);
+	}
+
+	sub_dissectors->index_valid = TRUE;
+	sub_dissectors->index_usable = TRUE;
+	g_hash_table_iter_init(&iter, sub_dissectors->hash_table);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		guint32 pattern = GPOINTER_TO_UINT(key);
+
+		if (pattern > max_pattern) {
+			sub_dissectors->index_usable = FALSE;
+			return;
+		}
+		if (sub_dissectors->type == FT_UINT8)
+			sub_dissectors->uint8_index[pattern] = (dtbl_entry_t *)value;
+		else
+			sub_dissectors->uint16_present[pattern >> 3] |= 1 << (pattern & 7);
+	}
+}
+
+/* Remember that a dissector looked up a pattern in an FT_UINT8 or FT_UINT16 table. */
+static void
+mark_uint_dtbl_consulted(dissector_table_t sub_dissectors, const guint32 pattern)
+{
+	guint32 max_pattern = sub_dissectors->type == FT_UINT8 ? G_MAXUINT8 : G_MAXUINT16;
+
+	/* Patterns outside the type can't be entries that Decode As changes */
+	if (pattern > max_pattern)
+		return;
+	if (!sub_dissectors->consulted)
+		sub_dissectors->consulted = (guint8 *)g_malloc0((max_pattern + 1) / 8);
+	sub_dissectors->consulted[pattern >> 3] |= 1 << (pattern & 7);
+}
+
+gboolean
+dissector_uint_pattern_consulted(const char *name, const guint32 pattern)
+{
+	dissector_table_t sub_dissectors = find_dissector_table(name);
+
+	if (!sub_dissectors)
+		return TRUE;
+	if (sub_dissectors->type != FT_UINT8 && sub_dissectors->type != FT_UINT16)
+		return TRUE;
+	if (!sub_dissectors->consulted)
+		return FALSE;
+	if (pattern > (sub_dissectors->type == FT_UINT8 ? G_MAXUINT8 : G_MAXUINT16))
+		return TRUE;
+	return (sub_dissectors->consulted[pattern >> 3] & (1 << (pattern & 7))) != 0;
+}
+
+/*
+ * Find an entry in an FT_UINT8 or FT_UINT16 table through its index.
+ * Returns FALSE if the hash table has to be searched after all.
+ */
+static gboolean
+find_uint_dtbl_entry_indexed(dissector_table_t sub_dissectors, const guint32 pattern,
+			     dtbl_entry_t **dtbl_entry)
+{
+	if (!sub_dissectors->index_valid)
+		build_uint_dtbl_index(sub_dissectors);
+	if (!sub_dissectors->index_usable)
+		return FALSE;
+
+	if (sub_dissectors->type == FT_UINT8) {
+		*dtbl_entry = pattern <= G_MAXUINT8 ? sub_dissectors->uint8_index[pattern] : NULL;
+		return TRUE;
+	}
+	if (pattern > G_MAXUINT16 ||
+	    !(sub_dissectors->uint16_present[pattern >> 3] & (1 << (pattern & 7)))) {
+		*dtbl_entry = NULL;
+		return TRUE;
+	}
+	return FALSE;
+}
+
 /* Find an entry in a uint dissector table. */
 static dtbl_entry_t *
 find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 {
+	dtbl_entry_t *dtbl_entry = NULL;
+	gboolean indexed = FALSE;
+
 	switch (sub_dissectors->type) {
 
 	case FT_UINT8:
@@ -984,8 +1237,23 @@ find_uint_dtbl_entry(dissector_table_t sub_dissectors, const guint32 pattern)
 	/*
 	 * Find the entry.
 	 */
-	return (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table,
-				   GUINT_TO_POINTER(pattern));
+	if (sub_dissectors->type == FT_UINT8 || sub_dissectors->type == FT_UINT16) {
+		if (dissecting)
+			mark_uint_dtbl_consulted(sub_dissectors, pattern);
+		indexed = find_uint_dtbl_entry_indexed(sub_dissectors, pattern, &dtbl_entry);
+	}
+	if (!indexed)
+		dtbl_entry = (dtbl_entry_t *)g_hash_table_lookup(sub_dissectors->hash_table,
+					   GUINT_TO_POINTER(pattern));
+
+	if (G_UNLIKELY(dissector_profiling)) {
+		sub_dissectors->profile.lookups++;
+		if (indexed)
+			sub_dissectors->profile.indexed++;
+		if (dtbl_entry != NULL)
+			sub_dissectors->profile.hits++;
+	}
+	return dtbl_entry;
 }
 
 #if 0
@@ -1067,6 +1335,7 @@ dissector_add_uint(const char *name, const guint32 pattern, dissector_handle_t h
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_dtbl_changed(sub_dissectors);
 
 	/*
 	 * Now, if this table supports "Decode As", add this handle
@@ -1228,6 +1497,7 @@ dissector_delete_uint(const char *name, const guint32 pattern,
 		 */
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_dtbl_changed(sub_dissectors);
 	}
 }
 
@@ -1269,6 +1539,7 @@ void dissector_delete_all(const char *name, dissector_handle_t handle)
 	g_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove (sub_dissectors->hash_table, dissector_delete_all_check, handle);
+	uint_dtbl_changed(sub_dissectors);
 }
 
 static void
@@ -1278,6 +1549,7 @@ dissector_delete_from_table(gpointer key _U_, gpointer value, gpointer user_data
 	g_assert (sub_dissectors);
 
 	g_hash_table_foreach_remove(sub_dissectors->hash_table, dissector_delete_all_check, user_data);
+	uint_dtbl_changed(sub_dissectors);
 	sub_dissectors->dissector_handles = g_slist_remove(sub_dissectors->dissector_handles, user_data);
 }
 
@@ -1323,6 +1595,7 @@ dissector_change_uint(const char *name, const guint32 pattern, dissector_handle_
 	/* do the table insertion */
 	g_hash_table_insert(sub_dissectors->hash_table,
 			     GUINT_TO_POINTER(pattern), (gpointer)dtbl_entry);
+	uint_dtbl_changed(sub_dissectors);
 }
 
 /* Reset an entry in a uint dissector table to its initial value. */
@@ -1351,6 +1624,7 @@ dissector_reset_uint(const char *name, const guint32 pattern)
 	} else {
 		g_hash_table_remove(sub_dissectors->hash_table,
 				    GUINT_TO_POINTER(pattern));
+		uint_dtbl_changed(sub_dissectors);
 	}
 }
 
@@ -2472,6 +2746,12 @@ register_dissector_table(const char *name, const char *ui_name, const int proto,
 	sub_dissectors->param   = param;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->index_valid = FALSE;
+	sub_dissectors->index_usable = FALSE;
+	sub_dissectors->uint8_index = NULL;
+	sub_dissectors->uint16_present = NULL;
+	sub_dissectors->consulted = NULL;
+	memset(&sub_dissectors->profile, 0, sizeof sub_dissectors->profile);
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2501,6 +2781,12 @@ dissector_table_t register_custom_dissector_table(const char *name,
 	sub_dissectors->param   = BASE_NONE;
 	sub_dissectors->protocol  = find_protocol_by_id(proto);
 	sub_dissectors->supports_decode_as = FALSE;
+	sub_dissectors->index_valid = FALSE;
+	sub_dissectors->index_usable = FALSE;
+	sub_dissectors->uint8_index = NULL;
+	sub_dissectors->uint16_present = NULL;
+	sub_dissectors->consulted = NULL;
+	memset(&sub_dissectors->profile, 0, sizeof sub_dissectors->profile);
 	g_hash_table_insert(dissector_tables, (gpointer)name, (gpointer) sub_dissectors);
 	return sub_dissectors;
 }
@@ -2697,9 +2983,84 @@ heur_dissector_delete(const char *name, heur_dissector_t dissector, const int pr
 	}
 }
 
+/*
+ * Call one heuristic dissector on behalf of dissector_try_heuristic_hinted(),
+ * returning the number of bytes it consumed, or 0 if it is disabled or did
+ * not accept the packet.
+ */
+static int
+call_heur_dtbl_entry(heur_dtbl_entry_t *hdtbl_entry, tvbuff_t *tvb,
+		     packet_info *pinfo, proto_tree *tree, void *data,
+		     guint16 saved_can_desegment, guint saved_layers_len,
+		     int saved_tree_count)
+{
+	int proto_id;
+	int len;
+
+	/* XXX - why set this now and above? */
+	pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
+
+	if (hdtbl_entry->protocol != NULL &&
+		(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==FALSE))) {
+		/*
+		 * No - don't try this dissector.
+		 */
+		return 0;
+	}
+
+	if (hdtbl_entry->protocol != NULL) {
+		proto_id = proto_get_id(hdtbl_entry->protocol);
+		/* do NOT change this behavior - wslua uses the protocol short name set here in order
+		   to determine which Lua-based heurisitc dissector to call */
+		pinfo->current_proto =
+			proto_get_protocol_short_name(hdtbl_entry->protocol);
+
+		/*
+		 * Add the protocol name to the layers; we'll remove it
+		 * if the dissector fails.
+		 */
+		pinfo->curr_layer_num++;
+		wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_id));
+	}
+
+	pinfo->heur_list_name = hdtbl_entry->list_name;
+
+	len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
+	if (hdtbl_entry->protocol != NULL &&
+		(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
+		/*
+		 * We added a protocol layer above. The dissector
+		 * didn't accept the packet or it didn't add any
+		 * items to the tree so remove it from the list.
+		 */
+		while (wmem_list_count(pinfo->layers) > saved_layers_len) {
+			if (len == 0) {
+				/*
+				 * Only reduce the layer number if the dissector
+				 * rejected the data. Since tree can be NULL on
+				 * the first pass, we cannot check it or it will
+				 * break dissectors that rely on a stable value.
+				 */
+				pinfo->curr_layer_num--;
+			}
+			wmem_list_remove_frame(pinfo->layers, wmem_list_tail(pinfo->layers));
+		}
+	}
+
+	return len;
+}
+
 gboolean
 dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 			packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **heur_dtbl_entry, void *data)
+{
+	return dissector_try_heuristic_hinted(sub_dissectors, tvb, pinfo, tree, NULL, heur_dtbl_entry, data);
+}
+
+gboolean
+dissector_try_heuristic_hinted(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
+			       packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t *hint,
+			       heur_dtbl_entry_t **heur_dtbl_entry, void *data)
 {
 	gboolean           status;
 	const char        *saved_curr_proto;
@@ -2708,8 +3069,6 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 	guint16            saved_can_desegment;
 	guint              saved_layers_len = 0;
 	heur_dtbl_entry_t *hdtbl_entry;
-	int                proto_id;
-	int                len;
 	int                saved_tree_count = tree ? tree->tree_data->count : 0;
 
 	/* can_desegment is set to 2 by anyone which offers this api/service.
@@ -2734,62 +3093,33 @@ dissector_try_heuristic(heur_dissector_list_t sub_dissectors, tvbuff_t *tvb,
 
 	DISSECTOR_ASSERT(saved_layers_len < PINFO_LAYER_MAX_RECURSION_DEPTH);
 
-	for (entry = sub_dissectors->dissectors; entry != NULL;
+	/*
+	 * Try the hinted dissector first, but only if it is still in
+	 * this list; it may have been removed since the hint was saved.
+	 */
+	if (hint != NULL && g_slist_find(sub_dissectors->dissectors, hint) != NULL) {
+		if (call_heur_dtbl_entry(hint, tvb, pinfo, tree, data,
+		    saved_can_desegment, saved_layers_len, saved_tree_count)) {
+			*heur_dtbl_entry = hint;
+			status = TRUE;
+		}
+	} else {
+		hint = NULL;
+	}
+
+	for (entry = sub_dissectors->dissectors; !status && entry != NULL;
 	    entry = g_slist_next(entry)) {
-		/* XXX - why set this now and above? */
-		pinfo->can_desegment = saved_can_desegment-(saved_can_desegment>0);
 		hdtbl_entry = (heur_dtbl_entry_t *)entry->data;
 
-		if (hdtbl_entry->protocol != NULL &&
-			(!proto_is_protocol_enabled(hdtbl_entry->protocol)||(hdtbl_entry->enabled==FALSE))) {
-			/*
-			 * No - don't try this dissector.
-			 */
+		if (hdtbl_entry == hint) {
+			/* Already tried above */
 			continue;
 		}
 
-		if (hdtbl_entry->protocol != NULL) {
-			proto_id = proto_get_id(hdtbl_entry->protocol);
-			/* do NOT change this behavior - wslua uses the protocol short name set here in order
-			   to determine which Lua-based heurisitc dissector to call */
-			pinfo->current_proto =
-				proto_get_protocol_short_name(hdtbl_entry->protocol);
-
-			/*
-			 * Add the protocol name to the layers; we'll remove it
-			 * if the dissector fails.
-			 */
-			pinfo->curr_layer_num++;
-			wmem_list_append(pinfo->layers, GINT_TO_POINTER(proto_id));
-		}
-
-		pinfo->heur_list_name = hdtbl_entry->list_name;
-
-		len = (hdtbl_entry->dissector)(tvb, pinfo, tree, data);
-		if (hdtbl_entry->protocol != NULL &&
-			(len == 0 || (tree && saved_tree_count == tree->tree_data->count))) {
-			/*
-			 * We added a protocol layer above. The dissector
-			 * didn't accept the packet or it didn't add any
-			 * items to the tree so remove it from the list.
-			 */
-			while (wmem_list_count(pinfo->layers) > saved_layers_len) {
-				if (len == 0) {
-					/*
-					 * Only reduce the layer number if the dissector
-					 * rejected the data. Since tree can be NULL on
-					 * the first pass, we cannot check it or it will
-					 * break dissectors that rely on a stable value.
-					 */
-					pinfo->curr_layer_num--;
-				}
-				wmem_list_remove_frame(pinfo->layers, wmem_list_tail(pinfo->layers));
-			}
-		}
-		if (len) {
+		if (call_heur_dtbl_entry(hdtbl_entry, tvb, pinfo, tree, data,
+		    saved_can_desegment, saved_layers_len, saved_tree_count)) {
 			*heur_dtbl_entry = hdtbl_entry;
 			status = TRUE;
-			break;
 		}
 	}
 
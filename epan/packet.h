@@ -276,6 +276,21 @@ WS_DLL_PUBLIC dissector_handle_t dissector_get_uint_handle(
 WS_DLL_PUBLIC dissector_handle_t dissector_get_default_uint_handle(
     const char *name, const guint32 uint_val);
 
+/** Find out whether any dissector looked up a value in a uint dissector
+ * table.  Only FT_UINT8 and FT_UINT16 tables keep track of this; for
+ * other tables, and for values that don't fit the table's type, the
+ * answer is always TRUE.
+ *
+ * If it is FALSE, changing the table's entry for the value doesn't change
+ * the dissection of any packet dissected so far.
+ *
+ * @param[in] name Dissector table name.
+ * @param[in] uint_val Value to check, e.g. a port number.
+ * @return FALSE if the value was never looked up while dissecting.
+ */
+WS_DLL_PUBLIC gboolean dissector_uint_pattern_consulted(const char *name,
+    const guint32 uint_val);
+
 /* Add an entry to a string dissector table. */
 WS_DLL_PUBLIC void dissector_add_string(const char *name, const gchar *pattern,
     dissector_handle_t handle);
@@ -488,6 +503,24 @@ WS_DLL_PUBLIC gboolean has_heur_dissector_list(const gchar *name);
 WS_DLL_PUBLIC gboolean dissector_try_heuristic(heur_dissector_list_t sub_dissectors,
     tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t **hdtbl_entry, void *data);
 
+/** Like dissector_try_heuristic(), but try one heuristic dissector, typically
+ * the one that accepted an earlier packet of the same conversation, before
+ * the others. The rest of the list is tried in the usual order.
+ *
+ * @param sub_dissectors the sub-dissector list
+ * @param tvb the tvbuff with the (remaining) packet data
+ * @param pinfo the packet info of this packet (additional info)
+ * @param tree the protocol tree to be build or NULL
+ * @param hint the heuristic dissector to try first, or NULL; it is ignored
+ * if it is no longer in the list
+ * @param hdtbl_entry returns the last tried dissector
+ * @param data parameter to pass to subdissector
+ * @return TRUE if the packet was recognized by the sub-dissector (stop dissection here)
+ */
+WS_DLL_PUBLIC gboolean dissector_try_heuristic_hinted(heur_dissector_list_t sub_dissectors,
+    tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree, heur_dtbl_entry_t *hint,
+    heur_dtbl_entry_t **hdtbl_entry, void *data);
+
 /** Find a heuristic dissector table by table name.
  *
  * @param name name of the dissector table
@@ -607,6 +640,49 @@ WS_DLL_PUBLIC int call_dissector_only(dissector_handle_t handle, tvbuff_t *tvb,
 WS_DLL_PUBLIC void call_heur_dissector_direct(heur_dtbl_entry_t *heur_dtbl_entry, tvbuff_t *tvb,
     packet_info *pinfo, proto_tree *tree, void *data);
 
+/** Time spent in, and data handled by, the dissector behind one handle. */
+typedef struct {
+	guint64	calls;			/**< Number of times it was called */
+	guint64	bytes;			/**< Sum of the reported lengths of the tvbuffs it got */
+	gint64	inclusive_usecs;	/**< Time spent in it and the dissectors it called */
+	gint64	exclusive_usecs;	/**< Time spent in it alone */
+} dissector_profile_t;
+
+/** Start or stop measuring the dissectors called through handles.
+ * Measuring is off by default; while it is, calling a dissector
+ * costs one extra test.  Heuristic dissectors called directly,
+ * rather than through a handle, are not measured.
+ */
+WS_DLL_PUBLIC void set_dissector_profiling(gboolean enable);
+
+/** Discard the measurements made so far. */
+WS_DLL_PUBLIC void dissector_profile_reset(void);
+
+typedef void (*dissector_profile_func)(const char *name, const dissector_profile_t *profile,
+    gpointer user_data);
+
+/** Call func for every dissector that was called while measuring.
+ * name is the dissector name, or the protocol's short name for an
+ * unregistered handle.
+ */
+WS_DLL_PUBLIC void dissector_profile_foreach(dissector_profile_func func, gpointer user_data);
+
+/** Lookups in one uint dissector table, counted while measuring. */
+typedef struct {
+	guint64	lookups;		/**< Number of patterns looked up */
+	guint64	hits;			/**< Lookups that found an entry */
+	guint64	indexed;		/**< Lookups answered without a hash lookup */
+} dissector_table_profile_t;
+
+typedef void (*dissector_table_profile_func)(const char *table_name,
+    const dissector_table_profile_t *profile, gpointer user_data);
+
+/** Call func for every uint dissector table that was searched while
+ * measuring.  dissector_profile_reset() clears these counts too.
+ */
+WS_DLL_PUBLIC void dissector_table_profile_foreach(dissector_table_profile_func func,
+    gpointer user_data);
+
 /* This is opaque outside of "packet.c". */
 struct depend_dissector_list;
 typedef struct depend_dissector_list *depend_dissector_list_t;
@@ -2356,6 +2356,14 @@ stats_callback(void)
     }
 }
 
+static void
+capture_callback(void)
+{
+    /* dumpcap only takes a positive update interval */
+    if (prefs.capture_update_interval < 1)
+        prefs.capture_update_interval = 1;
+}
+
 static void
 gui_callback(void)
 {
@@ -3394,6 +3402,19 @@ prefs_register_modules(void)
                                    "Show the intelligent scroll bar (a minimap of packet list colors in the scrollbar)",
                                    &prefs.gui_packet_list_show_minimap);
 
+    prefs_register_uint_preference(gui_module, "packet_list_cached_rows.max",
+                                   "Maximum number of cached rows",
+                                   "Maximum number of rows whose column text is kept in the packet list. "
+                                   "Rows beyond this limit are dissected again when they are needed. "
+                                   "Set to 0 for no limit.",
+                                   10,
+                                   &prefs.gui_packet_list_cached_rows_max);
+
+    prefs_register_bool_preference(gui_module, "graph_fast_rendering",
+                                   "Draw graphs without antialiasing",
+                                   "Draw the lines and points of the I/O, TCP stream, RTP player and LTE RLC graphs "
+                                   "without antialiasing, which makes panning and zooming large graphs much faster.",
+                                   &prefs.gui_graph_fast_rendering);
 
     prefs_register_bool_preference(gui_module, "interfaces_show_hidden",
                                    "Show hidden interfaces",
@@ -3459,7 +3480,7 @@ prefs_register_modules(void)
      * preference "string compare list" in set_pref()
      */
     capture_module = prefs_register_module(NULL, "capture", "Capture",
-        "Capture preferences", NULL, FALSE);
+        "Capture preferences", &capture_callback, FALSE);
     /* Capture preferences don't affect dissection */
     prefs_set_module_effect_flags(capture_module, PREF_EFFECT_CAPTURE);
 
@@ -3521,6 +3542,18 @@ prefs_register_modules(void)
     prefs_register_bool_preference(capture_module, "show_info", "Show capture information dialog while capturing",
         "Show capture information dialog while capturing?", &prefs.capture_show_info);
 
+    prefs_register_uint_preference(capture_module, "update_interval",
+        "Update interval in ms",
+        "How often the capture child reports new packets, and so how often the "
+        "packet list is updated during a live capture.",
+        10, &prefs.capture_update_interval);
+
+    prefs_register_uint_preference(capture_module, "info_sample_rate",
+        "Capture information sampling rate (packets/s)",
+        "Above this many packets per second, the capture information dialog only dissects a sample "
+        "of the packets and estimates the protocol counts from it. 0 dissects every packet.",
+        10, &prefs.capture_info_sample_rate);
+
     prefs_register_obsolete_preference(capture_module, "syntax_check_filter");
 
     custom_cbs.free_cb = capture_column_free_cb;
@@ -3659,6 +3692,21 @@ prefs_register_modules(void)
                                    "Currently only ICMP and ICMPv6 use this preference to add VLAN ID to conversation tracking",
                                    &prefs.strict_conversation_tracking_heuristics);
 
+    prefs_register_uint_preference(protocols_module, "reassembly_max_age_frames",
+                                   "Discard unfinished reassemblies after this many frames",
+                                   "Fragments of a reassembly that has had no new fragment for this many frames "
+                                   "are discarded, so that long captures with lost fragments don't use ever more memory. "
+                                   "0 keeps them for the life of the file.",
+                                   10,
+                                   &prefs.reassembly_max_age_frames);
+
+    prefs_register_uint_preference(protocols_module, "reassembly_max_age_secs",
+                                   "Discard unfinished reassemblies after this many seconds",
+                                   "Fragments of a reassembly that has had no new fragment for this many seconds "
+                                   "of capture time are discarded. 0 keeps them for the life of the file.",
+                                   10,
+                                   &prefs.reassembly_max_age_secs);
+
     /* Obsolete preferences
      * These "modules" were reorganized/renamed to correspond to their GUI
      * configuration screen within the preferences dialog
@@ -4107,6 +4155,8 @@ pre_init_prefs(void)
     prefs.gui_packet_list_elide_mode = ELIDE_RIGHT;
     prefs.gui_packet_list_show_related = TRUE;
     prefs.gui_packet_list_show_minimap = TRUE;
+    prefs.gui_packet_list_cached_rows_max = 0;
+    prefs.gui_graph_fast_rendering = FALSE;
     g_free (prefs.gui_interfaces_hide_types);
     prefs.gui_interfaces_hide_types = g_strdup("");
     prefs.gui_interfaces_show_hidden = FALSE;
@@ -4142,6 +4192,8 @@ pre_init_prefs(void)
     prefs.capture_no_extcap             = FALSE;
     prefs.capture_auto_scroll           = TRUE;
     prefs.capture_show_info             = FALSE;
+    prefs.capture_info_sample_rate      = 20000;
+    prefs.capture_update_interval       = DEFAULT_UPDATE_INTERVAL;
 
     if (!prefs.capture_columns) {
         /* First time through */
@@ -4168,6 +4220,8 @@ pre_init_prefs(void)
     prefs.st_sort_showfullname = FALSE;
     prefs.display_hidden_proto_items = FALSE;
     prefs.display_byte_fields_with_spaces = FALSE;
+    prefs.reassembly_max_age_frames = 0;
+    prefs.reassembly_max_age_secs = 0;
 }
 
 /*
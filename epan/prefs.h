@@ -30,6 +30,8 @@ extern "C" {
 #define MAX_VAL_LEN  1024
 
 #define TAP_UPDATE_DEFAULT_INTERVAL 3000
+/* Default time in ms between reports of new packets from the capture child. */
+#define DEFAULT_UPDATE_INTERVAL 100
 #define ST_DEF_BURSTRES 5
 #define ST_DEF_BURSTLEN 100
 #define ST_MAX_BURSTRES 600000 /* somewhat arbirary limit of 10 minutes */
@@ -195,6 +197,8 @@ typedef struct _e_prefs {
   gboolean     capture_no_interface_load;
   gboolean     capture_no_extcap;
   gboolean     capture_show_info;
+  guint        capture_update_interval;
+  guint        capture_info_sample_rate;
   GList       *capture_columns;
   guint        tap_update_interval;
   gboolean     display_hidden_proto_items;
@@ -202,6 +206,8 @@ typedef struct _e_prefs {
   gboolean     enable_incomplete_dissectors_check;
   gboolean     incomplete_dissectors_check_debug;
   gboolean     strict_conversation_tracking_heuristics;
+  guint        reassembly_max_age_frames;
+  guint        reassembly_max_age_secs;
   gboolean     filter_expressions_old;  /* TRUE if old filter expressions preferences were loaded. */
   gboolean     gui_update_enabled;
   software_update_channel_e gui_update_channel;
@@ -216,6 +222,8 @@ typedef struct _e_prefs {
   elide_mode_e gui_packet_list_elide_mode;
   gboolean     gui_packet_list_show_related;
   gboolean     gui_packet_list_show_minimap;
+  guint        gui_packet_list_cached_rows_max;
+  gboolean     gui_graph_fast_rendering;
   gboolean     st_enable_burstinfo;
   gboolean     st_burst_showcount;
   gint         st_burst_resolution;
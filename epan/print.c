@@ -78,6 +78,8 @@ struct _output_fields {
     gchar         aggregator;
     GPtrArray    *fields;
     GHashTable   *field_indicies;
+    GHashTable   *field_indicies_by_id; /* hf id -> field_indicies value (NULL if not wanted), filled in as fields are met */
+    GArray       *field_hfids;          /* hf ids to prime when the tree isn't visible */
     GPtrArray   **field_values;
     gchar         quote;
     gboolean      includes_col_fields;
@@ -98,6 +100,7 @@ static void write_specified_fields(fields_format format,
                                    FILE *fh,
                                    json_dumper *dumper);
 static void print_escaped_xml(FILE *fh, const char *unescaped_string);
+static const gchar *pdml_escaped_abbrev(header_field_info *hfinfo);
 static void print_escaped_csv(FILE *fh, const char *unescaped_string);
 
 typedef void (*proto_node_value_writer)(proto_node *, write_json_data *);
@@ -503,7 +506,7 @@ proto_tree_write_node_pdml(proto_node *node, gpointer data)
         else {
             fputs("<field name=\"", pdata->fh);
         }
-        print_escaped_xml(pdata->fh, fi->hfinfo->abbrev);
+        fputs(pdml_escaped_abbrev(fi->hfinfo), pdata->fh);
 
 #if 0
         /* PDML spec, see:
@@ -647,7 +650,7 @@ proto_tree_write_node_pdml(proto_node *node, gpointer data)
 
             /* print dummy field */
             fputs("<field name=\"filtered\" value=\"", pdata->fh);
-            print_escaped_xml(pdata->fh, fi->hfinfo->abbrev);
+            fputs(pdml_escaped_abbrev(fi->hfinfo), pdata->fh);
             fputs("\" />\n", pdata->fh);
         }
     }
@@ -1728,44 +1731,106 @@ get_field_data(GSList *src_list, field_info *fi)
     return NULL;  /* not found */
 }
 
+/*
+ * Returns the escaped form of a character that can't appear as is in
+ * PDML, or NULL if it can.
+ */
+static const char *
+xml_escape_char(char c, char temp_str[8])
+{
+    switch (c) {
+    case '&':
+        return "&amp;";
+    case '<':
+        return "&lt;";
+    case '>':
+        return "&gt;";
+    case '"':
+        return "&quot;";
+    case '\'':
+        return "&#x27;";
+    default:
+        if (g_ascii_isprint(c))
+            return NULL;
+        g_snprintf(temp_str, 8, "\\x%x", (guint8)c);
+        return temp_str;
+    }
+}
+
 /* Print a string, escaping out certain characters that need to
  * escaped out for XML. */
 static void
 print_escaped_xml(FILE *fh, const char *unescaped_string)
 {
     const char *p;
+    const char *run;
+    const char *escaped;
     char        temp_str[8];
 
     if (fh == NULL || unescaped_string == NULL) {
         return;
     }
 
+    /* Write runs of characters that need no escaping with one fwrite() */
+    run = unescaped_string;
     for (p = unescaped_string; *p != '\0'; p++) {
-        switch (*p) {
-        case '&':
-            fputs("&amp;", fh);
-            break;
-        case '<':
-            fputs("&lt;", fh);
-            break;
-        case '>':
-            fputs("&gt;", fh);
-            break;
-        case '"':
-            fputs("&quot;", fh);
-            break;
-        case '\'':
-            fputs("&#x27;", fh);
-            break;
-        default:
-            if (g_ascii_isprint(*p))
-                fputc(*p, fh);
-            else {
-                g_snprintf(temp_str, sizeof(temp_str), "\\x%x", (guint8)*p);
-                fputs(temp_str, fh);
-            }
+        escaped = xml_escape_char(*p, temp_str);
+        if (escaped != NULL) {
+            if (p > run)
+                fwrite(run, 1, p - run, fh);
+            fputs(escaped, fh);
+            run = p + 1;
         }
     }
+    if (p > run)
+        fwrite(run, 1, p - run, fh);
+}
+
+/*
+ * Field abbreviations are escaped once and kept, indexed by hf id,
+ * as every node of every packet writes one.  The abbreviation pointer
+ * is kept as well so a slot is rebuilt if the id is registered again.
+ */
+typedef struct {
+    const char *abbrev;
+    gchar      *escaped;
+} pdml_abbrev_t;
+
+static GArray *pdml_abbrevs;
+
+static const gchar *
+pdml_escaped_abbrev(header_field_info *hfinfo)
+{
+    pdml_abbrev_t *entry;
+    GString       *str;
+    const char    *p;
+    const char    *escaped;
+    char           temp_str[8];
+
+    if (hfinfo->id < 0)
+        return hfinfo->abbrev;
+
+    if (pdml_abbrevs == NULL)
+        pdml_abbrevs = g_array_new(FALSE, TRUE, sizeof(pdml_abbrev_t));
+    if ((guint)hfinfo->id >= pdml_abbrevs->len)
+        g_array_set_size(pdml_abbrevs, hfinfo->id + 1);
+
+    entry = &g_array_index(pdml_abbrevs, pdml_abbrev_t, hfinfo->id);
+    if (entry->abbrev != hfinfo->abbrev || entry->escaped == NULL) {
+        str = g_string_sized_new(strlen(hfinfo->abbrev));
+        for (p = hfinfo->abbrev; *p != '\0'; p++) {
+            escaped = xml_escape_char(*p, temp_str);
+            if (escaped != NULL)
+                g_string_append(str, escaped);
+            else
+                g_string_append_c(str, *p);
+        }
+        g_free(entry->escaped);
+        entry->escaped = g_string_free(str, FALSE);
+        entry->abbrev = hfinfo->abbrev;
+    }
+
+    return entry->escaped;
 }
 
 static void
@@ -1818,10 +1883,21 @@ pdml_write_field_hex_value(write_pdml_data *pdata, field_info *fi)
     pd = get_field_data(pdata->src_list, fi);
 
     if (pd) {
-        /* Print a simple hex dump */
+        static const char hex[] = "0123456789abcdef";
+        char              hex_buf[256];
+        int               pos = 0;
+
+        /* Print a simple hex dump, a buffer at a time */
         for (i = 0 ; i < fi->length; i++) {
-            fprintf(pdata->fh, "%02x", pd[i]);
+            hex_buf[pos++] = hex[pd[i] >> 4];
+            hex_buf[pos++] = hex[pd[i] & 0x0f];
+            if (pos == sizeof hex_buf) {
+                fwrite(hex_buf, 1, pos, pdata->fh);
+                pos = 0;
+            }
         }
+        if (pos > 0)
+            fwrite(hex_buf, 1, pos, pdata->fh);
     }
 }
 
@@ -2027,6 +2103,14 @@ void output_fields_free(output_fields_t* fields)
             g_hash_table_destroy(fields->field_indicies);
         }
 
+        if (NULL != fields->field_indicies_by_id) {
+            g_hash_table_destroy(fields->field_indicies_by_id);
+        }
+
+        if (NULL != fields->field_hfids) {
+            g_array_free(fields->field_hfids, TRUE);
+        }
+
         if (NULL != fields->field_values) {
             g_free(fields->field_values);
         }
@@ -2093,6 +2177,77 @@ output_fields_valid(output_fields_t *fields)
     return invalid_fields;
 }
 
+/*
+ * Fields whose value is printed from the item's text label need a
+ * visible tree, as that text is only filled in for visible trees.
+ */
+static gboolean
+output_field_needs_label(header_field_info *hfinfo)
+{
+    return (hfinfo->id == hf_text_only || hfinfo->type == FT_PROTOCOL);
+}
+
+gboolean
+output_fields_need_visible_tree(output_fields_t *fields)
+{
+    gsize i;
+
+    if (fields->fields == NULL) {
+        return FALSE;
+    }
+
+    for (i = 0; i < fields->fields->len; i++) {
+        const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+        header_field_info *hfinfo;
+
+        if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+            continue;
+
+        hfinfo = proto_registrar_get_byname(field);
+        if (hfinfo == NULL) {
+            return TRUE;
+        }
+        /* Fields sharing a name are all printed, so check every one of them. */
+        for (; hfinfo != NULL; hfinfo = hfinfo->same_name_prev_id != -1 ?
+                 proto_registrar_get_nth(hfinfo->same_name_prev_id) : NULL) {
+            if (output_field_needs_label(hfinfo)) {
+                return TRUE;
+            }
+        }
+    }
+
+    return FALSE;
+}
+
+void
+output_fields_prime_edt(output_fields_t *fields, epan_dissect_t *edt)
+{
+    if (fields->fields == NULL) {
+        return;
+    }
+
+    if (fields->field_hfids == NULL) {
+        gsize i;
+
+        fields->field_hfids = g_array_new(FALSE, FALSE, sizeof(int));
+        for (i = 0; i < fields->fields->len; i++) {
+            const gchar *field = (const gchar *)g_ptr_array_index(fields->fields, i);
+            header_field_info *hfinfo;
+
+            if (!strncmp(field, COLUMN_FIELD_FILTER, strlen(COLUMN_FIELD_FILTER)))
+                continue;
+
+            for (hfinfo = proto_registrar_get_byname(field); hfinfo != NULL;
+                 hfinfo = hfinfo->same_name_prev_id != -1 ?
+                     proto_registrar_get_nth(hfinfo->same_name_prev_id) : NULL) {
+                g_array_append_val(fields->field_hfids, hfinfo->id);
+            }
+        }
+    }
+
+    epan_dissect_prime_with_hfid_array(edt, fields->field_hfids);
+}
+
 gboolean output_fields_set_option(output_fields_t *info, gchar *option)
 {
     const gchar *option_name;
@@ -2329,7 +2484,17 @@ static void proto_tree_get_node_field_values(proto_node *node, gpointer data)
     /* dissection with an invisible proto tree? */
     g_assert(fi);
 
-    field_index = g_hash_table_lookup(call_data->fields->field_indicies, fi->hfinfo->abbrev);
+    /*
+     * Every node of the tree is checked, so remember for each hf id
+     * whether it's wanted rather than hashing its abbreviation again
+     * for every occurrence.
+     */
+    if (!g_hash_table_lookup_extended(call_data->fields->field_indicies_by_id,
+                                      GINT_TO_POINTER(fi->hfinfo->id), NULL, &field_index)) {
+        field_index = g_hash_table_lookup(call_data->fields->field_indicies, fi->hfinfo->abbrev);
+        g_hash_table_insert(call_data->fields->field_indicies_by_id,
+                            GINT_TO_POINTER(fi->hfinfo->id), field_index);
+    }
     if (NULL != field_index) {
         format_field_values(call_data->fields, field_index,
                             get_node_field_value(fi, call_data->edt) /* g_ alloc'd string */
@@ -2378,6 +2543,7 @@ static void write_specified_fields(fields_format format, output_fields_t *fields
             ++i;
             g_hash_table_insert(fields->field_indicies, field, GUINT_TO_POINTER(i));
         }
+        fields->field_indicies_by_id = g_hash_table_new(g_direct_hash, g_direct_equal);
     }
 
     /* Array buffer to store values for this packet              */
@@ -2664,6 +2830,8 @@ output_fields_t* output_fields_new(void)
     fields->aggregator          = ',';
     fields->fields              = NULL; /*Do lazy initialisation */
     fields->field_indicies      = NULL;
+    fields->field_indicies_by_id = NULL;
+    fields->field_hfids         = NULL;
     fields->field_values        = NULL;
     fields->quote               ='\0';
     fields->includes_col_fields = FALSE;
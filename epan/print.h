@@ -71,6 +71,14 @@ WS_DLL_PUBLIC gboolean output_fields_set_option(output_fields_t* info, gchar* op
 WS_DLL_PUBLIC void output_fields_list_options(FILE *fh);
 WS_DLL_PUBLIC gboolean output_fields_has_cols(output_fields_t* info);
 
+/*
+ * TRUE if some of the fields can only be printed from a visible tree;
+ * otherwise the fields can be extracted from a tree that isn't visible
+ * once output_fields_prime_edt() has primed it for each packet.
+ */
+WS_DLL_PUBLIC gboolean output_fields_need_visible_tree(output_fields_t* info);
+WS_DLL_PUBLIC void output_fields_prime_edt(output_fields_t* info, epan_dissect_t *edt);
+
 /*
  * Higher-level packet-printing code.
  */
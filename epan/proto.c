@@ -21,6 +21,7 @@
 #include <wsutil/sign_ext.h>
 #include <wsutil/utf8_entities.h>
 #include <wsutil/json_dumper.h>
+#include <wsutil/startup_timings.h>
 
 #include <ftypes/ftypes-int.h>
 
@@ -369,11 +370,19 @@ static GHashTable* prefixes = NULL;
 	DISSECTOR_ASSERT_HINT(gpa_hfinfo.hfi[hfindex] != NULL, "Unregistered hf!");	\
 	hfinfo = gpa_hfinfo.hfi[hfindex];
 
-/* List which stores protocols and fields that have been registered */
+/* List which stores protocols and fields that have been registered
+ *
+ * Note that this can't be saved and mapped back in on a later run in
+ * place of registering: the header_field_info structures belong to the
+ * dissectors, point to their value_strings and other static data
+ * (whose addresses change from run to run), and registration has to
+ * fill in the dissectors' hf_ variables anyway; plugins and preferences
+ * can also change the set of fields between runs. */
 typedef struct _gpa_hfinfo_t {
 	guint32             len;
 	guint32             allocated_len;
 	header_field_info **hfi;
+	value_string_ext  **auto_vse;	/* Indexed forms of large value_strings, by field id */
 } gpa_hfinfo_t;
 
 static gpa_hfinfo_t gpa_hfinfo;
@@ -460,6 +469,10 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	   register_cb cb,
 	   gpointer client_data)
 {
+#ifdef HAVE_PLUGINS
+	gint64 start;
+#endif
+
 	proto_cleanup_base();
 
 	proto_names        = g_hash_table_new(g_str_hash, g_str_equal);
@@ -469,6 +482,7 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	gpa_hfinfo.len           = 0;
 	gpa_hfinfo.allocated_len = 0;
 	gpa_hfinfo.hfi           = NULL;
+	gpa_hfinfo.auto_vse      = NULL;
 	gpa_name_map             = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, save_same_name_hfinfo);
 	gpa_protocol_aliases     = g_hash_table_new(g_str_hash, g_str_equal);
 	deregistered_fields      = g_ptr_array_new();
@@ -506,7 +520,9 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	/* Now call the registration routines for all dissector plugins. */
 	if (cb)
 		(*cb)(RA_PLUGIN_REGISTER, NULL, client_data);
+	start = g_get_monotonic_time();
 	g_slist_foreach(dissector_plugins, call_plugin_register_protoinfo, NULL);
+	startup_timing_record("plugin_register", NULL, g_get_monotonic_time() - start);
 #endif
 
 	/* Now call the "handoff registration" routines of all built-in
@@ -524,7 +540,9 @@ proto_init(GSList *register_all_plugin_protocols_list,
 	/* Now do the same with dissector plugins. */
 	if (cb)
 		(*cb)(RA_PLUGIN_HANDOFF, NULL, client_data);
+	start = g_get_monotonic_time();
 	g_slist_foreach(dissector_plugins, call_plugin_register_handoff, NULL);
+	startup_timing_record("plugin_handoff", NULL, g_get_monotonic_time() - start);
 #endif
 
 	/* sort the protocols by protocol name */
@@ -598,6 +616,8 @@ proto_cleanup_base(void)
 		gpa_hfinfo.allocated_len = 0;
 		g_free(gpa_hfinfo.hfi);
 		gpa_hfinfo.hfi           = NULL;
+		g_free(gpa_hfinfo.auto_vse);
+		gpa_hfinfo.auto_vse      = NULL;
 	}
 
 	if (deregistered_fields) {
@@ -701,10 +721,8 @@ proto_tree_children_foreach(proto_tree *tree, proto_tree_foreach_func func,
 }
 
 static void
-free_GPtrArray_value(gpointer key, gpointer value, gpointer user_data _U_)
+unreference_hfid(gint hfid)
 {
-	GPtrArray         *ptrs = (GPtrArray *)value;
-	gint               hfid = GPOINTER_TO_UINT(key);
 	header_field_info *hfinfo;
 
 	PROTO_REGISTRAR_GET_NTH(hfid, hfinfo);
@@ -720,8 +738,29 @@ free_GPtrArray_value(gpointer key, gpointer value, gpointer user_data _U_)
 		}
 		hfinfo->ref_type = HF_REF_TYPE_NONE;
 	}
+}
 
-	g_ptr_array_free(ptrs, TRUE);
+static void
+free_GPtrArray_value(gpointer key, gpointer value, gpointer user_data _U_)
+{
+	unreference_hfid(GPOINTER_TO_UINT(key));
+	g_ptr_array_free((GPtrArray *)value, TRUE);
+}
+
+/* Like free_GPtrArray_value, but keeps the emptied array in the tree's
+ * list of spare arrays, so that the next packet doesn't have to allocate
+ * a new array for each interesting field. */
+static void
+recycle_GPtrArray_value(gpointer key, gpointer value, gpointer user_data)
+{
+	GPtrArray   *ptrs = (GPtrArray *)value;
+	tree_data_t *tree_data = (tree_data_t *)user_data;
+
+	unreference_hfid(GPOINTER_TO_UINT(key));
+	g_ptr_array_set_size(ptrs, 0);
+	if (tree_data->spare_finfo_arrays == NULL)
+		tree_data->spare_finfo_arrays = g_ptr_array_new();
+	g_ptr_array_add(tree_data->spare_finfo_arrays, ptrs);
 }
 
 static void
@@ -743,9 +782,10 @@ proto_tree_reset(proto_tree *tree)
 
 	/* free tree data */
 	if (tree_data->interesting_hfids) {
-		/* Free all the GPtrArray's in the interesting_hfids hash. */
+		/* Empty all the GPtrArray's in the interesting_hfids hash
+		 * and keep them for the next packet. */
 		g_hash_table_foreach(tree_data->interesting_hfids,
-			free_GPtrArray_value, NULL);
+			recycle_GPtrArray_value, tree_data);
 
 		/* And then remove all values. */
 		g_hash_table_remove_all(tree_data->interesting_hfids);
@@ -775,6 +815,12 @@ proto_tree_free(proto_tree *tree)
 		g_hash_table_destroy(tree_data->interesting_hfids);
 	}
 
+	if (tree_data->spare_finfo_arrays) {
+		g_ptr_array_foreach(tree_data->spare_finfo_arrays,
+			(GFunc)g_ptr_array_unref, NULL);
+		g_ptr_array_free(tree_data->spare_finfo_arrays, TRUE);
+	}
+
 	g_slice_free(tree_data_t, tree_data);
 
 	g_slice_free(proto_tree, tree);
@@ -2305,8 +2351,13 @@ tree_data_add_maybe_interesting_field(tree_data_t *tree_data, field_info *fi)
 		}
 
 		if (!ptrs) {
-			/* First element triggers the creation of pointer array */
-			ptrs = g_ptr_array_new();
+			/* First element triggers the creation of pointer array,
+			 * or the reuse of one from an earlier packet. */
+			if (tree_data->spare_finfo_arrays && tree_data->spare_finfo_arrays->len > 0)
+				ptrs = (GPtrArray *)g_ptr_array_remove_index_fast(tree_data->spare_finfo_arrays,
+						tree_data->spare_finfo_arrays->len - 1);
+			else
+				ptrs = g_ptr_array_new();
 			g_hash_table_insert(tree_data->interesting_hfids,
 					    GINT_TO_POINTER(hfinfo->id), ptrs);
 		}
@@ -6618,6 +6669,7 @@ proto_tree_create_root(packet_info *pinfo)
 
 	/* Don't initialize the tree_data_t. Wait until we know we need it */
 	pnode->tree_data->interesting_hfids = NULL;
+	pnode->tree_data->spare_finfo_arrays = NULL;
 
 	/* Set the default to FALSE so it's easier to
 	 * find errors; if we expect to see the protocol tree
@@ -7605,6 +7657,11 @@ free_deregistered_field (gpointer data, gpointer user_data _U_)
 	if (hfi->parent == -1)
 		g_slice_free(header_field_info, hfi);
 
+	if (gpa_hfinfo.auto_vse[hf_id]) {
+		value_string_ext_free(gpa_hfinfo.auto_vse[hf_id]);
+		gpa_hfinfo.auto_vse[hf_id] = NULL;
+	}
+
 	gpa_hfinfo.hfi[hf_id] = NULL; /* Invalidate this hf_id / proto_id */
 }
 
@@ -8261,6 +8318,61 @@ register_string_errors(void)
 }
 
 #define PROTO_PRE_ALLOC_HF_FIELDS_MEM (220000+PRE_ALLOC_EXPERT_FIELDS_MEM)
+
+/* Plain value_strings with at least this many entries are looked up through
+ * an extended value string, which uses an index or a binary search */
+#define PROTO_AUTO_VSE_MIN_ENTRIES 16
+
+/*
+ * If the field has a large plain value_string whose values are strictly
+ * ascending, create an extended value string for it, so that labels don't
+ * have to scan it linearly. The field itself is left alone, as some
+ * dissectors use hfinfo->strings as a value_string directly. Arrays that
+ * aren't sorted are skipped, so that lookups always find the same entry as
+ * try_val_to_str() and the extended value string never falls back to a
+ * linear search (which it warns about).
+ */
+static void
+proto_register_field_auto_vse(header_field_info *hfinfo)
+{
+	const value_string *vs;
+	guint               num_entries;
+
+	if (hfinfo->strings == NULL)
+		return;
+
+	switch (hfinfo->type) {
+
+	case FT_CHAR:
+	case FT_UINT8:
+	case FT_UINT16:
+	case FT_UINT24:
+	case FT_UINT32:
+	case FT_INT8:
+	case FT_INT16:
+	case FT_INT24:
+	case FT_INT32:
+		break;
+
+	default:
+		return;
+	}
+
+	if ((hfinfo->display & (BASE_RANGE_STRING|BASE_EXT_STRING|BASE_VAL64_STRING|BASE_UNIT_STRING)) ||
+	    (hfinfo->display & FIELD_DISPLAY_E_MASK) == BASE_CUSTOM)
+		return;
+
+	vs = (const value_string *)hfinfo->strings;
+	for (num_entries = 0; vs[num_entries].strptr != NULL; num_entries++) {
+		if (num_entries > 0 && vs[num_entries].value <= vs[num_entries - 1].value)
+			return;
+	}
+
+	if (num_entries < PROTO_AUTO_VSE_MIN_ENTRIES)
+		return;
+
+	gpa_hfinfo.auto_vse[hfinfo->id] = value_string_ext_new(vs, num_entries + 1, hfinfo->abbrev);
+}
 static int
 proto_register_field_init(header_field_info *hfinfo, const int parent)
 {
@@ -8276,10 +8388,15 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 		if (!gpa_hfinfo.hfi) {
 			gpa_hfinfo.allocated_len = PROTO_PRE_ALLOC_HF_FIELDS_MEM;
 			gpa_hfinfo.hfi = (header_field_info **)g_malloc(sizeof(header_field_info *)*PROTO_PRE_ALLOC_HF_FIELDS_MEM);
+			gpa_hfinfo.auto_vse = (value_string_ext **)g_malloc0(sizeof(value_string_ext *)*PROTO_PRE_ALLOC_HF_FIELDS_MEM);
 		} else {
 			gpa_hfinfo.allocated_len += 1000;
 			gpa_hfinfo.hfi = (header_field_info **)g_realloc(gpa_hfinfo.hfi,
 						   sizeof(header_field_info *)*gpa_hfinfo.allocated_len);
+			gpa_hfinfo.auto_vse = (value_string_ext **)g_realloc(gpa_hfinfo.auto_vse,
+						   sizeof(value_string_ext *)*gpa_hfinfo.allocated_len);
+			memset(&gpa_hfinfo.auto_vse[gpa_hfinfo.len], 0,
+			       sizeof(value_string_ext *)*(gpa_hfinfo.allocated_len - gpa_hfinfo.len));
 			/*g_warning("gpa_hfinfo.allocated_len %u", gpa_hfinfo.allocated_len);*/
 		}
 	}
@@ -8287,6 +8404,8 @@ proto_register_field_init(header_field_info *hfinfo, const int parent)
 	gpa_hfinfo.len++;
 	hfinfo->id = gpa_hfinfo.len - 1;
 
+	proto_register_field_auto_vse(hfinfo);
+
 	/* if we have real names, enter this field in the name tree */
 	if ((hfinfo->name[0] != 0) && (hfinfo->abbrev[0] != 0 )) {
 
@@ -8865,6 +8984,15 @@ hf_try_val_to_str(guint32 value, const header_field_info *hfinfo)
 	if (hfinfo->display & BASE_UNIT_STRING)
 		return unit_name_string_get_value(value, (const struct unit_name_string*) hfinfo->strings);
 
+	/* Use the extended form created at registration, unless the
+	 * dissector has switched to another value_string since. */
+	if ((guint)hfinfo->id < gpa_hfinfo.len) {
+		value_string_ext *vse = gpa_hfinfo.auto_vse[hfinfo->id];
+
+		if (vse && vse->_vs_p == (const value_string *) hfinfo->strings)
+			return try_val_to_str_ext(value, vse);
+	}
+
 	return try_val_to_str(value, (const value_string *) hfinfo->strings);
 }
 
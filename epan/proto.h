@@ -777,6 +777,7 @@ typedef struct
  * in the protocol tree points to the same copy. */
 typedef struct {
     GHashTable          *interesting_hfids;
+    GPtrArray           *spare_finfo_arrays; /**< emptied interesting_hfids arrays, for reuse */
     gboolean             visible;
     gboolean             fake_protocols;
     gint                 count;
@@ -14,7 +14,9 @@
 
 #include <epan/packet.h>
 #include <epan/exceptions.h>
+#include <epan/prefs.h>
 #include <epan/reassemble.h>
+#include <epan/show_exception.h>
 #include <epan/tvbuff-int.h>
 
 #include <wsutil/str_util.h>
@@ -341,6 +343,128 @@ free_all_fragments(gpointer key_arg _U_, gpointer value, gpointer user_data _U_)
 	return TRUE;
 }
 
+/*
+ * Aging of unfinished reassemblies.
+ *
+ * In a long capture with lost fragments, reassemblies that will never
+ * finish would otherwise be kept for the life of the file. If the
+ * "protocols.reassembly_max_age_frames" or "protocols.reassembly_max_age_secs"
+ * preference is set, each table is checked every AGE_CHECK_INTERVAL frames
+ * on the first pass, and reassemblies with no fragment newer than the limit
+ * are discarded. The frames of their fragments are remembered, so that
+ * dissecting them again can say why they were never reassembled.
+ */
+#define AGE_CHECK_INTERVAL	1024
+
+/*
+ * Capture time of some of the frames seen by the checks, oldest first,
+ * to turn the age limit in seconds into a frame number.
+ */
+typedef struct {
+	guint32 frame;
+	time_t secs;
+} age_sample_t;
+
+static GArray *age_samples = NULL;
+
+/* Frames with fragments of reassemblies that were discarded */
+static GHashTable *evicted_frames = NULL;
+
+typedef struct {
+	reassembly_table *table;
+	guint32 oldest_frame;	/* reassemblies last added to before this are discarded */
+} age_check_t;
+
+/*
+ * Return the first frame whose fragments are still recent enough to
+ * keep, or 0 if everything is.
+ */
+static guint32
+oldest_frame_to_keep(const packet_info *pinfo)
+{
+	guint32 oldest = 0;
+
+	if (prefs.reassembly_max_age_frames != 0 &&
+	    pinfo->num > prefs.reassembly_max_age_frames)
+		oldest = pinfo->num - prefs.reassembly_max_age_frames;
+
+	if (prefs.reassembly_max_age_secs != 0) {
+		age_sample_t sample;
+		guint i, too_old = 0;
+
+		if (age_samples == NULL)
+			age_samples = g_array_new(FALSE, FALSE, sizeof(age_sample_t));
+		if (age_samples->len == 0 ||
+		    g_array_index(age_samples, age_sample_t, age_samples->len - 1).frame < pinfo->num) {
+			sample.frame = pinfo->num;
+			sample.secs = pinfo->abs_ts.secs;
+			g_array_append_val(age_samples, sample);
+		}
+
+		/* Find the newest sample that is too old */
+		for (i = 0; i < age_samples->len; i++) {
+			if (g_array_index(age_samples, age_sample_t, i).secs + (time_t)prefs.reassembly_max_age_secs > pinfo->abs_ts.secs)
+				break;
+			too_old = i + 1;
+		}
+		if (too_old != 0) {
+			guint32 frame = g_array_index(age_samples, age_sample_t, too_old - 1).frame;
+
+			if (frame > oldest)
+				oldest = frame;
+			/* The older samples won't be needed again */
+			g_array_remove_range(age_samples, 0, too_old - 1);
+		}
+	}
+
+	return oldest;
+}
+
+static gboolean
+evict_fragment_head(gpointer key, gpointer value, gpointer user_data)
+{
+	age_check_t *check = (age_check_t *)user_data;
+	fragment_head *fd_head = (fragment_head *)value;
+	fragment_item *fd;
+
+	/*
+	 * Leave finished reassemblies, and ones that have no fragments
+	 * yet, as there's no telling how old they are.
+	 */
+	if ((fd_head->flags & FD_DEFRAGMENTED) || fd_head->frame == 0 ||
+	    fd_head->frame >= check->oldest_frame)
+		return FALSE;
+
+	if (evicted_frames == NULL)
+		evicted_frames = g_hash_table_new(g_direct_hash, g_direct_equal);
+	for (fd = fd_head->next; fd != NULL; fd = fd->next)
+		g_hash_table_add(evicted_frames, GUINT_TO_POINTER(fd->frame));
+
+	check->table->evicted++;
+	return free_all_fragments(key, value, NULL);
+}
+
+static void
+age_fragment_table(reassembly_table *table, const packet_info *pinfo)
+{
+	age_check_t check;
+
+	if (prefs.reassembly_max_age_frames == 0 && prefs.reassembly_max_age_secs == 0)
+		return;
+	if (pinfo->fd->visited)
+		return;
+	if (pinfo->num >= table->last_age_check &&
+	    pinfo->num - table->last_age_check < AGE_CHECK_INTERVAL)
+		return;
+	table->last_age_check = pinfo->num;
+
+	check.table = table;
+	check.oldest_frame = oldest_frame_to_keep(pinfo);
+	if (check.oldest_frame == 0)
+		return;
+	g_hash_table_foreach_remove(table->fragment_table, evict_fragment_head, &check);
+}
+
 /* ------------------------- */
 static fragment_head *new_head(const guint32 flags)
 {
@@ -435,6 +559,8 @@ reassembly_table_init(reassembly_table *table,
 		table->persistent_key_func = funcs->persistent_key_func;
 	if (table->free_temporary_key_func == NULL)
 		table->free_temporary_key_func = funcs->free_temporary_key_func;
+	table->last_age_check = 0;
+	table->evicted = 0;
 	if (table->fragment_table != NULL) {
 		/*
 		 * The fragment hash table exists.
@@ -543,6 +669,12 @@ lookup_fd_head(reassembly_table *table, const packet_info *pinfo,
 	gpointer key;
 	gpointer value;
 
+	/*
+	 * This is done before the lookup, rather than when inserting,
+	 * because callers hold on to the fd_heads they find.
+	 */
+	age_fragment_table(table, pinfo);
+
 	/* Create key to search hash with */
 	key = table->temporary_key_func(pinfo, id, data);
 
@@ -573,6 +705,8 @@ insert_fd_head(reassembly_table *table, fragment_head *fd_head,
 	 */
 	key = table->persistent_key_func(pinfo, id, data);
 	g_hash_table_insert(table->fragment_table, key, fd_head);
+	if (table->name == NULL)
+		table->name = pinfo->current_proto;
 	return key;
 }
 
@@ -943,12 +1077,21 @@ LINK_FRAG(fragment_head *fd_head,fragment_item *fd)
 	fragment_item *fd_i;
 
 	/* add fragment to list, keep list sorted */
-	for(fd_i= fd_head; fd_i->next;fd_i=fd_i->next) {
-		if (fd->offset < fd_i->next->offset )
-			break;
+	if (fd_head->last && !fd_head->last->next &&
+	    fd_head->last->offset <= fd->offset) {
+		/* Fragments mostly arrive in order; appending after the
+		 * last one linked avoids walking the whole list. */
+		fd_i = fd_head->last;
+	} else {
+		for(fd_i= fd_head; fd_i->next;fd_i=fd_i->next) {
+			if (fd->offset < fd_i->next->offset )
+				break;
+		}
 	}
 	fd->next=fd_i->next;
 	fd_i->next=fd;
+	if (!fd->next)
+		fd_head->last = fd;
 }
 
 static void
@@ -968,6 +1111,22 @@ MERGE_FRAG(fragment_head *fd_head, fragment_item *fd)
 	fd_i->next = fd;
 }
 
+/*
+ * A new fragment with data first refers to it through a subset of the
+ * frame's tvbuff, flagged with FD_SUBSET_TVB so that it isn't freed.  If it
+ * turns out to complete the reassembly, its data is then copied only once,
+ * straight into the reassembled buffer.  Otherwise the data has to outlive
+ * the frame, so it is copied here.
+ */
+static void
+fragment_keep_data(fragment_item *fd, tvbuff_t *tvb, const int offset)
+{
+	if (!(fd->flags & FD_SUBSET_TVB))
+		return;
+	fd->tvb_data = tvb_clone_offset_len(tvb, offset, fd->len);
+	fd->flags &= ~FD_SUBSET_TVB;
+}
+
 /*
  * This function adds a new fragment to the fragment hash table.
  * If this is the first fragment seen for this datagram, a new entry
@@ -1009,6 +1168,7 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->fragment_nr_offset = 0; /* will only be used with sequence */
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
+	fd->last = NULL;
 	fd->error = NULL;
 
 	/*
@@ -1140,7 +1300,12 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 		g_slice_free(fragment_item, fd);
 		THROW(BoundsError);
 	}
-	fd->tvb_data = tvb_clone_offset_len(tvb, offset, fd->len);
+	if (fd->len) {
+		fd->tvb_data = tvb_new_subset_length(tvb, offset, fd->len);
+		fd->flags |= FD_SUBSET_TVB;
+	} else {
+		fd->tvb_data = tvb_clone_offset_len(tvb, offset, fd->len);
+	}
 	LINK_FRAG(fd_head,fd);
 
 
@@ -1148,6 +1313,7 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 		/* if we don't know the datalen, there are still missing
 		 * packets. Cheaper than the check below.
 		 */
+		fragment_keep_data(fd, tvb, offset);
 		return FALSE;
 	}
 
@@ -1176,6 +1342,7 @@ fragment_add_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 		 * amount of data we're trying to reassemble, so we haven't
 		 * received all packets yet.
 		 */
+		fragment_keep_data(fd, tvb, offset);
 		return FALSE;
 	}
 
@@ -1740,6 +1907,7 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 	fd->offset = frag_number_work;
 	fd->len  = frag_data_len;
 	fd->tvb_data = NULL;
+	fd->last = NULL;
 	fd->error = NULL;
 
 	/* fd_head->frame is the maximum of the frame numbers of all the
@@ -1874,7 +2042,8 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 			return FALSE;
 		}
 
-		fd->tvb_data = tvb_clone_offset_len(tvb, offset, fd->len);
+		fd->tvb_data = tvb_new_subset_length(tvb, offset, fd->len);
+		fd->flags |= FD_SUBSET_TVB;
 	}
 	LINK_FRAG(fd_head,fd);
 
@@ -1884,6 +2053,7 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 		 * there are definitely still missing packets. Cheaper than
 		 * the check below.
 		 */
+		fragment_keep_data(fd, tvb, offset);
 		return FALSE;
 	}
 
@@ -1902,6 +2072,7 @@ fragment_add_seq_work(fragment_head *fd_head, tvbuff_t *tvb, const int offset,
 
 	if (max <= fd_head->datalen) {
 		/* we have not received all packets yet */
+		fragment_keep_data(fd, tvb, offset);
 		return FALSE;
 	}
 
@@ -2273,6 +2444,7 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 					}
 				}
 				prev_fd->next = NULL;
+				new_fh->last = NULL;
 				break;
 			}
 		}
@@ -2355,6 +2527,7 @@ fragment_add_seq_single_work(reassembly_table *table, tvbuff_t *tvb,
 		 * if bit errors mess up Last or First. */
 		if (fd != NULL) {
 			prev_fd->next = NULL;
+			fh->last = NULL;
 			fh->frame = 0;
 			for (prev_fd=fh->next; prev_fd; prev_fd=prev_fd->next) {
 				if (fh->frame < prev_fd->frame) {
@@ -2497,6 +2670,7 @@ fragment_start_seq_check(reassembly_table *table, const packet_info *pinfo,
 		fd_head->reas_in_layer_num = 0;
 		fd_head->flags = FD_BLOCKSEQUENCE|FD_DATALEN_SET;
 		fd_head->tvb_data = NULL;
+		fd_head->last = NULL;
 		fd_head->error = NULL;
 
 		insert_fd_head(table, fd_head, pinfo, id, data);
@@ -2628,6 +2802,14 @@ process_reassembled_data(tvbuff_t *tvb, const int offset, packet_info *pinfo,
 				*(fit->hf_reassembled_in), tvb,
 				0, 0, fd_head->reassembled_in);
 		}
+
+		/*
+		 * If this fragment's reassembly went unfinished for
+		 * too long and was discarded, say so.
+		 */
+		if (fd_head == NULL && evicted_frames != NULL &&
+		    g_hash_table_contains(evicted_frames, GUINT_TO_POINTER(pinfo->num)))
+			show_evicted_fragment(tvb, pinfo, tree);
 	}
 	return next_tvb;
 }
@@ -2858,6 +3040,10 @@ static void
 reassembly_table_init_reg_tables(void)
 {
 	g_list_foreach(reassembly_table_list, reassembly_table_init_reg_table, NULL);
+	if (age_samples != NULL)
+		g_array_set_size(age_samples, 0);
+	if (evicted_frames != NULL)
+		g_hash_table_remove_all(evicted_frames);
 }
 
 static void
@@ -2871,6 +3057,14 @@ static void
 reassembly_table_cleanup_reg_tables(void)
 {
 	g_list_foreach(reassembly_table_list, reassembly_table_cleanup_reg_table, NULL);
+	if (age_samples != NULL) {
+		g_array_free(age_samples, TRUE);
+		age_samples = NULL;
+	}
+	if (evicted_frames != NULL) {
+		g_hash_table_destroy(evicted_frames);
+		evicted_frames = NULL;
+	}
 }
 
 void reassembly_tables_init(void)
@@ -2887,6 +3081,42 @@ reassembly_table_free(gpointer p, gpointer user_data _U_)
 	g_free(reg_table);
 }
 
+static void
+add_fragment_head_usage(gpointer key _U_, gpointer value, gpointer user_data)
+{
+	reassembly_table_usage_t *usage = (reassembly_table_usage_t *)user_data;
+	fragment_item *fd;
+
+	if (((fragment_head *)value)->flags & FD_DEFRAGMENTED)
+		return;
+
+	usage->unfinished++;
+	for (fd = (fragment_head *)value; fd != NULL; fd = fd->next) {
+		if (fd != value)
+			usage->fragments++;
+		usage->bytes += sizeof(fragment_item);
+		if (fd->tvb_data && !(fd->flags & FD_SUBSET_TVB))
+			usage->bytes += tvb_captured_length(fd->tvb_data);
+	}
+}
+
+void
+reassembly_table_usage_foreach(reassembly_table_usage_func func, gpointer user_data)
+{
+	GList *entry;
+
+	for (entry = reassembly_table_list; entry != NULL; entry = entry->next) {
+		reassembly_table *table = ((register_reassembly_table_t *)entry->data)->table;
+		reassembly_table_usage_t usage;
+
+		memset(&usage, 0, sizeof(usage));
+		if (table->fragment_table != NULL)
+			g_hash_table_foreach(table->fragment_table, add_fragment_head_usage, &usage);
+		usage.evicted = table->evicted;
+		func(table->name, &usage, user_data);
+	}
+}
+
 void
 reassembly_table_cleanup(void)
 {
@@ -74,6 +74,10 @@ typedef struct _fragment_item {
 					 * heads and others only to fragments within
 					 * a reassembly? */
 	tvbuff_t *tvb_data;
+	struct _fragment_item *last;	/**< only in fd_head: the fragment most
+					 * recently linked at the end of the
+					 * list, or NULL; a hint that is checked
+					 * before use */
 	/**
 	 * Null if the reassembly had no error; non-null if it had
 	 * an error, in which case it's the string for the error.
@@ -130,6 +134,9 @@ typedef struct {
 	fragment_temporary_key temporary_key_func;
 	fragment_persistent_key persistent_key_func;
 	GDestroyNotify free_temporary_key_func;		/* temporary key destruction function */
+	const char *name;				/* protocol that first added a fragment, for reports */
+	guint32 last_age_check;				/* frame in which unfinished reassemblies were last aged */
+	guint64 evicted;				/* unfinished reassemblies discarded by aging */
 } reassembly_table;
 
 /*
@@ -464,6 +471,27 @@ show_fragment_seq_tree(fragment_head *ipfd_head, const fragment_items *fit,
 
 /* Initialize internal structures
  */
+/*
+ * Memory held by the unfinished reassemblies in a table.
+ */
+typedef struct {
+	guint unfinished;	/* reassemblies that aren't complete */
+	guint fragments;	/* fragments in them */
+	guint64 bytes;		/* bytes of fragment data and bookkeeping */
+	guint64 evicted;	/* reassemblies discarded because they went unfinished too long */
+} reassembly_table_usage_t;
+
+typedef void (*reassembly_table_usage_func)(const char *name,
+    const reassembly_table_usage_t *usage, gpointer user_data);
+
+/*
+ * Call func for each registered reassembly table with its current
+ * memory usage. name is the protocol that first added a fragment to
+ * the table, or NULL if none has.
+ */
+WS_DLL_PUBLIC void
+reassembly_table_usage_foreach(reassembly_table_usage_func func, gpointer user_data);
+
 extern void reassembly_tables_init(void);
 
 /* Cleanup internal structures
@@ -44,6 +44,7 @@
 
 #include <epan/packet.h>
 #include <epan/packet_info.h>
+#include <epan/prefs.h>
 #include <epan/proto.h>
 #include <epan/tvbuff.h>
 #include <epan/reassemble.h>
@@ -967,6 +968,50 @@ test_fragment_add_seq_duplicate_conflict(void)
 #endif
 }
 
+/* Test case for aging out unfinished reassemblies.
+ * A datagram that got no fragment for more than reassembly_max_age_frames
+ * frames is discarded when the table is next checked; a recent one is kept.
+ */
+/*   visit  id  frame  frag  len  more  tvb_offset
+       0    12     1     0    50   T      10
+       0    13  1000     0    60   T      15
+       0    14  1030     0    60   T       5
+*/
+static void
+test_fragment_add_seq_aging(void)
+{
+    fragment_head *fd_head;
+
+    printf("Starting test test_fragment_add_seq_aging\n");
+
+    prefs.reassembly_max_age_frames = 100;
+
+    pinfo.num = 1;
+    fd_head=fragment_add_seq(&test_reassembly_table, tvb, 10, &pinfo, 12, NULL,
+                             0, 50, TRUE, 0);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+
+    /* Too early for the table to be checked again */
+    pinfo.num = 1000;
+    fd_head=fragment_add_seq(&test_reassembly_table, tvb, 15, &pinfo, 13, NULL,
+                             0, 60, TRUE, 0);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+    ASSERT_EQ(2,g_hash_table_size(test_reassembly_table.fragment_table));
+    ASSERT_EQ(0,test_reassembly_table.evicted);
+
+    /* Frame 1 is now too old, frame 1000 isn't */
+    pinfo.num = 1030;
+    fd_head=fragment_add_seq(&test_reassembly_table, tvb, 5, &pinfo, 14, NULL,
+                             0, 60, TRUE, 0);
+    ASSERT_EQ_POINTER(NULL,fd_head);
+    ASSERT_EQ(2,g_hash_table_size(test_reassembly_table.fragment_table));
+    ASSERT_EQ(1,test_reassembly_table.evicted);
+    ASSERT_EQ_POINTER(NULL,fragment_get(&test_reassembly_table, &pinfo, 12, NULL));
+    ASSERT_NE_POINTER(NULL,fragment_get(&test_reassembly_table, &pinfo, 13, NULL));
+
+    prefs.reassembly_max_age_frames = 0;
+}
+
 /**********************************************************************************
  *
  * fragment_add_seq_check
@@ -1530,6 +1575,7 @@ main(int argc _U_, char **argv _U_)
         test_fragment_add_seq_duplicate_middle,
         test_fragment_add_seq_duplicate_last,
         test_fragment_add_seq_duplicate_conflict,
+        test_fragment_add_seq_aging,
         test_fragment_add_seq_check,               /* frag + reassemble */
         test_fragment_add_seq_check_1,
         test_fragment_add_seq_802_11_0,
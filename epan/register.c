@@ -12,6 +12,7 @@
 #include "ws_attributes.h"
 
 #include <glib.h>
+#include <wsutil/startup_timings.h>
 #include "epan/dissectors/dissectors.h"
 
 static const char *cur_cb_name = NULL;
@@ -28,13 +29,43 @@ static void set_cb_name(const char *proto) {
     g_mutex_unlock(&cur_cb_name_mtx);
 }
 
+/*
+ * Run a set of registration routines, timing them so that the total and
+ * the slowest routine can be seen with G_MESSAGES_DEBUG=all; that's where
+ * to look when startup is slow.  Each routine's time is also kept for
+ * --startup-timings.
+ */
+static void
+call_register_routines(const char *what, dissector_reg_t *regs, gulong count)
+{
+    gint64 start = g_get_monotonic_time();
+    gint64 slowest = 0;
+    const char *slowest_name = NULL;
+
+    for (gulong i = 0; i < count; i++) {
+        gint64 elapsed = g_get_monotonic_time();
+
+        set_cb_name(regs[i].cb_name);
+        regs[i].cb_func();
+
+        elapsed = g_get_monotonic_time() - elapsed;
+        startup_timing_record(what, regs[i].cb_name, elapsed);
+        if (elapsed > slowest) {
+            slowest = elapsed;
+            slowest_name = regs[i].cb_name;
+        }
+    }
+
+    start = g_get_monotonic_time() - start;
+    startup_timing_record(what, NULL, start);
+    g_debug("%s: %lu routines in %.3fms, slowest %s (%.3fms)", what, count,
+            start / 1000.0, slowest_name ? slowest_name : "none", slowest / 1000.0);
+}
+
 static void *
 register_all_protocols_worker(void *arg _U_)
 {
-    for (gulong i = 0; i < dissector_reg_proto_count; i++) {
-        set_cb_name(dissector_reg_proto[i].cb_name);
-        dissector_reg_proto[i].cb_func();
-    }
+    call_register_routines("register", dissector_reg_proto, dissector_reg_proto_count);
 
     g_async_queue_push(register_cb_done_q, GINT_TO_POINTER(TRUE));
     return NULL;
@@ -67,10 +98,7 @@ register_all_protocols(register_cb cb, gpointer cb_data)
 static void *
 register_all_protocol_handoffs_worker(void *arg _U_)
 {
-    for (gulong i = 0; i < dissector_reg_handoff_count; i++) {
-        set_cb_name(dissector_reg_handoff[i].cb_name);
-        dissector_reg_handoff[i].cb_func();
-    }
+    call_register_routines("handoff", dissector_reg_handoff, dissector_reg_handoff_count);
 
     g_async_queue_push(register_cb_done_q, GINT_TO_POINTER(TRUE));
     return NULL;
@@ -26,6 +26,7 @@ static int proto_unreassembled = -1;
 static expert_field ei_malformed_dissector_bug = EI_INIT;
 static expert_field ei_malformed_reassembly = EI_INIT;
 static expert_field ei_malformed = EI_INIT;
+static expert_field ei_unreassembled_evicted = EI_INIT;
 
 void
 register_show_exception(void)
@@ -36,7 +37,12 @@ register_show_exception(void)
 		{ &ei_malformed, { "_ws.malformed.expert", PI_MALFORMED, PI_ERROR, "Malformed Packet (Exception occurred)", EXPFILL }},
 	};
 
+	static ei_register_info ei_unreassembled[] = {
+		{ &ei_unreassembled_evicted, { "_ws.unreassembled.evicted", PI_REASSEMBLE, PI_WARN, "Unfinished reassembly discarded", EXPFILL }},
+	};
+
 	expert_module_t* expert_malformed;
+	expert_module_t* expert_unreassembled;
 
 	proto_short = proto_register_protocol("Short Frame", "Short frame", "_ws.short");
 	proto_malformed = proto_register_protocol("Malformed Packet",
@@ -47,6 +53,8 @@ register_show_exception(void)
 
 	expert_malformed = expert_register_protocol(proto_malformed);
 	expert_register_field_array(expert_malformed, ei, array_length(ei));
+	expert_unreassembled = expert_register_protocol(proto_unreassembled);
+	expert_register_field_array(expert_unreassembled, ei_unreassembled, array_length(ei_unreassembled));
 
 	/* "Short Frame", "Malformed Packet", and "Unreassembled Fragmented
 	   Packet" aren't really protocols, they're error indications;
@@ -179,6 +187,18 @@ show_reported_bounds_error(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
 	expert_add_info(pinfo, item, &ei_malformed);
 }
 
+void
+show_evicted_fragment(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree)
+{
+	proto_item *item;
+
+	col_append_str(pinfo->cinfo, COL_INFO,
+	    "[Unfinished reassembly discarded]");
+	item = proto_tree_add_protocol_format(tree, proto_unreassembled,
+	    tvb, 0, 0, "[Unfinished reassembly discarded: %s]", pinfo->current_proto);
+	expert_add_info(pinfo, item, &ei_unreassembled_evicted);
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -27,3 +27,11 @@ void show_exception(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree,
  */
 void
 show_reported_bounds_error(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree);
+
+/*
+ * Routine used to note, in a frame with a fragment of a reassembly
+ * that was discarded because it went unfinished for too long, that
+ * the fragment will never be reassembled.
+ */
+void
+show_evicted_fragment(tvbuff_t *tvb, packet_info *pinfo, proto_tree *tree);
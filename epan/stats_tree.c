@@ -106,6 +106,7 @@ free_stat_node(stat_node *node)
     }
 
     if (node->hash) g_hash_table_destroy(node->hash);
+    if (node->value_hash) g_hash_table_destroy(node->value_hash);
 
     while (node->bh) {
         bucket = node->bh;
@@ -197,6 +198,8 @@ stats_tree_reset(void *p)
     st->start = -1.0;
     st->elapsed = 0.0;
     st->now = - 1.0;
+    st->abs_first = -1.0;
+    st->abs_last = -1.0;
 
     reset_stat_node(&st->root);
 }
@@ -215,6 +218,7 @@ stats_tree_reinit(void *p)
     }
 
     st->root.children = NULL;
+    st->root.last_child = NULL;
     st->root.counter = 0;
     switch (st->root.datatype)
     {
@@ -336,6 +340,8 @@ stats_tree_new(stats_tree_cfg *cfg, tree_pres *pr, const char *filter)
 
     st->start = -1.0;
     st->elapsed = 0.0;
+    st->abs_first = -1.0;
+    st->abs_last = -1.0;
 
     switch (st->root.datatype)
     {
@@ -378,10 +384,14 @@ extern tap_packet_status
 stats_tree_packet(void *p, packet_info *pinfo, epan_dissect_t *edt, const void *pri)
 {
     stats_tree *st = (stats_tree *)p;
+    double abs_now = nstime_to_msec(&pinfo->abs_ts);
 
     st->now = nstime_to_msec(&pinfo->rel_ts);
     if (st->start < 0.0) st->start = st->now;
 
+    if (st->abs_first < 0.0 || abs_now < st->abs_first) st->abs_first = abs_now;
+    if (abs_now > st->abs_last) st->abs_last = abs_now;
+
     st->elapsed = st->now - st->start;
 
     if (st->cfg->packet)
@@ -458,12 +468,11 @@ stats_tree_presentation(void (*registry_iterator)(gpointer,gpointer,gpointer),
 *    as_named_node: whether or not it has to be registered in the root namespace
 */
 static stat_node*
-new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_datatype datatype,
+new_child_node(stats_tree *st, const gchar *name, stat_node *parent, stat_node_datatype datatype,
           gboolean with_hash, gboolean as_parent_node)
 {
 
     stat_node *node = (stat_node *)g_malloc0(sizeof(stat_node));
-    stat_node *last_chld = NULL;
 
     node->datatype = datatype;
     switch (datatype)
@@ -477,7 +486,7 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_dataty
         node->maxvalue.float_max = G_MINFLOAT;
         break;
     }
-    node->st_flags = parent_id?0:ST_FLG_ROOTCHILD;
+    node->st_flags = (parent == &st->root)?ST_FLG_ROOTCHILD:0;
 
     node->bh = (burst_bucket*)g_malloc0(sizeof(burst_bucket));
     node->bt = node->bh;
@@ -499,26 +508,16 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_dataty
         node->id = -1;
     }
 
-    if (parent_id >= 0 && parent_id < (int) st->parents->len ) {
-        node->parent = (stat_node *)g_ptr_array_index(st->parents,parent_id);
-    } else {
-        /* ??? should we set the parent to be root ??? */
-        g_assert_not_reached();
-    }
+    node->parent = parent;
 
-    if (node->parent->children) {
+    if (node->parent->last_child) {
         /* insert as last child */
-
-        for (last_chld = node->parent->children;
-             last_chld->next;
-             last_chld = last_chld->next ) ;
-
-        last_chld->next = node;
-
+        node->parent->last_child->next = node;
     } else {
         /* insert as first child */
         node->parent->children = node;
     }
+    node->parent->last_child = node;
 
     if(node->parent->hash) {
         g_hash_table_insert(node->parent->hash,node->name,node);
@@ -532,6 +531,19 @@ new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_dataty
 
     return node;
 }
+
+static stat_node*
+new_stat_node(stats_tree *st, const gchar *name, int parent_id, stat_node_datatype datatype,
+          gboolean with_hash, gboolean as_parent_node)
+{
+    if (parent_id < 0 || parent_id >= (int) st->parents->len ) {
+        /* ??? should we set the parent to be root ??? */
+        g_assert_not_reached();
+    }
+
+    return new_child_node(st, name, (stat_node *)g_ptr_array_index(st->parents,parent_id),
+                          datatype, with_hash, as_parent_node);
+}
 /***/
 
 extern int
@@ -1004,6 +1016,44 @@ stats_tree_tick_pivot(stats_tree *st, int pivot_id, const gchar *pivot_value)
     return pivot_id;
 }
 
+extern int
+stats_tree_tick_pivot_value(stats_tree *st, int pivot_id, guint32 value,
+                            const value_string *vs, const char *unknown_fmt)
+{
+    stat_node *parent = (stat_node *)g_ptr_array_index(st->parents,pivot_id);
+    stat_node *node;
+
+    if (!parent->value_hash)
+        parent->value_hash = g_hash_table_new(g_direct_hash,g_direct_equal);
+
+    node = (stat_node *)g_hash_table_lookup(parent->value_hash,GUINT_TO_POINTER(value));
+
+    if ( node == NULL ) {
+        /* first time we see this value: find or create the child by name,
+           exactly as stats_tree_tick_pivot() would, and remember it */
+        gchar *name = val_to_str_wmem(NULL, value, vs, unknown_fmt);
+
+        if( parent->hash ) {
+            node = (stat_node *)g_hash_table_lookup(parent->hash,name);
+        } else {
+            node = (stat_node *)g_hash_table_lookup(st->names,name);
+        }
+
+        if ( node == NULL )
+            node = new_stat_node(st,name,pivot_id,STAT_DT_INT,FALSE,FALSE);
+
+        wmem_free(NULL, name);
+        g_hash_table_insert(parent->value_hash,GUINT_TO_POINTER(value),node);
+    }
+
+    parent->counter++;
+    update_burst_calc(parent, 1);
+    node->counter++;
+    update_burst_calc(node, 1);
+
+    return pivot_id;
+}
+
 extern gchar*
 stats_tree_get_displayname (gchar* fullname)
 {
@@ -1483,6 +1533,264 @@ WS_DLL_PUBLIC void stats_tree_format_node_as_str(const stat_node *node,
     }
 }
 
+/*
+ * Serialized trees are text, one line per node, so that they can be
+ * written by tshark on several machines and merged later:
+ *
+ *   stats_tree <version> <abbr> <filter> <first> <last>
+ *   <depth> <datatype> <counter> <total> <min> <max> <flags> <max burst> <burst time> <name>
+ *   ...
+ *   end
+ *
+ * Fields are separated by tabs; the filter and the node names are
+ * escaped with g_strescape(). A node follows its parent, with a depth
+ * one more than the parent's; children of the root have depth 0.
+ * <first> and <last> are the absolute times of the first and the last
+ * packet in msec, or -1 if the tree saw no packet. Times relative to
+ * the start of each capture can't be compared when merging.
+ */
+#define ST_SERIALIZE_VERSION 2
+#define ST_SERIALIZE_NODE_FIELDS 10
+
+static void
+append_double(GString *s, double value)
+{
+    gchar buf[G_ASCII_DTOSTR_BUF_SIZE];
+
+    g_string_append(s, g_ascii_dtostr(buf, sizeof(buf), value));
+}
+
+static void
+serialize_node(const stat_node *node, guint depth, GString *s)
+{
+    const stat_node *child;
+    gchar *name = g_strescape(node->name, NULL);
+
+    g_string_append_printf(s, "%u\t%d\t%d\t", depth, node->datatype, node->counter);
+    switch (node->datatype)
+    {
+    case STAT_DT_INT:
+        g_string_append_printf(s, "%" G_GINT64_FORMAT "\t%d\t%d\t",
+                               node->total.int_total, node->minvalue.int_min, node->maxvalue.int_max);
+        break;
+    case STAT_DT_FLOAT:
+        append_double(s, node->total.float_total);
+        g_string_append_c(s, '\t');
+        append_double(s, node->minvalue.float_min);
+        g_string_append_c(s, '\t');
+        append_double(s, node->maxvalue.float_max);
+        g_string_append_c(s, '\t');
+        break;
+    }
+    g_string_append_printf(s, "%d\t%d\t", node->st_flags, node->max_burst);
+    append_double(s, node->burst_time);
+    g_string_append_printf(s, "\t%s\n", name);
+    g_free(name);
+
+    for (child = node->children; child; child = child->next) {
+        serialize_node(child, depth + 1, s);
+    }
+}
+
+extern void
+stats_tree_serialize(const stats_tree *st, GString *s)
+{
+    const stat_node *child;
+    gchar *filter = g_strescape(st->filter ? st->filter : "", NULL);
+
+    g_string_append_printf(s, "stats_tree\t%d\t%s\t%s\t", ST_SERIALIZE_VERSION, st->cfg->abbr, filter);
+    append_double(s, st->abs_first);
+    g_string_append_c(s, '\t');
+    append_double(s, st->abs_last);
+    g_string_append_c(s, '\n');
+    g_free(filter);
+
+    for (child = st->root.children; child; child = child->next) {
+        serialize_node(child, 0, s);
+    }
+    g_string_append(s, "end\n");
+}
+
+/* Splits the header line of a serialized tree; the result has 6 fields */
+static gchar **
+split_serialized_header(const gchar *data, gchar **err)
+{
+    const gchar *eol = strchr(data, '\n');
+    gchar *line = eol ? g_strndup(data, eol - data) : g_strdup(data);
+    gchar **fields = g_strsplit(line, "\t", 6);
+
+    g_free(line);
+    if (g_strv_length(fields) != 6 || strcmp(fields[0], "stats_tree") != 0) {
+        *err = g_strdup("not a serialized stats_tree");
+        g_strfreev(fields);
+        return NULL;
+    }
+    if (atoi(fields[1]) != ST_SERIALIZE_VERSION) {
+        *err = g_strdup_printf("unsupported serialized stats_tree version %s", fields[1]);
+        g_strfreev(fields);
+        return NULL;
+    }
+    return fields;
+}
+
+extern gboolean
+stats_tree_serialized_info(const gchar *data, gchar **abbr, gchar **filter, gchar **err)
+{
+    gchar **fields = split_serialized_header(data, err);
+
+    if (!fields)
+        return FALSE;
+
+    *abbr = g_strdup(fields[2]);
+    *filter = g_strcompress(fields[3]);
+    g_strfreev(fields);
+    return TRUE;
+}
+
+/* Adds the values of one serialized node (split into fields) to node */
+static void
+merge_node_values(stat_node *node, gchar **fields)
+{
+    gint max_burst;
+
+    node->counter += atoi(fields[2]);
+    switch (node->datatype)
+    {
+    case STAT_DT_INT:
+    {
+        gint min = atoi(fields[4]);
+        gint max = atoi(fields[5]);
+
+        node->total.int_total += g_ascii_strtoll(fields[3], NULL, 10);
+        if (node->minvalue.int_min > min)
+            node->minvalue.int_min = min;
+        if (node->maxvalue.int_max < max)
+            node->maxvalue.int_max = max;
+        break;
+    }
+    case STAT_DT_FLOAT:
+    {
+        gfloat min = (gfloat)g_ascii_strtod(fields[4], NULL);
+        gfloat max = (gfloat)g_ascii_strtod(fields[5], NULL);
+
+        node->total.float_total += g_ascii_strtod(fields[3], NULL);
+        if (node->minvalue.float_min > min)
+            node->minvalue.float_min = min;
+        if (node->maxvalue.float_max < max)
+            node->maxvalue.float_max = max;
+        break;
+    }
+    }
+    node->st_flags |= atoi(fields[6]);
+
+    /* Bursts can't be combined exactly; keep the largest one */
+    max_burst = atoi(fields[7]);
+    if (max_burst > node->max_burst) {
+        node->max_burst = max_burst;
+        node->burst_time = g_ascii_strtod(fields[8], NULL);
+    }
+}
+
+extern const gchar *
+stats_tree_merge(stats_tree *st, const gchar *data, gchar **err)
+{
+    gchar **fields = split_serialized_header(data, err);
+    GPtrArray *path;
+    double first, last;
+    gchar *error = NULL;
+
+    if (!fields)
+        return NULL;
+
+    if (strcmp(fields[2], st->cfg->abbr) != 0) {
+        *err = g_strdup_printf("serialized stats_tree is a %s tree, not %s", fields[2], st->cfg->abbr);
+        g_strfreev(fields);
+        return NULL;
+    }
+
+    /* The merged tree covers the time of all trees merged into it */
+    first = g_ascii_strtod(fields[4], NULL);
+    last = g_ascii_strtod(fields[5], NULL);
+    g_strfreev(fields);
+    fields = NULL;
+    if (first >= 0.0) {
+        if (st->abs_first < 0.0 || first < st->abs_first)
+            st->abs_first = first;
+        if (last > st->abs_last)
+            st->abs_last = last;
+        st->elapsed = st->abs_last - st->abs_first;
+    }
+
+    /* path->pdata[d] is the parent of the nodes at depth d */
+    path = g_ptr_array_new();
+    g_ptr_array_add(path, &st->root);
+
+    for (data = strchr(data, '\n'); data != NULL; data = strchr(data, '\n')) {
+        const gchar *eol;
+        gchar *line;
+        stat_node *parent, *node;
+        stat_node_datatype datatype;
+        gchar *name;
+        guint depth;
+
+        data++;
+        eol = strchr(data, '\n');
+        line = eol ? g_strndup(data, eol - data) : g_strdup(data);
+        if (strcmp(line, "end") == 0) {
+            g_free(line);
+            g_ptr_array_free(path, TRUE);
+            return eol ? eol + 1 : data + strlen(data);
+        }
+
+        fields = g_strsplit(line, "\t", ST_SERIALIZE_NODE_FIELDS);
+        g_free(line);
+        if (g_strv_length(fields) != ST_SERIALIZE_NODE_FIELDS) {
+            error = g_strdup_printf("malformed %s stats_tree node", st->cfg->abbr);
+            break;
+        }
+        depth = (guint)atoi(fields[0]);
+        if (depth >= path->len) {
+            error = g_strdup_printf("%s stats_tree node has no parent", st->cfg->abbr);
+            break;
+        }
+        datatype = (stat_node_datatype)atoi(fields[1]);
+        if (datatype != STAT_DT_INT && datatype != STAT_DT_FLOAT) {
+            error = g_strdup_printf("%s stats_tree node has an unknown type", st->cfg->abbr);
+            break;
+        }
+        g_ptr_array_set_size(path, depth + 1);
+        parent = (stat_node *)g_ptr_array_index(path, depth);
+
+        name = g_strcompress(fields[ST_SERIALIZE_NODE_FIELDS - 1]);
+        if (parent->hash) {
+            node = (stat_node *)g_hash_table_lookup(parent->hash, name);
+        } else {
+            for (node = parent->children; node; node = node->next) {
+                if (strcmp(node->name, name) == 0)
+                    break;
+            }
+        }
+        if (node == NULL) {
+            node = new_child_node(st, name, parent, datatype, TRUE, FALSE);
+        } else if (node->datatype != datatype) {
+            error = g_strdup_printf("%s stats_tree node \"%s\" has a different type", st->cfg->abbr, name);
+            g_free(name);
+            break;
+        }
+        g_free(name);
+
+        merge_node_values(node, fields);
+        g_strfreev(fields);
+        fields = NULL;
+        g_ptr_array_add(path, node);
+    }
+
+    *err = error ? error : g_strdup_printf("truncated %s stats_tree", st->cfg->abbr);
+    g_strfreev(fields);
+    g_ptr_array_free(path, TRUE);
+    return NULL;
+}
+
 void stats_tree_cleanup(void)
 {
     g_hash_table_destroy(registry);
@@ -16,6 +16,7 @@
 #include <epan/packet_info.h>
 #include <epan/tap.h>
 #include <epan/stat_groups.h>
+#include <epan/value_string.h>
 #include "ws_symbol_export.h"
 
 #ifdef __cplusplus
@@ -177,6 +178,15 @@ WS_DLL_PUBLIC int stats_tree_tick_pivot(stats_tree *st,
                                         int pivot_id,
                                         const gchar *pivot_value);
 
+/* like stats_tree_tick_pivot() for a numeric value named through a
+   value_string: the child is found by value, so its name is only
+   formatted and hashed the first time the value is seen */
+WS_DLL_PUBLIC int stats_tree_tick_pivot_value(stats_tree *st,
+                                              int pivot_id,
+                                              guint32 value,
+                                              const value_string *vs,
+                                              const char *unknown_fmt);
+
 extern void stats_tree_cleanup(void);
 
 
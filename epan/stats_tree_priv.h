@@ -84,12 +84,16 @@ struct _stat_node {
 	/** children nodes by name */
 	GHashTable		*hash;
 
+	/** children nodes by numeric value, for stats_tree_tick_pivot_value() */
+	GHashTable		*value_hash;
+
 	/** the owner of this node */
 	stats_tree		*st;
 
 	/** relatives */
 	stat_node		*parent;
 	stat_node		*children;
+	stat_node		*last_child;
 	stat_node		*next;
 
 	/** used to check if value is within range */
@@ -109,6 +113,11 @@ struct _stats_tree {
 	double			start;
 	double			elapsed;
 	double			now;
+	/** absolute time of the first and the last packet, in msec since
+	    the epoch; unlike start and now, these can be compared between
+	    captures when trees are merged */
+	double			abs_first;
+	double			abs_last;
 
 	int				st_flags;
 	gint			num_columns;
@@ -246,6 +255,25 @@ WS_DLL_PUBLIC GString* stats_tree_format_as_str(const stats_tree* st,
 					gint sort_column,
 					gboolean sort_descending);
 
+/** appends the state of the tree to s, in a text form that
+    stats_tree_merge() can add to another tree of the same kind */
+WS_DLL_PUBLIC void stats_tree_serialize(const stats_tree *st, GString *s);
+
+/** gets the abbr and the filter of the serialized tree at data,
+    so that the caller can find or create the tree to merge it into.
+    Returns FALSE and sets err if data isn't a serialized tree */
+WS_DLL_PUBLIC gboolean stats_tree_serialized_info(const gchar *data,
+					gchar **abbr,
+					gchar **filter,
+					gchar **err);
+
+/** adds the serialized tree at data to st, summing the counters of
+    nodes with the same path and creating the missing ones. Returns
+    a pointer past the serialized tree, or NULL and sets err */
+WS_DLL_PUBLIC const gchar *stats_tree_merge(stats_tree *st,
+					const gchar *data,
+					gchar **err);
+
 /** helper funcation to add note to formatted stats_tree */
 WS_DLL_PUBLIC void stats_tree_format_node_as_str(const stat_node *node,
 					GString *s,
@@ -84,6 +84,8 @@ typedef struct _tap_listener_t {
 	guint flags;
 	gchar *fstring;
 	dfilter_t *code;
+	struct _tap_listener_t *filter_owner; /* earlier listener with the same filter, or NULL */
+	int filter_result; /* result of code for the current packet, -1 if not applied yet */
 	void *tapdata;
 	tap_reset_cb reset;
 	tap_packet_cb packet;
@@ -259,6 +261,43 @@ void tap_build_interesting (epan_dissect_t *edt)
 	}
 }
 
+/* Apply the listener's filter, or reuse the result of an earlier
+ * listener with the same filter for this packet. */
+static gboolean
+tap_listener_filter_passes(tap_listener_t *tl, epan_dissect_t *edt)
+{
+	tap_listener_t *owner = tl->filter_owner ? tl->filter_owner : tl;
+
+	if(owner->filter_result<0){
+		owner->filter_result = dfilter_apply_edt(owner->code, edt) ? 1 : 0;
+	}
+	return owner->filter_result;
+}
+
+/* Point each tap listener with a filter at the first listener in the
+ * queue with the same filter string, so that the filter is only applied
+ * once per packet. Must be called whenever a listener or its filter
+ * changes. */
+static void
+tap_share_filters(void)
+{
+	tap_listener_t *tl;
+	GHashTable *owners;
+
+	owners=g_hash_table_new(g_str_hash, g_str_equal);
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		tl->filter_owner=NULL;
+		if(!tl->code){
+			continue;
+		}
+		tl->filter_owner=(tap_listener_t *)g_hash_table_lookup(owners, tl->fstring);
+		if(!tl->filter_owner){
+			g_hash_table_insert(owners, tl->fstring, tl);
+		}
+	}
+	g_hash_table_destroy(owners);
+}
+
 /* This function is used to delete/initialize the tap queue and prime an
    epan_dissect_t with all the filters for tap listeners.
    To free the tap queue, we just prepend the used queue to the free queue.
@@ -300,6 +339,12 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 		return;
 	}
 
+	/* Every tapped packet shares the same tree, so each filter only
+	   has to be applied once. */
+	for(tl=tap_listener_queue;tl;tl=tl->next){
+		tl->filter_result=-1;
+	}
+
 	/* loop over all tap listeners and call the listener callback
 	   for all packets that match the filter. */
 	for(i=0;i<tap_packet_index;i++){
@@ -330,7 +375,7 @@ tap_push_tapped_queue(epan_dissect_t *edt)
 					 * packet passes.
 					 */
 					if(tl->code){
-						if (!dfilter_apply_edt(tl->code, edt)){
+						if (!tap_listener_filter_passes(tl, edt)){
 							/* The packet didn't
 							 * pass the filter. */
 							continue;
@@ -554,6 +599,7 @@ register_tap_listener(const char *tapname, void *tapdata, const char *fstring,
 	tl->next=tap_listener_queue;
 
 	tap_listener_queue=tl;
+	tap_share_filters();
 
 	return NULL;
 }
@@ -599,11 +645,13 @@ set_tap_dfilter(void *tapdata, const char *fstring)
 						 "Filter \"%s\" is invalid - %s",
 						 fstring, err_msg);
 				g_free(err_msg);
+				tap_share_filters();
 				return error_string;
 			}
 		}
 		tl->fstring=g_strdup(fstring);
 		tl->code=code;
+		tap_share_filters();
 	}
 
 	return NULL;
@@ -636,6 +684,7 @@ tap_listeners_dfilter_recompile(void)
 		}
 		tl->code=code;
 	}
+	tap_share_filters();
 }
 
 /* this function removes a tap listener
@@ -666,6 +715,7 @@ remove_tap_listener(void *tapdata)
 			return;
 		}
 	}
+	tap_share_filters();
 	free_tap_listener(tl);
 }
 
@@ -689,6 +739,30 @@ tap_listeners_require_dissection(void)
 
 }
 
+/*
+ * Return FALSE if none of the tap listeners that require dissection could
+ * get a packet whose protocol tree has only the protocols for which
+ * has_protocol returns TRUE, TRUE otherwise.
+ */
+gboolean
+tap_listeners_could_match_protocols(dfilter_has_protocol_func has_protocol, void *data)
+{
+	tap_listener_t *tap_queue = tap_listener_queue;
+
+	while(tap_queue) {
+		if(!(tap_queue->flags & TL_IS_DISSECTOR_HELPER)) {
+			if(!tap_queue->code)
+				return TRUE;
+			if(dfilter_could_match_protocols(tap_queue->code, has_protocol, data))
+				return TRUE;
+		}
+
+		tap_queue = tap_queue->next;
+	}
+
+	return FALSE;
+}
+
 /* Returns TRUE there is an active tap listener for the specified tap id. */
 gboolean
 have_tap_listener(int tap_id)
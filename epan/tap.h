@@ -13,6 +13,7 @@
 
 #include <epan/epan.h>
 #include <epan/packet_info.h>
+#include <epan/dfilter/dfilter.h>
 #include "ws_symbol_export.h"
 #ifdef HAVE_PLUGINS
 #include "wsutil/plugins.h"
@@ -238,6 +239,13 @@ WS_DLL_PUBLIC void remove_tap_listener(void *tapdata);
  */
 WS_DLL_PUBLIC gboolean tap_listeners_require_dissection(void);
 
+/**
+ * Return FALSE if none of the tap listeners that require dissection could
+ * get a packet whose protocol tree has only the protocols for which
+ * has_protocol returns TRUE, TRUE otherwise.
+ */
+WS_DLL_PUBLIC gboolean tap_listeners_could_match_protocols(dfilter_has_protocol_func has_protocol, void *data);
+
 /** Returns TRUE there is an active tap listener for the specified tap id. */
 WS_DLL_PUBLIC gboolean have_tap_listener(int tap_id);
 
@@ -70,6 +70,24 @@ gchar *address_to_display(wmem_allocator_t *allocator, const address *addr);
 
 WS_DLL_PUBLIC void     address_to_str_buf(const address *addr, gchar *buf, int buf_len);
 
+/*
+ * address_to_str_cached returns the same string as address_to_str, but
+ * formats each address only once per capture file.  The string belongs
+ * to the cache and lives until the file is closed.  Addresses of types
+ * registered by dissectors aren't cached, as their format can depend on
+ * preferences; their string is allocated in packet scope.
+ *
+ * The cache lives in file scope, so this may only be called while a
+ * packet is being dissected, e.g. when filling in columns.
+ */
+WS_DLL_PUBLIC const gchar *address_to_str_cached(const address *addr);
+
+/*
+ * address_to_display_buf writes the result of address_to_display into buf,
+ * truncating it to buf_len bytes.
+ */
+WS_DLL_PUBLIC void     address_to_display_buf(const address *addr, gchar *buf, int buf_len);
+
 #define tvb_ether_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_ETHER, offset)
 #define tvb_ip_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_IPv4, offset)
 #define tvb_ip6_to_str(tvb, offset) tvb_address_to_str(wmem_packet_scope(), tvb, AT_IPv6, offset)
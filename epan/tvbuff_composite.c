@@ -24,6 +24,13 @@ typedef struct {
 	guint		*start_offsets;
 	guint		*end_offsets;
 
+	/* The members as an array, for lookup by index, and the
+	 * index of the member found by the previous lookup, as
+	 * accesses are mostly sequential. */
+	tvbuff_t	**members;
+	guint		num_members;
+	guint		last_member;
+
 } tvb_comp_t;
 
 struct tvb_composite {
@@ -42,6 +49,7 @@ composite_free(tvbuff_t *tvb)
 
 	g_free(composite->start_offsets);
 	g_free(composite->end_offsets);
+	g_free(composite->members);
 	if (tvb->real_data) {
 		/*
 		 * XXX - do this with a union?
@@ -56,30 +64,59 @@ composite_offset(const tvbuff_t *tvb _U_, const guint counter)
 	return counter;
 }
 
+/* Returns the index of the member containing abs_offset, or num_members if
+ * abs_offset is past the end of the last member. */
+static guint
+composite_find_member(tvb_comp_t *composite, guint abs_offset)
+{
+	guint lo, hi, mid;
+
+	lo = composite->last_member;
+	if (abs_offset <= composite->end_offsets[lo] &&
+	    (lo == 0 || abs_offset > composite->end_offsets[lo - 1]))
+		return lo;
+	if (lo + 1 < composite->num_members &&
+	    abs_offset > composite->end_offsets[lo] &&
+	    abs_offset <= composite->end_offsets[lo + 1]) {
+		composite->last_member = lo + 1;
+		return lo + 1;
+	}
+
+	/* Binary search for the first member whose end is at or
+	 * past abs_offset; the end offsets are strictly increasing. */
+	lo = 0;
+	hi = composite->num_members;
+	while (lo < hi) {
+		mid = lo + (hi - lo) / 2;
+		if (abs_offset <= composite->end_offsets[mid])
+			hi = mid;
+		else
+			lo = mid + 1;
+	}
+
+	if (lo < composite->num_members)
+		composite->last_member = lo;
+	return lo;
+}
+
 static const guint8*
 composite_get_ptr(tvbuff_t *tvb, guint abs_offset, guint abs_length)
 {
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
 	tvbuff_t   *member_tvb = NULL;
 	guint	    member_offset;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
 	composite = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
+	if (i < composite->num_members)
+		member_tvb = composite->members[i];
 
 	/* special case */
 	if (!member_tvb) {
@@ -113,26 +150,20 @@ composite_memcpy(tvbuff_t *tvb, void* _target, guint abs_offset, guint abs_lengt
 	struct tvb_composite *composite_tvb = (struct tvb_composite *) tvb;
 	guint8 *target = (guint8 *) _target;
 
-	guint	    i, num_members;
+	guint	    i;
 	tvb_comp_t *composite;
 	tvbuff_t   *member_tvb = NULL;
 	guint	    member_offset, member_length;
-	GSList	   *slist;
 
 	/* DISSECTOR_ASSERT(tvb->ops == &tvb_composite_ops); */
 
 	/* Maybe the range specified by offset/length
 	 * is contiguous inside one of the member tvbuffs */
 	composite   = &composite_tvb->composite;
-	num_members = g_slist_length(composite->tvbs);
 
-	for (i = 0; i < num_members; i++) {
-		if (abs_offset <= composite->end_offsets[i]) {
-			slist = g_slist_nth(composite->tvbs, i);
-			member_tvb = (tvbuff_t *)slist->data;
-			break;
-		}
-	}
+	i = composite_find_member(composite, abs_offset);
+	if (i < composite->num_members)
+		member_tvb = composite->members[i];
 
 	/* special case */
 	if (!member_tvb) {
@@ -202,6 +233,9 @@ tvb_new_composite(void)
 	composite->tvbs		 = NULL;
 	composite->start_offsets = NULL;
 	composite->end_offsets	 = NULL;
+	composite->members	 = NULL;
+	composite->num_members	 = 0;
+	composite->last_member	 = 0;
 
 	return tvb;
 }
@@ -269,10 +303,13 @@ tvb_composite_finalize(tvbuff_t *tvb)
 
 	composite->start_offsets = g_new(guint, num_members);
 	composite->end_offsets = g_new(guint, num_members);
+	composite->members = g_new(tvbuff_t *, num_members);
+	composite->num_members = num_members;
 
 	for (slist = composite->tvbs; slist != NULL; slist = slist->next) {
 		DISSECTOR_ASSERT((guint) i < num_members);
 		member_tvb = (tvbuff_t *)slist->data;
+		composite->members[i] = member_tvb;
 		composite->start_offsets[i] = tvb->length;
 		tvb->length += member_tvb->length;
 		tvb->reported_length += member_tvb->reported_length;
@@ -41,6 +41,11 @@ struct _wmem_allocator_t {
     void                        *private_data;
     enum _wmem_allocator_type_t  type;
     gboolean                     in_scope;
+
+    /* Statistics, see wmem_get_stats() */
+    guint64                      alloc_count;
+    guint64                      alloc_bytes;
+    guint64                      peak_bytes;
 };
 
 #ifdef __cplusplus
@@ -41,6 +41,9 @@ wmem_alloc(wmem_allocator_t *allocator, const size_t size)
         return NULL;
     }
 
+    allocator->alloc_count++;
+    allocator->alloc_bytes += size;
+
     return allocator->walloc(allocator->private_data, size);
 }
 
@@ -93,6 +96,9 @@ wmem_realloc(wmem_allocator_t *allocator, void *ptr, const size_t size)
 
     g_assert(allocator->in_scope);
 
+    allocator->alloc_count++;
+    allocator->alloc_bytes += size;
+
     return allocator->wrealloc(allocator->private_data, ptr, size);
 }
 
@@ -102,6 +108,12 @@ wmem_free_all_real(wmem_allocator_t *allocator, gboolean final)
     wmem_call_callbacks(allocator,
             final ? WMEM_CB_DESTROY_EVENT : WMEM_CB_FREE_EVENT);
     allocator->free_all(allocator->private_data);
+
+    if (allocator->alloc_bytes > allocator->peak_bytes) {
+        allocator->peak_bytes = allocator->alloc_bytes;
+    }
+    allocator->alloc_count = 0;
+    allocator->alloc_bytes = 0;
 }
 
 void
@@ -110,6 +122,14 @@ wmem_free_all(wmem_allocator_t *allocator)
     wmem_free_all_real(allocator, FALSE);
 }
 
+void
+wmem_get_stats(wmem_allocator_t *allocator, wmem_allocator_stats_t *stats)
+{
+    stats->allocations = allocator->alloc_count;
+    stats->bytes       = allocator->alloc_bytes;
+    stats->peak_bytes  = MAX(allocator->peak_bytes, allocator->alloc_bytes);
+}
+
 void
 wmem_gc(wmem_allocator_t *allocator)
 {
@@ -143,6 +163,10 @@ wmem_allocator_new(const wmem_allocator_type_t type)
     allocator->callbacks = NULL;
     allocator->in_scope  = TRUE;
 
+    allocator->alloc_count = 0;
+    allocator->alloc_bytes = 0;
+    allocator->peak_bytes  = 0;
+
     switch (real_type) {
         case WMEM_ALLOCATOR_SIMPLE:
             wmem_simple_allocator_init(allocator);
@@ -166,6 +166,23 @@ WS_DLL_PUBLIC
 void
 wmem_free_all(wmem_allocator_t *allocator);
 
+/** Allocation statistics of an allocator, see wmem_get_stats(). */
+typedef struct _wmem_allocator_stats_t {
+    guint64 allocations; /**< Allocations and reallocations since the last wmem_free_all() */
+    guint64 bytes;       /**< Bytes they requested; individual frees aren't subtracted */
+    guint64 peak_bytes;  /**< Largest value bytes has had since the allocator was created */
+} wmem_allocator_stats_t;
+
+/** Get the allocation statistics of an allocator. Counting is always on;
+ * it costs two additions per allocation.
+ *
+ * @param allocator The allocator to get the statistics of.
+ * @param stats Filled in with the statistics.
+ */
+WS_DLL_PUBLIC
+void
+wmem_get_stats(wmem_allocator_t *allocator, wmem_allocator_stats_t *stats);
+
 /** Triggers a garbage-collection in the allocator. This does not free any
  * memory, but it can return unused blocks to the operating system or perform
  * other optimizations.
@@ -39,6 +39,10 @@ typedef struct _wmem_map_item_t {
     const void *key;
     void *value;
     struct _wmem_map_item_t *next;
+    /* The full (mixed) hash of the key. Comparing it before calling eql_func
+     * skips most key comparisons on colliding items, and growing the table
+     * doesn't have to call hash_func again. */
+    guint32 hash;
 } wmem_map_item_t;
 
 struct _wmem_map_t {
@@ -72,9 +76,14 @@ struct _wmem_map_t {
 
 /* Efficient universal integer hashing:
  * https://en.wikipedia.org/wiki/Universal_hashing#Avoiding_modular_arithmetic
+ * HASH gives the full 32-bit mixed hash that is stored in each item, SLOT
+ * takes its top bits as the index into the table.
  */
 #define HASH(MAP, KEY) \
-    ((guint32)(((MAP)->hash_func(KEY) * x) >> (32 - (MAP)->capacity)))
+    ((guint32)((MAP)->hash_func(KEY) * x))
+
+#define SLOT(MAP, H) \
+    ((guint32)((H) >> (32 - (MAP)->capacity)))
 
 static void
 wmem_map_init_table(wmem_map_t *map)
@@ -172,7 +181,7 @@ wmem_map_grow(wmem_map_t *map)
         cur = old_table[i];
         while (cur) {
             nxt              = cur->next;
-            slot             = HASH(map, cur->key);
+            slot             = SLOT(map, cur->hash);
             cur->next        = map->table[slot];
             map->table[slot] = cur;
             cur              = nxt;
@@ -188,6 +197,7 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
 {
     wmem_map_item_t **item;
     void *old_val;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -195,11 +205,12 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
     }
 
     /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
+    hash = HASH(map, key);
+    item = &(map->table[SLOT(map, hash)]);
 
     /* check existing items in that slot */
     while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
+        if ((*item)->hash == hash && map->eql_func(key, (*item)->key)) {
             /* replace and return old value for this key */
             old_val = (*item)->value;
             (*item)->value = value;
@@ -214,6 +225,7 @@ wmem_map_insert(wmem_map_t *map, const void *key, void *value)
     (*item)->key   = key;
     (*item)->value = value;
     (*item)->next  = NULL;
+    (*item)->hash  = hash;
 
     map->count++;
 
@@ -230,6 +242,7 @@ gboolean
 wmem_map_contains(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t *item;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -237,11 +250,12 @@ wmem_map_contains(wmem_map_t *map, const void *key)
     }
 
     /* find correct slot */
-    item = map->table[HASH(map, key)];
+    hash = HASH(map, key);
+    item = map->table[SLOT(map, hash)];
 
     /* scan list of items in this slot for the correct value */
     while (item) {
-        if (map->eql_func(key, item->key)) {
+        if (item->hash == hash && map->eql_func(key, item->key)) {
             return TRUE;
         }
         item = item->next;
@@ -254,6 +268,7 @@ void *
 wmem_map_lookup(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t *item;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -261,11 +276,12 @@ wmem_map_lookup(wmem_map_t *map, const void *key)
     }
 
     /* find correct slot */
-    item = map->table[HASH(map, key)];
+    hash = HASH(map, key);
+    item = map->table[SLOT(map, hash)];
 
     /* scan list of items in this slot for the correct value */
     while (item) {
-        if (map->eql_func(key, item->key)) {
+        if (item->hash == hash && map->eql_func(key, item->key)) {
             return item->value;
         }
         item = item->next;
@@ -278,6 +294,7 @@ gboolean
 wmem_map_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key, void **value)
 {
     wmem_map_item_t *item;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -285,11 +302,12 @@ wmem_map_lookup_extended(wmem_map_t *map, const void *key, const void **orig_key
     }
 
     /* find correct slot */
-    item = map->table[HASH(map, key)];
+    hash = HASH(map, key);
+    item = map->table[SLOT(map, hash)];
 
     /* scan list of items in this slot for the correct value */
     while (item) {
-        if (map->eql_func(key, item->key)) {
+        if (item->hash == hash && map->eql_func(key, item->key)) {
             if (orig_key) {
                 *orig_key = item->key;
             }
@@ -309,6 +327,7 @@ wmem_map_remove(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t **item, *tmp;
     void *value;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -316,11 +335,12 @@ wmem_map_remove(wmem_map_t *map, const void *key)
     }
 
     /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
+    hash = HASH(map, key);
+    item = &(map->table[SLOT(map, hash)]);
 
     /* check the items in that slot */
     while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
+        if ((*item)->hash == hash && map->eql_func(key, (*item)->key)) {
             /* found it */
             tmp     = (*item);
             value   = tmp->value;
@@ -340,6 +360,7 @@ gboolean
 wmem_map_steal(wmem_map_t *map, const void *key)
 {
     wmem_map_item_t **item, *tmp;
+    guint32 hash;
 
     /* Make sure we have a table */
     if (map->table == NULL) {
@@ -347,11 +368,12 @@ wmem_map_steal(wmem_map_t *map, const void *key)
     }
 
     /* get a pointer to the slot */
-    item = &(map->table[HASH(map, key)]);
+    hash = HASH(map, key);
+    item = &(map->table[SLOT(map, hash)]);
 
     /* check the items in that slot */
     while (*item) {
-        if (map->eql_func(key, (*item)->key)) {
+        if ((*item)->hash == hash && map->eql_func(key, (*item)->key)) {
             /* found it */
             tmp     = (*item);
             (*item) = tmp->next;
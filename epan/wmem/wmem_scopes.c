@@ -35,7 +35,12 @@
  * perfect, but it should stop most of the bad behaviour that emem permitted.
  */
 
-/* TODO: Make these thread-local */
+/* These are deliberately plain globals rather than thread-local. Dissection
+ * as a whole runs on a single thread: dissectors keep static state, and the
+ * conversation, reassembly and tap tables are unlocked. Giving each thread
+ * its own packet scope would not by itself make concurrent dissection safe,
+ * and every wmem_packet_scope() call would pay for a thread-local lookup.
+ */
 static wmem_allocator_t *packet_scope = NULL;
 static wmem_allocator_t *file_scope   = NULL;
 static wmem_allocator_t *epan_scope   = NULL;
@@ -194,6 +194,38 @@ wmem_test_allocator_callbacks(void)
     g_assert(cb_called_count == 3);
 }
 
+static void
+wmem_test_allocator_stats(void)
+{
+    wmem_allocator_t       *allocator;
+    wmem_allocator_stats_t  stats;
+    void                   *ptr;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
+
+    wmem_get_stats(allocator, &stats);
+    g_assert(stats.allocations == 0);
+    g_assert(stats.bytes == 0);
+    g_assert(stats.peak_bytes == 0);
+
+    wmem_alloc(allocator, 10);
+    ptr = wmem_alloc(allocator, 20);
+    wmem_realloc(allocator, ptr, 30);
+    wmem_get_stats(allocator, &stats);
+    g_assert(stats.allocations == 3);
+    g_assert(stats.bytes == 60);
+    g_assert(stats.peak_bytes == 60);
+
+    wmem_free_all(allocator);
+    wmem_alloc(allocator, 5);
+    wmem_get_stats(allocator, &stats);
+    g_assert(stats.allocations == 1);
+    g_assert(stats.bytes == 5);
+    g_assert(stats.peak_bytes == 60);
+
+    wmem_destroy_allocator(allocator);
+}
+
 static void
 wmem_test_allocator_det(wmem_allocator_t *allocator, wmem_verify_func verify,
         guint len)
@@ -631,6 +663,66 @@ wmem_test_stringperf(void)
     g_free(str_ptr);
 }
 
+/* NOTE: You have to run "wmem_test --verbose" to see results. */
+static void
+wmem_test_mapperf(void)
+{
+#define MAP_KEY_COUNT  (64 * 1024)
+#define MAP_LOOP_COUNT (16)
+    wmem_allocator_t   *allocator;
+    wmem_map_t         *map;
+    gchar             **str_keys = g_new(gchar *, MAP_KEY_COUNT);
+    unsigned            i, j;
+    double              start_utime, start_stime, end_utime, end_stime, utime_ms, stime_ms;
+
+    allocator = wmem_allocator_new(WMEM_ALLOCATOR_BLOCK);
+
+    for (i = 0; i < MAP_KEY_COUNT; i++) {
+        str_keys[i] = wmem_strdup_printf(allocator, "conversation key %u", i);
+    }
+
+    map = wmem_map_new(allocator, g_direct_hash, g_direct_equal);
+    RESOURCE_USAGE_START;
+    for (i = 0; i < MAP_KEY_COUNT; i++) {
+        wmem_map_insert(map, GUINT_TO_POINTER(i), GUINT_TO_POINTER(i));
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "wmem_map_insert %u direct keys: u %.3f ms s %.3f ms", MAP_KEY_COUNT, utime_ms, stime_ms);
+
+    RESOURCE_USAGE_START;
+    for (j = 0; j < MAP_LOOP_COUNT; j++) {
+        for (i = 0; i < MAP_KEY_COUNT; i++) {
+            g_assert(wmem_map_lookup(map, GUINT_TO_POINTER(i)) == GUINT_TO_POINTER(i));
+        }
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "wmem_map_lookup %u direct keys: u %.3f ms s %.3f ms", MAP_KEY_COUNT * MAP_LOOP_COUNT, utime_ms, stime_ms);
+
+    map = wmem_map_new(allocator, wmem_str_hash, g_str_equal);
+    RESOURCE_USAGE_START;
+    for (i = 0; i < MAP_KEY_COUNT; i++) {
+        wmem_map_insert(map, str_keys[i], GUINT_TO_POINTER(i));
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "wmem_map_insert %u string keys: u %.3f ms s %.3f ms", MAP_KEY_COUNT, utime_ms, stime_ms);
+
+    RESOURCE_USAGE_START;
+    for (j = 0; j < MAP_LOOP_COUNT; j++) {
+        for (i = 0; i < MAP_KEY_COUNT; i++) {
+            g_assert(wmem_map_lookup(map, str_keys[i]) == GUINT_TO_POINTER(i));
+        }
+    }
+    RESOURCE_USAGE_END;
+    g_test_minimized_result(utime_ms + stime_ms,
+        "wmem_map_lookup %u string keys: u %.3f ms s %.3f ms", MAP_KEY_COUNT * MAP_LOOP_COUNT, utime_ms, stime_ms);
+
+    wmem_destroy_allocator(allocator);
+    g_free(str_keys);
+}
+
 /* DATA STRUCTURE TESTING FUNCTIONS (/wmem/datastruct/) */
 
 static void
@@ -1425,12 +1517,14 @@ main(int argc, char **argv)
     g_test_add_func("/wmem/allocator/simple",    wmem_test_allocator_simple);
     g_test_add_func("/wmem/allocator/strict",    wmem_test_allocator_strict);
     g_test_add_func("/wmem/allocator/callbacks", wmem_test_allocator_callbacks);
+    g_test_add_func("/wmem/allocator/stats",     wmem_test_allocator_stats);
 
     g_test_add_func("/wmem/utils/misc",    wmem_test_miscutls);
     g_test_add_func("/wmem/utils/strings", wmem_test_strutls);
 
     if (!g_test_perf ()) {
         g_test_add_func("/wmem/utils/stringperf", wmem_test_stringperf);
+        g_test_add_func("/wmem/datastruct/mapperf", wmem_test_mapperf);
     }
 
     g_test_add_func("/wmem/datastruct/array",  wmem_test_array);
@@ -22,6 +22,7 @@
 #include <epan/ex-opt.h>
 #include <wsutil/privileges.h>
 #include <wsutil/file_util.h>
+#include <wsutil/startup_timings.h>
 #include <wsutil/ws_printf.h> /* ws_debug_printf */
 
 /* linked list of Lua plugins */
@@ -34,6 +35,16 @@ typedef struct _wslua_plugin {
 
 static wslua_plugin *wslua_plugin_list = NULL;
 
+/* Modification time and size of each script we loaded, by file name, and
+   the number of plugin scripts found; used by wslua_plugins_changed(). */
+typedef struct _wslua_script_stamp {
+    gint64 mtime;
+    gint64 size;
+} wslua_script_stamp;
+
+static GHashTable *wslua_script_stamps = NULL;
+static int wslua_plugin_scripts_found = -1;
+
 static lua_State* L = NULL;
 
 /* XXX: global variables? Really?? Yuck. These could be done differently,
@@ -450,6 +461,32 @@ static void wslua_clear_plugin_list(void)
     }
 }
 
+static void wslua_add_script_stamp(const gchar *filename)
+{
+    ws_statb64 statb;
+    wslua_script_stamp *stamp;
+
+    if (ws_stat64(filename, &statb) != 0)
+        return;
+
+    if (!wslua_script_stamps) {
+        wslua_script_stamps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
+    }
+    stamp = g_new(wslua_script_stamp, 1);
+    stamp->mtime = (gint64)statb.st_mtime;
+    stamp->size = (gint64)statb.st_size;
+    g_hash_table_replace(wslua_script_stamps, g_strdup(filename), stamp);
+}
+
+static void wslua_clear_script_stamps(void)
+{
+    if (wslua_script_stamps) {
+        g_hash_table_destroy(wslua_script_stamps);
+        wslua_script_stamps = NULL;
+    }
+    wslua_plugin_scripts_found = -1;
+}
+
 static int lua_script_push_args(const int script_num) {
     gchar* argname = g_strdup_printf("lua_script%d", script_num);
     const gchar* argvalue = NULL;
@@ -526,6 +563,7 @@ static gboolean lua_load_script(const gchar* filename, const gchar* dirname, con
         report_open_failure(filename,errno,FALSE);
         return FALSE;
     }
+    wslua_add_script_stamp(filename);
 
     lua_settop(L,0);
 
@@ -598,7 +636,11 @@ static gboolean lua_load_plugin_script(const gchar* name,
                                        const gchar* dirname,
                                        const int file_count)
 {
-    if (lua_load_script(filename, dirname, file_count)) {
+    gint64 start = g_get_monotonic_time();
+    gboolean loaded = lua_load_script(filename, dirname, file_count);
+
+    startup_timing_record("lua_plugins", filename, g_get_monotonic_time() - start);
+    if (loaded) {
         wslua_add_plugin(name, get_current_plugin_version(), filename);
         clear_current_plugin_version();
         return TRUE;
@@ -793,6 +835,7 @@ void wslua_init(register_cb cb, gpointer client_data) {
     const funnel_ops_t* ops = funnel_get_funnel_ops();
     gboolean enable_lua = TRUE;
     gboolean run_anyway = FALSE;
+    int plugin_scripts_found;
     expert_module_t* expert_lua;
     int file_count = 1;
     static gboolean first_time = TRUE;
@@ -977,7 +1020,7 @@ void wslua_init(register_cb cb, gpointer client_data) {
     }
 
     /* load global scripts */
-    lua_load_global_plugins(cb, client_data, FALSE);
+    plugin_scripts_found = lua_load_global_plugins(cb, client_data, FALSE);
 
     /* check whether we should run other scripts even if running superuser */
     lua_getglobal(L,"run_user_scripts_when_superuser");
@@ -995,11 +1038,13 @@ void wslua_init(register_cb cb, gpointer client_data) {
             if (cb)
                 (*cb)(RA_LUA_PLUGINS, get_basename(filename), client_data);
             lua_load_internal_script(filename);
+            plugin_scripts_found++;
         }
         g_free(filename);
 
         /* load user scripts */
-        lua_load_pers_plugins(cb, client_data, FALSE);
+        plugin_scripts_found += lua_load_pers_plugins(cb, client_data, FALSE);
+        plugin_scripts_found += ex_opt_count("lua_script");
 
         /* load scripts from command line */
         for (i = 0; i < ex_opt_count("lua_script"); i++) {
@@ -1041,6 +1086,7 @@ void wslua_init(register_cb cb, gpointer client_data) {
 
     Proto_commit(L);
 
+    wslua_plugin_scripts_found = plugin_scripts_found;
     first_time = FALSE;
 }
 
@@ -1065,11 +1111,37 @@ void wslua_reload_plugins (register_cb cb, gpointer client_data) {
     wslua_deregister_filehandlers(L);
     wslua_deregister_menus();
     wslua_clear_plugin_list();
+    wslua_clear_script_stamps();
 
     wslua_cleanup();
     wslua_init(cb, client_data);    /* reinitialize */
 }
 
+gboolean wslua_plugins_changed(void) {
+    GHashTableIter iter;
+    gpointer key, value;
+
+    if (wslua_plugin_scripts_found < 0 || !wslua_script_stamps)
+        return TRUE;
+
+    /* A plugin script was added or removed */
+    if (wslua_count_plugins() != wslua_plugin_scripts_found)
+        return TRUE;
+
+    g_hash_table_iter_init(&iter, wslua_script_stamps);
+    while (g_hash_table_iter_next(&iter, &key, &value)) {
+        const wslua_script_stamp *stamp = (const wslua_script_stamp *)value;
+        ws_statb64 statb;
+
+        if (ws_stat64((const gchar *)key, &statb) != 0 ||
+            (gint64)statb.st_mtime != stamp->mtime ||
+            (gint64)statb.st_size != stamp->size)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
 void wslua_cleanup(void) {
     /* cleanup lua */
     if (L) {
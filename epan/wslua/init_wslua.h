@@ -19,6 +19,9 @@ extern "C" {
 
 WS_DLL_PUBLIC int wslua_count_plugins(void);
 WS_DLL_PUBLIC void wslua_reload_plugins (register_cb cb, gpointer client_data);
+/* TRUE if a Lua script was added, removed or modified since the plugins
+   were loaded. Modules loaded with require or dofile aren't tracked. */
+WS_DLL_PUBLIC gboolean wslua_plugins_changed(void);
 
 typedef void (*wslua_plugin_description_callback)(const char *, const char *,
                                                   const char *, const char *,
@@ -21,6 +21,11 @@
 
 #include "wslua.h"
 
+/* Lua 5.1 used lua_objlen() instead of lua_rawlen() */
+#if LUA_VERSION_NUM == 501
+#define lua_rawlen lua_objlen
+#endif
+
 /* any call to checkFieldInfo() will now error on null or expired, so no need to check again */
 WSLUA_CLASS_DEFINE(FieldInfo,FAIL_ON_NULL_OR_EXPIRED("FieldInfo"));
 /*
@@ -65,91 +70,77 @@ WSLUA_METAMETHOD FieldInfo__unm(lua_State* L) {
     return 1;
 }
 
-/* WSLUA_ATTRIBUTE FieldInfo_value RO The value of this field. */
-WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
-    /*
-       Obtain the Value of the field.
-
-       Previous to 1.11.4, this function retrieved the value for most field types,
-       but for `ftypes.UINT_BYTES` it retrieved the `ByteArray` of the field's entire `TvbRange`.
-       In other words, it returned a `ByteArray` that included the leading length byte(s),
-       instead of just the *value* bytes. That was a bug, and has been changed in 1.11.4.
-       Furthermore, it retrieved an `ftypes.GUID` as a `ByteArray`, which is also incorrect.
-
-       If you wish to still get a `ByteArray` of the `TvbRange`, use `FieldInfo:get_range()`
-       to get the `TvbRange`, and then use `Tvb:bytes()` to convert it to a `ByteArray`.
-       */
-    FieldInfo fi = checkFieldInfo(L,1);
-
-    switch(fi->ws_fi->hfinfo->type) {
+/* Pushes the Lua value of a field, returning the number of values pushed. */
+static int push_FieldInfo_value(lua_State* L, field_info* fi) {
+    switch(fi->hfinfo->type) {
         case FT_BOOLEAN:
-                lua_pushboolean(L,(int)fvalue_get_uinteger64(&(fi->ws_fi->value)));
+                lua_pushboolean(L,(int)fvalue_get_uinteger64(&(fi->value)));
                 return 1;
         case FT_UINT8:
         case FT_UINT16:
         case FT_UINT24:
         case FT_UINT32:
         case FT_FRAMENUM:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_uinteger(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_uinteger(&(fi->value))));
                 return 1;
         case FT_INT8:
         case FT_INT16:
         case FT_INT24:
         case FT_INT32:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_sinteger(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_sinteger(&(fi->value))));
                 return 1;
         case FT_FLOAT:
         case FT_DOUBLE:
-                lua_pushnumber(L,(lua_Number)(fvalue_get_floating(&(fi->ws_fi->value))));
+                lua_pushnumber(L,(lua_Number)(fvalue_get_floating(&(fi->value))));
                 return 1;
         case FT_INT64: {
-                pushInt64(L,(Int64)(fvalue_get_sinteger64(&(fi->ws_fi->value))));
+                pushInt64(L,(Int64)(fvalue_get_sinteger64(&(fi->value))));
                 return 1;
             }
         case FT_UINT64: {
-                pushUInt64(L,fvalue_get_uinteger64(&(fi->ws_fi->value)));
+                pushUInt64(L,fvalue_get_uinteger64(&(fi->value)));
                 return 1;
             }
         case FT_ETHER: {
                 Address eth = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,eth,AT_ETHER,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
+                alloc_address_tvb(NULL,eth,AT_ETHER,fi->length,fi->ds_tvb,fi->start);
                 pushAddress(L,eth);
                 return 1;
             }
         case FT_IPv4:{
                 Address ipv4 = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipv4,AT_IPv4,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
+                alloc_address_tvb(NULL,ipv4,AT_IPv4,fi->length,fi->ds_tvb,fi->start);
                 pushAddress(L,ipv4);
                 return 1;
             }
         case FT_IPv6: {
                 Address ipv6 = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipv6,AT_IPv6,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
+                alloc_address_tvb(NULL,ipv6,AT_IPv6,fi->length,fi->ds_tvb,fi->start);
                 pushAddress(L,ipv6);
                 return 1;
             }
         case FT_FCWWN: {
                 Address fcwwn = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,fcwwn,AT_FCWWN,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
+                alloc_address_tvb(NULL,fcwwn,AT_FCWWN,fi->length,fi->ds_tvb,fi->start);
                 pushAddress(L,fcwwn);
                 return 1;
             }
         case FT_IPXNET:{
                 Address ipx = (Address)g_malloc(sizeof(address));
-                alloc_address_tvb(NULL,ipx,AT_IPX,fi->ws_fi->length,fi->ws_fi->ds_tvb,fi->ws_fi->start);
+                alloc_address_tvb(NULL,ipx,AT_IPX,fi->length,fi->ds_tvb,fi->start);
                 pushAddress(L,ipx);
                 return 1;
             }
         case FT_ABSOLUTE_TIME:
         case FT_RELATIVE_TIME: {
                 NSTime nstime = (NSTime)g_malloc(sizeof(nstime_t));
-                *nstime = *(NSTime)fvalue_get(&(fi->ws_fi->value));
+                *nstime = *(NSTime)fvalue_get(&(fi->value));
                 pushNSTime(L,nstime);
                 return 1;
             }
         case FT_STRING:
         case FT_STRINGZ: {
-                gchar* repr = fvalue_to_string_repr(NULL, &fi->ws_fi->value,FTREPR_DISPLAY,BASE_NONE);
+                gchar* repr = fvalue_to_string_repr(NULL, &fi->value,FTREPR_DISPLAY,BASE_NONE);
                 if (repr)
                 {
                     lua_pushstring(L, repr);
@@ -162,10 +153,10 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
                 return 1;
             }
         case FT_NONE:
-                if (fi->ws_fi->length > 0 && fi->ws_fi->rep) {
+                if (fi->length > 0 && fi->rep) {
                     /* it has a length, but calling fvalue_get() on an FT_NONE asserts,
                        so get the label instead (it's a FT_NONE, so a label is what it basically is) */
-                    lua_pushstring(L, fi->ws_fi->rep->representation);
+                    lua_pushstring(L, fi->rep->representation);
                     return 1;
                 }
                 return 0;
@@ -176,15 +167,15 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
         case FT_OID:
             {
                 ByteArray ba = g_byte_array_new();
-                g_byte_array_append(ba, (const guint8 *) fvalue_get(&fi->ws_fi->value),
-                                    fvalue_length(&fi->ws_fi->value));
+                g_byte_array_append(ba, (const guint8 *) fvalue_get(&fi->value),
+                                    fvalue_length(&fi->value));
                 pushByteArray(L,ba);
                 return 1;
             }
         case FT_PROTOCOL:
             {
                 ByteArray ba = g_byte_array_new();
-                tvbuff_t* tvb = (tvbuff_t *) fvalue_get(&fi->ws_fi->value);
+                tvbuff_t* tvb = (tvbuff_t *) fvalue_get(&fi->value);
                 g_byte_array_append(ba, (const guint8 *)tvb_memdup(wmem_packet_scope(), tvb, 0,
                                             tvb_captured_length(tvb)), tvb_captured_length(tvb));
                 pushByteArray(L,ba);
@@ -198,6 +189,25 @@ WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
     }
 }
 
+/* WSLUA_ATTRIBUTE FieldInfo_value RO The value of this field. */
+WSLUA_METAMETHOD FieldInfo__call(lua_State* L) {
+    /*
+       Obtain the Value of the field.
+
+       Previous to 1.11.4, this function retrieved the value for most field types,
+       but for `ftypes.UINT_BYTES` it retrieved the `ByteArray` of the field's entire `TvbRange`.
+       In other words, it returned a `ByteArray` that included the leading length byte(s),
+       instead of just the *value* bytes. That was a bug, and has been changed in 1.11.4.
+       Furthermore, it retrieved an `ftypes.GUID` as a `ByteArray`, which is also incorrect.
+
+       If you wish to still get a `ByteArray` of the `TvbRange`, use `FieldInfo:get_range()`
+       to get the `TvbRange`, and then use `Tvb:bytes()` to convert it to a `ByteArray`.
+       */
+    FieldInfo fi = checkFieldInfo(L,1);
+
+    return push_FieldInfo_value(L, fi->ws_fi);
+}
+
 /* WSLUA_ATTRIBUTE FieldInfo_label RO The string representing this field. */
 WSLUA_METAMETHOD FieldInfo__tostring(lua_State* L) {
     /* The string representation of the field. */
@@ -648,6 +658,69 @@ WSLUA_CONSTRUCTOR Field_list(lua_State *L) {
     WSLUA_RETURN(1); /* The array table of field filter names */
 }
 
+WSLUA_CONSTRUCTOR Field_values(lua_State *L) {
+    /* Gets the values of several fields in one call, without creating a `FieldInfo`
+       for each of them. This is cheaper than calling each `Field` extractor in
+       turn, e.g. in a `Listener` that reads the same few fields from every packet.
+
+       The values are stored in a table at the same indices as their `Field` in
+       the `fields` table. Only the first occurrence of each field is used, the
+       same as `Field()` followed by `FieldInfo.value` on its first result; a
+       field that is not in the packet gives `nil`. Passing the table returned
+       for the previous packet as `result` reuses it instead of creating a new one.
+
+       @since 3.1.0
+     */
+#define WSLUA_ARG_Field_values_FIELDS 1 /* An array table of `Field` extractors. */
+#define WSLUA_OPTARG_Field_values_RESULT 2 /* A table to store the values in. */
+    int count, idx;
+
+    luaL_checktype(L,WSLUA_ARG_Field_values_FIELDS,LUA_TTABLE);
+
+    if (! lua_pinfo ) {
+        WSLUA_ERROR(Field_values,"Fields cannot be used outside dissectors or taps");
+        return 0;
+    }
+
+    if (lua_istable(L,WSLUA_OPTARG_Field_values_RESULT)) {
+        lua_settop(L,WSLUA_OPTARG_Field_values_RESULT);
+    } else {
+        lua_settop(L,WSLUA_ARG_Field_values_FIELDS);
+        lua_newtable(L);
+    }
+
+    count = (int)lua_rawlen(L,WSLUA_ARG_Field_values_FIELDS);
+    for (idx = 1; idx <= count; idx++) {
+        Field f;
+        header_field_info* in;
+        int pushed = 0;
+
+        lua_rawgeti(L,WSLUA_ARG_Field_values_FIELDS,idx);
+        f = checkField(L,-1);
+        lua_pop(L,1);
+
+        in = f->hfi;
+        if (! in) {
+            luaL_error(L,"invalid field");
+            return 0;
+        }
+
+        for (; in && !pushed; in = (in->same_name_prev_id != -1) ? proto_registrar_get_nth(in->same_name_prev_id) : NULL) {
+            GPtrArray* found = proto_get_finfo_ptr_array(lua_tree->tree, in->id);
+            if (found && found->len) {
+                pushed = push_FieldInfo_value(L, (field_info *) g_ptr_array_index(found,0));
+            }
+        }
+
+        if (!pushed) {
+            lua_pushnil(L);
+        }
+        lua_rawseti(L,-2,idx);
+    }
+
+    WSLUA_RETURN(1); /* The table of field values */
+}
+
 /* the following is used in Field_get_xxx functions later. If called early
  * (wanted_fields is not NULL), it will try to retrieve information directly.
  * Otherwise it uses a cached field that was loaded in lua_prime_all_fields. */
@@ -781,6 +854,7 @@ WSLUA_ATTRIBUTES Field_attributes[] = {
 WSLUA_METHODS Field_methods[] = {
     WSLUA_CLASS_FNREG(Field,new),
     WSLUA_CLASS_FNREG(Field,list),
+    WSLUA_CLASS_FNREG(Field,values),
     { NULL, NULL }
 };
 
@@ -65,6 +65,19 @@ WSLUA_CLASS_DEFINE(Tvb,FAIL_ON_NULL_OR_EXPIRED("Tvb"));
 static GPtrArray* outstanding_Tvb = NULL;
 static GPtrArray* outstanding_TvbRange = NULL;
 
+/* A TvbRange made by push_TvbRange() has a Tvb of its own, which only
+   records whether the range has expired. Both are allocated together,
+   and freed blocks are kept for reuse, since many ranges are created
+   for every packet. */
+typedef struct {
+    struct _wslua_tvbrange tvbr;
+    struct _wslua_tvb tvb;
+} TvbRange_block;
+
+#define SPARE_TVBRANGE_MAX 256
+static TvbRange_block* spare_TvbRange[SPARE_TVBRANGE_MAX];
+static guint num_spare_TvbRange = 0;
+
 /* this is used to push Tvbs that were created brand new by wslua code */
 int push_wsluaTvb(lua_State* L, Tvb t) {
     g_ptr_array_add(outstanding_Tvb,t);
@@ -335,8 +348,9 @@ static void free_TvbRange(TvbRange tvbr) {
 
     if (!tvbr->tvb->expired) {
         tvbr->tvb->expired = TRUE;
+    } else if (num_spare_TvbRange < SPARE_TVBRANGE_MAX) {
+        spare_TvbRange[num_spare_TvbRange++] = (TvbRange_block*)tvbr;
     } else {
-        free_Tvb(tvbr->tvb);
         g_free(tvbr);
     }
 }
@@ -350,6 +364,7 @@ void clear_outstanding_TvbRange(void) {
 
 
 gboolean push_TvbRange(lua_State* L, tvbuff_t* ws_tvb, int offset, int len) {
+    TvbRange_block* block;
     TvbRange tvbr;
 
     if (!ws_tvb) {
@@ -368,8 +383,13 @@ gboolean push_TvbRange(lua_State* L, tvbuff_t* ws_tvb, int offset, int len) {
         return FALSE;
     }
 
-    tvbr = (TvbRange)g_malloc(sizeof(struct _wslua_tvbrange));
-    tvbr->tvb = (Tvb)g_malloc(sizeof(struct _wslua_tvb));
+    if (num_spare_TvbRange) {
+        block = spare_TvbRange[--num_spare_TvbRange];
+    } else {
+        block = g_new(TvbRange_block, 1);
+    }
+    tvbr = &block->tvbr;
+    tvbr->tvb = &block->tvb;
     tvbr->tvb->ws_tvb = ws_tvb;
     tvbr->tvb->expired = FALSE;
     tvbr->tvb->need_free = FALSE;
@@ -75,6 +75,24 @@ static GHashTable *_toolbars = NULL;
  */
 static GHashTable *extcap_prefs_dynamic_vals = NULL;
 
+/* Cached answers of an extcap program for one of its interfaces. They are
+ * valid for as long as the program file has the same modification time and
+ * size, and survive extcap_clear_interfaces() so that refreshing the interface
+ * list does not have to ask every interface for its configuration again.
+ */
+typedef struct extcap_output_cache {
+    char   *extcap_path;
+    gint64  mtime;
+    gint64  size;
+    char   *config_output;              /**< Output of --extcap-config. */
+    char   *dlts_output;                /**< Output of --extcap-dlts, or NULL if not queried yet. */
+} extcap_output_cache_t;
+
+/* Internal container, which maps each ifname to the cached answers of its
+ * extcap program. Keys and values are owned by this table.
+ */
+static GHashTable *_output_cache_for_ifname = NULL;
+
 typedef struct _extcap_callback_info_t
 {
     const gchar * extcap;
@@ -393,6 +411,84 @@ extcap_run_one(const extcap_interface *interface, GList *arguments, extcap_cb_t
     extcap_free_array(args, cnt);
 }
 
+static void
+extcap_free_output_cache(gpointer data)
+{
+    extcap_output_cache_t *cache = (extcap_output_cache_t *)data;
+
+    g_free(cache->extcap_path);
+    g_free(cache->config_output);
+    g_free(cache->dlts_output);
+    g_free(cache);
+}
+
+static gboolean
+extcap_stat_program(const char *extcap_path, gint64 *mtime, gint64 *size)
+{
+    ws_statb64 st;
+
+    if (ws_stat64(extcap_path, &st) != 0)
+        return FALSE;
+
+    *mtime = (gint64)st.st_mtime;
+    *size = (gint64)st.st_size;
+    return TRUE;
+}
+
+/*
+ * Returns the cached answers for ifname if they came from extcap_path and the
+ * program has not changed since, NULL otherwise. Does not modify the cache, so
+ * it may be called from the discovery threads.
+ */
+static extcap_output_cache_t *
+extcap_lookup_output_cache(const gchar *ifname, const gchar *extcap_path)
+{
+    extcap_output_cache_t *cache;
+    gint64 mtime, size;
+
+    if (!_output_cache_for_ifname)
+        return NULL;
+
+    cache = (extcap_output_cache_t *)g_hash_table_lookup(_output_cache_for_ifname, ifname);
+    if (!cache || g_strcmp0(cache->extcap_path, extcap_path) != 0)
+        return NULL;
+
+    if (!extcap_stat_program(extcap_path, &mtime, &size) ||
+        mtime != cache->mtime || size != cache->size)
+        return NULL;
+
+    return cache;
+}
+
+/*
+ * Returns the cached answers for ifname, replacing stale ones with an empty
+ * entry. Returns NULL if the program cannot be found.
+ */
+static extcap_output_cache_t *
+extcap_ensure_output_cache(const gchar *ifname, const gchar *extcap_path)
+{
+    extcap_output_cache_t *cache;
+    gint64 mtime, size;
+
+    cache = extcap_lookup_output_cache(ifname, extcap_path);
+    if (cache)
+        return cache;
+
+    if (!extcap_stat_program(extcap_path, &mtime, &size))
+        return NULL;
+
+    if (!_output_cache_for_ifname)
+        _output_cache_for_ifname = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, extcap_free_output_cache);
+
+    cache = g_new0(extcap_output_cache_t, 1);
+    cache->extcap_path = g_strdup(extcap_path);
+    cache->mtime = mtime;
+    cache->size = size;
+    g_hash_table_insert(_output_cache_for_ifname, g_strdup(ifname), cache);
+
+    return cache;
+}
+
 /** Thread callback to run an extcap program and pass its output. */
 static void
 extcap_thread_callback(gpointer data, gpointer user_data)
@@ -566,6 +662,20 @@ static gboolean cb_dlt(extcap_callback_info_t cb_info)
     return FALSE;
 }
 
+/* Like cb_dlt, but also remembers the answer for the next query. */
+static gboolean cb_dlt_cached(extcap_callback_info_t cb_info)
+{
+    extcap_output_cache_t *cache = extcap_ensure_output_cache(cb_info.ifname, cb_info.extcap);
+
+    if (cache)
+    {
+        g_free(cache->dlts_output);
+        cache->dlts_output = g_strdup(cb_info.output);
+    }
+
+    return cb_dlt(cb_info);
+}
+
 if_capabilities_t *
 extcap_get_if_dlts(const gchar *ifname, char **err_str)
 {
@@ -580,11 +690,25 @@ extcap_get_if_dlts(const gchar *ifname, char **err_str)
     extcap_interface *interface = extcap_find_interface_for_ifname(ifname);
     if (interface)
     {
+        extcap_output_cache_t *cache = extcap_lookup_output_cache(ifname, interface->extcap_path);
+        if (cache && cache->dlts_output)
+        {
+            extcap_callback_info_t cb_info = {
+                .ifname = interface->call,
+                .extcap = interface->extcap_path,
+                .output = cache->dlts_output,
+                .data = &caps,
+                .err_str = err_str,
+            };
+            cb_dlt(cb_info);
+            return caps;
+        }
+
         arguments = g_list_append(arguments, g_strdup(EXTCAP_ARGUMENT_LIST_DLTS));
         arguments = g_list_append(arguments, g_strdup(EXTCAP_ARGUMENT_INTERFACE));
         arguments = g_list_append(arguments, g_strdup(ifname));
 
-        extcap_run_one(interface, arguments, cb_dlt, &caps, err_str);
+        extcap_run_one(interface, arguments, cb_dlt_cached, &caps, err_str);
 
         g_list_free_full(arguments, g_free);
     }
@@ -719,6 +843,10 @@ void extcap_register_preferences(void)
  */
 void extcap_cleanup(void)
 {
+    if (_output_cache_for_ifname)
+        g_hash_table_destroy(_output_cache_for_ifname);
+    _output_cache_for_ifname = NULL;
+
     if (extcap_prefs_dynamic_vals)
         g_hash_table_destroy(extcap_prefs_dynamic_vals);
 
@@ -898,6 +1026,20 @@ static gboolean cb_preference(extcap_callback_info_t cb_info)
     return TRUE;
 }
 
+/* Like cb_preference, but also remembers the answer for the next query. */
+static gboolean cb_preference_cached(extcap_callback_info_t cb_info)
+{
+    extcap_output_cache_t *cache = extcap_ensure_output_cache(cb_info.ifname, cb_info.extcap);
+
+    if (cache)
+    {
+        g_free(cache->config_output);
+        cache->config_output = g_strdup(cb_info.output);
+    }
+
+    return cb_preference(cb_info);
+}
+
 GList *
 extcap_get_if_configuration(const char *ifname)
 {
@@ -907,6 +1049,19 @@ extcap_get_if_configuration(const char *ifname)
     extcap_interface *interface = extcap_find_interface_for_ifname(ifname);
     if (interface)
     {
+        extcap_output_cache_t *cache = extcap_lookup_output_cache(ifname, interface->extcap_path);
+        if (cache && cache->config_output)
+        {
+            extcap_callback_info_t cb_info = {
+                .ifname = interface->call,
+                .extcap = interface->extcap_path,
+                .output = cache->config_output,
+                .data = &ret,
+            };
+            cb_preference(cb_info);
+            return ret;
+        }
+
         g_log(LOG_DOMAIN_CAPTURE, G_LOG_LEVEL_DEBUG, "Extcap path %s",
               get_extcap_dir());
 
@@ -914,7 +1069,7 @@ extcap_get_if_configuration(const char *ifname)
         arguments = g_list_append(arguments, g_strdup(EXTCAP_ARGUMENT_INTERFACE));
         arguments = g_list_append(arguments, g_strdup(ifname));
 
-        extcap_run_one(interface, arguments, cb_preference, &ret, NULL);
+        extcap_run_one(interface, arguments, cb_preference_cached, &ret, NULL);
 
         g_list_free_full(arguments, g_free);
     }
@@ -1908,6 +2063,17 @@ extcap_process_interfaces_cb(thread_pool_t *pool, void *data, char *output)
             continue;
         }
 
+        extcap_iface_info_t *iface_info = &info->iface_infos[i++];
+
+        // Reuse the configuration from an earlier discovery if the program
+        // did not change. The cache is only modified by the main thread.
+        extcap_output_cache_t *cache = extcap_lookup_output_cache(intf->call, info->extcap_path);
+        if (cache && cache->config_output) {
+            iface_info->ifname = g_strdup(intf->call);
+            iface_info->output = g_strdup(cache->config_output);
+            continue;
+        }
+
         const char *argv[] = {
             EXTCAP_ARGUMENT_CONFIG,
             EXTCAP_ARGUMENT_INTERFACE,
@@ -1915,7 +2081,6 @@ extcap_process_interfaces_cb(thread_pool_t *pool, void *data, char *output)
             NULL
         };
         extcap_run_task_t *task = g_new0(extcap_run_task_t, 1);
-        extcap_iface_info_t *iface_info = &info->iface_infos[i++];
 
         task->extcap_path = info->extcap_path;
         task->argv = g_strdupv((char **)argv);
@@ -2025,10 +2190,11 @@ extcap_load_interface_list(void)
 
                 extcap_callback_info_t cb_info = {
                     .ifname = iface_info->ifname,
+                    .extcap = infos[i].extcap_path,
                     .output = iface_info->output,
                     .data = &unused_arguments,
                 };
-                cb_preference(cb_info);
+                cb_preference_cached(cb_info);
             }
         }
         /* XXX rework cb_preference such that this unused list can be removed. */
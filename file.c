@@ -50,6 +50,7 @@
 #include "frame_tvbuff.h"
 
 #include "ui/alert_box.h"
+#include "ui/capture_index.h"
 #include "ui/simple_dialog.h"
 #include "ui/main_statusbar.h"
 #include "ui/progress_dlg.h"
@@ -74,7 +75,11 @@
 static gboolean read_record(capture_file *cf, wtap_rec *rec, Buffer *buf,
     dfilter_t *dfcode, epan_dissect_t *edt, column_info *cinfo, gint64 offset);
 
-static void rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect);
+static void rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect,
+    gboolean passed_only, dfilter_t *dfcode);
+
+static void proto_presence_free(capture_file *cf);
+static void proto_presence_clear_frame(capture_file *cf, frame_data *fdata);
 
 typedef enum {
   MR_NOTMATCHED,
@@ -86,6 +91,8 @@ typedef match_result (*ws_match_function)(capture_file *, frame_data *,
 static match_result match_protocol_tree(capture_file *cf, frame_data *fdata,
     wtap_rec *, Buffer *, void *criterion);
 static void match_subtree_text(proto_node *node, gpointer data);
+static gboolean match_text(const char *text, const char *string,
+    size_t string_len, gboolean case_insensitive);
 static match_result match_summary_line(capture_file *cf, frame_data *fdata,
     wtap_rec *, Buffer *, void *criterion);
 static match_result match_narrow_and_wide(capture_file *cf, frame_data *fdata,
@@ -116,6 +123,16 @@ static void ref_time_packets(capture_file *cf);
 /* Show the progress bar after this many seconds. */
 #define PROGBAR_SHOW_DELAY 0.5
 
+/* While reading a file, only look at the progress timer once per this many
+   records (a power of 2); reading the clock for every record shows up on
+   large files of small records. */
+#define PROGBAR_READ_CHECK_RECORDS 64
+
+/* stdio buffer for files written by the PDML, PSML, CSV, C array and JSON
+   exports. The default buffer is small enough that a full tree export
+   spends noticeable time in write() calls. */
+#define EXPORT_WRITE_BUFFER_SIZE (1024 * 1024)
+
 /*
  * We could probably use g_signal_...() instead of the callbacks below but that
  * would require linking our CLI programs to libgobject and creating an object
@@ -298,6 +315,7 @@ cf_open(capture_file *cf, const char *fname, unsigned int type, gboolean is_temp
   cf->marked_count = 0;
   cf->ignored_count = 0;
   cf->ref_time_count = 0;
+  cf->filter_incomplete = FALSE;
   cf->drops_known = FALSE;
   cf->drops     = 0;
   cf->snap      = wtap_snapshot_length(cf->provider.wth);
@@ -394,6 +412,8 @@ cf_close(capture_file *cf)
 
   dfilter_free(cf->rfcode);
   cf->rfcode = NULL;
+  nstime_set_unset(&cf->read_start);
+  nstime_set_unset(&cf->read_stop);
   if (cf->provider.frames != NULL) {
     free_frame_data_sequence(cf->provider.frames);
     cf->provider.frames = NULL;
@@ -402,12 +422,14 @@ cf_close(capture_file *cf)
     g_tree_destroy(cf->provider.frames_user_comments);
     cf->provider.frames_user_comments = NULL;
   }
+  proto_presence_free(cf);
   cf_unselect_packet(cf);   /* nothing to select */
   cf->first_displayed = 0;
   cf->last_displayed = 0;
 
   /* No frames, no frame selected, no field in that frame selected. */
   cf->count = 0;
+  cf->dissection_gen++;
   cf->current_frame = NULL;
   cf->current_row = 0;
   cf->finfo_selected = NULL;
@@ -506,6 +528,7 @@ cf_read(capture_file *cf, gboolean reloading)
   guint                tap_flags;
   gboolean             compiled;
   volatile gboolean    is_read_aborted = FALSE;
+  capture_index_range_t read_range;
 
   /* The update_progress_dlg call below might end up accepting a user request to
    * trigger redissection/rescans which can modify/destroy the dissection
@@ -578,8 +601,11 @@ cf_read(capture_file *cf, gboolean reloading)
   wtap_rec_init(&rec);
   ws_buffer_init(&buf, 1514);
 
+  capture_index_range_open(&read_range, cf->filename, &cf->read_start, &cf->read_stop);
+  capture_index_range_seek(&read_range, cf->provider.wth);
+
   TRY {
-    int     count             = 0;
+    guint   count             = 0;
 
     gint64  file_pos;
     gint64  data_offset;
@@ -589,8 +615,7 @@ cf_read(capture_file *cf, gboolean reloading)
 
     while ((wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info,
             &data_offset))) {
-      if (size >= 0) {
-        count++;
+      if (size >= 0 && (++count & (PROGBAR_READ_CHECK_RECORDS - 1)) == 0) {
         file_pos = wtap_read_so_far(cf->provider.wth);
 
         /* Create the progress bar if necessary. */
@@ -643,6 +668,10 @@ cf_read(capture_file *cf, gboolean reloading)
            hours even on fast machines) just to see that it was the wrong file. */
         break;
       }
+      if (capture_index_range_at_end(&read_range, data_offset))
+        break;
+      if (!capture_index_range_contains(&read_range, &rec))
+        continue;
       read_record(cf, &rec, &buf, dfcode, &edt, cinfo, data_offset);
     }
   }
@@ -677,6 +706,7 @@ cf_read(capture_file *cf, gboolean reloading)
   epan_dissect_cleanup(&edt);
   wtap_rec_cleanup(&rec);
   ws_buffer_free(&buf);
+  capture_index_range_cleanup(&read_range);
 
   /* Close the sequential I/O side, to free up memory it requires. */
   wtap_sequential_close(cf->provider.wth);
@@ -727,7 +757,7 @@ cf_read(capture_file *cf, gboolean reloading)
   if (cf->redissection_queued != RESCAN_NONE) {
     /* Redissection was queued up. Clear the request and perform it now. */
     gboolean redissect = cf->redissection_queued == RESCAN_REDISSECT;
-    rescan_packets(cf, "Reprocessing", "all packets", redissect);
+    rescan_packets(cf, "Reprocessing", "all packets", redissect, FALSE, NULL);
   }
 
   if (cf->stop_flag) {
@@ -1151,11 +1181,198 @@ void cf_set_rfcode(capture_file *cf, dfilter_t *rfcode)
   cf->rfcode = rfcode;
 }
 
+void cf_set_read_time_range(capture_file *cf, const nstime_t *start, const nstime_t *stop)
+{
+  cf->read_start = *start;
+  cf->read_stop = *stop;
+}
+
+/*
+ * The protocols seen in each frame the last time we dissected it with a
+ * protocol tree. Frames share one copy of each distinct set of protocols,
+ * so this costs a guint32 per frame. cf_filter_packets and
+ * cf_retap_packets use it to skip frames that can't match a filter that
+ * requires a protocol, e.g. "sip" on a capture with little SIP in it.
+ */
+struct proto_presence {
+  GArray     *frame_sets;  /* guint32 per frame: index + 1 into sets, or 0 if unknown */
+  GPtrArray  *sets;        /* GBytes holding a sorted array of protocol ids */
+  GHashTable *set_ids;     /* GBytes -> index + 1 into sets */
+  GArray     *protocols;   /* Protocols found in the frame being recorded */
+  GArray     *could_match; /* guint8 per set, for the current filters */
+};
+
+enum {
+  PROTO_PRESENCE_UNKNOWN = 0,
+  PROTO_PRESENCE_COULD_MATCH,
+  PROTO_PRESENCE_CANT_MATCH
+};
+
+static void
+proto_presence_free(capture_file *cf)
+{
+  struct proto_presence *pp = cf->proto_presence;
+
+  if (pp == NULL)
+    return;
+
+  g_array_free(pp->frame_sets, TRUE);
+  g_hash_table_destroy(pp->set_ids);
+  g_ptr_array_free(pp->sets, TRUE);
+  g_array_free(pp->protocols, TRUE);
+  g_array_free(pp->could_match, TRUE);
+  g_free(pp);
+  cf->proto_presence = NULL;
+}
+
+static void
+proto_presence_clear_frame(capture_file *cf, frame_data *fdata)
+{
+  struct proto_presence *pp = cf->proto_presence;
+
+  if (pp != NULL && fdata->num <= pp->frame_sets->len)
+    g_array_index(pp->frame_sets, guint32, fdata->num - 1) = 0;
+}
+
+/* Forget which sets of protocols the current filters could match, as the
+   display filter or the tap listeners have changed. */
+static void
+proto_presence_reset_matches(capture_file *cf)
+{
+  if (cf->proto_presence != NULL)
+    g_array_set_size(cf->proto_presence->could_match, 0);
+}
+
+static gint
+proto_presence_compare_ids(gconstpointer a, gconstpointer b)
+{
+  int id_a = *(const int *)a;
+  int id_b = *(const int *)b;
+
+  return (id_a > id_b) - (id_a < id_b);
+}
+
+static void
+proto_presence_add_protocols(proto_node *node, gpointer data)
+{
+  GArray     *protocols = (GArray *)data;
+  field_info *finfo = PNODE_FINFO(node);
+
+  if (finfo && finfo->hfinfo->type == FT_PROTOCOL)
+    g_array_append_val(protocols, finfo->hfinfo->id);
+
+  proto_tree_children_foreach(node, proto_presence_add_protocols, data);
+}
+
+/*
+ * Remember the protocols in a frame's tree. The tree must have been built
+ * without faking protocols, so that every protocol is in it whether or not
+ * a filter refers to it.
+ */
+static void
+proto_presence_record(capture_file *cf, frame_data *fdata, proto_tree *tree)
+{
+  struct proto_presence *pp = cf->proto_presence;
+  GBytes  *set;
+  guint32  set_id;
+  guint    i, len;
+
+  if (pp == NULL) {
+    pp = g_new(struct proto_presence, 1);
+    pp->frame_sets = g_array_new(FALSE, TRUE, sizeof(guint32));
+    pp->sets = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+    pp->set_ids = g_hash_table_new(g_bytes_hash, g_bytes_equal);
+    pp->protocols = g_array_new(FALSE, FALSE, sizeof(int));
+    pp->could_match = g_array_new(FALSE, TRUE, sizeof(guint8));
+    cf->proto_presence = pp;
+  }
+
+  g_array_set_size(pp->protocols, 0);
+  proto_tree_children_foreach(tree, proto_presence_add_protocols, pp->protocols);
+  g_array_sort(pp->protocols, proto_presence_compare_ids);
+  for (i = 0, len = 0; i < pp->protocols->len; i++) {
+    if (len == 0 || g_array_index(pp->protocols, int, i) != g_array_index(pp->protocols, int, len - 1))
+      g_array_index(pp->protocols, int, len++) = g_array_index(pp->protocols, int, i);
+  }
+
+  set = g_bytes_new(pp->protocols->data, len * sizeof(int));
+  set_id = GPOINTER_TO_UINT(g_hash_table_lookup(pp->set_ids, set));
+  if (set_id == 0) {
+    g_ptr_array_add(pp->sets, set);
+    set_id = pp->sets->len;
+    g_hash_table_insert(pp->set_ids, set, GUINT_TO_POINTER(set_id));
+  } else {
+    g_bytes_unref(set);
+  }
+
+  if (pp->frame_sets->len < fdata->num)
+    g_array_set_size(pp->frame_sets, fdata->num);
+  g_array_index(pp->frame_sets, guint32, fdata->num - 1) = set_id;
+}
+
+static gboolean
+proto_presence_has_protocol(int proto_id, void *data)
+{
+  gsize      size;
+  const int *ids = (const int *)g_bytes_get_data((GBytes *)data, &size);
+  gsize      low = 0, high = size / sizeof(int), mid;
+
+  while (low < high) {
+    mid = low + (high - low) / 2;
+    if (ids[mid] == proto_id)
+      return TRUE;
+    if (ids[mid] < proto_id)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return FALSE;
+}
+
+/*
+ * Returns FALSE if we know which protocols are in the frame and neither
+ * dfcode (if any) nor any tap listener could match a frame with those
+ * protocols, TRUE otherwise.
+ */
+static gboolean
+proto_presence_could_match(capture_file *cf, frame_data *fdata, dfilter_t *dfcode)
+{
+  struct proto_presence *pp = cf->proto_presence;
+  guint32  set_id;
+  guint8  *match;
+  GBytes  *set;
+
+  if (pp == NULL || fdata->num > pp->frame_sets->len)
+    return TRUE;
+
+  set_id = g_array_index(pp->frame_sets, guint32, fdata->num - 1);
+  if (set_id == 0)
+    return TRUE;
+
+  if (pp->could_match->len < set_id)
+    g_array_set_size(pp->could_match, set_id);
+  match = &g_array_index(pp->could_match, guint8, set_id - 1);
+  if (*match == PROTO_PRESENCE_UNKNOWN) {
+    set = (GBytes *)g_ptr_array_index(pp->sets, set_id - 1);
+    if ((dfcode != NULL && dfilter_could_match_protocols(dfcode, proto_presence_has_protocol, set)) ||
+        tap_listeners_could_match_protocols(proto_presence_has_protocol, set))
+      *match = PROTO_PRESENCE_COULD_MATCH;
+    else
+      *match = PROTO_PRESENCE_CANT_MATCH;
+  }
+  return *match == PROTO_PRESENCE_COULD_MATCH;
+}
+
 static void
 add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
     epan_dissect_t *edt, dfilter_t *dfcode, column_info *cinfo,
     wtap_rec *rec, Buffer *buf, gboolean add_to_packet_list)
 {
+  /* Frames are dissected differently on the first pass, so only remember
+     the protocols of frames we've seen before. */
+  gboolean record_protocols = fdata->visited && edt->tree != NULL &&
+                              !PTREE_DATA(edt->tree)->fake_protocols;
+
   frame_data_set_before_dissect(fdata, &cf->elapsed_time,
                                 &cf->provider.ref, cf->provider.prev_dis);
   cf->provider.prev_cap = fdata;
@@ -1184,6 +1401,9 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
                              frame_tvbuff_new_buffer(&cf->provider, fdata, buf),
                              fdata, cinfo);
 
+  if (record_protocols)
+    proto_presence_record(cf, fdata, edt->tree);
+
   /* If we don't have a display filter, set "passed_dfilter" to 1. */
   if (dfcode != NULL) {
     fdata->passed_dfilter = dfilter_apply_edt(dfcode, edt) ? 1 : 0;
@@ -1222,6 +1442,32 @@ add_packet_to_packet_list(frame_data *fdata, capture_file *cf,
   epan_dissect_reset(edt);
 }
 
+/*
+ * Update a frame whose display filter result we already know, without
+ * reading or dissecting it. This does the same bookkeeping as
+ * add_packet_to_packet_list.
+ */
+static void
+set_packet_passed_without_dissection(frame_data *fdata, capture_file *cf, gboolean passed)
+{
+  frame_data_set_before_dissect(fdata, &cf->elapsed_time,
+                                &cf->provider.ref, cf->provider.prev_dis);
+  cf->provider.prev_cap = fdata;
+
+  fdata->passed_dfilter = passed ? 1 : 0;
+
+  /* Time reference frames are displayed even if they don't pass. */
+  if (fdata->passed_dfilter || fdata->ref_time) {
+    cf->displayed_count++;
+    frame_data_set_after_dissect(fdata, &cf->cum_bytes);
+    cf->provider.prev_dis = fdata;
+
+    if (cf->first_displayed == 0)
+      cf->first_displayed = fdata->num;
+    cf->last_displayed = fdata->num;
+  }
+}
+
 /*
  * Read in a new record.
  * Returns TRUE if the packet was added to the packet (record) list,
@@ -1467,31 +1713,38 @@ cf_merge_files_to_tempfile(gpointer pd_window, char **out_filenamep,
 
 cf_status_t
 cf_filter_packets(capture_file *cf, gchar *dftext, gboolean force)
+{
+  return cf_filter_packets_compiled(cf, dftext, NULL, force);
+}
+
+cf_status_t
+cf_filter_packets_compiled(capture_file *cf, gchar *dftext, dfilter_t *dfcode, gboolean force)
 {
   const char *filter_new = dftext ? dftext : "";
   const char *filter_old = cf->dfilter ? cf->dfilter : "";
-  dfilter_t  *dfcode;
   gchar      *err_msg;
   GTimeVal    start_time;
+  gboolean    passed_only = FALSE;
 
   /* if new filter equals old one, do nothing unless told to do so */
   if (!force && strcmp(filter_new, filter_old) == 0) {
+    dfilter_free(dfcode);
     return CF_OK;
   }
 
-  dfcode=NULL;
-
   if (dftext == NULL) {
     /* The new filter is an empty filter (i.e., display all packets).
      * so leave dfcode==NULL
      */
+    dfilter_free(dfcode);
+    dfcode = NULL;
   } else {
     /*
      * We have a filter; make a copy of it (as we'll be saving it),
-     * and try to compile it.
+     * and try to compile it unless the caller already did.
      */
     dftext = g_strdup(dftext);
-    if (!dfilter_compile(dftext, &dfcode, &err_msg)) {
+    if (dfcode == NULL && !dfilter_compile(dftext, &dfcode, &err_msg)) {
       /* The attempt failed; report an error. */
       simple_message_box(ESD_TYPE_ERROR, NULL,
           "See the help for a description of the display filter syntax.",
@@ -1510,6 +1763,19 @@ cf_filter_packets(capture_file *cf, gchar *dftext, gboolean force)
     }
   }
 
+  /* If the new filter can only match a subset of what the old one matched,
+     we only have to look at the frames which are currently displayed. Tap
+     listeners need to see every frame, so we can't do this if we have any. */
+  if (!force && !cf->filter_incomplete && dfcode != NULL && cf->dfilter != NULL &&
+      !tap_listeners_require_dissection()) {
+    dfilter_t *old_dfcode;
+
+    if (dfilter_compile(cf->dfilter, &old_dfcode, NULL)) {
+      passed_only = dfilter_narrows(old_dfcode, dfcode);
+      dfilter_free(old_dfcode);
+    }
+  }
+
   /* We have a valid filter.  Replace the current filter. */
   g_free(cf->dfilter);
   cf->dfilter = dftext;
@@ -1524,11 +1790,13 @@ cf_filter_packets(capture_file *cf, gchar *dftext, gboolean force)
     if (cf->read_lock) {
       cf->redissection_queued = RESCAN_SCAN;
     } else if (cf->state != FILE_CLOSED) {
+      /* rescan_packets() takes over dfcode. */
       if (dftext == NULL) {
-        rescan_packets(cf, "Resetting", "Filter", FALSE);
+        rescan_packets(cf, "Resetting", "Filter", FALSE, FALSE, dfcode);
       } else {
-        rescan_packets(cf, "Filtering", dftext, FALSE);
+        rescan_packets(cf, "Filtering", dftext, FALSE, passed_only, dfcode);
       }
+      dfcode = NULL;
     }
   }
 
@@ -1542,6 +1810,8 @@ void
 cf_reftime_packets(capture_file *cf)
 {
   ref_time_packets(cf);
+  /* Relative times, and anything tapped from them, have changed. */
+  cf->dissection_gen++;
 }
 
 void
@@ -1562,7 +1832,7 @@ cf_redissect_packets(capture_file *cf)
 
   if (cf->state != FILE_CLOSED) {
     /* Restart dissection in case no cf_read is pending. */
-    rescan_packets(cf, "Reprocessing", "all packets", TRUE);
+    rescan_packets(cf, "Reprocessing", "all packets", TRUE, FALSE, NULL);
   }
 }
 
@@ -1597,9 +1867,14 @@ cf_read_current_record(capture_file *cf)
    "redissect" is TRUE if we need to make the dissectors reconstruct
    any state information they have (because a preference that affects
    some dissector has changed, meaning some dissector might construct
-   its state differently from the way it was constructed the last time). */
+   its state differently from the way it was constructed the last time).
+
+   "passed_only" is TRUE if the display filter can only match frames that
+   passed the previous one, in which case the other frames aren't read
+   or dissected. */
 static void
-rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect)
+rescan_packets(capture_file *cf, const char *action, const char *action_item, gboolean redissect,
+    gboolean passed_only, dfilter_t *dfcode)
 {
   /* Rescan packets new packet list */
   guint32     framenum;
@@ -1616,7 +1891,6 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   GTimeVal    start_time;
   gchar       status_str[100];
   epan_dissect_t  edt;
-  dfilter_t  *dfcode;
   column_info *cinfo;
   gboolean    create_proto_tree;
   guint       tap_flags;
@@ -1624,6 +1898,8 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   gboolean    compiled;
   guint32     frames_count;
   gboolean    queued_rescan_type = RESCAN_NONE;
+  gboolean    need_dissection;
+  gboolean    use_proto_presence;
 
   /* Rescan in progress, clear pending actions. */
   cf->redissection_queued = RESCAN_NONE;
@@ -1633,12 +1909,14 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   wtap_rec_init(&rec);
   ws_buffer_init(&buf, 1514);
 
-  /* Compile the current display filter.
+  /* Compile the current display filter, unless our caller just did.
    * We assume this will not fail since cf->dfilter is only set in
    * cf_filter IFF the filter was valid.
    */
-  compiled = dfilter_compile(cf->dfilter, &dfcode, NULL);
-  g_assert(!cf->dfilter || (compiled && dfcode));
+  if (dfcode == NULL) {
+    compiled = dfilter_compile(cf->dfilter, &dfcode, NULL);
+    g_assert(!cf->dfilter || (compiled && dfcode));
+  }
 
   /* Get the union of the flags for all tap listeners. */
   tap_flags = union_of_tap_listener_flags();
@@ -1664,6 +1942,20 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
      (tap_flags & TL_REQUIRES_PROTO_TREE) ||
      (redissect && postdissectors_want_hfids()));
 
+  /* If there's no display filter, no tap listener other than dissector
+     helpers, and we're keeping dissector state, every frame passes and
+     nothing will look at the dissection, so we don't have to read or
+     dissect any frames. This makes clearing a filter cheap. */
+  need_dissection = (dfcode != NULL || redissect || tap_listeners_require_dissection());
+
+  /* If the display filter can only match frames with certain protocols,
+     skip the frames we know don't have them, unless the tap listeners
+     want those frames. Redissecting may change what's in each frame. */
+  if (redissect)
+    proto_presence_free(cf);
+  proto_presence_reset_matches(cf);
+  use_proto_presence = (dfcode != NULL && dfilter_requires_protocols(dfcode));
+
   reset_tap_listeners();
   /* Which frame, if any, is the currently selected frame?
      XXX - should the selected frame or the focus frame be the "current"
@@ -1687,6 +1979,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
     /* We might receive new packets while redissecting, and we don't
        want to dissect those before their time. */
     cf->redissecting = TRUE;
+    cf->dissection_gen++;
 
     /* 'reset' dissection session */
     epan_free(cf->epan);
@@ -1751,6 +2044,10 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   frames_count = cf->count;
 
   epan_dissect_init(&edt, cf->epan, create_proto_tree, FALSE);
+  /* Put every protocol in the tree, so that we can remember which
+     protocols each frame has. */
+  if (create_proto_tree)
+    epan_dissect_fake_protocols(&edt, FALSE);
 
   if (redissect) {
     /*
@@ -1837,9 +2134,6 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
     /* Frame dependencies from the previous dissection/filtering are no longer valid. */
     fdata->dependent_of_displayed = 0;
 
-    if (!cf_read_record(cf, fdata, &rec, &buf))
-      break; /* error reading the frame */
-
     /* If the previous frame is displayed, and we haven't yet seen the
        selected frame, remember that frame - it's the closest one we've
        yet seen before the selected frame. */
@@ -1848,9 +2142,20 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
       preceding_frame = prev_frame;
     }
 
-    add_packet_to_packet_list(fdata, cf, &edt, dfcode,
-                                    cinfo, &rec, &buf,
-                                    add_to_packet_list);
+    if (!need_dissection) {
+      set_packet_passed_without_dissection(fdata, cf, TRUE);
+    } else if (passed_only && !fdata->passed_dfilter) {
+      set_packet_passed_without_dissection(fdata, cf, FALSE);
+    } else if (use_proto_presence && !proto_presence_could_match(cf, fdata, dfcode)) {
+      set_packet_passed_without_dissection(fdata, cf, FALSE);
+    } else {
+      if (!cf_read_record(cf, fdata, &rec, &buf))
+        break; /* error reading the frame */
+
+      add_packet_to_packet_list(fdata, cf, &edt, dfcode,
+                                      cinfo, &rec, &buf,
+                                      add_to_packet_list);
+    }
 
     /* If this frame is displayed, and this is the first frame we've
        seen displayed after the selected frame, remember this frame -
@@ -1879,6 +2184,10 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
   /* We are done redissecting the packet list. */
   cf->redissecting = FALSE;
 
+  /* If we stopped early, some frames still have the results of an older
+     filter. */
+  cf->filter_incomplete = (framenum <= frames_count);
+
   if (redissect) {
       frames_count = cf->count;
     /* Clear out what remains of the visited flags and per-frame data
@@ -1983,7 +2292,7 @@ rescan_packets(capture_file *cf, const char *action, const char *action_item, gb
    * change) was requested, the rescan above is aborted and restarted here. */
   if (queued_rescan_type != RESCAN_NONE) {
     redissect = redissect || queued_rescan_type == RESCAN_REDISSECT;
-    rescan_packets(cf, "Reprocessing", "all packets", redissect);
+    rescan_packets(cf, "Reprocessing", "all packets", redissect, FALSE, NULL);
   }
 }
 
@@ -2076,13 +2385,18 @@ typedef enum {
   PSP_FAILED
 } psp_return_t;
 
+/*
+ * If read_records is FALSE, the records aren't read before the callback
+ * is called, and the callback gets an empty record and buffer it can
+ * use to read the record itself if it needs to.
+ */
 static psp_return_t
-process_specified_records(capture_file *cf, packet_range_t *range,
+process_specified_records_common(capture_file *cf, packet_range_t *range,
     const char *string1, const char *string2, gboolean terminate_is_stop,
     gboolean (*callback)(capture_file *, frame_data *,
                          wtap_rec *, Buffer *, void *),
     void *callback_args,
-    gboolean show_progress_bar)
+    gboolean show_progress_bar, gboolean read_records)
 {
   guint32          framenum;
   frame_data      *fdata;
@@ -2179,7 +2493,7 @@ process_specified_records(capture_file *cf, packet_range_t *range,
     }
 
     /* Get the packet */
-    if (!cf_read_record(cf, fdata, &rec, &buf)) {
+    if (read_records && !cf_read_record(cf, fdata, &rec, &buf)) {
       /* Attempt to get the packet failed. */
       ret = PSP_FAILED;
       break;
@@ -2207,9 +2521,24 @@ process_specified_records(capture_file *cf, packet_range_t *range,
   return ret;
 }
 
+static psp_return_t
+process_specified_records(capture_file *cf, packet_range_t *range,
+    const char *string1, const char *string2, gboolean terminate_is_stop,
+    gboolean (*callback)(capture_file *, frame_data *,
+                         wtap_rec *, Buffer *, void *),
+    void *callback_args,
+    gboolean show_progress_bar)
+{
+  return process_specified_records_common(cf, range, string1, string2,
+                                          terminate_is_stop, callback,
+                                          callback_args, show_progress_bar,
+                                          TRUE);
+}
+
 typedef struct {
   epan_dissect_t edt;
   column_info *cinfo;
+  gboolean use_proto_presence;
 } retap_callback_args_t;
 
 static gboolean
@@ -2217,10 +2546,17 @@ retap_packet(capture_file *cf, frame_data *fdata, wtap_rec *rec, Buffer *buf,
              void *argsp)
 {
   retap_callback_args_t *args = (retap_callback_args_t *)argsp;
+  gboolean record_protocols = fdata->visited && args->edt.tree != NULL;
+
+  /* Skip frames that none of the tap listeners could get. */
+  if (args->use_proto_presence && !proto_presence_could_match(cf, fdata, NULL))
+    return TRUE;
 
   epan_dissect_run_with_taps(&args->edt, cf->cd_t, rec,
                              frame_tvbuff_new_buffer(&cf->provider, fdata, buf),
                              fdata, args->cinfo);
+  if (record_protocols)
+    proto_presence_record(cf, fdata, args->edt.tree);
   epan_dissect_reset(&args->edt);
 
   return TRUE;
@@ -2259,10 +2595,19 @@ cf_retap_packets(capture_file *cf)
   create_proto_tree =
     (have_filtering_tap_listeners() || (tap_flags & TL_REQUIRES_PROTO_TREE));
 
+  /* If every tap listener has a filter, we can skip the frames we know
+     none of those filters could match. */
+  proto_presence_reset_matches(cf);
+  callback_args.use_proto_presence = have_filtering_tap_listeners();
+
   /* Reset the tap listeners. */
   reset_tap_listeners();
 
   epan_dissect_init(&callback_args.edt, cf->epan, create_proto_tree, FALSE);
+  /* Put every protocol in the tree, so that we can remember which
+     protocols each frame has. */
+  if (create_proto_tree)
+    epan_dissect_fake_protocols(&callback_args.edt, FALSE);
 
   /* Iterate through the list of packets, dissecting all packets and
      re-running the taps. */
@@ -2678,6 +3023,16 @@ write_pdml_packet(capture_file *cf, frame_data *fdata, wtap_rec *rec,
   return !ferror(args->fh);
 }
 
+static FILE *
+open_export_file(const char *path)
+{
+  FILE *fh = ws_fopen(path, "w");
+
+  if (fh != NULL)
+    setvbuf(fh, NULL, _IOFBF, EXPORT_WRITE_BUFFER_SIZE);
+  return fh;
+}
+
 cf_print_status_t
 cf_write_pdml_packets(capture_file *cf, print_args_t *print_args)
 {
@@ -2685,7 +3040,7 @@ cf_write_pdml_packets(capture_file *cf, print_args_t *print_args)
   FILE         *fh;
   psp_return_t  ret;
 
-  fh = ws_fopen(print_args->file, "w");
+  fh = open_export_file(print_args->file);
   if (fh == NULL)
     return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
 
@@ -2765,7 +3120,7 @@ cf_write_psml_packets(capture_file *cf, print_args_t *print_args)
 
   gboolean proto_tree_needed;
 
-  fh = ws_fopen(print_args->file, "w");
+  fh = open_export_file(print_args->file);
   if (fh == NULL)
     return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
 
@@ -2848,7 +3203,7 @@ cf_write_csv_packets(capture_file *cf, print_args_t *print_args)
   FILE         *fh;
   psp_return_t  ret;
 
-  fh = ws_fopen(print_args->file, "w");
+  fh = open_export_file(print_args->file);
   if (fh == NULL)
     return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
 
@@ -2917,7 +3272,7 @@ cf_write_carrays_packets(capture_file *cf, print_args_t *print_args)
   FILE         *fh;
   psp_return_t  ret;
 
-  fh = ws_fopen(print_args->file, "w");
+  fh = open_export_file(print_args->file);
 
   if (fh == NULL)
     return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
@@ -2986,7 +3341,7 @@ cf_write_json_packets(capture_file *cf, print_args_t *print_args)
   FILE         *fh;
   psp_return_t  ret;
 
-  fh = ws_fopen(print_args->file, "w");
+  fh = open_export_file(print_args->file);
   if (fh == NULL)
     return CF_PRINT_OPEN_ERROR; /* attempt to open destination failed */
 
@@ -3097,10 +3452,6 @@ match_subtree_text(proto_node *node, gpointer data)
   field_info   *fi         = PNODE_FINFO(node);
   gchar         label_str[ITEM_LABEL_LENGTH];
   gchar        *label_ptr;
-  size_t        label_len;
-  guint32       i;
-  guint8        c_char;
-  size_t        c_match    = 0;
 
   /* dissection with an invisible proto tree? */
   g_assert(fi);
@@ -3131,21 +3482,11 @@ match_subtree_text(proto_node *node, gpointer data)
     }
   } else {
     /* Does that label match? */
-    label_len = strlen(label_ptr);
-    for (i = 0; i < label_len; i++) {
-      c_char = label_ptr[i];
-      if (cf->case_type)
-        c_char = g_ascii_toupper(c_char);
-      if (c_char == string[c_match]) {
-        c_match++;
-        if (c_match == string_len) {
-          /* No need to look further; we have a match */
-          mdata->frame_matched = TRUE;
-          mdata->finfo = fi;
-          return;
-        }
-      } else
-        c_match = 0;
+    if (match_text(label_ptr, string, string_len, cf->case_type)) {
+      /* No need to look further; we have a match */
+      mdata->frame_matched = TRUE;
+      mdata->finfo = fi;
+      return;
     }
   }
 
@@ -3154,6 +3495,28 @@ match_subtree_text(proto_node *node, gpointer data)
     proto_tree_children_foreach(node, match_subtree_text, mdata);
 }
 
+/*
+ * Does text contain string? For case insensitive searches string has
+ * already been converted to upper case.
+ */
+static gboolean
+match_text(const char *text, const char *string, size_t string_len,
+           gboolean case_insensitive)
+{
+  if (string_len == 0)
+    return FALSE;
+
+  if (!case_insensitive)
+    return strstr(text, string) != NULL;
+
+  for (; *text != '\0'; text++) {
+    if (g_ascii_toupper(*text) == string[0] &&
+        g_ascii_strncasecmp(text, string, string_len) == 0)
+      return TRUE;
+  }
+  return FALSE;
+}
+
 gboolean
 cf_find_packet_summary_line(capture_file *cf, const char *string,
                             search_direction dir)
@@ -3174,12 +3537,8 @@ match_summary_line(capture_file *cf, frame_data *fdata,
   size_t          string_len = mdata->string_len;
   epan_dissect_t  edt;
   const char     *info_column;
-  size_t          info_column_len;
   match_result    result     = MR_NOTMATCHED;
   gint            colx;
-  guint32         i;
-  guint8          c_char;
-  size_t          c_match    = 0;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3199,26 +3558,13 @@ match_summary_line(capture_file *cf, frame_data *fdata,
     if (cf->cinfo.columns[colx].fmt_matx[COL_INFO]) {
       /* Found it.  See if we match. */
       info_column = edt.pi.cinfo->columns[colx].col_data;
-      info_column_len = strlen(info_column);
       if (cf->regex) {
         if (g_regex_match(cf->regex, info_column, (GRegexMatchFlags) 0, NULL)) {
           result = MR_MATCHED;
           break;
         }
-      } else {
-        for (i = 0; i < info_column_len; i++) {
-          c_char = info_column[i];
-          if (cf->case_type)
-            c_char = g_ascii_toupper(c_char);
-          if (c_char == string[c_match]) {
-            c_match++;
-            if (c_match == string_len) {
-              result = MR_MATCHED;
-              break;
-            }
-          } else
-            c_match = 0;
-        }
+      } else if (match_text(info_column, string, string_len, cf->case_type)) {
+        result = MR_MATCHED;
       }
       break;
     }
@@ -3277,6 +3623,35 @@ cf_find_packet_data(capture_file *cf, const guint8 *string, size_t string_size,
     return find_packet(cf, match_binary, &info, dir);
 }
 
+/*
+ * Return the first occurrence of text, which must be in upper case, in
+ * data ignoring ASCII case, or NULL.
+ */
+static const guint8 *
+find_ascii_nocase(const guint8 *data, size_t data_len, const guint8 *text,
+                  size_t text_len)
+{
+  const guint8 *cur;
+  const guint8 *last_possible;
+  size_t        i;
+
+  if (text_len == 0 || text_len > data_len)
+    return NULL;
+
+  last_possible = data + data_len - text_len;
+  for (cur = data; cur <= last_possible; cur++) {
+    if (g_ascii_toupper(*cur) != text[0])
+      continue;
+    for (i = 1; i < text_len; i++) {
+      if (g_ascii_toupper(cur[i]) != text[i])
+        break;
+    }
+    if (i == text_len)
+      return cur;
+  }
+  return NULL;
+}
+
 static match_result
 match_narrow_and_wide(capture_file *cf, frame_data *fdata,
                       wtap_rec *rec, Buffer *buf, void *criterion)
@@ -3337,9 +3712,7 @@ match_narrow(capture_file *cf, frame_data *fdata,
   match_result  result;
   guint32       buf_len;
   guint8       *pd;
-  guint32       i;
-  guint8        c_char;
-  size_t        c_match    = 0;
+  const guint8 *found;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3350,27 +3723,15 @@ match_narrow(capture_file *cf, frame_data *fdata,
   result = MR_NOTMATCHED;
   buf_len = fdata->cap_len;
   pd = ws_buffer_start_ptr(buf);
-  i = 0;
-  while (i < buf_len) {
-    c_char = pd[i];
-    if (cf->case_type)
-      c_char = g_ascii_toupper(c_char);
-    if (c_char == ascii_text[c_match]) {
-      c_match += 1;
-      if (c_match == textlen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)textlen;
-        break;
-      }
-    }
-    else {
-      g_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
+  if (cf->case_type)
+    found = find_ascii_nocase(pd, buf_len, ascii_text, textlen);
+  else
+    found = epan_memmem(pd, buf_len, ascii_text, (guint)textlen);
+  if (found) {
+    result = MR_MATCHED;
+    /* Save the position of the last character for highlighting the field. */
+    cf->search_pos = (guint32)(found - pd + textlen - 1);
+    cf->search_len = (guint32)textlen;
   }
 
   return result;
@@ -3435,8 +3796,7 @@ match_binary(capture_file *cf, frame_data *fdata,
   match_result  result;
   guint32       buf_len;
   guint8       *pd;
-  guint32       i;
-  size_t        c_match     = 0;
+  const guint8 *found;
 
   /* Load the frame's data. */
   if (!cf_read_record(cf, fdata, rec, buf)) {
@@ -3447,24 +3807,12 @@ match_binary(capture_file *cf, frame_data *fdata,
   result = MR_NOTMATCHED;
   buf_len = fdata->cap_len;
   pd = ws_buffer_start_ptr(buf);
-  i = 0;
-  while (i < buf_len) {
-    if (pd[i] == binary_data[c_match]) {
-      c_match += 1;
-      if (c_match == datalen) {
-        result = MR_MATCHED;
-        cf->search_pos = i; /* Save the position of the last character
-                               for highlighting the field. */
-        cf->search_len = (guint32)datalen;
-        break;
-      }
-    }
-    else {
-      g_assert(i>=c_match);
-      i -= (guint32)c_match;
-      c_match = 0;
-    }
-    i += 1;
+  found = epan_memmem(pd, buf_len, binary_data, (guint)datalen);
+  if (found) {
+    result = MR_MATCHED;
+    /* Save the position of the last character for highlighting the field. */
+    cf->search_pos = (guint32)(found - pd + datalen - 1);
+    cf->search_len = (guint32)datalen;
   }
   return result;
 }
@@ -3813,6 +4161,73 @@ cf_goto_framenum(capture_file *cf)
   return FALSE;
 }
 
+/*
+ * Dissections of the selected packet handed out by cf_share_selected_edt(),
+ * epan_dissect_t * -> shared_edt_t *.
+ */
+typedef struct {
+  Buffer buf;   /* the packet bytes the dissection's tvbuffs point into */
+  guint  refs;  /* one for the capture file while it is cf->edt, one per sharer */
+} shared_edt_t;
+
+static GHashTable *shared_edts = NULL;
+
+/* Drop a reference to a dissection, freeing it once nobody uses it. */
+static void
+cf_free_edt(epan_dissect_t *edt)
+{
+  shared_edt_t *shared = NULL;
+
+  if (shared_edts != NULL)
+    shared = (shared_edt_t *)g_hash_table_lookup(shared_edts, edt);
+  if (shared != NULL) {
+    if (--shared->refs > 0)
+      return;
+    g_hash_table_remove(shared_edts, edt);
+  }
+
+  epan_dissect_free(edt);
+  if (shared != NULL) {
+    ws_buffer_free(&shared->buf);
+    g_free(shared);
+  }
+}
+
+epan_dissect_t *
+cf_share_selected_edt(capture_file *cf)
+{
+  shared_edt_t *shared;
+
+  if (cf->edt == NULL || cf->current_frame == NULL)
+    return NULL;
+
+  if (shared_edts == NULL)
+    shared_edts = g_hash_table_new(g_direct_hash, g_direct_equal);
+
+  shared = (shared_edt_t *)g_hash_table_lookup(shared_edts, cf->edt);
+  if (shared == NULL) {
+    /*
+     * The dissection points into cf->buf, which is overwritten when
+     * the next record is read; let it keep those bytes and give the
+     * capture file a copy of them.
+     */
+    shared = g_new(shared_edt_t, 1);
+    shared->buf = cf->buf;
+    shared->refs = 1;
+    ws_buffer_init(&cf->buf, 1514);
+    ws_buffer_append_buffer(&cf->buf, &shared->buf);
+    g_hash_table_insert(shared_edts, cf->edt, shared);
+  }
+  shared->refs++;
+  return cf->edt;
+}
+
+void
+cf_release_edt(epan_dissect_t *edt)
+{
+  cf_free_edt(edt);
+}
+
 /* Select the packet on a given row. */
 void
 cf_select_packet(capture_file *cf, int row)
@@ -3868,7 +4283,7 @@ cf_select_packet(capture_file *cf, int row)
   dfilter_macro_build_ftv_cache(cf->edt->tree);
 
   if (old_edt != NULL)
-    epan_dissect_free(old_edt);
+    cf_free_edt(old_edt);
 }
 
 /* Unselect the selected packet, if any. */
@@ -3889,7 +4304,7 @@ cf_unselect_packet(capture_file *cf)
 
   /* Destroy the epan_dissect_t for the unselected packet. */
   if (old_edt != NULL)
-    epan_dissect_free(old_edt);
+    cf_free_edt(old_edt);
 }
 
 /*
@@ -3928,6 +4343,8 @@ cf_ignore_frame(capture_file *cf, frame_data *frame)
     frame->ignored = TRUE;
     if (cf->count > cf->ignored_count)
       cf->ignored_count++;
+    /* An ignored frame isn't dissected past the frame protocol. */
+    proto_presence_clear_frame(cf, frame);
   }
 }
 
@@ -3941,6 +4358,7 @@ cf_unignore_frame(capture_file *cf, frame_data *frame)
     frame->ignored = FALSE;
     if (cf->ignored_count > 0)
       cf->ignored_count--;
+    proto_presence_clear_frame(cf, frame);
   }
 }
 
@@ -4052,6 +4470,8 @@ cf_set_user_packet_comment(capture_file *cf, frame_data *fd, const gchar *new_co
     cf->packet_comment_count++;
 
   cap_file_provider_set_user_comment(&cf->provider, fd, new_comment);
+  /* The comment is in its own protocol. */
+  proto_presence_clear_frame(cf, fd);
 
   expert_update_comment_count(cf->packet_comment_count);
 
@@ -4140,6 +4560,36 @@ save_record(capture_file *cf, frame_data *fdata, wtap_rec *rec,
   return TRUE;
 }
 
+/*
+ * Save a record by copying it as it is stored in the capture file, if
+ * that's possible and the user hasn't changed it; otherwise read it
+ * and save it with save_record().
+ */
+static gboolean
+copy_record(capture_file *cf, frame_data *fdata, wtap_rec *rec,
+            Buffer *buf, void *argsp)
+{
+  save_callback_args_t *args = (save_callback_args_t *)argsp;
+  gboolean      copied = FALSE;
+  int           err;
+  gchar        *err_info;
+
+  if (!fdata->has_user_comment) {
+    if (!wtap_dump_copy_record(args->pdh, cf->provider.wth, fdata->file_off,
+                               buf, &copied, &err, &err_info)) {
+      cfile_write_failure_alert_box(NULL, args->fname, err, err_info, fdata->num,
+                                    args->file_type);
+      return FALSE;
+    }
+  }
+  if (copied)
+    return TRUE;
+
+  if (!cf_read_record(cf, fdata, rec, buf))
+    return FALSE;
+  return save_record(cf, fdata, rec, buf, argsp);
+}
+
 /*
  * Can this capture file be written out in any format using Wiretap
  * rather than by copying the raw data?
@@ -4836,8 +5286,11 @@ cf_export_specified_packets(capture_file *cf, const char *fname,
   callback_args.pdh = pdh;
   callback_args.fname = fname;
   callback_args.file_type = save_format;
-  switch (process_specified_records(cf, range, "Writing", "specified records",
-                                    TRUE, save_record, &callback_args, TRUE)) {
+  /* Records that are unchanged are copied without being decoded and
+     re-encoded when the file format allows it. */
+  switch (process_specified_records_common(cf, range, "Writing", "specified records",
+                                           TRUE, copy_record, &callback_args, TRUE,
+                                           FALSE)) {
 
   case PSP_FINISHED:
     /* Completed successfully. */
@@ -4938,6 +5391,7 @@ void
 cf_reload(capture_file *cf) {
   gchar    *filename;
   gboolean  is_tempfile;
+  nstime_t  read_start, read_stop;
   int       err;
 
   if (cf->read_lock) {
@@ -4954,11 +5408,15 @@ cf_reload(capture_file *cf) {
      reopen it as the type of file it was.
 
      Also, "cf_close()" will free "cf->filename", so we must make
-     a copy of it first. */
+     a copy of it first, and it forgets the time range the file was
+     read for. */
   filename = g_strdup(cf->filename);
   is_tempfile = cf->is_tempfile;
+  read_start = cf->read_start;
+  read_stop = cf->read_stop;
   cf->is_tempfile = FALSE;
   if (cf_open(cf, filename, cf->open_type, is_tempfile, &err) == CF_OK) {
+    cf_set_read_time_range(cf, &read_start, &read_stop);
     switch (cf_read(cf, TRUE)) {
 
     case CF_READ_OK:
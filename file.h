@@ -371,6 +371,18 @@ guint32 cf_get_drops(capture_file *cf);
  */
 void cf_set_rfcode(capture_file *cf, dfilter_t *rfcode);
 
+/**
+ * Read only the records in a time range.  cf_read() then starts at the
+ * first time checkpoint before the range if the file has been indexed
+ * with capindex, and stops after it; without an index, it reads the
+ * whole file and skips the records outside the range.
+ *
+ * @param cf the capture file
+ * @param start the start of the range, or an unset time
+ * @param stop the end of the range, not included, or an unset time
+ */
+void cf_set_read_time_range(capture_file *cf, const nstime_t *start, const nstime_t *stop);
+
 /**
  * "Display Filter" packets in the capture file.
  *
@@ -381,6 +393,19 @@ void cf_set_rfcode(capture_file *cf, dfilter_t *rfcode);
  */
 cf_status_t cf_filter_packets(capture_file *cf, gchar *dfilter, gboolean force);
 
+/**
+ * "Display Filter" packets in the capture file, using a filter the caller
+ * has already compiled from the same text.
+ *
+ * @param cf the capture file
+ * @param dfilter the display filter
+ * @param dfcode the compiled display filter or NULL to compile dfilter;
+ *        freed by this function in every case
+ * @param force TRUE if do in any case, FALSE only if dfilter changed
+ * @return one of cf_status_t
+ */
+cf_status_t cf_filter_packets_compiled(capture_file *cf, gchar *dfilter, dfilter_t *dfcode, gboolean force);
+
 /**
  * At least one "Refence Time" flag has changed, rescan all packets.
  *
@@ -616,6 +641,25 @@ void cf_select_packet(capture_file *cf, int row);
  */
 void cf_unselect_packet(capture_file *cf);
 
+/**
+ * Share the dissection of the selected packet, so that it can be shown
+ * elsewhere without dissecting the packet again. The dissection, including
+ * the packet bytes it refers to, stays valid after another packet has been
+ * selected, until it is released with cf_release_edt(). It was made without
+ * columns.
+ *
+ * @param cf the capture file
+ * @return the selected packet's dissection, or NULL if there is none
+ */
+epan_dissect_t *cf_share_selected_edt(capture_file *cf);
+
+/**
+ * Release a dissection obtained from cf_share_selected_edt().
+ *
+ * @param edt the dissection
+ */
+void cf_release_edt(epan_dissect_t *edt);
+
 /**
  * Mark a particular frame in a particular capture.
  *
@@ -170,74 +170,76 @@ fileset_find_by_path(gconstpointer a, gconstpointer b)
     return g_strcmp0(entry->fullname, path);
 }
 
+/* read the time and size of a file; returns FALSE if it can't be read */
+static gboolean
+fileset_read_stat(const char *path, fileset_entry *entry)
+{
+    ws_statb64 buf;
+
+    if (ws_stat64(path, &buf) != 0) {
+        return FALSE;
+    }
+
+    entry->ctime    = ST_CREATE_TIME(buf);
+    entry->mtime    = buf.st_mtime;
+    entry->size     = buf.st_size;
+    entry->stat_pending = FALSE;
+    return TRUE;
+}
+
 /* update the time and size of this file in the list */
 void
 fileset_update_file(const char *path)
 {
-    int fh, result;
-    ws_statb64 buf;
-    fileset_entry *entry = NULL;
     GList *entry_list;
 
-    fh = ws_open( path, O_RDONLY, 0000 /* no creation so don't matter */);
-    if(fh !=  -1) {
-
-        /* Get statistics */
-        result = ws_fstat64( fh, &buf );
+    entry_list = g_list_find_custom(set.entries, path,
+                                    fileset_find_by_path);
 
-        /* Show statistics if they are valid */
-        if( result == 0 ) {
-            entry_list = g_list_find_custom(set.entries, path,
-                                            fileset_find_by_path);
-
-            if (entry_list) {
-                entry = (fileset_entry *) entry_list->data;
-                entry->ctime    = ST_CREATE_TIME(buf);
-                entry->mtime    = buf.st_mtime;
-                entry->size     = buf.st_size;
-            }
-        }
+    if (entry_list) {
+        fileset_read_stat(path, (fileset_entry *) entry_list->data);
+    }
+}
 
-        ws_close(fh);
+/* read the time and size of this entry if that hasn't been done yet */
+void
+fileset_stat_entry(fileset_entry *entry)
+{
+    if (entry->stat_pending) {
+        /* Don't try again if the file has gone away */
+        entry->stat_pending = FALSE;
+        fileset_read_stat(entry->fullname, entry);
     }
 }
 
-/* we know this file is part of the set, so add it */
+/*
+ * we know this file is part of the set, so add it; if stat_now is FALSE,
+ * its time and size are read when fileset_stat_entry() is first called
+ */
 static fileset_entry *
-fileset_add_file(const char *dirname, const char *fname, gboolean current)
+fileset_add_file(const char *dirname, const char *fname, gboolean current, gboolean stat_now)
 {
-    int fh, result;
-    ws_statb64 buf;
-    char *path;
-    fileset_entry *entry = NULL;
-
-
-    path = g_strdup_printf("%s%s", dirname, fname);
-
-    fh = ws_open( path, O_RDONLY, 0000 /* no creation so don't matter */);
-    if(fh !=  -1) {
-
-        /* Get statistics */
-        result = ws_fstat64( fh, &buf );
-
-        /* Show statistics if they are valid */
-        if( result == 0 ) {
-            entry = (fileset_entry *)g_malloc(sizeof(fileset_entry));
+    fileset_entry *entry;
 
-            entry->fullname = g_strdup(path);
-            entry->name     = g_strdup(fname);
-            entry->ctime    = ST_CREATE_TIME(buf);
-            entry->mtime    = buf.st_mtime;
-            entry->size     = buf.st_size;
-            entry->current  = current;
+    entry = (fileset_entry *)g_malloc(sizeof(fileset_entry));
 
-            set.entries = g_list_append(set.entries, entry);
-        }
+    entry->fullname = g_strdup_printf("%s%s", dirname, fname);
+    entry->name     = g_strdup(fname);
+    entry->ctime    = 0;
+    entry->mtime    = 0;
+    entry->size     = 0;
+    entry->current  = current;
+    entry->stat_pending = TRUE;
 
-        ws_close(fh);
+    if (stat_now && !fileset_read_stat(entry->fullname, entry)) {
+        g_free(entry->fullname);
+        g_free(entry->name);
+        g_free(entry);
+        return NULL;
     }
 
-    g_free(path);
+    /* Prepended, as the list is sorted when the directory has been read */
+    set.entries = g_list_prepend(set.entries, entry);
 
     return entry;
 }
@@ -297,7 +299,13 @@ fileset_add_dir(const char *fname, void *window)
             while ((file = ws_dir_read_name(dir)) != NULL) {
                 name = ws_dir_get_name(file);
                 if(fileset_filename_match_pattern(name) && fileset_is_file_in_set(name, get_basename(fname))) {
-                    fileset_add_file(dirname->str, name, strcmp(name, get_basename(fname))== 0 /* current */);
+                    /*
+                     * A ring buffer can have tens of thousands of files,
+                     * and the names already have the creation time, so
+                     * only the current file is looked at now.
+                     */
+                    gboolean current = strcmp(name, get_basename(fname)) == 0;
+                    fileset_add_file(dirname->str, name, current, current /* stat_now */);
                 }
             } /* while */
 
@@ -305,7 +313,7 @@ fileset_add_dir(const char *fname, void *window)
         } /* if */
     } else {
         /* no, this is a "standalone file", just add this one */
-        fileset_add_file(dirname->str, get_basename(fname), TRUE /* current */);
+        fileset_add_file(dirname->str, get_basename(fname), TRUE /* current */, TRUE /* stat_now */);
         /* don't add the file to the dialog here, this will be done in fileset_update_dlg() below */
     }
 
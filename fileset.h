@@ -22,6 +22,7 @@ typedef struct _fileset_entry {
     time_t   mtime;          /* last modified time */
     gint64   size;           /* size of file in bytes */
     gboolean current;        /* is this the currently loaded file? */
+    gboolean stat_pending;   /* ctime, mtime and size haven't been read yet */
 } fileset_entry;
 
 
@@ -67,6 +68,9 @@ extern void fileset_update_dlg(void *window);
 
 extern void fileset_update_file(const char *path);
 
+/* read the time and size of this entry if that hasn't been done yet */
+extern void fileset_stat_entry(fileset_entry *entry);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
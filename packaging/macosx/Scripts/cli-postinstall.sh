@@ -2,6 +2,7 @@
 
 CLI_PATH="$2"
 BINARIES="
+    capindex
     capinfos
     captype
     dftest
@@ -65,6 +65,18 @@ typedef struct FrameRecord_t {
     nstime_t     frame_time;
 } FrameRecord_t;
 
+/* A frame read ahead in file order, waiting for its turn to be written */
+typedef struct PendingFrame_t {
+    wtap_rec     rec;
+    guint8      *data;
+} PendingFrame_t;
+
+/* If no frame has to move to more than this many frames before its
+ * position in the input file, the input is read once more in file order,
+ * holding back only the frames that have to wait, instead of re-reading
+ * every frame at its own offset. */
+#define MAX_PENDING_FRAMES 10000
+
 
 /**************************************************/
 /* Debugging only                                 */
@@ -126,8 +138,8 @@ frame_write(FrameRecord_t *frame, wtap *wth, wtap_dumper *pdh,
 static int
 frames_compare(gconstpointer a, gconstpointer b)
 {
-    const FrameRecord_t *frame1 = *(const FrameRecord_t *const *) a;
-    const FrameRecord_t *frame2 = *(const FrameRecord_t *const *) b;
+    const FrameRecord_t *frame1 = (const FrameRecord_t *) a;
+    const FrameRecord_t *frame2 = (const FrameRecord_t *) b;
 
     const nstime_t *time1 = &frame1->frame_time;
     const nstime_t *time2 = &frame2->frame_time;
@@ -135,6 +147,80 @@ frames_compare(gconstpointer a, gconstpointer b)
     return nstime_cmp(time1, time2);
 }
 
+static void
+pending_frame_free(gpointer data)
+{
+    PendingFrame_t *pending = (PendingFrame_t *)data;
+
+    g_free(pending->rec.opt_comment);
+    g_free(pending->data);
+    g_free(pending);
+}
+
+/*
+ * Write the sorted frames while reading the input once more in file order.
+ * Frames that are read before their turn are kept in memory; the caller
+ * has checked that there are never more than MAX_PENDING_FRAMES of them.
+ */
+static void
+frames_write_in_file_order(GArray *frames, wtap *wth, wtap_dumper *pdh,
+                           const char *infile, const char *outfile)
+{
+    GHashTable *pending_frames;
+    wtap_rec rec;
+    Buffer buf;
+    int    err;
+    gchar  *err_info;
+    gint64 data_offset;
+    guint  frames_read = 0;
+    guint  i;
+
+    pending_frames = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, pending_frame_free);
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+
+    for (i = 0; i < frames->len; i++) {
+        FrameRecord_t *frame = &g_array_index(frames, FrameRecord_t, i);
+        PendingFrame_t *pending;
+
+        /* Read ahead until we have this frame, keeping the others */
+        while (frames_read < frame->num) {
+            if (!wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
+                fprintf(stderr,
+                        "reordercap: An error occurred while re-reading \"%s\".\n",
+                        infile);
+                if (err != 0) {
+                    cfile_read_failure_message("reordercap", infile, err, err_info);
+                }
+                exit(1);
+            }
+            frames_read++;
+
+            pending = g_new(PendingFrame_t, 1);
+            pending->rec = rec;
+            pending->rec.opt_comment = g_strdup(rec.opt_comment);
+            /* The options buffer is scratch space for the reader */
+            memset(&pending->rec.options_buf, 0, sizeof pending->rec.options_buf);
+            pending->data = (guint8 *)g_memdup(ws_buffer_start_ptr(&buf), (guint)ws_buffer_length(&buf));
+            g_hash_table_insert(pending_frames, GUINT_TO_POINTER(frames_read), pending);
+        }
+
+        pending = (PendingFrame_t *)g_hash_table_lookup(pending_frames, GUINT_TO_POINTER(frame->num));
+        pending->rec.ts = frame->frame_time;
+        if (!wtap_dump(pdh, &pending->rec, pending->data, &err, &err_info)) {
+            cfile_write_failure_message("reordercap", infile, outfile, err,
+                                        err_info, frame->num,
+                                        wtap_file_type_subtype(wth));
+            exit(1);
+        }
+        g_hash_table_remove(pending_frames, GUINT_TO_POINTER(frame->num));
+    }
+
+    wtap_rec_cleanup(&rec);
+    ws_buffer_free(&buf);
+    g_hash_table_destroy(pending_frames);
+}
+
 /*
  * General errors and warnings are reported with an console message
  * in reordercap.
@@ -177,8 +263,10 @@ main(int argc, char *argv[])
     wtap_dump_params params;
     int                          ret = EXIT_SUCCESS;
 
-    GPtrArray *frames;
-    FrameRecord_t *prevFrame = NULL;
+    GArray *frames;
+    FrameRecord_t prevFrame;
+    guint max_displacement = 0;
+    wtap *wth_seq = NULL;
 
     int opt;
     static const struct option long_options[] = {
@@ -279,29 +367,28 @@ main(int argc, char *argv[])
         goto clean_exit;
     }
 
-    /* Allocate the array of frame pointers. */
-    frames = g_ptr_array_new();
+    /* Allocate the array of frames. */
+    frames = g_array_new(FALSE, FALSE, sizeof(FrameRecord_t));
 
     /* Read each frame from infile */
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
     while (wtap_read(wth, &rec, &buf, &err, &err_info, &data_offset)) {
-        FrameRecord_t *newFrameRecord;
+        FrameRecord_t newFrameRecord;
 
-        newFrameRecord = g_slice_new(FrameRecord_t);
-        newFrameRecord->num = frames->len + 1;
-        newFrameRecord->offset = data_offset;
+        newFrameRecord.num = frames->len + 1;
+        newFrameRecord.offset = data_offset;
         if (rec.presence_flags & WTAP_HAS_TS) {
-            newFrameRecord->frame_time = rec.ts;
+            newFrameRecord.frame_time = rec.ts;
         } else {
-            nstime_set_unset(&newFrameRecord->frame_time);
+            nstime_set_unset(&newFrameRecord.frame_time);
         }
 
-        if (prevFrame && frames_compare(&newFrameRecord, &prevFrame) < 0) {
+        if (frames->len > 0 && frames_compare(&newFrameRecord, &prevFrame) < 0) {
            wrong_order_count++;
         }
 
-        g_ptr_array_add(frames, newFrameRecord);
+        g_array_append_val(frames, newFrameRecord);
         prevFrame = newFrameRecord;
     }
     wtap_rec_cleanup(&rec);
@@ -313,32 +400,50 @@ main(int argc, char *argv[])
 
     printf("%u frames, %u out of order\n", frames->len, wrong_order_count);
 
-    /* Sort the frames */
+    /* Sort the frames (the sort is stable) */
     if (wrong_order_count > 0) {
-        g_ptr_array_sort(frames, frames_compare);
+        g_array_sort(frames, frames_compare);
     }
 
-    /* Write out each sorted frame in turn */
-    wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
+    /* How far ahead of its position in the input does a frame end up? */
     for (i = 0; i < frames->len; i++) {
-        FrameRecord_t *frame = (FrameRecord_t *)frames->pdata[i];
+        FrameRecord_t *frame = &g_array_index(frames, FrameRecord_t, i);
+
+        if (frame->num - 1 > i && frame->num - 1 - i > max_displacement) {
+            max_displacement = frame->num - 1 - i;
+        }
+    }
+    DEBUG_PRINT("maximum displacement is %u frames\n", max_displacement);
+
+    /* Mostly sorted input is better written in one pass in file order than
+       with a seek per frame; that needs a second, sequential handle. */
+    if ((write_output_regardless || (wrong_order_count > 0)) &&
+        max_displacement <= MAX_PENDING_FRAMES) {
+        wth_seq = wtap_open_offline(infile, WTAP_TYPE_AUTO, &err, &err_info, FALSE);
+    }
+
+    if (wth_seq != NULL) {
+        frames_write_in_file_order(frames, wth_seq, pdh, infile, outfile);
+        wtap_close(wth_seq);
+    } else if (write_output_regardless || (wrong_order_count > 0)) {
+        /* Write out each sorted frame in turn */
+        wtap_rec_init(&rec);
+        ws_buffer_init(&buf, 1514);
+        for (i = 0; i < frames->len; i++) {
+            FrameRecord_t *frame = &g_array_index(frames, FrameRecord_t, i);
 
-        /* Avoid writing if already sorted and configured to */
-        if (write_output_regardless || (wrong_order_count > 0)) {
             frame_write(frame, wth, pdh, &rec, &buf, infile, outfile);
         }
-        g_slice_free(FrameRecord_t, frame);
+        wtap_rec_cleanup(&rec);
+        ws_buffer_free(&buf);
     }
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
 
     if (!write_output_regardless && (wrong_order_count == 0)) {
         printf("Not writing output file because input file is already in order.\n");
     }
 
     /* Free the whole array */
-    g_ptr_array_free(frames, TRUE);
+    g_array_free(frames, TRUE);
 
     /* Close outfile */
     if (!wtap_dump_close(pdh, &err)) {
@@ -63,10 +63,62 @@ typedef struct _ringbuf_data {
   FILE         *pdh;
   char         *io_buffer;              /**< The IO buffer used to write to the file */
   gboolean      group_read_access;   /**< TRUE if files need to be opened with group read access */
+
+  GAsyncQueue  *unlink_queue;        /**< Names of replaced files for unlink_thread to remove */
+  GThread      *unlink_thread;       /**< Thread removing replaced files */
 } ringbuf_data;
 
 static ringbuf_data rb_data;
 
+/* Pushed onto rb_data.unlink_queue to make the unlink thread exit */
+static gchar unlink_thread_stop[1];
+
+/*
+ * Removes the files replaced by ringbuf_open_file().  Unlinking a large
+ * file can take a long time on some file systems, and the capture loop
+ * would not be reading packets in the meantime.
+ */
+static gpointer
+ringbuf_unlink_thread(gpointer data _U_)
+{
+  gchar *name;
+
+  while ((name = (gchar *)g_async_queue_pop(rb_data.unlink_queue)) != unlink_thread_stop) {
+    ws_unlink(name);
+    g_free(name);
+  }
+  return NULL;
+}
+
+/*
+ * Hands an old file to the unlink thread, starting it if necessary;
+ * takes ownership of name.
+ */
+static void
+ringbuf_unlink_later(gchar *name)
+{
+  if (rb_data.unlink_thread == NULL) {
+    rb_data.unlink_queue = g_async_queue_new();
+    rb_data.unlink_thread = g_thread_new("Ringbuffer unlink", ringbuf_unlink_thread, NULL);
+  }
+  g_async_queue_push(rb_data.unlink_queue, name);
+}
+
+/*
+ * Waits until all old files have been removed and stops the unlink thread.
+ */
+static void
+ringbuf_unlink_thread_join(void)
+{
+  if (rb_data.unlink_thread != NULL) {
+    g_async_queue_push(rb_data.unlink_queue, unlink_thread_stop);
+    g_thread_join(rb_data.unlink_thread);
+    rb_data.unlink_thread = NULL;
+    g_async_queue_unref(rb_data.unlink_queue);
+    rb_data.unlink_queue = NULL;
+  }
+}
+
 
 /*
  * create the next filename and open a new binary file with that name
@@ -77,14 +129,7 @@ static int ringbuf_open_file(rb_file *rfile, int *err)
   char    timestr[14+1];
   time_t  current_time;
   struct tm *tm;
-
-  if (rfile->name != NULL) {
-    if (rb_data.unlimited == FALSE) {
-      /* remove old file (if any, so ignore error) */
-      ws_unlink(rfile->name);
-    }
-    g_free(rfile->name);
-  }
+  gchar  *old_name = rfile->name;
 
 #ifdef _WIN32
   _tzset();
@@ -100,6 +145,17 @@ static int ringbuf_open_file(rb_file *rfile, int *err)
   rfile->name = g_strconcat(rb_data.fprefix, "_", filenum, "_", timestr,
                             rb_data.fsuffix, NULL);
 
+  if (old_name != NULL) {
+    if (rb_data.unlimited == FALSE &&
+        (rfile->name == NULL || strcmp(old_name, rfile->name) != 0)) {
+      /* remove old file (if any, so ignore error) */
+      ringbuf_unlink_later(old_name);
+    } else {
+      /* O_TRUNC below takes care of a file with the same name */
+      g_free(old_name);
+    }
+  }
+
   if (rfile->name == NULL) {
     if (err != NULL)
       *err = ENOMEM;
@@ -135,6 +191,8 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
   rb_data.pdh = NULL;
   rb_data.io_buffer = NULL;
   rb_data.group_read_access = group_read_access;
+  rb_data.unlink_queue = NULL;
+  rb_data.unlink_thread = NULL;
 
   /* just to be sure ... */
   if (num_files <= RINGBUFFER_MAX_NUM_FILES) {
@@ -145,7 +203,7 @@ ringbuf_init(const char *capfile_name, guint num_files, gboolean group_read_acce
 
   /* Check file name */
   if (capfile_name == NULL) {
-    /* ringbuffer does not work with temporary files! */
+    /* the caller has to choose a name, even for temporary files */
     return -1;
   }
 
@@ -335,6 +393,8 @@ ringbuf_free(void)
 {
   unsigned int i;
 
+  ringbuf_unlink_thread_join();
+
   if (rb_data.files != NULL) {
     for (i=0; i < rb_data.num_files; i++) {
       if (rb_data.files[i].name != NULL) {
@@ -512,6 +512,48 @@ sharkd_load_cap_file(void)
   return load_cap_file(&cfile, 0, 0);
 }
 
+/* TRUE if cfile was loaded by sharkd_preload_cap_file() */
+static gboolean cfile_preloaded = FALSE;
+
+int
+sharkd_preload_cap_file(const char *fname)
+{
+  int err = 0;
+
+  if (sharkd_cf_open(fname, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
+    return err;
+
+  err = sharkd_load_cap_file();
+  if (err == 0)
+    cfile_preloaded = TRUE;
+  return err;
+}
+
+gboolean
+sharkd_cap_file_preloaded(const char *fname)
+{
+  return cfile_preloaded && cfile.filename && !strcmp(cfile.filename, fname);
+}
+
+int
+sharkd_reopen_cap_file(void)
+{
+  int err = 0;
+
+  /*
+   * A forked session shares the open file descriptor, and so the file
+   * position, with its parent and its siblings; give it its own so that
+   * their random reads don't interfere.
+   */
+  if (cfile.provider.wth)
+  {
+    wtap_fdclose(cfile.provider.wth);
+    if (!wtap_fdreopen(cfile.provider.wth, cfile.filename, &err))
+      return err;
+  }
+  return 0;
+}
+
 frame_data *
 sharkd_get_frame(guint32 framenum)
 {
@@ -587,21 +629,29 @@ sharkd_dissect_request(guint32 framenum, guint32 frame_ref_num, guint32 prev_dis
 int
 sharkd_dissect_columns(frame_data *fdata, guint32 frame_ref_num, guint32 prev_dis_num, column_info *cinfo, gboolean dissect_color)
 {
+  /*
+   * The "frames" request calls this for every row it returns, so the
+   * record buffers are kept from one call to the next rather than
+   * allocated and freed for every frame.
+   */
+  static wtap_rec rec; /* Record metadata */
+  static Buffer buf;   /* Record data */
+  static gboolean rec_initialized = FALSE;
+
   epan_dissect_t edt;
   gboolean create_proto_tree;
-  wtap_rec rec; /* Record metadata */
-  Buffer buf;   /* Record data */
 
   int err;
   char *err_info = NULL;
 
-  wtap_rec_init(&rec);
-  ws_buffer_init(&buf, 1514);
+  if (!rec_initialized) {
+    wtap_rec_init(&rec);
+    ws_buffer_init(&buf, 1514);
+    rec_initialized = TRUE;
+  }
 
   if (!wtap_seek_read(cfile.provider.wth, fdata->file_off, &rec, &buf, &err, &err_info)) {
     col_fill_in_error(cinfo, fdata, FALSE, FALSE /* fill_fd_columns */);
-    wtap_rec_cleanup(&rec);
-    ws_buffer_free(&buf);
     return -1; /* error reading the record */
   }
 
@@ -634,11 +684,12 @@ sharkd_dissect_columns(frame_data *fdata, guint32 frame_ref_num, guint32 prev_di
   }
 
   epan_dissect_cleanup(&edt);
-  wtap_rec_cleanup(&rec);
-  ws_buffer_free(&buf);
   return 0;
 }
 
+/* How often, in frames, sharkd_retap() checks whether the client left */
+#define SHARKD_RETAP_CHECK_FRAMES 4096
+
 int
 sharkd_retap(void)
 {
@@ -678,6 +729,10 @@ sharkd_retap(void)
   reset_tap_listeners();
 
   for (framenum = 1; framenum <= cfile.count; framenum++) {
+    /* Nobody to send the tap output to any more? */
+    if ((framenum & (SHARKD_RETAP_CHECK_FRAMES - 1)) == 0 && sharkd_client_gone())
+      exit(0);
+
     fdata = sharkd_get_frame(framenum);
 
     if (!wtap_seek_read(cfile.provider.wth, fdata->file_off, &rec, &buf, &err, &err_info))
@@ -25,6 +25,9 @@ typedef void (*sharkd_dissect_func_t)(epan_dissect_t *edt, proto_tree *tree, str
 /* sharkd.c */
 cf_status_t sharkd_cf_open(const char *fname, unsigned int type, gboolean is_tempfile, int *err);
 int sharkd_load_cap_file(void);
+int sharkd_preload_cap_file(const char *fname);
+gboolean sharkd_cap_file_preloaded(const char *fname);
+int sharkd_reopen_cap_file(void);
 int sharkd_retap(void);
 int sharkd_filter(const char *dftext, guint8 **result);
 frame_data *sharkd_get_frame(guint32 framenum);
@@ -37,6 +40,7 @@ const char *sharkd_version(void);
 /* sharkd_daemon.c */
 int sharkd_init(int argc, char **argv);
 int sharkd_loop(void);
+gboolean sharkd_client_gone(void);
 
 /* sharkd_session.c */
 int sharkd_session_main(void);
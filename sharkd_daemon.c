@@ -35,6 +35,7 @@
 #ifndef _WIN32
 #include <sys/un.h>
 #include <netinet/tcp.h>
+#include <poll.h>
 #endif
 
 #include <wsutil/strtoi.h>
@@ -52,6 +53,9 @@
 
 static int _use_stdinout = 0;
 static socket_handle_t _server_fd = INVALID_SOCKET;
+#ifndef _WIN32
+static const char *_preload_file = NULL;
+#endif
 
 static socket_handle_t
 socket_init(char *path)
@@ -165,9 +169,21 @@ sharkd_init(int argc, char **argv)
 #endif
 	socket_handle_t fd;
 
+#ifndef _WIN32
+	if (argc == 3)
+	{
+		_preload_file = argv[2];
+		argc--;
+	}
+#endif
+
 	if (argc != 2)
 	{
+#ifndef _WIN32
+		fprintf(stderr, "Usage: %s <-|socket> [capture file]\n", argv[0]);
+#else
 		fprintf(stderr, "Usage: %s <-|socket>\n", argv[0]);
+#endif
 		fprintf(stderr, "\n");
 
 		fprintf(stderr, "<socket> examples:\n");
@@ -178,6 +194,11 @@ sharkd_init(int argc, char **argv)
 		fprintf(stderr, " - tcp:127.0.0.1:4446 - listen on TCP port 4446\n");
 #endif
 		fprintf(stderr, "\n");
+#ifndef _WIN32
+		fprintf(stderr, "[capture file] is read and dissected once at startup;\n");
+		fprintf(stderr, "sessions that load it then share the result.\n");
+		fprintf(stderr, "\n");
+#endif
 		return -1;
 	}
 
@@ -216,9 +237,57 @@ sharkd_init(int argc, char **argv)
 	return 0;
 }
 
+/*
+ * TRUE if the client of this session has closed its connection, so that
+ * long requests can give up rather than compute a reply nobody reads.
+ */
+gboolean
+sharkd_client_gone(void)
+{
+#ifndef _WIN32
+	struct pollfd pfd;
+	char c;
+
+	/* With "-" the input may be closed while the output is still wanted */
+	if (_use_stdinout)
+		return FALSE;
+
+	/* A client may shut down its sending side after the last request
+	 * and still wait for the replies, so an EOF on the socket (recv()
+	 * returning 0) doesn't count. Only a hangup, an error or a reset
+	 * connection does. */
+	pfd.fd = 0;
+	pfd.events = 0;
+	pfd.revents = 0;
+	if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR)))
+		return TRUE;
+
+	/* With MSG_PEEK any request already sent stays where it is. */
+	if (recv(0, &c, 1, MSG_PEEK | MSG_DONTWAIT) == -1 && errno == ECONNRESET)
+		return TRUE;
+
+	return FALSE;
+#else
+	return FALSE;
+#endif
+}
+
 int
 sharkd_loop(void)
 {
+#ifndef _WIN32
+	if (_preload_file)
+	{
+		/* Sessions are forked from this process, so they get the frames
+		 * and the dissector state of the first pass copy-on-write. */
+		if (sharkd_preload_cap_file(_preload_file) != 0)
+		{
+			fprintf(stderr, "cannot load %s\n", _preload_file);
+			return -1;
+		}
+	}
+#endif
+
 	if (_use_stdinout)
 	{
 		return sharkd_session_main();
@@ -253,6 +322,9 @@ sharkd_loop(void)
 			dup2(fd, 1);
 			close(fd);
 
+			if (_preload_file && sharkd_reopen_cap_file() != 0)
+				exit(1);
+
 			exit(sharkd_session_main());
 		}
 
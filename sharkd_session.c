@@ -76,9 +76,20 @@
 struct sharkd_filter_item
 {
 	guint8 *filtered; /* can be NULL if all frames are matching for given filter. */
+	gsize filtered_size; /* size of filtered in bytes */
+	GList *lru_link; /* node in filter_lru, its data is the key in filter_table */
 };
 
+/*
+ * Results of earlier filters are kept until they take more than
+ * SHARKD_FILTER_CACHE_MAX_BYTES together; then the ones used least
+ * recently are dropped.
+ */
+#define SHARKD_FILTER_CACHE_MAX_BYTES (64 * 1024 * 1024)
+
 static GHashTable *filter_table = NULL;
+static GQueue filter_lru = G_QUEUE_INIT; /* least recently used first */
+static gsize filter_cache_bytes = 0;
 
 static json_dumper dumper = {0};
 
@@ -198,6 +209,7 @@ sharkd_session_filter_data(const char *filter)
 	if (!l)
 	{
 		guint8 *filtered = NULL;
+		char *key;
 
 		int ret = sharkd_filter(filter, &filtered);
 
@@ -206,8 +218,30 @@ sharkd_session_filter_data(const char *filter)
 
 		l = (struct sharkd_filter_item *) g_malloc(sizeof(struct sharkd_filter_item));
 		l->filtered = filtered;
+		l->filtered_size = filtered ? 2 + (cfile.count / 8) : 0;
+
+		/* make room, but never drop the result we're about to return */
+		while (filter_cache_bytes + l->filtered_size > SHARKD_FILTER_CACHE_MAX_BYTES &&
+		       !g_queue_is_empty(&filter_lru))
+		{
+			char *old_key = (char *) g_queue_pop_head(&filter_lru);
+			struct sharkd_filter_item *old = (struct sharkd_filter_item *) g_hash_table_lookup(filter_table, old_key);
+
+			filter_cache_bytes -= old->filtered_size;
+			g_hash_table_remove(filter_table, old_key);
+		}
 
-		g_hash_table_insert(filter_table, g_strdup(filter), l);
+		key = g_strdup(filter);
+		g_hash_table_insert(filter_table, key, l);
+		g_queue_push_tail(&filter_lru, key);
+		l->lru_link = g_queue_peek_tail_link(&filter_lru);
+		filter_cache_bytes += l->filtered_size;
+	}
+	else if (l->lru_link != filter_lru.tail)
+	{
+		/* move it to the most recently used end */
+		g_queue_unlink(&filter_lru, l->lru_link);
+		g_queue_push_tail_link(&filter_lru, l->lru_link);
 	}
 
 	return l;
@@ -546,6 +580,13 @@ sharkd_session_process_load(const char *buf, const jsmntok_t *tokens, int count)
 	if (!tok_file)
 		return;
 
+	if (sharkd_cap_file_preloaded(tok_file))
+	{
+		/* already dissected before this session was forked */
+		sharkd_json_simple_reply(0, NULL);
+		return;
+	}
+
 	if (sharkd_cf_open(tok_file, WTAP_TYPE_AUTO, FALSE, &err) != CF_OK)
 	{
 		sharkd_json_simple_reply(err, NULL);
@@ -2182,7 +2223,7 @@ sharkd_session_process_tap(char *buf, const jsmntok_t *tokens, int count)
 	int i;
 
 	rtpstream_tapinfo_t rtp_tapinfo =
-		{ NULL, NULL, NULL, NULL, 0, NULL, 0, TAP_ANALYSE, NULL, NULL, NULL, FALSE };
+		{ NULL, NULL, NULL, NULL, 0, NULL, 0, TAP_ANALYSE, NULL, NULL, NULL, FALSE, NULL };
 
 	for (i = 0; i < 16; i++)
 	{
@@ -4305,6 +4346,8 @@ sharkd_session_main(void)
 	}
 
 	g_hash_table_destroy(filter_table);
+	g_queue_clear(&filter_lru);
+	filter_cache_bytes = 0;
 	g_free(tokens);
 
 	return 0;
@@ -95,6 +95,11 @@ def program(program_path, request):
     return resolver
 
 
+@fixtures.fixture(scope='session')
+def cmd_capindex(program):
+    return program('capindex')
+
+
 @fixtures.fixture(scope='session')
 def cmd_capinfos(program):
     return program('capinfos')
@@ -86,6 +86,7 @@ test("Field.type-5", f_dhcp_opt.type == ftypes.UINT8)
 
 -- make sure can't create a FieldInfo outside tap
 test("Field__call-1",not pcall(makeFieldInfo,f_eth_src))
+test("Field.values-1",not pcall(Field.values,{ f_eth_src }))
 
 local tap = Listener.new()
 
@@ -164,6 +165,19 @@ function tap.packet(pinfo,tvb)
     test("FieldInfo.len-1", fi_eth_src.len == 6)
     test("FieldInfo.len-2",not pcall(setFieldInfo,fi_eth_src,"len",6))
 
+    testing("Field.values")
+
+    local values = Field.values({ f_udp_srcport, f_eth_mac, f_frame_proto })
+    test("Field.values-2", values[1] == finfo_udp_srcport.value)
+    test("Field.values-3", values[2] == eth_macs[1].value)
+    test("Field.values-4", values[3] == f_frame_proto().value)
+
+    local reused = Field.values({ f_ip_dst, f_udp_dstport }, values)
+    test("Field.values-5", reused == values)
+    test("Field.values-6", values[1] == f_ip_dst().value)
+    test("Field.values-7", values[2] == f_udp_dstport().value)
+    test("Field.values-9",not pcall(Field.values,{ f_eth_src, "eth.dst" }))
+
     if packet_count == 4 then
         print("\n-----------------------------\n")
         print("All tests passed!\n\n")
@@ -0,0 +1,76 @@
+#
+# -*- coding: utf-8 -*-
+# Wireshark tests
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Capindex tests'''
+
+import os
+import shutil
+import subprocesstest
+import fixtures
+
+
+@fixtures.fixture
+def index_capture(cmd_capindex, capture_file):
+    '''Copy dhcp.pcap and index it, returning the path of the copy.'''
+    def index_capture_real(self):
+        indexed_pcap = self.filename_from_id('indexed.pcap')
+        shutil.copy(capture_file('dhcp.pcap'), indexed_pcap)
+        self.assertRun((cmd_capindex, indexed_pcap))
+        return indexed_pcap
+    return index_capture_real
+
+
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_capindex(subprocesstest.SubprocessTestCase):
+    def test_capindex_build(self, cmd_capindex, index_capture):
+        '''Index dhcp.pcap and list its conversations'''
+        indexed_capture = index_capture(self)
+        # The DHCP client broadcasts and the server answers it unicast.
+        self.assertTrue(self.grepOutput(r'^4 records, 2 conversations$'))
+        self.assertTrue(os.path.exists(indexed_capture + '.idx'))
+        self.assertRun((cmd_capindex, '-l', indexed_capture))
+        self.assertTrue(self.grepOutput(r'^\s+1\s+udp\s+0\.0\.0\.0:68\s+255\.255\.255\.255:67\s+2$'))
+        self.assertTrue(self.grepOutput(r'^\s+2\s+udp\s+192\.168\.0\.1:67\s+192\.168\.0\.10:68\s+2$'))
+
+    def test_capindex_extract_flow(self, cmd_capindex, index_capture):
+        '''Extract one conversation'''
+        indexed_capture = index_capture(self)
+        testout_file = self.filename_from_id('testout.pcap')
+        self.assertRun((cmd_capindex, '-e', '2', '-w', testout_file, indexed_capture))
+        self.checkPacketCount(2, cap_file=testout_file)
+
+    def test_capindex_extract_time_range(self, cmd_capindex, index_capture):
+        '''Extract a time range'''
+        indexed_capture = index_capture(self)
+        # The capture is from 2004; the ranges are wide enough for any time zone.
+        testout_file = self.filename_from_id('testout.pcap')
+        self.assertRun((cmd_capindex, '-A', '2004-01-01 00:00:00', '-B', '2005-01-01 00:00:00',
+            '-w', testout_file, indexed_capture))
+        self.checkPacketCount(4, cap_file=testout_file)
+        self.assertRun((cmd_capindex, '-A', '2005-01-01 00:00:00',
+            '-w', testout_file, indexed_capture))
+        self.checkPacketCount(0, cap_file=testout_file)
+
+    def test_capindex_stale_index(self, cmd_capindex, index_capture):
+        '''Refuse an index made before the capture was modified'''
+        indexed_capture = index_capture(self)
+        stat = os.stat(indexed_capture)
+        os.utime(indexed_capture, (stat.st_atime, stat.st_mtime + 10))
+        testout_file = self.filename_from_id('testout.pcap')
+        self.assertRun((cmd_capindex, '-e', '1', '-w', testout_file, indexed_capture),
+            expected_return=2)
+        self.assertTrue(self.grepOutput('index it again'))
+
+    def test_tshark_read_time_range(self, cmd_tshark, index_capture):
+        '''TShark reads a time range of an indexed capture'''
+        indexed_capture = index_capture(self)
+        self.assertRun((cmd_tshark, '-r', indexed_capture,
+            '--read-start-time', '2004-01-01 00:00:00', '--read-stop-time', '2005-01-01 00:00:00'))
+        self.assertEqual(self.countOutput(), 4)
+        self.assertRun((cmd_tshark, '-r', indexed_capture,
+            '--read-start-time', '2005-01-01 00:00:00'))
+        self.assertEqual(self.countOutput(), 0)
@@ -284,6 +284,28 @@ class case_tshark_z_expert(subprocesstest.SubprocessTestCase):
         self.assertFalse(self.grepOutput('Chats'))
 
 
+@fixtures.mark_usefixtures('test_env')
+@fixtures.uses_fixtures
+class case_tshark_merge_stats(subprocesstest.SubprocessTestCase):
+    def test_tshark_merge_stats_rate(self, cmd_tshark, cmd_editcap, capture_file):
+        '''Merged rates cover the time span of all merged captures'''
+        # dhcp.pcap has 4 frames of 314 and 342 bytes in 70.345 ms.
+        # The copy is shifted by 1 s, so the merged trees hold 8 frames
+        # in 1070.345 ms, or 0.0075 frames per ms.
+        shifted_pcap = self.filename_from_id('shifted.pcap')
+        stats_1 = self.filename_from_id('stats_1.txt')
+        stats_2 = self.filename_from_id('stats_2.txt')
+        self.assertRun((cmd_editcap, '-t', '1',
+            capture_file('dhcp.pcap'), shifted_pcap))
+        self.assertRun((cmd_tshark, '-q', '-z', 'plen,tree',
+            '--export-stats', stats_1, '-r', capture_file('dhcp.pcap')))
+        self.assertRun((cmd_tshark, '-q', '-z', 'plen,tree',
+            '--export-stats', stats_2, '-r', shifted_pcap))
+        self.assertRun((cmd_tshark, '--merge-stats', stats_1,
+            '--merge-stats', stats_2))
+        self.assertTrue(self.grepOutput(r'Packet Lengths\s+8\s+\S+\s+314\s+342\s+0\.0075\s'))
+
+
 @fixtures.mark_usefixtures('test_env')
 @fixtures.uses_fixtures
 class case_tshark_extcap(subprocesstest.SubprocessTestCase):
@@ -58,3 +58,28 @@ class case_membership(unittest.TestCase):
         dfilter = 'frame.number in {1 "foo"}'
         error = '"foo" cannot be converted to Unsigned integer, 4 bytes.'
         checkDFilterFail(dfilter, error)
+
+    def test_membership_12_hashed_integer(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1 2 3 4 80}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_13_hashed_integer_no_match(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1 2 3 4 5}'
+        checkDFilterCount(dfilter, 0)
+
+    def test_membership_14_hashed_and_range(self, checkDFilterCount):
+        dfilter = 'tcp.port in {1 2 3 4 3260..3270}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_15_hashed_string(self, checkDFilterCount):
+        dfilter = 'http.request.method in {"PUT" "POST" "DELETE" "GET"}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_16_hashed_ipv4(self, checkDFilterCount):
+        dfilter = 'ip.src in {10.0.0.1 10.0.0.2 10.0.0.3 10.0.0.4 10.0.0.5}'
+        checkDFilterCount(dfilter, 1)
+
+    def test_membership_17_hashed_ipv4_subnet(self, checkDFilterCount):
+        # Members with a netmask are not hashed and still match the subnet.
+        dfilter = 'ip.dst in {10.0.0.1 10.0.0.2 10.0.0.3 10.0.0.4 207.46.0.0/16}'
+        checkDFilterCount(dfilter, 1)
@@ -233,6 +233,10 @@ static FILE       *input_file  = NULL;
 static char *output_filename;
 static FILE       *output_file = NULL;
 
+/* Output buffer, so that small writes of each record are batched */
+#define OUTPUT_BUF_SIZE (1024 * 1024)
+static char       *output_buf = NULL;
+
 /* Offset base to parse */
 static guint32 offset_base = 16;
 
@@ -422,9 +426,15 @@ static int
 write_byte(const char *str)
 {
     guint32 num;
+    int     hi, lo;
 
-    if (parse_num(str, FALSE, &num) != EXIT_SUCCESS)
+    /* The scanner hands us two hex digits; don't bother strtoul() with them */
+    if ((hi = g_ascii_xdigit_value(str[0])) >= 0 &&
+        (lo = g_ascii_xdigit_value(str[1])) >= 0) {
+        num = (hi << 4) | lo;
+    } else if (parse_num(str, FALSE, &num) != EXIT_SUCCESS) {
         return EXIT_FAILURE;
+    }
 
     packet_buf[curr_offset] = (guint8) num;
     curr_offset++;
@@ -1869,6 +1879,9 @@ main(int argc, char *argv[])
     assert(input_file  != NULL);
     assert(output_file != NULL);
 
+    output_buf = (char *)g_malloc(OUTPUT_BUF_SIZE);
+    setvbuf(output_file, output_buf, _IOFBF, OUTPUT_BUF_SIZE);
+
     if (write_file_header() != EXIT_SUCCESS) {
         ret = EXIT_FAILURE;
         goto clean_exit;
@@ -1921,6 +1934,7 @@ clean_exit:
     if (output_file) {
         fclose(output_file);
     }
+    g_free(output_buf);
     return ret;
 }
 
@@ -38,6 +38,7 @@
 #include <wsutil/file_util.h>
 #include <wsutil/privileges.h>
 #include <wsutil/report_message.h>
+#include <wsutil/startup_timings.h>
 #include <cli_main.h>
 #include <version_info.h>
 
@@ -426,6 +427,9 @@ main(int argc, char *argv[])
     case 'X':
       ex_opt_add(optarg);
       break;
+    case LONGOPT_STARTUP_TIMINGS: /* time the steps of epan_init() */
+      startup_timings_enable();
+      break;
     default:
       break;
     }
@@ -762,6 +766,7 @@ main(int argc, char *argv[])
     case LONGOPT_ENABLE_HEURISTIC: /* enable heuristic dissection of protocol */
     case LONGOPT_DISABLE_HEURISTIC: /* disable heuristic dissection of protocol */
     case LONGOPT_ENABLE_PROTOCOL: /* enable dissection of protocol (that is disabled by default) */
+    case LONGOPT_STARTUP_TIMINGS: /* write startup timings as JSON */
       if (!dissect_opts_handle_opt(opt, optarg)) {
         exit_status = INVALID_OPTION;
         goto clean_exit;
@@ -776,6 +781,11 @@ main(int argc, char *argv[])
     }
   }
 
+  if (!dissect_opts_write_startup_timings()) {
+    exit_status = INVALID_OPTION;
+    goto clean_exit;
+  }
+
   /* If we specified output fields, but not the output field type... */
   if (WRITE_FIELDS != output_action && 0 != output_fields_num_fields(output_fields)) {
         cmdarg_err("Output fields were specified with \"-e\", "
@@ -978,6 +988,8 @@ clean_exit:
 
   col_cleanup(&cfile.cinfo);
   wtap_cleanup();
+  /* In case we bailed out before writing the timings */
+  startup_timings_cleanup();
   return exit_status;
 }
 
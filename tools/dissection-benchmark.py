@@ -0,0 +1,209 @@
+#!/usr/bin/env python3
+#
+# Measure how fast TShark dissects a fixed set of captures
+#
+# Wireshark - Network traffic analyzer
+# By Gerald Combs <gerald@wireshark.org>
+# Copyright 1998 Gerald Combs
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Replay a corpus of captures through TShark and report throughput.
+
+Each protocol mix is read a number of times with the same preferences
+the test suite uses, so decryption keys from test/keys apply. For each
+mix the fastest run is reported, after subtracting the time TShark
+needs to start up and read an empty file. The results are written as
+JSON so that they can be compared between builds, e.g.
+
+    tools/dissection-benchmark.py --program-path build/run > new.json
+'''
+
+import argparse
+import json
+import os
+import platform
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+this_dir = os.path.dirname(os.path.abspath(__file__))
+test_dir = os.path.join(os.path.dirname(this_dir), 'test')
+capture_dir = os.path.join(test_dir, 'captures')
+config_dir = os.path.join(test_dir, 'config')
+key_dir = os.path.join(test_dir, 'keys')
+
+# UAT files populated from test/config, as test/fixtures_ws.py does.
+uat_files = [
+    '80211_keys',
+    'dtlsdecrypttablefile',
+    'esp_sa',
+    'ssl_keys',
+    'c1222_decryption_table',
+    'ikev1_decryption_table',
+    'ikev2_decryption_table',
+]
+
+# Protocol mixes: name, capture files, extra TShark arguments.
+# The corpus has no GTP, S1AP or other PER captures; add them here when it does.
+corpus = [
+    ('tcp-http', ['http.pcap', 'http-ooo.pcap', 'tcp-badsegments.pcap'], []),
+    ('http2-tls', ['http2-data-reassembly.pcap'], [
+        '-o', 'tls.keylog_file:' + os.path.join(key_dir, 'http2-data-reassembly.keys'),
+        '-d', 'tcp.port==8443,tls',
+    ]),
+    ('tls', ['tls12-dsb.pcapng', 'tls13-rfc8446.pcap', 'rsasnakeoil2.pcap'], [
+        '-o', 'tls.keylog_file:' + os.path.join(key_dir, 'tls13-rfc8446.keys'),
+    ]),
+    ('sip-rtp', ['sip.pcapng'], []),
+    ('ieee80211', ['wpa-Induction.pcap.gz', 'wpa-eap-tls.pcap.gz'], [
+        '-o', 'wlan.enable_decryption:TRUE',
+    ]),
+    ('smb2', ['smb300-aes-128-ccm.pcap.gz'], [
+        '-o', 'uat:smb2_seskey_list:1900009c003c0000,9a9ea16a0cdbeb6064772318073f172f',
+    ]),
+    ('dns-icmp', ['dns+icmp.pcapng.gz', 'icmp.pcapng.gz'], []),
+    # ASN.1 BER: Kerberos, C12.22 and the X.509 certificates in IKE.
+    ('asn1-ber', ['krb-816.pcap.gz', 'c1222_std_example8.pcap', 'ikev1-certs.pcap'], []),
+]
+
+# How much work TShark does per packet.
+modes = {
+    'quiet': ['-q'],            # dissect, no output
+    'summary': [],              # one summary line per packet
+    'tree': ['-V'],             # full protocol tree for every packet
+}
+
+def program_name(program_path, name):
+    path = os.path.join(program_path, name)
+    if sys.platform.startswith('win32'):
+        path += '.exe'
+    return path
+
+def make_env(home):
+    env = os.environ.copy()
+    env['TZ'] = 'UTC'
+    env['APPDATA' if sys.platform.startswith('win32') else 'HOME'] = home
+    env['WIRESHARK_RUN_FROM_BUILD_DIRECTORY'] = '1'
+    if sys.platform.startswith('win32'):
+        conf_path = os.path.join(home, 'Wireshark')
+    else:
+        conf_path = os.path.join(home, '.config', 'wireshark')
+    os.makedirs(conf_path)
+    key_dir_path = os.path.join(key_dir, '').replace('\\', '\\x5c')
+    for uat in uat_files:
+        with open(os.path.join(config_dir, uat + '.tmpl'), 'r') as f:
+            contents = f.read()
+        with open(os.path.join(conf_path, uat), 'w') as f:
+            f.write(contents.replace('TEST_KEYS_DIR', key_dir_path))
+    return env
+
+def run_tshark(cmd, env):
+    '''Run a command, returning (elapsed seconds, peak RSS in bytes or None).'''
+    start = time.perf_counter()
+    proc = subprocess.Popen(cmd, env=env, stdout=subprocess.DEVNULL, stderr=subprocess.PIPE)
+    if hasattr(os, 'wait4'):
+        _pid, status, rusage = os.wait4(proc.pid, 0)
+        elapsed = time.perf_counter() - start
+        proc.returncode = os.WEXITSTATUS(status) if os.WIFEXITED(status) else -1
+        stderr = proc.stderr.read()
+        proc.stderr.close()
+        # ru_maxrss is in kilobytes except on macOS.
+        peak_rss = rusage.ru_maxrss if sys.platform == 'darwin' else rusage.ru_maxrss * 1024
+    else:
+        _stdout, stderr = proc.communicate()
+        elapsed = time.perf_counter() - start
+        peak_rss = None
+    if proc.returncode != 0:
+        raise RuntimeError('{} failed: {}'.format(' '.join(cmd), stderr.decode('utf-8', 'replace')))
+    return elapsed, peak_rss
+
+def capture_size(capinfos, env, files):
+    '''Return the number of packets and bytes in the given files.'''
+    packets = 0
+    data_bytes = 0
+    for capture in files:
+        out = subprocess.check_output((capinfos, '-T', '-r', '-c', '-d', capture), env=env)
+        fields = out.decode('utf-8').strip().split('\t')
+        packets += int(fields[1])
+        data_bytes += int(fields[2])
+    return packets, data_bytes
+
+def main():
+    parser = argparse.ArgumentParser(description='Measure TShark dissection throughput.')
+    parser.add_argument('--program-path', default=os.path.curdir,
+                        help='directory with the tshark and capinfos binaries (default: %(default)s)')
+    parser.add_argument('--mode', choices=sorted(modes), default='summary',
+                        help='what TShark prints for each packet (default: %(default)s)')
+    parser.add_argument('--repeat', type=int, default=5,
+                        help='runs per mix; the fastest one is reported (default: %(default)s)')
+    parser.add_argument('--mix', action='append',
+                        help='only run the given protocol mix (may be repeated)')
+    parser.add_argument('--output', '-o', help='write the JSON results to this file instead of stdout')
+    args = parser.parse_args()
+
+    tshark = program_name(args.program_path, 'tshark')
+    capinfos = program_name(args.program_path, 'capinfos')
+    for program in (tshark, capinfos):
+        if not os.access(program, os.X_OK):
+            parser.error('{} not found; use --program-path'.format(program))
+
+    home = tempfile.mkdtemp(prefix='wireshark-benchmark-home-')
+    try:
+        env = make_env(home)
+        base_cmd = [tshark, '-n', '-o', 'tcp.desegment_tcp_streams:TRUE'] + modes[args.mode]
+
+        startup = min(run_tshark(base_cmd + ['-r', os.path.join(capture_dir, 'empty.pcap')], env)[0]
+                      for _ in range(args.repeat))
+
+        results = []
+        for name, files, extra_args in corpus:
+            if args.mix and name not in args.mix:
+                continue
+            paths = [os.path.join(capture_dir, f) for f in files]
+            packets, data_bytes = capture_size(capinfos, env, paths)
+            best = None
+            peak_rss = None
+            for _ in range(args.repeat):
+                elapsed = 0.0
+                for path in paths:
+                    seconds, rss = run_tshark(base_cmd + extra_args + ['-r', path], env)
+                    elapsed += max(seconds - startup, 1e-6)
+                    if rss is not None:
+                        peak_rss = max(peak_rss or 0, rss)
+                best = elapsed if best is None else min(best, elapsed)
+            results.append({
+                'mix': name,
+                'files': files,
+                'packets': packets,
+                'bytes': data_bytes,
+                'seconds': best,
+                'packets_per_second': packets / best,
+                'bytes_per_second': data_bytes / best,
+                'peak_rss_bytes': peak_rss,
+            })
+            sys.stderr.write('{}: {:.0f} packets/s\n'.format(name, packets / best))
+
+        report = {
+            'tshark': subprocess.check_output((tshark, '--version'), env=env).decode('utf-8').splitlines()[0],
+            'platform': platform.platform(),
+            'mode': args.mode,
+            'repeat': args.repeat,
+            'startup_seconds': startup,
+            'results': results,
+        }
+    finally:
+        shutil.rmtree(home, ignore_errors=True)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(report, f, indent=2)
+            f.write('\n')
+    else:
+        json.dump(report, sys.stdout, indent=2)
+        sys.stdout.write('\n')
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+#
+# Compute TShark statistics trees over many capture files in parallel
+#
+# Wireshark - Network traffic analyzer
+# By Gerald Combs <gerald@wireshark.org>
+# Copyright 1998 Gerald Combs
+#
+# SPDX-License-Identifier: GPL-2.0-or-later
+#
+'''Run TShark statistics over a set of capture files, several at a time.
+
+Each file, e.g. one of a ring buffer set, is read by its own TShark
+process, which writes its statistics trees with --export-stats. The
+results are then added up with --merge-stats and printed, as if all
+files had been read by one TShark:
+
+    tools/tshark-parallel-stats.py --jobs 8 -z http,tree -z ip_hosts,tree ring_*.pcapng
+
+Rates are computed over the time from the first to the last packet of
+all files, so the files may be read in any order.
+
+Only statistics trees (-z <tree>,tree[,filter]) can be merged. io,stat,
+io,phs and expert keep their own per-tap state and have no export format
+yet; their intervals and hierarchies would need one each. State that
+spans files, such as a conversation split across two files, is seen
+separately in each file.
+'''
+
+import argparse
+import concurrent.futures
+import os
+import re
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# Files merged by one TShark process; larger sets are merged in steps.
+merge_batch = 200
+
+def program_name(program_path, name):
+    path = os.path.join(program_path, name)
+    if sys.platform.startswith('win32'):
+        path += '.exe'
+    return path
+
+def run(cmd):
+    proc = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+    if proc.returncode != 0:
+        raise RuntimeError('{} failed: {}'.format(' '.join(cmd), proc.stderr.decode('utf-8', 'replace')))
+    return proc.stdout
+
+def export_stats(tshark, tshark_args, capture, stats_file):
+    run([tshark, '-n', '-q', '-r', capture] + tshark_args + ['--export-stats', stats_file])
+    return stats_file
+
+def merge_args(stats_files):
+    args = []
+    for stats_file in stats_files:
+        args += ['--merge-stats', stats_file]
+    return args
+
+def main():
+    parser = argparse.ArgumentParser(description='Compute TShark statistics trees over many files in parallel.')
+    parser.add_argument('--program-path', default=os.path.curdir,
+                        help='directory with the tshark binary (default: %(default)s)')
+    parser.add_argument('--jobs', '-j', type=int, default=os.cpu_count() or 1,
+                        help='TShark processes to run at the same time (default: %(default)s)')
+    parser.add_argument('-z', dest='stats', action='append', required=True,
+                        help='statistics tree to compute, e.g. http,tree (may be repeated)')
+    parser.add_argument('-o', dest='prefs', action='append', default=[],
+                        help='override a preference, as with TShark (may be repeated)')
+    parser.add_argument('--output', help='write the merged trees with --export-stats to this file instead of printing them')
+    parser.add_argument('files', nargs='+', help='capture files to read')
+    args = parser.parse_args()
+
+    for stat in args.stats:
+        if not re.match(r'^[^,]+,tree(,.*)?$', stat):
+            parser.error('-z {}: only statistics trees (-z <tree>,tree) can be merged'.format(stat))
+    if args.jobs < 1:
+        parser.error('--jobs must be at least 1')
+
+    tshark = program_name(args.program_path, 'tshark')
+    if not os.access(tshark, os.X_OK):
+        parser.error('{} not found; use --program-path'.format(tshark))
+
+    tshark_args = []
+    for stat in args.stats:
+        tshark_args += ['-z', stat]
+    for pref in args.prefs:
+        tshark_args += ['-o', pref]
+
+    stats_dir = tempfile.mkdtemp(prefix='tshark-stats-')
+    try:
+        with concurrent.futures.ThreadPoolExecutor(max_workers=args.jobs) as executor:
+            jobs = [executor.submit(export_stats, tshark, tshark_args, capture,
+                                    os.path.join(stats_dir, '{}.stats'.format(i)))
+                    for i, capture in enumerate(args.files)]
+            stats_files = [job.result() for job in jobs]
+
+            # Merge in batches, so that the command lines stay short.
+            step = 0
+            while len(stats_files) > merge_batch:
+                batches = [stats_files[i:i + merge_batch] for i in range(0, len(stats_files), merge_batch)]
+                merged = [os.path.join(stats_dir, 'merge{}-{}.stats'.format(step, i)) for i in range(len(batches))]
+                for job in [executor.submit(run, [tshark] + merge_args(batch) + ['--export-stats', out])
+                            for batch, out in zip(batches, merged)]:
+                    job.result()
+                stats_files = merged
+                step += 1
+
+        final_cmd = [tshark] + merge_args(stats_files)
+        if args.output:
+            final_cmd += ['--export-stats', args.output]
+        sys.stdout.write(run(final_cmd).decode('utf-8', 'replace'))
+    except RuntimeError as e:
+        sys.stderr.write('{}\n'.format(e))
+        sys.exit(1)
+    finally:
+        shutil.rmtree(stats_dir, ignore_errors=True)
+
+if __name__ == '__main__':
+    main()
@@ -72,6 +72,7 @@
 #include <epan/print.h>
 #include <epan/addr_resolv.h>
 #ifdef HAVE_LIBPCAP
+#include "ui/capture_index.h"
 #include "ui/capture_ui_utils.h"
 #endif
 #include "ui/taps.h"
@@ -117,6 +118,7 @@
 #include <wsutil/str_util.h>
 #include <wsutil/utf8_entities.h>
 #include <wsutil/json_dumper.h>
+#include <wsutil/startup_timings.h>
 
 #include "extcap.h"
 
@@ -144,6 +146,10 @@
 #define LONGOPT_COLOR (65536+1000)
 #define LONGOPT_NO_DUPLICATE_KEYS (65536+1001)
 #define LONGOPT_ELASTIC_MAPPING_FILTER (65536+1002)
+#define LONGOPT_EXPORT_STATS (65536+1003)
+#define LONGOPT_MERGE_STATS (65536+1004)
+#define LONGOPT_READ_START_TIME (65536+1005)
+#define LONGOPT_READ_STOP_TIME (65536+1006)
 
 #if 0
 #define tshark_debug(...) g_warning(__VA_ARGS__)
@@ -180,8 +186,10 @@ static gboolean do_dissection;     /* TRUE if we have to dissect each packet */
 static gboolean print_packet_info; /* TRUE if we're to print packet information */
 static gboolean print_summary;     /* TRUE if we're to print packet summary information */
 static gboolean print_details;     /* TRUE if we're to print packet details information */
+static gboolean prime_output_fields; /* TRUE if -T fields reads an invisible tree primed with its fields */
 static gboolean print_hex;         /* TRUE if we're to print hex/ascci information */
 static gboolean line_buffered;
+#define STDOUT_BUF_SIZE (64 * 1024)
 static gboolean really_quiet = FALSE;
 static gchar* delimiter_char = " ";
 static gboolean dissect_color = FALSE;
@@ -348,6 +356,7 @@ print_usage(FILE *output)
   fprintf(output, "  -D                       print list of interfaces and exit\n");
   fprintf(output, "  -L                       print list of link-layer types of iface and exit\n");
   fprintf(output, "  --list-time-stamp-types  print list of timestamp types for iface and exit\n");
+  fprintf(output, "  --update-interval        interval between updates with new packets (def: %dms)\n", DEFAULT_UPDATE_INTERVAL);
   fprintf(output, "\n");
   fprintf(output, "Capture stop conditions:\n");
   fprintf(output, "  -c <packet count>        stop after n packets (def: infinite)\n");
@@ -368,6 +377,10 @@ print_usage(FILE *output)
   /*fprintf(output, "\n");*/
   fprintf(output, "Input file:\n");
   fprintf(output, "  -r <infile|->            set the filename to read from (or '-' for stdin)\n");
+  fprintf(output, "  --read-start-time <YYYY-MM-DD hh:mm:ss>\n");
+  fprintf(output, "                           read only packets from this local time on\n");
+  fprintf(output, "  --read-stop-time <YYYY-MM-DD hh:mm:ss>\n");
+  fprintf(output, "                           read only packets before this local time\n");
 
   fprintf(output, "\n");
   fprintf(output, "Processing:\n");
@@ -392,6 +405,9 @@ print_usage(FILE *output)
   fprintf(output, "                           enable dissection of heuristic protocol\n");
   fprintf(output, "  --disable-heuristic <short_name>\n");
   fprintf(output, "                           disable dissection of heuristic protocol\n");
+  fprintf(output, "  --startup-timings <file>\n");
+  fprintf(output, "                           write the time taken by each startup step to\n");
+  fprintf(output, "                           <file> as JSON\n");
 
   /*fprintf(output, "\n");*/
   fprintf(output, "Output:\n");
@@ -457,6 +473,10 @@ print_usage(FILE *output)
   fprintf(output, "                           values\n");
   fprintf(output, "  --elastic-mapping-filter <protocols> If -G elastic-mapping is specified, put only the\n");
   fprintf(output, "                           specified protocols within the mapping file\n");
+  fprintf(output, "  --export-stats <file>    write the statistics trees of -z <tree>,tree to a file\n");
+  fprintf(output, "                           instead of printing them, for --merge-stats\n");
+  fprintf(output, "  --merge-stats <file>     sum up and print statistics trees written with\n");
+  fprintf(output, "                           --export-stats (may be repeated)\n");
 
   fprintf(output, "\n");
   fprintf(output, "Miscellaneous:\n");
@@ -694,6 +714,10 @@ main(int argc, char *argv[])
     {"color", no_argument, NULL, LONGOPT_COLOR},
     {"no-duplicate-keys", no_argument, NULL, LONGOPT_NO_DUPLICATE_KEYS},
     {"elastic-mapping-filter", required_argument, NULL, LONGOPT_ELASTIC_MAPPING_FILTER},
+    {"export-stats", required_argument, NULL, LONGOPT_EXPORT_STATS},
+    {"merge-stats", required_argument, NULL, LONGOPT_MERGE_STATS},
+    {"read-start-time", required_argument, NULL, LONGOPT_READ_START_TIME},
+    {"read-stop-time", required_argument, NULL, LONGOPT_READ_STOP_TIME},
     {0, 0, 0, 0 }
   };
   gboolean             arg_error = FALSE;
@@ -702,6 +726,7 @@ main(int argc, char *argv[])
   volatile process_file_status_t status;
   volatile gboolean    draw_taps = FALSE;
   volatile int         exit_status = EXIT_SUCCESS;
+  GSList              *merge_stats_paths = NULL;
 #ifdef HAVE_LIBPCAP
   int                  caps_queries = 0;
   gboolean             start_capture = FALSE;
@@ -859,6 +884,9 @@ main(int argc, char *argv[])
     case LONGOPT_ELASTIC_MAPPING_FILTER:
       elastic_mapping_filter = optarg;
       break;
+    case LONGOPT_STARTUP_TIMINGS: /* time the steps of epan_init() */
+      startup_timings_enable();
+      break;
     default:
       break;
     }
@@ -1071,6 +1099,7 @@ main(int argc, char *argv[])
     case 'g':        /* enable group read access on file(s) */
     case 'i':        /* Use interface x */
     case LONGOPT_SET_TSTAMP_TYPE: /* Set capture timestamp type */
+    case LONGOPT_UPDATE_INTERVAL: /* Set the update interval */
     case 'p':        /* Don't capture in promiscuous mode */
 #ifdef HAVE_PCAP_REMOTE
     case 'A':        /* Authentication */
@@ -1423,6 +1452,7 @@ main(int argc, char *argv[])
     case LONGOPT_ENABLE_HEURISTIC: /* enable heuristic dissection of protocol */
     case LONGOPT_DISABLE_HEURISTIC: /* disable heuristic dissection of protocol */
     case LONGOPT_ENABLE_PROTOCOL: /* enable dissection of protocol (that is disabled by default) */
+    case LONGOPT_STARTUP_TIMINGS: /* write startup timings as JSON */
       if (!dissect_opts_handle_opt(opt, optarg)) {
         exit_status = INVALID_OPTION;
         goto clean_exit;
@@ -1447,6 +1477,24 @@ main(int argc, char *argv[])
       no_duplicate_keys = TRUE;
       node_children_grouper = proto_node_group_children_by_json_key;
       break;
+    case LONGOPT_EXPORT_STATS: /* write -z stats trees for --merge-stats */
+      if (!stats_tree_export_open(optarg)) {
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+      break;
+    case LONGOPT_MERGE_STATS: /* sum up exported stats trees */
+      merge_stats_paths = g_slist_append(merge_stats_paths, optarg);
+      break;
+    case LONGOPT_READ_START_TIME: /* read only packets in a time range */
+    case LONGOPT_READ_STOP_TIME:
+      if (!capture_index_parse_time(optarg,
+              opt == LONGOPT_READ_START_TIME ? &cfile.read_start : &cfile.read_stop)) {
+        cmdarg_err("\"%s\" isn't a valid time; use YYYY-MM-DD hh:mm:ss", optarg);
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+      break;
     default:
     case '?':        /* Bad flag - print usage message */
       switch(optopt) {
@@ -1462,6 +1510,12 @@ main(int argc, char *argv[])
     }
   }
 
+  /* Dissectors are registered and the profile's settings loaded by now. */
+  if (!dissect_opts_write_startup_timings()) {
+    exit_status = INVALID_OPTION;
+    goto clean_exit;
+  }
+
   /*
    * Print packet summary information is the default if neither -V or -x
    * were specified. Note that this is new behavior, which allows for the
@@ -1698,6 +1752,13 @@ main(int argc, char *argv[])
         goto clean_exit;
       }
 
+      if (!nstime_is_unset(&cfile.read_start) || !nstime_is_unset(&cfile.read_stop)) {
+        cmdarg_err("A time range to read was specified, but "
+          "a capture file isn't being read.");
+        exit_status = INVALID_OPTION;
+        goto clean_exit;
+      }
+
       if (global_capture_opts.saving_to_file) {
         /* They specified a "-w" flag, so we'll be saving to a capture file. */
 
@@ -1815,6 +1876,21 @@ main(int argc, char *argv[])
       goto clean_exit;
     }
   }
+
+  /* --merge-stats only combines statistics exported earlier; nothing
+     is read or captured. */
+  if (merge_stats_paths != NULL) {
+    if (!stats_tree_merge_files(merge_stats_paths))
+      exit_status = INVALID_FILE;
+    goto clean_exit;
+  }
+
+  /* -T fields only prints the fields it was given, so unless one of them
+     is printed from its item's text label, there's no need to build a
+     visible tree; the fields are primed for each packet instead and
+     everything else can be faked. */
+  if (output_action == WRITE_FIELDS && !output_fields_need_visible_tree(output_fields))
+    prime_output_fields = TRUE;
 #ifdef HAVE_LIBPCAP
   /* We currently don't support taps, or printing dissected packets,
      if we're writing to a pipe. */
@@ -1920,6 +1996,13 @@ main(int argc, char *argv[])
   cfile.dfcode = dfcode;
 
   if (print_packet_info) {
+    /* Unless we're flushing after every packet, or stdout is a terminal,
+       give the standard output a big buffer; the default one is only a
+       few KB, so writing verbose, PDML or JSON output took a write()
+       call every few lines. */
+    if (!line_buffered && !ws_isatty(ws_fileno(stdout)))
+      setvbuf(stdout, NULL, _IOFBF, STDOUT_BUF_SIZE);
+
     /* If we're printing as text or PostScript, we have
        to create a print stream. */
     if (output_action == WRITE_TEXT) {
@@ -2258,6 +2341,9 @@ main(int argc, char *argv[])
   output_fields = NULL;
 
 clean_exit:
+  if (!stats_tree_export_close() && exit_status == EXIT_SUCCESS)
+    exit_status = INVALID_FILE;
+  g_slist_free(merge_stats_paths);
   g_free(cf_name);
   destroy_print_stream(print_stream);
   g_free(output_file_name);
@@ -2270,6 +2356,8 @@ clean_exit:
   free_progdirs();
   cf_close(&cfile);
   dfilter_free(dfcode);
+  /* In case we bailed out before writing the timings */
+  startup_timings_cleanup();
   return exit_status;
 }
 
@@ -2730,7 +2818,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !prime_output_fields);
 
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
@@ -2738,7 +2826,7 @@ capture_input_new_packets(capture_session *cap_session, int to_read)
     while (to_read-- && cf->provider.wth) {
       wtap_cleareof(cf->provider.wth);
       ret = wtap_read(cf->provider.wth, &rec, &buf, &err, &err_info, &data_offset);
-      reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+      reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details && !prime_output_fields);
       if (ret == FALSE) {
         /* read from file failed, tell the capture child to stop */
         sync_pipe_stop(cap_session);
@@ -3061,12 +3149,19 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
   Buffer          buf;
   epan_dissect_t *edt = NULL;
   gint64          data_offset;
+  capture_index_range_t read_range;
   pass_status_t   status = PASS_SUCCEEDED;
 
   wtap_rec_init(&rec);
   ws_buffer_init(&buf, 1514);
 
-  /* Allocate a frame_data_sequence for all the frames. */
+  /* Allocate a frame_data_sequence for all the frames.
+
+     This, about 88 bytes per frame, is what two-pass analysis itself keeps
+     between the passes; what usually dominates on large files is the
+     state dissectors keep in file scope (conversations, reassembly,
+     per-frame proto data), which they look up by pointer during the second
+     pass and which therefore can't be moved out to a file. */
   cf->provider.frames = new_frame_data_sequence();
 
   if (do_dissection) {
@@ -3094,12 +3189,18 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
   }
 
   tshark_debug("tshark: reading records for first pass");
+  capture_index_range_open(&read_range, cf->filename, &cf->read_start, &cf->read_stop);
+  capture_index_range_seek(&read_range, cf->provider.wth);
   *err = 0;
   while (wtap_read(cf->provider.wth, &rec, &buf, err, err_info, &data_offset)) {
     if (read_interrupted) {
       status = PASS_INTERRUPTED;
       break;
     }
+    if (capture_index_range_at_end(&read_range, data_offset))
+      break;
+    if (!capture_index_range_contains(&read_range, &rec))
+      continue;
     if (process_packet_first_pass(cf, edt, data_offset, &rec, &buf)) {
       /* Stop reading if we have the maximum number of packets;
        * When the -c option has not been used, max_packet_count
@@ -3116,6 +3217,7 @@ process_cap_file_first_pass(capture_file *cf, int max_packet_count,
   }
   if (*err != 0)
     status = PASS_READ_ERROR;
+  capture_index_range_cleanup(&read_range);
 
   if (edt)
     epan_dissect_free(edt);
@@ -3162,6 +3264,9 @@ process_packet_second_pass(capture_file *cf, epan_dissect_t *edt,
 
     col_custom_prime_edt(edt, &cf->cinfo);
 
+    if (prime_output_fields)
+      output_fields_prime_edt(output_fields, edt);
+
     /* We only need the columns if either
          1) some tap needs the columns
        or
@@ -3272,7 +3377,7 @@ process_cap_file_second_pass(capture_file *cf, wtap_dumper *pdh,
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !prime_output_fields);
   }
 
   /*
@@ -3334,6 +3439,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
   guint32         framenum;
   epan_dissect_t *edt = NULL;
   gint64          data_offset;
+  capture_index_range_t read_range;
   pass_status_t   status = PASS_SUCCEEDED;
 
   wtap_rec_init(&rec);
@@ -3379,7 +3485,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
        printing packet details, which is true if we're printing stuff
        ("print_packet_info" is true) and we're in verbose mode
        ("packet_details" is true). */
-    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details);
+    edt = epan_dissect_new(cf->epan, create_proto_tree, print_packet_info && print_details && !prime_output_fields);
   }
 
   /*
@@ -3389,17 +3495,23 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
    */
   set_resolution_synchrony(TRUE);
 
+  capture_index_range_open(&read_range, cf->filename, &cf->read_start, &cf->read_stop);
+  capture_index_range_seek(&read_range, cf->provider.wth);
   *err = 0;
   while (wtap_read(cf->provider.wth, &rec, &buf, err, err_info, &data_offset)) {
     if (read_interrupted) {
       status = PASS_INTERRUPTED;
       break;
     }
+    if (capture_index_range_at_end(&read_range, data_offset))
+      break;
+    if (!capture_index_range_contains(&read_range, &rec))
+      continue;
     framenum++;
 
     tshark_debug("tshark: processing packet #%d", framenum);
 
-    reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details);
+    reset_epan_mem(cf, edt, create_proto_tree, print_packet_info && print_details && !prime_output_fields);
 
     if (process_packet_single_pass(cf, edt, data_offset, &rec, &buf, tap_flags)) {
       /* Either there's no read filtering or this packet passed the
@@ -3432,6 +3544,7 @@ process_cap_file_single_pass(capture_file *cf, wtap_dumper *pdh,
     /* Error reading from the input file. */
     status = PASS_READ_ERROR;
   }
+  capture_index_range_cleanup(&read_range);
 
   if (edt)
     epan_dissect_free(edt);
@@ -3721,6 +3834,9 @@ process_packet_single_pass(capture_file *cf, epan_dissect_t *edt, gint64 offset,
 
     col_custom_prime_edt(edt, &cf->cinfo);
 
+    if (prime_output_fields)
+      output_fields_prime_edt(output_fields, edt);
+
     /* We only need the columns if either
          1) some tap needs the columns
        or
@@ -51,6 +51,7 @@ struct if_stat_cache_s {
     int stat_fd;
     ws_process_id fork_child;
     GList *cache_list;  /* List of if_stat_chache_entry_t */
+    GHashTable *cache_hash; /* cache_list items by interface name */
 };
 
 /* this callback mechanism should possibly be replaced by the g_signal_...() stuff (if I only would know how :-) */
@@ -121,6 +122,7 @@ capture_start(capture_options *capture_opts, capture_session *cap_session, info_
 
     cap_session->state = CAPTURE_PREPARING;
     cap_session->count = 0;
+    cap_session->temp_files = (capture_opts->save_file == NULL);
     g_log(LOG_DOMAIN_CAPTURE, G_LOG_LEVEL_MESSAGE, "Capture Start ...");
     source = get_iface_list_string(capture_opts, IFLIST_SHOW_FILTER);
     cf_set_tempfile_source((capture_file *)cap_session->cf, source->str);
@@ -160,8 +162,11 @@ capture_start(capture_options *capture_opts, capture_session *cap_session, info_
         cap_data->counts.counts_hash = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, g_free);
         cap_data->counts.other = 0;
         cap_data->counts.total = 0;
+        cap_data->last_batch_time = 0;
+        cap_data->sample_skip = 0;
 
         cap_data->ui.counts = &cap_data->counts;
+        cap_data->ui.sampled = FALSE;
 
         capture_info_ui_create(&cap_data->ui, cap_session);
     }
@@ -423,8 +428,11 @@ capture_input_new_file(capture_session *cap_session, gchar *new_file)
             }
         }
         g_free(capture_opts->save_file);
-        is_tempfile = FALSE;
-        cf_set_tempfile((capture_file *)cap_session->cf, FALSE);
+        /* In a ring buffer of temporary files every file is a temporary
+           one; closing the previous file above has already removed it,
+           so only the packets of the current file are kept in memory. */
+        is_tempfile = cap_session->temp_files;
+        cf_set_tempfile((capture_file *)cap_session->cf, is_tempfile);
     } else {
         /* we didn't have a save_file before; must be a tempfile */
         is_tempfile = TRUE;
@@ -787,6 +795,7 @@ capture_stat_start(capture_options *capture_opts)
         sc->fork_child = fork_child;
 
         /* Initialize the cache */
+        sc->cache_hash = g_hash_table_new(g_str_hash, g_str_equal);
         for (i = 0; i < capture_opts->all_ifaces->len; i++) {
             device = &g_array_index(capture_opts->all_ifaces, interface_t, i);
             if (device->type != IF_PIPE) {
@@ -794,6 +803,7 @@ capture_stat_start(capture_options *capture_opts)
                 g_assert(device->if_info.name);
                 sc_item->name = g_strdup(device->if_info.name);
                 sc->cache_list = g_list_prepend(sc->cache_list, sc_item);
+                g_hash_table_insert(sc->cache_hash, sc_item->name, sc_item);
             }
         }
     } else {
@@ -809,7 +819,6 @@ capture_stat_cache_update(if_stat_cache_t *sc)
 {
     gchar stat_line[MAX_STAT_LINE_LEN] = "";
     gchar **stat_parts;
-    GList *sc_entry;
     if_stat_cache_item_t *sc_item;
 
     if (!sc || sc->fork_child == WS_INVALID_PID) {
@@ -824,12 +833,10 @@ capture_stat_cache_update(if_stat_cache_t *sc)
             g_strfreev(stat_parts);
             continue;
         }
-        for (sc_entry = sc->cache_list; sc_entry != NULL; sc_entry = g_list_next(sc_entry)) {
-            sc_item = (if_stat_cache_item_t *)sc_entry->data;
-            if (strcmp(sc_item->name, stat_parts[0]) == 0) {
-                sc_item->ps.ps_recv = (u_int) strtoul(stat_parts[1], NULL, 10);
-                sc_item->ps.ps_drop = (u_int) strtoul(stat_parts[2], NULL, 10);
-            }
+        sc_item = (if_stat_cache_item_t *)g_hash_table_lookup(sc->cache_hash, stat_parts[0]);
+        if (sc_item) {
+            sc_item->ps.ps_recv = (u_int) strtoul(stat_parts[1], NULL, 10);
+            sc_item->ps.ps_drop = (u_int) strtoul(stat_parts[2], NULL, 10);
         }
         g_strfreev(stat_parts);
     }
@@ -838,7 +845,6 @@ capture_stat_cache_update(if_stat_cache_t *sc)
 gboolean
 capture_stats(if_stat_cache_t *sc, char *ifname, struct pcap_stat *ps)
 {
-    GList *sc_entry;
     if_stat_cache_item_t *sc_item;
 
     if (!sc || sc->fork_child == WS_INVALID_PID || !ifname || !ps) {
@@ -846,12 +852,10 @@ capture_stats(if_stat_cache_t *sc, char *ifname, struct pcap_stat *ps)
     }
 
     capture_stat_cache_update(sc);
-    for (sc_entry = sc->cache_list; sc_entry != NULL; sc_entry = g_list_next(sc_entry)) {
-        sc_item = (if_stat_cache_item_t *)sc_entry->data;
-        if (strcmp(sc_item->name, ifname) == 0) {
-            memcpy(ps, &sc_item->ps, sizeof(struct pcap_stat));
-            return TRUE;
-        }
+    sc_item = (if_stat_cache_item_t *)g_hash_table_lookup(sc->cache_hash, ifname);
+    if (sc_item) {
+        memcpy(ps, &sc_item->ps, sizeof(struct pcap_stat));
+        return TRUE;
     }
     return FALSE;
 }
@@ -882,6 +886,9 @@ capture_stat_stop(if_stat_cache_t *sc)
         g_free(sc_item);
     }
     g_list_free(sc->cache_list);
+    if (sc->cache_hash) {
+        g_hash_table_destroy(sc->cache_hash);
+    }
     g_free(sc);
 }
 
@@ -0,0 +1,310 @@
+/* capture_index.c
+ * Read the indexes that capindex writes next to capture files, and use
+ * their time checkpoints to read only a time range of a capture
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <string.h>
+#include <errno.h>
+
+/*
+ * Just make sure we include the prototype for strptime as well
+ * (needed for glibc 2.2) but make sure we do this only if not
+ * yet defined.
+ */
+
+#ifndef __USE_XOPEN
+#  define __USE_XOPEN
+#endif
+
+#include <time.h>
+
+#include <glib.h>
+
+#ifndef HAVE_STRPTIME
+# include "wsutil/strptime.h"
+#endif
+
+#include <wsutil/file_util.h>
+
+#include "capture_index.h"
+
+char *
+capture_index_default_name(const char *capture_file)
+{
+    return g_strdup_printf("%s.idx", capture_file);
+}
+
+gboolean
+capture_index_get_id(const char *capture_file, capture_index_id_t *id,
+                     char **err_msg)
+{
+    ws_statb64 statb;
+    FILE      *fh;
+    guint8    *header;
+    size_t     header_len;
+    gchar     *hash;
+
+    if (ws_stat64(capture_file, &statb) != 0) {
+        *err_msg = g_strdup_printf("Can't get information about \"%s\": %s.",
+                                   capture_file, g_strerror(errno));
+        return FALSE;
+    }
+    id->size = statb.st_size;
+    id->mtime = statb.st_mtime;
+
+    fh = ws_fopen(capture_file, "rb");
+    if (fh == NULL) {
+        *err_msg = g_strdup_printf("Can't open \"%s\": %s.",
+                                   capture_file, g_strerror(errno));
+        return FALSE;
+    }
+    header = (guint8 *)g_malloc(CAPTURE_INDEX_HEADER_HASH_LENGTH);
+    header_len = fread(header, 1, CAPTURE_INDEX_HEADER_HASH_LENGTH, fh);
+    if (ferror(fh)) {
+        *err_msg = g_strdup_printf("Error reading \"%s\": %s.",
+                                   capture_file, g_strerror(errno));
+        g_free(header);
+        fclose(fh);
+        return FALSE;
+    }
+    fclose(fh);
+
+    hash = g_compute_checksum_for_data(G_CHECKSUM_SHA256, header, header_len);
+    g_strlcpy(id->header_hash, hash, sizeof id->header_hash);
+    g_free(hash);
+    g_free(header);
+    return TRUE;
+}
+
+static gboolean
+nstime_from_index_string(const char *str, nstime_t *t)
+{
+    gint64 secs;
+    int    nsecs;
+
+    if (strcmp(str, "-") == 0) {
+        nstime_set_unset(t);
+        return TRUE;
+    }
+    if (sscanf(str, "%" G_GINT64_MODIFIER "d.%d", &secs, &nsecs) != 2)
+        return FALSE;
+    t->secs = (time_t)secs;
+    t->nsecs = nsecs;
+    return TRUE;
+}
+
+FILE *
+capture_index_open(const char *index_file, const capture_index_id_t *id,
+                   GArray *checkpoints, char **err_msg)
+{
+    FILE  *fh;
+    char   line[64];
+    capture_index_id_t index_id;
+    int    c;
+
+    fh = ws_fopen(index_file, "r");
+    if (fh == NULL) {
+        *err_msg = g_strdup_printf("Can't open \"%s\": %s.",
+                                   index_file, g_strerror(errno));
+        return NULL;
+    }
+
+    if (fgets(line, sizeof line, fh) == NULL ||
+        strncmp(line, CAPTURE_INDEX_VERSION_LINE, strlen(CAPTURE_INDEX_VERSION_LINE)) != 0 ||
+        fscanf(fh, "size %" G_GINT64_MODIFIER "d\n", &index_id.size) != 1 ||
+        fscanf(fh, "mtime %" G_GINT64_MODIFIER "d\n", &index_id.mtime) != 1 ||
+        fscanf(fh, "header %64s\n", index_id.header_hash) != 1) {
+        *err_msg = g_strdup_printf("\"%s\" is not a capindex index.", index_file);
+        fclose(fh);
+        return NULL;
+    }
+    if (index_id.size != id->size ||
+        index_id.mtime != id->mtime ||
+        strcmp(index_id.header_hash, id->header_hash) != 0) {
+        *err_msg = g_strdup_printf("\"%s\" was made for a different capture file; index it again.",
+                                   index_file);
+        fclose(fh);
+        return NULL;
+    }
+
+    while ((c = getc(fh)) == 't') {
+        capture_index_checkpoint_t checkpoint;
+        char latest_str[32], earliest_str[32];
+
+        if (fscanf(fh, "ime %" G_GINT64_MODIFIER "d %31s %31s\n",
+                   &checkpoint.offset, latest_str, earliest_str) != 3 ||
+            !nstime_from_index_string(latest_str, &checkpoint.latest_before) ||
+            !nstime_from_index_string(earliest_str, &checkpoint.earliest_from)) {
+            *err_msg = g_strdup_printf("\"%s\" has a bad time checkpoint.", index_file);
+            fclose(fh);
+            return NULL;
+        }
+        if (checkpoints != NULL)
+            g_array_append_val(checkpoints, checkpoint);
+    }
+    if (c != EOF)
+        ungetc(c, fh);
+    return fh;
+}
+
+GArray *
+capture_index_read_checkpoints(const char *capture_file)
+{
+    capture_index_id_t id;
+    char   *index_file;
+    GArray *checkpoints;
+    FILE   *fh;
+    char   *err_msg;
+
+    if (!capture_index_get_id(capture_file, &id, &err_msg)) {
+        g_free(err_msg);
+        return NULL;
+    }
+
+    index_file = capture_index_default_name(capture_file);
+    checkpoints = g_array_new(FALSE, FALSE, sizeof(capture_index_checkpoint_t));
+    fh = capture_index_open(index_file, &id, checkpoints, &err_msg);
+    g_free(index_file);
+    if (fh == NULL) {
+        g_free(err_msg);
+        g_array_free(checkpoints, TRUE);
+        return NULL;
+    }
+    fclose(fh);
+    return checkpoints;
+}
+
+gboolean
+capture_index_parse_time(const char *str, nstime_t *t)
+{
+    struct tm tm;
+
+    memset(&tm, 0, sizeof tm);
+    if (!strptime(str, "%Y-%m-%d %T", &tm))
+        return FALSE;
+    tm.tm_isdst = -1;
+    t->secs = mktime(&tm);
+    t->nsecs = 0;
+    return TRUE;
+}
+
+void
+capture_index_range_init(capture_index_range_t *range, GArray *checkpoints,
+                         const nstime_t *start, const nstime_t *stop)
+{
+    range->start = *start;
+    range->stop = *stop;
+    range->checkpoints = checkpoints;
+    range->free_checkpoints = FALSE;
+    range->next = 0;
+}
+
+void
+capture_index_range_open(capture_index_range_t *range, const char *capture_file,
+                         const nstime_t *start, const nstime_t *stop)
+{
+    GArray *checkpoints = NULL;
+
+    if (!nstime_is_unset(start) || !nstime_is_unset(stop))
+        checkpoints = capture_index_read_checkpoints(capture_file);
+    capture_index_range_init(range, checkpoints, start, stop);
+    range->free_checkpoints = TRUE;
+}
+
+void
+capture_index_range_cleanup(capture_index_range_t *range)
+{
+    if (range->free_checkpoints && range->checkpoints != NULL)
+        g_array_free(range->checkpoints, TRUE);
+    range->checkpoints = NULL;
+}
+
+void
+capture_index_range_seek(capture_index_range_t *range, wtap *wth)
+{
+    guint first = 0;
+    int   err;
+
+    if (range->checkpoints == NULL || range->checkpoints->len == 0)
+        return;
+
+    if (!nstime_is_unset(&range->start)) {
+        /* latest_before only grows, so binary search for it */
+        guint lo = 0, hi = range->checkpoints->len;
+
+        while (hi - lo > 1) {
+            guint mid = lo + (hi - lo) / 2;
+            const capture_index_checkpoint_t *checkpoint =
+                &g_array_index(range->checkpoints, capture_index_checkpoint_t, mid);
+
+            if (nstime_is_unset(&checkpoint->latest_before) ||
+                nstime_cmp(&checkpoint->latest_before, &range->start) < 0)
+                lo = mid;
+            else
+                hi = mid;
+        }
+        first = lo;
+    }
+
+    if (first != 0 &&
+        !wtap_seek_sequential(wth, g_array_index(range->checkpoints, capture_index_checkpoint_t, first).offset, &err)) {
+        /* Not a file type we can start in the middle of; read all of it */
+        first = 0;
+    }
+    range->next = first + 1;
+}
+
+gboolean
+capture_index_range_at_end(capture_index_range_t *range, gint64 data_offset)
+{
+    const capture_index_checkpoint_t *checkpoint;
+
+    if (range->checkpoints == NULL || range->next == 0 ||
+        range->next >= range->checkpoints->len)
+        return FALSE;
+
+    checkpoint = &g_array_index(range->checkpoints, capture_index_checkpoint_t, range->next);
+    if (data_offset != checkpoint->offset)
+        return FALSE;
+    if (nstime_is_unset(&checkpoint->earliest_from) ||
+        (!nstime_is_unset(&range->stop) && nstime_cmp(&checkpoint->earliest_from, &range->stop) >= 0))
+        return TRUE;
+    range->next++;
+    return FALSE;
+}
+
+gboolean
+capture_index_range_contains(const capture_index_range_t *range,
+                             const wtap_rec *rec)
+{
+    if (nstime_is_unset(&range->start) && nstime_is_unset(&range->stop))
+        return TRUE;
+    if (!(rec->presence_flags & WTAP_HAS_TS))
+        return FALSE;
+    if (!nstime_is_unset(&range->start) && nstime_cmp(&rec->ts, &range->start) < 0)
+        return FALSE;
+    if (!nstime_is_unset(&range->stop) && nstime_cmp(&rec->ts, &range->stop) >= 0)
+        return FALSE;
+    return TRUE;
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
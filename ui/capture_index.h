@@ -0,0 +1,170 @@
+/* capture_index.h
+ * Read the indexes that capindex writes next to capture files, and use
+ * their time checkpoints to read only a time range of a capture
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __CAPTURE_INDEX_H__
+#define __CAPTURE_INDEX_H__
+
+#include <stdio.h>
+
+#include <glib.h>
+
+#include <wsutil/nstime.h>
+#include <wiretap/wtap.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * The index is a text file next to the capture, "<capture>.idx" by
+ * default.  It starts with a version line and the size, modification
+ * time and a hash of the first bytes of the capture it was made for,
+ * followed by the time checkpoints and one line per conversation:
+ *
+ *   # capindex 3
+ *   size <capture file size>
+ *   mtime <capture file modification time, in seconds since the epoch>
+ *   header <SHA-256 of the first CAPTURE_INDEX_HEADER_HASH_LENGTH bytes of the capture>
+ *   time <offset> <latest time before> <earliest time from>
+ *   flow <id> <protocol> <endpoint> <endpoint> <records> <offset> ...
+ *
+ * The offsets are those of records in the capture, as wtap_read() returns
+ * them.  The conversation offsets are in file order.
+ *
+ * A time checkpoint has the latest time stamp of all records before it,
+ * and the earliest one of all records from it to the end of the file
+ * ("-" if there's none), so that a time range can be found by binary
+ * search even if the records aren't in time order.
+ */
+#define CAPTURE_INDEX_VERSION_LINE "# capindex 3"
+#define CAPTURE_INDEX_HEADER_HASH_LENGTH 4096
+
+typedef struct capture_index_checkpoint_t {
+    gint64       offset;
+    nstime_t     latest_before;
+    nstime_t     earliest_from;
+} capture_index_checkpoint_t;
+
+/* What the index remembers about the capture file it was made for */
+typedef struct capture_index_id_t {
+    gint64       size;
+    gint64       mtime;
+    char         header_hash[65];
+} capture_index_id_t;
+
+/** The default index file name of a capture file; g_free() it. */
+extern char *capture_index_default_name(const char *capture_file);
+
+/**
+ * Get the size and modification time of a capture file, and hash its
+ * first bytes, which hold the file header and usually the first section
+ * and interface descriptions.
+ *
+ * @return TRUE on success; otherwise *err_msg is set to a message to
+ * g_free().
+ */
+extern gboolean capture_index_get_id(const char *capture_file,
+                                     capture_index_id_t *id, char **err_msg);
+
+/**
+ * Open an index and check that it was made for the capture with this id:
+ * the size, modification time and header hash must all match.
+ *
+ * @param checkpoints if not NULL, the time checkpoints are appended to
+ * this array of capture_index_checkpoint_t.
+ * @return the index, positioned at the first "flow" line, or NULL with
+ * *err_msg set to a message to g_free().
+ */
+extern FILE *capture_index_open(const char *index_file,
+                                const capture_index_id_t *id,
+                                GArray *checkpoints, char **err_msg);
+
+/**
+ * The time checkpoints in the default index of a capture file, or NULL if
+ * it has no index or the index isn't for this version of the file.
+ */
+extern GArray *capture_index_read_checkpoints(const char *capture_file);
+
+/**
+ * Parse a time given as "YYYY-MM-DD hh:mm:ss" in local time, as capindex,
+ * editcap and TShark take it.
+ */
+extern gboolean capture_index_parse_time(const char *str, nstime_t *t);
+
+/** Reading the records of a capture in a time range */
+typedef struct capture_index_range_t {
+    nstime_t     start;         /* may be unset */
+    nstime_t     stop;          /* may be unset */
+    GArray      *checkpoints;   /* capture_index_checkpoint_t, or NULL */
+    gboolean     free_checkpoints;
+    guint        next;          /* the first checkpoint after where reading started */
+} capture_index_range_t;
+
+/**
+ * Set up reading records from start up to, but not including, stop.
+ * Either may be unset; if both are, every record is in the range.  If
+ * checkpoints is NULL, the whole file is read.  The range does not take
+ * over checkpoints.
+ */
+extern void capture_index_range_init(capture_index_range_t *range,
+                                     GArray *checkpoints,
+                                     const nstime_t *start,
+                                     const nstime_t *stop);
+
+/**
+ * Like capture_index_range_init(), with the checkpoints of the default
+ * index of capture_file if start or stop is set and there's a usable
+ * index.  Free them with capture_index_range_cleanup().
+ */
+extern void capture_index_range_open(capture_index_range_t *range,
+                                     const char *capture_file,
+                                     const nstime_t *start,
+                                     const nstime_t *stop);
+
+extern void capture_index_range_cleanup(capture_index_range_t *range);
+
+/**
+ * Move the sequential stream of wth, which must not have been read from
+ * yet, to the last checkpoint with no record in the range before it.
+ * If the file type doesn't support that, reading starts at the beginning.
+ */
+extern void capture_index_range_seek(capture_index_range_t *range, wtap *wth);
+
+/**
+ * Whether the record read at data_offset is at a checkpoint after which
+ * no record is in the range, so that reading can stop.  Must be called
+ * for every record read.
+ */
+extern gboolean capture_index_range_at_end(capture_index_range_t *range,
+                                           gint64 data_offset);
+
+/** Whether a record is in the range. */
+extern gboolean capture_index_range_contains(const capture_index_range_t *range,
+                                             const wtap_rec *rec);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __CAPTURE_INDEX_H__ */
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,260 @@
+/* tap-dissectorprof.c
+ * Time spent in each dissector, for tshark -z dissector,prof
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/packet.h>
+#include <epan/reassemble.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_dissectorprof(void);
+
+typedef struct {
+	const char *name;
+	dissector_profile_t profile;
+} dissectorprof_entry_t;
+
+typedef struct {
+	const char *name;
+	dissector_table_profile_t profile;
+} dissectortableprof_entry_t;
+
+static void
+dissectorprof_collect(const char *name, const dissector_profile_t *profile, gpointer user_data)
+{
+	GArray *entries = (GArray *)user_data;
+	dissectorprof_entry_t entry;
+
+	entry.name = name;
+	entry.profile = *profile;
+	g_array_append_val(entries, entry);
+}
+
+static gint
+dissectorprof_compare(gconstpointer a, gconstpointer b)
+{
+	const dissectorprof_entry_t *ea = (const dissectorprof_entry_t *)a;
+	const dissectorprof_entry_t *eb = (const dissectorprof_entry_t *)b;
+
+	/* Most exclusive time first */
+	if (ea->profile.exclusive_usecs != eb->profile.exclusive_usecs)
+		return ea->profile.exclusive_usecs > eb->profile.exclusive_usecs ? -1 : 1;
+	return strcmp(ea->name, eb->name);
+}
+
+typedef struct {
+	const char *name;
+	reassembly_table_usage_t usage;
+} reassemblyprof_entry_t;
+
+static void
+dissectortableprof_collect(const char *table_name, const dissector_table_profile_t *profile, gpointer user_data)
+{
+	GArray *entries = (GArray *)user_data;
+	dissectortableprof_entry_t entry;
+
+	entry.name = table_name;
+	entry.profile = *profile;
+	g_array_append_val(entries, entry);
+}
+
+static gint
+dissectortableprof_compare(gconstpointer a, gconstpointer b)
+{
+	const dissectortableprof_entry_t *ea = (const dissectortableprof_entry_t *)a;
+	const dissectortableprof_entry_t *eb = (const dissectortableprof_entry_t *)b;
+
+	/* Most lookups first */
+	if (ea->profile.lookups != eb->profile.lookups)
+		return ea->profile.lookups > eb->profile.lookups ? -1 : 1;
+	return strcmp(ea->name, eb->name);
+}
+
+static void
+dissectortableprof_draw(void)
+{
+	GArray *entries = g_array_new(FALSE, FALSE, sizeof(dissectortableprof_entry_t));
+	guint i;
+
+	dissector_table_profile_foreach(dissectortableprof_collect, entries);
+	g_array_sort(entries, dissectortableprof_compare);
+
+	printf("\n");
+	printf("Dissector Table Lookups\n");
+	printf("Indexed lookups were answered without searching the hash table\n\n");
+	printf("%-32s %14s %14s %14s\n",
+	       "Table", "Lookups", "Hits", "Indexed");
+	for (i = 0; i < entries->len; i++) {
+		const dissectortableprof_entry_t *entry = &g_array_index(entries, dissectortableprof_entry_t, i);
+
+		printf("%-32s %14" G_GUINT64_FORMAT " %14" G_GUINT64_FORMAT " %14" G_GUINT64_FORMAT "\n",
+		       entry->name,
+		       entry->profile.lookups,
+		       entry->profile.hits,
+		       entry->profile.indexed);
+	}
+
+	g_array_free(entries, TRUE);
+}
+
+static void
+reassemblyprof_collect(const char *name, const reassembly_table_usage_t *usage, gpointer user_data)
+{
+	GArray *entries = (GArray *)user_data;
+	reassemblyprof_entry_t entry;
+
+	/* Tables no protocol has added a fragment to */
+	if (name == NULL)
+		return;
+	entry.name = name;
+	entry.usage = *usage;
+	g_array_append_val(entries, entry);
+}
+
+static gint
+reassemblyprof_compare(gconstpointer a, gconstpointer b)
+{
+	const reassemblyprof_entry_t *ea = (const reassemblyprof_entry_t *)a;
+	const reassemblyprof_entry_t *eb = (const reassemblyprof_entry_t *)b;
+
+	if (ea->usage.bytes != eb->usage.bytes)
+		return ea->usage.bytes > eb->usage.bytes ? -1 : 1;
+	return strcmp(ea->name, eb->name);
+}
+
+static void
+reassemblyprof_draw(void)
+{
+	GArray *entries = g_array_new(FALSE, FALSE, sizeof(reassemblyprof_entry_t));
+	guint i;
+
+	reassembly_table_usage_foreach(reassemblyprof_collect, entries);
+	g_array_sort(entries, reassemblyprof_compare);
+
+	printf("\n");
+	printf("Reassembly Tables\n");
+	printf("Memory held by unfinished reassemblies; discarded ones went unfinished too long\n\n");
+	printf("%-32s %12s %12s %14s %12s\n",
+	       "Table", "Unfinished", "Fragments", "Bytes", "Discarded");
+	for (i = 0; i < entries->len; i++) {
+		const reassemblyprof_entry_t *entry = &g_array_index(entries, reassemblyprof_entry_t, i);
+
+		printf("%-32s %12u %12u %14" G_GUINT64_FORMAT " %12" G_GUINT64_FORMAT "\n",
+		       entry->name,
+		       entry->usage.unfinished,
+		       entry->usage.fragments,
+		       entry->usage.bytes,
+		       entry->usage.evicted);
+	}
+
+	g_array_free(entries, TRUE);
+}
+
+static void
+dissectorprof_draw(void *prs _U_)
+{
+	GArray *entries = g_array_new(FALSE, FALSE, sizeof(dissectorprof_entry_t));
+	gint64 total_usecs = 0;
+	guint i;
+
+	dissector_profile_foreach(dissectorprof_collect, entries);
+	g_array_sort(entries, dissectorprof_compare);
+	for (i = 0; i < entries->len; i++) {
+		total_usecs += g_array_index(entries, dissectorprof_entry_t, i).profile.exclusive_usecs;
+	}
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Dissector Profile\n");
+	printf("Times in microseconds; exclusive time excludes called dissectors\n\n");
+	printf("%-32s %12s %14s %12s %12s %7s\n",
+	       "Dissector", "Calls", "Bytes", "Inclusive", "Exclusive", "Excl %");
+	for (i = 0; i < entries->len; i++) {
+		const dissectorprof_entry_t *entry = &g_array_index(entries, dissectorprof_entry_t, i);
+
+		printf("%-32s %12" G_GUINT64_FORMAT " %14" G_GUINT64_FORMAT " %12" G_GINT64_FORMAT " %12" G_GINT64_FORMAT " %6.2f%%\n",
+		       entry->name,
+		       entry->profile.calls,
+		       entry->profile.bytes,
+		       entry->profile.inclusive_usecs,
+		       entry->profile.exclusive_usecs,
+		       total_usecs ? 100.0 * entry->profile.exclusive_usecs / total_usecs : 0.0);
+	}
+	dissectortableprof_draw();
+	reassemblyprof_draw();
+	printf("===================================================================\n");
+
+	g_array_free(entries, TRUE);
+}
+
+static void
+dissectorprof_reset(void *prs _U_)
+{
+	dissector_profile_reset();
+}
+
+static void
+dissectorprof_init(const char *opt_arg, void *userdata _U_)
+{
+	static int dissectorprof_tap_data;
+	GString *error_string;
+
+	if (strcmp("dissector,prof", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z dissector,prof\" argument");
+		exit(1);
+	}
+
+	/* The tap is only used to print the profile when we're done */
+	error_string = register_tap_listener("frame", &dissectorprof_tap_data, NULL, TL_REQUIRES_NOTHING,
+					     dissectorprof_reset, NULL, dissectorprof_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register dissector,prof tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+
+	set_dissector_profiling(TRUE);
+}
+
+static stat_tap_ui dissectorprof_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"dissector,prof",
+	dissectorprof_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_dissectorprof(void)
+{
+	register_stat_tap_ui(&dissectorprof_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -0,0 +1,106 @@
+/* tap-memstat.c
+ * Memory used by the wmem scopes and the process, for tshark -z memory,stat
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <epan/app_mem_usage.h>
+#include <epan/tap.h>
+#include <epan/stat_tap_ui.h>
+#include <epan/wmem/wmem.h>
+
+#include <ui/cmdarg_err.h>
+
+void register_tap_listener_memstat(void);
+
+static void
+memstat_print_scope(const char *name, wmem_allocator_t *scope)
+{
+	wmem_allocator_stats_t stats;
+
+	wmem_get_stats(scope, &stats);
+	printf("%-24s %14" G_GUINT64_FORMAT " %16" G_GUINT64_FORMAT " %16" G_GUINT64_FORMAT "\n",
+	       name, stats.allocations, stats.bytes, stats.peak_bytes);
+}
+
+static void
+memstat_draw(void *prs _U_)
+{
+	const char *name;
+	gsize value;
+	guint i;
+
+	printf("\n");
+	printf("===================================================================\n");
+	printf("Memory Statistics\n\n");
+	printf("%-24s %14s %16s %16s\n", "Scope", "Allocations", "Bytes", "Peak bytes");
+	memstat_print_scope("Packet", wmem_packet_scope());
+	memstat_print_scope("File", wmem_file_scope());
+	memstat_print_scope("Epan", wmem_epan_scope());
+	printf("\n");
+	printf("%-24s %16s\n", "Component", "Bytes");
+	for (i = 0; (name = memory_usage_get(i, &value)) != NULL; i++) {
+		printf("%-24s %16" G_GSIZE_FORMAT "\n", name, value);
+	}
+	printf("===================================================================\n");
+}
+
+static void
+memstat_init(const char *opt_arg, void *userdata _U_)
+{
+	static int memstat_tap_data;
+	GString *error_string;
+
+	if (strcmp("memory,stat", opt_arg) != 0) {
+		cmdarg_err("invalid \"-z memory,stat\" argument");
+		exit(1);
+	}
+
+	/* The tap is only used to print the statistics when we're done */
+	error_string = register_tap_listener("frame", &memstat_tap_data, NULL, TL_REQUIRES_NOTHING,
+					     NULL, NULL, memstat_draw, NULL);
+	if (error_string) {
+		cmdarg_err("Couldn't register memory,stat tap: %s",
+			error_string->str);
+		g_string_free(error_string, TRUE);
+		exit(1);
+	}
+}
+
+static stat_tap_ui memstat_ui = {
+	REGISTER_STAT_GROUP_GENERIC,
+	NULL,
+	"memory,stat",
+	memstat_init,
+	0,
+	NULL
+};
+
+void
+register_tap_listener_memstat(void)
+{
+	register_stat_tap_ui(&memstat_ui, NULL);
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
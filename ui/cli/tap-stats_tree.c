@@ -13,13 +13,19 @@
 
 #include <string.h>
 #include <stdio.h>
+#include <errno.h>
 #include <glib.h>
 
 #include <wsutil/report_message.h>
+#include <wsutil/file_util.h>
 
 #include <epan/stats_tree_priv.h>
 #include <epan/stat_tap_ui.h>
 
+#include <ui/cmdarg_err.h>
+
+#include <ui/cli/tshark-tap.h>
+
 void register_tap_listener_stats_tree_stat(void);
 
 /* actually unused */
@@ -35,12 +41,23 @@ struct _tree_cfg_pres {
 	gchar *init_string;
 };
 
+/* --export-stats file; if set, the trees are written there instead of printed */
+static FILE *export_file = NULL;
+
 static void
 draw_stats_tree(void *psp)
 {
 	stats_tree *st = (stats_tree *)psp;
 	GString *s;
 
+	if (export_file) {
+		s = g_string_new(NULL);
+		stats_tree_serialize(st, s);
+		fputs(s->str, export_file);
+		g_string_free(s, TRUE);
+		return;
+	}
+
 	s= stats_tree_format_as_str(st, ST_FORMAT_PLAIN, stats_tree_get_default_sort_col(st),
 				    stats_tree_is_default_sort_DESC(st));
 
@@ -48,6 +65,114 @@ draw_stats_tree(void *psp)
 	g_string_free(s, TRUE);
 }
 
+gboolean
+stats_tree_export_open(const char *path)
+{
+	export_file = ws_fopen(path, "w");
+	if (export_file == NULL) {
+		cmdarg_err("Can't create stats file \"%s\": %s", path, g_strerror(errno));
+		return FALSE;
+	}
+	return TRUE;
+}
+
+gboolean
+stats_tree_export_close(void)
+{
+	gboolean ok = TRUE;
+
+	if (export_file) {
+		if (fclose(export_file) == EOF) {
+			cmdarg_err("Error writing stats file: %s", g_strerror(errno));
+			ok = FALSE;
+		}
+		export_file = NULL;
+	}
+	return ok;
+}
+
+/* Merges the serialized trees in one file into trees, keyed by abbr and filter */
+static gboolean
+merge_stats_file(const char *path, GHashTable *trees, GPtrArray *order)
+{
+	gchar *contents;
+	const gchar *data;
+	GError *error = NULL;
+	gchar *err = NULL;
+
+	if (!g_file_get_contents(path, &contents, NULL, &error)) {
+		cmdarg_err("Can't read stats file: %s", error->message);
+		g_error_free(error);
+		return FALSE;
+	}
+
+	for (data = contents; data != NULL && *data != '\0'; ) {
+		gchar *abbr, *filter, *key;
+		stats_tree_cfg *cfg;
+		stats_tree *st;
+
+		if (!stats_tree_serialized_info(data, &abbr, &filter, &err))
+			break;
+
+		key = g_strconcat(abbr, "\t", filter, NULL);
+		st = (stats_tree *)g_hash_table_lookup(trees, key);
+		if (st == NULL) {
+			cfg = stats_tree_get_cfg_by_abbr(abbr);
+			if (cfg == NULL) {
+				err = g_strdup_printf("no such stats_tree (%s) found in stats_tree registry", abbr);
+				g_free(key);
+				g_free(abbr);
+				g_free(filter);
+				break;
+			}
+			st = stats_tree_new(cfg, NULL, filter);
+			if (cfg->init) cfg->init(st);
+			g_hash_table_insert(trees, key, st);
+			g_ptr_array_add(order, st);
+		} else {
+			g_free(key);
+		}
+		g_free(abbr);
+		g_free(filter);
+
+		data = stats_tree_merge(st, data, &err);
+	}
+	g_free(contents);
+
+	if (err) {
+		cmdarg_err("Stats file \"%s\": %s", path, err);
+		g_free(err);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+gboolean
+stats_tree_merge_files(GSList *paths)
+{
+	GHashTable *trees = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	GPtrArray *order = g_ptr_array_new();
+	gboolean ok = TRUE;
+	GSList *path;
+	guint i;
+
+	for (path = paths; path && ok; path = g_slist_next(path)) {
+		ok = merge_stats_file((const char *)path->data, trees, order);
+	}
+
+	/* Print (or export again) the trees in the order they were first seen */
+	for (i = 0; i < order->len; i++) {
+		stats_tree *st = (stats_tree *)g_ptr_array_index(order, i);
+
+		if (ok)
+			draw_stats_tree(st);
+		stats_tree_free(st);
+	}
+	g_ptr_array_free(order, TRUE);
+	g_hash_table_destroy(trees);
+	return ok;
+}
+
 static void
 init_stats_tree(const char *opt_arg, void *userdata _U_)
 {
@@ -18,4 +18,10 @@ extern gboolean register_srt_tables(const void *key, void *value, void *userdata
 extern gboolean register_rtd_tables(const void *key, void *value, void *userdata);
 extern gboolean register_simple_stat_tables(const void *key, void *value, void *userdata);
 
+/* --export-stats: write the -z stats trees to a file, for --merge-stats */
+extern gboolean stats_tree_export_open(const char *path);
+extern gboolean stats_tree_export_close(void);
+/* --merge-stats: sum up the stats trees exported to the given files and print them */
+extern gboolean stats_tree_merge_files(GSList *paths);
+
 #endif /* __TSHARK_TAP_H__ */
@@ -29,6 +29,7 @@
 #include <ui/clopts_common.h>
 #include <ui/cmdarg_err.h>
 #include <wsutil/filesystem.h>
+#include <wsutil/startup_timings.h>
 
 #include <epan/ex-opt.h>
 #include <epan/packet.h>
@@ -96,6 +97,7 @@ commandline_print_usage(gboolean for_help_option) {
     fprintf(output, "  -D                       print list of interfaces and exit\n");
     fprintf(output, "  -L                       print list of link-layer types of iface and exit\n");
     fprintf(output, "  --list-time-stamp-types  print list of timestamp types for iface and exit\n");
+    fprintf(output, "  --update-interval        interval between updates with new packets (def: %dms)\n", DEFAULT_UPDATE_INTERVAL);
     fprintf(output, "\n");
     fprintf(output, "Capture stop conditions:\n");
     fprintf(output, "  -c <packet count>        stop after n packets (def: infinite)\n");
@@ -132,6 +134,9 @@ commandline_print_usage(gboolean for_help_option) {
     fprintf(output, "                           enable dissection of heuristic protocol\n");
     fprintf(output, "  --disable-heuristic <short_name>\n");
     fprintf(output, "                           disable dissection of heuristic protocol\n");
+    fprintf(output, "  --startup-timings <file>\n");
+    fprintf(output, "                           write the time taken by each startup step to\n");
+    fprintf(output, "                           <file> as JSON\n");
 
     fprintf(output, "\n");
     fprintf(output, "User interface:\n");
@@ -315,6 +320,9 @@ void commandline_early_options(int argc, char *argv[])
                  */
                 ex_opt_add(optarg);
                 break;
+            case LONGOPT_STARTUP_TIMINGS: /* time the steps of epan_init() */
+                startup_timings_enable();
+                break;
             case '?':        /* Ignore errors - the "real" scan will catch them. */
                 break;
         }
@@ -404,6 +412,7 @@ void commandline_other_options(int argc, char *argv[], gboolean opt_reset)
             case 'p':        /* Don't capture in promiscuous mode */
             case 'i':        /* Use interface x */
             case LONGOPT_SET_TSTAMP_TYPE: /* Set capture timestamp type */
+            case LONGOPT_UPDATE_INTERVAL: /* Set the update interval */
 #ifdef HAVE_PCAP_CREATE
             case 'I':        /* Capture in monitor mode, if available */
 #endif
@@ -557,6 +566,7 @@ void commandline_other_options(int argc, char *argv[], gboolean opt_reset)
             case LONGOPT_ENABLE_HEURISTIC: /* enable heuristic dissection of protocol */
             case LONGOPT_DISABLE_HEURISTIC: /* disable heuristic dissection of protocol */
             case LONGOPT_ENABLE_PROTOCOL: /* enable dissection of protocol (that is disabled by default) */
+            case LONGOPT_STARTUP_TIMINGS: /* write startup timings as JSON */
                 if (!dissect_opts_handle_opt(opt, optarg))
                    exit_application(1);
                 break;
@@ -33,6 +33,7 @@
 #include <ui/clopts_common.h>
 #include <ui/cmdarg_err.h>
 #include <wsutil/file_util.h>
+#include <wsutil/startup_timings.h>
 
 #include "ui/dissect_opts.h"
 
@@ -46,6 +47,7 @@ dissect_opts_init(void)
     global_dissect_options.enable_protocol_slist = NULL;
     global_dissect_options.enable_heur_slist = NULL;
     global_dissect_options.disable_heur_slist = NULL;
+    global_dissect_options.startup_timings_file = NULL;
 }
 
 gboolean
@@ -144,6 +146,9 @@ dissect_opts_handle_opt(int opt, char *optarg_str_p)
     case LONGOPT_ENABLE_PROTOCOL: /* enable dissection of protocol (that is disableed by default) */
         global_dissect_options.enable_protocol_slist = g_slist_append(global_dissect_options.enable_protocol_slist, optarg_str_p);
         break;
+    case LONGOPT_STARTUP_TIMINGS: /* write startup timings as JSON */
+        global_dissect_options.startup_timings_file = optarg_str_p;
+        break;
     default:
         /* the caller is responsible to send us only the right opt's */
         g_assert_not_reached();
@@ -194,6 +199,23 @@ setup_enabled_and_disabled_protocols(void)
     return success;
 }
 
+gboolean
+dissect_opts_write_startup_timings(void)
+{
+    gboolean success = TRUE;
+
+    if (global_dissect_options.startup_timings_file != NULL &&
+        !startup_timings_write_json(global_dissect_options.startup_timings_file)) {
+        cmdarg_err("Can't write startup timings to \"%s\": %s",
+                   global_dissect_options.startup_timings_file, g_strerror(errno));
+        success = FALSE;
+    }
+
+    /* Startup is over; nothing records timings after this. */
+    startup_timings_cleanup();
+    return success;
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -45,6 +45,7 @@ extern "C" {
 #define LONGOPT_ENABLE_HEURISTIC  4097
 #define LONGOPT_DISABLE_HEURISTIC 4098
 #define LONGOPT_ENABLE_PROTOCOL   4099
+#define LONGOPT_STARTUP_TIMINGS   4100
 
 /*
  * Options for dissecting common to all dissecting programs.
@@ -54,6 +55,7 @@ extern "C" {
     {"enable-heuristic", required_argument, NULL, LONGOPT_ENABLE_HEURISTIC }, \
     {"disable-heuristic", required_argument, NULL, LONGOPT_DISABLE_HEURISTIC }, \
     {"enable-protocol", required_argument, NULL, LONGOPT_ENABLE_PROTOCOL }, \
+    {"startup-timings", required_argument, NULL, LONGOPT_STARTUP_TIMINGS }, \
 
 #define OPTSTRING_DISSECT_COMMON \
     "d:K:nN:t:u:"
@@ -65,6 +67,7 @@ typedef struct dissect_options_tag {
     GSList *disable_protocol_slist;
     GSList *enable_heur_slist;
     GSList *disable_heur_slist;
+    const char *startup_timings_file; // --startup-timings output file
 } dissect_options;
 
 extern dissect_options global_dissect_options;
@@ -91,6 +94,10 @@ dissect_opts_handle_opt(int opt, char *optarg_str_p);
 extern gboolean
 setup_enabled_and_disabled_protocols(void);
 
+/* Write the startup timings to the --startup-timings file, if given */
+extern gboolean
+dissect_opts_write_startup_timings(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
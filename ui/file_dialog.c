@@ -74,7 +74,8 @@ get_stats_for_preview(wtap *wth, ws_file_preview_stats *stats,
         }
 
         records++;
-        if ((records % 1000) == 0) {
+        /* Check often, so that slow (e.g. network) reads don't overrun much */
+        if ((records % 100) == 0) {
             /* do we have a timeout? */
             time(&time_current);
             if (time_current-time_preview >= (time_t) prefs.gui_fileopen_preview) {
@@ -89,6 +90,7 @@ get_stats_for_preview(wtap *wth, ws_file_preview_stats *stats,
     stats->stop_time = stop_time;
     stats->records = records;
     stats->data_records = data_records;
+    stats->bytes_read = wtap_read_so_far(wth);
 
     wtap_rec_cleanup(&rec);
     ws_buffer_free(&buf);
@@ -100,6 +102,27 @@ get_stats_for_preview(wtap *wth, ws_file_preview_stats *stats,
     return timed_out ? PREVIEW_TIMED_OUT : PREVIEW_SUCCEEDED;
 }
 
+guint32
+estimate_data_records_for_preview(const ws_file_preview_stats *stats,
+                                  gint64 filesize)
+{
+    double estimate;
+
+    /*
+     * Records are assumed to average the same size over the rest of
+     * the file.  wtap_read_so_far() is an offset in the file as stored,
+     * so this works for compressed files too.
+     */
+    if (stats->bytes_read <= 0 || filesize <= 0 || stats->data_records == 0)
+        return 0;
+    if (stats->bytes_read >= filesize)
+        return stats->data_records;
+    estimate = (double)stats->data_records * (double)filesize / (double)stats->bytes_read;
+    if (estimate > G_MAXUINT32)
+        return G_MAXUINT32;
+    return (guint32)estimate;
+}
+
 /*
  * Editor modelines
  *
@@ -38,6 +38,7 @@ typedef struct {
     double stop_time;     /* seconds, with nsec resolution */
     guint32 records;      /* total number of records */
     guint32 data_records; /* number of data records */
+    gint64 bytes_read;    /* bytes of the file read to get these records */
 } ws_file_preview_stats;
 
 typedef enum {
@@ -50,6 +51,15 @@ extern ws_file_preview_stats_status
 get_stats_for_preview(wtap *wth, ws_file_preview_stats *stats,
                       int *err, gchar **err_info);
 
+/*
+ * Estimate the number of data records in a file of filesize bytes,
+ * from the stats of a preview that read part of it.
+ * Returns 0 if there's no estimate.
+ */
+extern guint32
+estimate_data_records_for_preview(const ws_file_preview_stats *stats,
+                                  gint64 filesize);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
@@ -125,16 +125,18 @@ GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_u
     return err_str;
 }
 
-// Adapted from get_it_value in gtk/io_stat.c.
 double get_io_graph_item(const io_graph_item_t *items_, io_graph_item_unit_t val_units_, int idx, int hf_index_, const capture_file *cap_file, int interval_, int cur_idx_)
+{
+    return get_io_graph_item_value(&items_[idx], val_units_, idx, hf_index_, cap_file, interval_, cur_idx_);
+}
+
+// Adapted from get_it_value in gtk/io_stat.c.
+double get_io_graph_item_value(const io_graph_item_t *item, io_graph_item_unit_t val_units_, int idx, int hf_index_, const capture_file *cap_file, int interval_, int cur_idx_)
 {
     double     value = 0;          /* FIXME: loss of precision, visible on the graph for small values */
     int        adv_type;
-    const io_graph_item_t *item;
     guint32    interval;
 
-    item = &items_[idx];
-
     // Basic units
     switch (val_units_) {
     case IOG_ITEM_UNIT_PACKETS:
@@ -93,6 +93,84 @@ reset_io_graph_items(io_graph_item_t *items, gsize count) {
     }
 }
 
+/** Merge one io_graph_item_t into another.
+ *
+ * Used to derive the items for a coarser interval from items tapped at a
+ * finer one without retapping. dst and src must have been updated with the
+ * same hf_index and item_unit.
+ *
+ * @param dst [in,out] The item to merge into.
+ * @param src [in] The item to merge from.
+ * @param item_unit [in] The type of unit to calculate. From IOG_ITEM_UNITS.
+ */
+static inline void
+merge_io_graph_item(io_graph_item_t *dst, const io_graph_item_t *src, int item_unit) {
+    if (src->fields > 0) {
+        if (dst->fields == 0) {
+            dst->int_max    = src->int_max;
+            dst->int_min    = src->int_min;
+            dst->float_max  = src->float_max;
+            dst->float_min  = src->float_min;
+            dst->double_max = src->double_max;
+            dst->double_min = src->double_min;
+            dst->time_max   = src->time_max;
+            dst->time_min   = src->time_min;
+            dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+        } else {
+            /* Only one of the value types is in use for a given field;
+             * the others are zero in both items. */
+            gboolean new_max = (src->int_max > dst->int_max)
+                               || (src->float_max > dst->float_max)
+                               || (src->double_max > dst->double_max)
+                               || (nstime_cmp(&src->time_max, &dst->time_max) > 0);
+            gboolean new_min = (src->int_min < dst->int_min)
+                               || (src->float_min < dst->float_min)
+                               || (src->double_min < dst->double_min)
+                               || (nstime_cmp(&src->time_min, &dst->time_min) < 0);
+
+            if (new_max) {
+                dst->int_max    = MAX(dst->int_max, src->int_max);
+                dst->float_max  = MAX(dst->float_max, src->float_max);
+                dst->double_max = MAX(dst->double_max, src->double_max);
+                if (nstime_cmp(&src->time_max, &dst->time_max) > 0) {
+                    dst->time_max = src->time_max;
+                }
+                if (item_unit == IOG_ITEM_UNIT_CALC_MAX) {
+                    dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+                }
+            }
+            if (new_min) {
+                dst->int_min    = MIN(dst->int_min, src->int_min);
+                dst->float_min  = MIN(dst->float_min, src->float_min);
+                dst->double_min = MIN(dst->double_min, src->double_min);
+                if (nstime_cmp(&src->time_min, &dst->time_min) < 0) {
+                    dst->time_min = src->time_min;
+                }
+                if (item_unit == IOG_ITEM_UNIT_CALC_MIN) {
+                    dst->extreme_frame_in_invl = src->extreme_frame_in_invl;
+                }
+            }
+        }
+    }
+
+    dst->frames     += src->frames;
+    dst->bytes      += src->bytes;
+    dst->fields     += src->fields;
+    dst->int_tot    += src->int_tot;
+    dst->float_tot  += src->float_tot;
+    dst->double_tot += src->double_tot;
+    /* LOAD spreads each call across the intervals it spans, so its
+     * time_tot is additive as well. */
+    nstime_add(&dst->time_tot, &src->time_tot);
+
+    if (dst->first_frame_in_invl == 0) {
+        dst->first_frame_in_invl = src->first_frame_in_invl;
+    }
+    if (src->last_frame_in_invl != 0) {
+        dst->last_frame_in_invl = src->last_frame_in_invl;
+    }
+}
+
 /** Get the interval (array index) for a packet
  *
  * It is up to the caller to determine if the return value is valid.
@@ -126,12 +204,26 @@ GString *check_field_unit(const char *field_name, int *hf_index, io_graph_item_u
  */
 double get_io_graph_item(const io_graph_item_t *items, io_graph_item_unit_t val_units, int idx, int hf_index, const capture_file *cap_file, int interval, int cur_idx);
 
+/** Like get_io_graph_item, for an item that isn't part of an array.
+ *
+ * @param item [in] The item for interval idx.
+ */
+double get_io_graph_item_value(const io_graph_item_t *item, io_graph_item_unit_t val_units, int idx, int hf_index, const capture_file *cap_file, int interval, int cur_idx);
+
+/** Return the item for interval idx in a store of items, creating it if
+ * needed. Used by update_io_graph_item_in() for stores that aren't a single
+ * array.
+ */
+typedef io_graph_item_t *(*io_graph_item_lookup_func)(void *items, int idx);
+
 /** Update the values of an io_graph_item_t.
  *
  * Frame and byte counts are always calculated. If edt is non-NULL advanced
  * statistics are calculated using hfindex.
  *
- * @param items [in,out] Array containing the item to update.
+ * @param lookup [in] Returns the item for an index in items. LOAD
+ * calculations also look up items before idx.
+ * @param items [in,out] Store containing the item to update.
  * @param idx [in] Index of the item to update.
  * @param pinfo [in] Packet containing update information.
  * @param edt [in] Dissection information for advanced statistics. May be NULL.
@@ -141,8 +233,8 @@ double get_io_graph_item(const io_graph_item_t *items, io_graph_item_unit_t val_
  * @return TRUE if the update was successful, otherwise FALSE.
  */
 static inline gboolean
-update_io_graph_item(io_graph_item_t *items, int idx, packet_info *pinfo, epan_dissect_t *edt, int hf_index, int item_unit, guint32 interval) {
-    io_graph_item_t *item = &items[idx];
+update_io_graph_item_in(io_graph_item_lookup_func lookup, void *items, int idx, packet_info *pinfo, epan_dissect_t *edt, int hf_index, int item_unit, guint32 interval) {
+    io_graph_item_t *item = lookup(items, idx);
 
     /* Set the first and last frame num in current interval matching the target field+filter  */
     if (item->first_frame_in_invl == 0) {
@@ -310,7 +402,7 @@ update_io_graph_item(io_graph_item_t *items, int idx, packet_info *pinfo, epan_d
                     while (t) {
                         io_graph_item_t *load_item;
 
-                        load_item = &items[j];
+                        load_item = lookup(items, j);
                         load_item->time_tot.nsecs += (int) (pt * 1000);
                         if (load_item->time_tot.nsecs > 1000000000) {
                             load_item->time_tot.secs++;
@@ -382,6 +474,22 @@ update_io_graph_item(io_graph_item_t *items, int idx, packet_info *pinfo, epan_d
     return TRUE;
 }
 
+static inline io_graph_item_t *
+io_graph_item_array_lookup(void *items, int idx) {
+    return &((io_graph_item_t *)items)[idx];
+}
+
+/** Update the values of an io_graph_item_t in an array of items.
+ *
+ * @see update_io_graph_item_in
+ *
+ * @param items [in,out] Array containing the item to update.
+ */
+static inline gboolean
+update_io_graph_item(io_graph_item_t *items, int idx, packet_info *pinfo, epan_dissect_t *edt, int hf_index, int item_unit, guint32 interval) {
+    return update_io_graph_item_in(io_graph_item_array_lookup, items, idx, pinfo, edt, hf_index, item_unit, interval);
+}
+
 
 #ifdef __cplusplus
 }
@@ -18,6 +18,7 @@
 #include "ui/progress_dlg.h"
 #include "epan/epan_dissect.h"
 #include "epan/proto.h"
+#include "epan/wmem/wmem.h"
 
 /* Update the progress bar this many times when scanning the packet list. */
 #define N_PROGBAR_UPDATES	100
@@ -77,57 +78,60 @@ find_stat_node(GNode *parent_stat_node, header_field_info *needle_hfinfo)
 }
 
 
-    static void
-process_node(proto_node *ptree_node, GNode *parent_stat_node, ph_stats_t *ps)
-{
-    field_info		*finfo;
-    ph_stats_node_t	*stats;
-    proto_node		*proto_sibling_node;
-    GNode		*stat_node;
-
-    finfo = PNODE_FINFO(ptree_node);
-    /* We don't fake protocol nodes we expect them to have a field_info.
-     * Dissection with faked proto tree? */
-    g_assert(finfo);
-
-    /* If the field info isn't related to a protocol but to a field,
-     * don't count them, as they don't belong to any protocol.
-     * (happens e.g. for toplevel tree item of desegmentation "[Reassembled TCP Segments]") */
-    if (finfo->hfinfo->parent != -1) {
-        /* Skip this element, use parent status node */
-        stat_node = parent_stat_node;
-        stats = STAT_NODE_STATS(stat_node);
-    } else {
-        stat_node = find_stat_node(parent_stat_node, finfo->hfinfo);
-
-        stats = STAT_NODE_STATS(stat_node);
-        stats->num_pkts_total++;
-        stats->num_bytes_total += finfo->length;
-    }
-
-    proto_sibling_node = ptree_node->next;
+/*
+ * The protocol stack of every frame dissected for the statistics is
+ * recorded, so that they can be computed again, e.g. with another
+ * display filter or after more packets were captured, without
+ * dissecting those frames again. The records belong to the dissection
+ * session and are dropped when the file scope is freed (the file is
+ * closed or redissected).
+ */
+typedef struct {
+    int		hf_id;
+    guint32	length;
+} ph_layer_t;
+
+typedef struct {
+    guint32	first_layer;	/* index into ph_cache.layers */
+    guint16	num_layers;
+    guint16	dissected;
+} ph_frame_stack_t;
+
+static struct {
+    GArray	*frames;	/* ph_frame_stack_t, indexed by frame number - 1 */
+    GArray	*layers;	/* ph_layer_t */
+} ph_cache;
 
-    if (proto_sibling_node) {
-        /* If the name does not exist for this proto_sibling_node, then it is
-         * not a normal protocol in the top-level tree.  It was instead
-         * added as a normal tree such as IPv6's Hop-by-hop Option Header and
-         * should be skipped when creating the protocol hierarchy display. */
-        if(strlen(PNODE_FINFO(proto_sibling_node)->hfinfo->name) == 0 && ptree_node->next)
-            proto_sibling_node = proto_sibling_node->next;
+    static gboolean
+ph_cache_free_cb(wmem_allocator_t *allocator _U_, wmem_cb_event_t event _U_, void *user_data _U_)
+{
+    g_array_free(ph_cache.frames, TRUE);
+    g_array_free(ph_cache.layers, TRUE);
+    ph_cache.frames = NULL;
+    ph_cache.layers = NULL;
+    return FALSE;
+}
 
-        process_node(proto_sibling_node, stat_node, ps);
-    } else {
-        stats->num_pkts_last++;
-        stats->num_bytes_last += finfo->length;
+    static void
+ph_cache_init(guint32 count)
+{
+    if (!ph_cache.frames) {
+        ph_cache.frames = g_array_sized_new(FALSE, TRUE, sizeof(ph_frame_stack_t), count);
+        ph_cache.layers = g_array_new(FALSE, FALSE, sizeof(ph_layer_t));
+        wmem_register_callback(wmem_file_scope(), ph_cache_free_cb, NULL);
     }
+    if (ph_cache.frames->len < count)
+        g_array_set_size(ph_cache.frames, count);
 }
 
-
-
     static void
-process_tree(proto_tree *protocol_tree, ph_stats_t* ps)
+record_tree(proto_tree *protocol_tree, ph_frame_stack_t *stack)
 {
     proto_node	*ptree_node;
+    field_info	*finfo;
+    ph_layer_t	layer;
+
+    stack->first_layer = ph_cache.layers->len;
 
     /*
      * If our first item is a comment, skip over it. This keeps
@@ -139,34 +143,89 @@ process_tree(proto_tree *protocol_tree, ph_stats_t* ps)
         ptree_node = ptree_node->next;
     }
 
-    if (!ptree_node) {
-        return;
+    while (ptree_node && stack->num_layers < G_MAXUINT16) {
+        finfo = PNODE_FINFO(ptree_node);
+        /* We don't fake protocol nodes we expect them to have a field_info.
+         * Dissection with faked proto tree? */
+        g_assert(finfo);
+
+        layer.hf_id = finfo->hfinfo->id;
+        layer.length = finfo->length;
+        g_array_append_val(ph_cache.layers, layer);
+        stack->num_layers++;
+
+        ptree_node = ptree_node->next;
+        /* If the name does not exist for this sibling node, then it is
+         * not a normal protocol in the top-level tree.  It was instead
+         * added as a normal tree such as IPv6's Hop-by-hop Option Header and
+         * should be skipped when creating the protocol hierarchy display. */
+        if (ptree_node && strlen(PNODE_FINFO(ptree_node)->hfinfo->name) == 0)
+            ptree_node = ptree_node->next;
+    }
+    stack->dissected = TRUE;
+}
+
+    static void
+process_stack(const ph_frame_stack_t *stack, ph_stats_t *ps)
+{
+    GNode		*stat_node = ps->stats_tree;
+    ph_stats_node_t	*stats = NULL;
+    header_field_info	*hfinfo;
+    const ph_layer_t	*layer = NULL;
+    guint		i;
+
+    for (i = 0; i < stack->num_layers; i++) {
+        layer = &g_array_index(ph_cache.layers, ph_layer_t, stack->first_layer + i);
+        hfinfo = proto_registrar_get_nth(layer->hf_id);
+
+        /* If the field info isn't related to a protocol but to a field,
+         * don't count them, as they don't belong to any protocol.
+         * (happens e.g. for toplevel tree item of desegmentation "[Reassembled TCP Segments]")
+         * Such an element uses its parent's status node. */
+        if (hfinfo->parent == -1) {
+            stat_node = find_stat_node(stat_node, hfinfo);
+            stats = STAT_NODE_STATS(stat_node);
+            stats->num_pkts_total++;
+            stats->num_bytes_total += layer->length;
+        }
     }
 
-    process_node(ptree_node, ps->stats_tree, ps);
+    if (stats) {
+        stats->num_pkts_last++;
+        stats->num_bytes_last += layer->length;
+    }
 }
 
     static gboolean
 process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
                wtap_rec *rec, Buffer *buf, ph_stats_t* ps)
 {
+    ph_frame_stack_t	*stack;
     epan_dissect_t	edt;
     double		cur_time;
 
-    /* Load the record from the capture file */
-    if (!cf_read_record(cf, frame, rec, buf))
-        return FALSE;	/* failure */
+    stack = &g_array_index(ph_cache.frames, ph_frame_stack_t, frame->num - 1);
+    if (!stack->dissected) {
+        /* Load the record from the capture file */
+        if (!cf_read_record(cf, frame, rec, buf))
+            return FALSE;	/* failure */
 
-    /* Dissect the record   tree  not visible */
-    epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
-    /* Don't fake protocols. We need them for the protocol hierarchy */
-    epan_dissect_fake_protocols(&edt, FALSE);
-    epan_dissect_run(&edt, cf->cd_t, rec,
-                     frame_tvbuff_new_buffer(&cf->provider, frame, buf),
-                     frame, cinfo);
+        /* Dissect the record   tree  not visible */
+        epan_dissect_init(&edt, cf->epan, TRUE, FALSE);
+        /* Don't fake protocols. We need them for the protocol hierarchy */
+        epan_dissect_fake_protocols(&edt, FALSE);
+        epan_dissect_run(&edt, cf->cd_t, rec,
+                         frame_tvbuff_new_buffer(&cf->provider, frame, buf),
+                         frame, cinfo);
 
-    /* Get stats from this protocol tree */
-    process_tree(edt.tree, ps);
+        record_tree(edt.tree, stack);
+
+        /* Free our memory. */
+        epan_dissect_cleanup(&edt);
+    }
+
+    /* Get stats from this protocol stack */
+    process_stack(stack, ps);
 
     if (frame->has_ts) {
         /* Update times */
@@ -177,9 +236,6 @@ process_record(capture_file *cf, frame_data *frame, column_info *cinfo,
             ps->last_time = cur_time;
     }
 
-    /* Free our memory. */
-    epan_dissect_cleanup(&edt);
-
     return TRUE;	/* success */
 }
 
@@ -229,6 +285,8 @@ ph_stats_new(capture_file *cf)
     tot_packets = 0;
     tot_bytes = 0;
 
+    ph_cache_init(cf->count);
+
     wtap_rec_init(&rec);
     ws_buffer_init(&buf, 1514);
 
@@ -63,6 +63,15 @@ bluetooth_device_tap_reset(void *tapinfo_ptr)
         tapinfo->tap_reset(tapinfo);
 }
 
+static void
+bluetooth_device_tap_draw(void *tapinfo_ptr)
+{
+    bluetooth_devices_tapinfo_t *tapinfo = (bluetooth_devices_tapinfo_t *) tapinfo_ptr;
+
+    if (tapinfo->tap_draw)
+        tapinfo->tap_draw(tapinfo);
+}
+
 BluetoothDevicesDialog::BluetoothDevicesDialog(QWidget &parent, CaptureFile &cf, PacketList *packet_list) :
     WiresharkDialog(parent, cf),
     ui(new Ui::BluetoothDevicesDialog)
@@ -90,13 +99,14 @@ BluetoothDevicesDialog::BluetoothDevicesDialog(QWidget &parent, CaptureFile &cf,
 
     tapinfo_.tap_packet = tapPacket;
     tapinfo_.tap_reset  = tapReset;
+    tapinfo_.tap_draw   = tapDraw;
     tapinfo_.ui = this;
 
     registerTapListener("bluetooth.device", &tapinfo_, NULL,
                         0,
                         bluetooth_device_tap_reset,
                         bluetooth_device_tap_packet,
-                        NULL
+                        bluetooth_device_tap_draw
                         );
     ui->hintLabel->setText(ui->hintLabel->text().arg(0));
 
@@ -106,6 +116,7 @@ BluetoothDevicesDialog::BluetoothDevicesDialog(QWidget &parent, CaptureFile &cf,
 
 BluetoothDevicesDialog::~BluetoothDevicesDialog()
 {
+    qDeleteAll(pending_items_);
     delete ui;
 }
 
@@ -251,6 +262,46 @@ void BluetoothDevicesDialog::tapReset(void *tapinfo_ptr)
     BluetoothDevicesDialog  *bluetooth_devices_dialog = static_cast<BluetoothDevicesDialog *>(tapinfo->ui);
 
     bluetooth_devices_dialog->ui->tableTreeWidget->clear();
+    qDeleteAll(bluetooth_devices_dialog->pending_items_);
+    bluetooth_devices_dialog->pending_items_.clear();
+    bluetooth_devices_dialog->bd_addr_items_.clear();
+    bluetooth_devices_dialog->local_adapter_items_.clear();
+}
+
+void BluetoothDevicesDialog::tapDraw(void *tapinfo_ptr)
+{
+    bluetooth_devices_tapinfo_t *tapinfo = (bluetooth_devices_tapinfo_t *) tapinfo_ptr;
+    BluetoothDevicesDialog  *dialog = static_cast<BluetoothDevicesDialog *>(tapinfo->ui);
+
+    if (dialog->file_closed_)
+        return;
+
+    if (!dialog->pending_items_.isEmpty()) {
+        dialog->ui->tableTreeWidget->addTopLevelItems(dialog->pending_items_);
+        dialog->pending_items_.clear();
+    }
+
+    for (int i = 0; i < dialog->ui->tableTreeWidget->columnCount(); i++) {
+        dialog->ui->tableTreeWidget->resizeColumnToContents(i);
+    }
+
+    dialog->ui->hintLabel->setText(QString(tr("%1 items; Right click for more option; Double click for device details")).arg(dialog->ui->tableTreeWidget->topLevelItemCount()));
+}
+
+void BluetoothDevicesDialog::indexItem(QTreeWidgetItem *item)
+{
+    QString bd_addr = item->text(column_number_bd_addr);
+
+    if (!bd_addr.isEmpty() && !bd_addr_items_.contains(bd_addr))
+        bd_addr_items_.insert(bd_addr, item);
+
+    if (!item->text(column_number_is_local_adapter).isEmpty()) {
+        bluetooth_item_data_t *item_data = VariantPointer<bluetooth_item_data_t>::asPtr(item->data(0, Qt::UserRole));
+        QPair<guint32, guint32> adapter(item_data->interface_id, item_data->adapter_id);
+
+        if (!local_adapter_items_.contains(adapter))
+            local_adapter_items_.insert(adapter, item);
+    }
 }
 
 tap_packet_status BluetoothDevicesDialog::tapPacket(void *tapinfo_ptr, packet_info *pinfo, epan_dissect_t *, const void *data)
@@ -306,26 +357,16 @@ tap_packet_status BluetoothDevicesDialog::tapPacket(void *tapinfo_ptr, packet_in
     }
 
     if (dialog->ui->showInformationStepsCheckBox->checkState() != Qt::Checked) {
-        QTreeWidgetItemIterator i_item(dialog->ui->tableTreeWidget);
-
-        while (*i_item) {
-            QTreeWidgetItem *current_item = static_cast<QTreeWidgetItem*>(*i_item);
-            bluetooth_item_data_t *item_data = VariantPointer<bluetooth_item_data_t>::asPtr(current_item->data(0, Qt::UserRole));
-
-            if ((tap_device->has_bd_addr && current_item->text(column_number_bd_addr) == bd_addr) ||
-                    (tap_device->is_local &&
-                    item_data->interface_id == tap_device->interface_id &&
-                    item_data->adapter_id == tap_device->adapter_id &&
-                    !current_item->text(column_number_is_local_adapter).isEmpty())) {
-                item = current_item;
-                break;
-            }
-            ++i_item;
-        }
+        if (tap_device->has_bd_addr)
+            item = dialog->bd_addr_items_.value(bd_addr, NULL);
+        if (!item && tap_device->is_local)
+            item = dialog->local_adapter_items_.value(QPair<guint32, guint32>(tap_device->interface_id, tap_device->adapter_id), NULL);
     }
 
     if (!item) {
-        item = new QTreeWidgetItem(dialog->ui->tableTreeWidget);
+        // Added to the table by tapDraw
+        item = new QTreeWidgetItem();
+        dialog->pending_items_ << item;
         item->setText(column_number_bd_addr, bd_addr);
         item->setText(column_number_bd_addr_oui, bd_addr_oui);
         if (tap_device->is_local) {
@@ -364,11 +405,7 @@ tap_packet_status BluetoothDevicesDialog::tapPacket(void *tapinfo_ptr, packet_in
         item->setText(column_number_manufacturer,   val_to_str_ext_const(tap_device->data.remote_version.manufacturer, &bluetooth_company_id_vals_ext, "Unknown 0x%04x"));
     }
 
-    for (int i = 0; i < dialog->ui->tableTreeWidget->columnCount(); i++) {
-        dialog->ui->tableTreeWidget->resizeColumnToContents(i);
-    }
-
-    dialog->ui->hintLabel->setText(QString(tr("%1 items; Right click for more option; Double click for device details")).arg(dialog->ui->tableTreeWidget->topLevelItemCount()));
+    dialog->indexItem(item);
 
     return TAP_PACKET_REDRAW;
 }
@@ -20,7 +20,10 @@
 
 #include "epan/tap.h"
 
+#include <QHash>
+#include <QList>
 #include <QMenu>
+#include <QPair>
 
 class QAbstractButton;
 class QPushButton;
@@ -29,6 +32,7 @@ class QTreeWidgetItem;
 typedef struct _bluetooth_devices_tapinfo_t {
     tap_reset_cb    tap_reset;
     tap_packet_cb   tap_packet;
+    tap_draw_cb     tap_draw;
     void           *ui;
 } bluetooth_devices_tapinfo_t;
 
@@ -64,8 +68,18 @@ private:
     bluetooth_devices_tapinfo_t   tapinfo_;
     QMenu        context_menu_;
 
+    // Rows by BD_ADDR and by (interface ID, adapter ID) of local adapters,
+    // so that tapped packets don't have to search the table.
+    QHash<QString, QTreeWidgetItem *> bd_addr_items_;
+    QHash<QPair<guint32, guint32>, QTreeWidgetItem *> local_adapter_items_;
+    // Rows created since the last draw, not yet in the table.
+    QList<QTreeWidgetItem *> pending_items_;
+
+    void indexItem(QTreeWidgetItem *item);
+
     static void     tapReset(void *tapinfo_ptr);
     static tap_packet_status tapPacket(void *tapinfo_ptr, packet_info *pinfo, epan_dissect_t *, const void *data);
+    static void     tapDraw(void *tapinfo_ptr);
 
 private slots:
     void captureFileClosing();
@@ -86,7 +86,10 @@ QString CaptureFile::no_capture_file_ = QObject::tr("[no capture file]");
 CaptureFile::CaptureFile(QObject *parent, capture_file *cap_file) :
     QObject(parent),
     cap_file_(cap_file),
-    file_state_(QString())
+    file_state_(QString()),
+    retapping_(false),
+    retap_pending_(false),
+    delayed_retap_queued_(false)
 {
 #ifdef HAVE_LIBPCAP
     capture_callback_add(captureCallback, (gpointer) this);
@@ -216,14 +219,44 @@ int CaptureFile::timestampPrecision()
 
 void CaptureFile::retapPackets()
 {
-    if (cap_file_) {
-        cf_retap_packets(cap_file_);
+    // Each pass retaps every registered listener, so requests can be
+    // coalesced. A queued delayed retap is covered by this one, and a
+    // request made while we're retapping (e.g. by a dialog opened while
+    // events were processed) only needs one more pass afterward.
+    delayed_retap_queued_ = false;
+    if (retapping_) {
+        retap_pending_ = true;
+        return;
     }
+    if (!cap_file_) {
+        return;
+    }
+
+    retapping_ = true;
+    do {
+        retap_pending_ = false;
+        if (cf_retap_packets(cap_file_) == CF_READ_ABORTED) {
+            retap_pending_ = false;
+        }
+    } while (retap_pending_);
+    retapping_ = false;
 }
 
 void CaptureFile::delayedRetapPackets()
 {
-    QTimer::singleShot(0, this, SLOT(retapPackets()));
+    if (delayed_retap_queued_) {
+        return;
+    }
+    delayed_retap_queued_ = true;
+    QTimer::singleShot(0, this, SLOT(runDelayedRetap()));
+}
+
+void CaptureFile::runDelayedRetap()
+{
+    // Another retap might have run since we were queued.
+    if (delayed_retap_queued_) {
+        retapPackets();
+    }
 }
 
 void CaptureFile::reload()
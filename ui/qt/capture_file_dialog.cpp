@@ -26,6 +26,7 @@
 #include "wsutil/utf8_entities.h"
 
 #include "ui/all_files_wildcard.h"
+#include "ui/capture_index.h"
 
 #include <QCheckBox>
 #include <QFileInfo>
@@ -50,6 +51,8 @@ CaptureFileDialog::CaptureFileDialog(QWidget *parent, capture_file *cf, QString
     display_filter_(display_filter),
 #if !defined(Q_OS_WIN)
     display_filter_edit_(NULL),
+    read_start_edit_(NULL),
+    read_stop_edit_(NULL),
     default_ft_(-1),
     save_bt_(NULL),
     help_topic_(TOPIC_ACTION_NONE)
@@ -327,6 +330,13 @@ int CaptureFileDialog::mergeType() {
     return merge_type_;
 }
 
+// The native dialog has no time range controls.
+bool CaptureFileDialog::readTimeRange(nstime_t *start, nstime_t *stop) {
+    nstime_set_unset(start);
+    nstime_set_unset(stop);
+    return true;
+}
+
 #else // ! Q_OS_WIN
 // Not Windows
 // We use the Qt dialogs here
@@ -621,6 +631,44 @@ void CaptureFileDialog::addDisplayFilterEdit() {
     last_row_++;
 }
 
+void CaptureFileDialog::addTimeRangeEdits() {
+    QGridLayout *fd_grid = qobject_cast<QGridLayout*>(layout());
+    QHBoxLayout *h_box = new QHBoxLayout();
+    QString tool_tip = tr("Read only the packets from the first time on and "
+                          "before the second one, in local time. Either may be empty. "
+                          "If the file was indexed with capindex, only the part "
+                          "around the range is read.");
+
+    fd_grid->addWidget(new QLabel(tr("Time range:")), last_row_, 0);
+
+    read_start_edit_ = new QLineEdit(this);
+    read_start_edit_->setPlaceholderText(tr("YYYY-MM-DD hh:mm:ss"));
+    read_start_edit_->setToolTip(tool_tip);
+    h_box->addWidget(read_start_edit_);
+    h_box->addWidget(new QLabel(UTF8_RIGHTWARDS_ARROW));
+    read_stop_edit_ = new QLineEdit(this);
+    read_stop_edit_->setPlaceholderText(tr("YYYY-MM-DD hh:mm:ss"));
+    read_stop_edit_->setToolTip(tool_tip);
+    h_box->addWidget(read_stop_edit_);
+    fd_grid->addLayout(h_box, last_row_, 1);
+    last_row_++;
+}
+
+bool CaptureFileDialog::readTimeRange(nstime_t *start, nstime_t *stop) {
+    QString start_text = read_start_edit_ ? read_start_edit_->text().trimmed() : QString();
+    QString stop_text = read_stop_edit_ ? read_stop_edit_->text().trimmed() : QString();
+
+    nstime_set_unset(start);
+    nstime_set_unset(stop);
+    if (!start_text.isEmpty() && !capture_index_parse_time(qUtf8Printable(start_text), start)) {
+        return false;
+    }
+    if (!stop_text.isEmpty() && !capture_index_parse_time(qUtf8Printable(stop_text), stop)) {
+        return false;
+    }
+    return true;
+}
+
 void CaptureFileDialog::addFormatTypeSelector(QVBoxLayout &v_box) {
     format_type_.addItem(tr("Automatically detect file type"));
     for (int i = 0; open_routines[i].name != NULL; i += 1) {
@@ -670,11 +718,13 @@ int CaptureFileDialog::open(QString &file_name, unsigned int &type) {
 
     addFormatTypeSelector(left_v_box_);
     addDisplayFilterEdit();
+    addTimeRangeEdits();
     addPreview(right_v_box_);
     addHelpButton(HELP_OPEN_DIALOG);
 
     // Grow the dialog to account for the extra widgets.
-    resize(width(), height() + left_v_box_.minimumSize().height() + display_filter_edit_->minimumSize().height());
+    resize(width(), height() + left_v_box_.minimumSize().height() + display_filter_edit_->minimumSize().height()
+           + read_start_edit_->minimumSize().height());
 
     display_filter_.clear();
 
@@ -898,8 +948,14 @@ void CaptureFileDialog::preview(const QString & path)
 
     // Packet count
     if(status == PREVIEW_TIMED_OUT) {
-        preview_size_.setText(tr("%1, timed out at %Ln data record(s)", "", stats.data_records)
-                              .arg(size_str));
+        guint32 estimate = estimate_data_records_for_preview(&stats, filesize);
+        if (estimate > stats.data_records) {
+            preview_size_.setText(tr("%1, timed out at %Ln data record(s), about %2 in total", "", stats.data_records)
+                                  .arg(size_str).arg(estimate));
+        } else {
+            preview_size_.setText(tr("%1, timed out at %Ln data record(s)", "", stats.data_records)
+                                  .arg(size_str));
+        }
     } else {
         preview_size_.setText(tr("%1, %Ln data record(s)", "", stats.data_records)
                               .arg(size_str));
@@ -30,6 +30,7 @@
 #include <QCheckBox>
 #include <QDialogButtonBox>
 #include <QComboBox>
+#include <QLineEdit>
 
 class CaptureFileDialog : public QFileDialog
 {
@@ -69,6 +70,9 @@ public:
     int mergeType();
     int selectedFileType();
     wtap_compression_type compressionType();
+    // The time range to read that was given in the open dialog. Either
+    // end may be unset. Returns false if a time isn't valid.
+    bool readTimeRange(nstime_t *start, nstime_t *stop);
 
 private:
     capture_file *cap_file_;
@@ -78,6 +82,7 @@ private:
     void addMergeControls(QVBoxLayout &v_box);
     void addFormatTypeSelector(QVBoxLayout &v_box);
     void addDisplayFilterEdit();
+    void addTimeRangeEdits();
     void addPreview(QVBoxLayout &v_box);
     QString fileExtensionType(int et, bool extension_globs = true);
     QString fileType(int ft, QStringList &suffixes);
@@ -87,6 +92,8 @@ private:
     QVBoxLayout right_v_box_;
 
     DisplayFilterEdit* display_filter_edit_;
+    QLineEdit *read_start_edit_;
+    QLineEdit *read_stop_edit_;
     int last_row_;
 
     QLabel preview_format_;
@@ -119,6 +119,9 @@ void CaptureInfoDialog::updateInfo()
             .arg(secs / 3600, 2, 10, QChar('0'))
             .arg(secs % 3600 / 60, 2, 10, QChar('0'))
             .arg(secs % 60, 2, 10, QChar('0'));
+    if (cap_info_->sampled) {
+        duration += tr(" (protocol counts estimated from a sample)");
+    }
     ui->infoLabel->setText(duration);
 
     ci_model_->updateInfo();
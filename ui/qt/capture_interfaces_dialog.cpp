@@ -902,12 +902,9 @@ bool CaptureInterfacesDialog::saveOptionsToPreferences()
                  break;
              }
          }
-         /* test if the settings are ok for a ringbuffer */
-         if (global_capture_opts.save_file == NULL) {
-             QMessageBox::warning(this, tr("Error"),
-                                      tr("Multiple files: No capture file name given. You must specify a filename if you want to use multiple files."));
-             return false;
-         } else if (!global_capture_opts.has_autostop_filesize &&
+         /* test if the settings are ok for a ringbuffer; without a file
+            name the files go to the temporary directory */
+         if (!global_capture_opts.has_autostop_filesize &&
                     !global_capture_opts.has_file_interval &&
                     !global_capture_opts.has_file_duration &&
                     !global_capture_opts.has_file_packets) {
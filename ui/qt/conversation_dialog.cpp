@@ -736,18 +736,11 @@ void ConversationTreeWidget::updateItems() {
         return;
     }
 
-    setSortingEnabled(false);
-
     QList<QTreeWidgetItem *>new_items;
     for (int i = topLevelItemCount(); i < (int) hash_.conv_array->len; i++) {
         ConversationTreeWidgetItem *ctwi = new ConversationTreeWidgetItem(hash_.conv_array, i, &resolve_names_);
         new_items << ctwi;
 
-        if (i == 0) {
-            min_rel_start_time_ = nstime_to_sec(&(ctwi->convItem()->start_time));
-            max_rel_stop_time_ = nstime_to_sec(&(ctwi->convItem()->stop_time));
-        }
-
         for (int col = 0; col < columnCount(); col++) {
             switch (col) {
             case CONV_COLUMN_SRC_ADDR:
@@ -759,25 +752,30 @@ void ConversationTreeWidget::updateItems() {
             }
         }
     }
-    addTopLevelItems(new_items);
 
-    for (int i = 0; i < topLevelItemCount(); i++) {
-        ConversationTreeWidgetItem *ctwi = dynamic_cast<ConversationTreeWidgetItem *>(topLevelItem(i));
-
-        if (ctwi) {
-            double item_rel_start = nstime_to_sec(&(ctwi->convItem()->start_time));
-            if (item_rel_start < min_rel_start_time_) {
-                min_rel_start_time_ = item_rel_start;
-            }
+    // Stop times of existing conversations move, so scan the table itself
+    // rather than going through every tree item.
+    for (guint i = 0; i < hash_.conv_array->len; i++) {
+        conv_item_t *conv_item = &g_array_index(hash_.conv_array, conv_item_t, i);
 
-            double item_rel_stop = nstime_to_sec(&(ctwi->convItem()->stop_time));
-            if (item_rel_stop > max_rel_stop_time_) {
-                max_rel_stop_time_ = item_rel_stop;
-            }
+        double item_rel_start = nstime_to_sec(&conv_item->start_time);
+        double item_rel_stop = nstime_to_sec(&conv_item->stop_time);
+        if (i == 0 || item_rel_start < min_rel_start_time_) {
+            min_rel_start_time_ = item_rel_start;
+        }
+        if (i == 0 || item_rel_stop > max_rel_stop_time_) {
+            max_rel_stop_time_ = item_rel_stop;
         }
     }
 
-    setSortingEnabled(true);
+    if (new_items.isEmpty()) {
+        // Items read their values from hash_, so repainting is enough.
+        viewport()->update();
+    } else {
+        setSortingEnabled(false);
+        addTopLevelItems(new_items);
+        setSortingEnabled(true);
+    }
 
     if (resize) {
         for (int col = 0; col < columnCount(); col++) {
@@ -16,72 +16,189 @@
 
 #include <epan/conversation.h>
 #include <epan/conversation_debug.h>
+#include <epan/wmem/wmem.h>
 
 #include <ui/qt/utils/qt_ui_utils.h>
 #include "wireshark_application.h"
 
-ConversationHashTablesDialog::ConversationHashTablesDialog(QWidget *parent) :
-    GeometryStateDialog(parent),
-    ui(new Ui::ConversationHashTablesDialog)
+#include <QAbstractItemModel>
+#include <QVector>
+
+// Lists the keys of the conversation hash tables. Keys are only formatted
+// when the view asks for them, so that tables with millions of
+// conversations open quickly. The dialog isn't modal and conversations
+// are freed when the file is closed or redissected, so the addresses and
+// ports are copied.
+class ConversationHashTablesModel : public QAbstractItemModel
 {
-    ui->setupUi(this);
-    if (parent) loadGeometry(parent->width() * 3 / 4, parent->height() * 3 / 4);
-    setAttribute(Qt::WA_DeleteOnClose, true);
-    setWindowTitle(wsApp->windowTitleString(tr("Conversation Hash Tables")));
+public:
+    ConversationHashTablesModel(QObject *parent) :
+        QAbstractItemModel(parent)
+    {}
 
-    QString html;
+    ~ConversationHashTablesModel()
+    {
+        for (int i = 0; i < tables_.size(); i++) {
+            QVector<ConversationKey> &keys = tables_[i].keys;
+            for (int j = 0; j < keys.size(); j++) {
+                free_address(&keys[j].addr1);
+                free_address(&keys[j].addr2);
+            }
+        }
+    }
 
-    html += "<h3>Conversation Hash Tables</h3>\n";
+    void addTable(const QString table_name, wmem_map_t *hash_table)
+    {
+        HashTable table;
+        table.name = table_name;
+        if (hash_table) {
+            table.keys.reserve(wmem_map_size(hash_table));
+            wmem_map_foreach(hash_table, collectKey, &table.keys);
+        }
+
+        beginInsertRows(QModelIndex(), tables_.size(), tables_.size());
+        tables_ << table;
+        endInsertRows();
+    }
 
-    html += hashTableToHtmlTable("conversation_hashtable_exact", get_conversation_hashtable_exact());
-    html += hashTableToHtmlTable("conversation_hashtable_no_addr2", get_conversation_hashtable_no_addr2());
-    html += hashTableToHtmlTable("conversation_hashtable_no_port2", get_conversation_hashtable_no_port2());
-    html += hashTableToHtmlTable("conversation_hashtable_no_addr2_or_port2", get_conversation_hashtable_no_addr2_or_port2());
+    QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const
+    {
+        if (!hasIndex(row, column, parent)) return QModelIndex();
 
-    ui->conversationTextEdit->setHtml(html);
-}
+        // Table rows have an internal ID of 0, key rows their table number + 1.
+        if (!parent.isValid()) return createIndex(row, column, quintptr(0));
+        return createIndex(row, column, quintptr(parent.row() + 1));
+    }
 
-ConversationHashTablesDialog::~ConversationHashTablesDialog()
-{
-    delete ui;
-}
+    QModelIndex parent(const QModelIndex &child) const
+    {
+        if (!child.isValid() || child.internalId() == 0) return QModelIndex();
+        return createIndex(int(child.internalId() - 1), 0, quintptr(0));
+    }
 
-static void
-populate_html_table(gpointer data, gpointer user_data)
-{
-    const conversation_key_t conv_key = (conversation_key_t)data;
-    QString* html_table = (QString*)user_data;
-    gchar* tmp = conversation_get_html_hash(conv_key);
+    int rowCount(const QModelIndex &parent = QModelIndex()) const
+    {
+        if (!parent.isValid()) return tables_.size();
+        if (parent.internalId() == 0 && parent.column() == 0) return tables_[parent.row()].keys.size();
+        return 0;
+    }
 
-    // XXX Add a column for the hash value.
-    (*html_table) += QString(tmp);
-    wmem_free(NULL, tmp);
-}
+    int columnCount(const QModelIndex & = QModelIndex()) const
+    {
+        return col_count_;
+    }
 
-const QString ConversationHashTablesDialog::hashTableToHtmlTable(const QString table_name, wmem_map_t *hash_table)
-{
-    wmem_list_t *conversation_keys = NULL;
-    guint num_keys = 0;
-    if (hash_table)
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const
     {
-        conversation_keys = wmem_map_get_keys(NULL, hash_table);
-        num_keys = wmem_list_count(conversation_keys);
+        if (!index.isValid() || role != Qt::DisplayRole) return QVariant();
+
+        if (index.internalId() == 0) {
+            if (index.column() != col_address1_) return QVariant();
+            const HashTable &table = tables_[index.row()];
+            return QObject::tr("%1, %2 entries").arg(table.name).arg(table.keys.size());
+        }
+
+        const ConversationKey &conv_key = tables_[int(index.internalId() - 1)].keys[index.row()];
+        switch (index.column()) {
+        case col_address1_:
+            return address_to_qstring(&conv_key.addr1);
+        case col_port1_:
+            return conv_key.port1;
+        case col_address2_:
+            return address_to_qstring(&conv_key.addr2);
+        case col_port2_:
+            return conv_key.port2;
+        default:
+            break;
+        }
+        return QVariant();
     }
 
-    QString html_table = QString("<p>%1, %2 entries</p>").arg(table_name).arg(num_keys);
-    if (num_keys > 0)
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const
     {
-        int one_em = fontMetrics().height();
-        html_table += QString("<table cellpadding=\"%1\">\n").arg(one_em / 4);
+        if (orientation != Qt::Horizontal || role != Qt::DisplayRole) return QVariant();
+
+        switch (section) {
+        case col_address1_:
+            return QObject::tr("Address 1");
+        case col_port1_:
+            return QObject::tr("Port 1");
+        case col_address2_:
+            return QObject::tr("Address 2");
+        case col_port2_:
+            return QObject::tr("Port 2");
+        default:
+            break;
+        }
+        return QVariant();
+    }
 
-        html_table += "<tr><th align=\"left\">Address 1</th><th align=\"left\">Port 1</th><th align=\"left\">Address 2</th><th align=\"left\">Port 2</th></tr>\n";
+private:
+    enum {
+        col_address1_,
+        col_port1_,
+        col_address2_,
+        col_port2_,
+        col_count_
+    };
+
+    // The address data is owned by the model and freed in its destructor.
+    struct ConversationKey {
+        address addr1;
+        guint32 port1;
+        address addr2;
+        guint32 port2;
+    };
+
+    struct HashTable {
+        QString name;
+        QVector<ConversationKey> keys;
+    };
+
+    QList<HashTable> tables_;
+
+    static void collectKey(gpointer key, gpointer, gpointer keys_ptr)
+    {
+        QVector<ConversationKey> *keys = (QVector<ConversationKey> *)keys_ptr;
+        const conversation_key_t conv_key = (conversation_key_t)key;
+        ConversationKey copy;
+
+        copy_address(&copy.addr1, conversation_key_addr1(conv_key));
+        copy.port1 = conversation_key_port1(conv_key);
+        copy_address(&copy.addr2, conversation_key_addr2(conv_key));
+        copy.port2 = conversation_key_port2(conv_key);
+        *keys << copy;
+    }
+};
 
-        wmem_list_foreach(conversation_keys, populate_html_table, (void*)&html_table);
-        html_table += "</table>\n";
+ConversationHashTablesDialog::ConversationHashTablesDialog(QWidget *parent) :
+    GeometryStateDialog(parent),
+    ui(new Ui::ConversationHashTablesDialog)
+{
+    ui->setupUi(this);
+    if (parent) loadGeometry(parent->width() * 3 / 4, parent->height() * 3 / 4);
+    setAttribute(Qt::WA_DeleteOnClose, true);
+    setWindowTitle(wsApp->windowTitleString(tr("Conversation Hash Tables")));
+
+    ConversationHashTablesModel *model = new ConversationHashTablesModel(this);
+
+    model->addTable("conversation_hashtable_exact", get_conversation_hashtable_exact());
+    model->addTable("conversation_hashtable_no_addr2", get_conversation_hashtable_no_addr2());
+    model->addTable("conversation_hashtable_no_port2", get_conversation_hashtable_no_port2());
+    model->addTable("conversation_hashtable_no_addr2_or_port2", get_conversation_hashtable_no_addr2_or_port2());
+
+    // Uniform row heights let the view lay out only the visible rows.
+    ui->conversationTreeView->setUniformRowHeights(true);
+    ui->conversationTreeView->setModel(model);
+    for (int row = 0; row < model->rowCount(); row++) {
+        ui->conversationTreeView->setFirstColumnSpanned(row, QModelIndex(), true);
     }
-    if (conversation_keys)
-        wmem_destroy_list(conversation_keys);
-    return html_table;
+    ui->conversationTreeView->expandAll();
+}
+
+ConversationHashTablesDialog::~ConversationHashTablesDialog()
+{
+    delete ui;
 }
 
 /*
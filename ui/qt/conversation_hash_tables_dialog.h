@@ -11,7 +11,6 @@
 #define CONVERSATION_HASH_TABLES_DIALOG_H
 
 #include "geometry_state_dialog.h"
-#include <epan/wmem/wmem.h>
 
 namespace Ui {
 class ConversationHashTablesDialog;
@@ -27,8 +26,6 @@ public:
 
 private:
     Ui::ConversationHashTablesDialog *ui;
-
-    const QString hashTableToHtmlTable(const QString table_name, wmem_map_t *hash_table);
 };
 
 #endif // CONVERSATION_HASH_TABLES_DIALOG_H
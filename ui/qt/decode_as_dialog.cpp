@@ -26,6 +26,7 @@
 #include <QComboBox>
 #include <QFont>
 #include <QFontMetrics>
+#include <QHash>
 #include <QLineEdit>
 #include <QUrl>
 
@@ -39,7 +40,8 @@ DecodeAsDialog::DecodeAsDialog(QWidget *parent, capture_file *cf, bool create_ne
     GeometryStateDialog(parent),
     ui(new Ui::DecodeAsDialog),
     model_(new DecodeAsModel(this, cf)),
-    delegate_(NULL)
+    delegate_(NULL),
+    only_default_changes_(true)
 {
     ui->setupUi(this);
     loadGeometry();
@@ -86,6 +88,8 @@ DecodeAsDialog::~DecodeAsDialog()
 void DecodeAsDialog::fillTable()
 {
     model_->fillTable();
+    // Rules deleted from the table must be taken into account too.
+    only_default_changes_ = model_->onlyDefaultChanges();
 
     resizeColumns();
 
@@ -174,10 +178,76 @@ void DecodeAsDialog::on_clearToolButton_clicked()
     model_->clearAll();
 }
 
+// A non-default dissector table entry, keyed by table, selector and handle.
+struct ChangedEntry {
+    QString table_name;
+    ftenum_t selector_type;
+    guint32 selector_uint;
+};
+typedef QHash<QString, ChangedEntry> ChangedEntryHash;
+
+static void gatherChangedEntry(const gchar *table_name, ftenum_t selector_type,
+                               gpointer key, gpointer value, gpointer user_data)
+{
+    ChangedEntryHash *entries = (ChangedEntryHash *)user_data;
+    ChangedEntry entry = { table_name, selector_type, 0 };
+    QString selector;
+
+    switch (selector_type) {
+    case FT_UINT8:
+    case FT_UINT16:
+    case FT_UINT24:
+    case FT_UINT32:
+        entry.selector_uint = GPOINTER_TO_UINT(key);
+        selector = QString::number(entry.selector_uint);
+        break;
+    case FT_STRING:
+    case FT_STRINGZ:
+    case FT_UINT_STRING:
+    case FT_STRINGZPAD:
+        selector = (const char *)key;
+        break;
+    default:
+        break;
+    }
+
+    dissector_handle_t handle = dtbl_entry_get_handle((dtbl_entry_t *)value);
+    entries->insert(QString("%1 %2 %3").arg(table_name).arg(selector).arg((quintptr)handle), entry);
+}
+
 void DecodeAsDialog::applyChanges()
 {
+    ChangedEntryHash before, after;
+    bool only_default_changes = only_default_changes_ && model_->onlyDefaultChanges();
+
+    dissector_all_tables_foreach_changed(gatherChangedEntry, &before);
     model_->applyChanges();
-    wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
+    dissector_all_tables_foreach_changed(gatherChangedEntry, &after);
+
+    // Entries that were added, removed or changed. If no packet looked up
+    // any of them, redissecting wouldn't change a thing. We can only tell
+    // for small uint tables such as tcp.port; anything else redissects.
+    if (!only_default_changes) {
+        wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
+        return;
+    }
+
+    ChangedEntryHash changed;
+    foreach (QString id, before.keys()) {
+        if (!after.contains(id)) changed.insert(id, before.value(id));
+    }
+    foreach (QString id, after.keys()) {
+        if (!before.contains(id)) changed.insert(id, after.value(id));
+    }
+
+    foreach (ChangedEntry entry, changed) {
+        QByteArray table_name = entry.table_name.toUtf8();
+        if ((entry.selector_type != FT_UINT8 && entry.selector_type != FT_UINT16)
+                || dissector_uint_pattern_consulted(table_name.constData(), entry.selector_uint)) {
+            wsApp->queueAppSignal(WiresharkApplication::PacketDissectionChanged);
+            return;
+        }
+    }
 }
 
 void DecodeAsDialog::on_buttonBox_clicked(QAbstractButton *button)
@@ -41,6 +41,7 @@ private:
 
     DecodeAsModel* model_;
     DecodeAsDelegate* delegate_;
+    bool only_default_changes_;
 
     void addRecord(bool copy_from_current = false);
     void applyChanges();
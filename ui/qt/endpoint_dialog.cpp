@@ -592,8 +592,6 @@ void EndpointTreeWidget::updateItems()
         return;
     }
 
-    setSortingEnabled(false);
-
     QList<QTreeWidgetItem *>new_items;
     for (int i = topLevelItemCount(); i < (int) hash_.conv_array->len; i++) {
         EndpointTreeWidgetItem *etwi = new EndpointTreeWidgetItem(hash_.conv_array, i, &resolve_names_);
@@ -615,8 +613,14 @@ void EndpointTreeWidget::updateItems()
         }
 #endif
     }
-    addTopLevelItems(new_items);
-    setSortingEnabled(true);
+    if (new_items.isEmpty()) {
+        // Items read their values from hash_, so repainting is enough.
+        viewport()->update();
+    } else {
+        setSortingEnabled(false);
+        addTopLevelItems(new_items);
+        setSortingEnabled(true);
+    }
 
     if (resize) {
         for (int col = 0; col < columnCount(); col++) {
@@ -10,6 +10,8 @@
 #include "follow_stream_dialog.h"
 #include <ui_follow_stream_dialog.h>
 
+#include <algorithm> // for std::upper_bound
+
 #include "main_window.h"
 #include "wireshark_application.h"
 
@@ -22,7 +24,6 @@
 #include "epan/epan_dissect.h"
 #include "epan/tap.h"
 
-#include "ui/alert_box.h"
 #include "ui/simple_dialog.h"
 #include <wsutil/utf8_entities.h>
 
@@ -44,7 +45,6 @@
 #include <QMessageBox>
 #include <QPrintDialog>
 #include <QPrinter>
-#include <QScrollBar>
 #include <QTextEdit>
 #include <QTextStream>
 
@@ -164,10 +164,7 @@ void FollowStreamDialog::fillHintLabel(int text_pos)
     int pkt = -1;
 
     if (text_pos >= 0) {
-        QMap<int, guint32>::iterator it = text_pos_to_packet_.upperBound(text_pos);
-        if (it != text_pos_to_packet_.end()) {
-            pkt = it.value();
-        }
+        pkt = packetForTextPos(text_pos);
     }
 
     if (pkt > 0) {
@@ -199,10 +196,7 @@ void FollowStreamDialog::goToPacketForTextPos(int text_pos)
     }
 
     if (text_pos >= 0) {
-        QMap<int, guint32>::iterator it = text_pos_to_packet_.upperBound(text_pos);
-        if (it != text_pos_to_packet_.end()) {
-            pkt = it.value();
-        }
+        pkt = packetForTextPos(text_pos);
     }
 
     if (pkt > 0) {
@@ -210,6 +204,16 @@ void FollowStreamDialog::goToPacketForTextPos(int text_pos)
     }
 }
 
+// Returns the packet containing the text at text_pos, or 0 if not found.
+guint32 FollowStreamDialog::packetForTextPos(int text_pos) const
+{
+    QVector<int>::const_iterator it = std::upper_bound(text_pos_ends_.constBegin(), text_pos_ends_.constEnd(), text_pos);
+    if (it == text_pos_ends_.constEnd()) {
+        return 0;
+    }
+    return text_pos_packets_.at(int(it - text_pos_ends_.constBegin()));
+}
+
 void FollowStreamDialog::updateWidgets(bool follow_in_progress)
 {
     bool enable = !follow_in_progress;
@@ -274,20 +278,50 @@ void FollowStreamDialog::saveAs()
 
     QFile file(file_name);
     if (!file.open(QIODevice::WriteOnly)) {
-        open_failure_alert_box(file_name.toUtf8().constData(), errno, TRUE);
+        QMessageBox::warning(this, tr("Save Failed"),
+                             tr("The file \"%1\" could not be created: %2.")
+                             .arg(file_name, file.errorString()));
         return;
     }
 
-    // Unconditionally save data as UTF-8 (even if data is decoded as UTF-16).
-    QByteArray bytes = ui->teStreamContent->toPlainText().toUtf8();
+    bool saved;
     if (show_type_ == SHOW_RAW) {
-        // The "Raw" format is currently displayed as hex data and needs to be
-        // converted to binary data.
-        bytes = QByteArray::fromHex(bytes);
+        // The "Raw" format is displayed as hex data. Write the payload
+        // records directly instead of converting the (possibly truncated)
+        // document back to binary.
+        saved = saveRawStream(file);
+    } else {
+        // Unconditionally save data as UTF-8 (even if data is decoded as UTF-16).
+        QByteArray bytes = ui->teStreamContent->toPlainText().toUtf8();
+
+        QDataStream out(&file);
+        saved = out.writeRawData(bytes.constData(), bytes.size()) == bytes.size();
+    }
+
+    if (!saved) {
+        QMessageBox::warning(this, tr("Save Failed"),
+                             tr("An error occurred while writing to the file \"%1\": %2.")
+                             .arg(file_name, file.errorString()));
     }
+}
+
+// Write the shown direction(s) of the payload to file one record at a time,
+// in the same order as readFollowStream.
+bool FollowStreamDialog::saveRawStream(QFile &file)
+{
+    for (GList *cur = g_list_last(follow_info_.payload); cur; cur = g_list_previous(cur)) {
+        follow_record_t *follow_record = (follow_record_t *)cur->data;
+
+        if ((follow_record->is_server && follow_info_.show_stream == FROM_CLIENT) ||
+                (!follow_record->is_server && follow_info_.show_stream == FROM_SERVER)) {
+            continue;
+        }
 
-    QDataStream out(&file);
-    out.writeRawData(bytes.constData(), bytes.size());
+        if (file.write((const char *) follow_record->data->data, follow_record->data->len) != (qint64) follow_record->data->len) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void FollowStreamDialog::helpButton()
@@ -396,7 +430,8 @@ void FollowStreamDialog::resetStream()
     follow_record_t *follow_record;
 
     filter_out_filter_.clear();
-    text_pos_to_packet_.clear();
+    text_pos_ends_.clear();
+    text_pos_packets_.clear();
     if (!data_out_filename_.isEmpty()) {
         ws_unlink(data_out_filename_.toUtf8().constData());
     }
@@ -438,7 +473,8 @@ FollowStreamDialog::readStream()
 {
 
     ui->teStreamContent->clear();
-    text_pos_to_packet_.clear();
+    text_pos_ends_.clear();
+    text_pos_packets_.clear();
 
     truncated_ = false;
     frs_return_t ret;
@@ -450,6 +486,10 @@ FollowStreamDialog::readStream()
     last_packet_ = 0;
     turns_ = 0;
 
+    // addText appends through its own cursor, so there's no need to repaint
+    // the view for each chunk.
+    ui->teStreamContent->setUpdatesEnabled(false);
+
     switch(follow_type_) {
 
     case FOLLOW_TCP :
@@ -465,6 +505,7 @@ FollowStreamDialog::readStream()
         break;
     }
 
+    ui->teStreamContent->setUpdatesEnabled(true);
     ui->teStreamContent->moveCursor(QTextCursor::Start);
 
     return ret;
@@ -489,10 +530,11 @@ void FollowStreamDialog::addText(QString text, gboolean is_from_server, guint32
         truncated_ = true;
     }
 
-    setUpdatesEnabled(false);
-    int cur_pos = ui->teStreamContent->verticalScrollBar()->value();
-    ui->teStreamContent->moveCursor(QTextCursor::End);
-    QTextCharFormat tcf = ui->teStreamContent->currentCharFormat();
+    // Append with a cursor of our own so that we don't move the view's
+    // cursor or scroll position for every chunk.
+    QTextCursor cursor(ui->teStreamContent->document());
+    cursor.movePosition(QTextCursor::End);
+    QTextCharFormat tcf = cursor.charFormat();
     if (is_from_server) {
         tcf.setForeground(ColorUtils::fromColorT(prefs.st_server_fg));
         tcf.setBackground(ColorUtils::fromColorT(prefs.st_server_bg));
@@ -500,21 +542,24 @@ void FollowStreamDialog::addText(QString text, gboolean is_from_server, guint32
         tcf.setForeground(ColorUtils::fromColorT(prefs.st_client_fg));
         tcf.setBackground(ColorUtils::fromColorT(prefs.st_client_bg));
     }
-    ui->teStreamContent->setCurrentCharFormat(tcf);
 
-    ui->teStreamContent->insertPlainText(text);
-    text_pos_to_packet_[ui->teStreamContent->textCursor().anchor()] = packet_num;
+    cursor.insertText(text, tcf);
+
+    // Chunk end positions only grow, so keep them in sorted vectors.
+    int text_end = cursor.position();
+    if (!text_pos_ends_.isEmpty() && text_pos_ends_.last() == text_end) {
+        text_pos_packets_.last() = packet_num;
+    } else {
+        text_pos_ends_.append(text_end);
+        text_pos_packets_.append(packet_num);
+    }
 
     if (truncated_) {
-        tcf = ui->teStreamContent->currentCharFormat();
         tcf.setBackground(palette().window().color());
         tcf.setForeground(palette().windowText().color());
-        ui->teStreamContent->insertPlainText("\n" + tr("[Stream output truncated]"));
+        cursor.insertText("\n" + tr("[Stream output truncated]"), tcf);
         ui->teStreamContent->moveCursor(QTextCursor::End);
-    } else {
-        ui->teStreamContent->verticalScrollBar()->setValue(cur_pos);
     }
-    setUpdatesEnabled(true);
 }
 
 // The following keyboard shortcuts should work (although
@@ -27,8 +27,8 @@
 #include "wireshark_dialog.h"
 
 #include <QFile>
-#include <QMap>
 #include <QPushButton>
+#include <QVector>
 
 namespace Ui {
 class FollowStreamDialog;
@@ -90,7 +90,9 @@ private:
     frs_return_t readSslStream();
 
     void followStream();
+    bool saveRawStream(QFile &file);
     void addText(QString text, gboolean is_from_server, guint32 packet_num);
+    guint32 packetForTextPos(int text_pos) const;
 
     Ui::FollowStreamDialog  *ui;
 
@@ -117,7 +119,9 @@ private:
     guint32                 last_packet_;
     gboolean                last_from_server_;
     int                     turns_;
-    QMap<int,guint32>       text_pos_to_packet_;
+    // End position of each chunk of text and the packet it came from.
+    QVector<int>            text_pos_ends_;
+    QVector<guint32>        text_pos_packets_;
 
     bool                    use_regex_find_;
 
@@ -14,6 +14,7 @@
 #include <QRegExp>
 #include <QTextCharFormat>
 #include <QTextCursor>
+#include <QTimer>
 
 #include <ui/qt/utils/qt_ui_utils.h>
 #include "wireshark_application.h"
@@ -25,11 +26,17 @@
 
 static QHash<QObject *, funnel_bt_t*> text_button_to_funnel_button_;
 
+// Text appended by taps is collected and added to the widget at most this
+// often (in milliseconds), so that a tap that appends a line per packet
+// doesn't relayout the document for every packet.
+const int append_flush_interval_ = 100;
+
 FunnelTextDialog::FunnelTextDialog(const QString &title) :
     GeometryStateDialog(NULL),
     ui(new Ui::FunnelTextDialog),
     close_cb_(NULL),
-    close_cb_data_(NULL)
+    close_cb_data_(NULL),
+    append_timer_(new QTimer(this))
 {
     ui->setupUi(this);
     if (!title.isEmpty()) {
@@ -41,7 +48,10 @@ FunnelTextDialog::FunnelTextDialog(const QString &title) :
 
     ui->textEdit->setFont(wsApp->monospaceFont());
     ui->textEdit->setReadOnly(true);
-    ui->textEdit->setAcceptRichText(false);
+
+    append_timer_->setSingleShot(true);
+    append_timer_->setInterval(append_flush_interval_);
+    connect(append_timer_, SIGNAL(timeout()), this, SLOT(flushAppendedText()));
 }
 
 FunnelTextDialog::~FunnelTextDialog()
@@ -70,28 +80,36 @@ struct _funnel_text_window_t *FunnelTextDialog::textWindowNew(const QString titl
 
 void FunnelTextDialog::setText(const QString text)
 {
-    ui->textEdit->setText(text);
+    pending_text_.clear();
+    append_timer_->stop();
+    ui->textEdit->setPlainText(text);
 }
 
 void FunnelTextDialog::appendText(const QString text)
 {
-    ui->textEdit->moveCursor(QTextCursor::End);
-    ui->textEdit->insertPlainText(text);
+    pending_text_.append(text);
+    if (!append_timer_->isActive()) {
+        append_timer_->start();
+    }
 }
 
 void FunnelTextDialog::prependText(const QString text)
 {
+    flushAppendedText();
     ui->textEdit->moveCursor(QTextCursor::Start);
     ui->textEdit->insertPlainText(text);
 }
 
 void FunnelTextDialog::clearText()
 {
+    pending_text_.clear();
+    append_timer_->stop();
     ui->textEdit->clear();
 }
 
 const char *FunnelTextDialog::getText()
 {
+    flushAppendedText();
     return qstring_strdup(ui->textEdit->toPlainText());
 }
 
@@ -124,8 +142,20 @@ void FunnelTextDialog::buttonClicked()
     }
 }
 
+void FunnelTextDialog::flushAppendedText()
+{
+    append_timer_->stop();
+    if (pending_text_.isEmpty()) return;
+
+    ui->textEdit->moveCursor(QTextCursor::End);
+    ui->textEdit->insertPlainText(pending_text_);
+    pending_text_.clear();
+}
+
 void FunnelTextDialog::on_findLineEdit_textChanged(const QString &pattern)
 {
+    flushAppendedText();
+
     QRegExp re(pattern, Qt::CaseInsensitive);
     QTextCharFormat plain_fmt, highlight_fmt;
     highlight_fmt.setBackground(Qt::yellow);
@@ -141,8 +171,9 @@ void FunnelTextDialog::on_findLineEdit_textChanged(const QString &pattern)
 
     // Apply new highlighting
     if (!pattern.isEmpty()) {
+        const QString text = ui->textEdit->toPlainText();
         int match_pos = 0;
-        while ((match_pos = re.indexIn(ui->textEdit->toPlainText(), match_pos)) > -1) {
+        while ((match_pos = re.indexIn(text, match_pos)) > -1) {
             csr.setPosition(match_pos, QTextCursor::MoveAnchor);
             csr.setPosition(match_pos + re.matchedLength(), QTextCursor::KeepAnchor);
             csr.setCharFormat(highlight_fmt);
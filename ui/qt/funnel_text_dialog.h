@@ -17,6 +17,8 @@
 
 #include <QDialog>
 
+class QTimer;
+
 namespace Ui {
 class FunnelTextDialog;
 }
@@ -49,6 +51,7 @@ public:
 
 private slots:
     void buttonClicked();
+    void flushAppendedText();
     void on_findLineEdit_textChanged(const QString &pattern);
 
 private:
@@ -57,6 +60,8 @@ private:
     struct _funnel_text_window_t funnel_text_window_;
     text_win_close_cb_t close_cb_;
     void *close_cb_data_;
+    QTimer *append_timer_;
+    QString pending_text_;
 };
 
 extern "C" {
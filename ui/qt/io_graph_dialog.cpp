@@ -35,6 +35,7 @@
 #include <QClipboard>
 #include <QFontMetrics>
 #include <QFrame>
+#include <QHash>
 #include <QHBoxLayout>
 #include <QLineEdit>
 #include <QMessageBox>
@@ -372,6 +373,7 @@ IOGraphDialog::IOGraphDialog(QWidget &parent, CaptureFile &cf) :
 
     iop->setMouseTracking(true);
     iop->setEnabled(true);
+    set_plot_rendering_hints(iop);
 
     QCPPlotTitle *title = new QCPPlotTitle(iop);
     iop->plotLayout()->insertRow(0);
@@ -606,6 +608,32 @@ void IOGraphDialog::scheduleRetap(bool now)
     if (now) updateStatistics();
 }
 
+// Let graphs that tap the same thing share a single tap listener so that
+// each packet is filtered and its field extracted only once per group.
+void IOGraphDialog::groupGraphTaps()
+{
+    QHash<QString, IOGraph *> leaders;
+
+    foreach (IOGraph *iog, ioGraphs_) {
+        if (iog) {
+            iog->setTapLeader(NULL);
+        }
+    }
+
+    foreach (IOGraph *iog, ioGraphs_) {
+        if (!iog) continue;
+        QString key = iog->tapGroupKey();
+        if (key.isEmpty()) continue;
+
+        IOGraph *leader = leaders.value(key, NULL);
+        if (leader) {
+            iog->setTapLeader(leader);
+        } else {
+            leaders.insert(key, iog);
+        }
+    }
+}
+
 void IOGraphDialog::reloadFields()
 {
     emit reloadValueUnitFields();
@@ -1099,6 +1127,7 @@ void IOGraphDialog::updateStatistics()
 
     if (need_retap_ && !file_closed_) {
         need_retap_ = false;
+        groupGraphTaps();
         cap_file_.retapPackets();
         // The user might have closed the window while tapping, which means
         // we might no longer exist.
@@ -1185,8 +1214,7 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
         for (int row = 0; row < uat_model_->rowCount(); row++) {
             IOGraph *iog = ioGraphs_.value(row, NULL);
             if (iog) {
-                iog->setInterval(interval);
-                if (iog->visible()) {
+                if (iog->setInterval(interval) && iog->visible()) {
                     need_retap = true;
                 }
             }
@@ -1195,6 +1223,8 @@ void IOGraphDialog::on_intervalComboBox_currentIndexChanged(int)
 
     if (need_retap) {
         scheduleRetap(true);
+    } else {
+        scheduleRecalc(true);
     }
 
     updateLegend();
@@ -1540,16 +1570,25 @@ IOGraph::IOGraph(QCustomPlot *parent) :
     bars_(NULL),
     val_units_(IOG_ITEM_UNIT_FIRST),
     hf_index_(-1),
-    cur_idx_(-1)
+    interval_(0),
+    tap_interval_(0),
+    cur_idx_(-1),
+    merged_cur_idx_(-1),
+    tap_leader_(NULL)
 {
     Q_ASSERT(parent_ != NULL);
     graph_ = parent_->addGraph(parent_->xAxis, parent_->yAxis);
     Q_ASSERT(graph_ != NULL);
 
+    registerTap();
+}
+
+void IOGraph::registerTap()
+{
     GString *error_string;
     error_string = register_tap_listener("frame",
                           this,
-                          "",
+                          full_filter_.toUtf8().constData(),
                           TL_REQUIRES_PROTO_TREE,
                           tapReset,
                           tapPacket,
@@ -1564,7 +1603,14 @@ IOGraph::IOGraph(QCustomPlot *parent) :
 }
 
 IOGraph::~IOGraph() {
-    remove_tap_listener(this);
+    foreach (IOGraph *follower, tap_followers_) {
+        follower->setTapLeader(NULL);
+    }
+    if (tap_leader_) {
+        tap_leader_->tap_followers_.removeOne(this);
+    } else {
+        remove_tap_listener(this);
+    }
     if (graph_) {
         parent_->removeGraph(graph_);
     }
@@ -1582,6 +1628,10 @@ void IOGraph::setFilter(const QString &filter)
 
     config_err_.clear();
 
+    // We're about to change what we tap, so stop sharing until the
+    // dialog groups the graphs again.
+    setTapLeader(NULL);
+
     // Make sure we have a good display filter
     if (!full_filter.isEmpty()) {
         dfilter_t *dfilter;
@@ -1621,6 +1671,7 @@ void IOGraph::setFilter(const QString &filter)
         g_string_free(error_string, TRUE);
         return;
     } else {
+        full_filter_ = full_filter;
         if (filter_.compare(filter) && visible_) {
             emit requestRetap();
         }
@@ -1812,13 +1863,14 @@ double IOGraph::startOffset()
 int IOGraph::packetFromTime(double ts)
 {
     int idx = ts * 1000 / interval_;
-    if (idx >= 0 && idx < (int) cur_idx_) {
+    const io_graph_item_t *item = idx >= 0 && idx < maxInterval() ? viewItem(idx) : NULL;
+    if (item) {
         switch (val_units_) {
         case IOG_ITEM_UNIT_CALC_MAX:
         case IOG_ITEM_UNIT_CALC_MIN:
-            return items_[idx].extreme_frame_in_invl;
+            return item->extreme_frame_in_invl;
         default:
-            return items_[idx].last_frame_in_invl;
+            return item->last_frame_in_invl;
         }
     }
     return -1;
@@ -1827,7 +1879,10 @@ int IOGraph::packetFromTime(double ts)
 void IOGraph::clearAllData()
 {
     cur_idx_ = -1;
-    reset_io_graph_items(items_, max_io_items_);
+    items_.clear();
+    merged_cur_idx_ = -1;
+    merged_items_.clear();
+    tap_interval_ = interval_;
     if (graph_) {
         graph_->clearData();
     }
@@ -1845,6 +1900,9 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
     double mavg_cumulated = 0;
     QCPAxis *x_axis = NULL;
 
+    mergeItems();
+    int max_idx = maxInterval();
+
     if (graph_) {
         graph_->clearData();
         x_axis = graph_->keyAxis();
@@ -1854,7 +1912,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         x_axis = bars_->keyAxis();
     }
 
-    if (moving_avg_period_ > 0 && cur_idx_ >= 0) {
+    if (moving_avg_period_ > 0 && max_idx >= 0) {
         /* "Warm-up phase" - calculate average on some data not displayed;
          * just to make sure average on leftmost and rightmost displayed
          * values is as reliable as possible
@@ -1870,7 +1928,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         mavg_in_average_count++;
         for (warmup_interval = interval_;
             ((warmup_interval < (0 + (moving_avg_period_ / 2) * (guint64)interval_)) &&
-             (warmup_interval <= (cur_idx_ * (guint64)interval_)));
+             (warmup_interval <= (max_idx * (guint64)interval_)));
              warmup_interval += interval_) {
 
             mavg_cumulated += getItemValue((int)warmup_interval / interval_, cap_file);
@@ -1880,7 +1938,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
         mavg_to_add = (unsigned int)warmup_interval;
     }
 
-    for (int i = 0; i <= cur_idx_; i++) {
+    for (int i = 0; i <= max_idx; i++) {
         double ts = (double) i * interval_ / 1000;
         if (x_axis && x_axis->tickLabelType() == QCPAxis::ltDateTime) {
             ts += start_time_;
@@ -1896,7 +1954,7 @@ void IOGraph::recalcGraphData(capture_file *cap_file, bool enable_scaling)
                     mavg_cumulated -= getItemValue((int)mavg_to_remove / interval_, cap_file);
                     mavg_to_remove += interval_;
                 }
-                if (mavg_to_add <= (unsigned int) cur_idx_ * interval_) {
+                if (mavg_to_add <= (unsigned int) max_idx * interval_) {
                     mavg_in_average_count++;
                     mavg_cumulated += getItemValue((int)mavg_to_add / interval_, cap_file);
                     mavg_to_add += interval_;
@@ -2025,17 +2083,152 @@ void IOGraph::reloadValueUnitField()
     }
 }
 
-void IOGraph::setInterval(int interval)
+// Returns true if the graph has to be retapped for the new interval.
+// Intervals that are a multiple of the tapped one are merged from the
+// items we already have in recalcGraphData.
+bool IOGraph::setInterval(int interval)
 {
     interval_ = interval;
+    return tap_interval_ <= 0 || interval_ % tap_interval_ != 0;
 }
 
 // Get the value at the given interval (idx) for the current value unit.
 double IOGraph::getItemValue(int idx, const capture_file *cap_file) const
 {
-    g_assert(idx < max_io_items_);
+    const io_graph_item_t *item = viewItem(idx);
+
+    if (!item) {
+        // Nothing was tapped here, and empty items are always zero.
+        return 0.0;
+    }
 
-    return get_io_graph_item(items_, val_units_, idx, hf_index_, cap_file, interval_, cur_idx_);
+    return get_io_graph_item_value(item, val_units_, idx, hf_index_, cap_file, interval_, maxInterval());
+}
+
+// Rebuild merged_items_ from items_ if interval_ is coarser than the
+// interval we tapped at.
+void IOGraph::mergeItems()
+{
+    if (interval_ == tap_interval_ || tap_interval_ <= 0 || interval_ % tap_interval_ != 0) {
+        merged_cur_idx_ = -1;
+        merged_items_.clear();
+        return;
+    }
+
+    int factor = interval_ / tap_interval_;
+    merged_cur_idx_ = cur_idx_ < 0 ? -1 : cur_idx_ / factor;
+    merged_items_.clear();
+    // Only the allocated pages can have anything in them.
+    foreach (int page, items_.pageIndexes()) {
+        int first = page * IOGraphItems::io_item_page_size_;
+        for (int i = first; i < first + IOGraphItems::io_item_page_size_ && i <= cur_idx_; i++) {
+            const io_graph_item_t *item = items_.item(i);
+            io_graph_item_t *merged = merged_items_.insert(i / factor);
+            if (merged) {
+                merge_io_graph_item(merged, item, val_units_);
+            }
+        }
+    }
+}
+
+// IOGraphItems
+
+const io_graph_item_t *IOGraphItems::item(int idx) const
+{
+    if (idx < 0) return NULL;
+    io_graph_item_t *page = pages_.value(idx / io_item_page_size_, NULL);
+    return page ? &page[idx % io_item_page_size_] : NULL;
+}
+
+io_graph_item_t *IOGraphItems::insert(int idx)
+{
+    if (idx < 0) return NULL;
+    int page_idx = idx / io_item_page_size_;
+    io_graph_item_t *page = pages_.value(page_idx, NULL);
+    if (!page) {
+        if (populated_ + io_item_page_size_ > max_io_items_) {
+            return NULL;
+        }
+        page = addPage(page_idx);
+    }
+    return &page[idx % io_item_page_size_];
+}
+
+io_graph_item_t *IOGraphItems::addPage(int page_idx)
+{
+    io_graph_item_t *page = g_new(io_graph_item_t, io_item_page_size_);
+    reset_io_graph_items(page, io_item_page_size_);
+    pages_.insert(page_idx, page);
+    populated_ += io_item_page_size_;
+    return page;
+}
+
+void IOGraphItems::clear()
+{
+    foreach (io_graph_item_t *page, pages_) {
+        g_free(page);
+    }
+    pages_.clear();
+    populated_ = 0;
+}
+
+io_graph_item_t *IOGraphItems::lookup(void *items, int idx)
+{
+    // LOAD calculations only look up earlier intervals of a page that
+    // insert() already allocated, or of pages before it. Going over
+    // max_io_items_ there would lose the update, so it isn't checked.
+    IOGraphItems *iogi = static_cast<IOGraphItems *>(items);
+    io_graph_item_t *item = iogi->insert(idx);
+    if (!item) {
+        item = &iogi->addPage(idx / io_item_page_size_)[idx % io_item_page_size_];
+    }
+    return item;
+}
+
+// Graphs that would end up with identical items_ after a retap return the
+// same key. update_io_graph_item computes every statistic regardless of
+// the value unit except for the min/max frame and LOAD, which also
+// updates earlier intervals, so those are kept apart.
+QString IOGraph::tapGroupKey() const
+{
+    if (!config_err_.isEmpty() || val_units_ == IOG_ITEM_UNIT_CALC_LOAD) {
+        return QString();
+    }
+
+    int unit_class = IOG_ITEM_UNIT_PACKETS;
+    int hf_index = -1;
+    if (val_units_ >= IOG_ITEM_UNIT_CALC_SUM) {
+        unit_class = IOG_ITEM_UNIT_CALC_SUM;
+        if (val_units_ == IOG_ITEM_UNIT_CALC_MAX || val_units_ == IOG_ITEM_UNIT_CALC_MIN) {
+            unit_class = val_units_;
+        }
+        hf_index = hf_index_;
+    }
+
+    return QString("%1 %2 %3 %4").arg(interval_).arg(unit_class).arg(hf_index).arg(full_filter_);
+}
+
+// Share leader's tap listener instead of registering our own. Pass NULL to
+// tap on our own again.
+void IOGraph::setTapLeader(IOGraph *leader)
+{
+    if (leader == tap_leader_ || leader == this) return;
+
+    if (tap_leader_) {
+        tap_leader_->tap_followers_.removeOne(this);
+    } else {
+        foreach (IOGraph *follower, tap_followers_) {
+            follower->setTapLeader(NULL);
+        }
+        remove_tap_listener(this);
+    }
+
+    tap_leader_ = leader;
+    if (tap_leader_) {
+        tap_leader_->tap_followers_.append(this);
+    } else {
+        registerTap();
+    }
 }
 
 // "tap_reset" callback for register_tap_listener
@@ -2046,6 +2239,9 @@ void IOGraph::tapReset(void *iog_ptr)
 
 //    qDebug() << "=tapReset" << iog->name_;
     iog->clearAllData();
+    foreach (IOGraph *follower, iog->tap_followers_) {
+        follower->clearAllData();
+    }
 }
 
 // "tap_packet" callback for register_tap_listener
@@ -2056,12 +2252,11 @@ tap_packet_status IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dis
         return TAP_PACKET_DONT_REDRAW;
     }
 
-    int idx = get_io_graph_index(pinfo, iog->interval_);
+    int idx = get_io_graph_index(pinfo, iog->tap_interval_);
     bool recalc = false;
 
     /* some sanity checks */
-    if ((idx < 0) || (idx >= max_io_items_)) {
-        iog->cur_idx_ = max_io_items_ - 1;
+    if (!iog->items_.insert(idx)) {
         return TAP_PACKET_DONT_REDRAW;
     }
 
@@ -2085,7 +2280,17 @@ tap_packet_status IOGraph::tapPacket(void *iog_ptr, packet_info *pinfo, epan_dis
         adv_edt = edt;
     }
 
-    if (!update_io_graph_item(iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->interval_)) {
+    bool updated = update_io_graph_item_in(IOGraphItems::lookup, &iog->items_, idx, pinfo, adv_edt, iog->hf_index_, iog->val_units_, iog->tap_interval_);
+
+    foreach (IOGraph *follower, iog->tap_followers_) {
+        io_graph_item_t *follower_item = follower->items_.insert(idx);
+        if (!follower_item) continue;
+        *follower_item = *iog->items_.item(idx);
+        follower->cur_idx_ = iog->cur_idx_;
+        follower->start_time_ = iog->start_time_;
+    }
+
+    if (!updated) {
         return TAP_PACKET_DONT_REDRAW;
     }
 
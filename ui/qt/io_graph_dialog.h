@@ -23,9 +23,11 @@
 #include <ui/qt/models/uat_model.h>
 #include <ui/qt/models/uat_delegate.h>
 
+#include <QHash>
 #include <QIcon>
 #include <QMenu>
 #include <QTextStream>
+#include <QVector>
 
 class QRubberBand;
 class QTimer;
@@ -35,8 +37,39 @@ class QCPGraph;
 class QCPItemTracer;
 class QCustomPlot;
 
-// GTK+ sets this to 100000 (NUM_IO_ITEMS)
-const int max_io_items_ = 250000;
+// GTK+ sets this to 100000 (NUM_IO_ITEMS). We used to allocate a fixed
+// array of 250000 items per graph. Items are now allocated a page at a
+// time as intervals are seen, and this limits the number of allocated
+// items, not the interval index.
+const int max_io_items_ = 10 * 1000 * 1000;
+
+// The items of a graph, in pages of io_item_page_size_ intervals that are
+// allocated when a packet first falls into them. A bogus timestamp far
+// from the rest only costs one page. Intervals without a page read as zero.
+class IOGraphItems {
+public:
+    IOGraphItems() : populated_(0) {}
+    ~IOGraphItems() { clear(); }
+
+    const io_graph_item_t *item(int idx) const;
+    // NULL if idx is negative or the page would exceed max_io_items_.
+    io_graph_item_t *insert(int idx);
+    void clear();
+    QList<int> pageIndexes() const { return pages_.keys(); }
+
+    // io_graph_item_lookup_func for update_io_graph_item_in.
+    static io_graph_item_t *lookup(void *items, int idx);
+
+    static const int io_item_page_size_ = 4096;
+
+private:
+    QHash<int, io_graph_item_t *> pages_;
+    int populated_;
+
+    io_graph_item_t *addPage(int page_idx);
+
+    Q_DISABLE_COPY(IOGraphItems)
+};
 
 // XXX - Move to its own file?
 class IOGraph : public QObject {
@@ -63,7 +96,7 @@ public:
     const QString valueUnitField() { return vu_field_; }
     void setValueUnitField(const QString &vu_field);
     unsigned int movingAveragePeriod() { return moving_avg_period_; }
-    void setInterval(int interval);
+    bool setInterval(int interval);
     bool addToLegend();
     bool removeFromLegend();
     QCPGraph *graph() { return graph_; }
@@ -71,10 +104,12 @@ public:
     double startOffset();
     int packetFromTime(double ts);
     double getItemValue(int idx, const capture_file *cap_file) const;
-    int maxInterval () const { return cur_idx_; }
+    int maxInterval () const { return interval_ == tap_interval_ ? cur_idx_ : merged_cur_idx_; }
     QString scaledValueUnit() const { return scaled_value_unit_; }
 
     void clearAllData();
+    QString tapGroupKey() const;
+    void setTapLeader(IOGraph *leader);
 
     unsigned int moving_avg_period_;
 
@@ -94,6 +129,7 @@ private:
     static tap_packet_status tapPacket(void *iog_ptr, packet_info *pinfo, epan_dissect_t *edt, const void *data);
     static void tapDraw(void *iog_ptr);
 
+    void registerTap();
     void calculateScaledValueUnit();
     template<class DataMap> double maxValueFromGraphData(const DataMap &map);
     template<class DataMap> void scaleGraphData(DataMap &map, int scalar);
@@ -105,18 +141,31 @@ private:
     QCPGraph *graph_;
     QCPBars *bars_;
     QString filter_;
+    QString full_filter_;
     QBrush color_;
     io_graph_item_unit_t val_units_;
     QString vu_field_;
     int hf_index_;
     int interval_;
+    int tap_interval_;
     double start_time_;
     QString scaled_value_unit_;
 
     // Cached data. We should be able to change the Y axis without retapping as
     // much as is feasible.
-    io_graph_item_t items_[max_io_items_];
+    IOGraphItems items_;
     int cur_idx_;
+    // items_ merged up to interval_ when it's a multiple of tap_interval_.
+    IOGraphItems merged_items_;
+    int merged_cur_idx_;
+
+    // Graphs that tap the same packets and values share a single tap
+    // listener. The leader fills in its followers' items.
+    IOGraph *tap_leader_;
+    QList<IOGraph *> tap_followers_;
+
+    void mergeItems();
+    const io_graph_item_t *viewItem(int idx) const { return interval_ == tap_interval_ ? items_.item(idx) : merged_items_.item(idx); }
 };
 
 namespace Ui {
@@ -198,6 +247,7 @@ private:
     bool saveCsv(const QString &file_name) const;
     IOGraph *currentActiveGraph() const;
     bool graphIsEnabled(int row) const;
+    void groupGraphTaps();
 
 private slots:
     void copyFromProfile(QAction *action);
@@ -18,6 +18,7 @@
 #include "wireshark_application.h"
 
 #include <QClipboard>
+#include <QHash>
 #include <QMenu>
 #include <QMessageBox>
 #include <QTreeWidget>
@@ -170,6 +171,7 @@ class LBMLBTRMSQNEntry : public QTreeWidgetItem
         LBMLBTRMSQNEntry(guint32 sqn);
         virtual ~LBMLBTRMSQNEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRMSQNEntry(void);
@@ -208,11 +210,19 @@ void LBMLBTRMSQNEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRMFrameEntry * entry = new LBMLBTRMFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRMSQNEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -224,6 +234,7 @@ class LBMLBTRMNCFReasonEntry : public QTreeWidgetItem
         LBMLBTRMNCFReasonEntry(guint8 reason);
         virtual ~LBMLBTRMNCFReasonEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRMNCFReasonEntry(void);
@@ -281,11 +292,19 @@ void LBMLBTRMNCFReasonEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRMFrameEntry * entry = new LBMLBTRMFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRMNCFReasonEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -300,6 +319,7 @@ class LBMLBTRMNCFSQNEntry : public QTreeWidgetItem
         LBMLBTRMNCFSQNEntry(guint32 sqn);
         virtual ~LBMLBTRMNCFSQNEntry(void);
         void processFrame(guint8 reason, guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRMNCFSQNEntry(void);
@@ -348,9 +368,18 @@ void LBMLBTRMNCFSQNEntry::processFrame(guint8 reason, guint32 frame)
         entry = it.value();
     }
     m_count++;
+    entry->processFrame(frame);
+}
+
+void LBMLBTRMNCFSQNEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
-    entry->processFrame(frame);
+
+    for (LBMLBTRMNCFReasonMapIterator it = m_reasons.begin(); it != m_reasons.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
 }
 
 typedef QMap<guint32, LBMLBTRMSQNEntry *> LBMLBTRMSQNMap;
@@ -367,12 +396,12 @@ class LBMLBTRMSourceTransportEntry : public QTreeWidgetItem
         LBMLBTRMSourceTransportEntry(const QString & transport);
         virtual ~LBMLBTRMSourceTransportEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtrm_tap_info_t * tap_info);
+        void fillItem(void);
 
     protected:
         QString m_transport;
 
     private:
-        void fillItem(void);
         guint64 m_data_frames;
         guint64 m_data_bytes;
         guint64 m_rx_data_frames;
@@ -547,7 +576,6 @@ void LBMLBTRMSourceTransportEntry::processPacket(const packet_info * pinfo, cons
     {
         return;
     }
-    fillItem();
 }
 
 void LBMLBTRMSourceTransportEntry::fillItem(void)
@@ -597,8 +625,8 @@ void LBMLBTRMSourceTransportEntry::fillItem(void)
     setTextAlignment(Source_SMRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRMSourceTransportEntry *> LBMLBTRMSourceTransportMap;
-typedef QMap<QString, LBMLBTRMSourceTransportEntry *>::iterator LBMLBTRMSourceTransportMapIterator;
+typedef QHash<guint64, LBMLBTRMSourceTransportEntry *> LBMLBTRMSourceTransportMap;
+typedef QHash<guint64, LBMLBTRMSourceTransportEntry *>::iterator LBMLBTRMSourceTransportMapIterator;
 
 // A source (address) entry
 class LBMLBTRMSourceEntry : public QTreeWidgetItem
@@ -607,9 +635,9 @@ class LBMLBTRMSourceEntry : public QTreeWidgetItem
         LBMLBTRMSourceEntry(const QString & source_address);
         virtual ~LBMLBTRMSourceEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtrm_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
-        void fillItem(void);
         QString m_address;
         QString m_transport;
         guint64 m_data_frames;
@@ -625,6 +653,7 @@ class LBMLBTRMSourceEntry : public QTreeWidgetItem
         bool m_first_frame_timestamp_valid;
         nstime_t m_last_frame_timestamp;
         LBMLBTRMSourceTransportMap m_transports;
+        bool m_transport_added;
 };
 
 LBMLBTRMSourceEntry::LBMLBTRMSourceEntry(const QString & source_address) :
@@ -640,7 +669,8 @@ LBMLBTRMSourceEntry::LBMLBTRMSourceEntry(const QString & source_address) :
     m_sm_frames(0),
     m_sm_bytes(0),
     m_first_frame_timestamp_valid(false),
-    m_transports()
+    m_transports(),
+    m_transport_added(false)
 {
     m_first_frame_timestamp.secs = 0;
     m_first_frame_timestamp.nsecs = 0;
@@ -704,19 +734,18 @@ void LBMLBTRMSourceEntry::processPacket(const packet_info * pinfo, const lbm_lbt
         m_sm_bytes += pinfo->fd->pkt_len;
     }
 
-    it = m_transports.find(tap_info->transport);
+    it = m_transports.find(tap_info->channel);
     if (m_transports.end() == it)
     {
-        transport = new LBMLBTRMSourceTransportEntry(tap_info->transport);
-        m_transports.insert(tap_info->transport, transport);
+        transport = new LBMLBTRMSourceTransportEntry(QString(tap_info->transport));
+        m_transports.insert(tap_info->channel, transport);
         addChild(transport);
-        sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = true;
     }
     else
     {
         transport = it.value();
     }
-    fillItem();
     transport->processPacket(pinfo, tap_info);
 }
 
@@ -724,6 +753,16 @@ void LBMLBTRMSourceEntry::fillItem(void)
 {
     nstime_t delta;
 
+    for (LBMLBTRMSourceTransportMapIterator it = m_transports.begin(); it != m_transports.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_transport_added)
+    {
+        sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = false;
+    }
+
     nstime_delta(&delta, &m_last_frame_timestamp, &m_first_frame_timestamp);
     setText(Source_DataFrames_Column, QString("%1").arg(m_data_frames));
     setTextAlignment(Source_DataFrames_Column, Qt::AlignRight);
@@ -767,8 +806,12 @@ void LBMLBTRMSourceEntry::fillItem(void)
     setTextAlignment(Source_SMRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRMSourceEntry *> LBMLBTRMSourceMap;
-typedef QMap<QString, LBMLBTRMSourceEntry *>::iterator LBMLBTRMSourceMapIterator;
+// Sources and receivers are keyed by address type and address bytes, so
+// that finding one does not need the address formatted as a string.
+typedef QPair<int, QByteArray> LBMLBTRMAddressKey;
+
+typedef QHash<LBMLBTRMAddressKey, LBMLBTRMSourceEntry *> LBMLBTRMSourceMap;
+typedef QHash<LBMLBTRMAddressKey, LBMLBTRMSourceEntry *>::iterator LBMLBTRMSourceMapIterator;
 
 // A receiver transport entry
 class LBMLBTRMReceiverTransportEntry : public QTreeWidgetItem
@@ -779,9 +822,9 @@ class LBMLBTRMReceiverTransportEntry : public QTreeWidgetItem
         LBMLBTRMReceiverTransportEntry(const QString & transport);
         virtual ~LBMLBTRMReceiverTransportEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtrm_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
-        void fillItem(void);
         QString m_transport;
         guint64 m_nak_frames;
         guint64 m_nak_count;
@@ -865,7 +908,6 @@ void LBMLBTRMReceiverTransportEntry::processPacket(const packet_info * pinfo, co
     {
         return;
     }
-    fillItem();
 }
 
 void LBMLBTRMReceiverTransportEntry::fillItem(void)
@@ -883,8 +925,8 @@ void LBMLBTRMReceiverTransportEntry::fillItem(void)
     setTextAlignment(Receiver_NAKRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRMReceiverTransportEntry *> LBMLBTRMReceiverTransportMap;
-typedef QMap<QString, LBMLBTRMReceiverTransportEntry *>::iterator LBMLBTRMReceiverTransportMapIterator;
+typedef QHash<guint64, LBMLBTRMReceiverTransportEntry *> LBMLBTRMReceiverTransportMap;
+typedef QHash<guint64, LBMLBTRMReceiverTransportEntry *>::iterator LBMLBTRMReceiverTransportMapIterator;
 
 // A receiver (address) entry
 class LBMLBTRMReceiverEntry : public QTreeWidgetItem
@@ -893,10 +935,10 @@ class LBMLBTRMReceiverEntry : public QTreeWidgetItem
         LBMLBTRMReceiverEntry(const QString & receiver_address);
         virtual ~LBMLBTRMReceiverEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtrm_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
         LBMLBTRMReceiverEntry(void);
-        void fillItem(void);
         QString m_address;
         QString m_transport;
         guint64 m_nak_frames;
@@ -906,6 +948,7 @@ class LBMLBTRMReceiverEntry : public QTreeWidgetItem
         bool m_first_frame_timestamp_valid;
         nstime_t m_last_frame_timestamp;
         LBMLBTRMReceiverTransportMap m_transports;
+        bool m_transport_added;
 };
 
 LBMLBTRMReceiverEntry::LBMLBTRMReceiverEntry(const QString & receiver_address) :
@@ -915,7 +958,8 @@ LBMLBTRMReceiverEntry::LBMLBTRMReceiverEntry(const QString & receiver_address) :
     m_nak_count(0),
     m_nak_bytes(0),
     m_first_frame_timestamp_valid(false),
-    m_transports()
+    m_transports(),
+    m_transport_added(false)
 {
     m_first_frame_timestamp.secs = 0;
     m_first_frame_timestamp.nsecs = 0;
@@ -961,19 +1005,18 @@ void LBMLBTRMReceiverEntry::processPacket(const packet_info * pinfo, const lbm_l
         m_nak_count += tap_info->num_sqns;
     }
 
-    it = m_transports.find(tap_info->transport);
+    it = m_transports.find(tap_info->channel);
     if (m_transports.end() == it)
     {
-        transport = new LBMLBTRMReceiverTransportEntry(tap_info->transport);
-        m_transports.insert(tap_info->transport, transport);
+        transport = new LBMLBTRMReceiverTransportEntry(QString(tap_info->transport));
+        m_transports.insert(tap_info->channel, transport);
         addChild(transport);
-        sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = true;
     }
     else
     {
         transport = it.value();
     }
-    fillItem();
     transport->processPacket(pinfo, tap_info);
 }
 
@@ -981,6 +1024,16 @@ void LBMLBTRMReceiverEntry::fillItem(void)
 {
     nstime_t delta;
 
+    for (LBMLBTRMReceiverTransportMapIterator it = m_transports.begin(); it != m_transports.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_transport_added)
+    {
+        sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = false;
+    }
+
     nstime_delta(&delta, &m_last_frame_timestamp, &m_first_frame_timestamp);
     setText(Receiver_NAKFrames_Column, QString("%1").arg(m_nak_frames));
     setTextAlignment(Receiver_NAKFrames_Column, Qt::AlignRight);
@@ -992,8 +1045,8 @@ void LBMLBTRMReceiverEntry::fillItem(void)
     setTextAlignment(Receiver_NAKRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRMReceiverEntry *> LBMLBTRMReceiverMap;
-typedef QMap<QString, LBMLBTRMReceiverEntry *>::iterator LBMLBTRMReceiverMapIterator;
+typedef QHash<LBMLBTRMAddressKey, LBMLBTRMReceiverEntry *> LBMLBTRMReceiverMap;
+typedef QHash<LBMLBTRMAddressKey, LBMLBTRMReceiverEntry *>::iterator LBMLBTRMReceiverMapIterator;
 
 class LBMLBTRMTransportDialogInfo
 {
@@ -1003,18 +1056,23 @@ class LBMLBTRMTransportDialogInfo
         void setDialog(LBMLBTRMTransportDialog * dialog);
         LBMLBTRMTransportDialog * getDialog(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtrm_tap_info_t * tap_info);
+        void fillItems(void);
         void clearMaps(void);
 
     private:
         LBMLBTRMTransportDialog * m_dialog;
         LBMLBTRMSourceMap m_sources;
         LBMLBTRMReceiverMap m_receivers;
+        bool m_source_added;
+        bool m_receiver_added;
 };
 
 LBMLBTRMTransportDialogInfo::LBMLBTRMTransportDialogInfo(void) :
     m_dialog(NULL),
     m_sources(),
-    m_receivers()
+    m_receivers(),
+    m_source_added(false),
+    m_receiver_added(false)
 {
 }
 
@@ -1043,21 +1101,20 @@ void LBMLBTRMTransportDialogInfo::processPacket(const packet_info * pinfo, const
             {
                 LBMLBTRMSourceEntry * source = NULL;
                 LBMLBTRMSourceMapIterator it;
-                QString src_address = address_to_qstring(&(pinfo->src));
+                LBMLBTRMAddressKey key(pinfo->src.type, QByteArray::fromRawData((const char *)pinfo->src.data, pinfo->src.len));
 
-                it = m_sources.find(src_address);
+                it = m_sources.find(key);
                 if (m_sources.end() == it)
                 {
-                    QTreeWidgetItem * parent = NULL;
                     Ui::LBMLBTRMTransportDialog * ui = NULL;
 
-                    source = new LBMLBTRMSourceEntry(src_address);
-                    it = m_sources.insert(src_address, source);
+                    source = new LBMLBTRMSourceEntry(address_to_qstring(&(pinfo->src)));
+                    // The lookup key points into the packet; keep a copy.
+                    key.second = QByteArray((const char *)pinfo->src.data, pinfo->src.len);
+                    it = m_sources.insert(key, source);
                     ui = m_dialog->getUI();
                     ui->sources_TreeWidget->addTopLevelItem(source);
-                    parent = ui->sources_TreeWidget->invisibleRootItem();
-                    parent->sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
-                    ui->sources_TreeWidget->resizeColumnToContents(Source_AddressTransport_Column);
+                    m_source_added = true;
                 }
                 else
                 {
@@ -1070,21 +1127,20 @@ void LBMLBTRMTransportDialogInfo::processPacket(const packet_info * pinfo, const
             {
                 LBMLBTRMReceiverEntry * receiver = NULL;
                 LBMLBTRMReceiverMapIterator it;
-                QString src_address = address_to_qstring(&(pinfo->src));
+                LBMLBTRMAddressKey key(pinfo->src.type, QByteArray::fromRawData((const char *)pinfo->src.data, pinfo->src.len));
 
-                it = m_receivers.find(src_address);
+                it = m_receivers.find(key);
                 if (m_receivers.end() == it)
                 {
-                    QTreeWidgetItem * parent = NULL;
                     Ui::LBMLBTRMTransportDialog * ui = NULL;
 
-                    receiver = new LBMLBTRMReceiverEntry(src_address);
-                    it = m_receivers.insert(src_address, receiver);
+                    receiver = new LBMLBTRMReceiverEntry(address_to_qstring(&(pinfo->src)));
+                    // The lookup key points into the packet; keep a copy.
+                    key.second = QByteArray((const char *)pinfo->src.data, pinfo->src.len);
+                    it = m_receivers.insert(key, receiver);
                     ui = m_dialog->getUI();
                     ui->receivers_TreeWidget->addTopLevelItem(receiver);
-                    parent = ui->receivers_TreeWidget->invisibleRootItem();
-                    parent->sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
-                    ui->receivers_TreeWidget->resizeColumnToContents(Receiver_AddressTransport_Column);
+                    m_receiver_added = true;
                 }
                 else
                 {
@@ -1098,6 +1154,33 @@ void LBMLBTRMTransportDialogInfo::processPacket(const packet_info * pinfo, const
     }
 }
 
+void LBMLBTRMTransportDialogInfo::fillItems(void)
+{
+    Ui::LBMLBTRMTransportDialog * ui = m_dialog->getUI();
+
+    for (LBMLBTRMSourceMapIterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_source_added)
+    {
+        ui->sources_TreeWidget->invisibleRootItem()->sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        ui->sources_TreeWidget->resizeColumnToContents(Source_AddressTransport_Column);
+        m_source_added = false;
+    }
+
+    for (LBMLBTRMReceiverMapIterator it = m_receivers.begin(); it != m_receivers.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_receiver_added)
+    {
+        ui->receivers_TreeWidget->invisibleRootItem()->sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        ui->receivers_TreeWidget->resizeColumnToContents(Receiver_AddressTransport_Column);
+        m_receiver_added = false;
+    }
+}
+
 void LBMLBTRMTransportDialogInfo::clearMaps(void)
 {
     for (LBMLBTRMSourceMapIterator it = m_sources.begin(); it != m_sources.end(); ++it)
@@ -1111,6 +1194,8 @@ void LBMLBTRMTransportDialogInfo::clearMaps(void)
         delete *it;
     }
     m_receivers.clear();
+    m_source_added = false;
+    m_receiver_added = false;
 }
 
 LBMLBTRMTransportDialog::LBMLBTRMTransportDialog(QWidget * parent, capture_file * cfile) :
@@ -1304,7 +1389,7 @@ void LBMLBTRMTransportDialog::fillTree(void)
     }
 
     cf_retap_packets(m_capture_file);
-    drawTreeItems(&m_dialog_info);
+    drawTreeItems(m_dialog_info);
     remove_tap_listener((void *)m_dialog_info);
 }
 
@@ -1335,8 +1420,15 @@ tap_packet_status LBMLBTRMTransportDialog::tapPacket(void * tap_data, packet_inf
     return (TAP_PACKET_REDRAW);
 }
 
-void LBMLBTRMTransportDialog::drawTreeItems(void *)
+void LBMLBTRMTransportDialog::drawTreeItems(void * tap_data)
 {
+    LBMLBTRMTransportDialogInfo * info = (LBMLBTRMTransportDialogInfo *)tap_data;
+
+    if (info->getDialog() == NULL)
+    {
+        return;
+    }
+    info->fillItems();
 }
 
 void LBMLBTRMTransportDialog::on_applyFilterButton_clicked(void)
@@ -1408,6 +1500,7 @@ void LBMLBTRMTransportDialog::loadSourceDataDetails(LBMLBTRMSourceTransportEntry
     for (LBMLBTRMSQNMapIterator it = transport->m_data_sqns.begin(); it != transport->m_data_sqns.end(); ++it)
     {
         LBMLBTRMSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1417,6 +1510,7 @@ void LBMLBTRMTransportDialog::loadSourceRXDataDetails(LBMLBTRMSourceTransportEnt
     for (LBMLBTRMSQNMapIterator it = transport->m_rx_data_sqns.begin(); it != transport->m_rx_data_sqns.end(); ++it)
     {
         LBMLBTRMSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1426,6 +1520,7 @@ void LBMLBTRMTransportDialog::loadSourceNCFDetails(LBMLBTRMSourceTransportEntry
     for (LBMLBTRMNCFSQNMapIterator it = transport->m_ncf_sqns.begin(); it != transport->m_ncf_sqns.end(); ++it)
     {
         LBMLBTRMNCFSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_ncf_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1435,6 +1530,7 @@ void LBMLBTRMTransportDialog::loadSourceSMDetails(LBMLBTRMSourceTransportEntry *
     for (LBMLBTRMSQNMapIterator it = transport->m_sm_sqns.begin(); it != transport->m_sm_sqns.end(); ++it)
     {
         LBMLBTRMSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1459,6 +1555,7 @@ void LBMLBTRMTransportDialog::loadReceiverNAKDetails(LBMLBTRMReceiverTransportEn
     for (LBMLBTRMSQNMapIterator it = transport->m_nak_sqns.begin(); it != transport->m_nak_sqns.end(); ++it)
     {
         LBMLBTRMSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->receivers_detail_TreeWidget->addTopLevelItem(sqn);
     }
 }
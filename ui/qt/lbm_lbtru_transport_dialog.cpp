@@ -18,6 +18,7 @@
 #include "wireshark_application.h"
 
 #include <QClipboard>
+#include <QHash>
 #include <QMessageBox>
 #include <QTreeWidget>
 #include <QTreeWidgetItemIterator>
@@ -188,6 +189,7 @@ class LBMLBTRUSQNEntry : public QTreeWidgetItem
         LBMLBTRUSQNEntry(guint32 sqn);
         virtual ~LBMLBTRUSQNEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRUSQNEntry(void);
@@ -226,11 +228,19 @@ void LBMLBTRUSQNEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRUFrameEntry * entry = new LBMLBTRUFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRUSQNEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -242,6 +252,7 @@ class LBMLBTRUNCFReasonEntry : public QTreeWidgetItem
         LBMLBTRUNCFReasonEntry(guint8 reason);
         virtual ~LBMLBTRUNCFReasonEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRUNCFReasonEntry(void);
@@ -296,11 +307,19 @@ void LBMLBTRUNCFReasonEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRUFrameEntry * entry = new LBMLBTRUFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRUNCFReasonEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -315,6 +334,7 @@ class LBMLBTRUNCFSQNEntry : public QTreeWidgetItem
         LBMLBTRUNCFSQNEntry(guint32 sqn);
         virtual ~LBMLBTRUNCFSQNEntry(void);
         void processFrame(guint8 reason, guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRUNCFSQNEntry(void);
@@ -363,9 +383,18 @@ void LBMLBTRUNCFSQNEntry::processFrame(guint8 reason, guint32 frame)
         entry = it.value();
     }
     m_count++;
+    entry->processFrame(frame);
+}
+
+void LBMLBTRUNCFSQNEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
-    entry->processFrame(frame);
+
+    for (LBMLBTRUNCFReasonMapIterator it = m_reasons.begin(); it != m_reasons.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
 }
 
 // An RST (ReSeT) Reason entry
@@ -375,6 +404,7 @@ class LBMLBTRURSTReasonEntry : public QTreeWidgetItem
         LBMLBTRURSTReasonEntry(guint32 reason);
         virtual ~LBMLBTRURSTReasonEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRURSTReasonEntry(void);
@@ -424,11 +454,19 @@ void LBMLBTRURSTReasonEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRUFrameEntry * entry = new LBMLBTRUFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRURSTReasonEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -440,6 +478,7 @@ class LBMLBTRUCREQRequestEntry : public QTreeWidgetItem
         LBMLBTRUCREQRequestEntry(guint32 request);
         virtual ~LBMLBTRUCREQRequestEntry(void);
         void processFrame(guint32 frame);
+        void fillItem(void);
 
     private:
         LBMLBTRUCREQRequestEntry(void);
@@ -489,11 +528,19 @@ void LBMLBTRUCREQRequestEntry::processFrame(guint32 frame)
     if (m_frames.end() == it)
     {
         LBMLBTRUFrameEntry * entry = new LBMLBTRUFrameEntry(frame);
+        bool in_order = m_frames.isEmpty() || (frame > m_frames.lastKey());
         m_frames.insert(frame, entry);
         addChild(entry);
-        sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        if (!in_order)
+        {
+            sortChildren(Detail_Frame_Column, Qt::AscendingOrder);
+        }
     }
     m_count++;
+}
+
+void LBMLBTRUCREQRequestEntry::fillItem(void)
+{
     setText(Detail_Count_Column, QString("%1").arg(m_count));
     setTextAlignment(Detail_Count_Column, Qt::AlignRight);
 }
@@ -516,12 +563,12 @@ class LBMLBTRUSourceTransportEntry : public QTreeWidgetItem
         LBMLBTRUSourceTransportEntry(const QString & transport);
         virtual ~LBMLBTRUSourceTransportEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtru_tap_info_t * tap_info);
+        void fillItem(void);
 
     protected:
         QString m_transport;
 
     private:
-        void fillItem(void);
         guint64 m_data_frames;
         guint64 m_data_bytes;
         guint64 m_rx_data_frames;
@@ -728,7 +775,6 @@ void LBMLBTRUSourceTransportEntry::processPacket(const packet_info * pinfo, cons
     {
         return;
     }
-    fillItem();
 }
 
 void LBMLBTRUSourceTransportEntry::fillItem(void)
@@ -786,8 +832,8 @@ void LBMLBTRUSourceTransportEntry::fillItem(void)
     setTextAlignment(Source_RSTRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRUSourceTransportEntry *> LBMLBTRUSourceTransportMap;
-typedef QMap<QString, LBMLBTRUSourceTransportEntry *>::iterator LBMLBTRUSourceTransportMapIterator;
+typedef QHash<guint64, LBMLBTRUSourceTransportEntry *> LBMLBTRUSourceTransportMap;
+typedef QHash<guint64, LBMLBTRUSourceTransportEntry *>::iterator LBMLBTRUSourceTransportMapIterator;
 
 // A source (address) entry
 class LBMLBTRUSourceEntry : public QTreeWidgetItem
@@ -796,9 +842,9 @@ class LBMLBTRUSourceEntry : public QTreeWidgetItem
         LBMLBTRUSourceEntry(const QString & source_address);
         virtual ~LBMLBTRUSourceEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtru_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
-        void fillItem(void);
         QString m_address;
         QString m_transport;
         guint64 m_data_frames;
@@ -816,6 +862,7 @@ class LBMLBTRUSourceEntry : public QTreeWidgetItem
         bool m_first_frame_timestamp_valid;
         nstime_t m_last_frame_timestamp;
         LBMLBTRUSourceTransportMap m_transports;
+        bool m_transport_added;
 };
 
 LBMLBTRUSourceEntry::LBMLBTRUSourceEntry(const QString & source_address) :
@@ -833,7 +880,8 @@ LBMLBTRUSourceEntry::LBMLBTRUSourceEntry(const QString & source_address) :
     m_rst_frames(0),
     m_rst_bytes(0),
     m_first_frame_timestamp_valid(false),
-    m_transports()
+    m_transports(),
+    m_transport_added(false)
 {
     m_first_frame_timestamp.secs = 0;
     m_first_frame_timestamp.nsecs = 0;
@@ -901,19 +949,18 @@ void LBMLBTRUSourceEntry::processPacket(const packet_info * pinfo, const lbm_lbt
             break;
     }
 
-    it = m_transports.find(tap_info->transport);
+    it = m_transports.find(tap_info->channel);
     if (m_transports.end() == it)
     {
-        transport = new LBMLBTRUSourceTransportEntry(tap_info->transport);
-        m_transports.insert(tap_info->transport, transport);
+        transport = new LBMLBTRUSourceTransportEntry(QString(tap_info->transport));
+        m_transports.insert(tap_info->channel, transport);
         addChild(transport);
-        sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = true;
     }
     else
     {
         transport = it.value();
     }
-    fillItem();
     transport->processPacket(pinfo, tap_info);
 }
 
@@ -921,6 +968,16 @@ void LBMLBTRUSourceEntry::fillItem(void)
 {
     nstime_t delta;
 
+    for (LBMLBTRUSourceTransportMapIterator it = m_transports.begin(); it != m_transports.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_transport_added)
+    {
+        sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = false;
+    }
+
     nstime_delta(&delta, &m_last_frame_timestamp, &m_first_frame_timestamp);
     setText(Source_DataFrames_Column, QString("%1").arg(m_data_frames));
     setTextAlignment(Source_DataFrames_Column, Qt::AlignRight);
@@ -972,8 +1029,12 @@ void LBMLBTRUSourceEntry::fillItem(void)
     setTextAlignment(Source_RSTRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRUSourceEntry *> LBMLBTRUSourceMap;
-typedef QMap<QString, LBMLBTRUSourceEntry *>::iterator LBMLBTRUSourceMapIterator;
+// Sources and receivers are keyed by address type and address bytes, so
+// that finding one does not need the address formatted as a string.
+typedef QPair<int, QByteArray> LBMLBTRUAddressKey;
+
+typedef QHash<LBMLBTRUAddressKey, LBMLBTRUSourceEntry *> LBMLBTRUSourceMap;
+typedef QHash<LBMLBTRUAddressKey, LBMLBTRUSourceEntry *>::iterator LBMLBTRUSourceMapIterator;
 
 // A receiver transport entry
 class LBMLBTRUReceiverTransportEntry : public QTreeWidgetItem
@@ -984,9 +1045,9 @@ class LBMLBTRUReceiverTransportEntry : public QTreeWidgetItem
         LBMLBTRUReceiverTransportEntry(const QString & transport);
         virtual ~LBMLBTRUReceiverTransportEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtru_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
-        void fillItem(void);
         QString m_transport;
         guint64 m_nak_frames;
         guint64 m_nak_count;
@@ -1137,7 +1198,6 @@ void LBMLBTRUReceiverTransportEntry::processPacket(const packet_info * pinfo, co
             return;
             break;
     }
-    fillItem();
 }
 
 void LBMLBTRUReceiverTransportEntry::fillItem(void)
@@ -1179,8 +1239,8 @@ void LBMLBTRUReceiverTransportEntry::fillItem(void)
     setTextAlignment(Receiver_CREQRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRUReceiverTransportEntry *> LBMLBTRUReceiverTransportMap;
-typedef QMap<QString, LBMLBTRUReceiverTransportEntry *>::iterator LBMLBTRUReceiverTransportMapIterator;
+typedef QHash<guint64, LBMLBTRUReceiverTransportEntry *> LBMLBTRUReceiverTransportMap;
+typedef QHash<guint64, LBMLBTRUReceiverTransportEntry *>::iterator LBMLBTRUReceiverTransportMapIterator;
 
 // A receiver (address) entry
 class LBMLBTRUReceiverEntry : public QTreeWidgetItem
@@ -1189,9 +1249,9 @@ class LBMLBTRUReceiverEntry : public QTreeWidgetItem
         LBMLBTRUReceiverEntry(const QString & receiver_address);
         virtual ~LBMLBTRUReceiverEntry(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtru_tap_info_t * tap_info);
+        void fillItem(void);
 
     private:
-        void fillItem(void);
         QString m_address;
         QString m_transport;
         guint64 m_nak_frames;
@@ -1205,6 +1265,7 @@ class LBMLBTRUReceiverEntry : public QTreeWidgetItem
         bool m_first_frame_timestamp_valid;
         nstime_t m_last_frame_timestamp;
         LBMLBTRUReceiverTransportMap m_transports;
+        bool m_transport_added;
 };
 
 LBMLBTRUReceiverEntry::LBMLBTRUReceiverEntry(const QString & receiver_address) :
@@ -1218,7 +1279,8 @@ LBMLBTRUReceiverEntry::LBMLBTRUReceiverEntry(const QString & receiver_address) :
     m_creq_frames(0),
     m_creq_bytes(0),
     m_first_frame_timestamp_valid(false),
-    m_transports()
+    m_transports(),
+    m_transport_added(false)
 {
     m_first_frame_timestamp.secs = 0;
     m_first_frame_timestamp.nsecs = 0;
@@ -1274,19 +1336,18 @@ void LBMLBTRUReceiverEntry::processPacket(const packet_info * pinfo, const lbm_l
             break;
     }
 
-    it = m_transports.find(tap_info->transport);
+    it = m_transports.find(tap_info->channel);
     if (m_transports.end() == it)
     {
-        transport = new LBMLBTRUReceiverTransportEntry(tap_info->transport);
-        m_transports.insert(tap_info->transport, transport);
+        transport = new LBMLBTRUReceiverTransportEntry(QString(tap_info->transport));
+        m_transports.insert(tap_info->channel, transport);
         addChild(transport);
-        sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = true;
     }
     else
     {
         transport = it.value();
     }
-    fillItem();
     transport->processPacket(pinfo, tap_info);
 }
 
@@ -1294,6 +1355,16 @@ void LBMLBTRUReceiverEntry::fillItem(void)
 {
     nstime_t delta;
 
+    for (LBMLBTRUReceiverTransportMapIterator it = m_transports.begin(); it != m_transports.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_transport_added)
+    {
+        sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        m_transport_added = false;
+    }
+
     nstime_delta(&delta, &m_last_frame_timestamp, &m_first_frame_timestamp);
     setText(Receiver_NAKFrames_Column, QString("%1").arg(m_nak_frames));
     setTextAlignment(Receiver_NAKFrames_Column, Qt::AlignRight);
@@ -1329,8 +1400,8 @@ void LBMLBTRUReceiverEntry::fillItem(void)
     setTextAlignment(Receiver_CREQRate_Column, Qt::AlignRight);
 }
 
-typedef QMap<QString, LBMLBTRUReceiverEntry *> LBMLBTRUReceiverMap;
-typedef QMap<QString, LBMLBTRUReceiverEntry *>::iterator LBMLBTRUReceiverMapIterator;
+typedef QHash<LBMLBTRUAddressKey, LBMLBTRUReceiverEntry *> LBMLBTRUReceiverMap;
+typedef QHash<LBMLBTRUAddressKey, LBMLBTRUReceiverEntry *>::iterator LBMLBTRUReceiverMapIterator;
 
 class LBMLBTRUTransportDialogInfo
 {
@@ -1340,18 +1411,23 @@ class LBMLBTRUTransportDialogInfo
         void setDialog(LBMLBTRUTransportDialog * dialog);
         LBMLBTRUTransportDialog * getDialog(void);
         void processPacket(const packet_info * pinfo, const lbm_lbtru_tap_info_t * tap_info);
+        void fillItems(void);
         void clearMaps(void);
 
     private:
         LBMLBTRUTransportDialog * m_dialog;
         LBMLBTRUSourceMap m_sources;
         LBMLBTRUReceiverMap m_receivers;
+        bool m_source_added;
+        bool m_receiver_added;
 };
 
 LBMLBTRUTransportDialogInfo::LBMLBTRUTransportDialogInfo(void) :
     m_dialog(NULL),
     m_sources(),
-    m_receivers()
+    m_receivers(),
+    m_source_added(false),
+    m_receiver_added(false)
 {
 }
 
@@ -1381,21 +1457,20 @@ void LBMLBTRUTransportDialogInfo::processPacket(const packet_info * pinfo, const
             {
                 LBMLBTRUSourceEntry * source = NULL;
                 LBMLBTRUSourceMapIterator it;
-                QString src_address = address_to_qstring(&(pinfo->src));
+                LBMLBTRUAddressKey key(pinfo->src.type, QByteArray::fromRawData((const char *)pinfo->src.data, pinfo->src.len));
 
-                it = m_sources.find(src_address);
+                it = m_sources.find(key);
                 if (m_sources.end() == it)
                 {
-                    QTreeWidgetItem * parent = NULL;
                     Ui::LBMLBTRUTransportDialog * ui = NULL;
 
-                    source = new LBMLBTRUSourceEntry(src_address);
-                    it = m_sources.insert(src_address, source);
+                    source = new LBMLBTRUSourceEntry(address_to_qstring(&(pinfo->src)));
+                    // The lookup key points into the packet; keep a copy.
+                    key.second = QByteArray((const char *)pinfo->src.data, pinfo->src.len);
+                    it = m_sources.insert(key, source);
                     ui = m_dialog->getUI();
                     ui->sources_TreeWidget->addTopLevelItem(source);
-                    parent = ui->sources_TreeWidget->invisibleRootItem();
-                    parent->sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
-                    ui->sources_TreeWidget->resizeColumnToContents(Source_AddressTransport_Column);
+                    m_source_added = true;
                 }
                 else
                 {
@@ -1410,21 +1485,20 @@ void LBMLBTRUTransportDialogInfo::processPacket(const packet_info * pinfo, const
             {
                 LBMLBTRUReceiverEntry * receiver = NULL;
                 LBMLBTRUReceiverMapIterator it;
-                QString src_address = address_to_qstring(&(pinfo->src));
+                LBMLBTRUAddressKey key(pinfo->src.type, QByteArray::fromRawData((const char *)pinfo->src.data, pinfo->src.len));
 
-                it = m_receivers.find(src_address);
+                it = m_receivers.find(key);
                 if (m_receivers.end() == it)
                 {
-                    QTreeWidgetItem * parent = NULL;
                     Ui::LBMLBTRUTransportDialog * ui = NULL;
 
-                    receiver = new LBMLBTRUReceiverEntry(src_address);
-                    it = m_receivers.insert(src_address, receiver);
+                    receiver = new LBMLBTRUReceiverEntry(address_to_qstring(&(pinfo->src)));
+                    // The lookup key points into the packet; keep a copy.
+                    key.second = QByteArray((const char *)pinfo->src.data, pinfo->src.len);
+                    it = m_receivers.insert(key, receiver);
                     ui = m_dialog->getUI();
                     ui->receivers_TreeWidget->addTopLevelItem(receiver);
-                    parent = ui->receivers_TreeWidget->invisibleRootItem();
-                    parent->sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
-                    ui->receivers_TreeWidget->resizeColumnToContents(Receiver_AddressTransport_Column);
+                    m_receiver_added = true;
                 }
                 else
                 {
@@ -1438,6 +1512,33 @@ void LBMLBTRUTransportDialogInfo::processPacket(const packet_info * pinfo, const
     }
 }
 
+void LBMLBTRUTransportDialogInfo::fillItems(void)
+{
+    Ui::LBMLBTRUTransportDialog * ui = m_dialog->getUI();
+
+    for (LBMLBTRUSourceMapIterator it = m_sources.begin(); it != m_sources.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_source_added)
+    {
+        ui->sources_TreeWidget->invisibleRootItem()->sortChildren(Source_AddressTransport_Column, Qt::AscendingOrder);
+        ui->sources_TreeWidget->resizeColumnToContents(Source_AddressTransport_Column);
+        m_source_added = false;
+    }
+
+    for (LBMLBTRUReceiverMapIterator it = m_receivers.begin(); it != m_receivers.end(); ++it)
+    {
+        (*it)->fillItem();
+    }
+    if (m_receiver_added)
+    {
+        ui->receivers_TreeWidget->invisibleRootItem()->sortChildren(Receiver_AddressTransport_Column, Qt::AscendingOrder);
+        ui->receivers_TreeWidget->resizeColumnToContents(Receiver_AddressTransport_Column);
+        m_receiver_added = false;
+    }
+}
+
 void LBMLBTRUTransportDialogInfo::clearMaps(void)
 {
     for (LBMLBTRUSourceMapIterator it = m_sources.begin(); it != m_sources.end(); ++it)
@@ -1451,6 +1552,8 @@ void LBMLBTRUTransportDialogInfo::clearMaps(void)
         delete *it;
     }
     m_receivers.clear();
+    m_source_added = false;
+    m_receiver_added = false;
 }
 
 LBMLBTRUTransportDialog::LBMLBTRUTransportDialog(QWidget * parent, capture_file * cfile) :
@@ -1723,7 +1826,7 @@ void LBMLBTRUTransportDialog::fillTree(void)
     }
 
     cf_retap_packets(m_capture_file);
-    drawTreeItems(&m_dialog_info);
+    drawTreeItems(m_dialog_info);
     remove_tap_listener((void *)m_dialog_info);
 }
 
@@ -1754,8 +1857,15 @@ tap_packet_status LBMLBTRUTransportDialog::tapPacket(void * tap_data, packet_inf
     return (TAP_PACKET_REDRAW);
 }
 
-void LBMLBTRUTransportDialog::drawTreeItems(void *)
+void LBMLBTRUTransportDialog::drawTreeItems(void * tap_data)
 {
+    LBMLBTRUTransportDialogInfo * info = (LBMLBTRUTransportDialogInfo *)tap_data;
+
+    if (info->getDialog() == NULL)
+    {
+        return;
+    }
+    info->fillItems();
 }
 
 void LBMLBTRUTransportDialog::on_applyFilterButton_clicked(void)
@@ -1834,6 +1944,7 @@ void LBMLBTRUTransportDialog::loadSourceDataDetails(LBMLBTRUSourceTransportEntry
     for (LBMLBTRUSQNMapIterator it = transport->m_data_sqns.begin(); it != transport->m_data_sqns.end(); ++it)
     {
         LBMLBTRUSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1843,6 +1954,7 @@ void LBMLBTRUTransportDialog::loadSourceRXDataDetails(LBMLBTRUSourceTransportEnt
     for (LBMLBTRUSQNMapIterator it = transport->m_rx_data_sqns.begin(); it != transport->m_rx_data_sqns.end(); ++it)
     {
         LBMLBTRUSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1852,6 +1964,7 @@ void LBMLBTRUTransportDialog::loadSourceNCFDetails(LBMLBTRUSourceTransportEntry
     for (LBMLBTRUNCFSQNMapIterator it = transport->m_ncf_sqns.begin(); it != transport->m_ncf_sqns.end(); ++it)
     {
         LBMLBTRUNCFSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_ncf_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1861,6 +1974,7 @@ void LBMLBTRUTransportDialog::loadSourceSMDetails(LBMLBTRUSourceTransportEntry *
     for (LBMLBTRUSQNMapIterator it = transport->m_sm_sqns.begin(); it != transport->m_sm_sqns.end(); ++it)
     {
         LBMLBTRUSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->sources_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1870,6 +1984,7 @@ void LBMLBTRUTransportDialog::loadSourceRSTDetails(LBMLBTRUSourceTransportEntry
     for (LBMLBTRURSTReasonMapIterator it = transport->m_rst_reasons.begin(); it != transport->m_rst_reasons.end(); ++it)
     {
         LBMLBTRURSTReasonEntry * reason = it.value();
+        reason->fillItem();
         m_ui->sources_detail_rst_TreeWidget->addTopLevelItem(reason);
     }
 }
@@ -1939,6 +2054,7 @@ void LBMLBTRUTransportDialog::loadReceiverNAKDetails(LBMLBTRUReceiverTransportEn
     for (LBMLBTRUSQNMapIterator it = transport->m_nak_sqns.begin(); it != transport->m_nak_sqns.end(); ++it)
     {
         LBMLBTRUSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->receivers_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1948,6 +2064,7 @@ void LBMLBTRUTransportDialog::loadReceiverACKDetails(LBMLBTRUReceiverTransportEn
     for (LBMLBTRUSQNMapIterator it = transport->m_ack_sqns.begin(); it != transport->m_ack_sqns.end(); ++it)
     {
         LBMLBTRUSQNEntry * sqn = it.value();
+        sqn->fillItem();
         m_ui->receivers_detail_sqn_TreeWidget->addTopLevelItem(sqn);
     }
 }
@@ -1957,6 +2074,7 @@ void LBMLBTRUTransportDialog::loadReceiverCREQDetails(LBMLBTRUReceiverTransportE
     for (LBMLBTRUCREQRequestMapIterator it = transport->m_creq_requests.begin(); it != transport->m_creq_requests.end(); ++it)
     {
         LBMLBTRUCREQRequestEntry * req = it.value();
+        req->fillItem();
         m_ui->receivers_detail_reason_TreeWidget->addTopLevelItem(req);
     }
 }
@@ -200,7 +200,8 @@ public:
         dl_raw_bytes_(0),
         dl_padding_bytes_(0),
         dl_crc_failed_(0),
-        dl_retx_(0)
+        dl_retx_(0),
+        dirty_(true)
     {
         // Set fixed fields.
         rnti_ = mlt_info->rnti;
@@ -223,6 +224,7 @@ public:
 
     // Update this UE according to the tap info
     void update(const mac_lte_tap_info *mlt_info) {
+        dirty_ = true;
 
         // Uplink.
         if (mlt_info->direction == DIRECTION_UPLINK) {
@@ -316,8 +318,13 @@ public:
         setExpanded(false);
     }
 
-    // Draw this UE.
+    // Draw this UE, if it has changed since it was last drawn.
     void draw() {
+        if (!dirty_) {
+            return;
+        }
+        dirty_ = false;
+
         // Fixed fields (rnti, type, ueid) won't change during lifetime of UE entry.
 
         // Calculate bw now.
@@ -455,6 +462,9 @@ private:
     unsigned dl_crc_failed_;
     unsigned dl_retx_;
 
+    // Set when there are changes that have not yet been drawn.
+    bool dirty_;
+
     // Child nodes storing per-lcid counts.
     MacULDLTreeWidgetItem *ul_frames_item_;
     MacULDLTreeWidgetItem *ul_bytes_item_;
@@ -707,6 +717,7 @@ void LteMacStatisticsDialog::tapReset(void *ws_dlg_ptr)
     }
 
     ws_dlg->statsTreeWidget()->clear();
+    ws_dlg->ueItems_.clear();
     ws_dlg->clearCommonStats();
 }
 
@@ -731,21 +742,8 @@ tap_packet_status LteMacStatisticsDialog::tapPacket(void *ws_dlg_ptr, struct _pa
     }
 
     // Look for an existing UE to match this tap info.
-    MacUETreeWidgetItem *mac_ue_ti = NULL;
-    for (int i = 0; i < ws_dlg->statsTreeWidget()->topLevelItemCount(); i++) {
-        QTreeWidgetItem *ti = ws_dlg->statsTreeWidget()->topLevelItem(i);
-        // Make sure we're looking at a UE entry
-        if (ti->type() != mac_whole_ue_row_type_) {
-            continue;
-        }
-
-        // See if current item matches tap.
-        MacUETreeWidgetItem *cur_muds_ti = static_cast<MacUETreeWidgetItem*>(ti);
-        if (cur_muds_ti->isMatch(mlt_info)) {
-            mac_ue_ti = cur_muds_ti;
-            break;
-        }
-    }
+    quint64 ue_key = ueKey(mlt_info);
+    MacUETreeWidgetItem *mac_ue_ti = ws_dlg->ueItems_.value(ue_key, NULL);
 
     // If don't find matching UE, create a new one.
     if (!mac_ue_ti) {
@@ -753,6 +751,7 @@ tap_packet_status LteMacStatisticsDialog::tapPacket(void *ws_dlg_ptr, struct _pa
         for (int col = 0; col < ws_dlg->statsTreeWidget()->columnCount(); col++) {
             mac_ue_ti->setTextAlignment(col, ws_dlg->statsTreeWidget()->headerItem()->textAlignment(col));
         }
+        ws_dlg->ueItems_.insert(ue_key, mac_ue_ti);
     }
 
     // Update the UE item with info from tap!
@@ -760,6 +759,12 @@ tap_packet_status LteMacStatisticsDialog::tapPacket(void *ws_dlg_ptr, struct _pa
     return TAP_PACKET_REDRAW;
 }
 
+// Key for ueItems_; a UE is matched on the same fields as MacUETreeWidgetItem::isMatch().
+quint64 LteMacStatisticsDialog::ueKey(const mac_lte_tap_info *mlt_info)
+{
+    return ((quint64)mlt_info->ueid << 32) | ((quint64)mlt_info->rnti << 8) | mlt_info->rntiType;
+}
+
 // Return total number of frames tapped.
 unsigned LteMacStatisticsDialog::getFrameCount()
 {
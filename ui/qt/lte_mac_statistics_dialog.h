@@ -14,6 +14,7 @@
 
 #include <QLabel>
 #include <QCheckBox>
+#include <QHash>
 
 
 // Common channel stats
@@ -33,6 +34,8 @@ typedef struct mac_lte_common_stats {
 } mac_lte_common_stats;
 
 
+class MacUETreeWidgetItem;
+
 class LteMacStatisticsDialog : public TapParameterDialog
 {
     Q_OBJECT
@@ -66,6 +69,10 @@ private:
 
     unsigned  getFrameCount();
 
+    // UE items by ueKey(), so that packets don't search the whole tree.
+    QHash<quint64, MacUETreeWidgetItem *> ueItems_;
+    static quint64 ueKey(const struct mac_lte_tap_info *mlt_info);
+
     QList<QVariant> treeItemData(QTreeWidgetItem *item) const;
 
 private slots:
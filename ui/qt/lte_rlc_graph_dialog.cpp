@@ -61,6 +61,7 @@ LteRlcGraphDialog::LteRlcGraphDialog(QWidget &parent, CaptureFile &cf, bool chan
     QCustomPlot *rp = ui->rlcPlot;
     rp->xAxis->setLabel(tr("Time"));
     rp->yAxis->setLabel(tr("Sequence Number"));
+    set_plot_rendering_hints(rp);
 
     // TODO: couldn't work out how to tell rp->xAxis not to label fractions of a SN...
 
@@ -379,7 +379,8 @@ class RlcUeTreeWidgetItem : public QTreeWidgetItem
 public:
     RlcUeTreeWidgetItem(QTreeWidget *parent, const rlc_lte_tap_info *rlt_info) :
         QTreeWidgetItem (parent, rlc_ue_row_type_),
-        ueid_(0)
+        ueid_(0),
+        dirty_(true)
     {
         ueid_ = rlt_info->ueid;
         setText(col_ueid_, QString::number(ueid_));
@@ -411,6 +412,7 @@ public:
             (recent.gui_rlc_use_pdus_from_mac  && !tap_info->loggedInMACFrame)) {
             return;
         }
+        dirty_ = true;
 
         // TODO: update title with number of UEs and frames like MAC does?
 
@@ -506,8 +508,13 @@ public:
         }
     }
 
-    // Draw UE entry
+    // Draw UE entry, if it has changed since it was last drawn
     void draw() {
+        if (!dirty_) {
+            return;
+        }
+        dirty_ = false;
+
         // Fixed fields only drawn once from constructor so don't redraw here.
 
         /* Calculate bandwidths. */
@@ -628,6 +635,9 @@ private:
     unsigned ueid_;
     rlc_ue_stats stats_;
 
+    // Set when there are changes that have not yet been drawn.
+    bool dirty_;
+
     // Channel counters stored in channel sub-items.
     RlcChannelTreeWidgetItem* CCCH_stats_;
     RlcChannelTreeWidgetItem* srb_stats_[2];
@@ -767,6 +777,7 @@ void LteRlcStatisticsDialog::tapReset(void *ws_dlg_ptr)
 
     // Clears/deletes all UEs.
     ws_dlg->statsTreeWidget()->clear();
+    ws_dlg->ueItems_.clear();
     ws_dlg->packet_count_ = 0;
 }
 
@@ -783,18 +794,8 @@ tap_packet_status LteRlcStatisticsDialog::tapPacket(void *ws_dlg_ptr, struct _pa
 
     ws_dlg->incFrameCount();
 
-    // Look for this UE (TODO: avoid linear search if have lots of UEs in capture...)
-    RlcUeTreeWidgetItem *ue_ti = NULL;
-    for (int i = 0; i < ws_dlg->statsTreeWidget()->topLevelItemCount(); i++) {
-        QTreeWidgetItem *ti = ws_dlg->statsTreeWidget()->topLevelItem(i);
-        if (ti->type() != rlc_ue_row_type_) continue;
-        RlcUeTreeWidgetItem *cur_ru_ti = static_cast<RlcUeTreeWidgetItem*>(ti);
-
-        if (cur_ru_ti->isMatch(rlt_info)) {
-            ue_ti = cur_ru_ti;
-            break;
-        }
-    }
+    // Look for this UE.
+    RlcUeTreeWidgetItem *ue_ti = ws_dlg->ueItems_.value(rlt_info->ueid, NULL);
 
     if (!ue_ti) {
         // Existing UE wasn't found so create a new one.
@@ -802,6 +803,7 @@ tap_packet_status LteRlcStatisticsDialog::tapPacket(void *ws_dlg_ptr, struct _pa
         for (int col = 0; col < ws_dlg->statsTreeWidget()->columnCount(); col++) {
             ue_ti->setTextAlignment(col, ws_dlg->statsTreeWidget()->headerItem()->textAlignment(col));
         }
+        ws_dlg->ueItems_.insert(rlt_info->ueid, ue_ti);
     }
 
     // Update the UE from the information in the tap structure.
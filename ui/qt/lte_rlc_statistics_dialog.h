@@ -13,6 +13,9 @@
 #include "tap_parameter_dialog.h"
 
 #include <QCheckBox>
+#include <QHash>
+
+class RlcUeTreeWidgetItem;
 
 class LteRlcStatisticsDialog : public TapParameterDialog
 {
@@ -45,6 +48,9 @@ private:
     CaptureFile &cf_;
     int packet_count_;
 
+    // UE items by ueid, so that PDUs don't search the whole tree.
+    QHash<unsigned, RlcUeTreeWidgetItem *> ueItems_;
+
     // Callbacks for register_tap_listener
     static void tapReset(void *ws_dlg_ptr);
     static tap_packet_status tapPacket(void *ws_dlg_ptr, struct _packet_info *, struct epan_dissect *, const void *rlc_lte_tap_info_ptr);
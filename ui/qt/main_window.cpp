@@ -334,6 +334,7 @@ MainWindow::MainWindow(QWidget *parent) :
 
 #ifndef HAVE_LUA
     main_ui_->actionAnalyzeReloadLuaPlugins->setVisible(false);
+    main_ui_->actionAnalyzeForceReloadLuaPlugins->setVisible(false);
 #endif
 
     qRegisterMetaType<FilterAction::Action>("FilterAction::Action");
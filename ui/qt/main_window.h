@@ -550,6 +550,7 @@ private slots:
     void on_actionAnalyzeEnabledProtocols_triggered();
     void on_actionAnalyzeDecodeAs_triggered();
     void on_actionAnalyzeReloadLuaPlugins_triggered();
+    void on_actionAnalyzeForceReloadLuaPlugins_triggered();
 
     void openFollowStreamDialog(follow_type_t type, guint stream_num, bool use_stream_index = true);
     void openFollowStreamDialogForType(follow_type_t type);
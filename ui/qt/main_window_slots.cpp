@@ -179,6 +179,7 @@ bool MainWindow::openCaptureFile(QString cf_path, QString read_filter, unsigned
 {
     QString file_name = "";
     dfilter_t *rfcode = NULL;
+    nstime_t read_start, read_stop;
     gchar *err_msg;
     int err;
     gboolean name_param;
@@ -189,10 +190,18 @@ bool MainWindow::openCaptureFile(QString cf_path, QString read_filter, unsigned
 
     for (;;) {
 
+        nstime_set_unset(&read_start);
+        nstime_set_unset(&read_stop);
         if (cf_path.isEmpty()) {
             CaptureFileDialog open_dlg(this, capture_file_.capFile(), read_filter);
 
             if (open_dlg.open(file_name, type)) {
+                if (!open_dlg.readTimeRange(&read_start, &read_stop)) {
+                    QMessageBox::warning(this, tr("Invalid Time Range"),
+                            tr("The times to read from and to must be given as YYYY-MM-DD hh:mm:ss."),
+                            QMessageBox::Ok);
+                    continue;
+                }
                 cf_path = file_name;
             } else {
                 ret = false;
@@ -248,6 +257,7 @@ bool MainWindow::openCaptureFile(QString cf_path, QString read_filter, unsigned
             cf_path.clear();
             continue;
         }
+        cf_set_read_time_range(CaptureFile::globalCapFile(), &read_start, &read_stop);
 
         switch (cf_read(CaptureFile::globalCapFile(), FALSE)) {
         case CF_READ_OK:
@@ -286,7 +296,14 @@ void MainWindow::filterPackets(QString new_filter, bool force)
 {
     cf_status_t cf_status;
 
-    cf_status = cf_filter_packets(CaptureFile::globalCapFile(), new_filter.toUtf8().data(), force);
+    // Reuse the filter that the filter toolbar compiled while checking it.
+    dfilter_t *dfcode = NULL;
+    DisplayFilterEdit *df_edit = qobject_cast<DisplayFilterEdit *>(df_combo_box_->lineEdit());
+    if (df_edit) {
+        dfcode = df_edit->takeCompiledDisplayFilter(new_filter);
+    }
+
+    cf_status = cf_filter_packets_compiled(CaptureFile::globalCapFile(), new_filter.toUtf8().data(), dfcode, force);
 
     if (cf_status == CF_OK) {
         emit displayFilterSuccess(true);
@@ -745,6 +762,7 @@ void MainWindow::captureFileReadStarted(const QString &action) {
     main_ui_->statusBar->pushFileStatus(msg, msgtip);
     showCapture();
     main_ui_->actionAnalyzeReloadLuaPlugins->setEnabled(false);
+    main_ui_->actionAnalyzeForceReloadLuaPlugins->setEnabled(false);
     main_ui_->wirelessTimelineWidget->captureFileReadStarted(capture_file_.capFile());
 
     WiresharkApplication::processEvents();
@@ -774,6 +792,7 @@ void MainWindow::captureFileReadFinished() {
 
     main_ui_->statusBar->setFileName(capture_file_);
     main_ui_->actionAnalyzeReloadLuaPlugins->setEnabled(true);
+    main_ui_->actionAnalyzeForceReloadLuaPlugins->setEnabled(true);
 
     packet_list_->captureFileReadFinished();
 
@@ -1475,7 +1494,7 @@ void MainWindow::reloadLuaPlugins()
     wsApp->readConfigurationFiles(true);
 
     prefs_apply_all();
-    fieldsChanged();
+    wsApp->emitAppSignal(WiresharkApplication::FieldsChanged);
     redissectPackets();
 
     wsApp->setReloadingLua(false);
@@ -2372,7 +2391,7 @@ void MainWindow::on_actionViewColoringRules_triggered()
 {
     ColoringRulesDialog coloring_rules_dialog(this);
     connect(&coloring_rules_dialog, SIGNAL(accepted()),
-            packet_list_, SLOT(recolorPackets()));
+            packet_list_, SLOT(recolorChangedPackets()));
     connect(&coloring_rules_dialog, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)),
             this, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)));
     coloring_rules_dialog.exec();
@@ -2396,7 +2415,7 @@ void MainWindow::colorizeConversation(bool create_rule)
         if (create_rule) {
             ColoringRulesDialog coloring_rules_dialog(this, filter);
             connect(&coloring_rules_dialog, SIGNAL(accepted()),
-                    packet_list_, SLOT(recolorPackets()));
+                    packet_list_, SLOT(recolorChangedPackets()));
             connect(&coloring_rules_dialog, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)),
                     this, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)));
             coloring_rules_dialog.exec();
@@ -2448,7 +2467,7 @@ void MainWindow::colorizeWithFilter(QByteArray filter, int color_number)
         // New coloring rule
         ColoringRulesDialog coloring_rules_dialog(window(), filter);
         connect(&coloring_rules_dialog, SIGNAL(accepted()),
-            packet_list_, SLOT(recolorPackets()));
+            packet_list_, SLOT(recolorChangedPackets()));
         connect(&coloring_rules_dialog, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)),
             this, SIGNAL(filterAction(QString, FilterAction::Action, FilterAction::ActionType)));
         coloring_rules_dialog.exec();
@@ -2505,7 +2524,11 @@ void MainWindow::openPacketDialog(bool from_reference)
 
     /* If we have a frame, pop up the dialog */
     if (fdata) {
-        PacketDialog *packet_dialog = new PacketDialog(*this, capture_file_, fdata);
+        QStringList col_strings;
+        if (fdata == capture_file_.capFile()->current_frame) {
+            col_strings = packet_list_->selectedColumnStrings();
+        }
+        PacketDialog *packet_dialog = new PacketDialog(*this, capture_file_, fdata, col_strings);
 
         connect(this, SIGNAL(closePacketDialogs()),
                 packet_dialog, SLOT(close()));
@@ -2758,6 +2781,20 @@ void MainWindow::on_actionAnalyzeDecodeAs_triggered()
 }
 
 void MainWindow::on_actionAnalyzeReloadLuaPlugins_triggered()
+{
+#ifdef HAVE_LUA
+    // Reloading means redissecting every packet, which takes a while on
+    // large captures. Don't do it if no script changed. Modules loaded
+    // with require or dofile aren't tracked; Force Reload covers those.
+    if (!wslua_plugins_changed()) {
+        main_ui_->statusBar->pushTemporaryStatus(tr("No Lua plugins changed. Use Force Reload Lua Plugins to reload anyway."));
+        return;
+    }
+#endif
+    reloadLuaPlugins();
+}
+
+void MainWindow::on_actionAnalyzeForceReloadLuaPlugins_triggered()
 {
     reloadLuaPlugins();
 }
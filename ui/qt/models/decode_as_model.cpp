@@ -616,6 +616,28 @@ void DecodeAsModel::gatherChangedEntries(const gchar *table_name,
     }
 }
 
+// TRUE if every rule goes through decode_as_default_change, i.e. only
+// touches a regular dissector table. DCE/RPC and BER keep their own
+// bindings, which dissector_all_tables_foreach_changed can't see.
+bool DecodeAsModel::onlyDefaultChanges() const
+{
+    foreach(DecodeAsItem *item, decode_as_items_) {
+        if (item->selectorDCERPC_ != NULL) {
+            return false;
+        }
+
+        for (GList *cur = decode_as_list; cur; cur = cur->next) {
+            decode_as_t *decode_as_entry = (decode_as_t *) cur->data;
+
+            if (!g_strcmp0(decode_as_entry->table_name, item->tableName_)
+                    && decode_as_entry->change_value != decode_as_default_change) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
 void DecodeAsModel::applyChanges()
 {
     dissector_table_t sub_dissectors;
@@ -78,6 +78,7 @@ public:
     static QString entryString(const gchar *table_name, gconstpointer value);
 
     void applyChanges();
+    bool onlyDefaultChanges() const;
 
 protected:
     static void buildChangedList(const gchar *table_name, ftenum_t selector_type,
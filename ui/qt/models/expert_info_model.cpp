@@ -17,6 +17,7 @@ ExpertPacketItem::ExpertPacketItem(const expert_info_t& expert_info, column_info
     group_(expert_info.group),
     severity_(expert_info.severity),
     hf_id_(expert_info.hf_index),
+    row_(0),
     protocol_(expert_info.protocol),
     summary_(expert_info.summary),
     parentItem_(parent)
@@ -26,6 +27,19 @@ ExpertPacketItem::ExpertPacketItem(const expert_info_t& expert_info, column_info
     }
 }
 
+ExpertPacketItem::ExpertPacketItem(const ExpertPacketItem& other, ExpertPacketItem* parent) :
+    packet_num_(other.packet_num_),
+    group_(other.group_),
+    severity_(other.severity_),
+    hf_id_(other.hf_id_),
+    row_(0),
+    protocol_(other.protocol_),
+    summary_(other.summary_),
+    info_(other.info_),
+    parentItem_(parent)
+{
+}
+
 ExpertPacketItem::~ExpertPacketItem()
 {
     for (int row = 0; row < childItems_.count(); row++)
@@ -36,26 +50,16 @@ ExpertPacketItem::~ExpertPacketItem()
     childItems_.clear();
 }
 
-QString ExpertPacketItem::groupKey(bool group_by_summary, int severity, int group, QString protocol, int expert_hf)
+void ExpertPacketItem::appendChild(ExpertPacketItem* child)
 {
-    QString key = QString("%1|%2|%3")
-            .arg(severity)
-            .arg(group)
-            .arg(protocol);
-    if (group_by_summary) {
-        key += QString("|%1").arg(expert_hf);
-    }
-    return key;
-}
-
-QString ExpertPacketItem::groupKey(bool group_by_summary) {
-    return groupKey(group_by_summary, severity_, group_, protocol_, hf_id_);
+    child->row_ = childItems_.count();
+    childItems_.append(child);
 }
 
-void ExpertPacketItem::appendChild(ExpertPacketItem* child, QString hash)
+void ExpertPacketItem::appendChild(ExpertPacketItem* child, quint64 key)
 {
-    childItems_.append(child);
-    hashChild_[hash] = child;
+    appendChild(child);
+    hashChild_[key] = child;
 }
 
 ExpertPacketItem* ExpertPacketItem::child(int row)
@@ -63,9 +67,9 @@ ExpertPacketItem* ExpertPacketItem::child(int row)
     return childItems_.value(row);
 }
 
-ExpertPacketItem* ExpertPacketItem::child(QString hash)
+ExpertPacketItem* ExpertPacketItem::child(quint64 key)
 {
-    return hashChild_[hash];
+    return hashChild_.value(key, NULL);
 }
 
 int ExpertPacketItem::childCount() const
@@ -75,10 +79,7 @@ int ExpertPacketItem::childCount() const
 
 int ExpertPacketItem::row() const
 {
-    if (parentItem_)
-        return parentItem_->childItems_.indexOf(const_cast<ExpertPacketItem*>(this));
-
-    return 0;
+    return row_;
 }
 
 ExpertPacketItem* ExpertPacketItem::parentItem()
@@ -107,6 +108,9 @@ void ExpertInfoModel::clear()
     emit beginResetModel();
 
     eventCounts_.clear();
+    protocol_ptr_ids_.clear();
+    protocol_name_ids_.clear();
+    protocol_names_.clear();
     delete root_;
     root_ = createRootItem();
 
@@ -123,6 +127,26 @@ ExpertPacketItem* ExpertInfoModel::createRootItem()
 
 
 
+int ExpertInfoModel::protocolId(const char *protocol)
+{
+    if (!protocol) protocol = "";
+
+    int id = protocol_ptr_ids_.value(protocol, -1);
+    if (id >= 0 && protocol_names_.at(id) == protocol) {
+        return id;
+    }
+
+    QByteArray name(protocol);
+    id = protocol_name_ids_.value(name, -1);
+    if (id < 0) {
+        id = protocol_names_.count();
+        protocol_names_.append(name);
+        protocol_name_ids_.insert(name, id);
+    }
+    protocol_ptr_ids_.insert(protocol, id);
+    return id;
+}
+
 int ExpertInfoModel::numEvents(enum ExpertSeverity severity)
 {
     return eventCounts_[severity];
@@ -340,8 +364,7 @@ int ExpertInfoModel::columnCount(const QModelIndex& ) const
 
 void ExpertInfoModel::addExpertInfo(const struct expert_info_s& expert_info)
 {
-    QString groupKey = ExpertPacketItem::groupKey(FALSE, expert_info.severity, expert_info.group, QString(expert_info.protocol), expert_info.hf_index);
-    QString summaryKey = ExpertPacketItem::groupKey(TRUE, expert_info.severity, expert_info.group, QString(expert_info.protocol), expert_info.hf_index);
+    quint64 groupKey = ExpertPacketItem::groupKey(expert_info.severity, expert_info.group, protocolId(expert_info.protocol));
 
     ExpertPacketItem* expert_root = root_->child(groupKey);
     if (expert_root == NULL) {
@@ -353,22 +376,24 @@ void ExpertInfoModel::addExpertInfo(const struct expert_info_s& expert_info)
     }
 
     ExpertPacketItem *expert = new ExpertPacketItem(expert_info, &(capture_file_.capFile()->cinfo), expert_root);
-    expert_root->appendChild(expert, groupKey);
+    expert_root->appendChild(expert);
 
     //add the summary children off of the first child of the root children
     ExpertPacketItem* summary_root = expert_root->child(0);
 
-    //make a summary child
+    //make a summary child. Its siblings share the group key, so the
+    //hf index alone identifies it.
+    quint64 summaryKey = (guint32) expert_info.hf_index;
     ExpertPacketItem* expert_summary_root = summary_root->child(summaryKey);
     if (expert_summary_root == NULL) {
-        ExpertPacketItem *new_summary = new ExpertPacketItem(expert_info, &(capture_file_.capFile()->cinfo), summary_root);
+        ExpertPacketItem *new_summary = new ExpertPacketItem(*expert, summary_root);
 
         summary_root->appendChild(new_summary, summaryKey);
         expert_summary_root = new_summary;
     }
 
-    ExpertPacketItem *expert_summary = new ExpertPacketItem(expert_info, &(capture_file_.capFile()->cinfo), expert_summary_root);
-    expert_summary_root->appendChild(expert_summary, summaryKey);
+    ExpertPacketItem *expert_summary = new ExpertPacketItem(*expert, expert_summary_root);
+    expert_summary_root->appendChild(expert_summary);
 }
 
 void ExpertInfoModel::tapReset(void *eid_ptr)
@@ -27,6 +27,8 @@ class ExpertPacketItem
 {
 public:
     ExpertPacketItem(const expert_info_t& expert_info, column_info *cinfo, ExpertPacketItem* parent);
+    // Shares other's strings.
+    ExpertPacketItem(const ExpertPacketItem& other, ExpertPacketItem* parent);
     virtual ~ExpertPacketItem();
 
     unsigned int packetNum() const { return packet_num_; }
@@ -37,12 +39,14 @@ public:
     QString summary() const { return summary_; }
     QString colInfo() const { return info_; }
 
-    static QString groupKey(bool group_by_summary, int severity, int group, QString protocol, int expert_hf);
-    QString groupKey(bool group_by_summary);
+    // Severity and group use separate bits, so together with a protocol ID
+    // they make a unique integer key.
+    static quint64 groupKey(int severity, int group, int protocol_id) { return ((quint64) protocol_id << 32) | (guint32) (severity | group); }
 
-    void appendChild(ExpertPacketItem* child, QString hash);
+    void appendChild(ExpertPacketItem* child);
+    void appendChild(ExpertPacketItem* child, quint64 key);
     ExpertPacketItem* child(int row);
-    ExpertPacketItem* child(QString hash);
+    ExpertPacketItem* child(quint64 key);
     int childCount() const;
     int row() const;
     ExpertPacketItem* parentItem();
@@ -52,6 +56,7 @@ private:
     int group_;
     int severity_;
     int hf_id_;
+    int row_;
     // Half-hearted attempt at conserving memory. If this isn't sufficient,
     // PacketListRecord interns column strings in a GStringChunk.
     QByteArray protocol_;
@@ -60,7 +65,7 @@ private:
 
     QList<ExpertPacketItem*> childItems_;
     ExpertPacketItem* parentItem_;
-    QHash<QString, ExpertPacketItem*> hashChild_;    //optimization for insertion
+    QHash<quint64, ExpertPacketItem*> hashChild_;    //optimization for insertion
 };
 
 class ExpertInfoModel : public QAbstractItemModel
@@ -120,11 +125,18 @@ private:
     CaptureFile& capture_file_;
 
     ExpertPacketItem* createRootItem();
+    int protocolId(const char *protocol);
 
     bool group_by_summary_;
     ExpertPacketItem* root_;
 
     QHash<enum ExpertSeverity, int> eventCounts_;
+
+    // Protocol names are usually static strings, so look them up by
+    // address first.
+    QHash<const char *, int> protocol_ptr_ids_;
+    QHash<QByteArray, int> protocol_name_ids_;
+    QList<QByteArray> protocol_names_;
 };
 #endif // EXPERT_INFO_MODEL_H
 
@@ -14,6 +14,8 @@
 #include <ui/qt/utils/variant_pointer.h>
 #include <ui/export_object_ui.h>
 
+#include <QHash>
+
 extern "C" {
 
 static void
@@ -158,6 +160,11 @@ void ExportObjectModel::saveAllEntries(QString path)
         return;
 
     export_object_entry_t *entry;
+    QByteArray path_utf8 = path.toUtf8();
+    // Many objects often share a name (e.g. "index.html"). Remember the
+    // next suffix to try for each name so that every entry doesn't probe
+    // the files we saved right before it.
+    QHash<QString, int> next_count;
 
     for (QList<QVariant>::iterator it = objects_.begin(); it != objects_.end(); ++it)
     {
@@ -165,30 +172,31 @@ void ExportObjectModel::saveAllEntries(QString path)
         if (entry == NULL)
             continue;
 
-        int count = 0;
+        char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
+        const char *name = entry->filename;
         gchar *save_as_fullpath = NULL;
 
+        if (!name) {
+            const char *ext;
+            ext = eo_ct2ext(entry->content_type);
+            g_snprintf(generic_name, sizeof(generic_name),
+                "object%u%s%s", entry->pkt_num, ext ? "." : "",
+                ext ? ext : "");
+            name = generic_name;
+        }
+
+        int &count = next_count[QString::fromUtf8(name)];
         do {
             GString *safe_filename;
 
             g_free(save_as_fullpath);
-            if (entry->filename)
-                safe_filename = eo_massage_str(entry->filename,
-                    EXPORT_OBJECT_MAXFILELEN, count);
-            else {
-                char generic_name[EXPORT_OBJECT_MAXFILELEN+1];
-                const char *ext;
-                ext = eo_ct2ext(entry->content_type);
-                g_snprintf(generic_name, sizeof(generic_name),
-                    "object%u%s%s", entry->pkt_num, ext ? "." : "",
-                    ext ? ext : "");
-                safe_filename = eo_massage_str(generic_name,
-                    EXPORT_OBJECT_MAXFILELEN, count);
-            }
-            save_as_fullpath = g_build_filename(path.toUtf8().constData(),
+            safe_filename = eo_massage_str(name, EXPORT_OBJECT_MAXFILELEN, count);
+            save_as_fullpath = g_build_filename(path_utf8.constData(),
                                                 safe_filename->str, NULL);
             g_string_free(safe_filename, TRUE);
         } while (g_file_test(save_as_fullpath, G_FILE_TEST_EXISTS) && ++count < 1000);
+        if (count < 1000)
+            count++;
         eo_save_entry(save_as_fullpath, entry);
         g_free(save_as_fullpath);
         save_as_fullpath = NULL;
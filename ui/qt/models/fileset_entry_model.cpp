@@ -66,8 +66,11 @@ QVariant FilesetEntryModel::data(const QModelIndex &index, int role) const
             return created;
         }
         case Modified:
+            // Files are only stat'ed once they're shown
+            fileset_stat_entry(const_cast<fileset_entry *>(entry));
             return time_tToString(entry->mtime);
         case Size:
+            fileset_stat_entry(const_cast<fileset_entry *>(entry));
             return file_size_to_qstring(entry->size);
         default:
             break;
@@ -33,6 +33,9 @@
 
 const QString InterfaceTreeModel::DefaultNumericValue = QObject::tr("default");
 
+/* Statistics points kept per interface; more than a sparkline can show */
+#define IFTREE_STAT_MAX_POINTS 1000
+
 /**
  * This is the data model for interface trees. It implies, that the index within
  * global_capture_opts.all_ifaces is identical to the row. This is always the case, even
@@ -337,6 +340,7 @@ void InterfaceTreeModel::interfaceListChanged()
     emit beginResetModel();
 
     points.clear();
+    zero_points.clear();
 
     emit endResetModel();
 }
@@ -433,8 +437,20 @@ void InterfaceTreeModel::updateStatistic(unsigned int idx)
         device->last_packets = stats.ps_recv;
     }
 
-    points[device->name].append(diff);
-    emit dataChanged(index(idx, IFTREE_COL_STATS), index(idx, IFTREE_COL_STATS));
+    PointList &dev_points = points[device->name];
+    int &dev_zero_points = zero_points[device->name];
+
+    // A sparkline row that has been idle for its whole history looks
+    // the same after one more idle point, so don't repaint it.
+    bool changed = (diff != 0 || dev_zero_points < dev_points.length());
+
+    dev_points.append(diff);
+    while ( dev_points.length() > IFTREE_STAT_MAX_POINTS )
+        dev_points.removeFirst();
+    dev_zero_points = (diff == 0) ? qMin(dev_zero_points + 1, IFTREE_STAT_MAX_POINTS) : 0;
+
+    if ( changed )
+        emit dataChanged(index(idx, IFTREE_COL_STATS), index(idx, IFTREE_COL_STATS));
 #else
     Q_UNUSED(idx)
 #endif
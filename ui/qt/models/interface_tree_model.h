@@ -90,6 +90,7 @@ protected slots:
 private:
     QVariant toolTipForInterface(int idx) const;
     QMap<QString, PointList> points;
+    QMap<QString, int> zero_points; /* trailing points with no packets, per interface */
 
 #ifdef HAVE_LIBPCAP
     if_stat_cache_t *stat_cache_;
@@ -16,6 +16,7 @@
 
 #include <wsutil/nstime.h>
 #include <epan/column.h>
+#include <epan/column-utils.h>
 #include <epan/prefs.h>
 
 #include "ui/packet_list_utils.h"
@@ -31,7 +32,7 @@
 #include <QElapsedTimer>
 #include <QFontMetrics>
 #include <QModelIndex>
-#include <QElapsedTimer>
+#include <QTimer>
 
 // Print timing information
 //#define DEBUG_PACKET_LIST_MODEL 1
@@ -41,13 +42,25 @@
 #endif
 
 static const int reserved_packets_ = 100000;
+// How long to queue appended rows before inserting them into the model.
+// Each insertion makes the view update its geometry and scroll bars, so
+// doing it for every event loop iteration during a fast capture is costly.
+static const int flush_interval_ = 100; // ms
 
 PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     QAbstractItemModel(parent),
     number_to_row_(QVector<int>()),
     max_row_height_(0),
     max_line_count_(1),
-    idle_dissection_row_(0)
+    sorted_row_count_(0),
+    sorted_column_(-1),
+    sorted_order_(Qt::AscendingOrder),
+    sorted_data_ver_(0),
+    sorting_(false),
+    idle_dissection_row_(0),
+    string_cache_pool_(NULL),
+    string_cache_ver_(0),
+    string_cache_trim_queued_(false)
 {
     setCaptureFile(cf);
 
@@ -59,9 +72,18 @@ PacketListModel::PacketListModel(QObject *parent, capture_file *cf) :
     connect(this, &PacketListModel::maxLineCountChanged,
             this, &PacketListModel::emitItemHeightChanged,
             Qt::QueuedConnection);
+    connect(this, &PacketListModel::columnStringCacheFull,
+            this, &PacketListModel::trimColumnStringCache,
+            Qt::QueuedConnection);
     idle_dissection_timer_ = new QElapsedTimer();
 
+    flush_timer_ = new QTimer(this);
+    flush_timer_->setSingleShot(true);
+    flush_timer_->setInterval(flush_interval_);
+    connect(flush_timer_, &QTimer::timeout, this, &PacketListModel::flushVisibleRows);
+
     string_cache_pool_ = g_string_chunk_new(1 * 1024 * 1024);
+    string_cache_ver_ = PacketListRecord::columnDataVersion();
 }
 
 PacketListModel::~PacketListModel()
@@ -100,22 +122,33 @@ int PacketListModel::packetNumberToRow(int packet_num) const
     return number_to_row_.value(packet_num) - 1;
 }
 
+// number_to_row_ stores 1-based rows so that its default value (0) can
+// mean "not visible".
+void PacketListModel::setNumberToRow(guint32 num, int row)
+{
+    if (number_to_row_.size() <= (int)num) {
+        // Grow geometrically. Frame numbers arrive in order during a live
+        // capture, so growing by a fixed amount reallocates over and over.
+        number_to_row_.resize(qMax((int)num + 1, number_to_row_.size() * 2));
+    }
+    number_to_row_[num] = row + 1;
+}
+
 guint PacketListModel::recreateVisibleRows()
 {
     beginResetModel();
     visible_rows_.resize(0);
-    number_to_row_.fill(0);
+    // Every frame has a physical row, so this covers all frame numbers.
+    number_to_row_.fill(0, physical_rows_.count() + 1);
     endResetModel();
+    sorted_row_count_ = 0;
 
     foreach (PacketListRecord *record, physical_rows_) {
         frame_data *fdata = record->frameData();
 
         if (fdata->passed_dfilter || fdata->ref_time) {
             visible_rows_ << record;
-            if (number_to_row_.size() <= (int)fdata->num) {
-                number_to_row_.resize(fdata->num + 10000);
-            }
-            number_to_row_[fdata->num] = visible_rows_.count();
+            setNumberToRow(fdata->num, visible_rows_.count() - 1);
         }
     }
     if (!visible_rows_.isEmpty()) {
@@ -133,24 +166,90 @@ void PacketListModel::clear() {
     visible_rows_.resize(0);
     new_visible_rows_.resize(0);
     number_to_row_.resize(0);
-    g_string_chunk_clear(string_cache_pool_);
+    PacketListRecord::invalidateAllRecords();
+    releaseStaleColumnStrings();
     endResetModel();
     max_row_height_ = 0;
     max_line_count_ = 1;
     idle_dissection_row_ = 0;
+    sorted_row_count_ = 0;
 }
 
 void PacketListModel::invalidateAllColumnStrings()
 {
     PacketListRecord::invalidateAllRecords();
+    releaseStaleColumnStrings();
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
     headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
 }
 
+// Cached column strings are only used while their record's data version
+// matches the current one. Once the version changes every record has to
+// redissect before it can return text again, so the old strings can be
+// freed. This must be called right after the version changes.
+void PacketListModel::releaseStaleColumnStrings()
+{
+    if (!string_cache_pool_ || string_cache_ver_ == PacketListRecord::columnDataVersion()) {
+        return;
+    }
+    g_string_chunk_clear(string_cache_pool_);
+    string_cache_ver_ = PacketListRecord::columnDataVersion();
+}
+
+bool PacketListModel::columnStringCacheOverLimit() const
+{
+    return prefs.gui_packet_list_cached_rows_max > 0
+            && PacketListRecord::cachedRowCount() > prefs.gui_packet_list_cached_rows_max;
+}
+
+// Most recently used rows first
+bool PacketListModel::recordUsedLater(const PacketListRecord *r1, const PacketListRecord *r2)
+{
+    return r1->lastUsed() > r2->lastUsed();
+}
+
+// Once more rows than the user allows have been cached, drop the column
+// text of the least recently used ones until a quarter of the limit is
+// free again, so that we don't trim again on the next few rows. Evicted
+// rows are dissected again when they are requested. Other rows, sort
+// keys and colorization are kept. Strings can't be removed from a
+// GStringChunk, so the kept ones are copied to a new pool.
+void PacketListModel::trimColumnStringCache()
+{
+    string_cache_trim_queued_ = false;
+    if (sorting_ || !columnStringCacheOverLimit()) {
+        return;
+    }
+
+    QVector<PacketListRecord *> cached_rows;
+    foreach (PacketListRecord *record, physical_rows_) {
+        if (record->hasCachedColumnStrings()) {
+            cached_rows << record;
+        }
+    }
+
+    int keep = qMin((int) (prefs.gui_packet_list_cached_rows_max - prefs.gui_packet_list_cached_rows_max / 4),
+                    cached_rows.count());
+    std::nth_element(cached_rows.begin(), cached_rows.begin() + keep, cached_rows.end(),
+                     recordUsedLater);
+
+    struct _GStringChunk *old_pool = string_cache_pool_;
+    string_cache_pool_ = g_string_chunk_new(1 * 1024 * 1024);
+    for (int i = 0; i < cached_rows.count(); i++) {
+        if (i < keep) {
+            cached_rows[i]->recacheColumnStrings();
+        } else {
+            cached_rows[i]->releaseColumnStrings();
+        }
+    }
+    g_string_chunk_free(old_pool);
+}
+
 void PacketListModel::resetColumns()
 {
     if (cap_file_) {
         PacketListRecord::resetColumns(&cap_file_->cinfo);
+        releaseStaleColumnStrings();
     }
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
     headerDataChanged(Qt::Horizontal, 0, columnCount() - 1);
@@ -164,6 +263,14 @@ void PacketListModel::resetColorized()
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
+void PacketListModel::resetChangedColorized()
+{
+    foreach (PacketListRecord *record, physical_rows_) {
+        record->resetChangedColorized();
+    }
+    dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
+}
+
 void PacketListModel::toggleFrameMark(const QModelIndex &fm_index)
 {
     if (!cap_file_ || !fm_index.isValid()) return;
@@ -244,6 +351,7 @@ void PacketListModel::toggleFrameRefTime(const QModelIndex &rt_index)
         cap_file_->displayed_count--;
     }
     record->resetColumns(&cap_file_->cinfo);
+    releaseStaleColumnStrings();
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
@@ -262,12 +370,22 @@ void PacketListModel::unsetAllFrameRefTime()
     cap_file_->ref_time_count = 0;
     cf_reftime_packets(cap_file_);
     PacketListRecord::resetColumns(&cap_file_->cinfo);
+    releaseStaleColumnStrings();
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
 void PacketListModel::applyTimeShift()
 {
-    resetColumns();
+    // Custom columns can show frame.time fields, which only a dissection
+    // fills in. Otherwise only the time columns changed, and they are set
+    // from frame data as rows are displayed.
+    if (!cap_file_ || have_custom_cols(&cap_file_->cinfo)) {
+        resetColumns();
+    } else {
+        PacketListRecord::invalidateFrameDataColumns();
+        // Adjusting times can change their order; sort again next time.
+        sorted_row_count_ = 0;
+    }
     dataChanged(index(0, 0), index(rowCount() - 1, columnCount() - 1));
 }
 
@@ -300,6 +418,7 @@ capture_file *PacketListModel::sort_cap_file_;
 
 QElapsedTimer busy_timer_;
 const int busy_timeout_ = 65; // ms, approximately 15 fps
+const int sort_chunk_size_ = 4096; // rows
 void PacketListModel::sort(int column, Qt::SortOrder order)
 {
     // packet_list_store.c:packet_list_dissect_and_cache_all
@@ -314,62 +433,208 @@ void PacketListModel::sort(int column, Qt::SortOrder order)
     gboolean stop_flag = FALSE;
     QString col_title = get_column_title(column);
 
+    // recordLessThan needs the text of every row, so don't trim the
+    // column string cache until we're done.
+    sorting_ = true;
     busy_timer_.start();
-    emit pushProgressStatus(tr("Dissecting"), true, true, &stop_flag);
-    int row_num = 0;
-    foreach (PacketListRecord *row, physical_rows_) {
-        row->columnString(sort_cap_file_, column);
-        row_num++;
-        if (busy_timer_.elapsed() > busy_timeout_) {
-            if (stop_flag) {
-                emit popProgressStatus();
-                return;
+    sort_column_is_numeric_ = isNumericColumn(sort_column_);
+
+    // Columns based on frame data are compared using frame_data_compare
+    // in recordLessThan, so there's no need to dissect anything for them.
+    if (text_sort_column_ >= 0) {
+        emit pushProgressStatus(tr("Dissecting"), true, true, &stop_flag);
+        int row_num = 0;
+        foreach (PacketListRecord *row, physical_rows_) {
+            // Only records without cached column text need dissecting.
+            if (!row->columnStringCached(column)) {
+                row->columnString(sort_cap_file_, column);
+            }
+            // Parse numeric values once here instead of in every comparison.
+            if (sort_column_is_numeric_) {
+                bool ok;
+                double num = parseNumericColumn(row->columnString(sort_cap_file_, column).constData(), &ok);
+                row->setNumericSortKey(num, ok);
+            }
+            row_num++;
+            if (busy_timer_.elapsed() > busy_timeout_) {
+                if (stop_flag) {
+                    emit popProgressStatus();
+                    sorting_ = false;
+                    return;
+                }
+                emit updateProgressStatus(row_num * 100 / physical_rows_.count());
+                // What's the least amount of processing that we can do which will draw
+                // the progress indicator?
+                wsApp->processEvents(QEventLoop::AllEvents, 1);
+                busy_timer_.restart();
             }
-            emit updateProgressStatus(row_num * 100 / physical_rows_.count());
-            // What's the least amount of processing that we can do which will draw
-            // the progress indicator?
-            wsApp->processEvents(QEventLoop::AllEvents, 1);
-            busy_timer_.restart();
         }
+        emit popProgressStatus();
     }
-    emit popProgressStatus();
 
-    // XXX Use updateProgress instead. We'd have to switch from std::sort to
-    // something we can interrupt.
-    if (!col_title.isEmpty()) {
-        QString busy_msg = tr("Sorting \"%1\"").arg(col_title);
-        emit pushBusyStatus(busy_msg);
-    }
+    QString sort_msg = col_title.isEmpty() ? tr("Sorting") : tr("Sorting \"%1\"").arg(col_title);
+    emit pushProgressStatus(sort_msg, true, true, &stop_flag);
 
     busy_timer_.restart();
-    sort_column_is_numeric_ = isNumericColumn(sort_column_);
-    std::sort(physical_rows_.begin(), physical_rows_.end(), recordLessThan);
+
+    // If the previous sort used the same key and rows have only been
+    // appended since then, the leading rows are already in order.
+    int sorted_count = 0;
+    if (column == sorted_column_ && order == sorted_order_
+            && sorted_data_ver_ == PacketListRecord::columnDataVersion()
+            && sorted_row_count_ <= physical_rows_.count()) {
+        sorted_count = sorted_row_count_;
+    }
+
+    // Sort a copy so that physical_rows_ is left untouched if we're stopped.
+    QVector<PacketListRecord *> sorted_rows = physical_rows_;
+    if (!sortRows(sorted_rows, sorted_count, &stop_flag)
+            || sorted_rows.count() > physical_rows_.count()) {
+        emit popProgressStatus();
+        sorting_ = false;
+        return;
+    }
+    emit popProgressStatus();
+
+    // Packets might have been appended while we were processing events.
+    int new_rows = physical_rows_.count() - sorted_rows.count();
+    sorted_rows += physical_rows_.mid(sorted_rows.count());
+    physical_rows_.swap(sorted_rows);
+    sorted_row_count_ = physical_rows_.count() - new_rows;
+    sorted_column_ = column;
+    sorted_order_ = order;
+    sorted_data_ver_ = PacketListRecord::columnDataVersion();
 
     beginResetModel();
     visible_rows_.resize(0);
-    number_to_row_.fill(0);
+    number_to_row_.fill(0, physical_rows_.count() + 1);
     foreach (PacketListRecord *record, physical_rows_) {
         frame_data *fdata = record->frameData();
 
         if (fdata->passed_dfilter || fdata->ref_time) {
             visible_rows_ << record;
-            if (number_to_row_.size() <= (int)fdata->num) {
-                number_to_row_.resize(fdata->num + 10000);
-            }
-            number_to_row_[fdata->num] = visible_rows_.count();
+            setNumberToRow(fdata->num, visible_rows_.count() - 1);
         }
     }
     endResetModel();
 
-    if (!col_title.isEmpty()) {
-        emit popBusyStatus();
-    }
+    sorting_ = false;
+    trimColumnStringCache();
 
     if (cap_file_->current_frame) {
         emit goToPacket(cap_file_->current_frame->num);
     }
 }
 
+// Report sort progress and process events if enough time has passed.
+// Returns false if the user asked us to stop.
+bool PacketListModel::sortProgress(qint64 work_done, qint64 work_total, gboolean *stop_flag)
+{
+    if (busy_timer_.elapsed() > busy_timeout_) {
+        if (*stop_flag) {
+            return false;
+        }
+        if (work_total > 0) {
+            emit updateProgressStatus(int(work_done * 100 / work_total));
+        }
+        // What's the least amount of processing that we can do which will draw
+        // the progress indicator?
+        wsApp->processEvents(QEventLoop::AllEvents, 1);
+        busy_timer_.restart();
+    }
+    return !*stop_flag;
+}
+
+// Merge the sorted runs [first, middle) and [middle, last) into out,
+// checking for progress and cancellation along the way.
+bool PacketListModel::mergeRuns(PacketListRecord **first, PacketListRecord **middle, PacketListRecord **last,
+                                PacketListRecord **out, qint64 *work_done, qint64 work_total, gboolean *stop_flag)
+{
+    PacketListRecord **left = first;
+    PacketListRecord **right = middle;
+    int count = 0;
+
+    while (left < middle && right < last) {
+        // Take from the left run on ties so that the merge is stable.
+        if (recordLessThan(*right, *left)) {
+            *out++ = *right++;
+        } else {
+            *out++ = *left++;
+        }
+        if (++count % sort_chunk_size_ == 0) {
+            *work_done += sort_chunk_size_;
+            if (!sortProgress(*work_done, work_total, stop_flag)) {
+                return false;
+            }
+        }
+    }
+    *work_done += count % sort_chunk_size_ + (middle - left) + (last - right);
+    out = std::copy(left, middle, out);
+    std::copy(right, last, out);
+    return true;
+}
+
+// A bottom-up merge sort which can be interrupted. Chunks of
+// sort_chunk_size_ rows are sorted using std::sort and then merged
+// pairwise. Rows in [0, sorted_count) must already be in order; only the
+// remaining rows are sorted, after which they're merged with the rest.
+bool PacketListModel::sortRows(QVector<PacketListRecord *> &rows, int sorted_count, gboolean *stop_flag)
+{
+    int row_count = rows.count();
+    int tail_count = row_count - sorted_count;
+    if (tail_count < 1) {
+        return true;
+    }
+
+    QVector<PacketListRecord *> scratch(row_count);
+    PacketListRecord **src = rows.data();
+    PacketListRecord **dst = scratch.data();
+
+    // One unit of work per row per pass.
+    qint64 work_total = tail_count;
+    for (int width = sort_chunk_size_; width < tail_count; width *= 2) {
+        work_total += tail_count;
+    }
+    if (sorted_count > 0) {
+        work_total += row_count;
+    }
+    qint64 work_done = 0;
+
+    for (int start = sorted_count; start < row_count; start += sort_chunk_size_) {
+        int end = qMin(start + sort_chunk_size_, row_count);
+        std::sort(src + start, src + end, recordLessThan);
+        work_done += end - start;
+        if (!sortProgress(work_done, work_total, stop_flag)) {
+            return false;
+        }
+    }
+
+    // Merges only write past sorted_count, so copying the prefix once is enough.
+    std::copy(src, src + sorted_count, dst);
+    for (int width = sort_chunk_size_; width < tail_count; width *= 2) {
+        for (int start = sorted_count; start < row_count; start += 2 * width) {
+            int middle = qMin(start + width, row_count);
+            int end = qMin(start + 2 * width, row_count);
+            if (!mergeRuns(src + start, src + middle, src + end, dst + start, &work_done, work_total, stop_flag)) {
+                return false;
+            }
+        }
+        std::swap(src, dst);
+    }
+
+    if (sorted_count > 0) {
+        if (!mergeRuns(src, src + sorted_count, src + row_count, dst, &work_done, work_total, stop_flag)) {
+            return false;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != rows.data()) {
+        rows.swap(scratch);
+    }
+    return true;
+}
+
 bool PacketListModel::isNumericColumn(int column)
 {
     if (column < 0) {
@@ -445,12 +710,6 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
     // _packet_list_compare_records, and packet_list_compare_custom from
     // gtk/packet_list_store.c into one function
 
-    if (busy_timer_.elapsed() > busy_timeout_) {
-        // What's the least amount of processing that we can do which will draw
-        // the busy indicator?
-        wsApp->processEvents(QEventLoop::ExcludeUserInputEvents | QEventLoop::ExcludeSocketNotifiers, 1);
-        busy_timer_.restart();
-    }
     if (sort_column_ < 0) {
         // No column.
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), COL_NUMBER);
@@ -458,15 +717,13 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
         // Column comes directly from frame data
         cmp_val = frame_data_compare(sort_cap_file_->epan, r1->frameData(), r2->frameData(), sort_cap_file_->cinfo.columns[sort_column_].col_fmt);
     } else  {
-        if (r1->columnString(sort_cap_file_, sort_column_).constData() == r2->columnString(sort_cap_file_, sort_column_).constData()) {
-            cmp_val = 0;
-        } else if (sort_column_is_numeric_) {
+        if (sort_column_is_numeric_) {
             // Custom column with numeric data (or something like a port number).
-            // Attempt to convert to numbers.
-            // XXX This is slow. Can we avoid doing this?
-            bool ok_r1, ok_r2;
-            double num_r1 = parseNumericColumn(r1->columnString(sort_cap_file_, sort_column_), &ok_r1);
-            double num_r2 = parseNumericColumn(r2->columnString(sort_cap_file_, sort_column_), &ok_r2);
+            // The values were converted to numbers by sort() beforehand.
+            bool ok_r1 = r1->numericSortKeyValid();
+            bool ok_r2 = r2->numericSortKeyValid();
+            double num_r1 = r1->numericSortKey();
+            double num_r2 = r2->numericSortKey();
 
             if (!ok_r1 && !ok_r2) {
                 cmp_val = 0;
@@ -477,6 +734,8 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
             } else if (!ok_r2 || (ok_r1 && num_r1 > num_r2)) {
                 cmp_val = 1;
             }
+        } else if (r1->columnString(sort_cap_file_, sort_column_).constData() == r2->columnString(sort_cap_file_, sort_column_).constData()) {
+            cmp_val = 0;
         } else {
             cmp_val = strcmp(r1->columnString(sort_cap_file_, sort_column_).constData(), r2->columnString(sort_cap_file_, sort_column_).constData());
         }
@@ -497,10 +756,8 @@ bool PacketListModel::recordLessThan(PacketListRecord *r1, PacketListRecord *r2)
 // Parses a field as a double. Handle values with suffixes ("12ms"), negative
 // values ("-1.23") and fields with multiple occurrences ("1,2"). Marks values
 // that do not contain any numeric value ("Unknown") as invalid.
-double PacketListModel::parseNumericColumn(const QString &val, bool *ok)
+double PacketListModel::parseNumericColumn(const char *strval, bool *ok)
 {
-    QByteArray ba = val.toUtf8();
-    const char *strval = ba.constData();
     gchar *end = NULL;
     double num = g_ascii_strtod(strval, &end);
     *ok = strval != end;
@@ -603,6 +860,11 @@ QVariant PacketListModel::data(const QModelIndex &d_index, int role) const
         if (column == 0 && record->lineCountChanged() && record->lineCount() > max_line_count_) {
             emit maxLineCountChanged(d_index);
         }
+        // Queue a single trim when we cross the limit.
+        if (!string_cache_trim_queued_ && columnStringCacheOverLimit()) {
+            string_cache_trim_queued_ = true;
+            emit columnStringCacheFull();
+        }
         return column_string;
     }
     case Qt::SizeHintRole:
@@ -648,16 +910,12 @@ void PacketListModel::flushVisibleRows()
 {
     gint pos = visible_rows_.count();
 
+    flush_timer_->stop();
     if (new_visible_rows_.count() > 0) {
-        beginInsertRows(QModelIndex(), pos, pos + new_visible_rows_.count());
-        foreach (PacketListRecord *record, new_visible_rows_) {
-            frame_data *fdata = record->frameData();
-
-            visible_rows_ << record;
-            if (number_to_row_.size() <= (int)fdata->num) {
-                number_to_row_.resize(fdata->num + 10000);
-            }
-            number_to_row_[fdata->num] = visible_rows_.count();
+        beginInsertRows(QModelIndex(), pos, pos + new_visible_rows_.count() - 1);
+        visible_rows_ += new_visible_rows_;
+        for (int row = pos; row < visible_rows_.count(); row++) {
+            setNumberToRow(visible_rows_[row]->frameData()->num, row);
         }
         endInsertRows();
         new_visible_rows_.resize(0);
@@ -680,13 +938,15 @@ void PacketListModel::dissectIdle(bool reset)
 
     int first = idle_dissection_row_;
     while (idle_dissection_timer_->elapsed() < idle_dissection_interval_
-           && idle_dissection_row_ < physical_rows_.count()) {
+           && idle_dissection_row_ < visible_rows_.count()) {
         ensureRowColorized(idle_dissection_row_);
         idle_dissection_row_++;
 //        if (idle_dissection_row_ % 1000 == 0) qDebug() << "=di row" << idle_dissection_row_;
     }
 
-    if (idle_dissection_row_ < physical_rows_.count()) {
+    trimColumnStringCache();
+
+    if (idle_dissection_row_ < visible_rows_.count()) {
         QTimer::singleShot(idle_dissection_interval_, this, SLOT(dissectIdle()));
     } else {
         idle_dissection_timer_->invalidate();
@@ -700,7 +960,7 @@ void PacketListModel::dissectIdle(bool reset)
 // line counts?
 gint PacketListModel::appendPacket(frame_data *fdata)
 {
-    PacketListRecord *record = new PacketListRecord(fdata, string_cache_pool_);
+    PacketListRecord *record = new PacketListRecord(fdata, &string_cache_pool_);
     gint pos = -1;
 
 #ifdef DEBUG_PACKET_LIST_MODEL
@@ -713,10 +973,10 @@ gint PacketListModel::appendPacket(frame_data *fdata)
 
     if (fdata->passed_dfilter || fdata->ref_time) {
         new_visible_rows_ << record;
-        if (new_visible_rows_.count() < 2) {
-            // This is the first queued packet. Schedule an insertion for
-            // the next UI update.
-            QTimer::singleShot(0, this, SLOT(flushVisibleRows()));
+        if (!flush_timer_->isActive()) {
+            // This is the first queued packet. Schedule an insertion,
+            // which will pick up any packets appended in the meantime.
+            flush_timer_->start();
         }
         pos = visible_rows_.count() + new_visible_rows_.count() - 1;
     }
@@ -740,24 +1000,43 @@ void PacketListModel::ensureRowColorized(int row)
     PacketListRecord *record = visible_rows_[row];
     if (!record)
         return;
-    if (!record->colorized()) {
-        record->columnString(cap_file_, 1, true);
-    }
+    // Colorizing doesn't require column text, which saves us from
+    // filling in and caching the columns of every row we touch here.
+    record->colorize(cap_file_);
 }
 
 int PacketListModel::visibleIndexOf(frame_data *fdata) const
 {
-    int row = 0;
-    foreach (PacketListRecord *record, visible_rows_) {
-        if (record->frameData() == fdata) {
-            return row;
-        }
-        row++;
+    if (!fdata) return -1;
+
+    int row = packetNumberToRow(fdata->num);
+    if (row >= 0 && row < visible_rows_.count() && visible_rows_[row]->frameData() == fdata) {
+        return row;
     }
 
     return -1;
 }
 
+const QString PacketListModel::longestCachedColumnString(int column, int max_rows) const
+{
+    int step = qMax(1, visible_rows_.count() / qMax(1, max_rows));
+    const char *longest = NULL;
+    size_t longest_len = 0;
+
+    for (int row = 0; row < visible_rows_.count(); row += step) {
+        const char *text = visible_rows_[row]->cachedColumnString(column);
+        if (text) {
+            size_t len = strlen(text);
+            if (len > longest_len) {
+                longest = text;
+                longest_len = len;
+            }
+        }
+    }
+
+    return longest ? QString::fromUtf8(longest) : QString();
+}
+
 /*
  * Editor modelines
  *
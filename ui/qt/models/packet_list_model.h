@@ -27,6 +27,7 @@
 #include "cfile.h"
 
 class QElapsedTimer;
+class QTimer;
 
 class PacketListModel : public QAbstractItemModel
 {
@@ -52,6 +53,13 @@ public:
     frame_data *getRowFdata(int row);
     void ensureRowColorized(int row);
     int visibleIndexOf(frame_data *fdata) const;
+    /**
+     * @brief Return the longest cached text of a column.
+     *
+     * Looks at up to max_rows rows spread over the list. Rows whose text
+     * isn't cached are skipped instead of being dissected.
+     */
+    const QString longestCachedColumnString(int column, int max_rows) const;
     /**
      * @brief Invalidate any cached column strings.
      */
@@ -61,6 +69,8 @@ public:
      */
     void resetColumns();
     void resetColorized();
+    // Like resetColorized, after color_filters_apply.
+    void resetChangedColorized();
     void toggleFrameMark(const QModelIndex &fm_index);
     void setDisplayedFrameMark(gboolean set);
     void toggleFrameIgnore(const QModelIndex &i_index);
@@ -74,6 +84,7 @@ public:
 signals:
     void goToPacket(int);
     void maxLineCountChanged(const QModelIndex &ih_index) const;
+    void columnStringCacheFull() const;
     void itemHeightChanged(const QModelIndex &ih_index);
     void pushBusyStatus(const QString &status);
     void popBusyStatus();
@@ -100,23 +111,45 @@ private:
     int max_row_height_; // px
     int max_line_count_;
 
+    // State of the most recent sort. Used to avoid re-sorting rows which
+    // are already in order after packets have been appended.
+    int sorted_row_count_;
+    int sorted_column_;
+    Qt::SortOrder sorted_order_;
+    unsigned sorted_data_ver_;
+    bool sorting_;
+
     static int sort_column_;
     static int sort_column_is_numeric_;
     static int text_sort_column_;
     static Qt::SortOrder sort_order_;
     static capture_file *sort_cap_file_;
     static bool recordLessThan(PacketListRecord *r1, PacketListRecord *r2);
-    static double parseNumericColumn(const QString &val, bool *ok);
-
+    bool sortProgress(qint64 work_done, qint64 work_total, gboolean *stop_flag);
+    bool mergeRuns(PacketListRecord **first, PacketListRecord **middle, PacketListRecord **last,
+                   PacketListRecord **out, qint64 *work_done, qint64 work_total, gboolean *stop_flag);
+    bool sortRows(QVector<PacketListRecord *> &rows, int sorted_count, gboolean *stop_flag);
+    static double parseNumericColumn(const char *strval, bool *ok);
+
+    /** Coalesces row insertions from appendPacket */
+    QTimer *flush_timer_;
     QElapsedTimer *idle_dissection_timer_;
     int idle_dissection_row_;
 
     struct _GStringChunk *string_cache_pool_;
+    unsigned string_cache_ver_;
+    /** columnStringCacheFull was emitted and trimColumnStringCache hasn't run yet */
+    mutable bool string_cache_trim_queued_;
+    void releaseStaleColumnStrings();
+    bool columnStringCacheOverLimit() const;
+    static bool recordUsedLater(const PacketListRecord *r1, const PacketListRecord *r2);
 
     bool isNumericColumn(int column);
+    void setNumberToRow(guint32 num, int row);
 
 private slots:
     void emitItemHeightChanged(const QModelIndex &ih_index);
+    void trimColumnStringCache();
 };
 
 #endif // PACKET_LIST_MODEL_H
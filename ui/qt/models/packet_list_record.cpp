@@ -23,25 +23,29 @@
 
 #include <QStringList>
 
-class ColumnTextList : public QList<const char *> {
-public:
-    // Allocate our records using wmem.
-    static void *operator new(size_t size) {
-        return wmem_alloc(wmem_file_scope(), size);
-    }
-
-    static void operator delete(void *) {}
-};
-
 QMap<int, int> PacketListRecord::cinfo_column_;
 unsigned PacketListRecord::col_data_ver_ = 1;
+unsigned PacketListRecord::cached_row_count_ = 0;
+unsigned PacketListRecord::frame_data_col_ver_ = 1;
+unsigned PacketListRecord::use_clock_ = 0;
+
+// Record data buffer shared by every dissect() call, so that colorizing and
+// filling in rows doesn't allocate and free a frame-sized buffer each time.
+// dissect() runs on the GUI thread only and doesn't recurse.
+static Buffer record_buf_;
+static bool record_buf_initialized_ = false;
 
-PacketListRecord::PacketListRecord(frame_data *frameData, struct _GStringChunk *string_cache_pool) :
+PacketListRecord::PacketListRecord(frame_data *frameData, struct _GStringChunk **string_cache_pool) :
     col_text_(0),
+    col_text_len_(0),
     fdata_(frameData),
     lines_(1),
     line_count_changed_(false),
+    sort_key_(0.0),
+    sort_key_valid_(false),
     data_ver_(0),
+    frame_data_col_ver_rec_(0),
+    last_use_(0),
     colorized_(false),
     conv_(NULL),
     string_cache_pool_(string_cache_pool)
@@ -65,11 +69,46 @@ const QByteArray PacketListRecord::columnString(capture_file *cap_file, int colu
     }
 
     bool dissect_color = colorized && !colorized_;
-    if (!col_text_ || column >= col_text_->size() || !col_text_->at(column) || data_ver_ != col_data_ver_ || dissect_color) {
+    if (!columnStringCached(column) || dissect_color) {
         dissect(cap_file, dissect_color);
+    } else if (frame_data_col_ver_rec_ != frame_data_col_ver_ && textColumn(column) < 0) {
+        refreshFrameDataColumns(&cap_file->cinfo);
     }
 
-    return col_text_->value(column, QByteArray());
+    if (!col_text_ || column >= col_text_len_) {
+        return QByteArray();
+    }
+    last_use_ = ++use_clock_;
+    return QByteArray(col_text_[column]);
+}
+
+bool PacketListRecord::columnStringCached(int column) const
+{
+    return col_text_ && column >= 0 && column < col_text_len_
+            && col_text_[column] && data_ver_ == col_data_ver_;
+}
+
+void PacketListRecord::releaseColumnStrings()
+{
+    if (!hasCachedColumnStrings()) {
+        return;
+    }
+    // col_data_ver_ starts at 1, so version 0 is never current. Keep
+    // col_text_ itself for the next dissection.
+    data_ver_ = 0;
+    cached_row_count_--;
+}
+
+void PacketListRecord::recacheColumnStrings()
+{
+    if (!hasCachedColumnStrings()) {
+        return;
+    }
+    for (int column = 0; column < col_text_len_; ++column) {
+        if (col_text_[column]) {
+            col_text_[column] = g_string_chunk_insert_const(*string_cache_pool_, col_text_[column]);
+        }
+    }
 }
 
 void PacketListRecord::resetColumns(column_info *cinfo)
@@ -95,17 +134,37 @@ void PacketListRecord::resetColorized()
     colorized_ = false;
 }
 
-void PacketListRecord::dissect(capture_file *cap_file, bool dissect_color)
+void PacketListRecord::resetChangedColorized()
+{
+    if (!colorized_) {
+        return;
+    }
+
+    const color_filter_t *colorf = color_filters_unchanged_match(fdata_->color_filter);
+    if (colorf) {
+        fdata_->color_filter = colorf;
+    } else {
+        colorized_ = false;
+    }
+}
+
+void PacketListRecord::colorize(capture_file *cap_file)
+{
+    if (!colorized_) {
+        dissect(cap_file, true, false);
+    }
+}
+
+void PacketListRecord::dissect(capture_file *cap_file, bool dissect_color, bool fill_columns)
 {
     // packet_list_store.c:packet_list_dissect_and_cache_record
     epan_dissect_t edt;
     column_info *cinfo = NULL;
     gboolean create_proto_tree;
     wtap_rec rec; /* Record metadata */
-    Buffer buf;   /* Record data */
+    Buffer *buf = &record_buf_;   /* Record data */
 
-    if (!col_text_) col_text_ = new ColumnTextList;
-    gboolean dissect_columns = col_text_->isEmpty() || data_ver_ != col_data_ver_;
+    gboolean dissect_columns = fill_columns && (!col_text_ || data_ver_ != col_data_ver_);
 
     if (!cap_file) {
         return;
@@ -117,8 +176,11 @@ void PacketListRecord::dissect(capture_file *cap_file, bool dissect_color)
     }
 
     wtap_rec_init(&rec);
-    ws_buffer_init(&buf, 1514);
-    if (!cf_read_record(cap_file, fdata_, &rec, &buf)) {
+    if (!record_buf_initialized_) {
+        ws_buffer_init(buf, 1514);
+        record_buf_initialized_ = true;
+    }
+    if (!cf_read_record(cap_file, fdata_, &rec, buf)) {
         /*
          * Error reading the record.
          *
@@ -138,7 +200,6 @@ void PacketListRecord::dissect(capture_file *cap_file, bool dissect_color)
             fdata_->color_filter = NULL;
             colorized_ = true;
         }
-        ws_buffer_free(&buf);
         wtap_rec_cleanup(&rec);
         return;    /* error reading the record */
     }
@@ -168,37 +229,41 @@ void PacketListRecord::dissect(capture_file *cap_file, bool dissect_color)
         color_filters_prime_edt(&edt);
         fdata_->need_colorize = 1;
     }
-    if (dissect_columns)
+    if (dissect_columns) {
+        // Hidden columns aren't displayed, so don't construct them.
+        col_set_only_visible(cinfo, TRUE);
         col_custom_prime_edt(&edt, cinfo);
+    }
 
     /*
      * XXX - need to catch an OutOfMemoryError exception and
      * attempt to recover from it.
      */
     epan_dissect_run(&edt, cap_file->cd_t, &rec,
-                     frame_tvbuff_new_buffer(&cap_file->provider, fdata_, &buf),
+                     frame_tvbuff_new_buffer(&cap_file->provider, fdata_, buf),
                      fdata_, cinfo);
 
     if (dissect_columns) {
         /* "Stringify" non frame_data vals */
         epan_dissect_fill_in_columns(&edt, FALSE, FALSE /* fill_fd_columns */);
         cacheColumnStrings(cinfo);
+        col_set_only_visible(cinfo, FALSE);
     }
 
     if (dissect_color) {
         colorized_ = true;
     }
-    data_ver_ = col_data_ver_;
+    if (dissect_columns) {
+        data_ver_ = col_data_ver_;
+    }
 
     packet_info *pi = &edt.pi;
     conv_ = find_conversation_pinfo(pi, 0);
 
     epan_dissect_cleanup(&edt);
-    ws_buffer_free(&buf);
     wtap_rec_cleanup(&rec);
 }
 
-//#define MINIMIZE_STRING_COPYING 1
 void PacketListRecord::cacheColumnStrings(column_info *cinfo)
 {
     // packet_list_store.c:packet_list_change_record(PacketList *packet_list, PacketListRecord *record, gint col, column_info *cinfo)
@@ -206,76 +271,24 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
         return;
     }
 
-    if (col_text_) {
-        col_text_->clear();
-    } else {
-        col_text_ = new ColumnTextList;
+    // The strings themselves live in string_cache_pool_, so each record
+    // only needs a flat array of pointers. It's reused across
+    // redissections unless the number of columns changes.
+    if (!col_text_ || col_text_len_ != cinfo->num_cols) {
+        col_text_ = (const char **) wmem_alloc(wmem_file_scope(), sizeof(const char *) * cinfo->num_cols);
+        col_text_len_ = cinfo->num_cols;
     }
     lines_ = 1;
     line_count_changed_ = false;
+    cached_row_count_++;
+    frame_data_col_ver_rec_ = frame_data_col_ver_;
 
     for (int column = 0; column < cinfo->num_cols; ++column) {
         int col_lines = 1;
-
-#ifdef MINIMIZE_STRING_COPYING
-        int text_col = cinfo_column_.value(column, -1);
-
-        /* Column based on frame_data or it already contains a value */
-        if (text_col < 0) {
-            col_fill_in_frame_data(fdata_, cinfo, column, FALSE);
-            col_text_->append(cinfo->columns[column].col_data);
-            continue;
-        }
-
-        switch (cinfo->col_fmt[column]) {
-        case COL_PROTOCOL:
-        case COL_INFO:
-        case COL_IF_DIR:
-        case COL_DCE_CALL:
-        case COL_8021Q_VLAN_ID:
-        case COL_EXPERT:
-        case COL_FREQ_CHAN:
-            if (cinfo->columns[column].col_data && cinfo->columns[column].col_data != cinfo->columns[column].col_buf) {
-                /* This is a constant string, so we don't have to copy it */
-                // XXX - ui/gtk/packet_list_store.c uses G_MAXUSHORT. We don't do proper UTF8
-                // truncation in either case.
-                int col_text_len = MIN(qstrlen(cinfo->col_data[column]) + 1, COL_MAX_INFO_LEN);
-                col_text_->append(QByteArray::fromRawData(cinfo->columns[column].col_data, col_text_len));
-                break;
-            }
-            /* !! FALL-THROUGH!! */
-
-        case COL_DEF_SRC:
-        case COL_RES_SRC:        /* COL_DEF_SRC is currently just like COL_RES_SRC */
-        case COL_UNRES_SRC:
-        case COL_DEF_DL_SRC:
-        case COL_RES_DL_SRC:
-        case COL_UNRES_DL_SRC:
-        case COL_DEF_NET_SRC:
-        case COL_RES_NET_SRC:
-        case COL_UNRES_NET_SRC:
-        case COL_DEF_DST:
-        case COL_RES_DST:        /* COL_DEF_DST is currently just like COL_RES_DST */
-        case COL_UNRES_DST:
-        case COL_DEF_DL_DST:
-        case COL_RES_DL_DST:
-        case COL_UNRES_DL_DST:
-        case COL_DEF_NET_DST:
-        case COL_RES_NET_DST:
-        case COL_UNRES_NET_DST:
-        default:
-            if (!get_column_resolved(column) && cinfo->col_expr.col_expr_val[column]) {
-                /* Use the unresolved value in col_expr_val */
-                // XXX Use QContiguousCache?
-                col_text_->append(cinfo->col_expr.col_expr_val[column]);
-            } else {
-                col_text_->append(cinfo->columns[column].col_data);
-            }
-            break;
-        }
-#else // MINIMIZE_STRING_COPYING
         const char *col_str;
-        if (!get_column_resolved(column) && cinfo->col_expr.col_expr_val[column]) {
+        if (cinfo->only_visible && !cinfo->columns[column].visible) {
+            col_str = "";
+        } else if (!get_column_resolved(column) && cinfo->col_expr.col_expr_val[column]) {
             /* Use the unresolved value in col_expr_val */
             col_str = cinfo->col_expr.col_expr_val[column];
         } else {
@@ -291,7 +304,7 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
         // https://git.gnome.org/browse/glib/tree/glib/gstringchunk.c
         // We might be better off adding the equivalent functionality to
         // wmem_tree.
-        col_text_->append(g_string_chunk_insert_const(string_cache_pool_, col_str));
+        col_text_[column] = g_string_chunk_insert_const(*string_cache_pool_, col_str);
         for (int i = 0; col_str[i]; i++) {
             if (col_str[i] == '\n') col_lines++;
         }
@@ -299,7 +312,24 @@ void PacketListRecord::cacheColumnStrings(column_info *cinfo)
             lines_ = col_lines;
             line_count_changed_ = true;
         }
-#endif // MINIMIZE_STRING_COPYING
+    }
+}
+
+// Columns based on frame data, such as the time columns, can be filled in
+// without dissecting. Update just those, e.g. after a time shift.
+void PacketListRecord::refreshFrameDataColumns(column_info *cinfo)
+{
+    frame_data_col_ver_rec_ = frame_data_col_ver_;
+    if (!cinfo || !col_text_ || col_text_len_ != cinfo->num_cols) {
+        return;
+    }
+
+    for (int column = 0; column < cinfo->num_cols; ++column) {
+        if (textColumn(column) >= 0 || (cinfo->only_visible && !cinfo->columns[column].visible)) {
+            continue;
+        }
+        col_fill_in_frame_data(fdata_, cinfo, column, FALSE);
+        col_text_[column] = g_string_chunk_insert_const(*string_cache_pool_, cinfo->columns[column].col_data);
     }
 }
 
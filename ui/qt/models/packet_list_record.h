@@ -26,12 +26,10 @@
 struct conversation;
 struct _GStringChunk;
 
-class ColumnTextList;
-
 class PacketListRecord
 {
 public:
-    PacketListRecord(frame_data *frameData, struct _GStringChunk *string_cache_pool);
+    PacketListRecord(frame_data *frameData, struct _GStringChunk **string_cache_pool);
 
     // Allocate our records using wmem.
     static void *operator new(size_t size);
@@ -39,42 +37,82 @@ public:
 
     // Return the string value for a column. Data is cached if possible.
     const QByteArray columnString(capture_file *cap_file, int column, bool colorized = false);
+    // Returns true if columnString can be returned without dissecting.
+    bool columnStringCached(int column) const;
+    // Cached text for a column, or NULL if it isn't cached.
+    const char *cachedColumnString(int column) const { return columnStringCached(column) ? col_text_[column] : NULL; }
     frame_data *frameData() const { return fdata_; }
     // packet_list->col_to_text in gtk/packet_list_store.c
     static int textColumn(int column) { return cinfo_column_.value(column, -1); }
     bool colorized() { return colorized_; }
+    // Apply color filters without filling in or caching column text.
+    void colorize(capture_file *cap_file);
     struct conversation *conversation() { return conv_; }
 
     int columnTextSize(const char *str);
-    static void invalidateAllRecords() { col_data_ver_++; }
+    static void invalidateAllRecords() { col_data_ver_++; cached_row_count_ = 0; }
+    // True if this record holds column text for the current data version.
+    bool hasCachedColumnStrings() const { return col_text_ && data_ver_ == col_data_ver_; }
+    // When columnString last returned this record's text. Larger is newer.
+    unsigned lastUsed() const { return last_use_; }
+    // Forget this record's column text; it's dissected again when needed.
+    void releaseColumnStrings();
+    // Copy this record's column text into the current string cache pool,
+    // e.g. after the model replaced the pool to free evicted strings.
+    void recacheColumnStrings();
+    static unsigned columnDataVersion() { return col_data_ver_; }
+    // Mark the columns based on frame data (times, lengths) as stale. They
+    // are filled in again when next requested, without dissecting.
+    static void invalidateFrameDataColumns() { frame_data_col_ver_++; }
+    // Number of records which have cached column text for the current
+    // data version.
+    static unsigned cachedRowCount() { return cached_row_count_; }
     static void resetColumns(column_info *cinfo);
     void resetColorized();
+    // Keep the color if the coloring rules it came from are unchanged.
+    void resetChangedColorized();
     inline int lineCount() { return lines_; }
     inline int lineCountChanged() { return line_count_changed_; }
 
+    // Numeric value of the column being sorted. Set by PacketListModel::sort.
+    void setNumericSortKey(double key, bool valid) { sort_key_ = key; sort_key_valid_ = valid; }
+    inline double numericSortKey() const { return sort_key_; }
+    inline bool numericSortKeyValid() const { return sort_key_valid_; }
+
 private:
-    /** The column text for some columns */
-    ColumnTextList *col_text_;
+    /** The column text for each column. Points into string_cache_pool_. */
+    const char **col_text_;
+    int col_text_len_;
 
     frame_data *fdata_;
     int lines_;
     bool line_count_changed_;
+    double sort_key_;
+    bool sort_key_valid_;
     static QMap<int, int> cinfo_column_;
 
     /** Data versions. Used to invalidate col_text_ */
     static unsigned col_data_ver_;
+    static unsigned cached_row_count_;
     unsigned data_ver_;
+    static unsigned frame_data_col_ver_;
+    unsigned frame_data_col_ver_rec_;
+    /** Use stamps, for evicting the least recently used column text */
+    static unsigned use_clock_;
+    unsigned last_use_;
     /** Has this record been colorized? */
     bool colorized_;
 
     /** Conversation. Used by RelatedPacketDelegate */
     struct conversation *conv_;
 
-    struct _GStringChunk *string_cache_pool_;
+    /** Owned by the model, which may replace the pool */
+    struct _GStringChunk **string_cache_pool_;
 
-    void dissect(capture_file *cap_file, bool dissect_color = false);
+    void dissect(capture_file *cap_file, bool dissect_color = false, bool fill_columns = true);
 
     void cacheColumnStrings(column_info *cinfo);
+    void refreshFrameDataColumns(column_info *cinfo);
 };
 
 #endif // PACKET_LIST_RECORD_H
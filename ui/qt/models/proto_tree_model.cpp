@@ -22,13 +22,17 @@
 
 ProtoTreeModel::ProtoTreeModel(QObject * parent) :
     QAbstractItemModel(parent),
-    root_node_(0)
+    root_node_(0),
+    find_index_valid_(false)
 {}
 
 Qt::ItemFlags ProtoTreeModel::flags(const QModelIndex &index) const
 {
     Qt::ItemFlags item_flags = QAbstractItemModel::flags(index);
-    if (rowCount(index) < 1) {
+    ProtoNode index_node = protoNodeFromIndex(index);
+    // Checking for a first child is enough here; don't build the child
+    // list of every item the view draws.
+    if (!index_node.isValid() || !index_node.children().element().isValid()) {
         item_flags |= Qt::ItemNeverHasChildren;
     }
 
@@ -37,30 +41,22 @@ Qt::ItemFlags ProtoTreeModel::flags(const QModelIndex &index) const
 
 QModelIndex ProtoTreeModel::index(int row, int, const QModelIndex &parent) const
 {
-    ProtoNode parent_node(root_node_);
+    proto_node *parent_node = root_node_;
 
     if (parent.isValid()) {
         // index is not a top level item.
-        parent_node = protoNodeFromIndex(parent);
+        parent_node = protoNodeFromIndex(parent).protoNode();
     }
 
-    if (! parent_node.isValid() )
+    if (!parent_node)
         return QModelIndex();
 
-    int cur_row = 0;
-    ProtoNode::ChildIterator kids = parent_node.children();
-    while ( kids.element().isValid() )
-    {
-        if ( cur_row == row )
-            break;
-        cur_row++;
-        kids.next();
-    }
-    if ( ! kids.element().isValid() ) {
+    const QVector<proto_node *> &kids = visibleChildren(parent_node);
+    if (row < 0 || row >= kids.size()) {
         return QModelIndex();
     }
 
-    return createIndex(row, 0, static_cast<void *>(kids.element().protoNode()));
+    return createIndex(row, 0, static_cast<void *>(kids.at(row)));
 }
 
 QModelIndex ProtoTreeModel::parent(const QModelIndex &index) const
@@ -71,10 +67,15 @@ QModelIndex ProtoTreeModel::parent(const QModelIndex &index) const
 
 int ProtoTreeModel::rowCount(const QModelIndex &parent) const
 {
+    proto_node *parent_node = root_node_;
+
     if (parent.isValid()) {
-        return protoNodeFromIndex(parent).childrenCount();
+        parent_node = protoNodeFromIndex(parent).protoNode();
+    }
+    if (!parent_node) {
+        return 0;
     }
-    return ProtoNode(root_node_).childrenCount();
+    return visibleChildren(parent_node).size();
 }
 
 // The QItemDelegate documentation says
@@ -93,7 +94,14 @@ QVariant ProtoTreeModel::data(const QModelIndex &index, int role) const
 
     switch (role) {
     case Qt::DisplayRole:
-        return index_node.labelText();
+    {
+        proto_node *node = index_node.protoNode();
+        QHash<proto_node *, QString>::const_iterator it = labels_.constFind(node);
+        if (it != labels_.constEnd()) {
+            return it.value();
+        }
+        return labels_.insert(node, index_node.labelText()).value();
+    }
     case Qt::BackgroundRole:
     {
         switch(finfo.flag(PI_SEVERITY_MASK)) {
@@ -147,10 +155,16 @@ void ProtoTreeModel::setRootNode(proto_node *root_node)
 {
     beginResetModel();
     root_node_ = root_node;
+    children_.clear();
+    rows_.clear();
+    labels_.clear();
+    find_index_valid_ = false;
+    hfid_nodes_.clear();
+    finfo_nodes_.clear();
     endResetModel();
     if (!root_node) return;
 
-    int row_count = ProtoNode(root_node_).childrenCount();
+    int row_count = rowCount();
     if (row_count < 1) return;
     beginInsertRows(QModelIndex(), 0, row_count - 1);
     endInsertRows();
@@ -163,58 +177,68 @@ ProtoNode ProtoTreeModel::protoNodeFromIndex(const QModelIndex &index) const
 
 QModelIndex ProtoTreeModel::indexFromProtoNode(ProtoNode &index_node) const
 {
-    int row = index_node.row();
+    if (!index_node.isChild()) {
+        return QModelIndex();
+    }
 
-    if (!index_node.isValid() || row < 0) {
+    proto_node *node = index_node.protoNode();
+    visibleChildren(node->parent);
+    int row = rows_.value(node, -1);
+    if (row < 0) {
+        // Hidden
         return QModelIndex();
     }
 
-    return createIndex(row, 0, static_cast<void *>(index_node.protoNode()));
+    return createIndex(row, 0, static_cast<void *>(node));
 }
 
-struct find_hfid_ {
-    int hfid;
-    ProtoNode node;
-};
-
-void ProtoTreeModel::foreachFindHfid(proto_node *node, gpointer find_hfid_ptr)
+const QVector<proto_node *> &ProtoTreeModel::visibleChildren(proto_node *node) const
 {
-    struct find_hfid_ *find_hfid = (struct find_hfid_ *) find_hfid_ptr;
-    if (PNODE_FINFO(node)->hfinfo->id == find_hfid->hfid) {
-        find_hfid->node = ProtoNode(node);
-        return;
+    QHash<proto_node *, QVector<proto_node *> >::const_iterator it = children_.constFind(node);
+    if (it != children_.constEnd()) {
+        return it.value();
+    }
+
+    QVector<proto_node *> &kids = children_[node];
+    ProtoNode::ChildIterator child = ProtoNode(node).children();
+    while (child.element().isValid()) {
+        rows_.insert(child.element().protoNode(), kids.size());
+        kids << child.element().protoNode();
+        child.next();
     }
-    proto_tree_children_foreach(node, foreachFindHfid, find_hfid);
+    return kids;
 }
 
-QModelIndex ProtoTreeModel::findFirstHfid(int hf_id)
+void ProtoTreeModel::foreachIndexNode(proto_node *node, gpointer model_ptr)
 {
-    if (!root_node_ || hf_id < 0) return QModelIndex();
-
-    struct find_hfid_ find_hfid;
-    find_hfid.hfid = hf_id;
-
-    proto_tree_children_foreach(root_node_, foreachFindHfid, &find_hfid);
+    ProtoTreeModel *model = static_cast<ProtoTreeModel *>(model_ptr);
+    field_info *fi = PNODE_FINFO(node);
 
-    if (find_hfid.node.isValid()) {
-        return indexFromProtoNode(find_hfid.node);
+    if (fi) {
+        // Pre-order, so the first insert for an hf_id is the first match.
+        if (!model->hfid_nodes_.contains(fi->hfinfo->id)) {
+            model->hfid_nodes_.insert(fi->hfinfo->id, node);
+        }
+        model->finfo_nodes_.insert(fi, node);
     }
-    return QModelIndex();
+    proto_tree_children_foreach(node, foreachIndexNode, model_ptr);
 }
 
-struct find_field_info_ {
-    field_info *fi;
-    ProtoNode node;
-};
+void ProtoTreeModel::buildFindIndex()
+{
+    if (find_index_valid_) return;
+
+    proto_tree_children_foreach(root_node_, foreachIndexNode, this);
+    find_index_valid_ = true;
+}
 
-void ProtoTreeModel::foreachFindField(proto_node *node, gpointer find_finfo_ptr)
+QModelIndex ProtoTreeModel::findFirstHfid(int hf_id)
 {
-    struct find_field_info_ *find_finfo = (struct find_field_info_ *) find_finfo_ptr;
-    if (PNODE_FINFO(node) == find_finfo->fi) {
-        find_finfo->node = ProtoNode(node);
-        return;
-    }
-    proto_tree_children_foreach(node, foreachFindField, find_finfo);
+    if (!root_node_ || hf_id < 0) return QModelIndex();
+
+    buildFindIndex();
+    ProtoNode node(hfid_nodes_.value(hf_id, NULL));
+    return indexFromProtoNode(node);
 }
 
 QModelIndex ProtoTreeModel::findFieldInformation(FieldInformation *finfo)
@@ -223,14 +247,9 @@ QModelIndex ProtoTreeModel::findFieldInformation(FieldInformation *finfo)
     field_info * fi = finfo->fieldInfo();
     if (!fi) return QModelIndex();
 
-    struct find_field_info_ find_finfo;
-    find_finfo.fi = fi;
-
-    proto_tree_children_foreach(root_node_, foreachFindField, &find_finfo);
-    if (find_finfo.node.isValid()) {
-        return indexFromProtoNode(find_finfo.node);
-    }
-    return QModelIndex();
+    buildFindIndex();
+    ProtoNode node(finfo_nodes_.value(fi, NULL));
+    return indexFromProtoNode(node);
 }
 
 /*
@@ -13,7 +13,9 @@
 #include <ui/qt/utils/proto_node.h>
 
 #include <QAbstractItemModel>
+#include <QHash>
 #include <QModelIndex>
+#include <QVector>
 
 class ProtoTreeModel : public QAbstractItemModel
 {
@@ -39,8 +41,22 @@ public:
 
 private:
     proto_node* root_node_;
-    static void foreachFindHfid(proto_node *node, gpointer find_hfid_ptr);
-    static void foreachFindField(proto_node *node, gpointer find_finfo_ptr);
+    // Visible children and their rows, filled in as the view asks for
+    // them. Walking the sibling list for each index() and row() call is
+    // quadratic for nodes with thousands of children.
+    mutable QHash<proto_node *, QVector<proto_node *> > children_;
+    mutable QHash<proto_node *, int> rows_;
+    // Labels of the items the view has displayed. They are formatted on
+    // the first request only, as repaints and column resizes ask again.
+    mutable QHash<proto_node *, QString> labels_;
+    // Built by the first find.
+    bool find_index_valid_;
+    QHash<int, proto_node *> hfid_nodes_;
+    QHash<field_info *, proto_node *> finfo_nodes_;
+
+    const QVector<proto_node *> &visibleChildren(proto_node *node) const;
+    void buildFindIndex();
+    static void foreachIndexNode(proto_node *node, gpointer model_ptr);
 };
 
 #endif // PROTO_TREE_MODEL_H
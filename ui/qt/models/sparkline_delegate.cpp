@@ -37,8 +37,8 @@ void SparkLineDelegate::paint(QPainter *painter, const QStyleOptionViewItem &opt
         return;
     }
 
-    while((qreal) points.length() > steps) {
-        points.removeFirst();
+    if ((qreal) points.length() > steps) {
+        points = points.mid(points.length() - (int) steps);
     }
 
     foreach (val, points) {
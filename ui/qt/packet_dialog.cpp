@@ -30,11 +30,13 @@
 // - Copy over experimental packet editing code.
 // - Fix ElidedText width.
 
-PacketDialog::PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata) :
+PacketDialog::PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata, const QStringList &col_strings) :
     WiresharkDialog(parent, cf),
     ui(new Ui::PacketDialog),
     proto_tree_(NULL),
-    byte_view_tab_(NULL)
+    byte_view_tab_(NULL),
+    edt_(NULL),
+    shared_edt_(false)
 {
     ui->setupUi(this);
     loadGeometry(parent.width() * 4 / 5, parent.height() * 4 / 5);
@@ -43,45 +45,55 @@ PacketDialog::PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata)
     wtap_rec_init(&rec_);
     ws_buffer_init(&buf_, 1514);
 
-    edt_.session = NULL;
-    edt_.tvb = NULL;
-    edt_.tree = NULL;
-
-    memset(&edt_.pi, 0x0, sizeof(edt_.pi));
-
     setWindowSubtitle(tr("Packet %1").arg(fdata->num));
 
-    if (!cf_read_record(cap_file_.capFile(), fdata, &rec_, &buf_)) {
-        reject();
-        return;
+    // The main window has just dissected the selected packet; show that
+    // dissection instead of repeating it. We only lack its columns.
+    QStringList col_values = col_strings;
+    if (fdata == cap_file_.capFile()->current_frame
+            && col_values.size() == cap_file_.capFile()->cinfo.num_cols) {
+        edt_ = cf_share_selected_edt(cap_file_.capFile());
+        shared_edt_ = edt_ != NULL;
     }
 
-    /* proto tree, visible. We need a proto tree if there are custom columns */
-    epan_dissect_init(&edt_, cap_file_.capFile()->epan, TRUE, TRUE);
-    col_custom_prime_edt(&edt_, &(cap_file_.capFile()->cinfo));
-
-    epan_dissect_run(&edt_, cap_file_.capFile()->cd_t, &rec_,
-                     frame_tvbuff_new_buffer(&cap_file_.capFile()->provider, fdata, &buf_),
-                     fdata, &(cap_file_.capFile()->cinfo));
-    epan_dissect_fill_in_columns(&edt_, TRUE, TRUE);
+    if (!edt_) {
+        if (!cf_read_record(cap_file_.capFile(), fdata, &rec_, &buf_)) {
+            reject();
+            return;
+        }
+
+        /* proto tree, visible. We need a proto tree if there are custom columns */
+        edt_ = epan_dissect_new(cap_file_.capFile()->epan, TRUE, TRUE);
+        col_custom_prime_edt(edt_, &(cap_file_.capFile()->cinfo));
+
+        epan_dissect_run(edt_, cap_file_.capFile()->cd_t, &rec_,
+                         frame_tvbuff_new_buffer(&cap_file_.capFile()->provider, fdata, &buf_),
+                         fdata, &(cap_file_.capFile()->cinfo));
+        epan_dissect_fill_in_columns(edt_, TRUE, TRUE);
+
+        col_values.clear();
+        for (int i = 0; i < cap_file_.capFile()->cinfo.num_cols; ++i) {
+            col_values << cap_file_.capFile()->cinfo.columns[i].col_data;
+        }
+    }
 
-    proto_tree_ = new ProtoTree(ui->packetSplitter, &edt_);
+    proto_tree_ = new ProtoTree(ui->packetSplitter, edt_);
     // Do not call proto_tree_->setCaptureFile, ProtoTree only needs the
     // dissection context.
-    proto_tree_->setRootNode(edt_.tree);
+    proto_tree_->setRootNode(edt_->tree);
 
-    byte_view_tab_ = new ByteViewTab(ui->packetSplitter, &edt_);
+    byte_view_tab_ = new ByteViewTab(ui->packetSplitter, edt_);
     byte_view_tab_->setCaptureFile(cap_file_.capFile());
     byte_view_tab_->selectedFrameChanged(0);
 
     ui->packetSplitter->setStretchFactor(1, 0);
 
     QStringList col_parts;
-    for (int i = 0; i < cap_file_.capFile()->cinfo.num_cols; ++i) {
+    for (int i = 0; i < col_values.size(); ++i) {
         // ElidedLabel doesn't support rich text / HTML
         col_parts << QString("%1: %2")
                      .arg(get_column_title(i))
-                     .arg(cap_file_.capFile()->cinfo.columns[i].col_data);
+                     .arg(col_values[i]);
     }
     col_info_ = col_parts.join(" " UTF8_MIDDLE_DOT " ");
 
@@ -103,7 +115,13 @@ PacketDialog::PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata)
 PacketDialog::~PacketDialog()
 {
     delete ui;
-    epan_dissect_cleanup(&edt_);
+    if (edt_) {
+        if (shared_edt_) {
+            cf_release_edt(edt_);
+        } else {
+            epan_dissect_free(edt_);
+        }
+    }
     wtap_rec_cleanup(&rec_);
     ws_buffer_free(&buf_);
 }
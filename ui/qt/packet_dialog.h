@@ -30,7 +30,10 @@ class PacketDialog : public WiresharkDialog
     Q_OBJECT
 
 public:
-    explicit PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata);
+    // If fdata is the selected packet and col_strings holds its column
+    // strings, the main window's dissection is shown instead of a new one.
+    explicit PacketDialog(QWidget &parent, CaptureFile &cf, frame_data *fdata,
+                          const QStringList &col_strings = QStringList());
     ~PacketDialog();
 
 private slots:
@@ -47,7 +50,8 @@ private:
     ByteViewTab *byte_view_tab_;
     wtap_rec rec_;
     Buffer buf_;
-    epan_dissect_t edt_;
+    epan_dissect_t *edt_;
+    bool shared_edt_;
 };
 
 #endif // PACKET_DIALOG_H
@@ -64,6 +64,7 @@
 #include <QPainter>
 #include <QScreen>
 #include <QScrollBar>
+#include <QStyle>
 #include <QTabWidget>
 #include <QTextEdit>
 #include <QTimerEvent>
@@ -251,7 +252,13 @@ PacketList::PacketList(QWidget *parent) :
     connect(packet_list_header_, &PacketListHeader::showColumnPreferences, this, &PacketList::showProtocolPreferences);
     connect(packet_list_header_, &PacketListHeader::editColumn, this, &PacketList::editColumn);
     connect(packet_list_header_, &PacketListHeader::columnsChanged, this, &PacketList::columnsChanged);
+    connect(packet_list_header_, &PacketListHeader::columnVisibilityChanged, this, &PacketList::setColumnVisibility);
     setHeader(packet_list_header_);
+#if (QT_VERSION >= QT_VERSION_CHECK(5, 2, 0))
+    // Measuring a row dissects it. Only measure the rows on screen and
+    // estimate the rest in sizeHintForColumn.
+    header()->setResizeContentsPrecision(0);
+#endif
 
     // Shrink down to a small but nonzero size in the main splitter.
     int one_em = fontMetrics().height();
@@ -269,6 +276,7 @@ PacketList::PacketList(QWidget *parent) :
 
     connect(packet_list_model_, SIGNAL(goToPacket(int)), this, SLOT(goToPacket(int)));
     connect(packet_list_model_, SIGNAL(itemHeightChanged(const QModelIndex&)), this, SLOT(updateRowHeights(const QModelIndex&)));
+    connect(packet_list_model_, SIGNAL(bgColorizationProgress(int,int)), this, SLOT(bgColorizationProgress(int,int)));
     connect(wsApp, SIGNAL(addressResolutionChanged()), this, SLOT(redrawVisiblePacketsDontSelectCurrent()));
     connect(wsApp, SIGNAL(columnDataChanged()), this, SLOT(redrawVisiblePacketsDontSelectCurrent()));
 
@@ -686,13 +694,29 @@ void PacketList::resizeEvent(QResizeEvent *event)
 
 void PacketList::setColumnVisibility()
 {
+    bool cinfo_changed = false;
+
     set_column_visibility_ = true;
     for (int i = 0; i < prefs.num_cols; i++) {
         setColumnHidden(i, get_column_visible(i) ? false : true);
+        if (cap_file_ && i < cap_file_->cinfo.num_cols &&
+                cap_file_->cinfo.columns[i].visible != get_column_visible(i)) {
+            col_set_visible(&cap_file_->cinfo, i, get_column_visible(i));
+            cinfo_changed = true;
+        }
     }
     set_column_visibility_ = false;
+
+    // Rows are dissected without their hidden columns, so cached text
+    // for a column that was just shown is empty.
+    if (cinfo_changed) {
+        packet_list_model_->invalidateAllColumnStrings();
+    }
 }
 
+// Rows sampled for the longest column text when sizing a column.
+const int PacketList::size_hint_sample_rows_ = 10000;
+
 int PacketList::sizeHintForColumn(int column) const
 {
     int size_hint = 0;
@@ -704,7 +728,18 @@ int PacketList::sizeHintForColumn(int column) const
         // on macOS and Linux. We might want to add Q_OS_... #ifdefs accordingly.
         size_hint = itemDelegateForColumn(column)->sizeHint(viewOptions(), QModelIndex()).width();
     }
-    size_hint += QTreeView::sizeHintForColumn(column); // Decoration padding
+    int tree_hint = QTreeView::sizeHintForColumn(column); // Decoration padding
+
+    // QTreeView only measured the rows on screen. Estimate the others from
+    // the longest text already in the column string cache for a sample of
+    // rows, so that we only measure one more string and dissect nothing.
+    const QString longest = packet_list_model_->longestCachedColumnString(column, size_hint_sample_rows_);
+    if (!longest.isEmpty()) {
+        int margin = (style()->pixelMetric(QStyle::PM_FocusFrameHMargin, 0, this) + 1) * 2;
+        tree_hint = qMax(tree_hint, QFontMetrics(font()).width(longest) + margin);
+    }
+
+    size_hint += tree_hint;
     return size_hint;
 }
 
@@ -858,6 +893,11 @@ void PacketList::preferencesChanged()
     // Update color style changes
     colorsChanged();
 
+    // Preferences that only change the packet details text, such as
+    // "summary_in_tree", don't redissect the file. Dissect the selected
+    // packet again to show them.
+    drawCurrentPacket();
+
     // Related packet delegate
     if (prefs.gui_packet_list_show_related) {
         setItemDelegateForColumn(0, &related_packet_delegate_);
@@ -904,6 +944,14 @@ void PacketList::recolorPackets()
     redrawVisiblePackets();
 }
 
+// Only recolor packets whose coloring rule, or a rule before it, was
+// changed by the coloring rules dialog.
+void PacketList::recolorChangedPackets()
+{
+    packet_list_model_->resetChangedColorized();
+    redrawVisiblePackets();
+}
+
 /* Enable autoscroll timer. Note: must be called after the capture is started,
  * otherwise the timer will not be executed. */
 void PacketList::setVerticalAutoScroll(bool enabled)
@@ -1099,6 +1147,19 @@ void PacketList::resetColorized()
     update();
 }
 
+QStringList PacketList::selectedColumnStrings()
+{
+    QStringList col_strings;
+
+    if (!currentIndex().isValid()) return col_strings;
+
+    int row = currentIndex().row();
+    for (int col = 0; col < packet_list_model_->columnCount(); col++) {
+        col_strings << packet_list_model_->data(packet_list_model_->index(row, col), Qt::DisplayRole).toString();
+    }
+    return col_strings;
+}
+
 QString PacketList::packetComment()
 {
     int row = currentIndex().row();
@@ -1598,22 +1659,30 @@ void PacketList::drawNearOverlay()
             start += ((double) overlay_sb_->value() / overlay_sb_->maximum()) * (packet_list_model_->rowCount() - o_rows);
         }
         int end = start + o_rows;
-        for (int row = start; row < end; row++) {
-            packet_list_model_->ensureRowColorized(row);
 
+        // Use the colors that the view and the idle colorizer have already
+        // assigned instead of dissecting every row here. Rows that haven't
+        // been colorized yet are filled in as bgColorizationProgress
+        // reports them. Adjacent rows with the same filter share a rect.
+        const color_filter_t *run_filter = NULL;
+        int run_start = 0;
+        for (int row = start; row < end; row++) {
             frame_data *fdata = packet_list_model_->getRowFdata(row);
-            const color_t *bgcolor = NULL;
-            if (fdata->color_filter) {
-                const color_filter_t *color_filter = (const color_filter_t *) fdata->color_filter;
-                bgcolor = &color_filter->bg_color;
-            }
+            const color_filter_t *color_filter = (const color_filter_t *) fdata->color_filter;
 
-            int next_line = (row - start) * o_height / o_rows;
-            if (bgcolor) {
-                QColor color(ColorUtils::fromColorT(bgcolor));
-                painter.fillRect(0, cur_line, o_width, next_line - cur_line, color);
+            if (color_filter != run_filter) {
+                if (run_filter) {
+                    QColor color(ColorUtils::fromColorT(&run_filter->bg_color));
+                    painter.fillRect(0, run_start, o_width, cur_line - run_start, color);
+                }
+                run_filter = color_filter;
+                run_start = cur_line;
             }
-            cur_line = next_line;
+            cur_line = (row - start) * o_height / o_rows;
+        }
+        if (run_filter) {
+            QColor color(ColorUtils::fromColorT(&run_filter->bg_color));
+            painter.fillRect(0, run_start, o_width, cur_line - run_start, color);
         }
 
         // If the selected packet is in the overlay set selected_pos
@@ -1636,6 +1705,11 @@ void PacketList::drawNearOverlay()
     }
 }
 
+void PacketList::bgColorizationProgress(int, int)
+{
+    create_near_overlay_ = true;
+}
+
 void PacketList::drawFarOverlay()
 {
     if (create_far_overlay_) {
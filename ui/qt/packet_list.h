@@ -56,6 +56,8 @@ public:
     void writeRecent(FILE *rf);
     bool contextMenuActive();
     QString getFilterFromRowAndColumn();
+    // The text of every column of the selected packet, displayed or not.
+    QStringList selectedColumnStrings();
     void resetColorized();
     QString packetComment();
     void setPacketComment(QString new_comment);
@@ -81,6 +83,8 @@ protected slots:
     void drawRow(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const;
 
 private:
+    static const int size_hint_sample_rows_;
+
     PacketListModel *packet_list_model_;
     PacketListHeader * packet_list_header_;
     ProtoTree *proto_tree_;
@@ -151,6 +155,7 @@ public slots:
     void unsetAllTimeReferences();
     void applyTimeShift();
     void recolorPackets();
+    void recolorChangedPackets();
     void redrawVisiblePackets();
     void redrawVisiblePacketsDontSelectCurrent();
     void columnsChanged();
@@ -166,6 +171,7 @@ private slots:
     void vScrollBarActionTriggered(int);
     void drawFarOverlay();
     void drawNearOverlay();
+    void bgColorizationProgress(int, int);
     void updatePackets(bool redraw);
 };
 
@@ -273,14 +273,20 @@ void ProtocolPreferencesMenu::boolPreferenceTriggered()
     BoolPreferenceAction *bpa = static_cast<BoolPreferenceAction *>(QObject::sender());
     if (!bpa) return;
 
-    module_->prefs_changed_flags |= bpa->setBoolValue();
-
-    prefs_apply(module_);
-    prefs_main_write();
+    unsigned int changed_flags = bpa->setBoolValue();
+    if (changed_flags) { // Changed
+        module_->prefs_changed_flags |= changed_flags;
+        prefs_apply(module_);
+        prefs_main_write();
 
-    /* Protocol preference changes almost always affect dissection,
-       so don't bother checking flags */
-    wsApp->emitAppSignal(WiresharkApplication::PacketDissectionChanged);
+        /* Redissecting a large file takes a while; skip it for
+           preferences that only affect the GUI */
+        if (changed_flags & PREF_EFFECT_DISSECTION) {
+            wsApp->emitAppSignal(WiresharkApplication::PacketDissectionChanged);
+        } else {
+            wsApp->emitAppSignal(WiresharkApplication::PreferencesChanged);
+        }
+    }
 }
 
 void ProtocolPreferencesMenu::enumPreferenceTriggered()
@@ -294,9 +300,11 @@ void ProtocolPreferencesMenu::enumPreferenceTriggered()
         prefs_apply(module_);
         prefs_main_write();
 
-        /* Protocol preference changes almost always affect dissection,
-           so don't bother checking flags */
-        wsApp->emitAppSignal(WiresharkApplication::PacketDissectionChanged);
+        if (changed_flags & PREF_EFFECT_DISSECTION) {
+            wsApp->emitAppSignal(WiresharkApplication::PacketDissectionChanged);
+        } else {
+            wsApp->emitAppSignal(WiresharkApplication::PreferencesChanged);
+        }
     }
 }
 
@@ -82,8 +82,18 @@ public:
     {
         setText(col_type_, type_);
         setHidden(true);
+        memset(drawn_counts_, 0, sizeof(drawn_counts_));
     }
-    void draw() {
+    // Returns true if the statistics were updated since they were last drawn.
+    bool draw() {
+        // Skip untouched rows. Every update changes one of these counters.
+        const guint32 counts[] = {
+            timestat_->rtd->num, timestat_->open_req_num, timestat_->disc_rsp_num,
+            timestat_->req_dup_num, timestat_->rsp_dup_num
+        };
+        if (memcmp(counts, drawn_counts_, sizeof(drawn_counts_)) == 0) return false;
+        memcpy(drawn_counts_, counts, sizeof(drawn_counts_));
+
         setText(col_messages_, QString::number(timestat_->rtd->num));
         setText(col_min_srt_, QString::number(nstime_to_sec(&timestat_->rtd->min), 'f', 6));
         setText(col_max_srt_, QString::number(nstime_to_sec(&timestat_->rtd->max), 'f', 6));
@@ -96,6 +106,7 @@ public:
         setText(col_repeated_responses_, QString::number(timestat_->rsp_dup_num));
 
         setHidden(timestat_->rtd->num < 1);
+        return true;
     }
     bool operator< (const QTreeWidgetItem &other) const
     {
@@ -145,6 +156,7 @@ public:
 private:
     const QString type_;
     const rtd_timestat *timestat_;
+    guint32 drawn_counts_[5];
 };
 
 ResponseTimeDelayDialog::ResponseTimeDelayDialog(QWidget &parent, CaptureFile &cf, register_rtd *rtd, const QString filter, int help_topic) :
@@ -212,14 +224,16 @@ void ResponseTimeDelayDialog::tapDraw(void *rtdd_ptr)
     ResponseTimeDelayDialog *rtd_dlg = static_cast<ResponseTimeDelayDialog *>(rtdd->user_data);
     if (!rtd_dlg || !rtd_dlg->statsTreeWidget()) return;
 
+    bool changed = false;
     QTreeWidgetItemIterator it(rtd_dlg->statsTreeWidget());
     while (*it) {
         if ((*it)->type() == rtd_time_stat_type_) {
             RtdTimeStatTreeWidgetItem *rtd_ts_ti = static_cast<RtdTimeStatTreeWidgetItem *>((*it));
-            rtd_ts_ti->draw();
+            if (rtd_ts_ti->draw()) changed = true;
         }
         ++it;
     }
+    if (!changed) return;
 
     for (int i = 0; i < rtd_dlg->statsTreeWidget()->columnCount() - 1; i++) {
         rtd_dlg->statsTreeWidget()->resizeColumnToContents(i);
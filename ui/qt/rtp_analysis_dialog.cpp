@@ -1030,102 +1030,137 @@ void RtpAnalysisDialog::showPlayer()
 #endif // QT_MULTIMEDIA_LIB
 }
 
-/* Convert one packet payload to samples in row */
+// rtp_analysis.c:copy_file
+enum { save_audio_none_, save_audio_au_, save_audio_wav_, save_audio_raw_ };
+
+/* Silence is written in blocks of this many bytes */
+#define SAVE_AUDIO_BLOCK_LEN 65536
+
+/* Read one packet payload and convert it to 16 bit samples in row.
+ * .au files are big endian, .wav files little endian. */
 /* It supports G.711 now, but can be extended to any other codecs */
-size_t RtpAnalysisDialog::convert_payload_to_samples(unsigned int payload_type, QTemporaryFile *tempfile, guint8 *pd_out, size_t payload_len)
+size_t RtpAnalysisDialog::convert_payload_to_samples(unsigned int payload_type, QTemporaryFile *tempfile, QByteArray &pd_out, size_t payload_len, bool little_endian)
 {
-    size_t sample_count;
-    char f_rawvalue;
-    gint16 sample;
-    guint8 pd[4];
+    static gint16 ulaw_table[256];
+    static gint16 alaw_table[256];
+    static bool tables_ready = false;
+    const gint16 *table;
+
+    /* ulaw2linear and alaw2linear compute each sample; look them up instead */
+    if (!tables_ready) {
+        for (int i = 0; i < 256; i++) {
+            ulaw_table[i] = (gint16)ulaw2linear((unsigned char)i);
+            alaw_table[i] = (gint16)alaw2linear((unsigned char)i);
+        }
+        tables_ready = true;
+    }
+
+    QByteArray payload = tempfile->read(payload_len);
+    if ((size_t)payload.size() != payload_len) {
+        return 0;
+    }
 
     if (payload_type == PT_PCMU) {
-        /* Output sample count is same as input sample count for G.711 */
-        sample_count = payload_len;
-        for(size_t i = 0; i < payload_len; i++) {
-            tempfile->read((char *)&f_rawvalue, sizeof(f_rawvalue));
-            sample = ulaw2linear((unsigned char)f_rawvalue);
-            phton16(pd, sample);
-            pd_out[2*i] = pd[0];
-            pd_out[2*i+1] = pd[1];
-        }
+        table = ulaw_table;
     } else if (payload_type == PT_PCMA) {
-        /* Output sample count is same as input sample count for G.711 */
-        sample_count = payload_len;
-        for(size_t i = 0; i < payload_len; i++) {
-            tempfile->read((char *)&f_rawvalue, sizeof(f_rawvalue));
-            sample = alaw2linear((unsigned char)f_rawvalue);
-            phton16(pd, sample);
-            pd_out[2*i] = pd[0];
-            pd_out[2*i+1] = pd[1];
-        }
+        table = alaw_table;
     } else {
-        /* Read payload, but ignore it */
-        sample_count = 0;
-        for(size_t i = 0; i < payload_len; i++) {
-            tempfile->read((char *)&f_rawvalue, sizeof(f_rawvalue));
+        /* Payload was read, but it is ignored */
+        return 0;
+    }
+
+    /* Output sample count is same as input sample count for G.711 */
+    pd_out.resize(int(payload_len * 2));
+    const guint8 *in = (const guint8 *)payload.constData();
+    guint8 *out = (guint8 *)pd_out.data();
+    for (size_t i = 0; i < payload_len; i++) {
+        guint16 sample = (guint16)table[in[i]];
+        if (little_endian) {
+            out[2*i] = (guint8)sample;
+            out[2*i+1] = (guint8)(sample >> 8);
+        } else {
+            out[2*i] = (guint8)(sample >> 8);
+            out[2*i+1] = (guint8)sample;
         }
     }
 
-    return sample_count;
+    return payload_len;
 }
 
 gboolean RtpAnalysisDialog::saveAudioAUSilence(size_t total_len, QFile *save_file, gboolean *stop_flag)
 {
-    qint64 nchars;
-    guint8 pd_out[2*4000];
-    gint16 silence;
-    guint8 pd[4];
-
-    silence = 0x0000;
-    phton16(pd, silence);
-    pd_out[0] = pd[0];
-    pd_out[1] = pd[1];
+    /* Silence is zero in either byte order */
+    QByteArray silence(SAVE_AUDIO_BLOCK_LEN, '\0');
+    size_t remaining = total_len * 2;
+
     /* Fill whole file with silence */
-    for(size_t i=0; i<total_len; i++) {
+    while (remaining > 0) {
+        qint64 len = (qint64)MIN(remaining, (size_t)SAVE_AUDIO_BLOCK_LEN);
+
         if (*stop_flag) {
             return FALSE;
         }
-        nchars = save_file->write((const char *)pd_out, 2);
-        if (nchars < 2) {
+        if (save_file->write(silence.constData(), len) != len) {
             return FALSE;
         }
+        remaining -= (size_t)len;
     }
 
     return TRUE;
 }
 
-gboolean RtpAnalysisDialog::saveAudioAUUnidir(tap_rtp_stat_t &statinfo, QTemporaryFile *tempfile, QFile *save_file, qint64 header_end, gboolean *stop_flag, gboolean interleave, size_t prefix_silence)
+gboolean RtpAnalysisDialog::saveAudioAUUnidir(tap_rtp_stat_t &statinfo, QTemporaryFile *tempfile, QFile *save_file, qint64 header_end, gboolean *stop_flag, gboolean interleave, size_t prefix_silence, bool little_endian)
 {
-    qint64 nchars;
-    guint8 pd_out[2*4000];
-    guint8 pd[4];
+    QByteArray pd_out;
+    QByteArray frame;
     tap_rtp_save_data_t save_data;
 
     while (sizeof(save_data) == tempfile->read((char *)&save_data,sizeof(save_data))) {
         size_t sample_count;
+        qint64 pos;
 
         if (*stop_flag) {
             return FALSE;
         }
         ui->progressFrame->setValue(int(tempfile->pos() * 100 / tempfile->size()));
 
-        sample_count=convert_payload_to_samples(save_data.payload_type, tempfile ,pd_out, save_data.payload_len);
+        sample_count=convert_payload_to_samples(save_data.payload_type, tempfile, pd_out, save_data.payload_len, little_endian);
+        if (sample_count == 0) {
+            continue;
+        }
 
-        if (sample_count > 0 ) {
-            nchars = 0;
-            /* Save payload samples with optional interleaving */
+        pos = prefix_silence + guint32_wraparound_diff(save_data.timestamp, statinfo.first_timestamp);
+        if (!interleave) {
+            /* Samples of one packet are contiguous; write them at once */
+            if (!save_file->seek(header_end + pos * 2)) {
+                return FALSE;
+            }
+            if (save_file->write(pd_out) != pd_out.size()) {
+                return FALSE;
+            }
+        } else {
+            /* Every other sample belongs to the other channel. Read the
+             * frames the packet spans, fill in this channel and write
+             * them back. The file was filled with silence before, but a
+             * packet may reach past the end of it, e.g. if its timestamp
+             * jumped; the other channel is silent there. */
+            qint64 span = (qint64)sample_count * 4 - 2;
+
+            if (!save_file->seek(header_end + pos * 4)) {
+                return FALSE;
+            }
+            frame = save_file->read(span);
+            if (frame.size() < span) {
+                frame.append(QByteArray(int(span - frame.size()), '\0'));
+            }
             for (size_t i = 0; i < sample_count; i++) {
-                pd[0] = pd_out[ 2 * i ];
-                pd[1] = pd_out[ 2 * i + 1 ];
-                if (interleave) {
-                    save_file->seek(header_end+(prefix_silence + (guint32_wraparound_diff(save_data.timestamp, statinfo.first_timestamp) + i)) * 4);
-                } else {
-                    save_file->seek(header_end+(prefix_silence + (guint32_wraparound_diff(save_data.timestamp, statinfo.first_timestamp) + i)) * 2);
-                }
-                nchars += save_file->write((const char *)pd, 2);
+                frame[int(4 * i)] = pd_out[int(2 * i)];
+                frame[int(4 * i + 1)] = pd_out[int(2 * i + 1)];
+            }
+            if (!save_file->seek(header_end + pos * 4)) {
+                return FALSE;
             }
-            if ((size_t)nchars < sample_count*2) {
+            if (save_file->write(frame) != span) {
                 return FALSE;
             }
         }
@@ -1134,13 +1169,13 @@ gboolean RtpAnalysisDialog::saveAudioAUUnidir(tap_rtp_stat_t &statinfo, QTempora
     return TRUE;
 }
 
-gboolean RtpAnalysisDialog::saveAudioAUBidir(tap_rtp_stat_t &fwd_statinfo, tap_rtp_stat_t &rev_statinfo, QTemporaryFile *fwd_tempfile, QTemporaryFile *rev_tempfile, QFile *save_file, qint64 header_end, gboolean *stop_flag, size_t prefix_silence_fwd, size_t prefix_silence_rev)
+gboolean RtpAnalysisDialog::saveAudioAUBidir(tap_rtp_stat_t &fwd_statinfo, tap_rtp_stat_t &rev_statinfo, QTemporaryFile *fwd_tempfile, QTemporaryFile *rev_tempfile, QFile *save_file, qint64 header_end, gboolean *stop_flag, size_t prefix_silence_fwd, size_t prefix_silence_rev, bool little_endian)
 {
-    if (! saveAudioAUUnidir(fwd_statinfo, fwd_tempfile, save_file, header_end, stop_flag, TRUE, prefix_silence_fwd))
+    if (! saveAudioAUUnidir(fwd_statinfo, fwd_tempfile, save_file, header_end, stop_flag, TRUE, prefix_silence_fwd, little_endian))
     {
         return FALSE;
     }
-    if (! saveAudioAUUnidir(rev_statinfo, rev_tempfile, save_file, header_end+2, stop_flag, TRUE, prefix_silence_rev))
+    if (! saveAudioAUUnidir(rev_statinfo, rev_tempfile, save_file, header_end+2, stop_flag, TRUE, prefix_silence_rev, little_endian))
     {
         return FALSE;
     }
@@ -1148,64 +1183,58 @@ gboolean RtpAnalysisDialog::saveAudioAUBidir(tap_rtp_stat_t &fwd_statinfo, tap_r
     return TRUE;
 }
 
-gboolean RtpAnalysisDialog::saveAudioAU(StreamDirection direction, QFile *save_file, gboolean *stop_flag, RtpAnalysisDialog::SyncType sync)
+gboolean RtpAnalysisDialog::saveAudioAU(StreamDirection direction, QFile *save_file, gboolean *stop_flag, RtpAnalysisDialog::SyncType sync, int save_format)
 {
-    guint8 pd[4];
-    qint64 nchars;
+    guint8 header[44];
     qint64 header_end;
     size_t fwd_total_len;
     size_t rev_total_len;
     size_t total_len;
-
-    /* http://pubs.opengroup.org/external/auformat.html */
-    /* First we write the .au header.  All values in the header are
-     * 4-byte big-endian values, so we use pntoh32() to copy them
-     * to a 4-byte buffer, in big-endian order, and then write out
-     * the buffer. */
-
-    /* the magic word 0x2e736e64 == .snd */
-    phton32(pd, 0x2e736e64);
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
-    /* header offset == 24 bytes */
-    phton32(pd, 24);
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
-    /* total length; it is permitted to set this to 0xffffffff */
-    phton32(pd, 0xffffffff);
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
-    /* encoding format == 16-bit linear PCM */
-    phton32(pd, 3);
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
-    /* sample rate == 8000 Hz */
-    phton32(pd, 8000);
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
-    /* channels == 1 or == 2 */
-    switch (direction) {
-        case dir_forward_: {
-            phton32(pd, 1);
-            break;
-        }
-        case dir_reverse_: {
-            phton32(pd, 1);
-            break;
-        }
-        case dir_both_: {
-            phton32(pd, 2);
-            break;
-        }
+    guint32 channels = (direction == dir_both_) ? 2 : 1;
+    bool little_endian = (save_format == save_audio_wav_);
+
+    if (save_format == save_audio_wav_) {
+        /* http://soundfile.sapp.org/doc/WaveFormat/ */
+        /* All values are little endian. The RIFF and data chunk sizes
+         * are filled in when all the samples have been written. */
+        memcpy(header, "RIFF", 4);
+        phtole32(header + 4, 0);
+        memcpy(header + 8, "WAVE", 4);
+        memcpy(header + 12, "fmt ", 4);
+        phtole32(header + 16, 16);
+        /* format == 1, linear PCM; channels == 1 or == 2 */
+        phtole32(header + 20, 1 | (channels << 16));
+        /* sample rate == 8000 Hz */
+        phtole32(header + 24, 8000);
+        /* byte rate */
+        phtole32(header + 28, 8000 * channels * 2);
+        /* block align; 16 bits per sample */
+        phtole32(header + 32, (channels * 2) | (16 << 16));
+        memcpy(header + 36, "data", 4);
+        phtole32(header + 40, 0);
+        if (save_file->write((const char *)header, 44) != 44)
+            return FALSE;
+    } else {
+        /* http://pubs.opengroup.org/external/auformat.html */
+        /* First we write the .au header.  All values in the header are
+         * 4-byte big-endian values, so we use phton32() to copy them
+         * to the header buffer, in big-endian order. */
+
+        /* the magic word 0x2e736e64 == .snd */
+        phton32(header, 0x2e736e64);
+        /* header offset == 24 bytes */
+        phton32(header + 4, 24);
+        /* total length; it is permitted to set this to 0xffffffff */
+        phton32(header + 8, 0xffffffff);
+        /* encoding format == 16-bit linear PCM */
+        phton32(header + 12, 3);
+        /* sample rate == 8000 Hz */
+        phton32(header + 16, 8000);
+        /* channels == 1 or == 2 */
+        phton32(header + 20, channels);
+        if (save_file->write((const char *)header, 24) != 24)
+            return FALSE;
     }
-    nchars = save_file->write((const char *)pd, 4);
-    if (nchars != 4)
-        return FALSE;
 
     header_end=save_file->pos();
 
@@ -1262,7 +1291,7 @@ gboolean RtpAnalysisDialog::saveAudioAU(StreamDirection direction, QFile *save_f
             {
                 return FALSE;
             }
-            if (! saveAudioAUUnidir(fwd_statinfo_.rtp_stats, fwd_tempfile_, save_file, header_end, stop_flag, FALSE, fwd_samples_diff + bidir_samples_diff))
+            if (! saveAudioAUUnidir(fwd_statinfo_.rtp_stats, fwd_tempfile_, save_file, header_end, stop_flag, FALSE, fwd_samples_diff + bidir_samples_diff, little_endian))
             {
                 return FALSE;
             }
@@ -1275,7 +1304,7 @@ gboolean RtpAnalysisDialog::saveAudioAU(StreamDirection direction, QFile *save_f
             {
                 return FALSE;
             }
-            if (! saveAudioAUUnidir(rev_statinfo_.rtp_stats, rev_tempfile_, save_file, header_end, stop_flag, FALSE, rev_samples_diff + bidir_samples_diff))
+            if (! saveAudioAUUnidir(rev_statinfo_.rtp_stats, rev_tempfile_, save_file, header_end, stop_flag, FALSE, rev_samples_diff + bidir_samples_diff, little_endian))
             {
                 return FALSE;
             }
@@ -1290,13 +1319,25 @@ gboolean RtpAnalysisDialog::saveAudioAU(StreamDirection direction, QFile *save_f
             {
                 return FALSE;
             }
-            if (! saveAudioAUBidir(fwd_statinfo_.rtp_stats, rev_statinfo_.rtp_stats, fwd_tempfile_, rev_tempfile_, save_file, header_end, stop_flag, fwd_samples_diff + bidir_samples_diff, rev_samples_diff + bidir_samples_diff))
+            if (! saveAudioAUBidir(fwd_statinfo_.rtp_stats, rev_statinfo_.rtp_stats, fwd_tempfile_, rev_tempfile_, save_file, header_end, stop_flag, fwd_samples_diff + bidir_samples_diff, rev_samples_diff + bidir_samples_diff, little_endian))
             {
                 return FALSE;
             }
         }
     }
 
+    if (save_format == save_audio_wav_) {
+        /* fill in the RIFF and data chunk sizes */
+        qint64 file_len = save_file->size();
+
+        phtole32(header, (guint32)(file_len - 8));
+        if (!save_file->seek(4) || save_file->write((const char *)header, 4) != 4)
+            return FALSE;
+        phtole32(header, (guint32)(file_len - header_end));
+        if (!save_file->seek(40) || save_file->write((const char *)header, 4) != 4)
+            return FALSE;
+    }
+
     return TRUE;
 }
 
@@ -1323,22 +1364,19 @@ gboolean RtpAnalysisDialog::saveAudioRAW(StreamDirection direction, QFile *save_
 
     /* Copy just payload */
     while (sizeof(save_data) == tempfile->read((char *)&save_data,sizeof(save_data))) {
-        char f_rawvalue;
-
         if (*stop_flag) {
             return FALSE;
         }
 
-        ui->progressFrame->setValue(int(tempfile->pos() * 100 / fwd_tempfile_->size()));
+        ui->progressFrame->setValue(int(tempfile->pos() * 100 / tempfile->size()));
 
         if (save_data.payload_len > 0) {
-            for(size_t i = 0; i < save_data.payload_len; i++) {
-                if (sizeof(f_rawvalue) != tempfile->read((char *)&f_rawvalue, sizeof(f_rawvalue))) {
-                    return FALSE;
-                }
-                if (sizeof(f_rawvalue) != save_file->write((char *)&f_rawvalue, sizeof(f_rawvalue))) {
-                    return FALSE;
-                }
+            QByteArray payload = tempfile->read(save_data.payload_len);
+            if ((size_t)payload.size() != save_data.payload_len) {
+                return FALSE;
+            }
+            if (save_file->write(payload) != payload.size()) {
+                return FALSE;
             }
         }
     }
@@ -1346,8 +1384,6 @@ gboolean RtpAnalysisDialog::saveAudioRAW(StreamDirection direction, QFile *save_
     return TRUE;
 }
 
-// rtp_analysis.c:copy_file
-enum { save_audio_none_, save_audio_au_, save_audio_raw_ };
 void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction, RtpAnalysisDialog::SyncType sync)
 {
     if (!fwd_tempfile_->isOpen() || !rev_tempfile_->isOpen()) return;
@@ -1369,8 +1405,11 @@ void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction,
 
     QString ext_filter = "";
     QString ext_filter_au = tr("Sun Audio (*.au)");
+    QString ext_filter_wav = tr("WAV (*.wav)");
     QString ext_filter_raw = tr("Raw (*.raw)");
     ext_filter.append(ext_filter_au);
+    ext_filter.append(";;");
+    ext_filter.append(ext_filter_wav);
     if (direction != dir_both_) {
         ext_filter.append(";;");
         ext_filter.append(ext_filter_raw);
@@ -1385,6 +1424,8 @@ void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction,
     int save_format = save_audio_none_;
     if (0 == QString::compare(sel_filter, ext_filter_au)) {
         save_format = save_audio_au_;
+    } else if (0 == QString::compare(sel_filter, ext_filter_wav)) {
+        save_format = save_audio_wav_;
     } else if (0 == QString::compare(sel_filter, ext_filter_raw)) {
         save_format = save_audio_raw_;
     }
@@ -1397,7 +1438,8 @@ void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction,
     QFile      save_file(file_path);
     gboolean   stop_flag = FALSE;
 
-    save_file.open(QIODevice::WriteOnly);
+    /* Interleaved samples are read back to fill in the second channel */
+    save_file.open(QIODevice::ReadWrite | QIODevice::Truncate);
     fwd_tempfile_->seek(0);
     rev_tempfile_->seek(0);
 
@@ -1409,13 +1451,13 @@ void RtpAnalysisDialog::saveAudio(RtpAnalysisDialog::StreamDirection direction,
     ui->hintLabel->setText(tr("Saving %1" UTF8_HORIZONTAL_ELLIPSIS).arg(save_file.fileName()));
     ui->progressFrame->showProgress(true, true, &stop_flag);
 
-    if (save_format == save_audio_au_) { /* au format */
+    if (save_format == save_audio_au_ || save_format == save_audio_wav_) { /* au or wav format */
         if ((fwd_statinfo_.rtp_stats.clock_rate != 8000) ||
             ((rev_statinfo_.rtp_stats.clock_rate != 0) && (rev_statinfo_.rtp_stats.clock_rate != 8000))
            ) {
             QMessageBox::warning(this, tr("Warning"), tr("Can save audio with 8000 Hz clock rate only"));
         } else {
-            if (! saveAudioAU(direction, &save_file, &stop_flag, sync)) {
+            if (! saveAudioAU(direction, &save_file, &stop_flag, sync, save_format)) {
                 goto copy_file_err;
             }
         }
@@ -26,6 +26,8 @@
 
 #include <wsutil/nstime.h>
 
+#include <algorithm> // for std::upper_bound
+
 #include <QAudioFormat>
 #include <QAudioOutput>
 #include <QDir>
@@ -140,6 +142,8 @@ void RtpAudioStream::reset(double start_rel_time)
     audio_out_rate_ = 0;
     max_sample_val_ = 1;
     packet_timestamps_.clear();
+    packet_first_samples_.clear();
+    packet_frame_nums_.clear();
     visual_samples_.clear();
     out_of_seq_timestamps_.clear();
     jitter_drop_timestamps_.clear();
@@ -376,8 +380,12 @@ void RtpAudioStream::decode()
         }
 
         speex_resampler_process_int(visual_resampler_, 0, decode_buff, &in_len, resample_buff, &out_len);
+        if (out_len > 0) {
+            packet_timestamps_.append(stop_rel_time_);
+            packet_first_samples_.append(visual_samples_.size());
+            packet_frame_nums_.append(rtp_packet->frame_num);
+        }
         for (unsigned i = 0; i < out_len; i++) {
-            packet_timestamps_[stop_rel_time_ + (double) i / visual_out_rate] = rtp_packet->frame_num;
             if (qAbs(resample_buff[i]) > max_sample_val_) max_sample_val_ = qAbs(resample_buff[i]);
             visual_samples_.append(resample_buff[i]);
         }
@@ -397,12 +405,16 @@ const QStringList RtpAudioStream::payloadNames() const
 
 const QVector<double> RtpAudioStream::visualTimestamps(bool relative)
 {
-    QVector<double> ts_keys = packet_timestamps_.keys().toVector();
-    if (relative) return ts_keys;
-
     QVector<double> adj_timestamps;
-    for (int i = 0; i < ts_keys.size(); i++) {
-        adj_timestamps.append(ts_keys[i] + start_abs_offset_);
+    double offset = relative ? 0.0 : start_abs_offset_;
+
+    adj_timestamps.reserve(visual_samples_.size());
+    for (int pkt = 0; pkt < packet_timestamps_.size(); pkt++) {
+        int first = packet_first_samples_[pkt];
+        int end = pkt + 1 < packet_first_samples_.size() ? packet_first_samples_[pkt + 1] : visual_samples_.size();
+        for (int i = first; i < end; i++) {
+            adj_timestamps.append(packet_timestamps_[pkt] + offset + (double) (i - first) / visual_sample_rate_);
+        }
     }
     return adj_timestamps;
 }
@@ -417,6 +429,7 @@ const QVector<double> RtpAudioStream::visualSamples(int y_offset)
 {
     QVector<double> adj_samples;
     double scaled_offset = y_offset * stack_offset_;
+    adj_samples.reserve(visual_samples_.size());
     for (int i = 0; i < visual_samples_.size(); i++) {
         adj_samples.append(((double)visual_samples_[i] * G_MAXINT16 / max_sample_val_) + scaled_offset);
     }
@@ -509,12 +522,16 @@ const QVector<double> RtpAudioStream::insertedSilenceSamples(int y_offset)
 
 quint32 RtpAudioStream::nearestPacket(double timestamp, bool is_relative)
 {
-    if (packet_timestamps_.keys().count() < 1) return 0;
+    if (packet_timestamps_.size() < 1) return 0;
 
     if (!is_relative) timestamp -= start_abs_offset_;
-    QMap<double, quint32>::const_iterator it = packet_timestamps_.lowerBound(timestamp);
-    if (it == packet_timestamps_.end()) return 0;
-    return it.value();
+    double last_ts = packet_timestamps_.last() + (double) (visual_samples_.size() - 1 - packet_first_samples_.last()) / visual_sample_rate_;
+    if (timestamp > last_ts) return 0;
+
+    // Find the last packet that starts at or before timestamp.
+    QVector<double>::const_iterator it = std::upper_bound(packet_timestamps_.constBegin(), packet_timestamps_.constEnd(), timestamp);
+    if (it != packet_timestamps_.constBegin()) --it;
+    return packet_frame_nums_[int(it - packet_timestamps_.constBegin())];
 }
 
 QAudio::State RtpAudioStream::outputState() const
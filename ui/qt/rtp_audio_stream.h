@@ -21,7 +21,6 @@
 
 #include <QAudio>
 #include <QColor>
-#include <QMap>
 #include <QObject>
 #include <QSet>
 #include <QVector>
@@ -157,7 +156,12 @@ private:
     struct SpeexResamplerState_ *audio_resampler_;
     struct SpeexResamplerState_ *visual_resampler_;
     QAudioOutput *audio_output_;
-    QMap<double, quint32> packet_timestamps_;
+    // Start time, index of the first visual sample, and frame number of
+    // each packet that produced visual samples. Sample timestamps are
+    // derived from these instead of being stored per sample.
+    QVector<double> packet_timestamps_;
+    QVector<int> packet_first_samples_;
+    QVector<quint32> packet_frame_nums_;
     QVector<qint16> visual_samples_;
     QVector<double> out_of_seq_timestamps_;
     QVector<double> jitter_drop_timestamps_;
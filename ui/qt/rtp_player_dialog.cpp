@@ -25,6 +25,7 @@
 
 #include <QAudio>
 #include <QAudioDeviceInfo>
+#include <QElapsedTimer>
 #include <QFrame>
 #include <QMenu>
 #include <QVBoxLayout>
@@ -42,7 +43,8 @@
 // - Make streams checkable.
 // - Add silence, drop & jitter indicators to the graph.
 // - How to handle multiple channels?
-// - Threaded decoding?
+// - Threaded decoding? Decoders and the audio device queries aren't
+//   thread safe, so for now we plot each stream as soon as it's decoded.
 // - Play MP3s. As per Zawinski's Law we already read emails.
 // - RTP audio streams are currently keyed on src addr + src port + dst addr
 //   + dst port + ssrc. This means that we can have multiple rtp_stream_info
@@ -67,6 +69,9 @@
 
 // In some places we match by conv/call number, in others we match by first frame.
 
+// How often to replot while decoding streams, in ms.
+static const int progressive_update_freq_ = 100;
+
 enum {
     src_addr_col_,
     src_port_col_,
@@ -161,6 +166,7 @@ RtpPlayerDialog::RtpPlayerDialog(QWidget &parent, CaptureFile &cf) :
 
     ui->audioPlot->setMouseTracking(true);
     ui->audioPlot->setEnabled(true);
+    set_plot_rendering_hints(ui->audioPlot);
     ui->audioPlot->setInteractions(
                 QCP::iRangeDrag |
                 QCP::iRangeZoom
@@ -238,6 +244,9 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
 
     ui->audioPlot->xAxis->setTickLabelType(relative_timestamps ? QCPAxis::ltNumber : QCPAxis::ltDateTime);
 
+    QElapsedTimer elapsed_timer;
+    elapsed_timer.start();
+
     for (int row = 0; row < row_count; row++) {
         QTreeWidgetItem *ti = ui->streamTreeWidget->topLevelItem(row);
         RtpAudioStream *audio_stream = ti->data(stream_data_col_, Qt::UserRole).value<RtpAudioStream*>();
@@ -340,6 +349,15 @@ void RtpPlayerDialog::rescanPackets(bool rescale_axes)
                 seq_graph->removeFromLegend();
             }
         }
+
+        // Show the waveforms we have so far instead of leaving the dialog
+        // blank until every stream is decoded.
+        if (row < row_count - 1 && elapsed_timer.elapsed() > progressive_update_freq_) {
+            ui->audioPlot->replot();
+            wsApp->processEvents(QEventLoop::ExcludeUserInputEvents);
+            if (dialogClosed()) return;
+            elapsed_timer.start();
+        }
     }
     ui->audioPlot->legend->setVisible(show_legend);
 
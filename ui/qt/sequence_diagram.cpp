@@ -194,6 +194,17 @@ void SequenceDiagram::setSelectedPacket(int selected_packet)
     } else {
         selected_packet_ = 0;
     }
+
+    // draw() only visits visible items, so look the key up here.
+    if (selected_packet_ > 0) {
+        WSCPSeqDataMap::const_iterator it;
+        for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
+            if (it.value().value->frame_number == selected_packet_) {
+                selected_key_ = it.key();
+                break;
+            }
+        }
+    }
     mParentPlot->replot();
 }
 
@@ -239,8 +250,14 @@ void SequenceDiagram::draw(QCPPainter *painter)
     painter->restore();
     fg_pen = mainPen();
 
+    QFontMetrics cfm(comment_axis_->tickLabelFont());
+    double en_w = cfm.height() / 2.0;
+
+    // Items are keyed by row and each covers key +/- 0.5, so only visit
+    // the ones that overlap the visible key range.
+    double upper_key = key_axis_->range().upper + 0.5;
     WSCPSeqDataMap::const_iterator it;
-    for (it = data_->constBegin(); it != data_->constEnd(); ++it) {
+    for (it = data_->lowerBound(key_axis_->range().lower - 0.5); it != data_->constEnd() && it.key() <= upper_key; ++it) {
         double cur_key = it.key();
         seq_analysis_item_t *sai = it.value().value;
         QColor bg_color;
@@ -298,8 +315,6 @@ void SequenceDiagram::draw(QCPPainter *painter)
         if (mainPen().style() != Qt::NoPen && mainPen().color().alpha() != 0) {
             painter->save();
 
-            QFontMetrics cfm(comment_axis_->tickLabelFont());
-            double en_w = cfm.height() / 2.0;
             int dir_mul = (sai->src_node < sai->dst_node) ? 1 : -1;
             double ah_size = (cfm.height() / 5) * dir_mul;
             QPoint arrow_start(coordsToPixels(cur_key, sai->src_node).toPoint());
@@ -355,18 +370,11 @@ QCPRange SequenceDiagram::getKeyRange(bool &validRange, QCPAbstractPlottable::Si
     QCPRange range;
     bool valid = false;
 
-    WSCPSeqDataMap::const_iterator it = data_->constBegin();
-    while (it != data_->constEnd()) {
-        double cur_key = it.key();
-        if (!valid) {
-            range.lower = range.upper = cur_key;
-            valid = true;
-        } else if (cur_key < range.lower) {
-            range.lower = cur_key;
-        } else if (cur_key > range.upper) {
-            range.upper = cur_key;
-        }
-        ++it;
+    // The map is sorted by key.
+    if (!data_->isEmpty()) {
+        range.lower = data_->firstKey();
+        range.upper = data_->lastKey();
+        valid = true;
     }
     validRange = valid;
     return range;
@@ -79,13 +79,21 @@ class SrtRowTreeWidgetItem : public QTreeWidgetItem
 public:
     SrtRowTreeWidgetItem(QTreeWidgetItem *parent, const srt_procedure_t *procedure) :
         QTreeWidgetItem (parent, srt_row_type_),
-        procedure_(procedure)
+        procedure_(procedure),
+        drawn_num_(0)
     {
         setText(SRT_COLUMN_PROCEDURE, procedure_->procedure);
         setHidden(true);
     }
 
-    void draw() {
+    // Returns true if the procedure was updated since it was last drawn.
+    bool draw() {
+        // Every change to a procedure's statistics adds a call. Skip
+        // untouched rows, so that a redraw of a table with thousands of
+        // procedures only updates the ones that changed.
+        if (procedure_->stats.num == drawn_num_) return false;
+        drawn_num_ = procedure_->stats.num;
+
         setText(SRT_COLUMN_INDEX, QString::number(procedure_->proc_index));
         setText(SRT_COLUMN_CALLS, QString::number(procedure_->stats.num));
         setText(SRT_COLUMN_MIN, QString::number(nstime_to_sec(&procedure_->stats.min), 'f', 6));
@@ -99,6 +107,7 @@ public:
         }
 
         setHidden(procedure_->stats.num < 1);
+        return true;
     }
 
     bool operator< (const QTreeWidgetItem &other) const
@@ -137,6 +146,7 @@ public:
     }
 private:
     const srt_procedure_t *procedure_;
+    guint32 drawn_num_;
 };
 
 class SrtTableTreeWidgetItem : public QTreeWidgetItem
@@ -243,14 +253,16 @@ void ServiceResponseTimeDialog::tapDraw(void *srtd_ptr)
     ServiceResponseTimeDialog *srt_dlg = static_cast<ServiceResponseTimeDialog *>(srtd->user_data);
     if (!srt_dlg || !srt_dlg->statsTreeWidget()) return;
 
+    bool changed = false;
     QTreeWidgetItemIterator it(srt_dlg->statsTreeWidget());
     while (*it) {
         if ((*it)->type() == srt_row_type_) {
             SrtRowTreeWidgetItem *srtr_ti = static_cast<SrtRowTreeWidgetItem *>((*it));
-            srtr_ti->draw();
+            if (srtr_ti->draw()) changed = true;
         }
         ++it;
     }
+    if (!changed) return;
 
     for (int i = 0; i < srt_dlg->statsTreeWidget()->columnCount() - 1; i++) {
         srt_dlg->statsTreeWidget()->resizeColumnToContents(i);
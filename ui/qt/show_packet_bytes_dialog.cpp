@@ -29,7 +29,7 @@
 // To do:
 // - Add show as custom protocol in a Packet Details view
 // - Use ByteViewText to ShowAsHexDump and supplementary view for custom protocol
-// - Handle large data blocks
+// - Handle large data blocks better than only displaying the start of them
 
 ShowPacketBytesDialog::ShowPacketBytesDialog(QWidget &parent, CaptureFile &cf) :
     WiresharkDialog(parent, cf),
@@ -37,7 +37,8 @@ ShowPacketBytesDialog::ShowPacketBytesDialog(QWidget &parent, CaptureFile &cf) :
     finfo_(cf.capFile()->finfo_selected),
     decode_as_(DecodeAsNone),
     show_as_(ShowAsASCII),
-    use_regex_find_(false)
+    use_regex_find_(false),
+    display_truncated_(false)
 {
     ui->setupUi(this);
     loadGeometry(parent.width() * 2 / 3, parent.height() * 3 / 4);
@@ -163,6 +164,13 @@ void ShowPacketBytesDialog::updateHintLabel()
                     "</span>");
     }
 
+    if (display_truncated_) {
+        hint.append(" <span style=\"color: red\">" +
+                    tr("Showing the first %1 of %Ln decoded byte(s); find and print only cover those.", "", field_bytes_.length())
+                        .arg(max_display_bytes_) +
+                    "</span>");
+    }
+
     ui->hintLabel->setText("<small><i>" + hint + "</i></small>");
 }
 
@@ -258,12 +266,8 @@ void ShowPacketBytesDialog::copyBytes()
     switch (show_as_) {
 
     case ShowAsASCII:
-    {
-        QByteArray ba(field_bytes_);
-        sanitizeBuffer(ba, true);
-        wsApp->clipboard()->setText(ba);
+        wsApp->clipboard()->setText(plainText(field_bytes_, true));
         break;
-    }
 
     case ShowAsASCIIandControl:
     case ShowAsCArray:
@@ -272,7 +276,7 @@ void ShowPacketBytesDialog::copyBytes()
     case ShowAsISO8859_1:
     case ShowAsRAW:
     case ShowAsYAML:
-        wsApp->clipboard()->setText(ui->tePacketBytes->toPlainText());
+        wsApp->clipboard()->setText(plainText(field_bytes_));
         break;
 
     case ShowAsHTML:
@@ -285,7 +289,7 @@ void ShowPacketBytesDialog::copyBytes()
 
     case ShowAsUTF8:
     case ShowAsUTF16:
-        wsApp->clipboard()->setText(ui->tePacketBytes->toPlainText().toUtf8());
+        wsApp->clipboard()->setText(plainText(field_bytes_).toUtf8());
         break;
     }
 }
@@ -303,12 +307,8 @@ void ShowPacketBytesDialog::saveAs()
     switch (show_as_) {
 
     case ShowAsASCII:
-    {
-        QByteArray ba(field_bytes_);
-        sanitizeBuffer(ba, true);
-        file.write(ba);
+        file.write(plainText(field_bytes_, true).toUtf8());
         break;
-    }
 
     case ShowAsASCIIandControl:
     case ShowAsCArray:
@@ -318,7 +318,7 @@ void ShowPacketBytesDialog::saveAs()
     case ShowAsYAML:
     {
         QTextStream out(&file);
-        out << ui->tePacketBytes->toPlainText();
+        out << plainText(field_bytes_);
         break;
     }
 
@@ -333,7 +333,7 @@ void ShowPacketBytesDialog::saveAs()
     case ShowAsUTF16:
     {
         QTextStream out(&file);
-        out << ui->tePacketBytes->toPlainText().toUtf8();
+        out << plainText(field_bytes_).toUtf8();
         break;
     }
 
@@ -447,6 +447,9 @@ void ShowPacketBytesDialog::symbolizeBuffer(QByteArray &ba)
     ba.replace((char)0x7f, symbol); // DEL
 }
 
+// More decoded bytes than this are not displayed; see updatePacketBytes().
+const int ShowPacketBytesDialog::max_display_bytes_ = 1024 * 1024;
+
 QByteArray ShowPacketBytesDialog::decodeQuotedPrintable(const guint8 *bytes, int length)
 {
     QByteArray ba;
@@ -545,36 +548,30 @@ void ShowPacketBytesDialog::updateFieldBytes(bool initialization)
     updatePacketBytes();
 }
 
-void ShowPacketBytesDialog::updatePacketBytes(void)
+// Text for the "Show as" types that are displayed as plain text.
+QString ShowPacketBytesDialog::plainText(const QByteArray &bytes, bool keep_CR)
 {
     static const gchar hexchars[16] = {'0','1','2','3','4','5','6','7','8','9','a','b','c','d','e','f'};
 
-    ui->tePacketBytes->clear();
-    ui->tePacketBytes->setCurrentFont(wsApp->monospaceFont());
-
     switch (show_as_) {
 
     case ShowAsASCII:
     {
-        QByteArray ba(field_bytes_);
-        sanitizeBuffer(ba, false);
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(ba);
-        break;
+        QByteArray ba(bytes);
+        sanitizeBuffer(ba, keep_CR);
+        return QString::fromUtf8(ba);
     }
 
     case ShowAsASCIIandControl:
     {
-        QByteArray ba(field_bytes_);
+        QByteArray ba(bytes);
         symbolizeBuffer(ba);
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(ba);
-        break;
+        return QString::fromUtf8(ba);
     }
 
     case ShowAsCArray:
     {
-        int pos = 0, len = field_bytes_.length();
+        int pos = 0, len = bytes.length();
         QString text("char packet_bytes[] = {\n");
 
         while (pos < len) {
@@ -588,8 +585,8 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
                 *cur++ = ' ';
                 *cur++ = '0';
                 *cur++ = 'x';
-                *cur++ = hexchars[(field_bytes_[pos + i] & 0xf0) >> 4];
-                *cur++ = hexchars[field_bytes_[pos + i] & 0x0f];
+                *cur++ = hexchars[(bytes[pos + i] & 0xf0) >> 4];
+                *cur++ = hexchars[bytes[pos + i] & 0x0f];
 
                 // Delimit array entries with a comma
                 if (pos + i + 1 < len)
@@ -604,24 +601,20 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
         }
 
         text.append("};\n");
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::NoWrap);
-        ui->tePacketBytes->setPlainText(text);
-        break;
+        return text;
     }
 
     case ShowAsEBCDIC:
     {
-        QByteArray ba(field_bytes_);
+        QByteArray ba(bytes);
         EBCDIC_to_ASCII((guint8*)ba.data(), ba.length());
-        sanitizeBuffer(ba, false);
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(ba);
-        break;
+        sanitizeBuffer(ba, keep_CR);
+        return QString::fromUtf8(ba);
     }
 
     case ShowAsHexDump:
     {
-        int pos = 0, len = field_bytes_.length();
+        int pos = 0, len = bytes.length();
         // Use 16-bit offset if there are <= 65536 bytes, 32-bit offset if there are more
         unsigned int offset_chars = (len - 1 <= 0xFFFF) ? 4 : 8;
         QString text;
@@ -637,8 +630,8 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
 
             // Dump bytes as hex
             for (i = 0; i < 16 && pos + i < len; i++) {
-                *cur++ = hexchars[(field_bytes_[pos + i] & 0xf0) >> 4];
-                *cur++ = hexchars[field_bytes_[pos + i] & 0x0f];
+                *cur++ = hexchars[(bytes[pos + i] & 0xf0) >> 4];
+                *cur++ = hexchars[bytes[pos + i] & 0x0f];
                 *cur++ = ' ';
                 if (i == 7)
                     *cur++ = ' ';
@@ -649,8 +642,8 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
 
             // Dump bytes as text
             for (i = 0; i < 16 && pos + i < len; i++) {
-                if (g_ascii_isprint(field_bytes_[pos + i]))
-                    *cur++ = field_bytes_[pos + i];
+                if (g_ascii_isprint(bytes[pos + i]))
+                    *cur++ = bytes[pos + i];
                 else
                     *cur++ = '.';
                 if (i == 7)
@@ -664,11 +657,60 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
             text.append(hexbuf);
         }
 
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::NoWrap);
-        ui->tePacketBytes->setPlainText(text);
+        return text;
+    }
+
+    case ShowAsISO8859_1:
+        return QString::fromLatin1(bytes.constData(), (int)bytes.length());
+
+    case ShowAsUTF8:
+        // The QString docs say that invalid characters will be replaced with
+        // replacement characters or removed. It would be nice if we could
+        // explicitly choose one or the other.
+        return QString::fromUtf8(bytes.constData(), (int)bytes.length());
+
+    case ShowAsUTF16:
+        // QString::fromUtf16 calls QUtf16::convertToUnicode, casting buffer
+        // back to a const char * and doubling nchars.
+        return QString::fromUtf16((const unsigned short *)bytes.constData(), (int)bytes.length() / 2);
+
+    case ShowAsYAML:
+    {
+        const int base64_raw_len = 57; // Encodes to 76 bytes, common in RFCs
+        int pos = 0, len = bytes.length();
+        QString text("# Packet Bytes: !!binary |\n");
+
+        while (pos < len) {
+            QByteArray base64_data = bytes.mid(pos, base64_raw_len);
+            pos += base64_data.length();
+            text.append("  " + base64_data.toBase64() + "\n");
+        }
+
+        return text;
+    }
+
+    case ShowAsRAW:
+        return QString::fromLatin1(bytes.toHex());
+
+    case ShowAsHTML:
+    case ShowAsImage:
         break;
     }
 
+    return QString();
+}
+
+void ShowPacketBytesDialog::updatePacketBytes(void)
+{
+    ui->tePacketBytes->clear();
+    ui->tePacketBytes->setCurrentFont(wsApp->monospaceFont());
+
+    // QTextEdit takes very long to lay out a large document, so only the
+    // start of a large field is displayed. Copy and Save as use all of it.
+    display_truncated_ = false;
+
+    switch (show_as_) {
+
     case ShowAsHTML:
         ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
         ui->tePacketBytes->setHtml(field_bytes_);
@@ -691,57 +733,25 @@ void ShowPacketBytesDialog::updatePacketBytes(void)
         break;
     }
 
-    case ShowAsISO8859_1:
-    {
-        QString latin1 = QString::fromLatin1(field_bytes_.constData(), (int)field_bytes_.length());
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(latin1);
-        break;
-    }
-
-    case ShowAsUTF8:
-    {
-        // The QString docs say that invalid characters will be replaced with
-        // replacement characters or removed. It would be nice if we could
-        // explicitly choose one or the other.
-        QString utf8 = QString::fromUtf8(field_bytes_.constData(), (int)field_bytes_.length());
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(utf8);
-        break;
-    }
-
-    case ShowAsUTF16:
-    {
-        // QString::fromUtf16 calls QUtf16::convertToUnicode, casting buffer
-        // back to a const char * and doubling nchars.
-        QString utf16 = QString::fromUtf16((const unsigned short *)field_bytes_.constData(), (int)field_bytes_.length() / 2);
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(utf16);
-        break;
-    }
-
+    case ShowAsCArray:
+    case ShowAsHexDump:
     case ShowAsYAML:
-    {
-        const int base64_raw_len = 57; // Encodes to 76 bytes, common in RFCs
-        int pos = 0, len = field_bytes_.length();
-        QString text("# Packet Bytes: !!binary |\n");
-
-        while (pos < len) {
-            QByteArray base64_data = field_bytes_.mid(pos, base64_raw_len);
-            pos += base64_data.length();
-            text.append("  " + base64_data.toBase64() + "\n");
+    default:
+        if (show_as_ == ShowAsCArray || show_as_ == ShowAsHexDump || show_as_ == ShowAsYAML) {
+            ui->tePacketBytes->setLineWrapMode(QTextEdit::NoWrap);
+        } else {
+            ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
+        }
+        if (field_bytes_.length() > max_display_bytes_) {
+            display_truncated_ = true;
+            ui->tePacketBytes->setPlainText(plainText(field_bytes_.left(max_display_bytes_)));
+        } else {
+            ui->tePacketBytes->setPlainText(plainText(field_bytes_));
         }
-
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::NoWrap);
-        ui->tePacketBytes->setPlainText(text);
         break;
     }
 
-    case ShowAsRAW:
-        ui->tePacketBytes->setLineWrapMode(QTextEdit::WidgetWidth);
-        ui->tePacketBytes->setPlainText(field_bytes_.toHex());
-        break;
-    }
+    updateHintLabel();
 }
 
 void ShowPacketBytesDialog::captureFileClosing()
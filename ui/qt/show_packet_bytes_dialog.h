@@ -93,9 +93,12 @@ private:
     void symbolizeBuffer(QByteArray &ba);
     QByteArray decodeQuotedPrintable(const guint8 *bytes, int length);
     void rot13(QByteArray &ba);
+    QString plainText(const QByteArray &bytes, bool keep_CR = false);
     void updateFieldBytes(bool initialization = false);
     void updatePacketBytes();
 
+    static const int max_display_bytes_;
+
     Ui::ShowPacketBytesDialog  *ui;
 
     const field_info  *finfo_;
@@ -107,6 +110,7 @@ private:
     DecodeAsType decode_as_;
     ShowAsType  show_as_;
     bool        use_regex_find_;
+    bool        display_truncated_;
     int         start_;
     int         end_;
     QImage      image_;
@@ -82,6 +82,8 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
     ts_origin_conn_(true),
     seq_offset_(0),
     seq_origin_zero_(true),
+    segment_index_(NULL),
+    tput_samples_valid_(false),
     title_(NULL),
     base_graph_(NULL),
     tput_graph_(NULL),
@@ -302,6 +304,7 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
         fillGraph();
 
     sp->setMouseTracking(true);
+    set_plot_rendering_hints(sp);
 
     sp->yAxis->setLabelColor(QColor(graph_color_1));
     sp->yAxis->setTickLabelColor(QColor(graph_color_1));
@@ -331,6 +334,8 @@ TCPStreamDialog::TCPStreamDialog(QWidget *parent, capture_file *cf, tcp_graph_ty
 
 TCPStreamDialog::~TCPStreamDialog()
 {
+    graph_.segments = NULL;
+    graph_segment_index_free(segment_index_);
     delete ui;
 }
 
@@ -479,8 +484,18 @@ void TCPStreamDialog::findStream()
     if (spin_box_focused)
         ui->streamNumberSpinBox->clearFocus();
     ui->streamNumberSpinBox->setEnabled(false);
-    graph_segment_list_free(&graph_);
-    graph_segment_list_get(cap_file_, &graph_, TRUE);
+    // Index every stream on the first pass and look streams up from there.
+    // Rebuild if packets were added since, e.g. during a live capture, or
+    // if they were dissected again, e.g. after a preference change.
+    if (cap_file_ && (!segment_index_
+                      || segment_index_->frame_count != cap_file_->count
+                      || segment_index_->dissection_gen != cap_file_->dissection_gen)) {
+        graph_.segments = NULL;
+        graph_segment_index_free(segment_index_);
+        segment_index_ = graph_segment_index_new(cap_file_);
+    }
+    graph_segment_list_from_index(segment_index_, &graph_);
+    tput_samples_valid_ = false;
     ui->streamNumberSpinBox->setEnabled(true);
     if (spin_box_focused)
         ui->streamNumberSpinBox->setFocus();
@@ -1118,43 +1133,25 @@ goodput_adjust_for_sacks(guint32 *seglen, guint32 last_ack,
 }
 #endif // USE_SACKS_IN_GOODPUT_CALC
 
-void TCPStreamDialog::fillThroughput()
+// Collect the packet times and lengths that fillThroughput averages: data
+// lengths for forward packets, newly acked (and SACKed) lengths for
+// reverse packets. Times don't include ts_offset_.
+void TCPStreamDialog::fillThroughputSamples()
 {
-    QString dlg_title = QString(tr("Throughput")) + streamDescription();
-#ifdef MA_1_SECOND
-    dlg_title.append(tr(" (MA)"));
-#else
-    dlg_title.append(QString(tr(" (%1 Segment MA)")).arg(moving_avg_period_));
-#endif
-    setWindowTitle(dlg_title);
-    title_->setText(dlg_title);
-
-    QCustomPlot *sp = ui->streamPlot;
-    sp->yAxis->setLabel(segment_length_label_);
-    sp->yAxis2->setLabel(average_throughput_label_);
-    sp->yAxis2->setLabelColor(QColor(graph_color_2));
-    sp->yAxis2->setTickLabelColor(QColor(graph_color_2));
-    sp->yAxis2->setVisible(true);
-
-    base_graph_->setVisible(ui->showSegLengthCheckBox->isChecked());
-    tput_graph_->setVisible(ui->showThroughputCheckBox->isChecked());
-    goodput_graph_->setVisible(ui->showGoodputCheckBox->isChecked());
+    tput_seg_times_.clear();
+    tput_seg_lens_.clear();
+    tput_ack_times_.clear();
+    tput_ack_lens_.clear();
+    tput_samples_valid_ = true;
 
 #ifdef MA_1_SECOND
     if (!graph_.segments) {
 #else
     if (!graph_.segments || !graph_.segments->next) {
 #endif
-        dlg_title.append(tr(" [not enough data]"));
         return;
     }
 
-    QVector<double> seg_rel_times, ack_rel_times;
-    QVector<double> seg_lens, ack_lens;
-    QVector<double> tput_times, gput_times;
-    QVector<double> tputs, gputs;
-    int oldest_seg = 0, oldest_ack = 0;
-    guint64 seg_sum = 0, ack_sum = 0;
     guint32 seglen = 0;
 
 #ifdef USE_SACKS_IN_GOODPUT_CALC
@@ -1181,30 +1178,13 @@ void TCPStreamDialog::fillThroughput()
             break;
         }
     }
-    // Financial charts don't show MA data until a full period has elapsed.
-    //  [ NOTE - this is because they assume that there's old data that they
-    //      don't have access to - but in our case we know that there's NO
-    //      data prior to the first packet in the stream - so it's fine to
-    //      spit out the MA immediately... ]
-    // The Rosetta Code MA examples start spitting out values immediately.
-    // For now use not-really-correct initial values just to keep our vector
-    // lengths the same.
 #ifdef MA_1_SECOND
-    // NOTE that for the time-based MA case, you certainly can start with the
-    //  first segment!
     for (struct segment *seg = graph_.segments; seg != NULL; seg = seg->next) {
 #else
     for (struct segment *seg = graph_.segments->next; seg != NULL; seg = seg->next) {
 #endif
         bool is_forward_seg = compareHeaders(seg);
-        QVector<double>& r_pkt_times = is_forward_seg ? seg_rel_times : ack_rel_times;
-        QVector<double>& r_lens = is_forward_seg ? seg_lens : ack_lens;
-        QVector<double>& r_Xput_times = is_forward_seg ? tput_times : gput_times;
-        QVector<double>& r_Xputs = is_forward_seg ? tputs : gputs;
-        int& r_oldest = is_forward_seg ? oldest_seg : oldest_ack;
-        guint64& r_sum = is_forward_seg ? seg_sum : ack_sum;
-
-        double ts = (seg->rel_secs + seg->rel_usecs / 1000000.0) - ts_offset_;
+        double ts = seg->rel_secs + seg->rel_usecs / 1000000.0;
 
         if (is_forward_seg) {
             seglen = seg->th_seglen;
@@ -1234,22 +1214,49 @@ void TCPStreamDialog::fillThroughput()
             }
         }
 
-        r_pkt_times.append(ts);
-        r_lens.append(seglen);
+        if (is_forward_seg) {
+            tput_seg_times_.append(ts);
+            tput_seg_lens_.append(seglen);
+        } else {
+            tput_ack_times_.append(ts);
+            tput_ack_lens_.append(seglen);
+        }
+    }
+}
+
+// Compute the moving average throughput (or goodput) of one direction in a
+// single pass, sliding the start of the window forward as we go.
+void TCPStreamDialog::movingAverageXput(const QVector<double> &pkt_times, const QVector<double> &lens,
+                                         QVector<double> &xput_times, QVector<double> &xputs)
+{
+    int oldest = 0;
+    guint64 sum = 0;
+
+    // Financial charts don't show MA data until a full period has elapsed.
+    //  [ NOTE - this is because they assume that there's old data that they
+    //      don't have access to - but in our case we know that there's NO
+    //      data prior to the first packet in the stream - so it's fine to
+    //      spit out the MA immediately... ]
+    // The Rosetta Code MA examples start spitting out values immediately.
+    // For now use not-really-correct initial values just to keep our vector
+    // lengths the same.
+    for (int cur = 0; cur < pkt_times.size(); cur++) {
+        double ts = pkt_times[cur] - ts_offset_;
+        guint32 seglen = (guint32) lens[cur];
 
 #ifdef MA_1_SECOND
-        while (r_oldest < r_pkt_times.size() && ts - r_pkt_times[r_oldest] > ma_window_size_) {
-            r_sum -= r_lens[r_oldest];
+        while (oldest < cur && ts - (pkt_times[oldest] - ts_offset_) > ma_window_size_) {
+            sum -= (guint32) lens[oldest];
             // append points where a packet LEAVES the MA window
             //   (as well as, below, where they ENTER the MA window)
-            r_Xputs.append(r_sum * 8.0 / ma_window_size_);
-            r_Xput_times.append(r_pkt_times[r_oldest] + ma_window_size_);
-            r_oldest++;
+            xputs.append(sum * 8.0 / ma_window_size_);
+            xput_times.append(pkt_times[oldest] - ts_offset_ + ma_window_size_);
+            oldest++;
         }
 #else
-        if (r_lens.size() > moving_avg_period_) {
-            r_sum -= r_lens[r_oldest];
-            r_oldest++;
+        if (cur + 1 > moving_avg_period_) {
+            sum -= (guint32) lens[oldest];
+            oldest++;
         }
 #endif
 
@@ -1257,16 +1264,16 @@ void TCPStreamDialog::fillThroughput()
         //    throughput for forward packets
         //    goodput for reverse packets
         double av_Xput;
-        r_sum += seglen;
+        sum += seglen;
 #ifdef MA_1_SECOND
         // for time-based MA, delta_t is constant
-        av_Xput = r_sum * 8.0 / ma_window_size_;
+        av_Xput = sum * 8.0 / ma_window_size_;
 #else
         double dtime = 0.0;
-        if (r_oldest > 0)
-            dtime = ts - r_pkt_times[r_oldest-1];
+        if (oldest > 0)
+            dtime = ts - (pkt_times[oldest-1] - ts_offset_);
         if (dtime > 0.0) {
-            av_Xput = r_sum * 8.0 / dtime;
+            av_Xput = sum * 8.0 / dtime;
         } else {
             av_Xput = 0.0;
         }
@@ -1275,14 +1282,65 @@ void TCPStreamDialog::fillThroughput()
         // Add a data point only if our time window has advanced. Otherwise
         // update the most recent point. (We might want to show a warning
         // for out-of-order packets.)
-        if (r_Xput_times.size() > 0 && ts <= r_Xput_times.last()) {
-            r_Xputs[r_Xputs.size() - 1] = av_Xput;
+        if (xput_times.size() > 0 && ts <= xput_times.last()) {
+            xputs[xputs.size() - 1] = av_Xput;
         } else {
-            r_Xputs.append(av_Xput);
-            r_Xput_times.append(ts);
+            xputs.append(av_Xput);
+            xput_times.append(ts);
         }
     }
-    base_graph_->setData(seg_rel_times, seg_lens);
+}
+
+void TCPStreamDialog::fillThroughput()
+{
+    QString dlg_title = QString(tr("Throughput")) + streamDescription();
+#ifdef MA_1_SECOND
+    dlg_title.append(tr(" (MA)"));
+#else
+    dlg_title.append(QString(tr(" (%1 Segment MA)")).arg(moving_avg_period_));
+#endif
+    setWindowTitle(dlg_title);
+    title_->setText(dlg_title);
+
+    QCustomPlot *sp = ui->streamPlot;
+    sp->yAxis->setLabel(segment_length_label_);
+    sp->yAxis2->setLabel(average_throughput_label_);
+    sp->yAxis2->setLabelColor(QColor(graph_color_2));
+    sp->yAxis2->setTickLabelColor(QColor(graph_color_2));
+    sp->yAxis2->setVisible(true);
+
+    base_graph_->setVisible(ui->showSegLengthCheckBox->isChecked());
+    tput_graph_->setVisible(ui->showThroughputCheckBox->isChecked());
+    goodput_graph_->setVisible(ui->showGoodputCheckBox->isChecked());
+
+#ifdef MA_1_SECOND
+    if (!graph_.segments) {
+#else
+    if (!graph_.segments || !graph_.segments->next) {
+#endif
+        dlg_title.append(tr(" [not enough data]"));
+        return;
+    }
+
+    // The per-packet lengths only depend on the stream and direction, so
+    // keep them around for moving average window changes.
+    if (!tput_samples_valid_) {
+        fillThroughputSamples();
+    }
+
+    QVector<double> seg_rel_times;
+    QVector<double> tput_times, gput_times;
+    QVector<double> tputs, gputs;
+
+    seg_rel_times.reserve(tput_seg_times_.size());
+    foreach (double ts, tput_seg_times_) {
+        seg_rel_times.append(ts - ts_offset_);
+    }
+
+    movingAverageXput(tput_seg_times_, tput_seg_lens_, tput_times, tputs);
+    movingAverageXput(tput_ack_times_, tput_ack_lens_, gput_times, gputs);
+
+    base_graph_->setData(seg_rel_times, tput_seg_lens_);
     tput_graph_->setData(tput_times, tputs);
     goodput_graph_->setData(gput_times, gputs);
 }
@@ -2065,6 +2123,7 @@ void TCPStreamDialog::on_actionSwitchDirection_triggered()
     graph_.src_port = graph_.dst_port;
     copy_address(&graph_.dst_address, &tmp_addr);
     graph_.dst_port = tmp_port;
+    tput_samples_valid_ = false;
 
     fillGraph(/*reset_axes=*/true, /*set_focus=*/false);
 }
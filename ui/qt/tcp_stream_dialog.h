@@ -62,6 +62,13 @@ private:
     double seq_offset_;
     bool seq_origin_zero_;
     struct tcp_graph graph_;
+    tcp_segment_index_t *segment_index_;
+    // fillThroughput samples for the current stream and direction.
+    bool tput_samples_valid_;
+    QVector<double> tput_seg_times_;
+    QVector<double> tput_seg_lens_;
+    QVector<double> tput_ack_times_;
+    QVector<double> tput_ack_lens_;
     QCPPlotTitle *title_;
     QString stream_desc_;
     QCPGraph *base_graph_; // Clickable packets
@@ -118,6 +125,9 @@ private:
     void fillStevens();
     void fillTcptrace();
     void fillThroughput();
+    void fillThroughputSamples();
+    void movingAverageXput(const QVector<double> &pkt_times, const QVector<double> &lens,
+                           QVector<double> &xput_times, QVector<double> &xputs);
     void fillRoundTripTime();
     void fillWindowScale();
     QString streamDescription();
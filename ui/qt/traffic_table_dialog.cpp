@@ -23,6 +23,7 @@
 #include <QClipboard>
 #include <QContextMenuEvent>
 #include <QDialogButtonBox>
+#include <QHeaderView>
 #include <QList>
 #include <QMap>
 #include <QMessageBox>
@@ -403,6 +404,7 @@ void TrafficTableTreeWidget::setNameResolutionEnabled(bool enable)
     if (resolve_names_ != enable) {
         resolve_names_ = enable;
         updateItems();
+        sortAllItems();
     }
 }
 
@@ -418,9 +420,17 @@ void TrafficTableTreeWidget::contextMenuEvent(QContextMenuEvent *event)
 
 }
 
+void TrafficTableTreeWidget::sortAllItems()
+{
+    if (isSortingEnabled()) {
+        sortItems(sortColumn(), header()->sortIndicatorOrder());
+    }
+}
+
 void TrafficTableTreeWidget::updateItemsForSettingChange()
 {
     updateItems();
+    sortAllItems();
 }
 
 /*
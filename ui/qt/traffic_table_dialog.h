@@ -72,6 +72,9 @@ protected:
 
     // When adding rows, resize to contents up to this number.
     int resizeThreshold() const { return 200; }
+    // Tap draws only sort when rows are added. Call this when the
+    // values of existing rows may have changed order.
+    void sortAllItems();
     void contextMenuEvent(QContextMenuEvent *event);
 
 private:
@@ -14,6 +14,7 @@
 #include <ui/qt/utils/qt_ui_utils.h>
 
 #include <epan/addr_resolv.h>
+#include <epan/prefs.h>
 #include <epan/range.h>
 #include <epan/to_str.h>
 #include <epan/value_string.h>
@@ -23,6 +24,8 @@
 
 #include <wsutil/str_util.h>
 
+#include <ui/qt/widgets/qcustomplot.h>
+
 #include <QAction>
 #include <QApplication>
 #include <QDateTime>
@@ -107,9 +110,9 @@ const QString address_to_display_qstring(const _address *address)
 {
     QString address_qstr = QString();
     if (address) {
-        gchar *address_gchar_p = address_to_display(NULL, address);
-        address_qstr = address_gchar_p;
-        wmem_free(NULL, address_gchar_p);
+        gchar address_buf[MAX_ADDR_STR_LEN];
+        address_to_display_buf(address, address_buf, sizeof address_buf);
+        address_qstr = address_buf;
     }
     return address_qstr;
 }
@@ -238,6 +241,18 @@ bool rect_on_screen(const QRect &rect)
     return false;
 }
 
+void set_plot_rendering_hints(QCustomPlot *plot)
+{
+    // QCPGraph's adaptive sampling already reduces each graph to a few
+    // points per pixel. What's left is mostly the cost of antialiasing.
+    plot->setNoAntialiasingOnDrag(true);
+    if (prefs.gui_graph_fast_rendering) {
+        plot->setNotAntialiasedElements(QCP::aePlottables | QCP::aeScatters | QCP::aeFills |
+                                        QCP::aeGrid | QCP::aeSubGrid | QCP::aeZeroLine);
+        plot->setPlottingHint(QCP::phFastPolylines);
+    }
+}
+
 /*
  * Editor modelines
  *
@@ -24,6 +24,7 @@
 #include <QString>
 
 class QAction;
+class QCustomPlot;
 class QFont;
 class QRect;
 
@@ -213,6 +214,15 @@ void desktop_show_in_folder(const QString file_path);
  */
 bool rect_on_screen(const QRect &rect);
 
+/**
+ * Set how a graph is drawn according to the "gui.graph_fast_rendering"
+ * preference. Antialiasing is always turned off while the graph is
+ * dragged.
+ *
+ * @param plot The graph, typically just after the dialog's setupUi().
+ */
+void set_plot_rendering_hints(QCustomPlot *plot);
+
 #endif /* __QT_UI_UTILS__H__ */
 
 // XXX Add a routine to fetch the HWND corresponding to a widget using QPlatformIntegration
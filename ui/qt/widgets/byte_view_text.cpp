@@ -52,7 +52,9 @@ ByteViewText::ByteViewText(const QByteArray &data, packet_char_enc encoding, QWi
     show_ascii_(true),
     row_width_(recent.gui_bytes_view == BYTES_HEX ? 16 : 8),
     font_width_(0),
-    line_height_(0)
+    line_height_(0),
+    x_pos_row_len_(0),
+    x_pos_bytes_view_(recent.gui_bytes_view)
 {
     layout_->setCacheEnabled(true);
 
@@ -177,12 +179,13 @@ void ByteViewText::setMonospaceFont(const QFont &mono_font)
 
     // We should probably use ProtoTree::rowHeight.
     line_height_ = fontMetrics().height();
+    x_pos_to_column_.clear();
 
     updateScrollbars();
     viewport()->update();
 }
 
-void ByteViewText::paintEvent(QPaintEvent *)
+void ByteViewText::paintEvent(QPaintEvent *event)
 {
     QPainter painter(viewport());
     painter.translate(-horizontalScrollBar()->value() * font_width_, 0);
@@ -210,11 +213,16 @@ void ByteViewText::paintEvent(QPaintEvent *)
     // Data rows
     int widget_height = height();
     int leading = fontMetrics().leading();
+    const QRect &update_rect = event->rect();
     painter.save();
 
-    x_pos_to_column_.clear();
     while( (int) (row_y + line_height_) < widget_height && offset < (int) data_.count()) {
-        drawLine(&painter, offset, row_y);
+        // Hovering only updates the rows it touches. Skip the others,
+        // unless we still need a line for the pixel to column map.
+        if (x_pos_to_column_.isEmpty()
+                || (row_y + line_height_ + leading > update_rect.top() && row_y <= update_rect.bottom())) {
+            drawLine(&painter, offset, row_y);
+        }
         offset += row_width_;
         row_y += line_height_ + leading;
     }
@@ -295,17 +303,23 @@ void ByteViewText::mouseMoveEvent(QMouseEvent *event)
         return;
     }
 
-    hovered_byte_offset_ = byteOffsetAtPixel(event->pos());
+    int byte_offset = byteOffsetAtPixel(event->pos());
+    if (byte_offset == hovered_byte_offset_) {
+        return;
+    }
+
+    updateByteRow(hovered_byte_offset_);
+    hovered_byte_offset_ = byte_offset;
     emit byteHovered(hovered_byte_offset_);
-    viewport()->update();
+    updateByteRow(hovered_byte_offset_);
 }
 
 void ByteViewText::leaveEvent(QEvent *event)
 {
+    updateByteRow(hovered_byte_offset_);
     hovered_byte_offset_ = -1;
     emit byteHovered(hovered_byte_offset_);
 
-    viewport()->update();
     QAbstractScrollArea::leaveEvent(event);
 }
 
@@ -326,10 +340,17 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
         return;
     }
 
-    // Build our pixel to byte offset vector the first time through.
-    bool build_x_pos = x_pos_to_column_.empty() ? true : false;
     int tvb_len = data_.count();
     int max_tvb_pos = qMin(offset + row_width_, tvb_len) - 1;
+    // Build our pixel to byte offset vector if the layout changed.
+    bool build_x_pos = x_pos_to_column_.empty()
+            || x_pos_row_len_ != max_tvb_pos - offset + 1
+            || x_pos_bytes_view_ != recent.gui_bytes_view;
+    if (build_x_pos) {
+        x_pos_to_column_.clear();
+        x_pos_row_len_ = max_tvb_pos - offset + 1;
+        x_pos_bytes_view_ = recent.gui_bytes_view;
+    }
     QList<QTextLayout::FormatRange> fmt_list;
 
     static const guchar hexchars[16] = {
@@ -362,7 +383,9 @@ void ByteViewText::drawLine(QPainter *painter, const int offset, const int row_y
             /* insert a space every separator_interval_ bytes */
             if ((tvb_pos != offset) && ((tvb_pos % separator_interval_) == 0)) {
                 line += ' ';
-                x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
+                if (build_x_pos) {
+                    x_pos_to_column_ += QVector<int>().fill(tvb_pos - offset - 1, font_width_);
+                }
             }
 
             switch (recent.gui_bytes_view) {
@@ -552,6 +575,18 @@ void ByteViewText::scrollToByte(int byte)
 }
 
 // Offset character width
+// Schedule a repaint of the row containing byte.
+void ByteViewText::updateByteRow(int byte)
+{
+    if (byte < 0 || row_width_ < 1) {
+        return;
+    }
+
+    int row_height = line_height_ + fontMetrics().leading();
+    int row = byte / row_width_ - verticalScrollBar()->value();
+    viewport()->update(0, row * row_height, viewport()->width(), row_height);
+}
+
 int ByteViewText::offsetChars(bool include_pad)
 {
     int padding = include_pad ? 2 : 0;
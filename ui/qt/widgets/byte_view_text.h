@@ -54,7 +54,7 @@ public slots:
     void markAppendix(int start, int length);
 
 protected:
-    virtual void paintEvent(QPaintEvent *);
+    virtual void paintEvent(QPaintEvent *event);
     virtual void resizeEvent(QResizeEvent *);
     virtual void mousePressEvent (QMouseEvent * event);
     virtual void mouseMoveEvent (QMouseEvent * event);
@@ -80,6 +80,7 @@ private:
     bool addHexFormatRange(QList<QTextLayout::FormatRange> &fmt_list, int mark_start, int mark_length, int tvb_offset, int max_tvb_pos, HighlightMode mode);
     bool addAsciiFormatRange(QList<QTextLayout::FormatRange> &fmt_list, int mark_start, int mark_length, int tvb_offset, int max_tvb_pos, HighlightMode mode);
     void scrollToByte(int byte);
+    void updateByteRow(int byte);
     void updateScrollbars();
     int byteOffsetAtPixel(QPoint pos);
 
@@ -121,8 +122,11 @@ private:
     int line_height_;           // Font line spacing
     QList<QRect> hover_outlines_; // Hovered byte outlines.
 
-    // Data selection
+    // Data selection. The pixel to column map only depends on the font,
+    // the hex display format and the row length, so it's kept across paints.
     QVector<int> x_pos_to_column_;
+    int x_pos_row_len_;
+    bytes_view_type x_pos_bytes_view_;
 
 private slots:
     void copyBytes(bool);
@@ -33,12 +33,15 @@
 #include <QMessageBox>
 #include <QPainter>
 #include <QStringListModel>
+#include <QVector>
 #include <QWidget>
 #include <QObject>
 #include <QDrag>
 #include <QDropEvent>
 #include <QMimeData>
 
+#include <algorithm>
+
 // To do:
 // - Get rid of shortcuts and replace them with "n most recently applied filters"?
 // - We need simplified (button- and dropdown-free) versions for use in dialogs and field-only checking.
@@ -54,6 +57,44 @@
 // proto.c:fld_abbrev_chars
 static const QString fld_abbrev_chars_ = "-.0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ_abcdefghijklmnopqrstuvwxyz";
 
+// Protocol and field filter names sorted case-insensitively, so that
+// completion is a range lookup instead of a walk over every registered
+// field. Built on first use and dropped when the set of fields changes.
+struct FieldIndexEntry {
+    QString abbrev;
+    int proto_id;
+    int proto_dots; // Periods in the protocol's own filter name.
+    bool is_protocol;
+};
+static QVector<FieldIndexEntry> field_index_;
+
+static bool fieldIndexLessThan(const FieldIndexEntry &a, const FieldIndexEntry &b)
+{
+    return a.abbrev.compare(b.abbrev, Qt::CaseInsensitive) < 0;
+}
+
+static void buildFieldIndex()
+{
+    void *proto_cookie;
+
+    field_index_.clear();
+    for (int proto_id = proto_get_first_protocol(&proto_cookie); proto_id != -1; proto_id = proto_get_next_protocol(&proto_cookie)) {
+        const QString pfname = proto_get_protocol_filter_name(proto_id);
+        int proto_dots = pfname.count('.');
+        FieldIndexEntry proto_entry = { pfname, proto_id, proto_dots, true };
+        field_index_ << proto_entry;
+
+        void *field_cookie;
+        for (header_field_info *hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie)) {
+            if (hfinfo->same_name_prev_id != -1) continue; // Ignore duplicate names.
+
+            FieldIndexEntry field_entry = { hfinfo->abbrev, proto_id, proto_dots, false };
+            field_index_ << field_entry;
+        }
+    }
+    std::sort(field_index_.begin(), field_index_.end(), fieldIndexLessThan);
+}
+
 DisplayFilterEdit::DisplayFilterEdit(QWidget *parent, DisplayFilterEditType type) :
     SyntaxLineEdit(parent),
     type_(type),
@@ -158,6 +199,7 @@ DisplayFilterEdit::DisplayFilterEdit(QWidget *parent, DisplayFilterEditType type
 
     connect(wsApp, &WiresharkApplication::appInitialized, this, &DisplayFilterEdit::updateBookmarkMenu);
     connect(wsApp, &WiresharkApplication::displayFilterListChanged, this, &DisplayFilterEdit::updateBookmarkMenu);
+    connect(wsApp, &WiresharkApplication::fieldsChanged, this, &DisplayFilterEdit::fieldsChanged);
 
 }
 
@@ -408,30 +450,26 @@ void DisplayFilterEdit::buildCompletionList(const QString &field_word)
     completion_model_->setStringList(complex_list);
     completer()->setCompletionPrefix(field_word);
 
-    void *proto_cookie;
+    if (field_index_.isEmpty()) {
+        buildFieldIndex();
+    }
+
     QStringList field_list;
     int field_dots = field_word.count('.'); // Some protocol names (_ws.expert) contain periods.
-    for (int proto_id = proto_get_first_protocol(&proto_cookie); proto_id != -1; proto_id = proto_get_next_protocol(&proto_cookie)) {
-        protocol_t *protocol = find_protocol_by_id(proto_id);
+    FieldIndexEntry key = { field_word, -1, 0, false };
+    QVector<FieldIndexEntry>::const_iterator entry = std::lower_bound(field_index_.constBegin(), field_index_.constEnd(), key, fieldIndexLessThan);
+    for (; entry != field_index_.constEnd() && entry->abbrev.startsWith(field_word, Qt::CaseInsensitive); ++entry) {
+        protocol_t *protocol = find_protocol_by_id(entry->proto_id);
         if (!proto_is_protocol_enabled(protocol)) continue;
 
-        const QString pfname = proto_get_protocol_filter_name(proto_id);
-        field_list << pfname;
-
-        // Add fields only if we're past the protocol name and only for the
-        // current protocol.
-        if (field_dots > pfname.count('.')) {
-            void *field_cookie;
-            const QByteArray fw_ba = field_word.toUtf8(); // or toLatin1 or toStdString?
-            const char *fw_utf8 = fw_ba.constData();
-            gsize fw_len = (gsize) strlen(fw_utf8);
-            for (header_field_info *hfinfo = proto_get_first_protocol_field(proto_id, &field_cookie); hfinfo; hfinfo = proto_get_next_protocol_field(proto_id, &field_cookie)) {
-                if (hfinfo->same_name_prev_id != -1) continue; // Ignore duplicate names.
-
-                if (!g_ascii_strncasecmp(fw_utf8, hfinfo->abbrev, fw_len)) {
-                    if ((gsize) strlen(hfinfo->abbrev) != fw_len) field_list << hfinfo->abbrev;
-                }
-            }
+        if (entry->is_protocol) {
+            field_list << entry->abbrev;
+            continue;
+        }
+
+        // Add fields only if we're past the protocol name.
+        if (field_dots > entry->proto_dots && entry->abbrev.length() != field_word.length()) {
+            field_list << entry->abbrev;
         }
     }
     field_list.sort();
@@ -440,6 +478,11 @@ void DisplayFilterEdit::buildCompletionList(const QString &field_word)
     completer()->setCompletionPrefix(field_word);
 }
 
+void DisplayFilterEdit::fieldsChanged()
+{
+    field_index_.clear();
+}
+
 void DisplayFilterEdit::clearFilter()
 {
     clear();
@@ -50,6 +50,7 @@ private slots:
     void checkFilter(const QString &filter_text);
     void clearFilter();
     void changeEvent(QEvent* event);
+    void fieldsChanged();
 
     void saveFilter();
     void removeFilter();
@@ -226,6 +226,7 @@ void PacketListHeader::columnVisibilityTriggered()
     int col = ha->data().toInt();
     set_column_visible(col, ha->isChecked());
     setSectionVisibility();
+    emit columnVisibilityChanged();
     if (ha->isChecked())
         emit resetColumnWidth(col);
 
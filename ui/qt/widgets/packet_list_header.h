@@ -56,6 +56,7 @@ signals:
     void editColumn(int column);
 
     void columnsChanged();
+    void columnVisibilityChanged();
 
 private:
 
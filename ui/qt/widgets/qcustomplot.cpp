@@ -18791,8 +18791,40 @@ void QCPBars::draw(QCPPainter *painter)
 
   QCPBarDataMap::const_iterator it, lower, upperEnd;
   getVisibleDataBounds(lower, upperEnd);
+
+  // Wireshark: When there are more bars than pixels along the key axis, only
+  // draw the highest (and lowest negative) bar of each pixel column, similar to
+  // QCPGraph's adaptive sampling. This keeps large IO graphs responsive and
+  // refines automatically when zooming in.
+  QVector<QCPBarDataMap::const_iterator> drawBars;
+  QCPBarDataMap::const_iterator colMax = upperEnd, colMin = upperEnd;
+  int column = 0;
   for (it = lower; it != upperEnd; ++it)
   {
+    int itColumn = qRound(mKeyAxis->coordToPixel(it.key()));
+    if (colMax != upperEnd && itColumn != column)
+    {
+      drawBars.append(colMax);
+      if (colMin != colMax && colMin.value().value < 0)
+        drawBars.append(colMin);
+      colMax = colMin = upperEnd;
+    }
+    column = itColumn;
+    if (colMax == upperEnd || it.value().value > colMax.value().value)
+      colMax = it;
+    if (colMin == upperEnd || it.value().value < colMin.value().value)
+      colMin = it;
+  }
+  if (colMax != upperEnd)
+  {
+    drawBars.append(colMax);
+    if (colMin != colMax && colMin.value().value < 0)
+      drawBars.append(colMin);
+  }
+
+  for (int i=0; i<drawBars.size(); ++i)
+  {
+    it = drawBars.at(i);
     // check data validity if flag set:
 #ifdef QCUSTOMPLOT_CHECK_DATA
     if (QCP::isInvalidData(it.value().key, it.value().value))
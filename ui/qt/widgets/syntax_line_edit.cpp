@@ -37,7 +37,8 @@ const int max_completion_items_ = 20;
 SyntaxLineEdit::SyntaxLineEdit(QWidget *parent) :
     QLineEdit(parent),
     completer_(NULL),
-    completion_model_(NULL)
+    completion_model_(NULL),
+    compiled_dfilter_(NULL)
 {
     // Try to matche QLineEdit's placeholder text color (which sets the
     // alpha channel to 50%, which doesn't work in style sheets).
@@ -50,6 +51,11 @@ SyntaxLineEdit::SyntaxLineEdit(QWidget *parent) :
     setMaxLength(std::numeric_limits<quint32>::max());
 }
 
+SyntaxLineEdit::~SyntaxLineEdit()
+{
+    dfilter_free(compiled_dfilter_);
+}
+
 // Override setCompleter so that we don't clobber the filter text on activate.
 void SyntaxLineEdit::setCompleter(QCompleter *c)
 {
@@ -147,6 +153,10 @@ void SyntaxLineEdit::insertFilter(const QString &filter)
 
 void SyntaxLineEdit::checkDisplayFilter(QString filter)
 {
+    dfilter_free(compiled_dfilter_);
+    compiled_dfilter_ = NULL;
+    compiled_filter_text_.clear();
+
     if (filter.isEmpty()) {
         setSyntaxState(SyntaxLineEdit::Empty);
         return;
@@ -176,7 +186,24 @@ void SyntaxLineEdit::checkDisplayFilter(QString filter)
         syntax_error_message_ = QString::fromUtf8(err_msg);
         g_free(err_msg);
     }
-    dfilter_free(dfp);
+
+    // Keep the compiled filter so that applying it doesn't compile it again.
+    if (dfp) {
+        compiled_dfilter_ = dfp;
+        compiled_filter_text_ = filter;
+    }
+}
+
+dfilter_t *SyntaxLineEdit::takeCompiledDisplayFilter(const QString &filter)
+{
+    dfilter_t *dfp = NULL;
+
+    if (compiled_dfilter_ && filter == compiled_filter_text_) {
+        dfp = compiled_dfilter_;
+        compiled_dfilter_ = NULL;
+        compiled_filter_text_.clear();
+    }
+    return dfp;
 }
 
 void SyntaxLineEdit::checkFieldName(QString field)
@@ -14,6 +14,7 @@
 
 class QCompleter;
 class QStringListModel;
+struct epan_dfilter;
 
 // Autocompletion is partially implemented. Subclasses must:
 // - Provide buildCompletionList
@@ -26,6 +27,7 @@ class SyntaxLineEdit : public QLineEdit
     Q_ENUMS(SyntaxState)
 public:
     explicit SyntaxLineEdit(QWidget *parent = 0);
+    ~SyntaxLineEdit();
     enum SyntaxState { Empty, Busy, Invalid, Deprecated, Valid };
 
     SyntaxState syntaxState() const { return syntax_state_; }
@@ -37,6 +39,10 @@ public:
     void setCompleter(QCompleter *c);
     QCompleter *completer() const { return completer_; }
 
+    // Hand over the filter compiled by the last checkDisplayFilter call if
+    // it was compiled from filter, or return NULL. The caller must free it.
+    struct epan_dfilter *takeCompiledDisplayFilter(const QString &filter);
+
 public slots:
     void setStyleSheet(const QString &style_sheet);
     // Insert filter text at the current position, adding spaces where needed.
@@ -70,6 +76,8 @@ private:
     QString syntax_error_message_;
     QString token_chars_;
     QColor busy_fg_;
+    struct epan_dfilter *compiled_dfilter_;
+    QString compiled_filter_text_;
 
 private slots:
     void insertFieldCompletion(const QString &completion_text);
@@ -234,6 +234,7 @@ WirelessTimeline::find_packet(qreal x_position)
 void WirelessTimeline::captureFileReadStarted(capture_file *cf)
 {
     capfile = cf;
+    invalidate_packet_image();
     hide();
     // TODO: hide or grey the toolbar controls
 }
@@ -276,6 +277,7 @@ void WirelessTimeline::captureFileReadFinished()
 
     /* TODO: only reset the zoom level if the file is changed, not on redissection */
     zoom_level = 0;
+    invalidate_packet_image();
 
     show();
     selectedFrameChanged(0);
@@ -326,6 +328,9 @@ WirelessTimeline::WirelessTimeline(QWidget *parent) : QWidget(parent)
     first = NULL;
     last = NULL;
     capfile = NULL;
+    image_start_tsf = 0;
+    image_end_tsf = 0;
+    dirty_left = dirty_right = -1;
 
     radio_packet_list = NULL;
     connect(wsApp, SIGNAL(appInitialized()), this, SLOT(appInitialized()));
@@ -417,6 +422,13 @@ void WirelessTimeline::bgColorizationProgress(int first, int last)
     int x = position(first_wr->start_tsf, 1);
     int x_end = position(last_wr->end_tsf, 1);
 
+    if (dirty_left < 0) {
+        dirty_left = x;
+        dirty_right = x_end;
+    } else {
+        dirty_left = qMin(dirty_left, x);
+        dirty_right = qMax(dirty_right, x_end);
+    }
     update(x, 0, x_end-x+1, height());
 }
 
@@ -472,23 +484,13 @@ int WirelessTimeline::find_packet_tsf(guint64 tsf)
 }
 
 void
-WirelessTimeline::paintEvent(QPaintEvent *qpe)
+WirelessTimeline::paintEvent(QPaintEvent *)
 {
     QPainter p(this);
 
     // painting is done in device pixels in the x axis, get the ratio here
     float ratio = p.device()->devicePixelRatio();
 
-    unsigned int packet;
-    double zoom;
-    int last_x=-1;
-    int left = qpe->rect().left()*ratio;
-    int right = qpe->rect().right()*ratio;
-    float rgb[TIMELINE_HEIGHT][3];
-    reset_rgb(rgb);
-
-    zoom = ((double) width())/(end_tsf - start_tsf) * ratio;
-
     /* background is light grey */
     p.fillRect(0, 0, width(), TIMELINE_HEIGHT, QColor(240,240,240));
 
@@ -510,6 +512,48 @@ WirelessTimeline::paintEvent(QPaintEvent *qpe)
         }
     }
 
+    /* packets */
+    QSize image_size(width()*ratio, TIMELINE_HEIGHT*ratio);
+    if (packet_image.size() != image_size || image_start_tsf != start_tsf || image_end_tsf != end_tsf) {
+        packet_image = QImage(image_size, QImage::Format_ARGB32_Premultiplied);
+        packet_image.setDevicePixelRatio(ratio);
+        packet_image.fill(Qt::transparent);
+        image_start_tsf = start_tsf;
+        image_end_tsf = end_tsf;
+
+        QPainter ip(&packet_image);
+        render_packets(ip, 0, image_size.width(), ratio);
+    } else if (dirty_left >= 0) {
+        QRectF dirty_rect(dirty_left, 0, dirty_right-dirty_left+1, TIMELINE_HEIGHT);
+        QPainter ip(&packet_image);
+        ip.setCompositionMode(QPainter::CompositionMode_Source);
+        ip.fillRect(dirty_rect, Qt::transparent);
+        ip.setCompositionMode(QPainter::CompositionMode_SourceOver);
+        ip.setClipRect(dirty_rect);
+        render_packets(ip, dirty_left*ratio, dirty_right*ratio, ratio);
+    }
+    dirty_left = dirty_right = -1;
+
+    p.drawImage(QPointF(0, 0), packet_image);
+}
+
+void WirelessTimeline::invalidate_packet_image()
+{
+    packet_image = QImage();
+    dirty_left = dirty_right = -1;
+}
+
+/* render the packets that fall within device x positions left..right */
+void WirelessTimeline::render_packets(QPainter &p, int left, int right, float ratio)
+{
+    unsigned int packet;
+    double zoom;
+    int last_x=-1;
+    float rgb[TIMELINE_HEIGHT][3];
+    reset_rgb(rgb);
+
+    zoom = ((double) width())/(end_tsf - start_tsf) * ratio;
+
     QGraphicsScene qs;
     for (packet = find_packet_tsf(start_tsf + left/zoom - RENDER_EARLY); packet <= cfile.count; packet++) {
         frame_data *fdata = frame_data_sequence_find(cfile.provider.frames, packet);
@@ -33,6 +33,7 @@
 
 #include <epan/dissectors/packet-ieee80211-radio.h>
 
+#include <QImage>
 #include <QScrollArea>
 
 #include "cfile.h"
@@ -81,6 +82,8 @@ protected:
     int find_packet_tsf(guint64 tsf);
     void doToolTip(struct wlan_radio *wr, QPoint pos, int x);
     void zoom(double x_fraction);
+    void render_packets(QPainter &p, int left, int right, float ratio);
+    void invalidate_packet_image();
     double zoom_level;
     qreal start_x, last_x;
     PacketList *packet_list;
@@ -93,6 +96,14 @@ protected:
     struct wlan_radio *first, *last;
     capture_file *capfile;
 
+    /* packets and NAV lines for image_start_tsf..image_end_tsf. Selection
+     * and packet list scrolling only change the background, so they reuse
+     * this. dirty_left..dirty_right (widget x) is redrawn on the next paint. */
+    QImage packet_image;
+    guint64 image_start_tsf;
+    guint64 image_end_tsf;
+    int dirty_left, dirty_right;
+
     GHashTable* radio_packet_list;
 };
 
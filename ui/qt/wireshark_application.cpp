@@ -25,10 +25,12 @@
 #include "epan/disabled_protos.h"
 #include "epan/ftypes/ftypes.h"
 #include "epan/prefs.h"
+#include "epan/prefs-int.h"
 #include "epan/proto.h"
 #include "epan/tap.h"
 #include "epan/timestamp.h"
 #include "epan/decode_as.h"
+#include "epan/uat-int.h"
 
 #include "ui/decode_as_utils.h"
 #include "ui/preference_utils.h"
@@ -37,6 +39,7 @@
 #include "ui/recent.h"
 #include "ui/simple_dialog.h"
 #include "ui/util.h"
+#include "ui/ws_ui_util.h"
 
 #include <ui/qt/utils/qt_ui_utils.h>
 #include <ui/qt/utils/color_utils.h>
@@ -72,6 +75,7 @@
 #include <QAction>
 #include <QApplication>
 #include <QColorDialog>
+#include <QCryptographicHash>
 #include <QDesktopServices>
 #include <QDir>
 #include <QEvent>
@@ -354,6 +358,120 @@ int WiresharkApplication::monospaceTextSize(const char *str)
     return fm.width(str);
 }
 
+// Digest of everything a profile can change that affects dissection or
+// filtering: dissection preferences, UATs, enabled protocols and
+// heuristics, and Decode As entries. Hash table order may differ for
+// equal contents, which only costs an unneeded redissection.
+static void digest_add_string(QCryptographicHash *digest, const char *str)
+{
+    if (str) {
+        digest->addData(str, (int) strlen(str) + 1);
+    } else {
+        digest->addData("", 1);
+    }
+}
+
+static guint digest_pref_cb(pref_t *pref, gpointer user_data)
+{
+    QCryptographicHash *digest = static_cast<QCryptographicHash *>(user_data);
+
+    if (!(prefs_get_effect_flags(pref) & PREF_EFFECT_DISSECTION)) {
+        return 0;
+    }
+
+    switch (prefs_get_type(pref)) {
+    case PREF_OBSOLETE:
+    case PREF_STATIC_TEXT:
+    case PREF_UAT:
+        // UATs are digested by record below.
+        return 0;
+    default:
+        break;
+    }
+
+    char *value = prefs_pref_to_str(pref, pref_current);
+    digest_add_string(digest, prefs_get_name(pref));
+    digest_add_string(digest, value);
+    g_free(value);
+    return 0;
+}
+
+static guint digest_module_cb(module_t *module, gpointer user_data)
+{
+    QCryptographicHash *digest = static_cast<QCryptographicHash *>(user_data);
+
+    digest_add_string(digest, module->name);
+    prefs_pref_foreach(module, digest_pref_cb, user_data);
+
+    if (prefs_module_has_submodules(module)) {
+        return prefs_modules_foreach_submodules(module, digest_module_cb, user_data);
+    }
+    return 0;
+}
+
+static void digest_uat_cb(void *uat_ptr, void *user_data)
+{
+    QCryptographicHash *digest = static_cast<QCryptographicHash *>(user_data);
+    uat_t *uat = static_cast<uat_t *>(uat_ptr);
+
+    digest_add_string(digest, uat->name);
+    for (guint idx = 0; idx < uat->raw_data->len; idx++) {
+        void *rec = UAT_INDEX_PTR(uat, idx);
+        for (guint col = 0; col < uat->ncols; col++) {
+            char *str = uat_fld_tostr(rec, &uat->fields[col]);
+            digest_add_string(digest, str);
+            g_free(str);
+        }
+    }
+}
+
+static void digest_decode_as_cb(const gchar *table_name, ftenum_t selector_type,
+                                gpointer key, gpointer value, gpointer user_data)
+{
+    QCryptographicHash *digest = static_cast<QCryptographicHash *>(user_data);
+    dissector_handle_t handle = dtbl_entry_get_handle((dtbl_entry_t *)value);
+
+    digest_add_string(digest, table_name);
+    if (IS_FT_STRING(selector_type)) {
+        digest_add_string(digest, (const char *)key);
+    } else {
+        digest_add_string(digest, QByteArray::number(GPOINTER_TO_UINT(key)).constData());
+    }
+    digest_add_string(digest, handle ? dissector_handle_get_short_name(handle) : NULL);
+}
+
+static void digest_heur_cb(const gchar *, struct heur_dtbl_entry *entry, gpointer user_data)
+{
+    QCryptographicHash *digest = static_cast<QCryptographicHash *>(user_data);
+
+    digest_add_string(digest, entry->short_name);
+    digest_add_string(digest, entry->enabled ? "1" : "0");
+}
+
+static void digest_heur_table_cb(const char *table_name, struct heur_dissector_list *, gpointer user_data)
+{
+    heur_dissector_table_foreach(table_name, digest_heur_cb, user_data);
+}
+
+static QByteArray dissection_state_digest()
+{
+    QCryptographicHash digest(QCryptographicHash::Sha1);
+    void *cookie;
+
+    prefs_modules_foreach_submodules(NULL, digest_module_cb, &digest);
+    uat_foreach_table(digest_uat_cb, &digest);
+    for (int proto_id = proto_get_first_protocol(&cookie); proto_id != -1;
+         proto_id = proto_get_next_protocol(&cookie)) {
+        if (!proto_is_protocol_enabled(find_protocol_by_id(proto_id))) {
+            digest.addData((const char *)&proto_id, sizeof(proto_id));
+        }
+    }
+    dissector_all_heur_tables_foreach_table(digest_heur_table_cb, &digest, NULL);
+    dissector_all_tables_foreach_changed(digest_decode_as_cb, &digest);
+
+    return digest.result();
+}
+
 void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bool write_recent)
 {
     char  *rf_path;
@@ -403,6 +521,9 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
         write_profile_recent();
     }
 
+    /* Remember how packets are dissected with the old profile */
+    QByteArray dissection_digest = dissection_state_digest();
+
     /* Set profile name and update the status bar */
     set_profile_name (profile_name);
     emit profileNameChanged(profile_name);
@@ -448,7 +569,14 @@ void WiresharkApplication::setConfigurationProfile(const gchar *profile_name, bo
     }
 
     emit localInterfaceListChanged();
-    emit packetDissectionChanged();
+
+    /* Profiles often differ only in columns and coloring rules, which
+       the packet list handles without dissecting every packet again. */
+    if (dissection_state_digest() != dissection_digest) {
+        emit packetDissectionChanged();
+    } else {
+        packet_list_recolor_packets();
+    }
 }
 
 void WiresharkApplication::reloadLuaPluginsDelayed()
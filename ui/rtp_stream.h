@@ -95,6 +95,7 @@ struct _rtpstream_tapinfo {
     rtpstream_info_t  *filter_stream_rev; /**< used as filter in some tap modes */
     FILE              *save_file;
     gboolean           is_registered; /**< if the tap listener is currently registered or not */
+    GHashTable        *strinfo_hash; /**< strinfo_list items keyed by their rtpstream_id_t, for TAP_ANALYSE */
 };
 
 #if 0
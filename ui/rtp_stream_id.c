@@ -104,6 +104,19 @@ gboolean rtpstream_id_equal_pinfo_rtp_info(const rtpstream_id_t *id, const packe
 	return FALSE;
 }
 
+/****************************************************************************/
+/* hash an id, consistent with rtpstream_id_equal(..., RTPSTREAM_ID_EQUAL_SSRC) */
+guint rtpstream_id_hash(const rtpstream_id_t *id)
+{
+	guint hash = id->ssrc;
+
+	hash = add_address_to_hash(hash, &(id->src_addr));
+	hash = add_address_to_hash(hash, &(id->dst_addr));
+	hash ^= ((guint)id->src_port << 16) | id->dst_port;
+
+	return hash;
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
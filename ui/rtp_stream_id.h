@@ -70,6 +70,12 @@ gboolean rtpstream_id_equal(const rtpstream_id_t *id1, const rtpstream_id_t *id2
  */
 gboolean rtpstream_id_equal_pinfo_rtp_info(const rtpstream_id_t *id, const packet_info *pinfo, const struct _rtp_info *rtp_info);
 
+/**
+ * Get a hash value for rtpstream_id_t
+ * - ids that are equal with RTPSTREAM_ID_EQUAL_SSRC have the same hash
+ */
+guint rtpstream_id_hash(const rtpstream_id_t *id);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
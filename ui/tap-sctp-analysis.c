@@ -37,6 +37,11 @@
 
 static sctp_allassocs_info_t sctp_tapinfo_struct = {0, NULL, FALSE, NULL};
 
+/* Associations by assoc_id, and the last element of assoc_info_list, so
+ * that neither looking up nor adding an association walks the list. */
+static GHashTable *assoc_info_table = NULL;
+static GList *assoc_info_last = NULL;
+
 static void
 free_first(gpointer data, gpointer user_data _U_)
 {
@@ -169,6 +174,9 @@ reset(void *arg)
     g_list_free(tapdata->assoc_info_list);
     tapdata->sum_tvbs = 0;
     tapdata->assoc_info_list = NULL;
+    assoc_info_last = NULL;
+    if (assoc_info_table != NULL)
+        g_hash_table_remove_all(assoc_info_table);
 }
 
 
@@ -226,23 +234,26 @@ calc_checksum(const struct _sctp_info *check_data, sctp_assoc_info_t *data)
 static sctp_assoc_info_t *
 find_assoc(sctp_tmp_info_t *needle)
 {
-    sctp_allassocs_info_t *assoc_info;
-    sctp_assoc_info_t *info = NULL;
-    GList* list;
+    if (assoc_info_table == NULL)
+        return NULL;
 
-    assoc_info = &sctp_tapinfo_struct;
-    if ((list = g_list_last(assoc_info->assoc_info_list))!=NULL)
-    {
-        while (list)
-        {
-            info = (sctp_assoc_info_t*)(list->data);
-            if (needle->assoc_id == info->assoc_id)
-                return info;
+    return (sctp_assoc_info_t *)g_hash_table_lookup(assoc_info_table, GUINT_TO_POINTER(needle->assoc_id));
+}
 
-            list = g_list_previous(list);
-        }
+static void
+add_assoc(sctp_assoc_info_t *info)
+{
+    if (assoc_info_table == NULL)
+        assoc_info_table = g_hash_table_new(g_direct_hash, g_direct_equal);
+    g_hash_table_insert(assoc_info_table, GUINT_TO_POINTER(info->assoc_id), info);
+
+    /* Appending to the last element doesn't walk the list */
+    if (assoc_info_last == NULL) {
+        sctp_tapinfo_struct.assoc_info_list = g_list_append(NULL, info);
+        assoc_info_last = sctp_tapinfo_struct.assoc_info_list;
+    } else {
+        assoc_info_last = g_list_next(g_list_append(assoc_info_last, info));
     }
-    return NULL;
 }
 
 static sctp_assoc_info_t *
@@ -732,7 +743,7 @@ packet(void *tapdata _U_, packet_info *pinfo, epan_dissect_t *edt _U_, const voi
                     info->sack2 = g_list_prepend(info->sack2, sack);
                     sack_used = TRUE;
                 }
-                sctp_tapinfo_struct.assoc_info_list = g_list_append(sctp_tapinfo_struct.assoc_info_list, info);
+                add_assoc(info);
             }
             else
             {
@@ -36,6 +36,35 @@ typedef struct _tcp_scan_t {
 } tcp_scan_t;
 
 
+static void
+fill_segment(struct segment *segment, packet_info *pinfo, const struct tcpheader *tcphdr)
+{
+    segment->next      = NULL;
+    segment->num       = pinfo->num;
+    segment->rel_secs  = (guint32)pinfo->rel_ts.secs;
+    segment->rel_usecs = pinfo->rel_ts.nsecs/1000;
+    /* Currently unused
+    segment->abs_secs  = (guint32)pinfo->abs_ts.secs;
+    segment->abs_usecs = pinfo->abs_ts.nsecs/1000;
+    */
+    segment->th_seq    = tcphdr->th_seq;
+    segment->th_ack    = tcphdr->th_ack;
+    segment->th_win    = tcphdr->th_win;
+    segment->th_flags  = tcphdr->th_flags;
+    segment->th_sport  = tcphdr->th_sport;
+    segment->th_dport  = tcphdr->th_dport;
+    segment->th_seglen = tcphdr->th_seglen;
+    copy_address(&segment->ip_src, &tcphdr->ip_src);
+    copy_address(&segment->ip_dst, &tcphdr->ip_dst);
+
+    segment->num_sack_ranges = MIN(MAX_TCP_SACK_RANGES, tcphdr->num_sack_ranges);
+    if (segment->num_sack_ranges > 0) {
+        /* Copy entries in the order they happen */
+        memcpy(&segment->sack_left_edge, &tcphdr->sack_left_edge, sizeof(segment->sack_left_edge));
+        memcpy(&segment->sack_right_edge, &tcphdr->sack_right_edge, sizeof(segment->sack_right_edge));
+    }
+}
+
 static tap_packet_status
 tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, const void *vip)
 {
@@ -63,30 +92,7 @@ tapall_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, cons
         && tg->stream == tcphdr->th_stream)
     {
         struct segment *segment = g_new(struct segment, 1);
-        segment->next      = NULL;
-        segment->num       = pinfo->num;
-        segment->rel_secs  = (guint32)pinfo->rel_ts.secs;
-        segment->rel_usecs = pinfo->rel_ts.nsecs/1000;
-        /* Currently unused
-        segment->abs_secs  = (guint32)pinfo->abs_ts.secs;
-        segment->abs_usecs = pinfo->abs_ts.nsecs/1000;
-        */
-        segment->th_seq    = tcphdr->th_seq;
-        segment->th_ack    = tcphdr->th_ack;
-        segment->th_win    = tcphdr->th_win;
-        segment->th_flags  = tcphdr->th_flags;
-        segment->th_sport  = tcphdr->th_sport;
-        segment->th_dport  = tcphdr->th_dport;
-        segment->th_seglen = tcphdr->th_seglen;
-        copy_address(&segment->ip_src, &tcphdr->ip_src);
-        copy_address(&segment->ip_dst, &tcphdr->ip_dst);
-
-        segment->num_sack_ranges = MIN(MAX_TCP_SACK_RANGES, tcphdr->num_sack_ranges);
-        if (segment->num_sack_ranges > 0) {
-            /* Copy entries in the order they happen */
-            memcpy(&segment->sack_left_edge, &tcphdr->sack_left_edge, sizeof(segment->sack_left_edge));
-            memcpy(&segment->sack_right_edge, &tcphdr->sack_right_edge, sizeof(segment->sack_right_edge));
-        }
+        fill_segment(segment, pinfo, tcphdr);
 
         if (ts->tg->segments) {
             ts->last->next = segment;
@@ -163,6 +169,125 @@ graph_segment_list_free(struct tcp_graph *tg)
     tg->segments = NULL;
 }
 
+static tap_packet_status
+tapindex_tcpip_packet(void *pct, packet_info *pinfo, epan_dissect_t *edt _U_, const void *vip)
+{
+    tcp_segment_index_t *index = (tcp_segment_index_t *)pct;
+    const struct tcpheader *tcphdr = (const struct tcpheader *)vip;
+    GArray *stream_segs;
+    struct segment segment;
+
+    if (tcphdr->th_stream >= index->streams->len) {
+        g_ptr_array_set_size(index->streams, tcphdr->th_stream + 1);
+    }
+    stream_segs = (GArray *)g_ptr_array_index(index->streams, tcphdr->th_stream);
+    if (!stream_segs) {
+        stream_segs = g_array_new(FALSE, FALSE, sizeof(struct segment));
+        g_ptr_array_index(index->streams, tcphdr->th_stream) = stream_segs;
+    }
+
+    fill_segment(&segment, pinfo, tcphdr);
+    g_array_append_val(stream_segs, segment);
+
+    return TAP_PACKET_DONT_REDRAW;
+}
+
+/* Collect the segments of every TCP stream in one pass, so that switching
+ * between streams doesn't need to retap the capture. */
+tcp_segment_index_t *
+graph_segment_index_new(capture_file *cf)
+{
+    tcp_segment_index_t *index;
+    GString    *error_string;
+    guint       i, j;
+
+    if (!cf) {
+        return NULL;
+    }
+
+    index = g_new(tcp_segment_index_t, 1);
+    index->streams = g_ptr_array_new();
+    index->frame_count = cf->count;
+    index->dissection_gen = cf->dissection_gen;
+
+    error_string = register_tap_listener("tcp", index, "tcp", 0, NULL, tapindex_tcpip_packet, NULL, NULL);
+    if (error_string) {
+        fprintf(stderr, "wireshark: Couldn't register tcp_graph tap: %s\n",
+                error_string->str);
+        g_string_free(error_string, TRUE);
+        exit(1);   /* XXX: fix this */
+    }
+    cf_retap_packets(cf);
+    remove_tap_listener(index);
+
+    /* The arrays are done growing, so we can chain their elements for
+     * code that walks tcp_graph.segments. */
+    for (i = 0; i < index->streams->len; i++) {
+        GArray *stream_segs = (GArray *)g_ptr_array_index(index->streams, i);
+        if (!stream_segs) continue;
+        for (j = 1; j < stream_segs->len; j++) {
+            g_array_index(stream_segs, struct segment, j - 1).next = &g_array_index(stream_segs, struct segment, j);
+        }
+    }
+
+    return index;
+}
+
+void
+graph_segment_index_free(tcp_segment_index_t *index)
+{
+    guint i, j;
+
+    if (!index) {
+        return;
+    }
+
+    for (i = 0; i < index->streams->len; i++) {
+        GArray *stream_segs = (GArray *)g_ptr_array_index(index->streams, i);
+        if (!stream_segs) continue;
+        for (j = 0; j < stream_segs->len; j++) {
+            struct segment *segment = &g_array_index(stream_segs, struct segment, j);
+            free_address(&segment->ip_src);
+            free_address(&segment->ip_dst);
+        }
+        g_array_free(stream_segs, TRUE);
+    }
+    g_ptr_array_free(index->streams, TRUE);
+    g_free(index);
+}
+
+/* Point tg->segments at the indexed segments of tg->stream. The segments
+ * belong to the index and must not be freed with graph_segment_list_free. */
+void
+graph_segment_list_from_index(tcp_segment_index_t *index, struct tcp_graph *tg)
+{
+    GArray *stream_segs = NULL;
+    struct segment *first;
+
+    tg->segments = NULL;
+    if (!index || tg->stream >= index->streams->len) {
+        return;
+    }
+
+    stream_segs = (GArray *)g_ptr_array_index(index->streams, tg->stream);
+    if (!stream_segs || stream_segs->len < 1) {
+        return;
+    }
+
+    first = &g_array_index(stream_segs, struct segment, 0);
+    if (tg->src_address.type == AT_NONE || tg->dst_address.type == AT_NONE) {
+        /*
+         * We only know the stream number. Fill in our connection data.
+         * We assume that the server response is more interesting.
+         */
+        copy_address(&tg->src_address, &first->ip_dst);
+        tg->src_port = first->th_dport;
+        copy_address(&tg->dst_address, &first->ip_src);
+        tg->dst_port = first->th_sport;
+    }
+    tg->segments = first;
+}
+
 int
 compare_headers(address *saddr1, address *daddr1, guint16 sport1, guint16 dport1, const address *saddr2, const address *daddr2, guint16 sport2, guint16 dport2, int dir)
 {
@@ -78,6 +78,17 @@ struct tcp_graph {
 void graph_segment_list_get(capture_file *cf, struct tcp_graph *tg, gboolean stream_known );
 void graph_segment_list_free(struct tcp_graph * );
 
+/* The segments of every TCP stream in a capture file */
+typedef struct _tcp_segment_index_t {
+    GPtrArray       *streams;       /* GArray of struct segment, indexed by stream number */
+    guint32          frame_count;   /* cf->count when the index was built */
+    guint32          dissection_gen; /* cf->dissection_gen when the index was built */
+} tcp_segment_index_t;
+
+tcp_segment_index_t *graph_segment_index_new(capture_file *cf);
+void graph_segment_index_free(tcp_segment_index_t *index);
+void graph_segment_list_from_index(tcp_segment_index_t *index, struct tcp_graph *tg);
+
 /* for compare_headers() */
 /* segment went the same direction as the currently selected one */
 #define COMPARE_CURR_DIR    0
@@ -348,8 +348,15 @@ static void
 write_byte (const char *str)
 {
     guint32 num;
-
-    num = parse_num(str, FALSE);
+    int     hi, lo;
+
+    /* The scanner hands us two hex digits; don't bother strtoul() with them */
+    if ((hi = g_ascii_xdigit_value(str[0])) >= 0 &&
+        (lo = g_ascii_xdigit_value(str[1])) >= 0) {
+        num = (hi << 4) | lo;
+    } else {
+        num = parse_num(str, FALSE);
+    }
     packet_buf[curr_offset] = (guint8) num;
     curr_offset ++;
     if (curr_offset >= max_offset) /* packet full */
@@ -446,6 +446,8 @@ time_shift_undo(capture_file *cf)
     for (i = 1; i <= cf->count; i++) {
         if ((fd = frame_data_sequence_find(cf->provider.frames, i)) == NULL)
             continue;   /* Shouldn't happen */
+        if (nstime_is_zero(&fd->shift_offset))
+            continue;   /* Never shifted */
         modify_time_perform(fd, SHIFT_NEG, &nulltime, SHIFT_SETTOZERO);
     }
     packet_list_queue_draw();
@@ -287,6 +287,14 @@ voip_calls_reset_all_taps(voip_calls_tapinfo_t *tapinfo)
     /* free the SIP_HASH */
     if(NULL!=tapinfo->callsinfo_hashtable[SIP_HASH])
         g_hash_table_remove_all (tapinfo->callsinfo_hashtable[SIP_HASH]);
+    /* free the H225_HASH */
+    if(NULL!=tapinfo->callsinfo_hashtable[H225_HASH])
+        g_hash_table_remove_all (tapinfo->callsinfo_hashtable[H225_HASH]);
+    /* free the MGCP hashes */
+    if(NULL!=tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH])
+        g_hash_table_remove_all (tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH]);
+    if(NULL!=tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH])
+        g_hash_table_remove_all (tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH]);
 
     /* free the strinfo data items first */
     list = g_list_first(tapinfo->rtpstream_list);
@@ -439,8 +447,6 @@ static void insert_to_graph_t38(voip_calls_tapinfo_t *tapinfo, packet_info *pinf
 {
     seq_analysis_item_t *gai, *new_gai;
     GList    *list;
-    guint     item_num;
-    gboolean  inserted;
     gchar     time_str[COL_MAX_LEN];
 
     new_gai = (seq_analysis_item_t *)g_malloc0(sizeof(seq_analysis_item_t));
@@ -465,27 +471,26 @@ static void insert_to_graph_t38(voip_calls_tapinfo_t *tapinfo, packet_info *pinf
     new_gai->time_str = g_strdup(time_str);
     new_gai->display=FALSE;
 
-    item_num = 0;
-    inserted = FALSE;
     if(tapinfo->graph_analysis){
-        list = g_queue_peek_nth_link(tapinfo->graph_analysis->items, 0);
+        /* Insert after the last item that isn't later than this frame. Packets
+           are tapped in frame order, so search from the tail, where the new
+           item nearly always belongs. */
+        list = g_queue_peek_tail_link(tapinfo->graph_analysis->items);
         while (list)
         {
             gai = (seq_analysis_item_t *)list->data;
-            if (gai->frame_number > frame_num) {
-                g_queue_insert_before(tapinfo->graph_analysis->items, list, new_gai);
-                g_hash_table_insert(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(new_gai->frame_number), new_gai);
-                inserted = TRUE;
+            if (gai->frame_number <= frame_num) {
                 break;
             }
-            list = g_list_next(list);
-            item_num++;
+            list = g_list_previous(list);
         }
 
-        if (!inserted) {
-            g_queue_push_tail(tapinfo->graph_analysis->items, new_gai);
-            g_hash_table_insert(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(new_gai->frame_number), new_gai);
+        if (list) {
+            g_queue_insert_after(tapinfo->graph_analysis->items, list, new_gai);
+        } else {
+            g_queue_push_head(tapinfo->graph_analysis->items, new_gai);
         }
+        g_hash_table_insert(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(new_gai->frame_number), new_gai);
     }
 }
 
@@ -883,11 +888,10 @@ t38_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, const
 
     voip_calls_info_t    *callsinfo             = NULL;
     voip_calls_info_t    *tmp_listinfo;
-    GList                *voip_calls_graph_list = NULL;
     GList                *list;
     gchar                *frame_label           = NULL;
     gchar                *comment               = NULL;
-    seq_analysis_item_t  *tmp_gai, *gai         = NULL;
+    seq_analysis_item_t  *gai                   = NULL;
     gchar                *tmp_str1, *tmp_str2;
     guint16               line_style            = 2;
     double                duration;
@@ -897,17 +901,8 @@ t38_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt, const
 
     if  (t38_info->setup_frame_number != 0) {
         /* using the setup frame number of the T38 packet, we get the call number that it belongs */
-        if(tapinfo->graph_analysis){
-            voip_calls_graph_list = g_queue_peek_nth_link(tapinfo->graph_analysis->items, 0);
-        }
-        while (voip_calls_graph_list)
-        {
-            tmp_gai = (seq_analysis_item_t *)voip_calls_graph_list->data;
-            if (t38_info->setup_frame_number == tmp_gai->frame_number) {
-                gai = tmp_gai;
-                break;
-            }
-            voip_calls_graph_list = g_list_next(voip_calls_graph_list);
+        if(tapinfo->graph_analysis && NULL!=tapinfo->graph_analysis->ht){
+            gai = (seq_analysis_item_t *)g_hash_table_lookup(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(t38_info->setup_frame_number));
         }
         if (gai) conv_num = (int) gai->conv_num;
     }
@@ -1591,6 +1586,26 @@ remove_tap_listener_mtp3_calls(voip_calls_tapinfo_t *tap_id_base)
 /****************************************************************************/
 static void h245_add_to_graph(voip_calls_tapinfo_t *tapinfo, guint32 new_frame_num);
 static const e_guid_t guid_allzero = {0, 0, 0, { 0, 0, 0, 0, 0, 0, 0, 0 } };
+
+/* H225_HASH key functions; the keys are the guid of each call's h323_calls_info_t */
+static guint
+h225_guid_hash(gconstpointer key)
+{
+    const e_guid_t *guid = (const e_guid_t *)key;
+    guint hash = guid->data1 ^ ((guint)guid->data2 << 16 | guid->data3);
+    int i;
+
+    for (i = 0; i < 8; i++)
+        hash = (hash << 5) - hash + guid->data4[i];
+    return hash;
+}
+
+static gboolean
+h225_guid_equal(gconstpointer a, gconstpointer b)
+{
+    return memcmp(a, b, GUID_LEN) == 0;
+}
+
 /* defines specific H323 data */
 
 /****************************************************************************/
@@ -1954,6 +1969,14 @@ h225_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
         if ( ((pi->msg_type == H225_RAS) && ((pi->msg_tag < 18) || (pi->msg_tag > 20))) || (pi->msg_type != H225_RAS) )
             return TAP_PACKET_DONT_REDRAW;
 
+    /* init the hash table */
+    if(NULL==tapinfo->callsinfo_hashtable[H225_HASH]) {
+        tapinfo->callsinfo_hashtable[H225_HASH]=g_hash_table_new_full(h225_guid_hash,
+                h225_guid_equal,
+                NULL, /* key_destroy_func */
+                NULL);/* value_destroy_func */
+    }
+
     /* if it is RAS LCF or LRJ*/
     if ( (pi->msg_type == H225_RAS) && ((pi->msg_tag == 19) || (pi->msg_tag == 20))) {
         /* if the LCF/LRJ doesn't match to a LRQ, just return */
@@ -1975,21 +1998,10 @@ h225_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
             list = g_list_next (list);
         }
     } else {
-        /* check whether we already have a call with this guid in the list */
-        list = g_queue_peek_nth_link(tapinfo->callsinfos, 0);
-        while (list)
-        {
-            tmp_listinfo=(voip_calls_info_t *)list->data;
-            if (tmp_listinfo->protocol == VOIP_H323) {
-                tmp_h323info = (h323_calls_info_t *)tmp_listinfo->prot_info;
-                g_assert(tmp_h323info != NULL);
-                if ( (memcmp(tmp_h323info->guid, &guid_allzero, GUID_LEN) != 0) && (memcmp(tmp_h323info->guid, &pi->guid,GUID_LEN)==0) ) {
-                    callsinfo = (voip_calls_info_t*)(list->data);
-                    break;
-                }
-            }
-            list = g_list_next (list);
-        }
+        /* check whether we already have a call with this guid in the H225_HASH;
+           only calls with a non zero guid are inserted */
+        if (memcmp(&pi->guid, &guid_allzero, GUID_LEN) != 0)
+            callsinfo = (voip_calls_info_t *)g_hash_table_lookup(tapinfo->callsinfo_hashtable[H225_HASH], &pi->guid);
     }
 
     tapinfo->h225_cstype = pi->cs_type;
@@ -2027,6 +2039,13 @@ h225_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
         callsinfo->npackets = 0;
 
         g_queue_push_tail(tapinfo->callsinfos, callsinfo);
+        /* insert the call information in the H225_HASH. Calls found by their
+           RAS requestSeqNum are created too, so keep the first call per guid */
+        if (memcmp(tmp_h323info->guid, &guid_allzero, GUID_LEN) != 0
+                && g_hash_table_lookup(tapinfo->callsinfo_hashtable[H225_HASH], tmp_h323info->guid) == NULL) {
+            g_hash_table_insert(tapinfo->callsinfo_hashtable[H225_HASH],
+                    tmp_h323info->guid, callsinfo);
+        }
     }
 
     tapinfo->h225_frame_num = pinfo->num;
@@ -2429,6 +2448,25 @@ remove_tap_listener_sdp_calls(voip_calls_tapinfo_t *tap_id_base)
 /* ***************************TAP for MGCP **********************************/
 /****************************************************************************/
 
+/* MGCP_ENDPOINT_HASH key functions; endpoint names are compared ignoring case,
+   and the keys are the endpointId of each call's mgcp_calls_info_t */
+static guint
+mgcp_endpoint_hash(gconstpointer key)
+{
+    const gchar *p = (const gchar *)key;
+    guint hash = 5381;
+
+    for (; *p != '\0'; p++)
+        hash = (hash << 5) + hash + (guchar)g_ascii_tolower(*p);
+    return hash;
+}
+
+static gboolean
+mgcp_endpoint_equal(gconstpointer a, gconstpointer b)
+{
+    return g_ascii_strcasecmp((const gchar *)a, (const gchar *)b) == 0;
+}
+
 /*
    This function will look for a signal/event in the SignalReq/ObsEvent string
    and return true if it is found
@@ -2549,8 +2587,6 @@ mgcp_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
     voip_calls_info_t    *tmp_listinfo;
     voip_calls_info_t    *callsinfo    = NULL;
     mgcp_calls_info_t    *tmp_mgcpinfo = NULL;
-    GList                *list;
-    GList                *listGraph    = NULL;
     gchar                *frame_label  = NULL;
     gchar                *comment      = NULL;
     seq_analysis_item_t  *gai          = NULL;
@@ -2560,36 +2596,41 @@ mgcp_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
 
     const mgcp_info_t *pi = (const mgcp_info_t *)MGCPinfo;
 
+    /* init the hash tables */
+    if(NULL==tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH]) {
+        tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH]=g_hash_table_new_full(mgcp_endpoint_hash,
+                mgcp_endpoint_equal,
+                NULL, /* key_destroy_func */
+                NULL);/* value_destroy_func */
+    }
+    if(NULL==tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH]) {
+        tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH]=g_hash_table_new(g_direct_hash, g_direct_equal);
+    }
 
     if ((pi->mgcp_type == MGCP_REQUEST) && !pi->is_duplicate ) {
-        /* check whether we already have a call with this Endpoint and it is active*/
-        list = g_queue_peek_nth_link(tapinfo->callsinfos, 0);
-        while (list)
-        {
-            tmp_listinfo=(voip_calls_info_t *)list->data;
-            if ((tmp_listinfo->protocol == VOIP_MGCP) && (tmp_listinfo->call_active_state == VOIP_ACTIVE)) {
+        /* check whether we already have a call with this Endpoint and it is active.
+           A new call is only made for an Endpoint without an active one, so the
+           MGCP_ENDPOINT_HASH only needs the latest call of each Endpoint */
+        if (pi->endpointId != NULL)
+            tmp_listinfo = (voip_calls_info_t *)g_hash_table_lookup(tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH], pi->endpointId);
+        else
+            tmp_listinfo = NULL;
+        if ((tmp_listinfo != NULL) && (tmp_listinfo->call_active_state == VOIP_ACTIVE)) {
+            /*
+               check first if it is an ended call. We can still match packets to this Endpoint 2 seconds
+               after the call has been released
+             */
+            diff_time = nstime_to_sec(&pinfo->rel_ts) - nstime_to_sec(&tmp_listinfo->stop_rel_ts);
+            if ( ((tmp_listinfo->call_state == VOIP_CANCELLED) ||
+                        (tmp_listinfo->call_state == VOIP_COMPLETED)  ||
+                        (tmp_listinfo->call_state == VOIP_REJECTED)) &&
+                    (diff_time > 2) )
+            {
+                tmp_listinfo->call_active_state = VOIP_INACTIVE;
+            } else {
                 tmp_mgcpinfo = (mgcp_calls_info_t *)tmp_listinfo->prot_info;
-                if (pi->endpointId != NULL) {
-                    if (g_ascii_strcasecmp(tmp_mgcpinfo->endpointId,pi->endpointId) == 0) {
-                        /*
-                           check first if it is an ended call. We can still match packets to this Endpoint 2 seconds
-                           after the call has been released
-                         */
-                        diff_time = nstime_to_sec(&pinfo->rel_ts) - nstime_to_sec(&tmp_listinfo->stop_rel_ts);
-                        if ( ((tmp_listinfo->call_state == VOIP_CANCELLED) ||
-                                    (tmp_listinfo->call_state == VOIP_COMPLETED)  ||
-                                    (tmp_listinfo->call_state == VOIP_REJECTED)) &&
-                                (diff_time > 2) )
-                        {
-                            tmp_listinfo->call_active_state = VOIP_INACTIVE;
-                        } else {
-                            callsinfo = (voip_calls_info_t*)(list->data);
-                            break;
-                        }
-                    }
-                }
+                callsinfo = tmp_listinfo;
             }
-            list = g_list_next (list);
         }
 
         /* there is no call with this Endpoint, lets see if this a new call or not */
@@ -2609,30 +2650,14 @@ mgcp_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
             ((pi->mgcp_type == MGCP_REQUEST) && pi->is_duplicate) ) {
         /* if it is a response OR if it is a duplicated Request, lets look in the Graph to see
            if there is a request that matches */
-        if(tapinfo->graph_analysis){
-            listGraph = g_queue_peek_nth_link(tapinfo->graph_analysis->items, 0);
+        if(tapinfo->graph_analysis && NULL!=tapinfo->graph_analysis->ht){
+            gai = (seq_analysis_item_t *)g_hash_table_lookup(tapinfo->graph_analysis->ht, GUINT_TO_POINTER(pi->req_num));
         }
-        while (listGraph)
-        {
-            gai = (seq_analysis_item_t *)listGraph->data;
-            if (gai->frame_number == pi->req_num) {
-                /* there is a request that match, so look the associated call with this call_num */
-                list = g_queue_peek_nth_link(tapinfo->callsinfos, 0);
-                while (list)
-                {
-                    tmp_listinfo=(voip_calls_info_t *)list->data;
-                    if (tmp_listinfo->protocol == VOIP_MGCP) {
-                        if (tmp_listinfo->call_num == gai->conv_num) {
-                            tmp_mgcpinfo = (mgcp_calls_info_t *)tmp_listinfo->prot_info;
-                            callsinfo = (voip_calls_info_t*)(list->data);
-                            break;
-                        }
-                    }
-                    list = g_list_next (list);
-                }
-                if (callsinfo != NULL) break;
-            }
-            listGraph = g_list_next(listGraph);
+        if (gai) {
+            /* there is a request that match, so look the associated call with this call_num */
+            callsinfo = (voip_calls_info_t *)g_hash_table_lookup(tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH], GUINT_TO_POINTER(gai->conv_num));
+            if (callsinfo != NULL)
+                tmp_mgcpinfo = (mgcp_calls_info_t *)callsinfo->prot_info;
         }
         /* if there is not a matching request, just return */
         if (callsinfo == NULL) return TAP_PACKET_DONT_REDRAW;
@@ -2662,6 +2687,13 @@ mgcp_calls_packet(void *tap_offset_ptr, packet_info *pinfo, epan_dissect_t *edt,
         callsinfo->npackets = 0;
         callsinfo->call_num = tapinfo->ncalls++;
         g_queue_push_tail(tapinfo->callsinfos, callsinfo);
+        /* insert the call information in the MGCP hashes; the new call
+           replaces any inactive one of the same Endpoint */
+        if (tmp_mgcpinfo->endpointId != NULL)
+            g_hash_table_replace(tapinfo->callsinfo_hashtable[MGCP_ENDPOINT_HASH],
+                    tmp_mgcpinfo->endpointId, callsinfo);
+        g_hash_table_insert(tapinfo->callsinfo_hashtable[MGCP_CALL_NUM_HASH],
+                GUINT_TO_POINTER(callsinfo->call_num), callsinfo);
     }
 
     g_assert(tmp_mgcpinfo != NULL);
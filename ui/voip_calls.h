@@ -63,7 +63,10 @@ typedef enum _voip_protocol {
 } voip_protocol;
 
 typedef enum _hash_indexes {
-    SIP_HASH=0
+    SIP_HASH=0,
+    H225_HASH=1,
+    MGCP_ENDPOINT_HASH=2,
+    MGCP_CALL_NUM_HASH=3
 } hash_indexes;
 
 extern const char *voip_protocol_name[];
@@ -175,7 +178,7 @@ typedef struct _voip_calls_tapinfo {
     void                 *tap_data; /**< data for tap callbacks */
     int                   ncalls; /**< number of call */
     GQueue*               callsinfos; /**< queue with all calls (voip_calls_info_t) */
-    GHashTable*           callsinfo_hashtable[1]; /**< array of hashes per voip protocol (voip_calls_info_t); currently only the one for SIP is used */
+    GHashTable*           callsinfo_hashtable[4]; /**< array of hashes per voip protocol (voip_calls_info_t), indexed by hash_indexes */
     int                   npackets; /**< total number of packets of all calls */
     voip_calls_info_t    *filter_calls_fwd; /**< used as filter in some tap modes */
     int                   start_packets;
@@ -743,6 +743,7 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 	gboolean ispipe = FALSE;
 	wtap	*wth;
 	unsigned int	i;
+	int	pass;
 	gboolean use_stdin = FALSE;
 	gchar *extension;
 	wtap_block_t shb;
@@ -876,6 +877,14 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 	wth->interface_data = g_array_new(FALSE, FALSE, sizeof(wtap_block_t));
 
 	if (wth->random_fh) {
+		/*
+		 * The seek points are collected as the sequential handle
+		 * reads through the file.  There's no point in keeping
+		 * them in a sidecar file across opens: every program that
+		 * opens the file for random access reads it sequentially
+		 * first anyway, to find the records, and rebuilds them
+		 * along the way at no extra cost.
+		 */
 		wth->fast_seek = g_ptr_array_new();
 
 		file_set_random_access(wth->fh, FALSE, wth->fast_seek);
@@ -916,47 +925,65 @@ wtap_open_offline(const char *filename, unsigned int type, int *err, char **err_
 		}
 	}
 
-	/* Try all file types that support magic numbers */
-	for (i = 0; i < heuristic_open_routine_idx; i++) {
-		/* Seek back to the beginning of the file; the open routine
-		   for the previous file type may have left the file
-		   position somewhere other than the beginning, and the
-		   open routine for this file type will probably want
-		   to start reading at the beginning.
+	/* Does this file's name have an extension? */
+	extension = get_file_extension(filename);
 
-		   Initialize the data offset while we're at it. */
-		if (file_seek(wth->fh, 0, SEEK_SET, err) == -1) {
-			/* Error - give up */
-			wtap_close(wth);
-			return NULL;
-		}
+	/* Try all file types that support magic numbers.  Magic numbers
+	   are unambiguous, so the order doesn't matter for correctness;
+	   if the file name has an extension, try the types that use it
+	   first, so that, for example, a .log btsnoop file doesn't go
+	   through every other magic number check before its own. */
+	for (pass = 0; pass < 2; pass++) {
+		for (i = 0; i < heuristic_open_routine_idx; i++) {
+			/* In the first pass try only the types that use the
+			   extension, in the second one the rest. */
+			if (extension != NULL) {
+				if ((pass == 0) != heuristic_uses_extension(i, extension))
+					continue;
+			} else if (pass == 0) {
+				continue;
+			}
 
-		/* Set wth with wslua data if any - this is how we pass the data
-		 * to the file reader, kinda like the priv member but not free'd later.
-		 * It's ok for this to copy a NULL.
-		 */
-		wth->wslua_data = open_routines[i].wslua_data;
+			/* Seek back to the beginning of the file; the open routine
+			   for the previous file type may have left the file
+			   position somewhere other than the beginning, and the
+			   open routine for this file type will probably want
+			   to start reading at the beginning.
 
-		switch ((*open_routines[i].open_routine)(wth, err, err_info)) {
+			   Initialize the data offset while we're at it. */
+			if (file_seek(wth->fh, 0, SEEK_SET, err) == -1) {
+				/* Error - give up */
+				g_free(extension);
+				wtap_close(wth);
+				return NULL;
+			}
 
-		case WTAP_OPEN_ERROR:
-			/* Error - give up */
-			wtap_close(wth);
-			return NULL;
+			/* Set wth with wslua data if any - this is how we pass the data
+			 * to the file reader, kinda like the priv member but not free'd later.
+			 * It's ok for this to copy a NULL.
+			 */
+			wth->wslua_data = open_routines[i].wslua_data;
 
-		case WTAP_OPEN_NOT_MINE:
-			/* No error, but not that type of file */
-			break;
+			switch ((*open_routines[i].open_routine)(wth, err, err_info)) {
+
+			case WTAP_OPEN_ERROR:
+				/* Error - give up */
+				g_free(extension);
+				wtap_close(wth);
+				return NULL;
 
-		case WTAP_OPEN_MINE:
-			/* We found the file type */
-			goto success;
+			case WTAP_OPEN_NOT_MINE:
+				/* No error, but not that type of file */
+				break;
+
+			case WTAP_OPEN_MINE:
+				/* We found the file type */
+				g_free(extension);
+				goto success;
+			}
 		}
 	}
 
-
-	/* Does this file's name have an extension? */
-	extension = get_file_extension(filename);
 	if (extension != NULL) {
 		/* Yes - try the heuristic types that use that extension first. */
 		for (i = heuristic_open_routine_idx; i < open_info_arr->len; i++) {
@@ -2642,6 +2669,19 @@ wtap_dump(wtap_dumper *wdh, const wtap_rec *rec,
 	return (wdh->subtype_write)(wdh, rec, pd, err, err_info);
 }
 
+gboolean
+wtap_dump_copy_record(wtap_dumper *wdh, wtap *wth, gint64 offset,
+		      Buffer *buf, gboolean *copied, int *err, gchar **err_info)
+{
+	*copied = FALSE;
+	*err = 0;
+	*err_info = NULL;
+	if (wth->file_type_subtype == WTAP_FILE_TYPE_SUBTYPE_PCAPNG &&
+	    wdh->file_type_subtype == WTAP_FILE_TYPE_SUBTYPE_PCAPNG)
+		return pcapng_copy_record_block(wdh, wth, offset, buf, copied, err);
+	return TRUE;
+}
+
 void
 wtap_dump_flush(wtap_dumper *wdh)
 {
@@ -105,6 +105,11 @@ wtap_get_all_compression_type_extensions_list(void)
 /* #define GZBUFSIZE 8192 */
 #define GZBUFSIZE 4096
 
+/* Buffer size used once a sequentially-read file turns out to be gzipped;
+   inflating in bigger pieces cuts the per-call overhead of inflate() and
+   the number of read() calls. */
+#define ZLIB_SEQ_BUFSIZE (64 * 1024)
+
 /* values for wtap_reader compression */
 typedef enum {
     UNKNOWN,       /* unknown - look for a gzip header */
@@ -135,6 +140,7 @@ struct wtap_reader {
     gint64 raw;                 /* where the raw data started, for seeking */
     compression_t compression;  /* type of compression, if any */
     gboolean is_compressed;     /* FALSE if completely uncompressed, TRUE otherwise */
+    gboolean random_access;     /* TRUE if this is the random-access stream */
 
     /* seek request */
     gint64 skip;                /* amount to skip (already rewound if backwards) */
@@ -642,6 +648,43 @@ DIAG_ON(cast-qual)
 }
 #endif
 
+#ifdef HAVE_ZLIB
+/* Grow a buffer, keeping its contents and read position. */
+static gboolean
+buf_grow(struct wtap_reader_buf *buf, gsize size)
+{
+    guint offset = offset_in_buffer(buf);
+    unsigned char *new_buf;
+
+    new_buf = (unsigned char *)g_try_realloc(buf->buf, size);
+    if (new_buf == NULL)
+        return FALSE;
+    buf->buf = new_buf;
+    buf->next = new_buf + offset;
+    return TRUE;
+}
+
+/*
+ * Switch a sequentially-read stream to bigger buffers, now that we know
+ * it's compressed.  The random-access stream keeps its small buffers, as
+ * it usually wants only one record after each seek.  If we can't get the
+ * memory, just carry on with the buffers we have.
+ */
+static void
+zlib_grow_buffers(FILE_T state)
+{
+    if (state->random_access || state->size >= ZLIB_SEQ_BUFSIZE)
+        return;
+    if (!buf_grow(&state->in, ZLIB_SEQ_BUFSIZE))
+        return;
+    /* The input buffer may now be bigger than state->size says, which
+       is harmless; only record the new size once both have grown. */
+    if (!buf_grow(&state->out, ((gsize)ZLIB_SEQ_BUFSIZE) << 1))
+        return;
+    state->size = ZLIB_SEQ_BUFSIZE;
+}
+#endif
+
 static int
 gz_head(FILE_T state)
 {
@@ -735,6 +778,7 @@ gz_head(FILE_T state)
             state->strm.adler = crc32(0L, Z_NULL, 0);
             state->compression = ZLIB;
             state->is_compressed = TRUE;
+            zlib_grow_buffers(state);
 #ifdef Z_BLOCK
             if (state->fast_seek) {
                 struct zlib_cur_seek_point *cur = g_new(struct zlib_cur_seek_point,1);
@@ -1009,8 +1053,9 @@ file_open(const char *path)
 }
 
 void
-file_set_random_access(FILE_T stream, gboolean random_flag _U_, GPtrArray *seek)
+file_set_random_access(FILE_T stream, gboolean random_flag, GPtrArray *seek)
 {
+    stream->random_access = random_flag;
     stream->fast_seek = seek;
 }
 
@@ -1226,6 +1271,14 @@ file_seek(FILE_T file, gint64 offset, int whence, int *err)
      * Again, note that this will never be true on a pipe, as
      * file_set_random_access() should never be called if we're
      * reading from a pipe.
+     *
+     * We deliberately don't mmap() uncompressed files instead: the
+     * file being read may be a capture file that is still growing (or
+     * that gets truncated underneath us), which makes a mapping either
+     * stale or a source of SIGBUS, and the caller copies the record
+     * into its own Buffer anyway.  Seeking here costs one lseek(), and
+     * the following read fills the output buffer, so nearby records are
+     * then served from it by the in-buffer cases above.
      */
     if (file->compression == UNCOMPRESSED && file->pos + offset >= file->raw
         && (offset < 0 || offset >= file->out.avail)
@@ -1584,6 +1637,15 @@ file_fdreopen(FILE_T file, const char *path)
 
     if ((fd = ws_open(path, O_RDONLY|O_BINARY, 0000)) == -1)
         return FALSE;
+    /* file_seek() may seek relative to the current position, so the new
+       descriptor has to be where the old one was */
+    if (ws_lseek64(fd, file->raw_pos, SEEK_SET) == -1) {
+        int save_errno = errno;
+
+        ws_close(fd);
+        errno = save_errno;
+        return FALSE;
+    }
     file->fd = fd;
     return TRUE;
 }
@@ -1615,12 +1677,17 @@ file_close(FILE_T file)
 }
 
 #ifdef HAVE_ZLIB
+/* Buffer size for writing gzipped files; with GZBUFSIZE, deflate() was
+   called and the output written for every 4 KB, which limited how fast
+   a capture could be written compressed. */
+#define GZWBUFSIZE (64 * 1024)
+
 /* internal gzip file state data structure for writing */
 struct wtap_writer {
     int fd;                 /* file descriptor */
     gint64 pos;             /* current position in uncompressed data */
     guint size;          /* buffer size, zero if not allocated yet */
-    guint want;          /* requested buffer size, default is GZBUFSIZE */
+    guint want;          /* requested buffer size, default is GZWBUFSIZE */
     unsigned char *in;      /* input buffer */
     unsigned char *out;     /* output buffer (double-sized when reading) */
     unsigned char *next;    /* next output data to deliver or write */
@@ -1661,7 +1728,7 @@ gzwfile_fdopen(int fd)
         return NULL;
     state->fd = fd;
     state->size = 0;            /* no buffers allocated yet */
-    state->want = GZBUFSIZE;    /* requested buffer size */
+    state->want = GZWBUFSIZE;   /* requested buffer size */
 
     state->level = Z_DEFAULT_COMPRESSION;
     state->strategy = Z_DEFAULT_STRATEGY;
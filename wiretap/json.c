@@ -15,51 +15,266 @@
 #include "json.h"
 #include <wsutil/wsjson.h>
 
-/* Maximum size of json file. */
+/* Maximum size of json file, or of one record when reading it a value at a time. */
 #define MAX_FILE_SIZE  (50*1024*1024)
 
-wtap_open_return_val json_open(wtap *wth, int *err, gchar **err_info)
+/* json_validate() gives up on documents with more tokens than this. */
+#define MAX_VALIDATE_TOKENS 1024
+
+/*
+ * A file that is one small JSON document is a single record. A larger
+ * top-level array is read an element at a time, and a sequence of
+ * values, such as newline-delimited JSON, a value at a time, so that
+ * big JSON logs don't have to be held in memory and dissected at once.
+ */
+typedef struct {
+    gboolean in_array;      /* records are the elements of a top-level array */
+} json_stream_t;
+
+/*
+ * Skip white space, and the commas between array elements. Returns the
+ * next character without consuming it, or EOF.
+ */
+static int
+json_skip(FILE_T fh, gboolean in_array)
 {
-    guint8* filebuf;
-    int bytes_read;
+    int c;
 
-    /* XXX checking the full file contents might be a bit expensive, maybe
-     * resort to simpler heuristics like '{' or '[' (with some other chars)? */
-    filebuf = (guint8*)g_malloc0(MAX_FILE_SIZE);
-    if (!filebuf)
-        return WTAP_OPEN_ERROR;
+    for (;;) {
+        c = file_peekc(fh);
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || (in_array && c == ','))
+            file_getc(fh);
+        else
+            return c;
+    }
+}
 
-    bytes_read = file_read(filebuf, MAX_FILE_SIZE, wth->fh);
-    if (bytes_read < 0) {
-        /* Read error. */
-        *err = file_error(wth->fh, err_info);
-        g_free(filebuf);
-        return WTAP_OPEN_ERROR;
+static inline void
+json_append(Buffer *buf, int c)
+{
+    if (buf) {
+        ws_buffer_assure_space(buf, 1);
+        *ws_buffer_end_ptr(buf) = (guint8)c;
+        ws_buffer_increase_length(buf, 1);
     }
-    if (bytes_read == 0) {
-        /* empty file, not *anybody's* */
-        g_free(filebuf);
-        return WTAP_OPEN_NOT_MINE;
+}
+
+/*
+ * Read the JSON value that starts at the current position, appending it
+ * to buf unless that is NULL. Only the nesting of objects, arrays and
+ * strings is followed; anything else is up to the dissector. Returns
+ * FALSE if the value is cut short by the end of the file, or is longer
+ * than max_len or has more than max_tokens objects, arrays and strings.
+ */
+static gboolean
+json_read_value(FILE_T fh, Buffer *buf, gint64 max_len, guint max_tokens, gint64 *len)
+{
+    int      depth = 0;
+    gboolean in_string = FALSE;
+    gboolean escaped = FALSE;
+    guint    tokens = 0;
+    int      c;
+
+    *len = 0;
+    c = file_peekc(fh);
+    if (c != '{' && c != '[' && c != '"') {
+        /* A number, true, false or null, which ends where the next token starts */
+        while ((c = file_peekc(fh)) != EOF && strchr(" \t\r\n,]}", c) == NULL) {
+            if (*len >= max_len)
+                return FALSE;
+            json_append(buf, file_getc(fh));
+            (*len)++;
+        }
+        return *len > 0;
+    }
+
+    do {
+        if (*len >= max_len)
+            return FALSE;
+        c = file_getc(fh);
+        if (c == EOF)
+            return FALSE;
+        json_append(buf, c);
+        (*len)++;
+
+        if (in_string) {
+            if (escaped)
+                escaped = FALSE;
+            else if (c == '\\')
+                escaped = TRUE;
+            else if (c == '"')
+                in_string = FALSE;
+        } else if (c == '"') {
+            in_string = TRUE;
+            tokens++;
+        } else if (c == '{' || c == '[') {
+            depth++;
+            tokens++;
+        } else if (c == '}' || c == ']') {
+            depth--;
+        }
+        if (tokens > max_tokens)
+            return FALSE;
+    } while (in_string || depth > 0);
+
+    return TRUE;
+}
+
+static gboolean
+json_read_record(FILE_T fh, wtap_rec *rec, Buffer *buf, int *err, gchar **err_info)
+{
+    gint64 len;
+
+    ws_buffer_clean(buf);
+    if (!json_read_value(fh, buf, MAX_FILE_SIZE, G_MAXUINT, &len)) {
+        *err = file_error(fh, err_info);
+        if (*err == 0) {
+            *err = WTAP_ERR_BAD_FILE;
+            *err_info = g_strdup_printf("json: value is cut short or bigger than %u bytes", MAX_FILE_SIZE);
+        }
+        return FALSE;
     }
 
-    if (json_validate(filebuf, bytes_read) == FALSE) {
-        g_free(filebuf);
+    rec->rec_type = REC_TYPE_PACKET;
+    rec->presence_flags = 0; /* no time stamps */
+    rec->ts.secs = 0;
+    rec->ts.nsecs = 0;
+    rec->rec_header.packet_header.caplen = (guint32)len;
+    rec->rec_header.packet_header.len = (guint32)len;
+
+    return TRUE;
+}
+
+static gboolean
+json_stream_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err, gchar **err_info,
+                 gint64 *data_offset)
+{
+    json_stream_t *json = (json_stream_t *)wth->priv;
+    int c = json_skip(wth->fh, json->in_array);
+
+    if (c == EOF || (json->in_array && c == ']')) {
+        /* End of the file, or of the array */
+        *err = file_error(wth->fh, err_info);
+        return FALSE;
+    }
+
+    *data_offset = file_tell(wth->fh);
+    return json_read_record(wth->fh, rec, buf, err, err_info);
+}
+
+static gboolean
+json_stream_seek_read(wtap *wth, gint64 seek_off, wtap_rec *rec, Buffer *buf,
+                      int *err, gchar **err_info)
+{
+    if (file_seek(wth->random_fh, seek_off, SEEK_SET, err) == -1)
+        return FALSE;
+
+    return json_read_record(wth->random_fh, rec, buf, err, err_info);
+}
+
+/* Read the value at offset into a buffer and check it with json_validate(). */
+static gboolean
+json_validate_value_at(wtap *wth, gint64 offset, int *err)
+{
+    Buffer value;
+    gint64 len;
+    gboolean valid = FALSE;
+
+    if (file_seek(wth->fh, offset, SEEK_SET, err) == -1)
+        return FALSE;
+
+    ws_buffer_init(&value, 1024);
+    if (json_read_value(wth->fh, &value, MAX_FILE_SIZE, MAX_VALIDATE_TOKENS, &len))
+        valid = json_validate(ws_buffer_start_ptr(&value), (size_t)len);
+    ws_buffer_free(&value);
+    return valid;
+}
+
+wtap_open_return_val json_open(wtap *wth, int *err, gchar **err_info)
+{
+    gint64 start;
+    gint64 len;
+    gboolean is_document;
+    json_stream_t *json;
+    int c;
+
+    c = json_skip(wth->fh, FALSE);
+    if (c != '{' && c != '[') {
+        *err = file_error(wth->fh, err_info);
+        if (*err != 0 && *err != WTAP_ERR_SHORT_READ)
+            return WTAP_OPEN_ERROR;
         return WTAP_OPEN_NOT_MINE;
     }
+    start = file_tell(wth->fh);
 
-    if (file_seek(wth->fh, 0, SEEK_SET, err) == -1) {
-        g_free(filebuf);
+    /* Is the file a single value, small enough for json_validate()? */
+    is_document = json_read_value(wth->fh, NULL, MAX_FILE_SIZE, MAX_VALIDATE_TOKENS, &len);
+    *err = file_error(wth->fh, err_info);
+    if (*err != 0 && *err != WTAP_ERR_SHORT_READ)
         return WTAP_OPEN_ERROR;
+
+    if (is_document && json_skip(wth->fh, FALSE) == EOF) {
+        if (!json_validate_value_at(wth, start, err)) {
+            if (*err != 0)
+                return WTAP_OPEN_ERROR;
+            if (c == '{')
+                return WTAP_OPEN_NOT_MINE;
+            /* It may still be an array of which each element is valid */
+            is_document = FALSE;
+        }
+    } else if (c == '{' && is_document) {
+        /* A sequence of values; the first one has to be valid */
+        if (!json_validate_value_at(wth, start, err))
+            return *err != 0 ? WTAP_OPEN_ERROR : WTAP_OPEN_NOT_MINE;
+        is_document = FALSE;
+    } else if (c == '{') {
+        /* One object too big to validate */
+        return WTAP_OPEN_NOT_MINE;
+    } else {
+        is_document = FALSE;
     }
 
     wth->file_type_subtype = WTAP_FILE_TYPE_SUBTYPE_JSON;
     wth->file_encap = WTAP_ENCAP_JSON;
     wth->file_tsprec = WTAP_TSPREC_SEC;
-    wth->subtype_read = wtap_full_file_read;
-    wth->subtype_seek_read = wtap_full_file_seek_read;
     wth->snapshot_length = 0;
 
-    g_free(filebuf);
+    if (is_document) {
+        if (file_seek(wth->fh, 0, SEEK_SET, err) == -1)
+            return WTAP_OPEN_ERROR;
+        wth->subtype_read = wtap_full_file_read;
+        wth->subtype_seek_read = wtap_full_file_seek_read;
+        return WTAP_OPEN_MINE;
+    }
+
+    json = g_new(json_stream_t, 1);
+    json->in_array = (c == '[');
+    if (json->in_array) {
+        /* Records are the elements; the first one has to be valid */
+        if (file_seek(wth->fh, start + 1, SEEK_SET, err) == -1) {
+            g_free(json);
+            return WTAP_OPEN_ERROR;
+        }
+        c = json_skip(wth->fh, TRUE);
+        if (c == EOF || c == ']' ||
+            !json_validate_value_at(wth, file_tell(wth->fh), err)) {
+            g_free(json);
+            return *err != 0 ? WTAP_OPEN_ERROR : WTAP_OPEN_NOT_MINE;
+        }
+        if (file_seek(wth->fh, start + 1, SEEK_SET, err) == -1) {
+            g_free(json);
+            return WTAP_OPEN_ERROR;
+        }
+    } else {
+        if (file_seek(wth->fh, start, SEEK_SET, err) == -1) {
+            g_free(json);
+            return WTAP_OPEN_ERROR;
+        }
+    }
+
+    wth->priv = json;
+    wth->subtype_read = json_stream_read;
+    wth->subtype_seek_read = json_stream_seek_read;
     return WTAP_OPEN_MINE;
 }
 
@@ -210,7 +210,7 @@ merge_select_frame_type(int in_file_count, merge_in_file_t in_files[])
  * returns TRUE if first argument is earlier than second
  */
 static gboolean
-is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
+is_earlier(const nstime_t *l, const nstime_t *r) /* XXX, move to nstime.c */
 {
     if (l->secs > r->secs) {  /* left is later */
         return FALSE;
@@ -225,6 +225,112 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
     return TRUE;
 }
 
+/*
+ * Files that have a record read and waiting to be written are kept in a
+ * binary min-heap ordered by that record, so picking the next record is
+ * O(log n) in the number of input files rather than a scan of them all.
+ */
+typedef struct {
+    merge_in_file_t **files;    /* heap of files with RECORD_PRESENT */
+    guint             count;
+    merge_in_file_t  *refill;   /* file whose record was returned last */
+    gboolean          filled;   /* TRUE once every file has been read from */
+} merge_heap_t;
+
+/*
+ * returns TRUE if the record of the first file is to be written before
+ * the record of the second one
+ */
+static gboolean
+merge_rec_is_before(const merge_in_file_t *a, const merge_in_file_t *b)
+{
+    gboolean a_has_ts = (a->rec.presence_flags & WTAP_HAS_TS) != 0;
+    gboolean b_has_ts = (b->rec.presence_flags & WTAP_HAS_TS) != 0;
+
+    /*
+     * Records with no time stamp are treated as earlier than all other
+     * records, in input file order.
+     */
+    if (!a_has_ts || !b_has_ts) {
+        if (a_has_ts)
+            return FALSE;
+        if (b_has_ts)
+            return TRUE;
+        return a < b;
+    }
+    if (!is_earlier(&b->rec.ts, &a->rec.ts))
+        return TRUE;
+    if (!is_earlier(&a->rec.ts, &b->rec.ts))
+        return FALSE;
+    /* Equal time stamps: the later input file's record goes first. */
+    return a > b;
+}
+
+static void
+merge_heap_push(merge_heap_t *heap, merge_in_file_t *in_file)
+{
+    guint i = heap->count++;
+
+    while (i > 0) {
+        guint parent = (i - 1) / 2;
+
+        if (!merge_rec_is_before(in_file, heap->files[parent]))
+            break;
+        heap->files[i] = heap->files[parent];
+        i = parent;
+    }
+    heap->files[i] = in_file;
+}
+
+static merge_in_file_t *
+merge_heap_pop(merge_heap_t *heap)
+{
+    merge_in_file_t *top = heap->files[0];
+    merge_in_file_t *last = heap->files[--heap->count];
+    guint i = 0;
+
+    for (;;) {
+        guint child = 2 * i + 1;
+
+        if (child >= heap->count)
+            break;
+        if (child + 1 < heap->count &&
+            merge_rec_is_before(heap->files[child + 1], heap->files[child]))
+            child++;
+        if (!merge_rec_is_before(heap->files[child], last))
+            break;
+        heap->files[i] = heap->files[child];
+        i = child;
+    }
+    if (heap->count > 0)
+        heap->files[i] = last;
+    return top;
+}
+
+/*
+ * Read the next record from a file and, if there is one, put the file
+ * into the heap.  Returns FALSE on a read error.
+ */
+static gboolean
+merge_heap_read(merge_heap_t *heap, merge_in_file_t *in_file,
+                int *err, gchar **err_info)
+{
+    gint64 data_offset;
+
+    if (!wtap_read(in_file->wth, &in_file->rec, &in_file->frame_buffer,
+                   err, err_info, &data_offset)) {
+        if (*err != 0) {
+            in_file->state = GOT_ERROR;
+            return FALSE;
+        }
+        in_file->state = AT_EOF;
+    } else {
+        in_file->state = RECORD_PRESENT;
+        merge_heap_push(heap, in_file);
+    }
+    return TRUE;
+}
+
 /** Read the next packet, in chronological order, from the set of files to
  * be merged.
  *
@@ -239,6 +345,7 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  *
  * @param in_file_count number of entries in in_files
  * @param in_files input file array
+ * @param heap heap of files with a record available, empty on the first call
  * @param err wiretap error, if failed
  * @param err_info wiretap error string, if failed
  * @return pointer to merge_in_file_t for file from which that packet
@@ -247,79 +354,55 @@ is_earlier(nstime_t *l, nstime_t *r) /* XXX, move to nstime.c */
  */
 static merge_in_file_t *
 merge_read_packet(int in_file_count, merge_in_file_t in_files[],
-                  int *err, gchar **err_info)
+                  merge_heap_t *heap, int *err, gchar **err_info)
 {
+    merge_in_file_t *in_file;
     int i;
-    int ei = -1;
-    nstime_t tv = NSTIME_INIT_MAX;
-    wtap_rec *rec;
 
     /*
      * Make sure we have a record available from each file that's not at
-     * EOF, and search for the record with the earliest time stamp or
-     * with no time stamp (those records are treated as earlier than
-     * all other records).  Yes, this means you won't get a chronological
-     * merge of those records, but you obviously *can't* get that.
+     * EOF; only the file whose record we returned last needs reading
+     * once they all have been read from.  The heap then gives us the
+     * record with the earliest time stamp or with no time stamp (those
+     * records are treated as earlier than all other records).  Yes, this
+     * means you won't get a chronological merge of those records, but
+     * you obviously *can't* get that.
      */
-    for (i = 0; i < in_file_count; i++) {
-        gint64 data_offset;
-
-        if (in_files[i].state == RECORD_NOT_PRESENT) {
-            /*
-             * No packet available, and we haven't seen an error or EOF yet,
-             * so try to read the next packet.
-             */
-            if (!wtap_read(in_files[i].wth, &in_files[i].rec,
-                           &in_files[i].frame_buffer, err, err_info,
-                           &data_offset)) {
-                if (*err != 0) {
-                    in_files[i].state = GOT_ERROR;
-                    return &in_files[i];
-                }
-                in_files[i].state = AT_EOF;
-            } else
-                in_files[i].state = RECORD_PRESENT;
-        }
-
-        if (in_files[i].state == RECORD_PRESENT) {
-            rec = &in_files[i].rec;
-            if (!(rec->presence_flags & WTAP_HAS_TS)) {
-                /*
-                 * No time stamp.  Pick this record, and stop looking.
-                 */
-                ei = i;
-                break;
-            }
-            if (is_earlier(&rec->ts, &tv)) {
-                /*
-                 * This record's time stamp is earlier than any of the
-                 * records we've seen so far.  Pick it, for now, but
-                 * keep looking.
-                 */
-                tv = rec->ts;
-                ei = i;
-            }
+    if (!heap->filled) {
+        for (i = 0; i < in_file_count; i++) {
+            if (in_files[i].state == RECORD_NOT_PRESENT &&
+                !merge_heap_read(heap, &in_files[i], err, err_info))
+                return &in_files[i];
         }
+        heap->filled = TRUE;
+    } else if (heap->refill != NULL) {
+        in_file = heap->refill;
+        heap->refill = NULL;
+        if (!merge_heap_read(heap, in_file, err, err_info))
+            return in_file;
     }
 
-    if (ei == -1) {
+    if (heap->count == 0) {
         /* All the streams are at EOF.  Return an EOF indication. */
         *err = 0;
         return NULL;
     }
 
+    in_file = merge_heap_pop(heap);
+
     /* We'll need to read another packet from this file. */
-    in_files[ei].state = RECORD_NOT_PRESENT;
+    in_file->state = RECORD_NOT_PRESENT;
+    heap->refill = in_file;
 
     /* Count this packet. */
-    in_files[ei].packet_num++;
+    in_file->packet_num++;
 
     /*
      * Return a pointer to the merge_in_file_t of the file from which the
      * packet was read.
      */
     *err = 0;
-    return &in_files[ei];
+    return in_file;
 }
 
 /** Read the next packet, in file sequence order, from the set of files
@@ -851,6 +934,12 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
     int                 count = 0;
     gboolean            stop_flag = FALSE;
     wtap_rec *rec,      snap_rec;
+    merge_heap_t        heap;
+
+    heap.files = g_new(merge_in_file_t *, in_file_count);
+    heap.count = 0;
+    heap.refill = NULL;
+    heap.filled = FALSE;
 
     for (;;) {
         *err = 0;
@@ -860,7 +949,7 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
                                                err_info);
         }
         else {
-            in_file = merge_read_packet(in_file_count, in_files, err,
+            in_file = merge_read_packet(in_file_count, in_files, &heap, err,
                                         err_info);
         }
 
@@ -942,6 +1031,8 @@ merge_process_packets(wtap_dumper *pdh, const int file_type,
         }
     }
 
+    g_free(heap.files);
+
     if (cb)
         cb->callback_func(MERGE_EVENT_DONE, count, in_files, in_file_count, cb->data);
 
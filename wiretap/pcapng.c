@@ -1132,6 +1132,7 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
     guint8 *option_content;
     int pseudo_header_len;
     int fcslen;
+    gboolean have_comment;
 #ifdef HAVE_PLUGINS
     option_handler *handler;
 #endif
@@ -1321,9 +1322,9 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
         block_read += padding;
     }
 
-    /* Option defaults */
-    g_free(wblock->rec->opt_comment);   /* Free memory from an earlier read. */
-    wblock->rec->opt_comment = NULL;
+    /* Option defaults; the comment from an earlier read is kept until we
+     * know whether this packet has the same one. */
+    have_comment = FALSE;
     wblock->rec->rec_header.packet_header.drop_count  = -1;
     wblock->rec->rec_header.packet_header.pack_flags  = 0;
 
@@ -1374,8 +1375,18 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
             case(OPT_COMMENT):
                 if (oh->option_length > 0 && oh->option_length < opt_cont_buf_len) {
                     wblock->rec->presence_flags |= WTAP_HAS_COMMENTS;
+                    /* Captures often repeat the same comment on every
+                     * packet; don't reallocate it if it hasn't changed. */
+                    if (!have_comment && wblock->rec->opt_comment != NULL &&
+                        memchr(option_content, '\0', oh->option_length) == NULL &&
+                        strncmp(wblock->rec->opt_comment, (char *)option_content, oh->option_length) == 0 &&
+                        wblock->rec->opt_comment[oh->option_length] == '\0') {
+                        have_comment = TRUE;
+                        break;
+                    }
                     g_free(wblock->rec->opt_comment);
                     wblock->rec->opt_comment = g_strndup((char *)option_content, oh->option_length);
+                    have_comment = TRUE;
                     pcapng_debug("pcapng_read_packet_block: length %u opt_comment '%s'", oh->option_length, wblock->rec->opt_comment);
                 } else {
                     pcapng_debug("pcapng_read_packet_block: opt_comment length %u seems strange", oh->option_length);
@@ -1452,6 +1463,11 @@ pcapng_read_packet_block(FILE_T fh, pcapng_block_header_t *bh, pcapng_t *pn, wta
         }
     }
 
+    if (!have_comment) {
+        g_free(wblock->rec->opt_comment);   /* Free memory from an earlier read. */
+        wblock->rec->opt_comment = NULL;
+    }
+
     pcap_read_post_process(WTAP_FILE_TYPE_SUBTYPE_PCAPNG, iface_info.wtap_encap,
                            wblock->rec, ws_buffer_start_ptr(wblock->frame_buffer),
                            pn->byte_swapped, fcslen);
@@ -4470,6 +4486,84 @@ static gboolean pcapng_dump(wtap_dumper *wdh,
     return TRUE;
 }
 
+/*
+ * Copy a packet block from a pcapng file to a pcapng dump file as it is.
+ * Only packet blocks are copied: other record blocks may need their
+ * contents converted. If the block can't be copied, or can't be read,
+ * *copied is left FALSE and TRUE is returned, so that the caller reads
+ * and writes the record the usual way (and reports any read error).
+ */
+gboolean
+pcapng_copy_record_block(wtap_dumper *wdh, wtap *wth, gint64 seek_off,
+                         Buffer *buf, gboolean *copied, int *err)
+{
+    pcapng_t *pcapng = (pcapng_t *)wth->priv;
+    pcapng_block_header_t bh;
+    guint32 block_total_length;
+    gchar *read_err_info;
+    int read_err;
+
+    *copied = FALSE;
+
+    /*
+     * Interface IDs in the block must refer to the same interfaces in
+     * the new file, and its fields must be in the byte order we write.
+     */
+    if (pcapng->byte_swapped || wth->shb_hdrs->len != 1 ||
+        wdh->interface_data->len != wth->interface_data->len) {
+        return TRUE;
+    }
+
+    if (file_seek(wth->random_fh, seek_off, SEEK_SET, &read_err) < 0) {
+        return TRUE;
+    }
+    if (!wtap_read_bytes(wth->random_fh, &bh, sizeof bh, &read_err, &read_err_info)) {
+        g_free(read_err_info);
+        return TRUE;
+    }
+    if (bh.block_type != BLOCK_TYPE_EPB && bh.block_type != BLOCK_TYPE_SPB &&
+        bh.block_type != BLOCK_TYPE_PB) {
+        return TRUE;
+    }
+    block_total_length = bh.block_total_length;
+    if (block_total_length < MIN_BLOCK_SIZE || block_total_length > MAX_BLOCK_SIZE ||
+        block_total_length % 4 != 0) {
+        return TRUE;
+    }
+
+    ws_buffer_assure_space(buf, block_total_length);
+    memcpy(ws_buffer_start_ptr(buf), &bh, sizeof bh);
+    if (!wtap_read_bytes(wth->random_fh, ws_buffer_start_ptr(buf) + sizeof bh,
+                         block_total_length - (guint32)sizeof bh, &read_err, &read_err_info)) {
+        g_free(read_err_info);
+        return TRUE;
+    }
+    /* The trailing length must match; otherwise leave it to the reader to complain. */
+    if (memcmp(ws_buffer_start_ptr(buf) + block_total_length - sizeof block_total_length,
+               &block_total_length, sizeof block_total_length) != 0) {
+        return TRUE;
+    }
+
+    /* Write any Decryption Secrets Blocks that precede it, as pcapng_dump() does. */
+    if (wdh->dsbs_growing) {
+        for (guint i = wdh->dsbs_growing_written; i < wdh->dsbs_growing->len; i++) {
+            wtap_block_t dsb = g_array_index(wdh->dsbs_growing, wtap_block_t, i);
+            if (!pcapng_write_decryption_secrets_block(wdh, dsb, err)) {
+                return FALSE;
+            }
+            ++wdh->dsbs_growing_written;
+        }
+    }
+
+    if (!wtap_dump_file_write(wdh, ws_buffer_start_ptr(buf), block_total_length, err)) {
+        return FALSE;
+    }
+    wdh->bytes_dumped += block_total_length;
+
+    *copied = TRUE;
+    return TRUE;
+}
+
 
 /* Finish writing to a dump file.
    Returns TRUE on success, FALSE on failure. */
@@ -75,5 +75,7 @@ struct pcapng_option_header {
 wtap_open_return_val pcapng_open(wtap *wth, int *err, gchar **err_info);
 gboolean pcapng_dump_open(wtap_dumper *wdh, int *err);
 int pcapng_dump_can_write_encap(int encap);
+gboolean pcapng_copy_record_block(wtap_dumper *wdh, wtap *wth, gint64 seek_off,
+                                  Buffer *buf, gboolean *copied, int *err);
 
 #endif
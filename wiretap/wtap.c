@@ -104,6 +104,15 @@ wtap_file_get_shb(wtap *wth)
 	return g_array_index(wth->shb_hdrs, wtap_block_t, 0);
 }
 
+guint
+wtap_file_get_num_shbs(wtap *wth)
+{
+	if ((wth == NULL) || (wth->shb_hdrs == NULL) || (wth->shb_hdrs->len == 0))
+		return 1;
+
+	return wth->shb_hdrs->len;
+}
+
 GArray*
 wtap_file_get_shb_for_new_file(wtap *wth)
 {
@@ -1352,6 +1361,29 @@ wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
 	return TRUE;	/* success */
 }
 
+gboolean
+wtap_seek_sequential(wtap *wth, gint64 seek_off, int *err)
+{
+	/*
+	 * The pcap and pcapng readers keep no state between records
+	 * other than what the file and section headers and interface
+	 * descriptions give them, so they can pick up at any record.
+	 */
+	switch (wth->file_type_subtype) {
+
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAP_NSEC:
+	case WTAP_FILE_TYPE_SUBTYPE_PCAPNG:
+		break;
+
+	default:
+		*err = WTAP_ERR_UNSUPPORTED;
+		return FALSE;
+	}
+
+	return file_seek(wth->fh, seek_off, SEEK_SET, err) != -1;
+}
+
 /*
  * Read a given number of bytes from a file into a buffer or, if
  * buf is NULL, just discard them.
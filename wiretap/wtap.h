@@ -1783,6 +1783,24 @@ WS_DLL_PUBLIC
 gboolean wtap_read(wtap *wth, wtap_rec *rec, Buffer *buf, int *err,
     gchar **err_info, gint64 *offset);
 
+/** Continue sequential reading of a capture file at a given record.
+ *
+ * Only pcap and pcapng files can be read this way; for other file types
+ * this fails with WTAP_ERR_UNSUPPORTED. For pcapng files, the caller must
+ * know that no section header or interface description block is skipped,
+ * e.g. by comparing wtap_file_get_num_shbs() and the number of interfaces
+ * from when the offset was returned with the ones now.
+ *
+ * @wth a wtap * returned by a call that opened a file for reading.
+ * @seek_off a gint64 giving an offset value returned by a previous
+ * wtap_read() call on this file.
+ * @param err a positive "errno" value, or a negative number indicating
+ * the type of error, if the seek failed.
+ * @return TRUE on success, FALSE on failure.
+ */
+WS_DLL_PUBLIC
+gboolean wtap_seek_sequential(wtap *wth, gint64 seek_off, int *err);
+
 /** Read the record at a specified offset in a capture file, filling in
  * *phdr and *buf.
  *
@@ -1860,6 +1878,15 @@ int wtap_file_tsprec(wtap *wth);
 WS_DLL_PUBLIC
 wtap_block_t wtap_file_get_shb(wtap *wth);
 
+/**
+ * @brief Gets the number of section header blocks read so far.
+ *
+ * @param wth The wiretap session.
+ * @return The number of sections seen; 1 for files without sections.
+ */
+WS_DLL_PUBLIC
+guint wtap_file_get_num_shbs(wtap *wth);
+
 /**
  * @brief Gets new section header block for new file, based on existing info.
  * @details Creates a new wtap_block_t section header block and only
@@ -2104,6 +2131,29 @@ wtap_dumper* wtap_dump_open_stdout(int file_type_subtype,
 WS_DLL_PUBLIC
 gboolean wtap_dump(wtap_dumper *, const wtap_rec *, const guint8 *,
      int *err, gchar **err_info);
+
+/**
+ * @brief Copy a record from a file to a dump file without re-encoding it.
+ *
+ * Copies the record at the given offset in wth as it is stored in the
+ * file, which is much cheaper than reading it with wtap_seek_read() and
+ * writing it with wtap_dump(). This currently works for pcapng files
+ * written as pcapng, with one section in the host byte order, and with
+ * the interfaces of wth written to wdh in the same order.
+ *
+ * @param wdh The dump file to write to.
+ * @param wth The file the record is in.
+ * @param offset The offset of the record, as returned by wtap_read().
+ * @param buf Scratch buffer for the record data.
+ * @param copied Set to TRUE if the record was written, FALSE if it can't
+ * be copied and should be read and written with wtap_dump() instead.
+ * @param err Set to a WTAP_ERR_ value if writing failed.
+ * @param err_info Set to extra information about a failure.
+ * @return FALSE if writing failed, TRUE otherwise.
+ */
+WS_DLL_PUBLIC
+gboolean wtap_dump_copy_record(wtap_dumper *wdh, wtap *wth, gint64 offset,
+     Buffer *buf, gboolean *copied, int *err, gchar **err_info);
 WS_DLL_PUBLIC
 void wtap_dump_flush(wtap_dumper *);
 WS_DLL_PUBLIC
@@ -164,6 +164,13 @@ struct option {
 #define ISB_USRDELIV      8
 #define ADD_PADDING(x) ((((x) + 3) >> 2) << 2)
 
+/*
+ * Packets with at most this many bytes of data are copied, together with
+ * their record or block header and trailer, into a buffer on the stack and
+ * handed to fwrite() once, rather than once per part.
+ */
+#define MAX_SINGLE_WRITE_CAPLEN 2048
+
 /* Write to capture file */
 static gboolean
 write_to_file(FILE* pfile, const guint8* data, size_t data_length,
@@ -222,6 +229,13 @@ libpcap_write_packet(FILE* pfile,
         rec_hdr.ts_usec = usec;
         rec_hdr.incl_len = caplen;
         rec_hdr.orig_len = len;
+        if (caplen <= MAX_SINGLE_WRITE_CAPLEN) {
+                guint8 buff[sizeof(struct pcaprec_hdr) + MAX_SINGLE_WRITE_CAPLEN];
+
+                memcpy(buff, &rec_hdr, sizeof(rec_hdr));
+                memcpy(&buff[sizeof(rec_hdr)], pd, caplen);
+                return write_to_file(pfile, buff, sizeof(rec_hdr) + caplen, bytes_written, err);
+        }
         if (!write_to_file(pfile, (const guint8*)&rec_hdr, sizeof(rec_hdr), bytes_written, err))
                 return FALSE;
 
@@ -560,14 +574,32 @@ pcapng_write_enhanced_packet_block(FILE* pfile,
         epb.timestamp_low = (guint32)(timestamp & 0xffffffff);
         epb.captured_len = caplen;
         epb.packet_len = len;
-        if (!write_to_file(pfile, (const guint8*)&epb, sizeof(struct epb), bytes_written, err))
-                return FALSE;
-        if (!write_to_file(pfile, pd, caplen, bytes_written, err))
-                return FALSE;
         /* Use more efficient write in case of no "extras" */
         if(caplen % 4) {
             pad_len = 4 - (caplen % 4);
         }
+        /*
+         * If we have no options to write and the packet is small, write
+         * the whole block with one fwrite() call.
+         */
+        if (options_length == 0 && caplen <= MAX_SINGLE_WRITE_CAPLEN) {
+                guint8 block[sizeof(struct epb) + ADD_PADDING(MAX_SINGLE_WRITE_CAPLEN) + sizeof(guint32)];
+                size_t block_len;
+
+                memcpy(block, &epb, sizeof(struct epb));
+                block_len = sizeof(struct epb);
+                memcpy(&block[block_len], pd, caplen);
+                block_len += caplen;
+                memset(&block[block_len], 0, pad_len);
+                block_len += pad_len;
+                memcpy(&block[block_len], &block_total_length, sizeof(guint32));
+                block_len += sizeof(guint32);
+                return write_to_file(pfile, block, block_len, bytes_written, err);
+        }
+        if (!write_to_file(pfile, (const guint8*)&epb, sizeof(struct epb), bytes_written, err))
+                return FALSE;
+        if (!write_to_file(pfile, pd, caplen, bytes_written, err))
+                return FALSE;
         /*
          * If we have no options to write, just write out the padding and
          * the block total length with one fwrite() call.
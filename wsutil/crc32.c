@@ -18,6 +18,11 @@
 #include <glib.h>
 #include <wsutil/crc32.h>
 
+#ifdef HAVE_SSE4_2
+#include "ws_cpuid.h"
+#include "crc32_int.h"
+#endif
+
 #define CRC32_ACCUMULATE(c,d,table) (c=(c>>8)^(table)[(c^(d))&0xFF])
 
 /*****************************************************************/
@@ -365,21 +370,29 @@ crc32_ccitt_table_lookup (guchar pos)
 	return crc32_ccitt_table[pos];
 }
 
+#ifdef HAVE_SSE4_2
+/* -1 until the CPU has been checked */
+static int crc32c_use_sse42 = -1;
+#endif
+
 guint32
 crc32c_calculate(const void *buf, int len, guint32 crc)
 {
-	const guint8 *p = (const guint8 *)buf;
-	crc = CRC32C_SWAP(crc);
-	while (len-- > 0) {
-		CRC32C(crc, *p++);
-	}
-	return CRC32C_SWAP(crc);
+	return CRC32C_SWAP(crc32c_calculate_no_swap(buf, len, CRC32C_SWAP(crc)));
 }
 
 guint32
 crc32c_calculate_no_swap(const void *buf, int len, guint32 crc)
 {
 	const guint8 *p = (const guint8 *)buf;
+
+#ifdef HAVE_SSE4_2
+	if (crc32c_use_sse42 == -1)
+		crc32c_use_sse42 = ws_cpuid_sse42() ? 1 : 0;
+	if (crc32c_use_sse42)
+		return crc32c_sse42_calculate_no_swap(buf, len, crc);
+#endif
+
 	while (len-- > 0) {
 		CRC32C(crc, *p++);
 	}
@@ -0,0 +1,83 @@
+/* crc32c_sse42.c
+ * CRC-32C with the SSE 4.2 crc32 instruction
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#ifdef HAVE_SSE4_2
+
+#include <glib.h>
+#include <string.h>
+
+#include <nmmintrin.h>
+
+#include "crc32_int.h"
+
+/*
+ * The crc32 instruction computes the same reflected CRC-32C as the
+ * crc32c_table lookup, without the initial and final inversion, so it
+ * can continue a CRC started with the table and vice versa.
+ */
+guint32
+crc32c_sse42_calculate_no_swap(const void *buf, int len, guint32 crc)
+{
+	const guint8 *p = (const guint8 *)buf;
+
+	/* Align to 8 bytes, so that the wide loads don't straddle lines */
+	while (len > 0 && ((gsize)p & 7) != 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+		len--;
+	}
+
+#if defined(__x86_64__) || defined(_M_X64)
+	{
+		guint64 crc64 = crc;
+		guint64 word;
+
+		while (len >= 8) {
+			memcpy(&word, p, sizeof(word));
+			crc64 = _mm_crc32_u64(crc64, word);
+			p += 8;
+			len -= 8;
+		}
+		crc = (guint32)crc64;
+	}
+#endif
+	{
+		guint32 word;
+
+		while (len >= 4) {
+			memcpy(&word, p, sizeof(word));
+			crc = _mm_crc32_u32(crc, word);
+			p += 4;
+			len -= 4;
+		}
+	}
+
+	while (len-- > 0) {
+		crc = _mm_crc32_u8(crc, *p++);
+	}
+
+	return crc;
+}
+
+#endif /* HAVE_SSE4_2 */
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 8
+ * tab-width: 8
+ * indent-tabs-mode: t
+ * End:
+ *
+ * vi: set shiftwidth=8 tabstop=8 noexpandtab:
+ * :indentSize=8:tabSize=8:noTabs=false:
+ */
@@ -55,24 +55,42 @@ json_puts_string(FILE *fp, const char *str, gboolean dot_to_underscore)
         "u0010", "u0011", "u0012", "u0013", "u0014", "u0015", "u0016", "u0017", "u0018", "u0019", "u001a", "u001b", "u001c", "u001d", "u001e", "u001f"
     };
 
+    /*
+     * Characters that need no escaping are written in runs, with one
+     * fwrite() per run rather than one fputc() per character.
+     */
+    const char *run = str;
+    const char *p;
+
     fputc('"', fp);
-    for (int i = 0; str[i]; i++) {
-        if ((guint)str[i] < 0x20) {
+    for (p = str; *p; p++) {
+        guchar c = (guchar)*p;
+
+        if (c >= 0x20 && c != '\\' && c != '"' &&
+                !(c == '/' && p > str && p[-1] == '<') &&
+                !(dot_to_underscore && c == '.')) {
+            continue;
+        }
+        if (p > run) {
+            fwrite(run, 1, p - run, fp);
+        }
+        run = p + 1;
+        if (c < 0x20) {
             fputc('\\', fp);
-            fputs(json_cntrl[(guint)str[i]], fp);
-        } else if (i > 0 && str[i - 1] == '<' && str[i] == '/') {
+            fputs(json_cntrl[c], fp);
+        } else if (c == '/') {
             // Convert </script> to <\/script> to avoid breaking web pages.
             fputs("\\/", fp);
+        } else if (c == '.') {
+            fputc('_', fp);
         } else {
-            if (str[i] == '\\' || str[i] == '"') {
-                fputc('\\', fp);
-            }
-            if (dot_to_underscore && str[i] == '.')
-                fputc('_', fp);
-            else
-                fputc(str[i], fp);
+            fputc('\\', fp);
+            fputc(c, fp);
         }
     }
+    if (p > run) {
+        fwrite(run, 1, p - run, fp);
+    }
     fputc('"', fp);
 }
 
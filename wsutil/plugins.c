@@ -26,6 +26,7 @@
 #include <wsutil/report_message.h>
 
 #include <wsutil/plugins.h>
+#include <wsutil/startup_timings.h>
 #include <wsutil/ws_printf.h> /* ws_debug_printf */
 
 typedef struct _plugin {
@@ -134,6 +135,7 @@ scan_plugins_dir(GHashTable *plugins_module, const char *dirpath, plugin_type_e
     gpointer       symbol;
     const char    *plug_version;
     plugin        *new_plug;
+    gint64         start;
 
     if (append_type)
         plugin_folder = g_build_filename(dirpath, type_to_dir(type), (gchar *)NULL);
@@ -161,6 +163,7 @@ scan_plugins_dir(GHashTable *plugins_module, const char *dirpath, plugin_type_e
             continue;
         }
 
+        start = g_get_monotonic_time();
         plugin_file = g_build_filename(plugin_folder, name, (gchar *)NULL);
         handle = g_module_open(plugin_file, G_MODULE_BIND_LOCAL);
         g_free(plugin_file);
@@ -195,6 +198,7 @@ DIAG_OFF_PEDANTIC
         /* Found it, call the plugin registration function. */
         ((plugin_register_func)symbol)();
 DIAG_ON_PEDANTIC
+        startup_timing_record("plugin_load", name, g_get_monotonic_time() - start);
 
         new_plug = (plugin *)g_malloc(sizeof(plugin));
         new_plug->handle = handle;
@@ -0,0 +1,129 @@
+/* startup_timings.c
+ * Wall clock timings of the steps taken at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#include "config.h"
+
+#include <stdio.h>
+#include <errno.h>
+
+#include <glib.h>
+
+#include <wsutil/file_util.h>
+#include <wsutil/json_dumper.h>
+#include <wsutil/startup_timings.h>
+
+typedef struct {
+    const char *phase;
+    gchar      *name;
+    gint64      usecs;
+} startup_timing_t;
+
+/* Dissectors are registered on a worker thread, so guard the list. */
+static GMutex startup_timings_mtx;
+static GArray *startup_timings;
+/* Set before the worker threads start, and cleared after they're done. */
+static gboolean startup_timings_enabled;
+
+void
+startup_timings_enable(void)
+{
+    startup_timings_enabled = TRUE;
+}
+
+void
+startup_timing_record(const char *phase, const char *name, gint64 usecs)
+{
+    startup_timing_t timing;
+
+    if (!startup_timings_enabled)
+        return;
+
+    timing.phase = phase;
+    timing.name = g_strdup(name);
+    timing.usecs = usecs;
+
+    g_mutex_lock(&startup_timings_mtx);
+    if (startup_timings == NULL)
+        startup_timings = g_array_sized_new(FALSE, FALSE, sizeof(startup_timing_t), 4096);
+    g_array_append_val(startup_timings, timing);
+    g_mutex_unlock(&startup_timings_mtx);
+}
+
+gboolean
+startup_timings_write_json(const char *filename)
+{
+    json_dumper dumper = { 0 };
+    FILE *fh;
+    gboolean ok;
+
+    fh = ws_fopen(filename, "w");
+    if (fh == NULL)
+        return FALSE;
+
+    dumper.output_file = fh;
+    dumper.flags = JSON_DUMPER_FLAGS_PRETTY_PRINT;
+
+    json_dumper_begin_object(&dumper);
+    json_dumper_set_member_name(&dumper, "timings");
+    json_dumper_begin_array(&dumper);
+
+    g_mutex_lock(&startup_timings_mtx);
+    for (guint i = 0; startup_timings != NULL && i < startup_timings->len; i++) {
+        startup_timing_t *timing = &g_array_index(startup_timings, startup_timing_t, i);
+
+        json_dumper_begin_object(&dumper);
+        json_dumper_set_member_name(&dumper, "phase");
+        json_dumper_value_string(&dumper, timing->phase);
+        if (timing->name) {
+            json_dumper_set_member_name(&dumper, "name");
+            json_dumper_value_string(&dumper, timing->name);
+        }
+        json_dumper_set_member_name(&dumper, "usecs");
+        json_dumper_value_anyf(&dumper, "%" G_GINT64_FORMAT, timing->usecs);
+        json_dumper_end_object(&dumper);
+    }
+    g_mutex_unlock(&startup_timings_mtx);
+
+    json_dumper_end_array(&dumper);
+    json_dumper_end_object(&dumper);
+    json_dumper_finish(&dumper);
+
+    ok = !ferror(fh);
+    if (fclose(fh) != 0)
+        ok = FALSE;
+    return ok;
+}
+
+void
+startup_timings_cleanup(void)
+{
+    g_mutex_lock(&startup_timings_mtx);
+    startup_timings_enabled = FALSE;
+    if (startup_timings != NULL) {
+        for (guint i = 0; i < startup_timings->len; i++)
+            g_free(g_array_index(startup_timings, startup_timing_t, i).name);
+        g_array_free(startup_timings, TRUE);
+        startup_timings = NULL;
+    }
+    g_mutex_unlock(&startup_timings_mtx);
+}
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -0,0 +1,66 @@
+/* startup_timings.h
+ * Wall clock timings of the steps taken at startup
+ *
+ * Wireshark - Network traffic analyzer
+ * By Gerald Combs <gerald@wireshark.org>
+ * Copyright 1998 Gerald Combs
+ *
+ * SPDX-License-Identifier: GPL-2.0-or-later
+ */
+
+#ifndef __STARTUP_TIMINGS_H__
+#define __STARTUP_TIMINGS_H__
+
+#include <glib.h>
+
+#include "ws_symbol_export.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif /* __cplusplus */
+
+/*
+ * Start recording timings.  Until this is called, e.g. when
+ * --startup-timings is seen before libwireshark is initialized,
+ * startup_timing_record() does nothing.
+ */
+WS_DLL_PUBLIC void startup_timings_enable(void);
+
+/*
+ * Record that a startup step took the given number of microseconds.
+ * The phase (e.g. "register", "plugin_load", "lua_plugins") must be a
+ * string constant; the name of the step (a dissector routine, plugin or
+ * script) is copied, and is NULL for the total of a whole phase.
+ */
+WS_DLL_PUBLIC void startup_timing_record(const char *phase, const char *name, gint64 usecs);
+
+/*
+ * Write all the recorded timings to a file as JSON, in the order they
+ * were recorded.  Returns FALSE and sets errno if the file can't be
+ * written.
+ */
+WS_DLL_PUBLIC gboolean startup_timings_write_json(const char *filename);
+
+/*
+ * Free the recorded timings and stop recording.
+ */
+WS_DLL_PUBLIC void startup_timings_cleanup(void);
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* __STARTUP_TIMINGS_H__ */
+
+/*
+ * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
+ *
+ * Local variables:
+ * c-basic-offset: 4
+ * tab-width: 8
+ * indent-tabs-mode: nil
+ * End:
+ *
+ * vi: set shiftwidth=4 tabstop=8 expandtab:
+ * :indentSize=4:tabSize=8:noTabs=true:
+ */
@@ -164,6 +164,30 @@ create_timestamp(void) {
     return timestamp;
 }
 
+guint64
+get_monotonic_nsecs(void) {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+
+    if (frequency.QuadPart == 0)
+        QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&now);
+
+    /* Split the conversion so that the multiplication can't overflow. */
+    return (guint64)(now.QuadPart / frequency.QuadPart) * 1000000000 +
+           (guint64)(now.QuadPart % frequency.QuadPart) * 1000000000 / frequency.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec now;
+
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (guint64)(now.tv_sec) * 1000000000 + (guint64)(now.tv_nsec);
+#else
+    /* No better clock; GLib's is only good to a microsecond. */
+    return (guint64)g_get_monotonic_time() * 1000;
+#endif
+}
+
 /*
  * Editor modelines  -  http://www.wireshark.org/tools/modelines.html
  *
@@ -51,6 +51,13 @@ void log_resource_usage(gboolean reset_delta, const char *format, ...);
 WS_DLL_PUBLIC
 guint64 create_timestamp(void);
 
+/**
+ * Fetch a monotonic time in nanoseconds, for measuring short intervals.
+ * The starting point is unspecified; only differences are meaningful.
+ */
+WS_DLL_PUBLIC
+guint64 get_monotonic_nsecs(void);
+
 #ifdef __cplusplus
 }
 #endif /* __cplusplus */
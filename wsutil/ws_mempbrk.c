@@ -22,6 +22,8 @@
 #endif
 #endif
 
+#include <string.h>
+
 #include <glib.h>
 #include "ws_symbol_export.h"
 #include "ws_mempbrk.h"
@@ -36,6 +38,10 @@ ws_mempbrk_compile(ws_mempbrk_pattern* pattern, const gchar *needles)
         n++;
     }
 
+    pattern->num_needles = (guint)(n - needles);
+    if (pattern->num_needles <= G_N_ELEMENTS(pattern->needles))
+        memcpy(pattern->needles, needles, pattern->num_needles);
+
 #ifdef HAVE_SSE4_2
     ws_mempbrk_sse42_compile(pattern, needles);
 #endif
@@ -59,6 +65,47 @@ ws_mempbrk_portable_exec(const guint8* haystack, size_t haystacklen, const ws_me
     return NULL;
 }
 
+/* Size of the blocks searched by ws_mempbrk_memchr_exec(). */
+#define MEMCHR_BLOCK_SIZE 256
+
+/*
+ * Search for one or two needles with memchr(), which the C library
+ * usually vectorizes for the machine it runs on.  With two needles the
+ * haystack is searched block by block, so that finding a needle close
+ * to the start never costs a scan of the whole haystack for the other.
+ */
+static const guint8 *
+ws_mempbrk_memchr_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
+{
+    const guint8 *result, *second;
+    size_t block;
+
+    if (pattern->num_needles == 1) {
+        result = (const guint8 *)memchr(haystack, pattern->needles[0], haystacklen);
+        if (result && found_needle)
+            *found_needle = *result;
+        return result;
+    }
+
+    while (haystacklen > 0) {
+        block = MIN(haystacklen, MEMCHR_BLOCK_SIZE);
+        result = (const guint8 *)memchr(haystack, pattern->needles[0], block);
+        /* Only the part before the first needle can hold an earlier second needle. */
+        second = (const guint8 *)memchr(haystack, pattern->needles[1], result ? (size_t)(result - haystack) : block);
+        if (second)
+            result = second;
+        if (result) {
+            if (found_needle)
+                *found_needle = *result;
+            return result;
+        }
+        haystack += block;
+        haystacklen -= block;
+    }
+
+    return NULL;
+}
+
 
 WS_DLL_PUBLIC const guint8 *
 ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pattern* pattern, guchar *found_needle)
@@ -68,6 +115,9 @@ ws_mempbrk_exec(const guint8* haystack, size_t haystacklen, const ws_mempbrk_pat
         return ws_mempbrk_sse42_exec(haystack, haystacklen, pattern, found_needle);
 #endif
 
+    if (pattern->num_needles == 1 || pattern->num_needles == 2)
+        return ws_mempbrk_memchr_exec(haystack, haystacklen, pattern, found_needle);
+
     return ws_mempbrk_portable_exec(haystack, haystacklen, pattern, found_needle);
 }
 
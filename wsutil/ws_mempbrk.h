@@ -20,6 +20,8 @@
  */
 typedef struct {
     gchar patt[256];
+    guint num_needles;      /**< number of needles */
+    guint8 needles[2];      /**< the needles, if there are at most 2 */
 #ifdef HAVE_SSE4_2
     gboolean use_sse42;
     __m128i mask;